@@ -72,6 +72,12 @@ std::ostream &operator<<(std::ostream &os, MetaServerOpType optype) {
     case MetaServerOpType::UpdateVolumeExtent:
         os << "UpdateVolumeExtent";
         break;
+    case MetaServerOpType::CreateInodeAndDentry:
+        os << "CreateInodeAndDentry";
+        break;
+    case MetaServerOpType::AllocInodeIds:
+        os << "AllocInodeIds";
+        break;
     default:
         os << "Unknow opType";
     }
@@ -60,6 +60,8 @@ enum class MetaServerOpType {
     GetVolumeExtent,
     UpdateVolumeExtent,
     CreateManageInode,
+    CreateInodeAndDentry,
+    AllocInodeIds,
 };
 
 std::ostream &operator<<(std::ostream &os, MetaServerOpType optype);
@@ -233,6 +233,46 @@ void InitRefreshDataOpt(Configuration *conf,
                               &opt->refreshDataIntervalSec);
 }
 
+void InitDentryWriteBackOpt(Configuration *conf,
+                            DentryWriteBackOption *opt) {
+    conf->GetValueFatalIfFail("fuseClient.dentryWriteBack.enable",
+                              &opt->enable);
+    conf->GetValueFatalIfFail("fuseClient.dentryWriteBack.flushIntervalMs",
+                              &opt->flushIntervalMs);
+    conf->GetValueFatalIfFail("fuseClient.dentryWriteBack.maxPendingDentries",
+                              &opt->maxPendingDentries);
+    conf->GetValueFatalIfFail("fuseClient.dentryWriteBack.flushThreads",
+                              &opt->flushThreads);
+}
+
+void InitInodeIdPreallocOpt(Configuration *conf,
+                            InodeIdPreallocOption *opt) {
+    conf->GetValueFatalIfFail("fuseClient.inodeIdPrealloc.enable",
+                              &opt->enable);
+    conf->GetValueFatalIfFail("fuseClient.inodeIdPrealloc.leaseIds",
+                              &opt->leaseIds);
+    conf->GetValueFatalIfFail("fuseClient.inodeIdPrealloc.leaseMs",
+                              &opt->leaseMs);
+    conf->GetValueFatalIfFail("fuseClient.inodeIdPrealloc.expireMarginMs",
+                              &opt->expireMarginMs);
+    conf->GetValueFatalIfFail("fuseClient.inodeIdPrealloc.prefetchThreshold",
+                              &opt->prefetchThreshold);
+}
+
+void InitPersistentDentryCacheOpt(Configuration *conf,
+                                  PersistentDentryCacheOption *opt) {
+    conf->GetValueFatalIfFail("fuseClient.persistentDentryCache.enable",
+                              &opt->enable);
+    conf->GetValueFatalIfFail("fuseClient.persistentDentryCache.dir",
+                              &opt->dir);
+    conf->GetValueFatalIfFail(
+        "fuseClient.persistentDentryCache.warmUpBatchSize",
+        &opt->warmUpBatchSize);
+    conf->GetValueFatalIfFail(
+        "fuseClient.persistentDentryCache.maxDentriesPerDir",
+        &opt->maxDentriesPerDir);
+}
+
 void InitKVClientManagerOpt(Configuration *conf,
                                KVClientManagerOpt *config) {
     conf->GetValueFatalIfFail("fuseClient.supportKVcache",
@@ -263,6 +303,10 @@ void InitFuseClientOption(Configuration *conf, FuseClientOption *clientOption) {
     InitLeaseOpt(conf, &clientOption->leaseOpt);
     InitRefreshDataOpt(conf, &clientOption->refreshDataOption);
     InitKVClientManagerOpt(conf, &clientOption->kvClientManagerOpt);
+    InitDentryWriteBackOpt(conf, &clientOption->dentryWriteBackOpt);
+    InitInodeIdPreallocOpt(conf, &clientOption->inodeIdPreallocOpt);
+    InitPersistentDentryCacheOpt(conf,
+                                 &clientOption->persistentDentryCacheOpt);
 
     conf->GetValueFatalIfFail("fuseClient.attrTimeOut",
                               &clientOption->attrTimeOut);
@@ -301,6 +345,13 @@ void InitFuseClientOption(Configuration *conf, FuseClientOption *clientOption) {
         << "Not found `fuseClient.enableSplice` in conf, use default value `"
         << std::boolalpha << clientOption->enableFuseSplice << '`';
 
+    LOG_IF(WARNING,
+           !conf->GetBoolValue("fuseClient.enableCreateInodeAndDentry",
+                               &clientOption->enableCreateInodeAndDentry))
+        << "Not found `fuseClient.enableCreateInodeAndDentry` in conf, "
+           "use default value `"
+        << std::boolalpha << clientOption->enableCreateInodeAndDentry << '`';
+
     // if enableCto, attr and entry cache must invalid
     if (FLAGS_enableCto) {
         clientOption->attrTimeOut = 0;
@@ -173,6 +173,43 @@ struct RefreshDataOption {
     uint64_t maxDataSize = 1024;
     uint32_t refreshDataIntervalSec = 30;
 };
+
+struct DentryWriteBackOption {
+    // acknowledge new dentries locally and flush them to metaserver in
+    // background, dentries not flushed yet are lost if client crashed
+    bool enable = false;
+    uint32_t flushIntervalMs = 100;
+    // creating thread flushes by itself if pending dentries exceed this
+    uint32_t maxPendingDentries = 4096;
+    uint32_t flushThreads = 16;
+    // flush an entry and its inode in one request, not loaded from config
+    // but follows fuseClient.enableCreateInodeAndDentry
+    bool createInodeAndDentry = false;
+};
+
+struct InodeIdPreallocOption {
+    // lease inode ids from metaserver and create inodes with them
+    bool enable = false;
+    // inode ids per lease
+    uint32_t leaseIds = 1024;
+    uint64_t leaseMs = 600000;
+    // stop using a lease this long before it expires
+    uint64_t expireMarginMs = 60000;
+    // lease in background if ids left are less than this
+    uint32_t prefetchThreshold = 128;
+};
+
+struct PersistentDentryCacheOption {
+    // keep listed directories on local disk, so they are served locally
+    // after remount if unchanged
+    bool enable = false;
+    std::string dir = "/var/cache/curvefs/dentry";
+    // directories validated per request when mounting
+    uint32_t warmUpBatchSize = 128;
+    // don't keep directories larger than this
+    uint32_t maxDentriesPerDir = 100000;
+};
+
 struct FuseClientOption {
     MdsOption mdsOpt;
     MetaCacheOpt metaCacheOpt;
@@ -186,6 +223,9 @@ struct FuseClientOption {
     LeaseOpt leaseOpt;
     RefreshDataOption refreshDataOption;
     KVClientManagerOpt kvClientManagerOpt;
+    DentryWriteBackOption dentryWriteBackOpt;
+    InodeIdPreallocOption inodeIdPreallocOpt;
+    PersistentDentryCacheOption persistentDentryCacheOpt;
 
     double attrTimeOut;
     double entryTimeOut;
@@ -202,6 +242,7 @@ struct FuseClientOption {
     bool enableMultiMountPointRename = false;
     bool enableFuseSplice = false;
     bool disableXattr = false;
+    bool enableCreateInodeAndDentry = false;
     uint32_t downloadMaxRetryTimes;
 };
 
@@ -547,6 +547,18 @@ void FuseOpReleaseDir(fuse_req_t req, fuse_ino_t ino,
     FuseReplyErrByErrCode(req, ret);
 }
 
+void FuseOpFsyncDir(fuse_req_t req, fuse_ino_t ino, int datasync,
+                    struct fuse_file_info *fi) {
+    InflightGuard guard(&g_clientOpMetric->opFsyncDir.inflightOpNum);
+    LatencyUpdater updater(&g_clientOpMetric->opFsyncDir.latency);
+    CURVEFS_ERROR ret =
+        g_ClientInstance->FuseOpFsyncDir(req, ino, datasync, fi);
+    if (ret != CURVEFS_ERROR::OK) {
+        g_clientOpMetric->opFsyncDir.ecount << 1;
+    }
+    FuseReplyErrByErrCode(req, ret);
+}
+
 void FuseOpRename(fuse_req_t req, fuse_ino_t parent, const char *name,
                   fuse_ino_t newparent, const char *newname,
                   unsigned int flags) {
@@ -55,7 +55,7 @@ class DentryCacheManager {
     DentryCacheManager() : fsId_(0) {}
     virtual ~DentryCacheManager() {}
 
-    void SetFsId(uint32_t fsId) {
+    virtual void SetFsId(uint32_t fsId) {
         fsId_ = fsId;
     }
 
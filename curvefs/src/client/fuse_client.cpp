@@ -98,6 +98,41 @@ CURVEFS_ERROR FuseClient::Init(const FuseClientOption &option) {
     leaseExecutor_ = absl::make_unique<LeaseExecutor>(option.leaseOpt,
                                                       metaCache, mdsClient_);
 
+    if (option.persistentDentryCacheOpt.enable) {
+        persistentDentryCache_ =
+            std::make_shared<PersistentDentryCacheManager>(
+                dentryManager_, metaClient_,
+                option.persistentDentryCacheOpt);
+        dentryManager_ = persistentDentryCache_;
+    }
+
+    if (option.dentryWriteBackOpt.enable) {
+        DentryWriteBackOption writeBackOpt = option.dentryWriteBackOpt;
+        writeBackOpt.createInodeAndDentry = option.enableCreateInodeAndDentry;
+        dentryWriteBack_ = std::make_shared<WriteBackDentryCacheManager>(
+            dentryManager_, metaClient_, writeBackOpt);
+        dentryWriteBack_->SetFlushFailedCallback(
+            [this](const Dentry &dentry, bool withInode, CURVEFS_ERROR ret) {
+                RollbackPendingDentry(dentry, withInode);
+            });
+        dentryManager_ = dentryWriteBack_;
+    }
+
+    if (option.inodeIdPreallocOpt.enable) {
+        inodeIdAllocator_ = std::make_shared<InodeIdAllocator>(
+            metaClient_, option.inodeIdPreallocOpt);
+    }
+
+    if (dentryWriteBack_ != nullptr && inodeIdAllocator_ != nullptr) {
+        // a leased inode id must be still valid when it's flushed
+        createInodeLocally_ = option.inodeIdPreallocOpt.expireMarginMs >
+                              option.dentryWriteBackOpt.flushIntervalMs;
+        LOG_IF(WARNING, !createInodeLocally_)
+            << "Inodes are not created locally in write back mode, since"
+            << " inodeIdPrealloc.expireMarginMs is not greater than"
+            << " dentryWriteBack.flushIntervalMs";
+    }
+
     xattrManager_ = std::make_shared<XattrManager>(inodeManager_,
         dentryManager_, option_.listDentryLimit, option_.listDentryThreads);
 
@@ -353,6 +388,15 @@ CURVEFS_ERROR FuseClient::Run() {
 
 void FuseClient::Fini() {
     if (!isStop_.exchange(true)) {
+        if (dentryWriteBack_ != nullptr) {
+            dentryWriteBack_->Stop();
+        }
+        if (persistentDentryCache_ != nullptr) {
+            persistentDentryCache_->Stop();
+        }
+        if (inodeIdAllocator_ != nullptr) {
+            inodeIdAllocator_->Stop();
+        }
         inodeManager_->Stop();
         xattrManager_->Stop();
     }
@@ -386,6 +430,15 @@ CURVEFS_ERROR FuseClient::FuseOpInit(void *userdata,
     }
     inodeManager_->SetFsId(fsInfo_->fsid());
     dentryManager_->SetFsId(fsInfo_->fsid());
+    if (inodeIdAllocator_ != nullptr &&
+        !inodeIdAllocator_->Init(fsInfo_->fsid())) {
+        return CURVEFS_ERROR::INTERNAL;
+    }
+    if (persistentDentryCache_ != nullptr &&
+        !persistentDentryCache_->Open(fsName)) {
+        LOG(WARNING) << "Open persistent dentry cache failed, dentries are "
+                     << "not cached locally";
+    }
     enableSumInDir_ = fsInfo_->enablesumindir() && !FLAGS_enableCto;
     if (fsInfo_->has_recycletimehour()) {
         enableSumInDir_ = enableSumInDir_ && (fsInfo_->recycletimehour() == 0);
@@ -595,6 +648,160 @@ CURVEFS_ERROR FuseClient::UpdateParentMCTimeAndNlink(
     return CURVEFS_ERROR::OK;
 }
 
+namespace {
+
+Dentry NewDentry(const InodeParam &param, const char *name,
+                 uint64_t inodeId) {
+    Dentry dentry;
+    dentry.set_fsid(param.fsId);
+    dentry.set_inodeid(inodeId);
+    dentry.set_parentinodeid(param.parent);
+    dentry.set_name(name);
+    dentry.set_type(param.type);
+    if (param.type == FsFileType::TYPE_FILE ||
+        param.type == FsFileType::TYPE_S3) {
+        dentry.set_flag(DentryFlag::TYPE_FILE_FLAG);
+    }
+    return dentry;
+}
+
+}  // namespace
+
+CURVEFS_ERROR FuseClient::CreateInodeAndDentrySeparately(
+    const InodeParam &param, const char *name,
+    std::shared_ptr<InodeWrapper> *inodeWrapper) {
+    InodeParam leasedParam = param;
+    if (inodeIdAllocator_ != nullptr &&
+        inodeIdAllocator_->Alloc(&leasedParam.inodeId,
+                                 &leasedParam.leaseId)) {
+        CURVEFS_ERROR ret =
+            CreateInodeThenDentry(leasedParam, name, inodeWrapper);
+        if (ret != CURVEFS_ERROR::NOTSUPPORT) {
+            return ret;
+        }
+        // the lease has been reclaimed, let metaserver allocate inode id
+    }
+
+    return CreateInodeThenDentry(param, name, inodeWrapper);
+}
+
+CURVEFS_ERROR FuseClient::CreateInodeAndDentryLocally(
+    const InodeParam &param, const char *name,
+    std::shared_ptr<InodeWrapper> *inodeWrapper) {
+    InodeParam leasedParam = param;
+    if (!inodeIdAllocator_->Alloc(&leasedParam.inodeId,
+                                  &leasedParam.leaseId)) {
+        return CURVEFS_ERROR::NOTSUPPORT;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    leasedParam.timestamp = now;
+
+    uint64_t inodeId = leasedParam.inodeId;
+    std::weak_ptr<WriteBackDentryCacheManager> writeBack = dentryWriteBack_;
+    auto create = [writeBack, inodeId]() {
+        auto manager = writeBack.lock();
+        return manager != nullptr ? manager->FlushInode(inodeId)
+                                  : CURVEFS_ERROR::INTERNAL;
+    };
+    CURVEFS_ERROR ret =
+        inodeManager_->CreateInodeLocally(leasedParam, create, *inodeWrapper);
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "inodeManager CreateInodeLocally fail, ret = " << ret
+                   << ", parent = " << param.parent << ", name = " << name
+                   << ", inodeid = " << inodeId;
+        return ret;
+    }
+
+    Dentry dentry = NewDentry(param, name, inodeId);
+    ret = dentryWriteBack_->CreateInodeAndDentry(leasedParam, dentry);
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "dentryManager_ CreateInodeAndDentry fail, ret = "
+                   << ret << ", parent = " << param.parent
+                   << ", name = " << name << ", inodeid = " << inodeId;
+        inodeManager_->ClearInodeCache(inodeId);
+        return ret;
+    }
+    // the inode flush creates it on metaserver if it's still pending, so
+    // it can be evicted from cache later
+    inodeManager_->ShipToFlush(*inodeWrapper);
+
+    VLOG(6) << "Create inode and dentry locally success"
+            << ", parent = " << param.parent << ", name = " << name
+            << ", inode id = " << inodeId;
+    return CURVEFS_ERROR::OK;
+}
+
+CURVEFS_ERROR FuseClient::CreateInodeThenDentry(
+    const InodeParam &param, const char *name,
+    std::shared_ptr<InodeWrapper> *inodeWrapper) {
+    CURVEFS_ERROR ret = inodeManager_->CreateInode(param, *inodeWrapper);
+    if (ret == CURVEFS_ERROR::NOTSUPPORT) {
+        return ret;
+    } else if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "inodeManager CreateInode fail, ret = " << ret
+                   << ", parent = " << param.parent << ", name = " << name
+                   << ", mode = " << param.mode;
+        return ret;
+    }
+
+    VLOG(6) << "inodeManager CreateInode success"
+            << ", parent = " << param.parent << ", name = " << name
+            << ", mode = " << param.mode
+            << ", inode id = " << (*inodeWrapper)->GetInodeId();
+
+    Dentry dentry = NewDentry(param, name, (*inodeWrapper)->GetInodeId());
+    ret = dentryManager_->CreateDentry(dentry);
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "dentryManager_ CreateDentry fail, ret = " << ret
+                   << ", parent = " << param.parent << ", name = " << name
+                   << ", mode = " << param.mode;
+
+        CURVEFS_ERROR ret2 =
+            inodeManager_->DeleteInode((*inodeWrapper)->GetInodeId());
+        if (ret2 != CURVEFS_ERROR::OK) {
+            LOG(ERROR) << "Also delete inode failed, ret = " << ret2
+                       << ", inodeid = " << (*inodeWrapper)->GetInodeId();
+        }
+        return ret;
+    }
+    return CURVEFS_ERROR::OK;
+}
+
+void FuseClient::RollbackPendingDentry(const Dentry &dentry,
+                                       bool withInode) {
+    // the dentry never reached metaserver, so undo the link to inode and
+    // the nlink of parent, the same as removing it, and an inode journaled
+    // together doesn't exist on metaserver at all
+    CURVEFS_ERROR ret = CURVEFS_ERROR::OK;
+    if (!withInode) {
+        std::shared_ptr<InodeWrapper> inodeWrapper;
+        ret = inodeManager_->GetInode(dentry.inodeid(), inodeWrapper);
+        if (ret != CURVEFS_ERROR::OK) {
+            LOG(ERROR) << "inodeManager get inode fail, ret = " << ret
+                       << ", inodeid = " << dentry.inodeid();
+            return;
+        }
+
+        ret = inodeWrapper->UnLink(dentry.parentinodeid());
+        if (ret != CURVEFS_ERROR::OK) {
+            LOG(ERROR) << "UnLink failed, ret = " << ret
+                       << ", inodeid = " << dentry.inodeid()
+                       << ", parent = " << dentry.parentinodeid()
+                       << ", name = " << dentry.name();
+        }
+    }
+
+    ret = UpdateParentMCTimeAndNlink(dentry.parentinodeid(), dentry.type(),
+                                     NlinkChange::kSubOne);
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "UpdateParentMCTimeAndNlink failed"
+                   << ", parent: " << dentry.parentinodeid()
+                   << ", name: " << dentry.name();
+    }
+    inodeManager_->ClearInodeCache(dentry.inodeid());
+}
+
 CURVEFS_ERROR FuseClient::MakeNode(fuse_req_t req, fuse_ino_t parent,
                                    const char *name, mode_t mode,
                                    FsFileType type, dev_t rdev, bool internal,
@@ -631,42 +838,34 @@ CURVEFS_ERROR FuseClient::MakeNode(fuse_req_t req, fuse_ino_t parent,
     param.parent = parent;
 
     std::shared_ptr<InodeWrapper> inodeWrapper;
-    CURVEFS_ERROR ret = inodeManager_->CreateInode(param, inodeWrapper);
-    if (ret != CURVEFS_ERROR::OK) {
-        LOG(ERROR) << "inodeManager CreateInode fail, ret = " << ret
-                   << ", parent = " << parent << ", name = " << name
-                   << ", mode = " << mode;
-        return ret;
+    CURVEFS_ERROR ret = CURVEFS_ERROR::NOTSUPPORT;
+    if (createInodeLocally_) {
+        // journal inode and dentry locally, it's not supported if no
+        // leased inode id is usable now
+        ret = CreateInodeAndDentryLocally(param, name, &inodeWrapper);
+        if (ret != CURVEFS_ERROR::OK && ret != CURVEFS_ERROR::NOTSUPPORT) {
+            return ret;
+        }
     }
 
-    VLOG(6) << "inodeManager CreateInode success"
-            << ", parent = " << parent << ", name = " << name
-            << ", mode = " << mode
-            << ", inode id = " << inodeWrapper->GetInodeId();
-
-    Dentry dentry;
-    dentry.set_fsid(fsInfo_->fsid());
-    dentry.set_inodeid(inodeWrapper->GetInodeId());
-    dentry.set_parentinodeid(parent);
-    dentry.set_name(name);
-    dentry.set_type(inodeWrapper->GetType());
-    if (type == FsFileType::TYPE_FILE || type == FsFileType::TYPE_S3) {
-        dentry.set_flag(DentryFlag::TYPE_FILE_FLAG);
+    if (ret == CURVEFS_ERROR::NOTSUPPORT &&
+        option_.enableCreateInodeAndDentry) {
+        // create inode and dentry in one request, it's not supported
+        // if no inode id left in the partition which parent belongs to
+        ret = inodeManager_->CreateInodeAndDentry(param, name, inodeWrapper);
+        if (ret != CURVEFS_ERROR::OK && ret != CURVEFS_ERROR::NOTSUPPORT) {
+            LOG(ERROR) << "inodeManager CreateInodeAndDentry fail, ret = "
+                       << ret << ", parent = " << parent
+                       << ", name = " << name << ", mode = " << mode;
+            return ret;
+        }
     }
 
-    ret = dentryManager_->CreateDentry(dentry);
-    if (ret != CURVEFS_ERROR::OK) {
-        LOG(ERROR) << "dentryManager_ CreateDentry fail, ret = " << ret
-                   << ", parent = " << parent << ", name = " << name
-                   << ", mode = " << mode;
-
-        CURVEFS_ERROR ret2 =
-            inodeManager_->DeleteInode(inodeWrapper->GetInodeId());
-        if (ret2 != CURVEFS_ERROR::OK) {
-            LOG(ERROR) << "Also delete inode failed, ret = " << ret2
-                       << ", inodeid = " << inodeWrapper->GetInodeId();
+    if (ret == CURVEFS_ERROR::NOTSUPPORT) {
+        ret = CreateInodeAndDentrySeparately(param, name, &inodeWrapper);
+        if (ret != CURVEFS_ERROR::OK) {
+            return ret;
         }
-        return ret;
     }
 
     ret = UpdateParentMCTimeAndNlink(parent, type, NlinkChange::kAddOne);
@@ -1071,6 +1270,21 @@ CURVEFS_ERROR FuseClient::FuseOpReleaseDir(fuse_req_t req, fuse_ino_t ino,
     return CURVEFS_ERROR::OK;
 }
 
+CURVEFS_ERROR FuseClient::FuseOpFsyncDir(fuse_req_t req, fuse_ino_t ino,
+                                         int datasync,
+                                         struct fuse_file_info *fi) {
+    VLOG(1) << "FuseOpFsyncDir, ino: " << ino << ", datasync: " << datasync;
+    if (dentryWriteBack_ == nullptr) {
+        return CURVEFS_ERROR::OK;
+    }
+
+    CURVEFS_ERROR ret = dentryWriteBack_->Flush(ino);
+    LOG_IF(ERROR, ret != CURVEFS_ERROR::OK)
+        << "Flush pending dentries failed, ret = " << ret
+        << ", inodeid = " << ino;
+    return ret;
+}
+
 static void dirbuf_add(fuse_req_t req, struct DirBufferHead *b,
                        const Dentry &dentry,
                        const FuseClientOption &option,
@@ -1181,6 +1395,11 @@ CURVEFS_ERROR FuseClient::FuseOpRename(fuse_req_t req, fuse_ino_t parent,
         return CURVEFS_ERROR::NAMETOOLONG;
     }
 
+    // rename works on dentries at metaserver directly
+    CURVEFS_ERROR flushRet = FlushDentryAll();
+    LOG_IF(WARNING, flushRet != CURVEFS_ERROR::OK)
+        << "Flush pending dentries before rename failed, ret = " << flushRet;
+
     auto renameOp =
         RenameOperator(fsInfo_->fsid(), fsInfo_->fsname(),
                        parent, name, newparent, newname,
@@ -1630,8 +1849,18 @@ void FuseClient::FlushInodeAll() { inodeManager_->FlushAll(); }
 
 void FuseClient::FlushAll() {
     FlushData();
+    CURVEFS_ERROR ret = FlushDentryAll();
+    LOG_IF(ERROR, ret != CURVEFS_ERROR::OK)
+        << "Flush pending dentries failed, ret = " << ret;
     FlushInodeAll();
 }
 
+CURVEFS_ERROR FuseClient::FlushDentryAll() {
+    if (dentryWriteBack_ == nullptr) {
+        return CURVEFS_ERROR::OK;
+    }
+    return dentryWriteBack_->FlushAll();
+}
+
 }  // namespace client
 }  // namespace curvefs
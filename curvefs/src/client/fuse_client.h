@@ -52,6 +52,9 @@
 #include "curvefs/src/client/client_operator.h"
 #include "curvefs/src/client/lease/lease_excutor.h"
 #include "curvefs/src/client/xattr_manager.h"
+#include "curvefs/src/client/persistent_dentry_cache_manager.h"
+#include "curvefs/src/client/writeback_dentry_cache_manager.h"
+#include "curvefs/src/client/inode_id_allocator.h"
 
 #define DirectIOAlignment 512
 #define WARMUP_CHECKINTERVAL_US 1000*1000
@@ -172,6 +175,10 @@ class FuseClient {
     virtual CURVEFS_ERROR FuseOpReleaseDir(fuse_req_t req, fuse_ino_t ino,
                                            struct fuse_file_info* fi);
 
+    virtual CURVEFS_ERROR FuseOpFsyncDir(fuse_req_t req, fuse_ino_t ino,
+                                         int datasync,
+                                         struct fuse_file_info* fi);
+
     virtual CURVEFS_ERROR FuseOpReadDirPlus(fuse_req_t req, fuse_ino_t ino,
                                             size_t size, off_t off,
                                             struct fuse_file_info* fi,
@@ -265,6 +272,9 @@ class FuseClient {
 
     virtual void FlushAll();
 
+    // flush dentries pending in write back mode, return OK if disabled
+    CURVEFS_ERROR FlushDentryAll();
+
     // for unit test
     void SetEnableSumInDir(bool enable) {
         enableSumInDir_ = enable;
@@ -372,6 +382,27 @@ class FuseClient {
     CURVEFS_ERROR UpdateParentMCTimeAndNlink(
         fuse_ino_t parent, FsFileType type,  NlinkChange nlink);
 
+    // create inode and dentry in two requests, with a leased inode id if
+    // inode id preallocation is enabled
+    CURVEFS_ERROR CreateInodeAndDentrySeparately(
+        const InodeParam &param, const char *name,
+        std::shared_ptr<InodeWrapper> *inodeWrapper);
+
+    // create inode and then create dentry, the inode will be deleted
+    // if create dentry failed
+    CURVEFS_ERROR CreateInodeThenDentry(
+        const InodeParam &param, const char *name,
+        std::shared_ptr<InodeWrapper> *inodeWrapper);
+
+    // create inode in cache with a leased inode id, and journal it with
+    // its dentry in write back mode, return NOTSUPPORT if no id is leased
+    CURVEFS_ERROR CreateInodeAndDentryLocally(
+        const InodeParam &param, const char *name,
+        std::shared_ptr<InodeWrapper> *inodeWrapper);
+
+    // undo a dentry which failed to flush in write back mode
+    void RollbackPendingDentry(const Dentry &dentry, bool withInode);
+
     void WarmUpTask();
 
     void WarmUpRun() {
@@ -414,6 +445,18 @@ class FuseClient {
     // dentry cache manager
     std::shared_ptr<DentryCacheManager> dentryManager_;
 
+    // wraps the dentry cache manager if persistent dentry cache is enabled
+    std::shared_ptr<PersistentDentryCacheManager> persistentDentryCache_;
+
+    // wraps |dentryManager_| if dentry write back is enabled
+    std::shared_ptr<WriteBackDentryCacheManager> dentryWriteBack_;
+
+    // not null if inode id preallocation is enabled
+    std::shared_ptr<InodeIdAllocator> inodeIdAllocator_;
+
+    // create inodes locally with leased ids in write back mode
+    bool createInodeLocally_ = false;
+
     // xattr manager
     std::shared_ptr<XattrManager> xattrManager_;
 
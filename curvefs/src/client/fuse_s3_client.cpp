@@ -577,6 +577,12 @@ CURVEFS_ERROR FuseS3Client::FuseOpFsync(fuse_req_t req, fuse_ino_t ino,
     if (datasync != 0) {
         return CURVEFS_ERROR::OK;
     }
+    ret = FlushDentryAll();
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "flush pending dentries failed, ret = " << ret
+                   << ", inodeid = " << ino;
+        return ret;
+    }
     std::shared_ptr<InodeWrapper> inodeWrapper;
     ret = inodeManager_->GetInode(ino, inodeWrapper);
     if (ret != CURVEFS_ERROR::OK) {
@@ -615,10 +621,21 @@ CURVEFS_ERROR FuseS3Client::FuseOpFlush(fuse_req_t req, fuse_ino_t ino,
             return ret;
         }
 
-        ::curve::common::UniqueLock lgGuard = inodeWrapper->GetUniqueLock();
-        ret = inodeWrapper->Sync();
+        {
+            ::curve::common::UniqueLock lgGuard =
+                inodeWrapper->GetUniqueLock();
+            ret = inodeWrapper->Sync();
+            if (ret != CURVEFS_ERROR::OK) {
+                LOG(ERROR) << "FuseOpFlush, inode sync s3 chunk info fail"
+                           << ", ret = " << ret << ", ino: " << ino;
+                return ret;
+            }
+        }
+
+        // rolling back a failed dentry may lock its inode
+        ret = FlushDentryAll();
         if (ret != CURVEFS_ERROR::OK) {
-            LOG(ERROR) << "FuseOpFlush, inode sync s3 chunk info fail, ret = "
+            LOG(ERROR) << "FuseOpFlush, flush pending dentries fail, ret = "
                        << ret << ", ino: " << ino;
             return ret;
         }
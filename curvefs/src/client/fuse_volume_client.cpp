@@ -286,6 +286,13 @@ CURVEFS_ERROR FuseVolumeClient::FuseOpFsync(fuse_req_t req, fuse_ino_t ino,
         return CURVEFS_ERROR::OK;
     }
 
+    ret = FlushDentryAll();
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "Flush pending dentries failed, ino: " << ino
+                   << ", error: " << ret;
+        return ret;
+    }
+
     std::shared_ptr<InodeWrapper> inodeWrapper;
     ret = inodeManager_->GetInode(ino, inodeWrapper);
     if (ret != CURVEFS_ERROR::OK) {
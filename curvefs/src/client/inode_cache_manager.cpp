@@ -298,6 +298,12 @@ CURVEFS_ERROR InodeCacheManagerImpl::CreateInode(
     std::shared_ptr<InodeWrapper> &out) {
     Inode inode;
     MetaStatusCode ret = metaClient_->CreateInode(param, &inode);
+    if (ret == MetaStatusCode::INODE_ID_NOT_LEASED) {
+        VLOG(3) << "metaClient_ CreateInode with inode id not leased"
+                << ", inodeid = " << param.inodeId;
+        return CURVEFS_ERROR::NOTSUPPORT;
+    }
+
     if (ret != MetaStatusCode::OK) {
         LOG(ERROR) << "metaClient_ CreateInode failed, MetaStatusCode = " << ret
                    << ", MetaStatusCode_Name = " << MetaStatusCode_Name(ret);
@@ -321,6 +327,102 @@ CURVEFS_ERROR InodeCacheManagerImpl::CreateInode(
     return CURVEFS_ERROR::OK;
 }
 
+CURVEFS_ERROR InodeCacheManagerImpl::CreateInodeAndDentry(
+    const InodeParam &param,
+    const std::string &name,
+    std::shared_ptr<InodeWrapper> &out) {
+    Inode inode;
+    MetaStatusCode ret =
+        metaClient_->CreateInodeAndDentry(param, name, &inode);
+    if (ret == MetaStatusCode::PARTITION_ALLOC_ID_FAIL) {
+        VLOG(3) << "metaClient_ CreateInodeAndDentry not supported"
+                << " in partition of parent " << param.parent;
+        return CURVEFS_ERROR::NOTSUPPORT;
+    } else if (ret != MetaStatusCode::OK) {
+        LOG(ERROR) << "metaClient_ CreateInodeAndDentry failed"
+                   << ", MetaStatusCode = " << ret
+                   << ", MetaStatusCode_Name = " << MetaStatusCode_Name(ret)
+                   << ", parent = " << param.parent << ", name = " << name;
+        return MetaStatusCodeToCurvefsErrCode(ret);
+    }
+    uint64_t inodeid = inode.inodeid();
+    out = std::make_shared<InodeWrapper>(std::move(inode), metaClient_,
+        s3ChunkInfoMetric_, option_.maxDataSize,
+        option_.refreshDataIntervalSec);
+
+    std::shared_ptr<InodeWrapper> eliminatedOne;
+    bool eliminated = false;
+    {
+        NameLockGuard lock(nameLock_, std::to_string(inodeid));
+        eliminated = iCache_->Put(inodeid, out, &eliminatedOne);
+    }
+    if (eliminated) {
+        /* iCache does not evict inodes via put interface */
+        assert(0);
+    }
+    return CURVEFS_ERROR::OK;
+}
+
+CURVEFS_ERROR InodeCacheManagerImpl::CreateInodeLocally(
+    const InodeParam &param,
+    const std::function<CURVEFS_ERROR()> &create,
+    std::shared_ptr<InodeWrapper> &out) {
+    if (param.inodeId == 0 || !param.timestamp.has_value()) {
+        LOG(ERROR) << "CreateInodeLocally without leased inode id or create"
+                   << " time, param = " << param;
+        return CURVEFS_ERROR::INVALIDPARAM;
+    }
+
+    // the same as the inode metaserver creates
+    Inode inode;
+    inode.set_inodeid(param.inodeId);
+    inode.set_fsid(param.fsId);
+    inode.set_length(param.length);
+    inode.set_uid(param.uid);
+    inode.set_gid(param.gid);
+    inode.set_mode(param.mode);
+    inode.set_type(param.type);
+    inode.set_rdev(param.rdev);
+    inode.add_parent(param.parent);
+    inode.set_mtime(param.timestamp->tv_sec);
+    inode.set_mtime_ns(param.timestamp->tv_nsec);
+    inode.set_atime(param.timestamp->tv_sec);
+    inode.set_atime_ns(param.timestamp->tv_nsec);
+    inode.set_ctime(param.timestamp->tv_sec);
+    inode.set_ctime_ns(param.timestamp->tv_nsec);
+    if (param.type == FsFileType::TYPE_DIRECTORY) {
+        inode.set_nlink(2);
+        inode.mutable_xattr()->insert({XATTRFILES, "0"});
+        inode.mutable_xattr()->insert({XATTRSUBDIRS, "0"});
+        inode.mutable_xattr()->insert({XATTRENTRIES, "0"});
+        inode.mutable_xattr()->insert({XATTRFBYTES, "0"});
+    } else {
+        inode.set_nlink(1);
+    }
+    if (param.type == FsFileType::TYPE_SYM_LINK) {
+        inode.set_symlink(param.symlink);
+    }
+
+    uint64_t inodeid = inode.inodeid();
+    out = std::make_shared<InodeWrapper>(std::move(inode), metaClient_,
+        s3ChunkInfoMetric_, option_.maxDataSize,
+        option_.refreshDataIntervalSec);
+    // pin it in cache before it's visible
+    out->SetPendingCreate(create);
+
+    std::shared_ptr<InodeWrapper> eliminatedOne;
+    bool eliminated = false;
+    {
+        NameLockGuard lock(nameLock_, std::to_string(inodeid));
+        eliminated = iCache_->Put(inodeid, out, &eliminatedOne);
+    }
+    if (eliminated) {
+        /* iCache does not evict inodes via put interface */
+        assert(0);
+    }
+    return CURVEFS_ERROR::OK;
+}
+
 CURVEFS_ERROR InodeCacheManagerImpl::CreateManageInode(
     const InodeParam &param,
     std::shared_ptr<InodeWrapper> &out) {
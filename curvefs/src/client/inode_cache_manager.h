@@ -25,6 +25,7 @@
 #define CURVEFS_SRC_CLIENT_INODE_CACHE_MANAGER_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <map>
@@ -153,12 +154,27 @@ class InodeCacheManager {
     virtual CURVEFS_ERROR BatchGetXAttr(std::set<uint64_t> *inodeIds,
         std::list<XAttr> *xattrs) = 0;
 
+    // create inode with |param.inodeId| if it's not 0, return NOTSUPPORT
+    // if the id isn't leased from metaserver any more
     virtual CURVEFS_ERROR CreateInode(const InodeParam &param,
         std::shared_ptr<InodeWrapper> &out) = 0;   // NOLINT
 
     virtual CURVEFS_ERROR CreateManageInode(const InodeParam &param,
         std::shared_ptr<InodeWrapper> &out) = 0;   // NOLINT
 
+    // create inode and its dentry named |name| in one request, return
+    // NOTSUPPORT if the inode can't be allocated in parent's partition
+    virtual CURVEFS_ERROR CreateInodeAndDentry(const InodeParam &param,
+        const std::string &name,
+        std::shared_ptr<InodeWrapper> &out) = 0;   // NOLINT
+
+    // build inode with leased |param.inodeId| and create time
+    // |param.timestamp| in cache only, |create| creates it on metaserver
+    // before any other request for it, see InodeWrapper::SetPendingCreate
+    virtual CURVEFS_ERROR CreateInodeLocally(const InodeParam &param,
+        const std::function<CURVEFS_ERROR()> &create,
+        std::shared_ptr<InodeWrapper> &out) = 0;   // NOLINT
+
     virtual CURVEFS_ERROR DeleteInode(uint64_t inodeId) = 0;
 
     virtual void AddInodeAttrs(uint64_t parentId,
@@ -261,6 +277,14 @@ class InodeCacheManagerImpl : public InodeCacheManager,
     CURVEFS_ERROR CreateManageInode(const InodeParam &param,
         std::shared_ptr<InodeWrapper> &out) override;
 
+    CURVEFS_ERROR CreateInodeAndDentry(const InodeParam &param,
+        const std::string &name,
+        std::shared_ptr<InodeWrapper> &out) override;
+
+    CURVEFS_ERROR CreateInodeLocally(const InodeParam &param,
+        const std::function<CURVEFS_ERROR()> &create,
+        std::shared_ptr<InodeWrapper> &out) override;
+
     CURVEFS_ERROR DeleteInode(uint64_t inodeId) override;
 
     void AddInodeAttrs(uint64_t parentId,
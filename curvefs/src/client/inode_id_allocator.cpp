@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-09-02
+ */
+
+#include "curvefs/src/client/inode_id_allocator.h"
+
+#include <glog/logging.h>
+
+#include "src/common/timeutility.h"
+
+namespace curvefs {
+namespace client {
+
+using ::curve::common::LockGuard;
+using ::curve::common::TimeUtility;
+using ::curvefs::metaserver::MetaStatusCode;
+using ::curvefs::metaserver::MetaStatusCode_Name;
+
+namespace {
+
+// back off this long if leasing failed
+const uint64_t kLeaseRetryIntervalMs = 1000;
+
+}  // namespace
+
+InodeIdAllocator::InodeIdAllocator(
+    const std::shared_ptr<MetaServerClient>& metaClient,
+    const InodeIdPreallocOption& option)
+    : metaClient_(metaClient),
+      option_(option),
+      fsId_(0),
+      leasing_(false),
+      retryAfterMs_(0),
+      running_(false),
+      leasedNum_("curvefs_client_inode_id_allocator", "leased_num"),
+      missNum_("curvefs_client_inode_id_allocator", "miss_num") {
+    current_.set_start(0);
+    current_.set_end(0);
+    current_.set_nextid(0);
+    current_.set_expiretimems(0);
+    next_ = current_;
+}
+
+InodeIdAllocator::~InodeIdAllocator() {
+    Stop();
+}
+
+bool InodeIdAllocator::Init(uint32_t fsId) {
+    fsId_ = fsId;
+    // one thread is enough, as there's at most one lease in flight
+    if (leasePool_.Start(1) != 0) {
+        LOG(ERROR) << "Start inode id lease thread pool failed";
+        return false;
+    }
+    running_.store(true);
+    LOG(INFO) << "Inode id preallocation is enabled, ids per lease = "
+              << option_.leaseIds << ", lease = " << option_.leaseMs << " ms";
+    return true;
+}
+
+void InodeIdAllocator::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    leasePool_.Stop();
+}
+
+bool InodeIdAllocator::Usable(const InodeIdLease& lease,
+                              uint64_t nowMs) const {
+    return lease.nextid() < lease.end() &&
+           nowMs + option_.expireMarginMs < lease.expiretimems();
+}
+
+bool InodeIdAllocator::Alloc(uint64_t* inodeId, uint64_t* leaseId) {
+    uint64_t now = TimeUtility::GetTimeofDayMs();
+    LockGuard lk(mtx_);
+    if (!Usable(current_, now)) {
+        current_.Swap(&next_);
+        next_.set_end(0);
+    }
+
+    bool ok = Usable(current_, now);
+    if (ok) {
+        *inodeId = current_.nextid();
+        *leaseId = current_.leaseid();
+        current_.set_nextid(*inodeId + 1);
+    } else {
+        missNum_ << 1;
+    }
+
+    MaybeLease(now);
+    return ok;
+}
+
+void InodeIdAllocator::MaybeLease(uint64_t nowMs) {
+    if (leasing_ || Usable(next_, nowMs) || nowMs < retryAfterMs_ ||
+        !running_.load()) {
+        return;
+    }
+
+    if (Usable(current_, nowMs) &&
+        current_.end() - current_.nextid() > option_.prefetchThreshold) {
+        return;
+    }
+
+    leasing_ = true;
+    leasePool_.Enqueue(&InodeIdAllocator::Lease, this);
+}
+
+void InodeIdAllocator::Lease() {
+    uint64_t startMs = TimeUtility::GetTimeofDayMs();
+    InodeIdLease lease;
+    MetaStatusCode ret = metaClient_->AllocInodeIds(
+        fsId_, option_.leaseIds, option_.leaseMs, &lease);
+
+    LockGuard lk(mtx_);
+    leasing_ = false;
+    if (ret != MetaStatusCode::OK) {
+        LOG(WARNING) << "Lease inode ids failed, ret = "
+                     << MetaStatusCode_Name(ret) << ", fsId = " << fsId_;
+        retryAfterMs_ = TimeUtility::GetTimeofDayMs() + kLeaseRetryIntervalMs;
+        return;
+    }
+
+    VLOG(6) << "Lease inode ids success, lease = " << lease.ShortDebugString();
+    // metaserver starts the lease after |startMs| by leader's clock, which
+    // may differ from local clock
+    lease.set_expiretimems(startMs + option_.leaseMs);
+    leasedNum_ << lease.end() - lease.start();
+    next_.Swap(&lease);
+}
+
+}  // namespace client
+}  // namespace curvefs
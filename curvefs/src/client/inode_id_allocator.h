@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-09-02
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_INODE_ID_ALLOCATOR_H_
+#define CURVEFS_SRC_CLIENT_INODE_ID_ALLOCATOR_H_
+
+#include <bvar/bvar.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "curvefs/proto/common.pb.h"
+#include "curvefs/src/client/common/config.h"
+#include "curvefs/src/client/rpcclient/metaserver_client.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/concurrent/task_thread_pool.h"
+
+namespace curvefs {
+namespace client {
+
+using common::InodeIdPreallocOption;
+using ::curvefs::common::InodeIdLease;
+using rpcclient::MetaServerClient;
+
+// Allocate inode ids from leases of metaserver, so a new inode id is known
+// before creating it.
+//
+// Leases are requested in background once ids of the current lease run
+// low, and an id is never allocated from a lease about to expire, after
+// which metaserver may reclaim the unused ids. Expiry is judged by local
+// clock from sending the lease request, which is before metaserver starts
+// the lease by its own clock. Alloc never waits for a lease, the caller
+// lets metaserver allocate the id if it fails.
+class InodeIdAllocator {
+ public:
+    InodeIdAllocator(const std::shared_ptr<MetaServerClient>& metaClient,
+                     const InodeIdPreallocOption& option);
+
+    ~InodeIdAllocator();
+
+    bool Init(uint32_t fsId);
+
+    void Stop();
+
+    /**
+     * @brief allocate an inode id from the current lease
+     * @param[out] inodeId the inode id allocated
+     * @param[out] leaseId id of the lease, which creating the inode needs
+     * @return false if no lease is usable now
+     */
+    bool Alloc(uint64_t* inodeId, uint64_t* leaseId);
+
+ private:
+    bool Usable(const InodeIdLease& lease, uint64_t nowMs) const;
+
+    // trigger a background lease if needed, called with |mtx_| held
+    void MaybeLease(uint64_t nowMs);
+
+    void Lease();
+
+ private:
+    std::shared_ptr<MetaServerClient> metaClient_;
+    InodeIdPreallocOption option_;
+    uint32_t fsId_;
+
+    curve::common::Mutex mtx_;
+    InodeIdLease current_;
+    // lease got in background, used once |current_| is unusable
+    InodeIdLease next_;
+    bool leasing_;
+    // don't lease again until then if the last lease failed
+    uint64_t retryAfterMs_;
+
+    curve::common::TaskThreadPool<> leasePool_;
+    curve::common::Atomic<bool> running_;
+
+    bvar::Adder<uint64_t> leasedNum_;
+    bvar::Adder<uint64_t> missNum_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_INODE_ID_ALLOCATOR_H_
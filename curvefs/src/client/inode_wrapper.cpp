@@ -58,6 +58,25 @@ do {                                        \
     }                                       \
 } while (0)
 
+#define WAIT_CREATED                        \
+do {                                        \
+    CURVEFS_ERROR ret = WaitCreated();      \
+    if (ret != CURVEFS_ERROR::OK) {         \
+        return ret;                         \
+    }                                       \
+} while (0)
+
+#define WAIT_CREATED_ASYNC(DONE)                                          \
+do {                                                                      \
+    if (WaitCreated() != CURVEFS_ERROR::OK) {                             \
+        if ((DONE) != nullptr) {                                          \
+            (DONE)->SetMetaStatusCode(MetaStatusCode::UNKNOWN_ERROR);     \
+            (DONE)->Run();                                                \
+        }                                                                 \
+        return;                                                           \
+    }                                                                     \
+} while (0)
+
 std::ostream &operator<<(std::ostream &os, const struct stat &attr) {
     os << "{ st_ino = " << attr.st_ino << ", st_mode = " << attr.st_mode
        << ", st_nlink = " << attr.st_nlink << ", st_uid = " << attr.st_uid
@@ -182,6 +201,7 @@ void InodeWrapper::GetInodeAttr(InodeAttr *attr) {
 }
 
 CURVEFS_ERROR InodeWrapper::SyncAttr(bool internal) {
+    WAIT_CREATED;
     curve::common::UniqueLock lock = GetSyncingInodeUniqueLock();
     if (dirty_) {
         MetaStatusCode ret = metaClient_->UpdateInodeAttrWithOutNlink(
@@ -203,6 +223,7 @@ CURVEFS_ERROR InodeWrapper::SyncAttr(bool internal) {
 }
 
 CURVEFS_ERROR InodeWrapper::SyncS3ChunkInfo(bool internal) {
+    WAIT_CREATED;
     curve::common::UniqueLock lock = GetSyncingS3ChunkInfoUniqueLock();
     if (!s3ChunkInfoAdd_.empty()) {
         MetaStatusCode ret = metaClient_->GetOrModifyS3ChunkInfo(
@@ -222,6 +243,7 @@ CURVEFS_ERROR InodeWrapper::SyncS3ChunkInfo(bool internal) {
 
 void InodeWrapper::AsyncFlushAttr(MetaServerClientDone* done,
                                   bool /*internal*/) {
+    WAIT_CREATED_ASYNC(done);
     if (dirty_) {
         LockSyncingInode();
         metaClient_->UpdateInodeWithOutNlinkAsync(
@@ -238,6 +260,9 @@ void InodeWrapper::AsyncFlushAttr(MetaServerClientDone* done,
 }
 
 void InodeWrapper::FlushS3ChunkInfoAsync() {
+    if (WaitCreated() != CURVEFS_ERROR::OK) {
+        return;
+    }
     if (!s3ChunkInfoAdd_.empty()) {
         LockSyncingS3ChunkInfo();
          auto *done = new GetOrModifyS3ChunkInfoAsyncDone(shared_from_this());
@@ -249,6 +274,7 @@ void InodeWrapper::FlushS3ChunkInfoAsync() {
 }
 
 CURVEFS_ERROR InodeWrapper::FlushVolumeExtent() {
+    WAIT_CREATED;
     std::lock_guard<::curve::common::Mutex> guard(syncingVolumeExtentsMtx_);
     if (!extentCache_.HasDirtyExtents()) {
         return CURVEFS_ERROR::OK;
@@ -265,6 +291,9 @@ CURVEFS_ERROR InodeWrapper::FlushVolumeExtent() {
 }
 
 void InodeWrapper::FlushVolumeExtentAsync() {
+    if (WaitCreated() != CURVEFS_ERROR::OK) {
+        return;
+    }
     syncingVolumeExtentsMtx_.lock();
     if (!extentCache_.HasDirtyExtents()) {
         VLOG(3) << "FlushVolumeExtentAsync, ino: " << inode_.inodeid()
@@ -283,6 +312,7 @@ void InodeWrapper::FlushVolumeExtentAsync() {
 }
 
 CURVEFS_ERROR InodeWrapper::RefreshS3ChunkInfo() {
+    WAIT_CREATED;
     curve::common::UniqueLock lock = GetSyncingS3ChunkInfoUniqueLock();
     google::protobuf::Map<
                 uint64_t, S3ChunkInfoList> s3ChunkInfoMap;
@@ -306,6 +336,7 @@ CURVEFS_ERROR InodeWrapper::RefreshS3ChunkInfo() {
 }
 
 CURVEFS_ERROR InodeWrapper::Link(uint64_t parent) {
+    WAIT_CREATED;
     curve::common::UniqueLock lg(mtx_);
     REFRESH_NLINK;
     uint32_t old = inode_.nlink();
@@ -337,6 +368,7 @@ CURVEFS_ERROR InodeWrapper::Link(uint64_t parent) {
 }
 
 CURVEFS_ERROR InodeWrapper::UnLink(uint64_t parent) {
+    WAIT_CREATED;
     curve::common::UniqueLock lg(mtx_);
     REFRESH_NLINK;
     uint32_t old = inode_.nlink();
@@ -409,6 +441,7 @@ CURVEFS_ERROR InodeWrapper::UnLink(uint64_t parent) {
 
 CURVEFS_ERROR InodeWrapper::UpdateParent(
     uint64_t oldParent, uint64_t newParent) {
+    WAIT_CREATED;
     curve::common::UniqueLock lg(mtx_);
     auto parents = inode_.mutable_parent();
     for (auto iter = parents->begin(); iter != parents->end(); iter++) {
@@ -476,6 +509,7 @@ void InodeWrapper::Async(MetaServerClientDone *done, bool internal) {
 
 void InodeWrapper::AsyncFlushAttrAndExtents(MetaServerClientDone *done,
                                             bool /*internal*/) {
+    WAIT_CREATED_ASYNC(done);
     if (dirty_ || extentCache_.HasDirtyExtents()) {
         LockSyncingInode();
         syncingVolumeExtentsMtx_.lock();
@@ -501,6 +535,7 @@ void InodeWrapper::AsyncFlushAttrAndExtents(MetaServerClientDone *done,
 }
 
 CURVEFS_ERROR InodeWrapper::SyncS3(bool internal) {
+    WAIT_CREATED;
     curve::common::UniqueLock lock = GetSyncingInodeUniqueLock();
     curve::common::UniqueLock lockS3chunkInfo =
         GetSyncingS3ChunkInfoUniqueLock();
@@ -559,6 +594,7 @@ class UpdateInodeAsyncS3Done : public MetaServerClientDone {
 }  // namespace
 
 void InodeWrapper::AsyncS3(MetaServerClientDone *done, bool internal) {
+    WAIT_CREATED_ASYNC(done);
     if (dirty_ || !s3ChunkInfoAdd_.empty()) {
         LockSyncingInode();
         LockSyncingS3ChunkInfo();
@@ -582,6 +618,7 @@ void InodeWrapper::AsyncS3(MetaServerClientDone *done, bool internal) {
 }
 
 CURVEFS_ERROR InodeWrapper::RefreshVolumeExtent() {
+    WAIT_CREATED;
     VolumeExtentList extents;
     auto st = metaClient_->GetVolumeExtent(inode_.fsid(), inode_.inodeid(),
                                            true, &extents);
@@ -600,6 +637,7 @@ CURVEFS_ERROR InodeWrapper::RefreshVolumeExtent() {
 }
 
 CURVEFS_ERROR InodeWrapper::RefreshNlink() {
+    WAIT_CREATED;
     InodeAttr attr;
     auto ret = metaClient_->GetInodeAttr(
         inode_.fsid(), inode_.inodeid(), &attr);
@@ -614,6 +652,26 @@ CURVEFS_ERROR InodeWrapper::RefreshNlink() {
     return CURVEFS_ERROR::OK;
 }
 
+CURVEFS_ERROR InodeWrapper::WaitCreated() {
+    if (!pendingCreate_.load(std::memory_order_acquire)) {
+        return CURVEFS_ERROR::OK;
+    }
+
+    curve::common::LockGuard lk(createMtx_);
+    if (!pendingCreate_.load(std::memory_order_acquire)) {
+        return CURVEFS_ERROR::OK;
+    }
+    CURVEFS_ERROR ret = create_();
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "Create inode on metaserver failed, ret = " << ret
+                   << ", inodeid = " << inode_.inodeid();
+        return ret;
+    }
+    create_ = nullptr;
+    pendingCreate_.store(false, std::memory_order_release);
+    return CURVEFS_ERROR::OK;
+}
+
 void InodeWrapper::MergeXAttrLocked(
     const google::protobuf::Map<std::string, std::string>& xattrs) {
     auto helper =
@@ -28,6 +28,7 @@
 #include <gtest/gtest_prod.h>
 #include <climits>
 #include <cstdint>
+#include <functional>
 #include <utility>
 #include <memory>
 #include <string>
@@ -92,6 +93,7 @@ class InodeWrapper : public std::enable_shared_from_this<InodeWrapper> {
           metaClient_(std::move(metaClient)),
           s3ChunkInfoMetric_(std::move(s3ChunkInfoMetric)),
           dirty_(false),
+          pendingCreate_(false),
           time_(TimeUtility::GetTimeofDaySec()) {
         UpdateS3ChunkInfoMetric(CalS3ChunkInfoSize());
         g_alive_inode_count << 1;
@@ -250,8 +252,18 @@ class InodeWrapper : public std::enable_shared_from_this<InodeWrapper> {
         dirty_ = true;
     }
 
+    // an inode not created on metaserver yet is dirty, so it's never
+    // evicted from cache
     bool IsDirty() const {
-        return dirty_;
+        return dirty_ || pendingCreate_.load(std::memory_order_acquire);
+    }
+
+    // The inode is created locally, and |create| creates it on metaserver,
+    // which is called before any request to metaserver for the inode.
+    void SetPendingCreate(std::function<CURVEFS_ERROR()> create) {
+        curve::common::LockGuard lk(createMtx_);
+        create_ = std::move(create);
+        pendingCreate_.store(true, std::memory_order_release);
     }
 
     void ClearDirty() {
@@ -380,6 +392,9 @@ class InodeWrapper : public std::enable_shared_from_this<InodeWrapper> {
         }
     }
 
+    // create the inode on metaserver if it's created locally
+    CURVEFS_ERROR WaitCreated();
+
     // Flush inode attributes and extents asynchronously.
     // REQUIRES: |mtx_| is held
     void AsyncFlushAttrAndExtents(MetaServerClientDone *done, bool internal);
@@ -414,6 +429,11 @@ class InodeWrapper : public std::enable_shared_from_this<InodeWrapper> {
     bool dirty_;
     mutable ::curve::common::Mutex mtx_;
 
+    // set if the inode is created locally and not on metaserver yet
+    curve::common::Atomic<bool> pendingCreate_;
+    ::curve::common::Mutex createMtx_;
+    std::function<CURVEFS_ERROR()> create_;
+
     mutable ::curve::common::Mutex syncingInodeMtx_;
     mutable ::curve::common::Mutex syncingS3ChunkInfoMtx_;
 
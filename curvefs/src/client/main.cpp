@@ -57,7 +57,7 @@ static const struct fuse_lowlevel_ops curve_ll_oper = {
     readdir : FuseOpReadDir,
     // #endif
     releasedir : FuseOpReleaseDir,
-    fsyncdir : 0,
+    fsyncdir : FuseOpFsyncDir,
     statfs : FuseOpStatFs,
     setxattr : FuseOpSetXattr,
     getxattr : FuseOpGetXattr,
@@ -89,6 +89,8 @@ struct MetaServerClientMetric {
     InterfaceMetric updateInode;
     InterfaceMetric deleteInode;
     InterfaceMetric appendS3ChunkInfo;
+    InterfaceMetric createInodeAndDentry;
+    InterfaceMetric allocInodeIds;
 
     // tnx
     InterfaceMetric prepareRenameTx;
@@ -112,6 +114,8 @@ struct MetaServerClientMetric {
           updateInode(prefix, "updateInode"),
           deleteInode(prefix, "deleteInode"),
           appendS3ChunkInfo(prefix, "appendS3ChunkInfo"),
+          createInodeAndDentry(prefix, "createInodeAndDentry"),
+          allocInodeIds(prefix, "allocInodeIds"),
           prepareRenameTx(prefix, "prepareRenameTx"),
           updateVolumeExtent(prefix, "updateVolumeExtent"),
           getVolumeExtent(prefix, "getVolumeExtent") {}
@@ -154,6 +158,7 @@ struct ClientOpMetric {
     OpMetric opRmDir;
     OpMetric opOpenDir;
     OpMetric opReleaseDir;
+    OpMetric opFsyncDir;
     OpMetric opReadDir;
     OpMetric opRename;
     OpMetric opGetAttr;
@@ -182,6 +187,7 @@ struct ClientOpMetric {
           opRmDir(prefix, "opRmDir"),
           opOpenDir(prefix, "opOpenDir"),
           opReleaseDir(prefix, "opReleaseDir"),
+          opFsyncDir(prefix, "opFsyncDir"),
           opReadDir(prefix, "opReadDir"),
           opRename(prefix, "opRename"),
           opGetAttr(prefix, "opGetAttr"),
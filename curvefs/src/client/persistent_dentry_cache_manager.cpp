@@ -0,0 +1,475 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-09-05
+ */
+
+#include "curvefs/src/client/persistent_dentry_cache_manager.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <cstring>
+#include <set>
+#include <utility>
+
+#include "rocksdb/write_batch.h"
+#include "src/common/timeutility.h"
+
+namespace curvefs {
+namespace client {
+namespace common {
+DECLARE_bool(enableCto);
+}  // namespace common
+}  // namespace client
+}  // namespace curvefs
+
+namespace curvefs {
+namespace client {
+
+using ::curve::common::LockGuard;
+using ::curve::common::TimeUtility;
+using common::FLAGS_enableCto;
+using ::curvefs::metaserver::MetaStatusCode;
+using ::curvefs::metaserver::MetaStatusCode_Name;
+
+namespace {
+
+// "v" + directory -> dentry version of the directory when listed
+const char kVersionPrefix = 'v';
+// "d" + directory + name -> dentry
+const char kDentryPrefix = 'd';
+
+// big endian, so dentries of a directory are adjacent and sorted by name
+std::string EncodeDirKey(char prefix, uint64_t dir) {
+    std::string key(1, prefix);
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        key.push_back(static_cast<char>((dir >> shift) & 0xff));
+    }
+    return key;
+}
+
+uint64_t DecodeDir(const rocksdb::Slice& key) {
+    uint64_t dir = 0;
+    for (size_t i = 1; i <= sizeof(uint64_t); ++i) {
+        dir = (dir << 8) | static_cast<uint8_t>(key[i]);
+    }
+    return dir;
+}
+
+std::string EncodeVersion(uint64_t version) {
+    return std::string(reinterpret_cast<const char*>(&version),
+                       sizeof(version));
+}
+
+bool DecodeVersion(const rocksdb::Slice& value, uint64_t* version) {
+    if (value.size() != sizeof(uint64_t)) {
+        return false;
+    }
+    memcpy(version, value.data(), sizeof(uint64_t));
+    return true;
+}
+
+}  // namespace
+
+PersistentDentryCacheManager::PersistentDentryCacheManager(
+    const std::shared_ptr<DentryCacheManager>& dentryManager,
+    const std::shared_ptr<MetaServerClient>& metaClient,
+    const PersistentDentryCacheOption& option)
+    : dentryManager_(dentryManager),
+      metaClient_(metaClient),
+      option_(option),
+      cacheTimeOutSec_(0),
+      running_(false),
+      hitNum_("curvefs_client_persistent_dentry_cache", "hit_num"),
+      missNum_("curvefs_client_persistent_dentry_cache", "miss_num"),
+      staleNum_("curvefs_client_persistent_dentry_cache", "stale_num") {}
+
+PersistentDentryCacheManager::~PersistentDentryCacheManager() {
+    Stop();
+}
+
+void PersistentDentryCacheManager::SetFsId(uint32_t fsId) {
+    fsId_ = fsId;
+    dentryManager_->SetFsId(fsId);
+}
+
+CURVEFS_ERROR PersistentDentryCacheManager::Init(uint64_t cacheSize,
+                                                 bool enableCacheMetrics,
+                                                 uint32_t cacheTimeOutSec) {
+    cacheTimeOutSec_ = cacheTimeOutSec;
+    return dentryManager_->Init(cacheSize, enableCacheMetrics,
+                                cacheTimeOutSec);
+}
+
+bool PersistentDentryCacheManager::Open(const std::string& fsName) {
+    rocksdb::Status s = rocksdb::Env::Default()->CreateDirIfMissing(
+        option_.dir);
+    if (!s.ok()) {
+        LOG(ERROR) << "Create persistent dentry cache dir failed, dir = "
+                   << option_.dir << ", error = " << s.ToString();
+        return false;
+    }
+
+    // the fs id tells a recreated fs with the same name
+    std::string path =
+        option_.dir + "/" + fsName + "_" + std::to_string(fsId_);
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    rocksdb::DB* db = nullptr;
+    s = rocksdb::DB::Open(options, path, &db);
+    if (!s.ok()) {
+        LOG(ERROR) << "Open persistent dentry cache failed, path = " << path
+                   << ", error = " << s.ToString();
+        return false;
+    }
+    db_.reset(db);
+
+    running_.store(true);
+    // validated directories are only trusted if cto is disabled
+    if (!FLAGS_enableCto) {
+        warmUpThread_ = curve::common::Thread(
+            &PersistentDentryCacheManager::WarmUp, this);
+    }
+    LOG(INFO) << "Persistent dentry cache is enabled, path = " << path;
+    return true;
+}
+
+void PersistentDentryCacheManager::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (warmUpThread_.joinable()) {
+        warmUpThread_.join();
+    }
+}
+
+void PersistentDentryCacheManager::InsertOrReplaceCache(const Dentry& dentry) {
+    Invalidate(dentry.parentinodeid());
+    dentryManager_->InsertOrReplaceCache(dentry);
+}
+
+void PersistentDentryCacheManager::DeleteCache(uint64_t parentId,
+                                               const std::string& name) {
+    Invalidate(parentId);
+    dentryManager_->DeleteCache(parentId, name);
+}
+
+CURVEFS_ERROR PersistentDentryCacheManager::GetDentry(uint64_t parent,
+                                                      const std::string& name,
+                                                      Dentry* out) {
+    // validating costs as much as looking up metaserver if cto is enabled
+    if (db_ != nullptr && !FLAGS_enableCto && Validate(parent, true) &&
+        LoadDentry(parent, name, out)) {
+        hitNum_ << 1;
+        return CURVEFS_ERROR::OK;
+    }
+    return dentryManager_->GetDentry(parent, name, out);
+}
+
+CURVEFS_ERROR PersistentDentryCacheManager::CreateDentry(
+    const Dentry& dentry) {
+    Invalidate(dentry.parentinodeid());
+    return dentryManager_->CreateDentry(dentry);
+}
+
+CURVEFS_ERROR PersistentDentryCacheManager::DeleteDentry(
+    uint64_t parent, const std::string& name, FsFileType type) {
+    Invalidate(parent);
+    return dentryManager_->DeleteDentry(parent, name, type);
+}
+
+CURVEFS_ERROR PersistentDentryCacheManager::ListDentry(
+    uint64_t parent, std::list<Dentry>* dentryList, uint32_t limit,
+    bool onlyDir, uint32_t nlink) {
+    // no dir under this dir
+    if (db_ == nullptr || (onlyDir && nlink == 2)) {
+        return dentryManager_->ListDentry(parent, dentryList, limit, onlyDir,
+                                          nlink);
+    }
+
+    if (Validate(parent, false) && LoadListing(parent, dentryList)) {
+        if (onlyDir) {
+            dentryList->remove_if([](const Dentry& dentry) {
+                return dentry.type() != FsFileType::TYPE_DIRECTORY;
+            });
+        }
+        hitNum_ << 1;
+        return CURVEFS_ERROR::OK;
+    }
+    missNum_ << 1;
+
+    // only complete listings are kept
+    if (onlyDir) {
+        return dentryManager_->ListDentry(parent, dentryList, limit, onlyDir,
+                                          nlink);
+    }
+
+    uint64_t generation = 0;
+    {
+        LockGuard lk(mtx_);
+        auto it = dirs_.find(parent);
+        if (it != dirs_.end()) {
+            generation = it->second.generation;
+        }
+    }
+
+    // get the version before listing, so the listing is never older
+    uint64_t version = 0;
+    bool stable = GetVersion(parent, &version);
+    CURVEFS_ERROR ret = dentryManager_->ListDentry(parent, dentryList, limit,
+                                                   onlyDir, nlink);
+    if (ret == CURVEFS_ERROR::OK && stable && !dentryList->empty() &&
+        dentryList->size() <= option_.maxDentriesPerDir) {
+        SaveListing(parent, version, generation, *dentryList);
+    }
+    return ret;
+}
+
+bool PersistentDentryCacheManager::GetVersion(uint64_t parent,
+                                              uint64_t* version) {
+    InodeAttr attr;
+    MetaStatusCode ret = metaClient_->GetInodeAttr(fsId_, parent, &attr);
+    if (ret != MetaStatusCode::OK) {
+        LOG(WARNING) << "Get dentry version failed, ret = "
+                     << MetaStatusCode_Name(ret) << ", parent = " << parent;
+        return false;
+    }
+    if (!attr.has_dentryversion()) {
+        return false;
+    }
+    *version = attr.dentryversion();
+    return true;
+}
+
+bool PersistentDentryCacheManager::LoadVersion(uint64_t parent,
+                                               uint64_t* version) {
+    std::string value;
+    rocksdb::Status s = db_->Get(rocksdb::ReadOptions(),
+                                 EncodeDirKey(kVersionPrefix, parent), &value);
+    return s.ok() && DecodeVersion(value, version);
+}
+
+bool PersistentDentryCacheManager::Validate(uint64_t parent,
+                                            bool trustValidated) {
+    uint64_t now = TimeUtility::GetTimeofDaySec();
+    uint64_t generation = 0;
+    {
+        LockGuard lk(mtx_);
+        auto it = dirs_.find(parent);
+        if (it != dirs_.end()) {
+            const DirState& state = it->second;
+            if (trustValidated && state.validatedSec != 0 &&
+                (cacheTimeOutSec_ == 0 ||
+                 now - state.validatedSec < cacheTimeOutSec_)) {
+                return true;
+            }
+            generation = state.generation;
+        }
+    }
+
+    uint64_t kept = 0;
+    if (!LoadVersion(parent, &kept)) {
+        return false;
+    }
+
+    uint64_t version = 0;
+    if (!GetVersion(parent, &version)) {
+        return false;
+    }
+    if (version != kept) {
+        VLOG(6) << "Kept listing is stale, parent = " << parent;
+        staleNum_ << 1;
+        Drop(parent);
+        return false;
+    }
+
+    LockGuard lk(mtx_);
+    DirState& state = dirs_[parent];
+    if (state.generation != generation) {
+        return false;
+    }
+    state.validatedSec = now;
+    return true;
+}
+
+bool PersistentDentryCacheManager::LoadDentry(uint64_t parent,
+                                              const std::string& name,
+                                              Dentry* out) {
+    std::string value;
+    rocksdb::Status s =
+        db_->Get(rocksdb::ReadOptions(),
+                 EncodeDirKey(kDentryPrefix, parent) + name, &value);
+    return s.ok() && out->ParseFromString(value);
+}
+
+bool PersistentDentryCacheManager::LoadListing(uint64_t parent,
+                                               std::list<Dentry>* dentryList) {
+    dentryList->clear();
+    std::string prefix = EncodeDirKey(kDentryPrefix, parent);
+    std::unique_ptr<rocksdb::Iterator> iter(
+        db_->NewIterator(rocksdb::ReadOptions()));
+    for (iter->Seek(prefix); iter->Valid() && iter->key().starts_with(prefix);
+         iter->Next()) {
+        Dentry dentry;
+        if (!dentry.ParseFromArray(iter->value().data(),
+                                   iter->value().size())) {
+            LOG(ERROR) << "Parse kept dentry failed, parent = " << parent;
+            dentryList->clear();
+            return false;
+        }
+        dentryList->emplace_back(std::move(dentry));
+    }
+    return iter->status().ok() && !dentryList->empty();
+}
+
+void PersistentDentryCacheManager::Drop(uint64_t parent) {
+    rocksdb::WriteBatch batch;
+    batch.Delete(EncodeDirKey(kVersionPrefix, parent));
+    batch.DeleteRange(EncodeDirKey(kDentryPrefix, parent),
+                      EncodeDirKey(kDentryPrefix, parent + 1));
+    rocksdb::Status s = db_->Write(rocksdb::WriteOptions(), &batch);
+    LOG_IF(WARNING, !s.ok()) << "Drop kept listing failed, parent = " << parent
+                             << ", error = " << s.ToString();
+}
+
+void PersistentDentryCacheManager::SaveListing(
+    uint64_t parent, uint64_t version, uint64_t generation,
+    const std::list<Dentry>& dentrys) {
+    rocksdb::WriteBatch batch;
+    std::string prefix = EncodeDirKey(kDentryPrefix, parent);
+    batch.DeleteRange(prefix, EncodeDirKey(kDentryPrefix, parent + 1));
+    std::string value;
+    for (const auto& dentry : dentrys) {
+        dentry.SerializeToString(&value);
+        batch.Put(prefix + dentry.name(), value);
+    }
+    batch.Put(EncodeDirKey(kVersionPrefix, parent), EncodeVersion(version));
+
+    // written with |mtx_| held, so it's never after a local modification
+    LockGuard lk(mtx_);
+    DirState& state = dirs_[parent];
+    if (state.generation != generation) {
+        return;
+    }
+    rocksdb::Status s = db_->Write(rocksdb::WriteOptions(), &batch);
+    if (!s.ok()) {
+        LOG(WARNING) << "Keep listing failed, parent = " << parent
+                     << ", error = " << s.ToString();
+        return;
+    }
+    state.validatedSec = TimeUtility::GetTimeofDaySec();
+}
+
+void PersistentDentryCacheManager::Invalidate(uint64_t parent) {
+    if (db_ == nullptr) {
+        return;
+    }
+
+    // the listing is dropped lazily, only its version is removed here
+    LockGuard lk(mtx_);
+    DirState& state = dirs_[parent];
+    ++state.generation;
+    state.validatedSec = 0;
+    rocksdb::Status s = db_->Delete(rocksdb::WriteOptions(),
+                                    EncodeDirKey(kVersionPrefix, parent));
+    LOG_IF(WARNING, !s.ok()) << "Invalidate kept listing failed, parent = "
+                             << parent << ", error = " << s.ToString();
+}
+
+void PersistentDentryCacheManager::WarmUp() {
+    LOG(INFO) << "Persistent dentry cache warm up is start.";
+    uint64_t start = TimeUtility::GetTimeofDayMs();
+    std::map<uint64_t, uint64_t> kept;
+    std::string prefix(1, kVersionPrefix);
+    std::unique_ptr<rocksdb::Iterator> iter(
+        db_->NewIterator(rocksdb::ReadOptions()));
+    for (iter->Seek(prefix);
+         running_.load() && iter->Valid() && iter->key().starts_with(prefix);
+         iter->Next()) {
+        uint64_t version = 0;
+        if (iter->key().size() != prefix.size() + sizeof(uint64_t) ||
+            !DecodeVersion(iter->value(), &version)) {
+            continue;
+        }
+        kept.emplace(DecodeDir(iter->key()), version);
+        if (kept.size() >= option_.warmUpBatchSize) {
+            ValidateBatch(kept);
+            kept.clear();
+        }
+    }
+    if (running_.load() && !kept.empty()) {
+        ValidateBatch(kept);
+    }
+    LOG(INFO) << "Persistent dentry cache warm up is stop, cost "
+              << TimeUtility::GetTimeofDayMs() - start << " ms.";
+}
+
+void PersistentDentryCacheManager::ValidateBatch(
+    const std::map<uint64_t, uint64_t>& kept) {
+    std::set<uint64_t> inodeIds;
+    std::map<uint64_t, uint64_t> generations;
+    {
+        LockGuard lk(mtx_);
+        for (const auto& item : kept) {
+            inodeIds.emplace(item.first);
+            auto it = dirs_.find(item.first);
+            generations[item.first] =
+                it == dirs_.end() ? 0 : it->second.generation;
+        }
+    }
+
+    std::list<InodeAttr> attrs;
+    MetaStatusCode ret = metaClient_->BatchGetInodeAttr(fsId_, inodeIds,
+                                                        &attrs);
+    if (ret != MetaStatusCode::OK) {
+        LOG(WARNING) << "Get dentry versions of kept directories failed"
+                     << ", ret = " << MetaStatusCode_Name(ret);
+        return;
+    }
+
+    uint64_t now = TimeUtility::GetTimeofDaySec();
+    std::set<uint64_t> stale;
+    for (const auto& item : kept) {
+        stale.emplace(item.first);
+    }
+    for (const auto& attr : attrs) {
+        auto it = kept.find(attr.inodeid());
+        if (it == kept.end() || !attr.has_dentryversion() ||
+            attr.dentryversion() != it->second) {
+            continue;
+        }
+        stale.erase(attr.inodeid());
+        LockGuard lk(mtx_);
+        DirState& state = dirs_[attr.inodeid()];
+        if (state.generation == generations[attr.inodeid()]) {
+            state.validatedSec = now;
+        }
+    }
+
+    // changed or removed
+    for (uint64_t dir : stale) {
+        staleNum_ << 1;
+        Drop(dir);
+    }
+    VLOG(3) << "Validate " << kept.size() << " kept directories, "
+            << stale.size() << " are stale";
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-09-05
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_PERSISTENT_DENTRY_CACHE_MANAGER_H_
+#define CURVEFS_SRC_CLIENT_PERSISTENT_DENTRY_CACHE_MANAGER_H_
+
+#include <bvar/bvar.h>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "curvefs/src/client/common/config.h"
+#include "curvefs/src/client/dentry_cache_manager.h"
+#include "curvefs/src/client/rpcclient/metaserver_client.h"
+#include "rocksdb/db.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curvefs {
+namespace client {
+
+using common::PersistentDentryCacheOption;
+using rpcclient::MetaServerClient;
+
+// Persistent dentry cache, which wraps another DentryCacheManager.
+//
+// Complete listings of directories are kept in a local rocksdb together
+// with the directory's dentry version at listing time. Metaserver bumps the
+// version of a directory in the same apply which changes its dentries, so
+// a directory whose version is unchanged still has the kept listing, which
+// is served locally instead of listing metaserver again, also after
+// remount. The version is always got from metaserver rather than the inode
+// cache. Listing always validates the version, while looking up trusts a
+// validated directory until the dentry cache timeout like the memory cache,
+// unless cto is enabled.
+//
+// Versions of kept directories are validated in batches in background
+// after mounted. Local modifications drop the listing of the parent, and
+// an empty listing is never served, so checking a directory is empty
+// before removing it always goes to metaserver.
+class PersistentDentryCacheManager : public DentryCacheManager {
+ public:
+    PersistentDentryCacheManager(
+        const std::shared_ptr<DentryCacheManager>& dentryManager,
+        const std::shared_ptr<MetaServerClient>& metaClient,
+        const PersistentDentryCacheOption& option);
+
+    ~PersistentDentryCacheManager() override;
+
+    void SetFsId(uint32_t fsId) override;
+
+    CURVEFS_ERROR Init(uint64_t cacheSize, bool enableCacheMetrics,
+                       uint32_t cacheTimeOutSec) override;
+
+    /**
+     * @brief open the local cache of |fsName| and validate kept directories
+     *        in background, dentries are not cached locally if failed
+     */
+    bool Open(const std::string& fsName);
+
+    void Stop();
+
+    void InsertOrReplaceCache(const Dentry& dentry) override;
+
+    void DeleteCache(uint64_t parentId, const std::string& name) override;
+
+    CURVEFS_ERROR GetDentry(uint64_t parent, const std::string& name,
+                            Dentry* out) override;
+
+    CURVEFS_ERROR CreateDentry(const Dentry& dentry) override;
+
+    CURVEFS_ERROR DeleteDentry(uint64_t parent, const std::string& name,
+                               FsFileType type) override;
+
+    CURVEFS_ERROR ListDentry(uint64_t parent, std::list<Dentry>* dentryList,
+                             uint32_t limit, bool onlyDir = false,
+                             uint32_t nlink = 0) override;
+
+ private:
+    struct DirState {
+        // bumped by local modifications, a listing is kept only if it's
+        // unchanged during listing
+        uint64_t generation = 0;
+        // 0 means not validated
+        uint64_t validatedSec = 0;
+    };
+
+    // get dentry version of |parent| from metaserver, false if it's unknown
+    // or not stable now
+    bool GetVersion(uint64_t parent, uint64_t* version);
+
+    // the kept version of |parent|
+    bool LoadVersion(uint64_t parent, uint64_t* version);
+
+    // whether the kept listing of |parent| is valid now, a validated
+    // directory is trusted for a while if |trustValidated| is true
+    bool Validate(uint64_t parent, bool trustValidated);
+
+    bool LoadDentry(uint64_t parent, const std::string& name, Dentry* out);
+
+    bool LoadListing(uint64_t parent, std::list<Dentry>* dentryList);
+
+    // remove the kept listing and its version
+    void Drop(uint64_t parent);
+
+    void SaveListing(uint64_t parent, uint64_t version, uint64_t generation,
+                     const std::list<Dentry>& dentrys);
+
+    void Invalidate(uint64_t parent);
+
+    void WarmUp();
+
+    void ValidateBatch(const std::map<uint64_t, uint64_t>& kept);
+
+ private:
+    std::shared_ptr<DentryCacheManager> dentryManager_;
+    std::shared_ptr<MetaServerClient> metaClient_;
+    PersistentDentryCacheOption option_;
+    uint32_t cacheTimeOutSec_;
+
+    std::unique_ptr<rocksdb::DB> db_;
+
+    curve::common::Mutex mtx_;
+    std::unordered_map<uint64_t, DirState> dirs_;
+
+    curve::common::Thread warmUpThread_;
+    curve::common::Atomic<bool> running_;
+
+    bvar::Adder<uint64_t> hitNum_;
+    bvar::Adder<uint64_t> missNum_;
+    bvar::Adder<uint64_t> staleNum_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_PERSISTENT_DENTRY_CACHE_MANAGER_H_
@@ -24,6 +24,7 @@
 
 #include <brpc/channel.h>
 #include <brpc/controller.h>
+#include <time.h>
 
 #include <list>
 #include <string>
@@ -32,6 +33,7 @@
 #include "curvefs/proto/mds.pb.h"
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/proto/space.pb.h"
+#include "absl/types/optional.h"
 #include "curvefs/proto/topology.pb.h"
 #include "src/client/client_common.h"
 
@@ -44,6 +46,10 @@ using curvefs::metaserver::CreateInodeRequest;
 using curvefs::metaserver::CreateInodeResponse;
 using curvefs::metaserver::CreateManageInodeRequest;
 using curvefs::metaserver::CreateManageInodeResponse;
+using curvefs::metaserver::CreateInodeAndDentryRequest;
+using curvefs::metaserver::CreateInodeAndDentryResponse;
+using curvefs::metaserver::AllocInodeIdsRequest;
+using curvefs::metaserver::AllocInodeIdsResponse;
 using curvefs::metaserver::DeleteDentryRequest;
 using curvefs::metaserver::DeleteDentryResponse;
 using curvefs::metaserver::DeleteInodeRequest;
@@ -126,13 +132,20 @@ struct InodeParam {
     std::string symlink;
     uint64_t parent;
     ManageInodeType manageType = ManageInodeType::TYPE_NOT_MANAGE;
+    // inode id leased by AllocInodeIds, 0 means allocated by metaserver
+    uint64_t inodeId = 0;
+    // id of the lease which |inodeId| belongs to
+    uint64_t leaseId = 0;
+    // create time of the inode, it's chosen when creating if not set
+    absl::optional<struct timespec> timestamp;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const InodeParam& p) {
     os << "fsid: " << p.fsId << ", length: " << p.length << ", uid: " << p.uid
        << ", gid: " << p.gid << ", mode: " << p.mode << ", type: " << p.type
        << ", rdev: " << p.rdev
-       << ", symlink: " << p.symlink;
+       << ", symlink: " << p.symlink << ", inodeid: " << p.inodeId
+       << ", leaseid: " << p.leaseId;
 
     return os;
 }
@@ -1223,6 +1223,14 @@ void MetaServerClientImpl::GetOrModifyS3ChunkInfoAsync(
 
 MetaStatusCode MetaServerClientImpl::CreateInode(const InodeParam &param,
                                                  Inode *out) {
+    // the create time is the same for all the retries, by which metaserver
+    // recognizes a retry of the applied request with a leased inode id
+    struct timespec now;
+    if (param.timestamp.has_value()) {
+        now = param.timestamp.value();
+    } else {
+        clock_gettime(CLOCK_REALTIME, &now);
+    }
     auto task = RPCTask {
         metric_.createInode.qps.count << 1;
         LatencyUpdater updater(&metric_.createInode.latency);
@@ -1240,8 +1248,10 @@ MetaStatusCode MetaServerClientImpl::CreateInode(const InodeParam &param,
         request.set_rdev(param.rdev);
         request.set_symlink(param.symlink);
         request.set_parent(param.parent);
-        struct timespec now;
-        clock_gettime(CLOCK_REALTIME, &now);
+        if (param.inodeId != 0) {
+            request.set_inodeid(param.inodeId);
+            request.set_leaseid(param.leaseId);
+        }
         Time* tm = new Time();
         tm->set_sec(now.tv_sec);
         tm->set_nsec(now.tv_nsec);
@@ -1285,8 +1295,70 @@ MetaStatusCode MetaServerClientImpl::CreateInode(const InodeParam &param,
         return ret;
     };
 
+    // inode with leased id is created in the partition it belongs to
     auto taskCtx = std::make_shared<TaskContext>(MetaServerOpType::CreateInode,
-                                                 task, param.fsId, 0);
+                                                 task, param.fsId,
+                                                 param.inodeId);
+    CreateInodeExcutor excutor(opt_, metaCache_, channelManager_,
+                               std::move(taskCtx));
+    return ConvertToMetaStatusCode(excutor.DoRPCTask());
+}
+
+MetaStatusCode MetaServerClientImpl::AllocInodeIds(uint32_t fsId,
+                                                   uint32_t count,
+                                                   uint64_t leaseMs,
+                                                   InodeIdLease *lease) {
+    auto task = RPCTask {
+        metric_.allocInodeIds.qps.count << 1;
+        LatencyUpdater updater(&metric_.allocInodeIds.latency);
+        AllocInodeIdsResponse response;
+        AllocInodeIdsRequest request;
+        request.set_poolid(poolID);
+        request.set_copysetid(copysetID);
+        request.set_partitionid(partitionID);
+        request.set_fsid(fsId);
+        request.set_count(count);
+        request.set_leasems(leaseMs);
+        curvefs::metaserver::MetaServerService_Stub stub(channel);
+        stub.AllocInodeIds(cntl, &request, &response, nullptr);
+
+        if (cntl->Failed()) {
+            metric_.allocInodeIds.eps.count << 1;
+            LOG(WARNING) << "AllocInodeIds Failed, errorcode = "
+                         << cntl->ErrorCode()
+                         << ", error content:" << cntl->ErrorText()
+                         << ", log id = " << cntl->log_id();
+            return -cntl->ErrorCode();
+        }
+
+        MetaStatusCode ret = response.statuscode();
+        if (ret != MetaStatusCode::OK) {
+            LOG(WARNING) << "AllocInodeIds: fsId = " << fsId
+                         << ", count = " << count
+                         << ", errcode = " << ret
+                         << ", errmsg = " << MetaStatusCode_Name(ret)
+                         << ", pool: " << poolID << ", copyset: " << copysetID
+                         << ", partition: " << partitionID;
+        } else if (response.has_lease() && response.has_appliedindex()) {
+            *lease = response.lease();
+
+            metaCache_->UpdateApplyIndex(CopysetGroupID(poolID, copysetID),
+                                         response.appliedindex());
+        } else {
+            LOG(WARNING) << "AllocInodeIds: fsId = " << fsId
+                         << " ok, but applyIndex or lease not set in response:"
+                         << response.DebugString();
+            return -1;
+        }
+
+        VLOG(6) << "AllocInodeIds done, request: " << request.DebugString()
+                << "response: " << response.DebugString();
+        return ret;
+    };
+
+    // lease inode ids from any partition, the same as CreateInode
+    auto taskCtx = std::make_shared<TaskContext>(
+        MetaServerOpType::AllocInodeIds, task, fsId, 0);
     CreateInodeExcutor excutor(opt_, metaCache_, channelManager_,
                                std::move(taskCtx));
     return ConvertToMetaStatusCode(excutor.DoRPCTask());
@@ -1355,6 +1427,108 @@ MetaStatusCode MetaServerClientImpl::CreateManageInode(const InodeParam &param,
     return ConvertToMetaStatusCode(excutor.DoRPCTask());
 }
 
+MetaStatusCode MetaServerClientImpl::CreateInodeAndDentry(
+    const InodeParam &param, const std::string &name, Inode *out) {
+    // the request is sent to the partition of parent, so a leased id can
+    // only be used if it belongs to that partition too
+    if (param.inodeId != 0) {
+        PartitionID inodePartition = 0;
+        PartitionID parentPartition = 0;
+        if (!metaCache_->GetPartitionIdByInodeId(param.fsId, param.inodeId,
+                                                 &inodePartition) ||
+            !metaCache_->GetPartitionIdByInodeId(param.fsId, param.parent,
+                                                 &parentPartition) ||
+            inodePartition != parentPartition) {
+            VLOG(3) << "CreateInodeAndDentry: inode " << param.inodeId
+                    << " and parent " << param.parent
+                    << " are not in the same partition";
+            return MetaStatusCode::PARTITION_ID_MISSMATCH;
+        }
+    }
+
+    // the create time is the same for all the retries, by which metaserver
+    // recognizes a retry of the applied request
+    struct timespec now;
+    if (param.timestamp.has_value()) {
+        now = param.timestamp.value();
+    } else {
+        clock_gettime(CLOCK_REALTIME, &now);
+    }
+    auto task = RPCTask {
+        metric_.createInodeAndDentry.qps.count << 1;
+        LatencyUpdater updater(&metric_.createInodeAndDentry.latency);
+        CreateInodeAndDentryResponse response;
+        CreateInodeAndDentryRequest request;
+        request.set_poolid(poolID);
+        request.set_copysetid(copysetID);
+        request.set_partitionid(partitionID);
+        request.set_fsid(param.fsId);
+        request.set_length(param.length);
+        request.set_uid(param.uid);
+        request.set_gid(param.gid);
+        request.set_mode(param.mode);
+        request.set_type(param.type);
+        request.set_rdev(param.rdev);
+        request.set_symlink(param.symlink);
+        request.set_parent(param.parent);
+        request.set_name(name);
+        request.set_txid(txId);
+        if (param.inodeId != 0) {
+            request.set_inodeid(param.inodeId);
+            request.set_leaseid(param.leaseId);
+        }
+        Time* tm = new Time();
+        tm->set_sec(now.tv_sec);
+        tm->set_nsec(now.tv_nsec);
+        request.set_allocated_create(tm);
+        curvefs::metaserver::MetaServerService_Stub stub(channel);
+        stub.CreateInodeAndDentry(cntl, &request, &response, nullptr);
+
+        if (cntl->Failed()) {
+            metric_.createInodeAndDentry.eps.count << 1;
+            LOG(WARNING) << "CreateInodeAndDentry Failed, errorcode = "
+                         << cntl->ErrorCode()
+                         << ", error content:" << cntl->ErrorText()
+                         << ", log id = " << cntl->log_id();
+            return -cntl->ErrorCode();
+        }
+
+        MetaStatusCode ret = response.statuscode();
+        if (ret != MetaStatusCode::OK) {
+            LOG(WARNING) << "CreateInodeAndDentry:  param = " << param
+                         << ", name = " << name
+                         << ", errcode = " << ret
+                         << ", errmsg = " << MetaStatusCode_Name(ret)
+                         << ", pool: " << poolID << ", copyset: " << copysetID
+                         << ", partition: " << partitionID;
+        } else if (response.has_inode() && response.has_appliedindex()) {
+            *out = response.inode();
+
+            metaCache_->UpdateApplyIndex(CopysetGroupID(poolID, copysetID),
+                                         response.appliedindex());
+        } else {
+            LOG(WARNING) << "CreateInodeAndDentry:  param = " << param
+                         << ", name = " << name
+                         << " ok, but applyIndex or inode not set in response:"
+                         << response.DebugString();
+            return -1;
+        }
+
+        VLOG(6) << "CreateInodeAndDentry done, request: "
+                << request.DebugString()
+                << "response: " << response.DebugString();
+        return ret;
+    };
+
+    // the request is sent to the partition which parent inode belongs to
+    auto taskCtx = std::make_shared<TaskContext>(
+        MetaServerOpType::CreateInodeAndDentry, task, param.fsId,
+        param.parent, false, opt_.enableRenameParallel);
+    CreateInodeAndDentryExcutor excutor(opt_, metaCache_, channelManager_,
+                                        std::move(taskCtx));
+    return ConvertToMetaStatusCode(excutor.DoRPCTask());
+}
+
 MetaStatusCode MetaServerClientImpl::DeleteInode(uint32_t fsId,
                                                  uint64_t inodeid) {
     auto task = RPCTask {
@@ -49,6 +49,7 @@ using ::curvefs::metaserver::InodeAttr;
 using ::curvefs::metaserver::XAttr;
 using ::curvefs::metaserver::MetaStatusCode;
 using ::curvefs::metaserver::S3ChunkInfoList;
+using ::curvefs::common::InodeIdLease;
 using ::curvefs::common::StreamStatus;
 using ::curvefs::common::StreamClient;
 using S3ChunkInfoMap = google::protobuf::Map<uint64_t, S3ChunkInfoList>;
@@ -153,6 +154,27 @@ class MetaServerClient {
     virtual MetaStatusCode CreateManageInode(const InodeParam &param,
                                              Inode *out) = 0;
 
+    /**
+     * @brief create inode and its dentry named |name| under |param.parent|
+     *        in one request, the inode is allocated from the partition
+     *        which |param.parent| belongs to, or with the leased
+     *        |param.inodeId| if it belongs to that partition too
+     * @return PARTITION_ALLOC_ID_FAIL if no inode id left in the partition,
+     *         or PARTITION_ID_MISSMATCH if the leased id is not in it,
+     *         caller should fall back to CreateInode and CreateDentry
+     */
+    virtual MetaStatusCode CreateInodeAndDentry(const InodeParam &param,
+                                                const std::string &name,
+                                                Inode *out) = 0;
+
+    /**
+     * @brief lease at most |count| inode ids from a partition for |leaseMs|,
+     *        which can be used by CreateInode via |InodeParam::inodeId|
+     */
+    virtual MetaStatusCode AllocInodeIds(uint32_t fsId, uint32_t count,
+                                         uint64_t leaseMs,
+                                         InodeIdLease *lease) = 0;
+
     virtual MetaStatusCode DeleteInode(uint32_t fsId, uint64_t inodeid) = 0;
 
     virtual bool SplitRequestInodes(uint32_t fsId,
@@ -258,6 +280,14 @@ class MetaServerClientImpl : public MetaServerClient {
     MetaStatusCode CreateManageInode(const InodeParam &param,
                                      Inode *out) override;
 
+    MetaStatusCode CreateInodeAndDentry(const InodeParam &param,
+                                        const std::string &name,
+                                        Inode *out) override;
+
+    MetaStatusCode AllocInodeIds(uint32_t fsId, uint32_t count,
+                                 uint64_t leaseMs,
+                                 InodeIdLease *lease) override;
+
     MetaStatusCode DeleteInode(uint32_t fsId, uint64_t inodeid) override;
 
     bool SplitRequestInodes(uint32_t fsId,
@@ -149,9 +149,8 @@ bool TaskExecutor::OnReturn(int retCode) {
         case MetaStatusCode::PARTITION_ALLOC_ID_FAIL:
             // TODO(@lixiaocui @cw123): metaserver and mds heartbeat should
             // report this status
-            needRetry = true;
             // need choose a new coopyset
-            OnPartitionAllocIDFail();
+            needRetry = OnPartitionAllocIDFail();
             break;
 
         case MetaStatusCode::RPC_STREAM_ERROR:
@@ -263,9 +262,10 @@ void TaskExecutor::RefreshLeader() {
     task_->retryDirectly = (oldTarget != task_->target.metaServerID);
 }
 
-void TaskExecutor::OnPartitionAllocIDFail() {
+bool TaskExecutor::OnPartitionAllocIDFail() {
     metaCache_->MarkPartitionUnavailable(task_->target.partitionID);
     task_->target.Reset();
+    return true;
 }
 
 uint64_t TaskExecutor::OverLoadBackOff() {
@@ -330,6 +330,10 @@ void TaskExecutorDone::Run() {
 }
 
 bool CreateInodeExcutor::GetTarget() {
+    if (task_->inodeID != 0) {
+        return TaskExecutor::GetTarget();
+    }
+
     if (!metaCache_->SelectTarget(task_->fsID, &task_->target,
                                   &task_->applyIndex)) {
         LOG(ERROR) << "select target for task fail, "
@@ -339,6 +343,12 @@ bool CreateInodeExcutor::GetTarget() {
     return true;
 }
 
+bool CreateInodeAndDentryExcutor::OnPartitionAllocIDFail() {
+    // the caller should fall back to create inode in another partition
+    metaCache_->MarkPartitionUnavailable(task_->target.partitionID);
+    return false;
+}
+
 }  // namespace rpcclient
 }  // namespace client
 }  // namespace curvefs
@@ -155,7 +155,7 @@ class TaskExecutor {
     void OnReDirected();
     void OnCopysetNotExist();
     bool OnPartitionNotExist();
-    void OnPartitionAllocIDFail();
+    virtual bool OnPartitionAllocIDFail();
 
     // retry policy
     void RefreshLeader();
@@ -275,6 +275,21 @@ class CreateInodeExcutor : public TaskExecutor {
     bool GetTarget() override;
 };
 
+// create inode and dentry in the partition which parent inode belongs to,
+// so it can't choose another partition if no inode id left in it
+class CreateInodeAndDentryExcutor : public TaskExecutor {
+ public:
+    explicit CreateInodeAndDentryExcutor(
+        const ExcutorOpt &opt,
+        const std::shared_ptr<MetaCache> &metaCache,
+        const std::shared_ptr<ChannelManager<MetaserverID>> &channelManager,
+        const std::shared_ptr<TaskContext> &task)
+        : TaskExecutor(opt, metaCache, channelManager, task) {}
+
+ protected:
+    bool OnPartitionAllocIDFail() override;
+};
+
 }  // namespace rpcclient
 }  // namespace client
 }  // namespace curvefs
@@ -0,0 +1,450 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-31
+ */
+
+#include "curvefs/src/client/writeback_dentry_cache_manager.h"
+
+#include <glog/logging.h>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "curvefs/src/client/error_code.h"
+#include "src/common/concurrent/count_down_event.h"
+#include "src/common/timeutility.h"
+
+namespace curvefs {
+namespace client {
+
+using ::curve::common::CountDownEvent;
+using ::curvefs::metaserver::Inode;
+using ::curvefs::metaserver::MetaStatusCode;
+using ::curvefs::metaserver::MetaStatusCode_Name;
+using ::curve::common::LockGuard;
+using ::curve::common::TimeUtility;
+
+WriteBackDentryCacheManager::WriteBackDentryCacheManager(
+    const std::shared_ptr<DentryCacheManager>& dentryManager,
+    const std::shared_ptr<MetaServerClient>& metaClient,
+    const DentryWriteBackOption& option)
+    : dentryManager_(dentryManager),
+      metaClient_(metaClient),
+      option_(option),
+      pendingCount_(0),
+      flushError_(CURVEFS_ERROR::OK),
+      running_(false),
+      pendingNum_("curvefs_client_dentry_writeback", "pending_num"),
+      flushLatency_("curvefs_client_dentry_writeback", "flush") {}
+
+WriteBackDentryCacheManager::~WriteBackDentryCacheManager() {
+    Stop();
+}
+
+void WriteBackDentryCacheManager::SetFsId(uint32_t fsId) {
+    fsId_ = fsId;
+    dentryManager_->SetFsId(fsId);
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::Init(uint64_t cacheSize,
+                                                bool enableCacheMetrics,
+                                                uint32_t cacheTimeOutSec) {
+    CURVEFS_ERROR ret =
+        dentryManager_->Init(cacheSize, enableCacheMetrics, cacheTimeOutSec);
+    if (ret != CURVEFS_ERROR::OK) {
+        return ret;
+    }
+
+    if (flushPool_.Start(option_.flushThreads) != 0) {
+        LOG(ERROR) << "Start dentry flush thread pool failed, threads = "
+                   << option_.flushThreads;
+        return CURVEFS_ERROR::INTERNAL;
+    }
+    running_.store(true);
+    flushThread_ =
+        curve::common::Thread(&WriteBackDentryCacheManager::FlushBackground,
+                              this);
+    LOG(INFO) << "Dentry write back is enabled, flush interval = "
+              << option_.flushIntervalMs
+              << " ms, max pending dentries = " << option_.maxPendingDentries;
+    return CURVEFS_ERROR::OK;
+}
+
+void WriteBackDentryCacheManager::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    sleeper_.interrupt();
+    flushThread_.join();
+    CURVEFS_ERROR ret = FlushAll();
+    LOG_IF(ERROR, ret != CURVEFS_ERROR::OK)
+        << "Flush pending dentries failed when stop, ret = " << ret;
+    flushPool_.Stop();
+}
+
+void WriteBackDentryCacheManager::InsertOrReplaceCache(const Dentry& dentry) {
+    dentryManager_->InsertOrReplaceCache(dentry);
+}
+
+void WriteBackDentryCacheManager::DeleteCache(uint64_t parentId,
+                                              const std::string& name) {
+    dentryManager_->DeleteCache(parentId, name);
+}
+
+bool WriteBackDentryCacheManager::FindInJournal(const DentryJournal& journal,
+                                                uint64_t parent,
+                                                const std::string& name,
+                                                Dentry* out) {
+    auto it = journal.find(parent);
+    if (it == journal.end()) {
+        return false;
+    }
+    auto dentryIt = it->second.find(name);
+    if (dentryIt == it->second.end()) {
+        return false;
+    }
+    if (out != nullptr) {
+        *out = dentryIt->second.dentry;
+    }
+    return true;
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::GetDentry(uint64_t parent,
+                                                     const std::string& name,
+                                                     Dentry* out) {
+    {
+        LockGuard lk(mtx_);
+        if (FindInJournal(pending_, parent, name, out) ||
+            FindInJournal(flushing_, parent, name, out)) {
+            return CURVEFS_ERROR::OK;
+        }
+    }
+
+    return dentryManager_->GetDentry(parent, name, out);
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::CreateDentry(const Dentry& dentry) {
+    return Journal(PendingEntry{dentry, absl::nullopt});
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::CreateInodeAndDentry(
+    const InodeParam& param, const Dentry& dentry) {
+    return Journal(PendingEntry{dentry, param});
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::Journal(PendingEntry entry) {
+    uint64_t parent = entry.dentry.parentinodeid();
+    std::string name = entry.dentry.name();
+    bool full = false;
+    {
+        LockGuard lk(mtx_);
+        if (FindInJournal(pending_, parent, name, nullptr) ||
+            FindInJournal(flushing_, parent, name, nullptr)) {
+            return CURVEFS_ERROR::EXISTS;
+        }
+
+        if (entry.inode.has_value()) {
+            pendingInodes_.emplace(entry.dentry.inodeid(), parent);
+        }
+        pending_[parent].emplace(std::move(name), std::move(entry));
+        ++pendingCount_;
+        pendingNum_ << 1;
+        full = pendingCount_ >= option_.maxPendingDentries;
+    }
+
+    if (full) {
+        // throttle creating if background flush can't keep up
+        CURVEFS_ERROR ret = DoFlush(nullptr);
+        if (ret != CURVEFS_ERROR::OK) {
+            LockGuard lk(mtx_);
+            flushError_ = ret;
+        }
+        RunFlushFailedCallbacks();
+    }
+    return CURVEFS_ERROR::OK;
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::DeleteDentry(
+    uint64_t parent, const std::string& name, FsFileType type) {
+    bool flush = false;
+    {
+        LockGuard lk(mtx_);
+        auto it = pending_.find(parent);
+        if (it != pending_.end()) {
+            auto entryIt = it->second.find(name);
+            if (entryIt != it->second.end() &&
+                !entryIt->second.inode.has_value()) {
+                it->second.erase(entryIt);
+                if (it->second.empty()) {
+                    pending_.erase(it);
+                }
+                --pendingCount_;
+                pendingNum_ << -1;
+                // it never reached metaserver
+                return CURVEFS_ERROR::OK;
+            }
+            // the inode journaled together is unlinked on metaserver by
+            // the caller later, so it's flushed rather than dropped
+            flush = entryIt != it->second.end();
+        }
+        flush = flush || FindInJournal(flushing_, parent, name, nullptr);
+    }
+
+    if (flush) {
+        // wait until the dentry is flushed
+        CURVEFS_ERROR ret = DoFlush(&parent);
+        if (ret != CURVEFS_ERROR::OK) {
+            LockGuard lk(mtx_);
+            flushError_ = ret;
+        }
+    }
+    return dentryManager_->DeleteDentry(parent, name, type);
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::ListDentry(
+    uint64_t parent, std::list<Dentry>* dentryList, uint32_t limit,
+    bool onlyDir, uint32_t nlink) {
+    CURVEFS_ERROR ret = DoFlush(&parent);
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(WARNING) << "Flush pending dentries before list failed, ret = "
+                     << ret << ", parent = " << parent;
+        LockGuard lk(mtx_);
+        flushError_ = ret;
+    }
+    RunFlushFailedCallbacks();
+    return dentryManager_->ListDentry(parent, dentryList, limit, onlyDir,
+                                      nlink);
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::Flush(uint64_t parent) {
+    CURVEFS_ERROR ret = DoFlush(&parent);
+    RunFlushFailedCallbacks();
+    return TakeFlushError(ret);
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::FlushAll() {
+    CURVEFS_ERROR ret = DoFlush(nullptr);
+    RunFlushFailedCallbacks();
+    return TakeFlushError(ret);
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::FlushInode(uint64_t inodeId) {
+    uint64_t parent = 0;
+    {
+        LockGuard lk(mtx_);
+        auto failed = failedInodes_.find(inodeId);
+        if (failed != failedInodes_.end()) {
+            return failed->second;
+        }
+        auto it = pendingInodes_.find(inodeId);
+        if (it == pendingInodes_.end()) {
+            return CURVEFS_ERROR::OK;
+        }
+        parent = it->second;
+    }
+
+    CURVEFS_ERROR ret = DoFlush(&parent);
+    LockGuard lk(mtx_);
+    if (ret != CURVEFS_ERROR::OK) {
+        flushError_ = ret;
+    }
+    auto failed = failedInodes_.find(inodeId);
+    return failed != failedInodes_.end() ? failed->second
+                                         : CURVEFS_ERROR::OK;
+}
+
+uint64_t WriteBackDentryCacheManager::PendingCount() {
+    LockGuard lk(mtx_);
+    return pendingCount_;
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::TakeFlushError(CURVEFS_ERROR ret) {
+    LockGuard lk(mtx_);
+    if (ret == CURVEFS_ERROR::OK) {
+        ret = flushError_;
+    }
+    flushError_ = CURVEFS_ERROR::OK;
+    return ret;
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::DoFlush(const uint64_t* parent) {
+    LockGuard flushLk(flushMtx_);
+    std::vector<const PendingEntry*> entries;
+    {
+        LockGuard lk(mtx_);
+        if (parent == nullptr) {
+            flushing_.swap(pending_);
+        } else {
+            auto it = pending_.find(*parent);
+            if (it != pending_.end()) {
+                flushing_[*parent].swap(it->second);
+                pending_.erase(it);
+            }
+        }
+        for (const auto& dir : flushing_) {
+            for (const auto& item : dir.second) {
+                entries.push_back(&item.second);
+            }
+        }
+        pendingCount_ -= entries.size();
+        pendingNum_ << -static_cast<int64_t>(entries.size());
+    }
+
+    if (entries.empty()) {
+        return CURVEFS_ERROR::OK;
+    }
+
+    // entries are stable until |flushing_| is cleared, which is only
+    // modified by the flush holding |flushMtx_|
+    uint64_t start = TimeUtility::GetTimeofDayUs();
+    CountDownEvent cond(entries.size());
+    std::vector<CURVEFS_ERROR> rets(entries.size(), CURVEFS_ERROR::OK);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const PendingEntry* entry = entries[i];
+        CURVEFS_ERROR* ret = &rets[i];
+        flushPool_.Enqueue([this, entry, ret, &cond]() {
+            *ret = FlushEntry(*entry);
+            cond.Signal();
+        });
+    }
+    cond.Wait();
+    flushLatency_ << TimeUtility::GetTimeofDayUs() - start;
+
+    CURVEFS_ERROR flushRet = CURVEFS_ERROR::OK;
+    LockGuard lk(mtx_);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const PendingEntry& entry = *entries[i];
+        bool withInode = entry.inode.has_value();
+        if (withInode) {
+            pendingInodes_.erase(entry.dentry.inodeid());
+        }
+        if (rets[i] == CURVEFS_ERROR::OK) {
+            continue;
+        }
+        flushRet = rets[i];
+        if (withInode) {
+            failedInodes_[entry.dentry.inodeid()] = rets[i];
+        }
+        failedEntries_.push_back(FailedEntry{entry.dentry, withInode, rets[i]});
+    }
+
+    VLOG(6) << "Flush " << entries.size() << " dentries, ret = "
+            << flushRet;
+    flushing_.clear();
+    return flushRet;
+}
+
+CURVEFS_ERROR WriteBackDentryCacheManager::FlushEntry(
+    const PendingEntry& entry) {
+    const Dentry& dentry = entry.dentry;
+    if (entry.inode.has_value() && option_.createInodeAndDentry) {
+        // the leased id can be used in one request only if it belongs to
+        // the partition of parent, otherwise fall back to two requests
+        Inode inode;
+        MetaStatusCode st = metaClient_->CreateInodeAndDentry(
+            entry.inode.value(), dentry.name(), &inode);
+        if (st == MetaStatusCode::OK) {
+            dentryManager_->InsertOrReplaceCache(dentry);
+            return CURVEFS_ERROR::OK;
+        } else if (st != MetaStatusCode::PARTITION_ID_MISSMATCH &&
+                   st != MetaStatusCode::PARTITION_ALLOC_ID_FAIL) {
+            LOG(ERROR) << "Flush inode and dentry failed, ret = "
+                       << MetaStatusCode_Name(st)
+                       << ", parent = " << dentry.parentinodeid()
+                       << ", name = " << dentry.name()
+                       << ", inodeid = " << dentry.inodeid();
+            return MetaStatusCodeToCurvefsErrCode(st);
+        }
+    }
+
+    if (entry.inode.has_value()) {
+        Inode inode;
+        MetaStatusCode st = metaClient_->CreateInode(entry.inode.value(),
+                                                     &inode);
+        if (st != MetaStatusCode::OK) {
+            LOG(ERROR) << "Flush inode failed, ret = "
+                       << MetaStatusCode_Name(st)
+                       << ", parent = " << dentry.parentinodeid()
+                       << ", name = " << dentry.name()
+                       << ", inodeid = " << dentry.inodeid();
+            return MetaStatusCodeToCurvefsErrCode(st);
+        }
+    }
+
+    CURVEFS_ERROR ret = dentryManager_->CreateDentry(dentry);
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "Flush dentry failed, ret = " << ret
+                   << ", parent = " << dentry.parentinodeid()
+                   << ", name = " << dentry.name()
+                   << ", inodeid = " << dentry.inodeid();
+        if (entry.inode.has_value()) {
+            MetaStatusCode st =
+                metaClient_->DeleteInode(dentry.fsid(), dentry.inodeid());
+            LOG_IF(ERROR, st != MetaStatusCode::OK &&
+                              st != MetaStatusCode::NOT_FOUND)
+                << "Delete inode of the failed dentry failed, ret = "
+                << MetaStatusCode_Name(st)
+                << ", inodeid = " << dentry.inodeid();
+        }
+    }
+    return ret;
+}
+
+void WriteBackDentryCacheManager::RunFlushFailedCallbacks() {
+    std::vector<FailedEntry> failed;
+    {
+        LockGuard lk(mtx_);
+        failed.swap(failedEntries_);
+    }
+    if (failed.empty()) {
+        return;
+    }
+
+    for (const FailedEntry& entry : failed) {
+        if (flushFailedCallback_) {
+            flushFailedCallback_(entry.dentry, entry.withInode, entry.ret);
+        }
+    }
+
+    LockGuard lk(mtx_);
+    for (const FailedEntry& entry : failed) {
+        if (entry.withInode) {
+            failedInodes_.erase(entry.dentry.inodeid());
+        }
+    }
+}
+
+void WriteBackDentryCacheManager::FlushBackground() {
+    LOG(INFO) << "Dentry write back thread is start.";
+    while (sleeper_.wait_for(
+        std::chrono::milliseconds(option_.flushIntervalMs))) {
+        CURVEFS_ERROR ret = DoFlush(nullptr);
+        if (ret != CURVEFS_ERROR::OK) {
+            LockGuard lk(mtx_);
+            flushError_ = ret;
+        }
+        RunFlushFailedCallbacks();
+    }
+    LOG(INFO) << "Dentry write back thread is stop.";
+}
+
+}  // namespace client
+}  // namespace curvefs
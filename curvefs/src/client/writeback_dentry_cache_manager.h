@@ -0,0 +1,210 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-31
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_WRITEBACK_DENTRY_CACHE_MANAGER_H_
+#define CURVEFS_SRC_CLIENT_WRITEBACK_DENTRY_CACHE_MANAGER_H_
+
+#include <bvar/bvar.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "curvefs/src/client/common/config.h"
+#include "curvefs/src/client/dentry_cache_manager.h"
+#include "curvefs/src/client/rpcclient/metaserver_client.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/concurrent/task_thread_pool.h"
+#include "src/common/interruptible_sleeper.h"
+
+namespace curvefs {
+namespace client {
+
+using common::DentryWriteBackOption;
+using rpcclient::InodeParam;
+using rpcclient::MetaServerClient;
+
+// Write-back dentry cache, which wraps another DentryCacheManager.
+//
+// New dentries are acknowledged once they are journaled in memory, and
+// flushed to metaserver in batches by a background thread. Until flushed,
+// they are served from the journal, and a dentry removed before flushed
+// never reaches metaserver, unless its inode is journaled together.
+// Removing a flushed dentry and listing a directory always go to
+// metaserver, so pending dentries of the directory are flushed before
+// listing it.
+//
+// It's designed for workloads with a single writer per directory, the
+// existence of a new dentry is only checked against local state, and a
+// conflict found by metaserver is reported by the next Flush.
+//
+// A new entry may be journaled together with its inode, which is created
+// locally with a leased inode id. Such an inode is created on metaserver
+// right before its dentry is flushed, and deleted if the dentry failed,
+// FlushInode flushes it early for requests to metaserver about it.
+class WriteBackDentryCacheManager : public DentryCacheManager {
+ public:
+    // Called when a pending dentry failed to flush, |withInode| is true if
+    // its inode was journaled together, which doesn't exist on metaserver.
+    // It's never called by FlushInode, which may hold locks of inodes.
+    using FlushFailedCallback = std::function<void(
+        const Dentry& dentry, bool withInode, CURVEFS_ERROR ret)>;
+
+    WriteBackDentryCacheManager(
+        const std::shared_ptr<DentryCacheManager>& dentryManager,
+        const std::shared_ptr<MetaServerClient>& metaClient,
+        const DentryWriteBackOption& option);
+
+    ~WriteBackDentryCacheManager() override;
+
+    void SetFsId(uint32_t fsId) override;
+
+    void SetFlushFailedCallback(const FlushFailedCallback& callback) {
+        flushFailedCallback_ = callback;
+    }
+
+    CURVEFS_ERROR Init(uint64_t cacheSize, bool enableCacheMetrics,
+                       uint32_t cacheTimeOutSec) override;
+
+    /**
+     * @brief Flush all pending dentries and stop the background flushing
+     */
+    void Stop();
+
+    void InsertOrReplaceCache(const Dentry& dentry) override;
+
+    void DeleteCache(uint64_t parentId, const std::string& name) override;
+
+    CURVEFS_ERROR GetDentry(uint64_t parent, const std::string& name,
+                            Dentry* out) override;
+
+    CURVEFS_ERROR CreateDentry(const Dentry& dentry) override;
+
+    /**
+     * @brief Journal |dentry| together with its inode created locally
+     * @param param the inode, with leased inode id and create time set
+     */
+    CURVEFS_ERROR CreateInodeAndDentry(const InodeParam& param,
+                                       const Dentry& dentry);
+
+    CURVEFS_ERROR DeleteDentry(uint64_t parent, const std::string& name,
+                               FsFileType type) override;
+
+    CURVEFS_ERROR ListDentry(uint64_t parent, std::list<Dentry>* dentryList,
+                             uint32_t limit, bool onlyDir = false,
+                             uint32_t nlink = 0) override;
+
+    /**
+     * @brief Flush pending dentries under |parent|
+     * @return error of this flush or any background flush since last call
+     */
+    CURVEFS_ERROR Flush(uint64_t parent);
+
+    /**
+     * @brief Flush all pending dentries
+     * @return error of this flush or any background flush since last call
+     */
+    CURVEFS_ERROR FlushAll();
+
+    /**
+     * @brief Create inode |inodeId| on metaserver if it's journaled, by
+     *        flushing pending dentries under its parent
+     * @return error of creating the inode or its dentry
+     */
+    CURVEFS_ERROR FlushInode(uint64_t inodeId);
+
+    uint64_t PendingCount();
+
+ private:
+    struct PendingEntry {
+        Dentry dentry;
+        // set if the inode is journaled together
+        absl::optional<InodeParam> inode;
+    };
+
+    struct FailedEntry {
+        Dentry dentry;
+        bool withInode;
+        CURVEFS_ERROR ret;
+    };
+
+    // pending entries, parent inode id -> name -> entry
+    using DentryJournal =
+        std::map<uint64_t, std::map<std::string, PendingEntry>>;
+
+    static bool FindInJournal(const DentryJournal& journal, uint64_t parent,
+                              const std::string& name, Dentry* out);
+
+    CURVEFS_ERROR Journal(PendingEntry entry);
+
+    // flush pending dentries under |parent|, or all if |parent| is nullptr
+    CURVEFS_ERROR DoFlush(const uint64_t* parent);
+
+    CURVEFS_ERROR FlushEntry(const PendingEntry& entry);
+
+    // run callbacks of failed entries, with no lock held
+    void RunFlushFailedCallbacks();
+
+    CURVEFS_ERROR TakeFlushError(CURVEFS_ERROR ret);
+
+    void FlushBackground();
+
+ private:
+    std::shared_ptr<DentryCacheManager> dentryManager_;
+    std::shared_ptr<MetaServerClient> metaClient_;
+    DentryWriteBackOption option_;
+    FlushFailedCallback flushFailedCallback_;
+
+    curve::common::Mutex mtx_;
+    DentryJournal pending_;
+    uint64_t pendingCount_;
+    // dentries being flushed, they are visible until flush finished
+    DentryJournal flushing_;
+    // journaled inodes not flushed yet, inode id -> parent inode id
+    std::unordered_map<uint64_t, uint64_t> pendingInodes_;
+    // journaled inodes failed to flush, until their callbacks are run
+    std::unordered_map<uint64_t, CURVEFS_ERROR> failedInodes_;
+    std::vector<FailedEntry> failedEntries_;
+    // error of background flush, reported by the next Flush or FlushAll
+    CURVEFS_ERROR flushError_;
+
+    // only one flush at a time, so dentries are flushed in order
+    curve::common::Mutex flushMtx_;
+    curve::common::TaskThreadPool<> flushPool_;
+
+    curve::common::Thread flushThread_;
+    curve::common::InterruptibleSleeper sleeper_;
+    curve::common::Atomic<bool> running_;
+
+    bvar::Adder<int64_t> pendingNum_;
+    bvar::LatencyRecorder flushLatency_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_WRITEBACK_DENTRY_CACHE_MANAGER_H_
@@ -32,6 +32,7 @@
 #include <string>
 
 #include "curvefs/src/metaserver/copyset/apply_queue.h"
+#include "curvefs/src/metaserver/copyset/proposal_batcher.h"
 #include "curvefs/src/metaserver/copyset/trash.h"
 #include "curvefs/src/metaserver/storage/config.h"
 #include "src/fs/local_filesystem.h"
@@ -76,6 +77,9 @@ struct CopysetNodeOptions {
     // apply queue options
     ApplyQueueOption applyQueueOption;
 
+    // options for packing small mutations into one raft log entry
+    ProposalBatchOption proposalBatchOption;
+
     // filesystem adaptor
     curve::fs::LocalFileSystem* localFileSystem;
 
@@ -97,6 +101,7 @@ inline CopysetNodeOptions::CopysetNodeOptions()
       finishLoadMargin(2000),
       checkLoadMarginIntervalMs(1000),
       applyQueueOption(),
+      proposalBatchOption(),
       localFileSystem(nullptr),
       trashOptions(),
       raftNodeOptions() {}
@@ -82,6 +82,7 @@ CopysetNode::CopysetNode(PoolId poolId, CopysetId copysetId,
       appliedIndex_(0),
       epochFile_(),
       applyQueue_(nullptr),
+      proposalBatcher_(nullptr),
       latestLoadSnapshotIndex_(0),
       confChangeMtx_(),
       ongoingConfChange_(),
@@ -126,6 +127,15 @@ bool CopysetNode::Init(const CopysetNodeOptions& options) {
         return false;
     }
 
+    if (options_.proposalBatchOption.enable) {
+        proposalBatcher_ =
+            absl::make_unique<ProposalBatcher>(this, poolId_, copysetId_);
+        if (!proposalBatcher_->Start(options_.proposalBatchOption)) {
+            LOG(ERROR) << "Start proposal batcher failed";
+            return false;
+        }
+    }
+
     options_.storageOptions.dataDir = copysetDataPath_ + "/" + kStorageDataPath;
 
     // create metastore
@@ -164,6 +174,11 @@ bool CopysetNode::Start() {
 }
 
 void CopysetNode::Stop() {
+    // propose queued operators before shutdown raft node
+    if (proposalBatcher_) {
+        proposalBatcher_->Stop();
+    }
+
     if (raftNode_) {
         raftNode_->shutdown(nullptr);
         raftNode_->join();
@@ -245,39 +260,56 @@ void CopysetNode::on_apply(braft::Iterator& iter) {
         braft::AsyncClosureGuard doneGuard(iter.done());
 
         if (iter.done()) {
+            // operators packed in one log entry are pushed to apply queue in
+            // the order they were proposed, and each one completes itself
+            auto* batchClosure =
+                dynamic_cast<BatchMetaOperatorClosure*>(iter.done());
+            if (batchClosure != nullptr) {
+                for (auto* op : batchClosure->ReleaseOperators()) {
+                    PushToApplyQueue(op, iter.index(),
+                                     new MetaOperatorClosure(op));
+                }
+                continue;
+            }
+
             MetaOperatorClosure* metaClosure =
                 dynamic_cast<MetaOperatorClosure*>(iter.done());
             CHECK(metaClosure != nullptr) << "dynamic cast failed";
-            metaClosure->GetOperator()->timerPropose.stop();
-            g_oprequest_propose_latency
-                << metaClosure->GetOperator()->timerPropose.u_elapsed();
-            butil::Timer timer;
-            timer.start();
-            auto task =
-                std::bind(&MetaOperator::OnApply, metaClosure->GetOperator(),
-                          iter.index(), doneGuard.release(),
-                          TimeUtility::GetTimeofDayUs());
-            applyQueue_->Push(metaClosure->GetOperator()->HashCode(),
-                              std::move(task));
-            timer.stop();
-            g_concurrent_apply_wait_latency << timer.u_elapsed();
+            PushToApplyQueue(metaClosure->GetOperator(), iter.index(),
+                             doneGuard.release());
         } else {
             // parse request from raft-log
-            auto metaOperator = RaftLogCodec::Decode(this, iter.data());
-            CHECK(metaOperator != nullptr) << "Decode raft log failed";
-            butil::Timer timer;
-            timer.start();
-            auto hashcode = metaOperator->HashCode();
-            auto task =
-                std::bind(&MetaOperator::OnApplyFromLog, metaOperator.release(),
-                          TimeUtility::GetTimeofDayUs());
-            applyQueue_->Push(hashcode, std::move(task));
-            timer.stop();
-            g_concurrent_apply_from_log_wait_latency << timer.u_elapsed();
+            std::vector<std::unique_ptr<MetaOperator>> metaOperators;
+            CHECK(RaftLogCodec::DecodeBatch(this, iter.data(), &metaOperators))
+                << "Decode raft log failed";
+            for (auto& metaOperator : metaOperators) {
+                butil::Timer timer;
+                timer.start();
+                auto hashcode = metaOperator->HashCode();
+                auto task = std::bind(&MetaOperator::OnApplyFromLog,
+                                      metaOperator.release(),
+                                      TimeUtility::GetTimeofDayUs());
+                applyQueue_->Push(hashcode, std::move(task));
+                timer.stop();
+                g_concurrent_apply_from_log_wait_latency << timer.u_elapsed();
+            }
         }
     }
 }
 
+void CopysetNode::PushToApplyQueue(MetaOperator* op, int64_t index,
+                                   google::protobuf::Closure* done) {
+    op->timerPropose.stop();
+    g_oprequest_propose_latency << op->timerPropose.u_elapsed();
+    butil::Timer timer;
+    timer.start();
+    auto task = std::bind(&MetaOperator::OnApply, op, index, done,
+                          TimeUtility::GetTimeofDayUs());
+    applyQueue_->Push(op->HashCode(), std::move(task));
+    timer.stop();
+    g_concurrent_apply_wait_latency << timer.u_elapsed();
+}
+
 void CopysetNode::on_shutdown() {
     LOG(INFO) << "Copyset: " << name_ << " is shutdown";
 }
@@ -36,6 +36,7 @@
 #include "curvefs/src/metaserver/copyset/config.h"
 #include "curvefs/src/metaserver/copyset/copyset_conf_change.h"
 #include "curvefs/src/metaserver/copyset/metric.h"
+#include "curvefs/src/metaserver/copyset/proposal_batcher.h"
 #include "curvefs/src/metaserver/copyset/raft_node.h"
 #include "curvefs/src/metaserver/metastore.h"
 
@@ -49,6 +50,7 @@ using ::curvefs::metaserver::MetaStore;
 using ::curve::mds::heartbeat::ConfigChangeType;
 
 class CopysetNodeManager;
+class MetaOperator;
 
 // Implement our own business raft state machine
 class CopysetNode : public braft::StateMachine {
@@ -110,6 +112,11 @@ class CopysetNode : public braft::StateMachine {
 
     ApplyQueue* GetApplyQueue() const;
 
+    /**
+     * @brief Get proposal batcher, return nullptr if batch is disabled
+     */
+    ProposalBatcher* GetProposalBatcher() const;
+
     OperatorMetric* GetMetric() const;
 
     const std::string& Name() const;
@@ -185,6 +192,12 @@ class CopysetNode : public braft::StateMachine {
     bool FetchLeaderStatus(const braft::PeerId& peerId,
                            braft::NodeStatus* leaderStatus);
 
+    /**
+     * @brief Push an operator proposed by this node to apply queue
+     */
+    void PushToApplyQueue(MetaOperator* op, int64_t index,
+                          google::protobuf::Closure* done);
+
  private:
     const PoolId poolId_;
     const CopysetId copysetId_;
@@ -221,6 +234,8 @@ class CopysetNode : public braft::StateMachine {
 
     std::unique_ptr<ApplyQueue> applyQueue_;
 
+    std::unique_ptr<ProposalBatcher> proposalBatcher_;
+
     mutable Mutex confMtx_;
 
     int64_t latestLoadSnapshotIndex_;
@@ -277,6 +292,10 @@ inline ApplyQueue* CopysetNode::GetApplyQueue() const {
     return applyQueue_.get();
 }
 
+inline ProposalBatcher* CopysetNode::GetProposalBatcher() const {
+    return proposalBatcher_.get();
+}
+
 inline OperatorMetric* CopysetNode::GetMetric() const {
     return metric_.get();
 }
@@ -32,6 +32,7 @@
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/common/rpc_stream.h"
 #include "curvefs/src/metaserver/copyset/meta_operator_closure.h"
+#include "curvefs/src/metaserver/copyset/proposal_batcher.h"
 #include "curvefs/src/metaserver/copyset/raft_log_codec.h"
 #include "curvefs/src/metaserver/metastore.h"
 #include "curvefs/src/metaserver/streaming_utils.h"
@@ -83,6 +84,7 @@ void MetaOperator::RedirectRequest() {
 
 bool MetaOperator::ProposeTask() {
     timerPropose.start();
+    OnPropose();
     butil::IOBuf log;
     bool success = RaftLogCodec::Encode(GetOperatorType(), request_, &log);
     if (!success) {
@@ -93,6 +95,13 @@ bool MetaOperator::ProposeTask() {
         return false;
     }
 
+    // small mutations are packed into one raft log entry if possible
+    auto* batcher = node_->GetProposalBatcher();
+    if (batcher != nullptr && CanBatchPropose() &&
+        batcher->Propose(this, &log, node_->LeaderTerm())) {
+        return true;
+    }
+
     braft::Task task;
     task.data = &log;
     task.done = new MetaOperatorClosure(this);
@@ -150,6 +159,26 @@ bool GetVolumeExtentOperator::CanBypassPropose() const {
            node_->GetAppliedIndex() >= req->appliedindex();
 }
 
+void AllocInodeIdsOperator::OnPropose() {
+    // request from rpc is const, so propose a copy of it
+    proposedRequest_.CopyFrom(
+        *static_cast<const AllocInodeIdsRequest*>(request_));
+    proposedRequest_.set_timestampms(TimeUtility::GetTimeofDayMs());
+    request_ = &proposedRequest_;
+}
+
+#define OPERATOR_CAN_BATCH_PROPOSE(TYPE)           \
+    bool TYPE##Operator::CanBatchPropose() const { \
+        return true;                               \
+    }
+
+OPERATOR_CAN_BATCH_PROPOSE(CreateDentry);
+OPERATOR_CAN_BATCH_PROPOSE(CreateInode);
+OPERATOR_CAN_BATCH_PROPOSE(CreateInodeAndDentry);
+OPERATOR_CAN_BATCH_PROPOSE(UpdateInode);
+
+#undef OPERATOR_CAN_BATCH_PROPOSE
+
 #define OPERATOR_ON_APPLY(TYPE)                                        \
     void TYPE##Operator::OnApply(int64_t index,                        \
                                  google::protobuf::Closure* done,      \
@@ -190,6 +219,8 @@ OPERATOR_ON_APPLY(UpdateInode);
 OPERATOR_ON_APPLY(DeleteInode);
 OPERATOR_ON_APPLY(CreateRootInode);
 OPERATOR_ON_APPLY(CreateManageInode);
+OPERATOR_ON_APPLY(CreateInodeAndDentry);
+OPERATOR_ON_APPLY(AllocInodeIds);
 OPERATOR_ON_APPLY(CreatePartition);
 OPERATOR_ON_APPLY(DeletePartition);
 OPERATOR_ON_APPLY(PrepareRenameTx);
@@ -316,6 +347,8 @@ OPERATOR_ON_APPLY_FROM_LOG(UpdateInode);
 OPERATOR_ON_APPLY_FROM_LOG(DeleteInode);
 OPERATOR_ON_APPLY_FROM_LOG(CreateRootInode);
 OPERATOR_ON_APPLY_FROM_LOG(CreateManageInode);
+OPERATOR_ON_APPLY_FROM_LOG(CreateInodeAndDentry);
+OPERATOR_ON_APPLY_FROM_LOG(AllocInodeIds);
 OPERATOR_ON_APPLY_FROM_LOG(CreatePartition);
 OPERATOR_ON_APPLY_FROM_LOG(DeletePartition);
 OPERATOR_ON_APPLY_FROM_LOG(PrepareRenameTx);
@@ -372,6 +405,8 @@ OPERATOR_REDIRECT(GetOrModifyS3ChunkInfo);
 OPERATOR_REDIRECT(DeleteInode);
 OPERATOR_REDIRECT(CreateRootInode);
 OPERATOR_REDIRECT(CreateManageInode);
+OPERATOR_REDIRECT(CreateInodeAndDentry);
+OPERATOR_REDIRECT(AllocInodeIds);
 OPERATOR_REDIRECT(CreatePartition);
 OPERATOR_REDIRECT(DeletePartition);
 OPERATOR_REDIRECT(PrepareRenameTx);
@@ -398,6 +433,8 @@ OPERATOR_ON_FAILED(GetOrModifyS3ChunkInfo);
 OPERATOR_ON_FAILED(DeleteInode);
 OPERATOR_ON_FAILED(CreateRootInode);
 OPERATOR_ON_FAILED(CreateManageInode);
+OPERATOR_ON_FAILED(CreateInodeAndDentry);
+OPERATOR_ON_FAILED(AllocInodeIds);
 OPERATOR_ON_FAILED(CreatePartition);
 OPERATOR_ON_FAILED(DeletePartition);
 OPERATOR_ON_FAILED(PrepareRenameTx);
@@ -424,6 +461,8 @@ OPERATOR_HASH_CODE(GetOrModifyS3ChunkInfo);
 OPERATOR_HASH_CODE(DeleteInode);
 OPERATOR_HASH_CODE(CreateRootInode);
 OPERATOR_HASH_CODE(CreateManageInode);
+OPERATOR_HASH_CODE(CreateInodeAndDentry);
+OPERATOR_HASH_CODE(AllocInodeIds);
 OPERATOR_HASH_CODE(PrepareRenameTx);
 OPERATOR_HASH_CODE(DeletePartition);
 OPERATOR_HASH_CODE(GetVolumeExtent);
@@ -460,6 +499,8 @@ OPERATOR_TYPE(GetOrModifyS3ChunkInfo);
 OPERATOR_TYPE(DeleteInode);
 OPERATOR_TYPE(CreateRootInode);
 OPERATOR_TYPE(CreateManageInode);
+OPERATOR_TYPE(CreateInodeAndDentry);
+OPERATOR_TYPE(AllocInodeIds);
 OPERATOR_TYPE(PrepareRenameTx);
 OPERATOR_TYPE(CreatePartition);
 OPERATOR_TYPE(DeletePartition);
@@ -140,6 +140,20 @@ class MetaOperator {
         return false;
     }
 
+    /**
+     * @brief Whether an operator can be packed with others into one raft log
+     *        entry, return true if operator is a small mutation
+     */
+    virtual bool CanBatchPropose() const {
+        return false;
+    }
+
+    /**
+     * @brief Called on leader before the request is encoded into raft log,
+     *        an operator fills the fields decided by leader here
+     */
+    virtual void OnPropose() {}
+
  protected:
     CopysetNode* node_;
 
@@ -221,6 +235,7 @@ class CreateDentryOperator : public MetaOperator {
     void Redirect() override;
 
     void OnFailed(MetaStatusCode code) override;
+    bool CanBatchPropose() const override;
 };
 
 class DeleteDentryOperator : public MetaOperator {
@@ -322,6 +337,7 @@ class CreateInodeOperator : public MetaOperator {
     void Redirect() override;
 
     void OnFailed(MetaStatusCode code) override;
+    bool CanBatchPropose() const override;
 };
 
 class UpdateInodeOperator : public MetaOperator {
@@ -341,6 +357,7 @@ class UpdateInodeOperator : public MetaOperator {
     void Redirect() override;
 
     void OnFailed(MetaStatusCode code) override;
+    bool CanBatchPropose() const override;
 };
 
 class GetOrModifyS3ChunkInfoOperator : public MetaOperator {
@@ -419,6 +436,53 @@ class CreateManageInodeOperator : public MetaOperator {
     void OnFailed(MetaStatusCode code) override;
 };
 
+class CreateInodeAndDentryOperator : public MetaOperator {
+ public:
+    using MetaOperator::MetaOperator;
+
+    void OnApply(int64_t index, google::protobuf::Closure* done,
+                 uint64_t startTimeUs) override;
+
+    void OnApplyFromLog(uint64_t startTimeUs) override;
+
+    uint64_t HashCode() const override;
+
+    OperatorType GetOperatorType() const override;
+
+ private:
+    void Redirect() override;
+
+    void OnFailed(MetaStatusCode code) override;
+    bool CanBatchPropose() const override;
+};
+
+class AllocInodeIdsOperator : public MetaOperator {
+ public:
+    using MetaOperator::MetaOperator;
+
+    void OnApply(int64_t index, google::protobuf::Closure* done,
+                 uint64_t startTimeUs) override;
+
+    void OnApplyFromLog(uint64_t startTimeUs) override;
+
+    uint64_t HashCode() const override;
+
+    OperatorType GetOperatorType() const override;
+
+ private:
+    void Redirect() override;
+
+    void OnFailed(MetaStatusCode code) override;
+
+    // set the time judging lease expiry to leader's
+    void OnPropose() override;
+
+ private:
+    // copy of the rpc request with leader's time, which is proposed and
+    // applied instead
+    AllocInodeIdsRequest proposedRequest_;
+};
+
 class UpdateInodeS3VersionOperator : public MetaOperator {
  public:
     using MetaOperator::MetaOperator;
@@ -44,6 +44,16 @@ void MetaOperatorClosure::Run() {
     operator_->RedirectRequest();
 }
 
+void BatchMetaOperatorClosure::Run() {
+    std::unique_ptr<BatchMetaOperatorClosure> selfGuard(this);
+
+    for (auto* op : operators_) {
+        auto* done = new MetaOperatorClosure(op);
+        done->status() = status();
+        done->Run();
+    }
+}
+
 }  // namespace copyset
 }  // namespace metaserver
 }  // namespace curvefs
@@ -25,6 +25,9 @@
 
 #include <braft/raft.h>
 
+#include <utility>
+#include <vector>
+
 #include "curvefs/src/metaserver/copyset/meta_operator.h"
 
 namespace curvefs {
@@ -45,6 +48,29 @@ class MetaOperatorClosure : public braft::Closure {
     MetaOperator* operator_;
 };
 
+// Closure of a raft log entry packed by multiple operators
+class BatchMetaOperatorClosure : public braft::Closure {
+ public:
+    explicit BatchMetaOperatorClosure(std::vector<MetaOperator*> ops)
+        : operators_(std::move(ops)) {}
+
+    // Run each operator's closure with current status
+    void Run() override;
+
+    /**
+     * @brief Take operators out of this closure, then each operator should
+     *        be completed by its own `MetaOperatorClosure`
+     */
+    std::vector<MetaOperator*> ReleaseOperators() {
+        std::vector<MetaOperator*> ops;
+        ops.swap(operators_);
+        return ops;
+    }
+
+ private:
+    std::vector<MetaOperator*> operators_;
+};
+
 }  // namespace copyset
 }  // namespace metaserver
 }  // namespace curvefs
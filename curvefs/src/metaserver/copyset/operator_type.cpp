@@ -66,6 +66,10 @@ const char* OperatorTypeName(OperatorType type) {
             return "GetVolumeExtent";
         case OperatorType::UpdateVolumeExtent:
             return "UpdateVolumeExtent";
+        case OperatorType::CreateInodeAndDentry:
+            return "CreateInodeAndDentry";
+        case OperatorType::AllocInodeIds:
+            return "AllocInodeIds";
         // Add new case before `OperatorType::OperatorTypeMax`
         case OperatorType::OperatorTypeMax:
             break;
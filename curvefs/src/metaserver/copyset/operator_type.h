@@ -52,6 +52,8 @@ enum class OperatorType : uint32_t {
     GetVolumeExtent = 15,
     UpdateVolumeExtent = 16,
     CreateManageInode = 17,
+    CreateInodeAndDentry = 18,
+    AllocInodeIds = 19,
     // NOTE:
     //   Add new operator before `OperatorTypeMax`
     //   And DO NOT recorder or delete previous types
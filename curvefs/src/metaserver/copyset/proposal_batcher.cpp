@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-30
+ */
+
+#include "curvefs/src/metaserver/copyset/proposal_batcher.h"
+
+#include <braft/raft.h>
+#include <glog/logging.h>
+
+#include <string>
+#include <utility>
+
+#include "curvefs/src/metaserver/copyset/copyset_node.h"
+#include "curvefs/src/metaserver/copyset/meta_operator.h"
+#include "curvefs/src/metaserver/copyset/meta_operator_closure.h"
+#include "curvefs/src/metaserver/copyset/raft_log_codec.h"
+
+namespace curvefs {
+namespace metaserver {
+namespace copyset {
+
+namespace {
+
+// window size in seconds of batch size metrics
+const time_t kBatchMetricWindowSize = 10;
+
+std::string MetricPrefix(PoolId poolId, CopysetId copysetId) {
+    return "op_batch_pool_" + std::to_string(poolId) + "_copyset_" +
+           std::to_string(copysetId);
+}
+
+}  // namespace
+
+ProposalBatcher::ProposalBatcher(CopysetNode* node, PoolId poolId,
+                                 CopysetId copysetId)
+    : node_(node),
+      option_(),
+      running_(false),
+      queue_(),
+      batchSize_(),
+      batchSizeWindow_(MetricPrefix(poolId, copysetId), "size", &batchSize_,
+                       kBatchMetricWindowSize),
+      maxBatchSize_(),
+      maxBatchSizeWindow_(MetricPrefix(poolId, copysetId), "max_size",
+                          &maxBatchSize_, kBatchMetricWindowSize),
+      proposeCount_(),
+      proposeRate_(MetricPrefix(poolId, copysetId), "propose_rate",
+                   &proposeCount_, 1) {}
+
+ProposalBatcher::~ProposalBatcher() {
+    Stop();
+}
+
+bool ProposalBatcher::Start(const ProposalBatchOption& option) {
+    if (running_) {
+        return true;
+    }
+
+    option_ = option;
+    if (option_.maxBatchSize == 0) {
+        option_.maxBatchSize = 1;
+    }
+
+    int rc = bthread::execution_queue_start(&queue_, nullptr,
+                                            &ProposalBatcher::Execute, this);
+    if (rc != 0) {
+        LOG(ERROR) << "Start proposal batch queue failed, rc: " << rc;
+        return false;
+    }
+
+    running_ = true;
+    return true;
+}
+
+void ProposalBatcher::Stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+    bthread::execution_queue_stop(queue_);
+    bthread::execution_queue_join(queue_);
+}
+
+bool ProposalBatcher::Propose(MetaOperator* op, butil::IOBuf* log,
+                              int64_t term) {
+    Proposal proposal;
+    proposal.op = op;
+    proposal.log.swap(*log);
+    proposal.term = term;
+
+    int rc = bthread::execution_queue_execute(queue_, proposal);
+    if (rc != 0) {
+        log->swap(proposal.log);
+        return false;
+    }
+    return true;
+}
+
+int ProposalBatcher::Execute(void* meta,
+                             bthread::TaskIterator<Proposal>& iter) {
+    if (iter.is_queue_stopped()) {
+        return 0;
+    }
+
+    auto* batcher = static_cast<ProposalBatcher*>(meta);
+    const ProposalBatchOption& option = batcher->option_;
+    std::vector<Proposal> batch;
+    uint64_t batchBytes = 0;
+    for (; iter; ++iter) {
+        // operators proposed in different terms can't share one log entry,
+        // because raft task is proposed with an expected term
+        if (!batch.empty() &&
+            (batch.size() >= option.maxBatchSize ||
+             batchBytes + iter->log.size() > option.maxBatchBytes ||
+             iter->term != batch.front().term)) {
+            batcher->Flush(&batch);
+            batchBytes = 0;
+        }
+
+        batchBytes += iter->log.size();
+        batch.emplace_back(std::move(*iter));
+    }
+
+    if (!batch.empty()) {
+        batcher->Flush(&batch);
+    }
+
+    return 0;
+}
+
+void ProposalBatcher::Flush(std::vector<Proposal>* batch) {
+    braft::Task task;
+    butil::IOBuf log;
+
+    if (batch->size() == 1) {
+        // single operator is proposed as before, so the raft log entry is
+        // the same as operator proposed without batcher
+        log.swap(batch->front().log);
+        task.done = new MetaOperatorClosure(batch->front().op);
+    } else {
+        std::vector<butil::IOBuf> logs;
+        std::vector<MetaOperator*> ops;
+        logs.reserve(batch->size());
+        ops.reserve(batch->size());
+        for (auto& proposal : *batch) {
+            logs.emplace_back(std::move(proposal.log));
+            ops.push_back(proposal.op);
+        }
+
+        RaftLogCodec::EncodeBatch(logs, &log);
+        task.done = new BatchMetaOperatorClosure(std::move(ops));
+    }
+
+    task.data = &log;
+    task.expected_term = batch->front().term;
+    node_->Propose(task);
+
+    batchSize_ << batch->size();
+    maxBatchSize_ << batch->size();
+    proposeCount_ << 1;
+    batch->clear();
+}
+
+}  // namespace copyset
+}  // namespace metaserver
+}  // namespace curvefs
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-30
+ */
+
+#ifndef CURVEFS_SRC_METASERVER_COPYSET_PROPOSAL_BATCHER_H_
+#define CURVEFS_SRC_METASERVER_COPYSET_PROPOSAL_BATCHER_H_
+
+#include <bthread/execution_queue.h>
+#include <butil/iobuf.h>
+#include <bvar/bvar.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "curvefs/src/metaserver/common/types.h"
+
+namespace curvefs {
+namespace metaserver {
+namespace copyset {
+
+class CopysetNode;
+class MetaOperator;
+
+struct ProposalBatchOption {
+    // whether pack small mutations into one raft log entry
+    bool enable = false;
+
+    // maximum number of operators in one raft log entry
+    uint32_t maxBatchSize = 64;
+
+    // maximum encoded size of operators in one raft log entry
+    uint32_t maxBatchBytes = 1024 * 1024;
+};
+
+// Packs operators proposed to one copyset into a single raft log entry.
+//
+// Operators are queued into an execution queue, and all operators that
+// arrived while the previous batch was being proposed are packed together,
+// so a lone operator is proposed immediately without extra latency.
+// Operators in a batch are applied in the order they were proposed.
+class ProposalBatcher {
+ public:
+    ProposalBatcher(CopysetNode* node, PoolId poolId, CopysetId copysetId);
+
+    ~ProposalBatcher();
+
+    ProposalBatcher(const ProposalBatcher&) = delete;
+    ProposalBatcher& operator=(const ProposalBatcher&) = delete;
+
+    bool Start(const ProposalBatchOption& option);
+
+    /**
+     * @brief Stop the batcher, queued operators are proposed before return
+     */
+    void Stop();
+
+    /**
+     * @brief Queue an operator for proposing
+     * @param op operator to propose, owned by the raft task after proposed
+     * @param log encoded raft log of |op|, its content is moved on success
+     * @param term leader term when |op| is proposed
+     * @return true if success, otherwise caller should propose |op| itself
+     */
+    bool Propose(MetaOperator* op, butil::IOBuf* log, int64_t term);
+
+ private:
+    struct Proposal {
+        MetaOperator* op = nullptr;
+        butil::IOBuf log;
+        int64_t term = 0;
+    };
+
+    static int Execute(void* meta, bthread::TaskIterator<Proposal>& iter);
+
+    void Flush(std::vector<Proposal>* batch);
+
+ private:
+    CopysetNode* node_;
+    ProposalBatchOption option_;
+
+    bool running_;
+    bthread::ExecutionQueueId<Proposal> queue_;
+
+    // average and maximum number of operators in one raft log entry
+    bvar::IntRecorder batchSize_;
+    bvar::Window<bvar::IntRecorder> batchSizeWindow_;
+    bvar::Maxer<uint64_t> maxBatchSize_;
+    bvar::Window<bvar::Maxer<uint64_t>> maxBatchSizeWindow_;
+
+    // number of raft log entries proposed
+    bvar::Adder<uint64_t> proposeCount_;
+    bvar::PerSecond<bvar::Adder<uint64_t>> proposeRate_;
+};
+
+}  // namespace copyset
+}  // namespace metaserver
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_METASERVER_COPYSET_PROPOSAL_BATCHER_H_
@@ -27,6 +27,7 @@
 
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 #include "curvefs/proto/metaserver.pb.h"
 
@@ -95,16 +96,81 @@ bool RaftLogCodec::Encode(OperatorType type,
 
 std::unique_ptr<MetaOperator> RaftLogCodec::Decode(CopysetNode* node,
                                                    butil::IOBuf log) {
-    uint32_t logtype;
-    log.cutn(&logtype, kOperatorTypeSize);
-    logtype = butil::NetToHost32(logtype);
+    return DecodeOne(node, &log);
+}
+
+void RaftLogCodec::EncodeBatch(const std::vector<butil::IOBuf>& logs,
+                               butil::IOBuf* log) {
+    const uint32_t networkType = butil::HostToNet32(kBatchLogType);
+    log->append(&networkType, sizeof(networkType));
+
+    const uint32_t networkCount =
+        butil::HostToNet32(static_cast<uint32_t>(logs.size()));
+    log->append(&networkCount, sizeof(networkCount));
+
+    for (const auto& l : logs) {
+        log->append(l);
+    }
+}
+
+bool RaftLogCodec::DecodeBatch(
+    CopysetNode* node, butil::IOBuf log,
+    std::vector<std::unique_ptr<MetaOperator>>* ops) {
+    uint32_t logtype = 0;
+    if (log.copy_to(&logtype, sizeof(logtype)) != sizeof(logtype)) {
+        LOG(ERROR) << "Raft log is too short, size: " << log.size();
+        return false;
+    }
+
+    if (butil::NetToHost32(logtype) != kBatchLogType) {
+        auto op = DecodeOne(node, &log);
+        if (op == nullptr) {
+            return false;
+        }
+        ops->push_back(std::move(op));
+        return true;
+    }
+
+    log.pop_front(sizeof(logtype));
+    uint32_t count = 0;
+    if (log.cutn(&count, sizeof(count)) != sizeof(count)) {
+        LOG(ERROR) << "Batch raft log is too short";
+        return false;
+    }
+    count = butil::NetToHost32(count);
+
+    ops->reserve(ops->size() + count);
+    for (uint32_t i = 0; i < count; ++i) {
+        auto op = DecodeOne(node, &log);
+        if (op == nullptr) {
+            LOG(ERROR) << "Fail to decode operator " << i
+                       << " from batch raft log, count: " << count;
+            return false;
+        }
+        ops->push_back(std::move(op));
+    }
+
+    return true;
+}
 
-    uint32_t metaSize;
-    log.cutn(&metaSize, sizeof(metaSize));
+std::unique_ptr<MetaOperator> RaftLogCodec::DecodeOne(CopysetNode* node,
+                                                      butil::IOBuf* log) {
+    uint32_t logtype = 0;
+    uint32_t metaSize = 0;
+    if (log->cutn(&logtype, kOperatorTypeSize) != kOperatorTypeSize ||
+        log->cutn(&metaSize, sizeof(metaSize)) != sizeof(metaSize)) {
+        LOG(ERROR) << "Raft log is too short";
+        return nullptr;
+    }
+    logtype = butil::NetToHost32(logtype);
     metaSize = butil::NetToHost32(metaSize);
 
     butil::IOBuf meta;
-    log.cutn(&meta, metaSize);
+    if (log->cutn(&meta, metaSize) != metaSize) {
+        LOG(ERROR) << "Raft log is truncated, type: " << logtype
+                   << ", expected size: " << metaSize;
+        return nullptr;
+    }
 
     OperatorType type = static_cast<OperatorType>(logtype);
 
@@ -165,6 +231,13 @@ std::unique_ptr<MetaOperator> RaftLogCodec::Decode(CopysetNode* node,
             return ParseFromRaftLog<UpdateVolumeExtentOperator,
                                     UpdateVolumeExtentRequest>(node, type,
                                                                meta);
+        case OperatorType::CreateInodeAndDentry:
+            return ParseFromRaftLog<CreateInodeAndDentryOperator,
+                                    CreateInodeAndDentryRequest>(node, type,
+                                                                 meta);
+        case OperatorType::AllocInodeIds:
+            return ParseFromRaftLog<AllocInodeIdsOperator,
+                                    AllocInodeIdsRequest>(node, type, meta);
         // Add new case before `OperatorType::OperatorTypeMax`
         case OperatorType::OperatorTypeMax:
             break;
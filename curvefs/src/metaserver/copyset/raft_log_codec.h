@@ -23,7 +23,9 @@
 #ifndef CURVEFS_SRC_METASERVER_COPYSET_RAFT_LOG_CODEC_H_
 #define CURVEFS_SRC_METASERVER_COPYSET_RAFT_LOG_CODEC_H_
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "curvefs/src/metaserver/copyset/copyset_node.h"
 #include "curvefs/src/metaserver/copyset/meta_operator.h"
@@ -47,8 +49,30 @@ class RaftLogCodec {
     static std::unique_ptr<MetaOperator> Decode(CopysetNode* node,
                                                 butil::IOBuf log);
 
+    /**
+     * @brief Pack logs encoded by `Encode` into one batch log
+     */
+    static void EncodeBatch(const std::vector<butil::IOBuf>& logs,
+                            butil::IOBuf* log);
+
+    /**
+     * @brief Decode from batch log or single operator log, and create
+     *        metaoperators in the order they were encoded
+     */
+    static bool DecodeBatch(CopysetNode* node, butil::IOBuf log,
+                            std::vector<std::unique_ptr<MetaOperator>>* ops);
+
+ private:
+    static std::unique_ptr<MetaOperator> DecodeOne(CopysetNode* node,
+                                                   butil::IOBuf* log);
+
  private:
     static constexpr size_t kOperatorTypeSize = sizeof(OperatorType);
+
+    // Type of batch log, which is not an `OperatorType`.
+    // Batch log is encoded as |type|count|log 1|log 2|...|, and each log is
+    // encoded by `Encode`
+    static constexpr uint32_t kBatchLogType = UINT32_MAX;
 };
 
 }  // namespace copyset
@@ -501,6 +501,7 @@ MetaStatusCode InodeManager::UpdateInodeWhenCreateOrRemoveSubNode(
             inode.set_nlink(--oldNlink);
         }
     }
+    inode.set_dentryversion(inode.dentryversion() + 1);
 
     ret = inodeStorage_->Update(inode);
     if (ret != MetaStatusCode::OK) {
@@ -514,6 +515,35 @@ MetaStatusCode InodeManager::UpdateInodeWhenCreateOrRemoveSubNode(
     return MetaStatusCode::OK;
 }
 
+MetaStatusCode InodeManager::IncreaseDentryVersion(uint32_t fsId,
+                                                   uint64_t inodeId) {
+    VLOG(6) << "IncreaseDentryVersion, fsId = " << fsId
+            << ", inodeId = " << inodeId;
+    NameLockGuard lg(inodeLock_, GetInodeLockName(fsId, inodeId));
+
+    Inode inode;
+    MetaStatusCode ret = inodeStorage_->Get(Key4Inode(fsId, inodeId), &inode);
+    if (ret != MetaStatusCode::OK) {
+        LOG(ERROR) << "GetInode fail, fsId = " << fsId
+                   << ", inodeId = " << inodeId
+                   << ", ret = " << MetaStatusCode_Name(ret);
+        return ret;
+    }
+
+    inode.set_dentryversion(inode.dentryversion() + 1);
+    ret = inodeStorage_->Update(inode);
+    if (ret != MetaStatusCode::OK) {
+        LOG(ERROR) << "UpdateInode fail, " << inode.ShortDebugString()
+                   << ", ret = " << MetaStatusCode_Name(ret);
+        return ret;
+    }
+
+    VLOG(9) << "IncreaseDentryVersion success, fsId = " << fsId
+            << ", inodeId = " << inodeId
+            << ", dentryVersion = " << inode.dentryversion();
+    return MetaStatusCode::OK;
+}
+
 MetaStatusCode InodeManager::InsertInode(const Inode &inode) {
     VLOG(6) << "InsertInode, " << inode.ShortDebugString();
 
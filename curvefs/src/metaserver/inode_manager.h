@@ -106,6 +106,10 @@ class InodeManager {
     MetaStatusCode UpdateInodeWhenCreateOrRemoveSubNode(uint32_t fsId,
         uint64_t inodeId, FsFileType type, bool isCreate);
 
+    // bump dentry version of directory |inodeId| whose dentries are changed
+    // without creating or removing one, e.g. by rename
+    MetaStatusCode IncreaseDentryVersion(uint32_t fsId, uint64_t inodeId);
+
     MetaStatusCode InsertInode(const Inode &inode);
 
     bool GetInodeIdList(std::list<uint64_t>* inodeIdList);
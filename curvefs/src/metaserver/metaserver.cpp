@@ -660,6 +660,16 @@ void Metaserver::InitCopysetNodeOptions() {
                       "applyqueue.queue_depth",
                       &copysetNodeOptions_.applyQueueOption.queueDepth));
 
+    LOG_IF(FATAL, !conf_->GetBoolValue(
+                      "copyset.proposal_batch.enable",
+                      &copysetNodeOptions_.proposalBatchOption.enable));
+    LOG_IF(FATAL, !conf_->GetUInt32Value(
+                      "copyset.proposal_batch.max_size",
+                      &copysetNodeOptions_.proposalBatchOption.maxBatchSize));
+    LOG_IF(FATAL, !conf_->GetUInt32Value(
+                      "copyset.proposal_batch.max_bytes",
+                      &copysetNodeOptions_.proposalBatchOption.maxBatchBytes));
+
     LOG_IF(FATAL,
            !conf_->GetStringValue("copyset.trash.uri",
                                   &copysetNodeOptions_.trashOptions.trashUri));
@@ -43,6 +43,8 @@ using ::curvefs::metaserver::copyset::BatchGetXAttrOperator;
 using ::curvefs::metaserver::copyset::CreateInodeOperator;
 using ::curvefs::metaserver::copyset::CreateRootInodeOperator;
 using ::curvefs::metaserver::copyset::CreateManageInodeOperator;
+using ::curvefs::metaserver::copyset::CreateInodeAndDentryOperator;
+using ::curvefs::metaserver::copyset::AllocInodeIdsOperator;
 using ::curvefs::metaserver::copyset::UpdateInodeOperator;
 using ::curvefs::metaserver::copyset::GetOrModifyS3ChunkInfoOperator;
 using ::curvefs::metaserver::copyset::DeleteInodeOperator;
@@ -212,6 +214,29 @@ void MetaServerServiceImpl::CreateManageInode(
                                                request->copysetid());
 }
 
+void MetaServerServiceImpl::CreateInodeAndDentry(
+    ::google::protobuf::RpcController* controller,
+    const ::curvefs::metaserver::CreateInodeAndDentryRequest* request,
+    ::curvefs::metaserver::CreateInodeAndDentryResponse* response,
+    ::google::protobuf::Closure* done) {
+    OperatorHelper helper(copysetNodeManager_, inflightThrottle_);
+    helper.operator()<CreateInodeAndDentryOperator>(controller, request,
+                                                    response, done,
+                                                    request->poolid(),
+                                                    request->copysetid());
+}
+
+void MetaServerServiceImpl::AllocInodeIds(
+    ::google::protobuf::RpcController* controller,
+    const ::curvefs::metaserver::AllocInodeIdsRequest* request,
+    ::curvefs::metaserver::AllocInodeIdsResponse* response,
+    ::google::protobuf::Closure* done) {
+    OperatorHelper helper(copysetNodeManager_, inflightThrottle_);
+    helper.operator()<AllocInodeIdsOperator>(controller, request, response,
+                                             done, request->poolid(),
+                                             request->copysetid());
+}
+
 void MetaServerServiceImpl::UpdateInode(
     ::google::protobuf::RpcController* controller,
     const ::curvefs::metaserver::UpdateInodeRequest* request,
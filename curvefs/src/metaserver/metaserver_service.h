@@ -84,6 +84,16 @@ class MetaServerServiceImpl : public MetaServerService {
             const ::curvefs::metaserver::CreateManageInodeRequest* request,
             ::curvefs::metaserver::CreateManageInodeResponse* response,
             ::google::protobuf::Closure* done) override;
+    void CreateInodeAndDentry(
+            ::google::protobuf::RpcController* controller,
+            const ::curvefs::metaserver::CreateInodeAndDentryRequest* request,
+            ::curvefs::metaserver::CreateInodeAndDentryResponse* response,
+            ::google::protobuf::Closure* done) override;
+    void AllocInodeIds(
+            ::google::protobuf::RpcController* controller,
+            const ::curvefs::metaserver::AllocInodeIdsRequest* request,
+            ::curvefs::metaserver::AllocInodeIdsResponse* response,
+            ::google::protobuf::Closure* done) override;
     void UpdateInode(::google::protobuf::RpcController* controller,
                      const ::curvefs::metaserver::UpdateInodeRequest* request,
                      ::curvefs::metaserver::UpdateInodeResponse* response,
@@ -488,8 +488,14 @@ MetaStatusCode MetaStoreImpl::CreateInode(const CreateInodeRequest* request,
         response->set_statuscode(status);
         return status;
     }
-    MetaStatusCode status =
-        partition->CreateInode(param, response->mutable_inode());
+    MetaStatusCode status = MetaStatusCode::OK;
+    if (request->has_inodeid()) {
+        status = partition->CreateInodeWithLeasedId(
+            request->inodeid(), request->leaseid(), param,
+            response->mutable_inode());
+    } else {
+        status = partition->CreateInode(param, response->mutable_inode());
+    }
     response->set_statuscode(status);
     if (status != MetaStatusCode::OK) {
         response->clear_inode();
@@ -585,6 +591,72 @@ MetaStatusCode MetaStoreImpl::CreateManageInode(
     return MetaStatusCode::OK;
 }
 
+MetaStatusCode MetaStoreImpl::CreateInodeAndDentry(
+    const CreateInodeAndDentryRequest* request,
+    CreateInodeAndDentryResponse* response) {
+    InodeParam param;
+    param.fsId = request->fsid();
+    param.length = request->length();
+    param.uid = request->uid();
+    param.gid = request->gid();
+    param.mode = request->mode();
+    param.type = request->type();
+    param.parent = request->parent();
+    param.rdev = request->rdev();
+    if (request->has_create()) {
+        param.timestamp = absl::make_optional<struct timespec>(
+            {request->create().sec(), request->create().nsec()});
+    }
+    param.symlink = "";
+
+    if (param.type == FsFileType::TYPE_SYM_LINK) {
+        if (!request->has_symlink() || request->symlink().empty()) {
+            response->set_statuscode(MetaStatusCode::SYM_LINK_EMPTY);
+            return MetaStatusCode::SYM_LINK_EMPTY;
+        }
+
+        param.symlink = request->symlink();
+    }
+
+    ReadLockGuard readLockGuard(rwLock_);
+    std::shared_ptr<Partition> partition = GetPartition(request->partitionid());
+    if (partition == nullptr) {
+        MetaStatusCode status = MetaStatusCode::PARTITION_NOT_FOUND;
+        response->set_statuscode(status);
+        return status;
+    }
+
+    MetaStatusCode status = partition->CreateInodeAndDentry(
+        param, request->name(), request->txid(), request->inodeid(),
+        request->leaseid(), response->mutable_inode());
+    response->set_statuscode(status);
+    if (status != MetaStatusCode::OK) {
+        response->clear_inode();
+    }
+    return status;
+}
+
+MetaStatusCode MetaStoreImpl::AllocInodeIds(
+    const AllocInodeIdsRequest* request,
+    AllocInodeIdsResponse* response) {
+    ReadLockGuard readLockGuard(rwLock_);
+    std::shared_ptr<Partition> partition = GetPartition(request->partitionid());
+    if (partition == nullptr) {
+        MetaStatusCode status = MetaStatusCode::PARTITION_NOT_FOUND;
+        response->set_statuscode(status);
+        return status;
+    }
+
+    MetaStatusCode status = partition->AllocInodeIds(
+        request->fsid(), request->count(), request->leasems(),
+        request->timestampms(), response->mutable_lease());
+    response->set_statuscode(status);
+    if (status != MetaStatusCode::OK) {
+        response->clear_lease();
+    }
+    return status;
+}
+
 MetaStatusCode MetaStoreImpl::GetInode(const GetInodeRequest* request,
                                        GetInodeResponse* response) {
     uint32_t fsId = request->fsid();
@@ -71,6 +71,10 @@ using curvefs::metaserver::CreateRootInodeRequest;
 using curvefs::metaserver::CreateRootInodeResponse;
 using curvefs::metaserver::CreateManageInodeRequest;
 using curvefs::metaserver::CreateManageInodeResponse;
+using curvefs::metaserver::CreateInodeAndDentryRequest;
+using curvefs::metaserver::CreateInodeAndDentryResponse;
+using curvefs::metaserver::AllocInodeIdsRequest;
+using curvefs::metaserver::AllocInodeIdsResponse;
 
 // partition
 using curvefs::metaserver::CreatePartitionRequest;
@@ -138,6 +142,14 @@ class MetaStore {
                                 const CreateManageInodeRequest* request,
                                 CreateManageInodeResponse* response) = 0;
 
+    virtual MetaStatusCode CreateInodeAndDentry(
+        const CreateInodeAndDentryRequest* request,
+        CreateInodeAndDentryResponse* response) = 0;
+
+    virtual MetaStatusCode AllocInodeIds(
+        const AllocInodeIdsRequest* request,
+        AllocInodeIdsResponse* response) = 0;
+
     virtual MetaStatusCode GetInode(const GetInodeRequest* request,
                                     GetInodeResponse* response) = 0;
 
@@ -222,6 +234,14 @@ class MetaStoreImpl : public MetaStore {
                                 const CreateManageInodeRequest* request,
                                 CreateManageInodeResponse* response) override;
 
+    MetaStatusCode CreateInodeAndDentry(
+        const CreateInodeAndDentryRequest* request,
+        CreateInodeAndDentryResponse* response) override;
+
+    MetaStatusCode AllocInodeIds(
+        const AllocInodeIdsRequest* request,
+        AllocInodeIdsResponse* response) override;
+
     MetaStatusCode GetInode(const GetInodeRequest* request,
                             GetInodeResponse* response) override;
 
@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <utility>
 
 #include "curvefs/proto/metaserver.pb.h"
@@ -184,7 +185,42 @@ MetaStatusCode Partition::HandleRenameTx(const std::vector<Dentry>& dentrys) {
         return MetaStatusCode::PARTITION_DELETING;
     }
 
-    return dentryManager_->HandleRenameTx(dentrys);
+    // the pending transaction is committed or rolled back by this one,
+    // dentries of both change
+    std::set<uint64_t> parents;
+    RenameTx pendingTx;
+    if (txManager_->FindPendingTx(&pendingTx)) {
+        for (const auto& dentry : *pendingTx.GetDentrys()) {
+            parents.emplace(dentry.parentinodeid());
+        }
+    }
+    for (const auto& dentry : dentrys) {
+        parents.emplace(dentry.parentinodeid());
+    }
+
+    MetaStatusCode ret = dentryManager_->HandleRenameTx(dentrys);
+    for (uint64_t parent : parents) {
+        MetaStatusCode rc = inodeManager_->IncreaseDentryVersion(
+            partitionInfo_.fsid(), parent);
+        if (rc != MetaStatusCode::OK && rc != MetaStatusCode::NOT_FOUND &&
+            ret == MetaStatusCode::OK) {
+            ret = rc;
+        }
+    }
+    return ret;
+}
+
+bool Partition::InPendingTx(uint64_t parent) {
+    RenameTx pendingTx;
+    if (!txManager_->FindPendingTx(&pendingTx)) {
+        return false;
+    }
+    for (const auto& dentry : *pendingTx.GetDentrys()) {
+        if (dentry.parentinodeid() == parent) {
+            return true;
+        }
+    }
+    return false;
 }
 
 bool Partition::InsertPendingTx(const PrepareRenameTxRequest& pendingTx) {
@@ -246,6 +282,197 @@ MetaStatusCode Partition::CreateInode(const InodeParam &param,
     return inodeManager_->CreateInode(inodeId, param, inode);
 }
 
+MetaStatusCode Partition::CreateInodeWithLeasedId(uint64_t inodeId,
+                                                  uint64_t leaseId,
+                                                  const InodeParam &param,
+                                                  Inode* inode) {
+    if (GetStatus() == PartitionStatus::DELETING) {
+        return MetaStatusCode::PARTITION_DELETING;
+    }
+
+    if (!IsInodeBelongs(param.fsId, inodeId)) {
+        return MetaStatusCode::PARTITION_ID_MISSMATCH;
+    }
+
+    // a retry of an applied request finds the inode created by itself, even
+    // if the lease has been used up or reclaimed since
+    MetaStatusCode ret = inodeStorage_->Get(Key4Inode(param.fsId, inodeId),
+                                            inode);
+    if (ret == MetaStatusCode::OK) {
+        return IsCreatedByRequest(param, *inode) ? MetaStatusCode::OK
+                                                 : MetaStatusCode::INODE_EXIST;
+    } else if (ret != MetaStatusCode::NOT_FOUND) {
+        return ret;
+    }
+
+    // the lease may be expired but not reclaimed yet, it's still valid
+    auto* leases = partitionInfo_.mutable_inodeidleases();
+    auto it = std::find_if(leases->begin(), leases->end(),
+                           [inodeId, leaseId](const InodeIdLease& lease) {
+                               return lease.leaseid() == leaseId &&
+                                      inodeId >= lease.start() &&
+                                      inodeId < lease.end();
+                           });
+    if (it == leases->end()) {
+        return MetaStatusCode::INODE_ID_NOT_LEASED;
+    }
+
+    // ids are used out of order by concurrent creations
+    it->set_nextid(std::max(it->nextid(), inodeId + 1));
+    if (it->nextid() == it->end()) {
+        leases->erase(it);
+    }
+
+    return inodeManager_->CreateInode(inodeId, param, inode);
+}
+
+MetaStatusCode Partition::AllocInodeIds(uint32_t fsId, uint32_t count,
+                                        uint64_t leaseMs,
+                                        uint64_t timestampMs,
+                                        InodeIdLease* lease) {
+    if (fsId != partitionInfo_.fsid()) {
+        return MetaStatusCode::PARTITION_ID_MISSMATCH;
+    }
+
+    if (GetStatus() == PartitionStatus::DELETING) {
+        return MetaStatusCode::PARTITION_DELETING;
+    }
+
+    if (count == 0) {
+        return MetaStatusCode::PARAM_ERROR;
+    }
+
+    ReclaimExpiredInodeIdLeases(timestampMs);
+
+    uint64_t start = 0;
+    uint64_t end = 0;
+    auto* freeIds = partitionInfo_.mutable_freeinodeids();
+    if (!freeIds->empty()) {
+        InodeIdRange* range = freeIds->Mutable(0);
+        start = range->start();
+        end = start + std::min<uint64_t>(count, range->end() - start);
+        if (end == range->end()) {
+            freeIds->DeleteSubrange(0, 1);
+        } else {
+            range->set_start(end);
+        }
+    } else {
+        if (GetStatus() == PartitionStatus::READONLY) {
+            return MetaStatusCode::PARTITION_ALLOC_ID_FAIL;
+        }
+
+        // inode id range of partition is [start, end]
+        start = partitionInfo_.nextid();
+        if (start > partitionInfo_.end()) {
+            partitionInfo_.set_status(PartitionStatus::READONLY);
+            return MetaStatusCode::PARTITION_ALLOC_ID_FAIL;
+        }
+        end = start +
+              std::min<uint64_t>(count, partitionInfo_.end() - start + 1);
+        partitionInfo_.set_nextid(end);
+    }
+
+    // lease ids start from 1, so a lease id never equals an unset one
+    uint64_t leaseId = partitionInfo_.lastinodeidleaseid() + 1;
+    partitionInfo_.set_lastinodeidleaseid(leaseId);
+
+    InodeIdLease* newLease = partitionInfo_.add_inodeidleases();
+    newLease->set_leaseid(leaseId);
+    newLease->set_start(start);
+    newLease->set_end(end);
+    newLease->set_nextid(start);
+    newLease->set_expiretimems(timestampMs + leaseMs);
+    lease->CopyFrom(*newLease);
+    return MetaStatusCode::OK;
+}
+
+bool Partition::IsCreatedByRequest(const InodeParam &param,
+                                   const Inode& inode) {
+    // the create time is chosen by the client once for all the retries
+    // of a request, so it tells a retry from another request
+    if (!param.timestamp.has_value()) {
+        return false;
+    }
+
+    bool parentMatch = false;
+    for (const auto& parent : inode.parent()) {
+        if (parent == param.parent) {
+            parentMatch = true;
+            break;
+        }
+    }
+    return parentMatch && inode.type() == param.type &&
+           inode.ctime() == static_cast<uint64_t>(param.timestamp->tv_sec) &&
+           inode.ctime_ns() ==
+               static_cast<uint32_t>(param.timestamp->tv_nsec) &&
+           inode.uid() == param.uid && inode.gid() == param.gid &&
+           inode.mode() == param.mode;
+}
+
+MetaStatusCode Partition::CreateInodeAndDentry(const InodeParam &param,
+                                               const std::string& name,
+                                               uint64_t txId, uint64_t inodeId,
+                                               uint64_t leaseId, Inode* inode) {
+    if (!IsInodeBelongs(param.fsId, param.parent)) {
+        return MetaStatusCode::PARTITION_ID_MISSMATCH;
+    }
+
+    if (GetStatus() == PartitionStatus::DELETING) {
+        return MetaStatusCode::PARTITION_DELETING;
+    }
+
+    Dentry dentry;
+    dentry.set_fsid(param.fsId);
+    dentry.set_parentinodeid(param.parent);
+    dentry.set_name(name);
+    dentry.set_txid(txId);
+
+    // a retry of an applied request finds the dentry created by itself
+    MetaStatusCode ret = dentryManager_->GetDentry(&dentry);
+    if (ret == MetaStatusCode::OK) {
+        ret = inodeManager_->GetInode(param.fsId, dentry.inodeid(), inode);
+        if (ret == MetaStatusCode::OK && IsCreatedByRequest(param, *inode)) {
+            return MetaStatusCode::OK;
+        }
+        return MetaStatusCode::DENTRY_EXIST;
+    } else if (ret != MetaStatusCode::NOT_FOUND) {
+        return ret;
+    }
+
+    if (inodeId != 0) {
+        ret = CreateInodeWithLeasedId(inodeId, leaseId, param, inode);
+    } else {
+        ret = CreateInode(param, inode);
+    }
+    if (ret != MetaStatusCode::OK) {
+        return ret;
+    }
+
+    dentry.set_inodeid(inode->inodeid());
+    dentry.set_type(param.type);
+    if (param.type == FsFileType::TYPE_FILE ||
+        param.type == FsFileType::TYPE_S3) {
+        dentry.set_flag(DentryFlag::TYPE_FILE_FLAG);
+    }
+
+    ret = dentryManager_->CreateDentry(dentry);
+    if (ret == MetaStatusCode::IDEMPOTENCE_OK) {
+        return MetaStatusCode::OK;
+    } else if (ret != MetaStatusCode::OK) {
+        // dentry is not created, so remove the inode which nobody refers to
+        MetaStatusCode rc =
+            inodeManager_->DeleteInode(param.fsId, inode->inodeid());
+        LOG_IF(ERROR, rc != MetaStatusCode::OK)
+            << "Delete inode after create dentry failed, fsId = "
+            << param.fsId << ", inodeId = " << inode->inodeid()
+            << ", ret = " << MetaStatusCode_Name(rc);
+        return ret;
+    }
+
+    return inodeManager_->UpdateInodeWhenCreateOrRemoveSubNode(
+        param.fsId, param.parent, param.type, true);
+}
+
 MetaStatusCode Partition::CreateRootInode(const InodeParam &param) {
     if (!IsInodeBelongs(param.fsId)) {
         return MetaStatusCode::PARTITION_ID_MISSMATCH;
@@ -287,7 +514,14 @@ MetaStatusCode Partition::GetInodeAttr(uint32_t fsId, uint64_t inodeId,
         return MetaStatusCode::PARTITION_ID_MISSMATCH;
     }
 
-    return inodeManager_->GetInodeAttr(fsId, inodeId, attr);
+    MetaStatusCode ret = inodeManager_->GetInodeAttr(fsId, inodeId, attr);
+    // whether dentries of a pending transaction are seen depends on the
+    // transaction id of reader, so the version doesn't tell them
+    if (ret == MetaStatusCode::OK && attr->has_dentryversion() &&
+        InPendingTx(inodeId)) {
+        attr->clear_dentryversion();
+    }
+    return ret;
 }
 
 MetaStatusCode Partition::GetXAttr(uint32_t fsId, uint64_t inodeId,
@@ -457,6 +691,28 @@ uint64_t Partition::GetNewInodeId() {
     return newInodeId;
 }
 
+void Partition::ReclaimExpiredInodeIdLeases(uint64_t timestampMs) {
+    auto* leases = partitionInfo_.mutable_inodeidleases();
+    int kept = 0;
+    for (int i = 0; i < leases->size(); ++i) {
+        const InodeIdLease& lease = leases->Get(i);
+        if (lease.expiretimems() > timestampMs) {
+            leases->SwapElements(i, kept++);
+            continue;
+        }
+
+        if (lease.nextid() < lease.end()) {
+            InodeIdRange* range = partitionInfo_.add_freeinodeids();
+            range->set_start(lease.nextid());
+            range->set_end(lease.end());
+        }
+        VLOG(3) << "Inode id lease expired, partitionId = "
+                << partitionInfo_.partitionid()
+                << ", lease = " << lease.ShortDebugString();
+    }
+    leases->DeleteSubrange(kept, leases->size() - kept);
+}
+
 uint32_t Partition::GetInodeNum() {
     return static_cast<uint32_t>(inodeStorage_->Size());
 }
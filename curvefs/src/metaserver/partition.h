@@ -39,6 +39,8 @@
 
 namespace curvefs {
 namespace metaserver {
+using curvefs::common::InodeIdLease;
+using curvefs::common::InodeIdRange;
 using curvefs::common::PartitionInfo;
 using curvefs::common::PartitionStatus;
 using ::curvefs::metaserver::storage::KVStorage;
@@ -80,6 +82,30 @@ class Partition {
     MetaStatusCode CreateInode(const InodeParam &param,
                                Inode* inode);
 
+    // create inode with |inodeId|, which must belong to the lease |leaseId|
+    // got by AllocInodeIds. it's idempotent, an inode created by a former
+    // try of the same request is returned, see IsCreatedByRequest
+    MetaStatusCode CreateInodeWithLeasedId(uint64_t inodeId, uint64_t leaseId,
+                                           const InodeParam &param,
+                                           Inode* inode);
+
+    // lease at most |count| inode ids until |timestampMs| + |leaseMs|,
+    // expired leases before |timestampMs| are reclaimed first. |timestampMs|
+    // is leader's time when the request was proposed
+    MetaStatusCode AllocInodeIds(uint32_t fsId, uint32_t count,
+                                 uint64_t leaseMs, uint64_t timestampMs,
+                                 InodeIdLease* lease);
+
+    // create an inode and its dentry under |param.parent|, the inode is
+    // allocated from this partition, which |param.parent| must belong to,
+    // or created with |inodeId| of lease |leaseId| if |inodeId| isn't 0.
+    // A retry of an applied request returns the inode created before,
+    // which is recognized by the create time in |param|
+    MetaStatusCode CreateInodeAndDentry(const InodeParam &param,
+                                        const std::string& name,
+                                        uint64_t txId, uint64_t inodeId,
+                                        uint64_t leaseId, Inode* inode);
+
     MetaStatusCode CreateRootInode(const InodeParam &param);
 
     MetaStatusCode CreateManageInode(const InodeParam &param,
@@ -149,6 +175,10 @@ class Partition {
     // if no available inode id in this partiton ,return UINT64_MAX
     uint64_t GetNewInodeId();
 
+    // ids used by an expired lease are never reclaimed, as they may belong
+    // to inodes created with it, only ids from |nextId| are freed
+    void ReclaimExpiredInodeIdLeases(uint64_t timestampMs);
+
     uint32_t GetInodeNum();
 
     uint32_t GetDentryNum();
@@ -189,6 +219,14 @@ class Partition {
         }
     }
 
+ private:
+    // whether dentries under |parent| are in the pending rename transaction
+    bool InPendingTx(uint64_t parent);
+
+    // whether |inode| was created by a request with |param|
+    static bool IsCreatedByRequest(const InodeParam &param,
+                                   const Inode& inode);
+
  private:
     std::shared_ptr<InodeStorage> inodeStorage_;
     std::shared_ptr<DentryStorage> dentryStorage_;
@@ -73,6 +73,14 @@ class MockInodeCacheManager : public InodeCacheManager {
     MOCK_METHOD2(CreateManageInode, CURVEFS_ERROR(const InodeParam &param,
         std::shared_ptr<InodeWrapper> &out));     // NOLINT
 
+    MOCK_METHOD3(CreateInodeAndDentry, CURVEFS_ERROR(const InodeParam &param,
+        const std::string &name,
+        std::shared_ptr<InodeWrapper> &out));     // NOLINT
+
+    MOCK_METHOD3(CreateInodeLocally, CURVEFS_ERROR(const InodeParam &param,
+        const std::function<CURVEFS_ERROR()> &create,
+        std::shared_ptr<InodeWrapper> &out));     // NOLINT
+
     MOCK_METHOD1(DeleteInode, CURVEFS_ERROR(uint64_t inodeid));
 
     MOCK_METHOD1(InvalidateNlinkCache, void(uint64_t inodeid));
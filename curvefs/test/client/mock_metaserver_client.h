@@ -143,6 +143,14 @@ class MockMetaServerClient : public MetaServerClient {
     MOCK_METHOD2(CreateManageInode, MetaStatusCode(
                  const InodeParam &param, Inode *out));
 
+    MOCK_METHOD3(CreateInodeAndDentry, MetaStatusCode(
+                 const InodeParam &param, const std::string &name,
+                 Inode *out));
+
+    MOCK_METHOD4(AllocInodeIds, MetaStatusCode(
+                 uint32_t fsId, uint32_t count, uint64_t leaseMs,
+                 InodeIdLease *lease));
+
     MOCK_METHOD2(DeleteInode, MetaStatusCode(uint32_t fsId, uint64_t inodeid));
 
     MOCK_METHOD3(SplitRequestInodes, bool(uint32_t fsId,
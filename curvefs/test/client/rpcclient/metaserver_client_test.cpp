@@ -53,6 +53,7 @@ using ::testing::DoAll;
 using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::SetArgPointee;
+using ::testing::SaveArgPointee;
 using ::testing::AnyOf;
 
 using ::curvefs::metaserver::Dentry;
@@ -1056,6 +1057,207 @@ TEST_F(MetaServerClientImplTest, test_CreateInode) {
     ASSERT_EQ(MetaStatusCode::PARTITION_ALLOC_ID_FAIL, status);
 }
 
+TEST_F(MetaServerClientImplTest, test_CreateInodeAndDentry) {
+    // in
+    InodeParam param;
+    param.fsId = 2;
+    param.length = 0;
+    param.uid = 1;
+    param.gid = 1;
+    param.mode = 1;
+    param.type = curvefs::metaserver::FsFileType::TYPE_FILE;
+    param.rdev = 0;
+    param.parent = 1;
+
+    // out
+    uint64_t applyIndex = 10;
+    curvefs::metaserver::Inode out;
+    out.set_inodeid(100);
+    out.set_fsid(param.fsId);
+    out.set_length(param.length);
+    out.set_ctime(1623835517);
+    out.set_ctime_ns(0);
+    out.set_mtime(1623835517);
+    out.set_mtime_ns(0);
+    out.set_atime(1623835517);
+    out.set_atime_ns(0);
+    out.set_uid(param.uid);
+    out.set_gid(param.gid);
+    out.set_mode(param.mode);
+    out.set_nlink(1);
+    out.set_type(param.type);
+    out.add_parent(param.parent);
+
+    curvefs::metaserver::CreateInodeAndDentryResponse response;
+
+    // test1: create inode and dentry ok, request is sent to the partition
+    //        which parent belongs to
+    response.set_statuscode(MetaStatusCode::OK);
+    response.set_appliedindex(10);
+    response.mutable_inode()->CopyFrom(out);
+    CreateInodeAndDentryRequest request;
+    EXPECT_CALL(mockMetaServerService_, CreateInodeAndDentry(_, _, _, _))
+        .WillOnce(DoAll(
+            SaveArgPointee<1>(&request), SetArgPointee<2>(response),
+            Invoke(SetRpcService<CreateInodeAndDentryRequest,
+                                 CreateInodeAndDentryResponse>)));
+    EXPECT_CALL(*mockMetacache_.get(), GetTarget(param.fsId, param.parent, _,
+                                                 _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(target_), SetArgPointee<3>(applyIndex),
+                        Return(true)));
+    EXPECT_CALL(*mockMetacache_.get(), UpdateApplyIndex(_, _));
+    curvefs::metaserver::Inode inode;
+    auto status = metaserverCli_.CreateInodeAndDentry(param, "file", &inode);
+    ASSERT_EQ(MetaStatusCode::OK, status);
+    ASSERT_EQ(out.inodeid(), inode.inodeid());
+    ASSERT_EQ("file", request.name());
+    ASSERT_EQ(param.parent, request.parent());
+    ASSERT_EQ(target_.partitionID, request.partitionid());
+
+    // test2: dentry exist
+    response.set_statuscode(MetaStatusCode::DENTRY_EXIST);
+    EXPECT_CALL(mockMetaServerService_, CreateInodeAndDentry(_, _, _, _))
+        .WillOnce(DoAll(
+            SetArgPointee<2>(response),
+            Invoke(SetRpcService<CreateInodeAndDentryRequest,
+                                 CreateInodeAndDentryResponse>)));
+    EXPECT_CALL(*mockMetacache_.get(), GetTarget(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(target_), SetArgPointee<3>(applyIndex),
+                        Return(true)));
+    status = metaserverCli_.CreateInodeAndDentry(param, "file", &inode);
+    ASSERT_EQ(MetaStatusCode::DENTRY_EXIST, status);
+
+    // test3: no inode id left in parent's partition, return without retry
+    response.set_statuscode(MetaStatusCode::PARTITION_ALLOC_ID_FAIL);
+    EXPECT_CALL(mockMetaServerService_, CreateInodeAndDentry(_, _, _, _))
+        .WillOnce(DoAll(
+            SetArgPointee<2>(response),
+            Invoke(SetRpcService<CreateInodeAndDentryRequest,
+                                 CreateInodeAndDentryResponse>)));
+    EXPECT_CALL(*mockMetacache_.get(), GetTarget(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(target_), SetArgPointee<3>(applyIndex),
+                        Return(true)));
+    EXPECT_CALL(*mockMetacache_.get(),
+                MarkPartitionUnavailable(target_.partitionID))
+        .WillOnce(Return(true));
+    status = metaserverCli_.CreateInodeAndDentry(param, "file", &inode);
+    ASSERT_EQ(MetaStatusCode::PARTITION_ALLOC_ID_FAIL, status);
+
+    // test4: leased id in another partition, return without rpc
+    param.inodeId = 200;
+    param.leaseId = 3;
+    param.timestamp = timespec{1000, 10};
+    EXPECT_CALL(*mockMetacache_.get(),
+                GetPartitionIdByInodeId(param.fsId, param.inodeId, _))
+        .WillOnce(DoAll(SetArgPointee<2>(2), Return(true)));
+    EXPECT_CALL(*mockMetacache_.get(),
+                GetPartitionIdByInodeId(param.fsId, param.parent, _))
+        .WillOnce(DoAll(SetArgPointee<2>(1), Return(true)));
+    EXPECT_CALL(mockMetaServerService_, CreateInodeAndDentry(_, _, _, _))
+        .Times(0);
+    status = metaserverCli_.CreateInodeAndDentry(param, "file", &inode);
+    ASSERT_EQ(MetaStatusCode::PARTITION_ID_MISSMATCH, status);
+
+    // test5: leased id in the partition of parent
+    response.set_statuscode(MetaStatusCode::OK);
+    EXPECT_CALL(*mockMetacache_.get(), GetPartitionIdByInodeId(_, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(1), Return(true)));
+    EXPECT_CALL(mockMetaServerService_, CreateInodeAndDentry(_, _, _, _))
+        .WillOnce(DoAll(
+            SaveArgPointee<1>(&request), SetArgPointee<2>(response),
+            Invoke(SetRpcService<CreateInodeAndDentryRequest,
+                                 CreateInodeAndDentryResponse>)));
+    EXPECT_CALL(*mockMetacache_.get(), GetTarget(param.fsId, param.parent, _,
+                                                 _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(target_), SetArgPointee<3>(applyIndex),
+                        Return(true)));
+    EXPECT_CALL(*mockMetacache_.get(), UpdateApplyIndex(_, _));
+    status = metaserverCli_.CreateInodeAndDentry(param, "file", &inode);
+    ASSERT_EQ(MetaStatusCode::OK, status);
+    ASSERT_EQ(param.inodeId, request.inodeid());
+    ASSERT_EQ(param.leaseId, request.leaseid());
+    ASSERT_EQ(1000, request.create().sec());
+    ASSERT_EQ(10, request.create().nsec());
+}
+
+TEST_F(MetaServerClientImplTest, test_AllocInodeIds) {
+    uint32_t fsId = 2;
+    uint64_t applyIndex = 10;
+    curvefs::metaserver::AllocInodeIdsResponse response;
+
+    // test1: lease inode ids from any partition
+    response.set_statuscode(MetaStatusCode::OK);
+    response.set_appliedindex(10);
+    auto* lease = response.mutable_lease();
+    lease->set_start(100);
+    lease->set_end(200);
+    lease->set_nextid(100);
+    lease->set_expiretimems(1000);
+    lease->set_leaseid(1);
+    AllocInodeIdsRequest request;
+    EXPECT_CALL(mockMetaServerService_, AllocInodeIds(_, _, _, _))
+        .WillOnce(DoAll(
+            SaveArgPointee<1>(&request), SetArgPointee<2>(response),
+            Invoke(SetRpcService<AllocInodeIdsRequest,
+                                 AllocInodeIdsResponse>)));
+    EXPECT_CALL(*mockMetacache_.get(), SelectTarget(fsId, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(target_), SetArgPointee<2>(applyIndex),
+                        Return(true)));
+    EXPECT_CALL(*mockMetacache_.get(), UpdateApplyIndex(_, _));
+    InodeIdLease out;
+    auto status = metaserverCli_.AllocInodeIds(fsId, 100, 60000, &out);
+    ASSERT_EQ(MetaStatusCode::OK, status);
+    ASSERT_EQ(100, out.start());
+    ASSERT_EQ(200, out.end());
+    ASSERT_EQ(1, out.leaseid());
+    ASSERT_EQ(100, request.count());
+    ASSERT_EQ(60000, request.leasems());
+    ASSERT_EQ(target_.partitionID, request.partitionid());
+    // the time judging lease expiry is leader's
+    ASSERT_FALSE(request.has_timestampms());
+
+    // test2: create inode with a leased id, request is sent to the
+    //        partition which the inode belongs to, and a retry carries
+    //        the same create time
+    InodeParam param;
+    param.fsId = fsId;
+    param.length = 0;
+    param.uid = 1;
+    param.gid = 1;
+    param.mode = 1;
+    param.type = curvefs::metaserver::FsFileType::TYPE_FILE;
+    param.rdev = 0;
+    param.parent = 1;
+    param.inodeId = 100;
+    param.leaseId = 1;
+    curvefs::metaserver::CreateInodeResponse overloadResponse;
+    overloadResponse.set_statuscode(MetaStatusCode::OVERLOAD);
+    curvefs::metaserver::CreateInodeResponse createResponse;
+    createResponse.set_statuscode(MetaStatusCode::INODE_ID_NOT_LEASED);
+    CreateInodeRequest firstRequest;
+    CreateInodeRequest createRequest;
+    EXPECT_CALL(mockMetaServerService_, CreateInode(_, _, _, _))
+        .WillOnce(DoAll(
+            SaveArgPointee<1>(&firstRequest),
+            SetArgPointee<2>(overloadResponse),
+            Invoke(SetRpcService<CreateInodeRequest, CreateInodeResponse>)))
+        .WillOnce(DoAll(
+            SaveArgPointee<1>(&createRequest),
+            SetArgPointee<2>(createResponse),
+            Invoke(SetRpcService<CreateInodeRequest, CreateInodeResponse>)));
+    EXPECT_CALL(*mockMetacache_.get(), SelectTarget(_, _, _)).Times(0);
+    EXPECT_CALL(*mockMetacache_.get(), GetTarget(fsId, param.inodeId, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(target_), SetArgPointee<3>(applyIndex),
+                        Return(true)));
+    curvefs::metaserver::Inode inode;
+    status = metaserverCli_.CreateInode(param, &inode);
+    ASSERT_EQ(MetaStatusCode::INODE_ID_NOT_LEASED, status);
+    ASSERT_EQ(param.inodeId, createRequest.inodeid());
+    ASSERT_EQ(param.leaseId, createRequest.leaseid());
+    ASSERT_EQ(firstRequest.create().sec(), createRequest.create().sec());
+    ASSERT_EQ(firstRequest.create().nsec(), createRequest.create().nsec());
+}
+
 TEST_F(MetaServerClientImplTest, test_DeleteInode) {
     // in
     uint32_t fsId = 2;
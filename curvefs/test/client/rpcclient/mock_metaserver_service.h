@@ -86,6 +86,18 @@ class MockMetaServerService : public curvefs::metaserver::MetaServerService {
                       const ::curvefs::metaserver::CreateInodeRequest *request,
                       ::curvefs::metaserver::CreateInodeResponse *response,
                       ::google::protobuf::Closure *done));
+    MOCK_METHOD4(
+        CreateInodeAndDentry,
+        void(::google::protobuf::RpcController *controller,
+             const ::curvefs::metaserver::CreateInodeAndDentryRequest *request,
+             ::curvefs::metaserver::CreateInodeAndDentryResponse *response,
+             ::google::protobuf::Closure *done));
+    MOCK_METHOD4(
+        AllocInodeIds,
+        void(::google::protobuf::RpcController *controller,
+             const ::curvefs::metaserver::AllocInodeIdsRequest *request,
+             ::curvefs::metaserver::AllocInodeIdsResponse *response,
+             ::google::protobuf::Closure *done));
     MOCK_METHOD4(UpdateInode,
                  void(::google::protobuf::RpcController *controller,
                       const ::curvefs::metaserver::UpdateInodeRequest *request,
@@ -1461,6 +1461,89 @@ TEST_F(TestFuseS3Client, FuseOpGetXattr_EnableSumInDir_Failed) {
     ASSERT_EQ(CURVEFS_ERROR::INTERNAL, ret);
 }
 
+TEST_F(TestFuseS3Client, FuseOpMkDir_CreateInodeAndDentry) {
+    auto testclient =
+        std::make_shared<FuseS3Client>(mdsClient_, metaClient_, inodeManager_,
+                                       dentryManager_, s3ClientAdaptor_);
+    FuseClientOption opt;
+    InitOptionBasic(&opt);
+    opt.enableCreateInodeAndDentry = true;
+    InitFSInfo(testclient);
+    ASSERT_EQ(CURVEFS_ERROR::OK, testclient->Init(opt));
+    testclient->SetMounted(true);
+
+    fuse_req fakeReq;
+    fuse_ctx fakeCtx;
+    fakeReq.ctx = &fakeCtx;
+    fuse_req_t req = &fakeReq;
+    fuse_ino_t parent = 1;
+    const char* name = "xxx";
+    mode_t mode = 1;
+    fuse_entry_param e;
+
+    Inode inode;
+    inode.set_fsid(fsId);
+    inode.set_inodeid(2);
+    inode.set_length(4096);
+    inode.set_type(FsFileType::TYPE_DIRECTORY);
+    auto inodeWrapper = std::make_shared<InodeWrapper>(inode, metaClient_);
+
+    Inode parentInode;
+    parentInode.set_fsid(fsId);
+    parentInode.set_inodeid(parent);
+    parentInode.set_type(FsFileType::TYPE_DIRECTORY);
+    parentInode.set_nlink(2);
+    auto parentInodeWrapper =
+        std::make_shared<InodeWrapper>(parentInode, metaClient_);
+
+    // create inode and dentry in one request
+    {
+        EXPECT_CALL(*inodeManager_, CreateInodeAndDentry(_, "xxx", _))
+            .WillOnce(DoAll(SetArgReferee<2>(inodeWrapper),
+                            Return(CURVEFS_ERROR::OK)));
+        EXPECT_CALL(*inodeManager_, CreateInode(_, _)).Times(0);
+        EXPECT_CALL(*dentryManager_, CreateDentry(_)).Times(0);
+        EXPECT_CALL(*inodeManager_, GetInode(parent, _))
+            .WillOnce(DoAll(SetArgReferee<1>(parentInodeWrapper),
+                            Return(CURVEFS_ERROR::OK)));
+
+        ASSERT_EQ(CURVEFS_ERROR::OK,
+                  testclient->FuseOpMkDir(req, parent, name, mode, &e));
+        ASSERT_EQ(2, e.ino);
+    }
+
+    // dentry exist
+    {
+        EXPECT_CALL(*inodeManager_, CreateInodeAndDentry(_, "xxx", _))
+            .WillOnce(Return(CURVEFS_ERROR::EXISTS));
+        EXPECT_CALL(*inodeManager_, CreateInode(_, _)).Times(0);
+        EXPECT_CALL(*dentryManager_, CreateDentry(_)).Times(0);
+
+        ASSERT_EQ(CURVEFS_ERROR::EXISTS,
+                  testclient->FuseOpMkDir(req, parent, name, mode, &e));
+    }
+
+    // no inode id left in parent's partition, fall back to create inode
+    // and dentry separately
+    {
+        EXPECT_CALL(*inodeManager_, CreateInodeAndDentry(_, "xxx", _))
+            .WillOnce(Return(CURVEFS_ERROR::NOTSUPPORT));
+        EXPECT_CALL(*inodeManager_, CreateInode(_, _))
+            .WillOnce(DoAll(SetArgReferee<1>(inodeWrapper),
+                            Return(CURVEFS_ERROR::OK)));
+        EXPECT_CALL(*dentryManager_, CreateDentry(_))
+            .WillOnce(Return(CURVEFS_ERROR::OK));
+        EXPECT_CALL(*inodeManager_, GetInode(parent, _))
+            .WillOnce(DoAll(SetArgReferee<1>(parentInodeWrapper),
+                            Return(CURVEFS_ERROR::OK)));
+
+        ASSERT_EQ(CURVEFS_ERROR::OK,
+                  testclient->FuseOpMkDir(req, parent, name, mode, &e));
+    }
+
+    testclient->UnInit();
+}
+
 TEST_F(TestFuseS3Client, FuseOpCreate_EnableSummary) {
     client_->SetEnableSumInDir(true);
 
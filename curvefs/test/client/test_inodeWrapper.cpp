@@ -218,6 +218,37 @@ TEST_F(TestInodeWrapper, TestRefreshNlink) {
     ASSERT_EQ(nlink, inode.nlink());
 }
 
+TEST_F(TestInodeWrapper, TestPendingCreate) {
+    int created = 0;
+    CURVEFS_ERROR createRet = CURVEFS_ERROR::INTERNAL;
+    inodeWrapper_->SetPendingCreate([&created, &createRet]() {
+        ++created;
+        return createRet;
+    });
+    ASSERT_TRUE(inodeWrapper_->IsDirty());
+
+    // metaserver is not contacted until the inode is created
+    EXPECT_CALL(*metaClient_, GetInodeAttr(_, _, _)).Times(0);
+    ASSERT_EQ(CURVEFS_ERROR::INTERNAL, inodeWrapper_->RefreshNlink());
+    ASSERT_EQ(1, created);
+    ASSERT_TRUE(inodeWrapper_->IsDirty());
+
+    createRet = CURVEFS_ERROR::OK;
+    InodeAttr attr;
+    attr.set_nlink(1);
+    EXPECT_CALL(*metaClient_, GetInodeAttr(_, _, _))
+        .Times(2)
+        .WillRepeatedly(
+            DoAll(SetArgPointee<2>(attr), Return(MetaStatusCode::OK)));
+    ASSERT_EQ(CURVEFS_ERROR::OK, inodeWrapper_->RefreshNlink());
+    ASSERT_EQ(2, created);
+    ASSERT_FALSE(inodeWrapper_->IsDirty());
+
+    // created only once
+    ASSERT_EQ(CURVEFS_ERROR::OK, inodeWrapper_->RefreshNlink());
+    ASSERT_EQ(2, created);
+}
+
 TEST_F(TestInodeWrapper, TestNeedRefreshData) {
     Inode inode;
     inode.set_inodeid(1);
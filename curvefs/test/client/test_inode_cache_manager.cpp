@@ -290,6 +290,49 @@ TEST_F(TestInodeCacheManager, CreateAndGetInode) {
     ASSERT_EQ(FsFileType::TYPE_FILE, out.type());
 }
 
+TEST_F(TestInodeCacheManager, CreateInodeLocally) {
+    uint64_t inodeId = 100;
+    InodeParam param;
+    param.fsId = fsId_;
+    param.length = 4096;
+    param.uid = 1;
+    param.gid = 2;
+    param.mode = S_IFDIR | 0755;
+    param.type = FsFileType::TYPE_DIRECTORY;
+    param.rdev = 0;
+    param.parent = 1;
+
+    // leased inode id and create time are required
+    std::shared_ptr<InodeWrapper> inodeWrapper;
+    auto create = []() { return CURVEFS_ERROR::OK; };
+    ASSERT_EQ(CURVEFS_ERROR::INVALIDPARAM,
+              iCacheManager_->CreateInodeLocally(param, create,
+                                                 inodeWrapper));
+
+    param.inodeId = inodeId;
+    param.leaseId = 1;
+    param.timestamp = timespec{1000, 10};
+    EXPECT_CALL(*metaClient_, CreateInode(_, _)).Times(0);
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              iCacheManager_->CreateInodeLocally(param, create,
+                                                 inodeWrapper));
+    ASSERT_TRUE(inodeWrapper->IsDirty());
+    Inode out = inodeWrapper->GetInode();
+    ASSERT_EQ(inodeId, out.inodeid());
+    ASSERT_EQ(fsId_, out.fsid());
+    ASSERT_EQ(2, out.nlink());
+    ASSERT_EQ(1000, out.ctime());
+    ASSERT_EQ(10, out.ctime_ns());
+    ASSERT_EQ(1, out.parent(0));
+    ASSERT_EQ("0", out.xattr().at(XATTRENTRIES));
+
+    // served from cache before it's created on metaserver
+    EXPECT_CALL(*metaClient_, GetInode(_, _, _, _)).Times(0);
+    std::shared_ptr<InodeWrapper> cached;
+    ASSERT_EQ(CURVEFS_ERROR::OK, iCacheManager_->GetInode(inodeId, cached));
+    ASSERT_EQ(inodeWrapper, cached);
+}
+
 TEST_F(TestInodeCacheManager, DeleteInode) {
     uint64_t inodeId = 100;
 
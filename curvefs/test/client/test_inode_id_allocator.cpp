@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-09-02
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chrono>
+#include <thread>
+
+#include "curvefs/src/client/inode_id_allocator.h"
+#include "curvefs/test/client/mock_metaserver_client.h"
+
+namespace curvefs {
+namespace client {
+
+using ::curvefs::metaserver::MetaStatusCode;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using rpcclient::MockMetaServerClient;
+
+class TestInodeIdAllocator : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        option_.enable = true;
+        option_.leaseIds = 4;
+        option_.leaseMs = 60000;
+        option_.expireMarginMs = 1000;
+        option_.prefetchThreshold = 1;
+        metaClient_ = std::make_shared<MockMetaServerClient>();
+        allocator_ = std::make_shared<InodeIdAllocator>(metaClient_, option_);
+        ASSERT_TRUE(allocator_->Init(fsId_));
+    }
+
+    void TearDown() override {
+        allocator_->Stop();
+    }
+
+    // expire time of the lease is in leader's clock, which is ignored
+    InodeIdLease MakeLease(uint64_t start, uint64_t end, uint64_t leaseId) {
+        InodeIdLease lease;
+        lease.set_leaseid(leaseId);
+        lease.set_start(start);
+        lease.set_end(end);
+        lease.set_nextid(start);
+        lease.set_expiretimems(0);
+        return lease;
+    }
+
+    // alloc until the background lease is done
+    bool WaitAlloc(uint64_t* inodeId, uint64_t* leaseId) {
+        for (int i = 0; i < 100; ++i) {
+            if (allocator_->Alloc(inodeId, leaseId)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+ protected:
+    InodeIdPreallocOption option_;
+    std::shared_ptr<MockMetaServerClient> metaClient_;
+    std::shared_ptr<InodeIdAllocator> allocator_;
+    uint32_t fsId_ = 888;
+};
+
+TEST_F(TestInodeIdAllocator, AllocFromLeases) {
+    EXPECT_CALL(*metaClient_, AllocInodeIds(fsId_, 4, 60000, _))
+        .WillOnce(DoAll(SetArgPointee<3>(MakeLease(100, 104, 1)),
+                        Return(MetaStatusCode::OK)))
+        .WillOnce(DoAll(SetArgPointee<3>(MakeLease(200, 204, 2)),
+                        Return(MetaStatusCode::OK)))
+        .WillRepeatedly(Return(MetaStatusCode::PARTITION_ALLOC_ID_FAIL));
+
+    // the first alloc only triggers leasing
+    uint64_t inodeId = 0;
+    uint64_t leaseId = 0;
+    ASSERT_FALSE(allocator_->Alloc(&inodeId, &leaseId));
+    ASSERT_TRUE(WaitAlloc(&inodeId, &leaseId));
+    ASSERT_EQ(100, inodeId);
+    ASSERT_EQ(1, leaseId);
+
+    // next lease is prefetched before the current one run out
+    for (uint64_t expected = 101; expected < 104; ++expected) {
+        ASSERT_TRUE(allocator_->Alloc(&inodeId, &leaseId));
+        ASSERT_EQ(expected, inodeId);
+        ASSERT_EQ(1, leaseId);
+    }
+    ASSERT_TRUE(WaitAlloc(&inodeId, &leaseId));
+    ASSERT_EQ(200, inodeId);
+    ASSERT_EQ(2, leaseId);
+}
+
+TEST_F(TestInodeIdAllocator, SkipExpiringLease) {
+    // the lease expires within |expireMarginMs| by local clock
+    allocator_->Stop();
+    option_.leaseMs = 500;
+    allocator_ = std::make_shared<InodeIdAllocator>(metaClient_, option_);
+    ASSERT_TRUE(allocator_->Init(fsId_));
+    EXPECT_CALL(*metaClient_, AllocInodeIds(fsId_, 4, 500, _))
+        .WillRepeatedly(DoAll(SetArgPointee<3>(MakeLease(100, 104, 1)),
+                              Return(MetaStatusCode::OK)));
+
+    uint64_t inodeId = 0;
+    uint64_t leaseId = 0;
+    ASSERT_FALSE(allocator_->Alloc(&inodeId, &leaseId));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(allocator_->Alloc(&inodeId, &leaseId));
+}
+
+TEST_F(TestInodeIdAllocator, LeaseFailed) {
+    EXPECT_CALL(*metaClient_, AllocInodeIds(fsId_, 4, 60000, _))
+        .WillOnce(Return(MetaStatusCode::PARTITION_ALLOC_ID_FAIL));
+
+    // don't lease again for a while after failed
+    uint64_t inodeId = 0;
+    uint64_t leaseId = 0;
+    ASSERT_FALSE(allocator_->Alloc(&inodeId, &leaseId));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(allocator_->Alloc(&inodeId, &leaseId));
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-09-05
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <set>
+#include <thread>
+
+#include "curvefs/src/client/persistent_dentry_cache_manager.h"
+#include "curvefs/test/client/mock_dentry_cache_mamager.h"
+#include "curvefs/test/client/mock_metaserver_client.h"
+
+namespace curvefs {
+namespace client {
+namespace common {
+DECLARE_bool(enableCto);
+}  // namespace common
+}  // namespace client
+}  // namespace curvefs
+
+namespace curvefs {
+namespace client {
+
+using ::curvefs::metaserver::MetaStatusCode;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using rpcclient::MockMetaServerClient;
+
+class TestPersistentDentryCacheManager : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        curvefs::client::common::FLAGS_enableCto = false;
+        option_.enable = true;
+        option_.dir = "./persistent_dentry_cache_test";
+        option_.warmUpBatchSize = 2;
+        option_.maxDentriesPerDir = 100;
+        ASSERT_EQ(0, system(("rm -rf " + option_.dir).c_str()));
+        Open();
+    }
+
+    void TearDown() override {
+        dCacheManager_->Stop();
+        dCacheManager_ = nullptr;
+        ASSERT_EQ(0, system(("rm -rf " + option_.dir).c_str()));
+        curvefs::client::common::FLAGS_enableCto = true;
+    }
+
+    void Open() {
+        mockManager_ = std::make_shared<MockDentryCacheManager>();
+        metaClient_ = std::make_shared<MockMetaServerClient>();
+        dCacheManager_ = std::make_shared<PersistentDentryCacheManager>(
+            mockManager_, metaClient_, option_);
+        EXPECT_CALL(*mockManager_, Init(10, false, 3))
+            .WillOnce(Return(CURVEFS_ERROR::OK));
+        ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->Init(10, false, 3));
+        dCacheManager_->SetFsId(fsId_);
+        // warm up may see listings kept after opened
+        EXPECT_CALL(*metaClient_, BatchGetInodeAttr(fsId_, _, _))
+            .WillRepeatedly(Return(MetaStatusCode::UNKNOWN_ERROR));
+    }
+
+    Dentry MakeDentry(uint64_t parent, const std::string &name,
+                      uint64_t inodeid, FsFileType type) {
+        Dentry dentry;
+        dentry.set_fsid(fsId_);
+        dentry.set_parentinodeid(parent);
+        dentry.set_name(name);
+        dentry.set_inodeid(inodeid);
+        dentry.set_type(type);
+        return dentry;
+    }
+
+    InodeAttr MakeAttr(uint64_t inodeid, uint64_t version) {
+        InodeAttr attr;
+        attr.set_inodeid(inodeid);
+        attr.set_fsid(fsId_);
+        attr.set_nlink(3);
+        attr.set_dentryversion(version);
+        return attr;
+    }
+
+    // list directory 1 from metaserver and keep it
+    void KeepListing() {
+        EXPECT_CALL(*metaClient_, GetInodeAttr(fsId_, 1, _))
+            .WillOnce(DoAll(SetArgPointee<2>(MakeAttr(1, 100)),
+                            Return(MetaStatusCode::OK)));
+        EXPECT_CALL(*mockManager_, ListDentry(1, _, 100, false, 0))
+            .WillOnce(DoAll(SetArgPointee<1>(dentrys_),
+                            Return(CURVEFS_ERROR::OK)));
+        std::list<Dentry> out;
+        ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->ListDentry(1, &out, 100));
+        ASSERT_EQ(2, out.size());
+    }
+
+ protected:
+    PersistentDentryCacheOption option_;
+    std::shared_ptr<MockDentryCacheManager> mockManager_;
+    std::shared_ptr<MockMetaServerClient> metaClient_;
+    std::shared_ptr<PersistentDentryCacheManager> dCacheManager_;
+    uint32_t fsId_ = 888;
+    std::list<Dentry> dentrys_ = {
+        MakeDentry(1, "dir", 100, FsFileType::TYPE_DIRECTORY),
+        MakeDentry(1, "file", 101, FsFileType::TYPE_S3)};
+};
+
+TEST_F(TestPersistentDentryCacheManager, ListDentryFromKeptListing) {
+    ASSERT_TRUE(dCacheManager_->Open("fs"));
+    KeepListing();
+
+    // served locally as the directory is unchanged
+    EXPECT_CALL(*metaClient_, GetInodeAttr(fsId_, 1, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<2>(MakeAttr(1, 100)),
+                              Return(MetaStatusCode::OK)));
+    std::list<Dentry> out;
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->ListDentry(1, &out, 100));
+    ASSERT_EQ(2, out.size());
+    ASSERT_EQ("dir", out.front().name());
+    ASSERT_EQ("file", out.back().name());
+
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->ListDentry(1, &out, 100, true, 3));
+    ASSERT_EQ(1, out.size());
+    ASSERT_EQ(100, out.front().inodeid());
+
+    // looking up trusts the validated directory
+    Dentry dentry;
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->GetDentry(1, "file", &dentry));
+    ASSERT_EQ(101, dentry.inodeid());
+    EXPECT_CALL(*mockManager_, GetDentry(1, "none", _))
+        .WillOnce(Return(CURVEFS_ERROR::NOTEXIST));
+    ASSERT_EQ(CURVEFS_ERROR::NOTEXIST,
+              dCacheManager_->GetDentry(1, "none", &dentry));
+}
+
+TEST_F(TestPersistentDentryCacheManager, StaleListing) {
+    ASSERT_TRUE(dCacheManager_->Open("fs"));
+    KeepListing();
+
+    // dentries changed on metaserver
+    EXPECT_CALL(*metaClient_, GetInodeAttr(fsId_, 1, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<2>(MakeAttr(1, 101)),
+                              Return(MetaStatusCode::OK)));
+    std::list<Dentry> dentrys = {dentrys_.front()};
+    EXPECT_CALL(*mockManager_, ListDentry(1, _, 100, false, 0))
+        .WillOnce(DoAll(SetArgPointee<1>(dentrys),
+                        Return(CURVEFS_ERROR::OK)));
+    std::list<Dentry> out;
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->ListDentry(1, &out, 100));
+    ASSERT_EQ(1, out.size());
+}
+
+TEST_F(TestPersistentDentryCacheManager, UnstableVersionNotKept) {
+    ASSERT_TRUE(dCacheManager_->Open("fs"));
+
+    // a pending rename changes dentries of the directory
+    InodeAttr attr = MakeAttr(1, 100);
+    attr.clear_dentryversion();
+    EXPECT_CALL(*metaClient_, GetInodeAttr(fsId_, 1, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(attr),
+                              Return(MetaStatusCode::OK)));
+    EXPECT_CALL(*mockManager_, ListDentry(1, _, 100, false, 0))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(dentrys_),
+                              Return(CURVEFS_ERROR::OK)));
+    std::list<Dentry> out;
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->ListDentry(1, &out, 100));
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->ListDentry(1, &out, 100));
+    ASSERT_EQ(2, out.size());
+}
+
+TEST_F(TestPersistentDentryCacheManager, LocalModificationDropsListing) {
+    ASSERT_TRUE(dCacheManager_->Open("fs"));
+    KeepListing();
+
+    Dentry dentry = MakeDentry(1, "new", 102, FsFileType::TYPE_S3);
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .WillOnce(Return(CURVEFS_ERROR::OK));
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->CreateDentry(dentry));
+
+    // not served locally even if the attribute isn't flushed yet
+    EXPECT_CALL(*mockManager_, GetDentry(1, "file", _))
+        .WillOnce(Return(CURVEFS_ERROR::OK));
+    Dentry out;
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->GetDentry(1, "file", &out));
+}
+
+TEST_F(TestPersistentDentryCacheManager, EmptyListingNotKept) {
+    ASSERT_TRUE(dCacheManager_->Open("fs"));
+    EXPECT_CALL(*metaClient_, GetInodeAttr(fsId_, 1, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(MakeAttr(1, 100)),
+                              Return(MetaStatusCode::OK)));
+    EXPECT_CALL(*mockManager_, ListDentry(1, _, 100, false, 0))
+        .Times(2)
+        .WillRepeatedly(Return(CURVEFS_ERROR::OK));
+    std::list<Dentry> out;
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->ListDentry(1, &out, 100));
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->ListDentry(1, &out, 100));
+    ASSERT_TRUE(out.empty());
+}
+
+TEST_F(TestPersistentDentryCacheManager, WarmUpAfterRemount) {
+    ASSERT_TRUE(dCacheManager_->Open("fs"));
+    KeepListing();
+    dCacheManager_->Stop();
+
+    // remount, the kept directory is validated in background
+    Open();
+    std::atomic<bool> validated(false);
+    EXPECT_CALL(*metaClient_, BatchGetInodeAttr(fsId_, _, _))
+        .WillOnce(Invoke([this, &validated](
+                             uint32_t fsId, const std::set<uint64_t> &inodeIds,
+                             std::list<InodeAttr> *attrs) {
+            EXPECT_EQ(1, inodeIds.size());
+            attrs->emplace_back(MakeAttr(1, 100));
+            validated.store(true);
+            return MetaStatusCode::OK;
+        }));
+    ASSERT_TRUE(dCacheManager_->Open("fs"));
+    for (int i = 0; i < 100 && !validated.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // wait until the warm up is done
+    dCacheManager_->Stop();
+
+    EXPECT_CALL(*metaClient_, GetInodeAttr(_, _, _)).Times(0);
+    EXPECT_CALL(*mockManager_, GetDentry(_, _, _)).Times(0);
+    Dentry out;
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->GetDentry(1, "dir", &out));
+    ASSERT_EQ(100, out.inodeid());
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -0,0 +1,378 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-31
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <sys/stat.h>
+
+#include <chrono>
+#include <thread>
+
+#include "curvefs/src/client/writeback_dentry_cache_manager.h"
+#include "curvefs/test/client/mock_dentry_cache_mamager.h"
+#include "curvefs/test/client/mock_metaserver_client.h"
+
+namespace curvefs {
+namespace client {
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::InSequence;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+using ::curvefs::metaserver::MetaStatusCode;
+using rpcclient::MockMetaServerClient;
+
+class TestWriteBackDentryCacheManager : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        option_.enable = true;
+        // flush only when asked to
+        option_.flushIntervalMs = 3600 * 1000;
+        option_.maxPendingDentries = 100;
+        option_.flushThreads = 4;
+        Init();
+    }
+
+    void TearDown() override {
+        dCacheManager_->Stop();
+    }
+
+    void Init() {
+        mockManager_ = std::make_shared<MockDentryCacheManager>();
+        metaClient_ = std::make_shared<MockMetaServerClient>();
+        dCacheManager_ = std::make_shared<WriteBackDentryCacheManager>(
+            mockManager_, metaClient_, option_);
+        EXPECT_CALL(*mockManager_, Init(10, false, 3))
+            .WillOnce(Return(CURVEFS_ERROR::OK));
+        ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->Init(10, false, 3));
+    }
+
+    Dentry MakeDentry(uint64_t parent, const std::string &name,
+                      uint64_t inodeid) {
+        Dentry dentry;
+        dentry.set_fsid(fsId_);
+        dentry.set_parentinodeid(parent);
+        dentry.set_name(name);
+        dentry.set_inodeid(inodeid);
+        dentry.set_type(FsFileType::TYPE_S3);
+        return dentry;
+    }
+
+    InodeParam MakeInodeParam(uint64_t parent, uint64_t inodeid) {
+        InodeParam param;
+        param.fsId = fsId_;
+        param.length = 0;
+        param.uid = 0;
+        param.gid = 0;
+        param.mode = S_IFREG | 0644;
+        param.type = FsFileType::TYPE_S3;
+        param.rdev = 0;
+        param.parent = parent;
+        param.inodeId = inodeid;
+        param.leaseId = 1;
+        param.timestamp = timespec{1000, 10};
+        return param;
+    }
+
+ protected:
+    DentryWriteBackOption option_;
+    std::shared_ptr<MockDentryCacheManager> mockManager_;
+    std::shared_ptr<MockMetaServerClient> metaClient_;
+    std::shared_ptr<WriteBackDentryCacheManager> dCacheManager_;
+    uint32_t fsId_ = 888;
+};
+
+TEST_F(TestWriteBackDentryCacheManager, CreateGetAndDeletePendingDentry) {
+    Dentry dentry = MakeDentry(1, "file", 100);
+    EXPECT_CALL(*mockManager_, CreateDentry(_)).Times(0);
+    EXPECT_CALL(*mockManager_, DeleteDentry(_, _, _)).Times(0);
+
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->CreateDentry(dentry));
+    ASSERT_EQ(CURVEFS_ERROR::EXISTS, dCacheManager_->CreateDentry(dentry));
+    ASSERT_EQ(1, dCacheManager_->PendingCount());
+
+    Dentry out;
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->GetDentry(1, "file", &out));
+    ASSERT_EQ(100, out.inodeid());
+
+    // removed before flushed, metaserver never sees it
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->DeleteDentry(1, "file", FsFileType::TYPE_S3));
+    ASSERT_EQ(0, dCacheManager_->PendingCount());
+
+    EXPECT_CALL(*mockManager_, GetDentry(1, "file", _))
+        .WillOnce(Return(CURVEFS_ERROR::NOTEXIST));
+    ASSERT_EQ(CURVEFS_ERROR::NOTEXIST,
+              dCacheManager_->GetDentry(1, "file", &out));
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushAll());
+}
+
+TEST_F(TestWriteBackDentryCacheManager, Flush) {
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .Times(3)
+        .WillRepeatedly(Return(CURVEFS_ERROR::OK));
+
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateDentry(MakeDentry(1, "a", 100)));
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateDentry(MakeDentry(1, "b", 101)));
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateDentry(MakeDentry(2, "a", 102)));
+
+    // only flush dentries under parent 1
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->Flush(1));
+    ASSERT_EQ(1, dCacheManager_->PendingCount());
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushAll());
+    ASSERT_EQ(0, dCacheManager_->PendingCount());
+
+    // flushed dentry is removed from metaserver
+    EXPECT_CALL(*mockManager_, DeleteDentry(1, "a", FsFileType::TYPE_S3))
+        .WillOnce(Return(CURVEFS_ERROR::OK));
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->DeleteDentry(1, "a", FsFileType::TYPE_S3));
+}
+
+TEST_F(TestWriteBackDentryCacheManager, FlushFailed) {
+    Dentry failed;
+    dCacheManager_->SetFlushFailedCallback(
+        [&failed](const Dentry &dentry, bool withInode, CURVEFS_ERROR ret) {
+            ASSERT_FALSE(withInode);
+            ASSERT_EQ(CURVEFS_ERROR::EXISTS, ret);
+            failed = dentry;
+        });
+
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .WillOnce(Return(CURVEFS_ERROR::EXISTS));
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateDentry(MakeDentry(1, "a", 100)));
+    ASSERT_EQ(CURVEFS_ERROR::EXISTS, dCacheManager_->FlushAll());
+    ASSERT_EQ(100, failed.inodeid());
+
+    // error is reported only once
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushAll());
+}
+
+TEST_F(TestWriteBackDentryCacheManager, FlushInodeBeforeDentry) {
+    InodeParam param = MakeInodeParam(1, 100);
+    Dentry dentry = MakeDentry(1, "a", 100);
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateInodeAndDentry(param, dentry));
+    ASSERT_EQ(CURVEFS_ERROR::EXISTS,
+              dCacheManager_->CreateInodeAndDentry(param, dentry));
+
+    Dentry out;
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->GetDentry(1, "a", &out));
+    ASSERT_EQ(100, out.inodeid());
+
+    {
+        InSequence s;
+        EXPECT_CALL(*metaClient_, CreateInode(_, _))
+            .WillOnce(Invoke([](const InodeParam &param,
+                                ::curvefs::metaserver::Inode *inode) {
+                EXPECT_EQ(100, param.inodeId);
+                EXPECT_EQ(1, param.leaseId);
+                EXPECT_EQ(1000, param.timestamp->tv_sec);
+                return MetaStatusCode::OK;
+            }));
+        EXPECT_CALL(*mockManager_, CreateDentry(_))
+            .WillOnce(Return(CURVEFS_ERROR::OK));
+    }
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushAll());
+    ASSERT_EQ(0, dCacheManager_->PendingCount());
+
+    // already created
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushInode(100));
+}
+
+TEST_F(TestWriteBackDentryCacheManager, FlushInodeAndDentryInOneRequest) {
+    option_.createInodeAndDentry = true;
+    Init();
+
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateInodeAndDentry(MakeInodeParam(1, 100),
+                                                   MakeDentry(1, "a", 100)));
+    EXPECT_CALL(*metaClient_, CreateInodeAndDentry(_, "a", _))
+        .WillOnce(Invoke([](const InodeParam &param, const std::string &name,
+                            ::curvefs::metaserver::Inode *inode) {
+            EXPECT_EQ(100, param.inodeId);
+            EXPECT_EQ(1, param.leaseId);
+            EXPECT_EQ(1000, param.timestamp->tv_sec);
+            return MetaStatusCode::OK;
+        }));
+    EXPECT_CALL(*metaClient_, CreateInode(_, _)).Times(0);
+    EXPECT_CALL(*mockManager_, CreateDentry(_)).Times(0);
+    EXPECT_CALL(*mockManager_, InsertOrReplaceCache(_)).Times(1);
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushAll());
+    ASSERT_EQ(0, dCacheManager_->PendingCount());
+
+    // the leased id is not in the partition of parent
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateInodeAndDentry(MakeInodeParam(1, 101),
+                                                   MakeDentry(1, "b", 101)));
+    {
+        InSequence s;
+        EXPECT_CALL(*metaClient_, CreateInodeAndDentry(_, "b", _))
+            .WillOnce(Return(MetaStatusCode::PARTITION_ID_MISSMATCH));
+        EXPECT_CALL(*metaClient_, CreateInode(_, _))
+            .WillOnce(Return(MetaStatusCode::OK));
+        EXPECT_CALL(*mockManager_, CreateDentry(_))
+            .WillOnce(Return(CURVEFS_ERROR::OK));
+    }
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushAll());
+    ASSERT_EQ(0, dCacheManager_->PendingCount());
+
+    // dentries without inode are flushed as before
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateDentry(MakeDentry(1, "c", 102)));
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .WillOnce(Return(CURVEFS_ERROR::OK));
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushAll());
+}
+
+TEST_F(TestWriteBackDentryCacheManager, FlushInode) {
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateInodeAndDentry(MakeInodeParam(1, 100),
+                                                   MakeDentry(1, "a", 100)));
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateInodeAndDentry(MakeInodeParam(2, 101),
+                                                   MakeDentry(2, "b", 101)));
+
+    // not journaled
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushInode(102));
+
+    // only entries under the parent of the inode are flushed
+    EXPECT_CALL(*metaClient_, CreateInode(_, _))
+        .WillOnce(Return(MetaStatusCode::OK));
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .WillOnce(Return(CURVEFS_ERROR::OK));
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->FlushInode(100));
+    ASSERT_EQ(1, dCacheManager_->PendingCount());
+
+    EXPECT_CALL(*metaClient_, CreateInode(_, _))
+        .WillOnce(Return(MetaStatusCode::OK));
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .WillOnce(Return(CURVEFS_ERROR::OK));
+}
+
+TEST_F(TestWriteBackDentryCacheManager, FlushInodeFailed) {
+    int failed = 0;
+    dCacheManager_->SetFlushFailedCallback(
+        [&failed](const Dentry &dentry, bool withInode, CURVEFS_ERROR ret) {
+            ASSERT_TRUE(withInode);
+            ASSERT_EQ(100, dentry.inodeid());
+            ++failed;
+        });
+
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateInodeAndDentry(MakeInodeParam(1, 100),
+                                                   MakeDentry(1, "a", 100)));
+
+    // the inode is deleted if its dentry failed
+    EXPECT_CALL(*metaClient_, CreateInode(_, _))
+        .WillOnce(Return(MetaStatusCode::OK));
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .WillOnce(Return(CURVEFS_ERROR::EXISTS));
+    EXPECT_CALL(*metaClient_, DeleteInode(fsId_, 100))
+        .WillOnce(Return(MetaStatusCode::OK));
+    ASSERT_EQ(CURVEFS_ERROR::EXISTS, dCacheManager_->FlushInode(100));
+    ASSERT_EQ(CURVEFS_ERROR::EXISTS, dCacheManager_->FlushInode(100));
+
+    // callbacks are not run by FlushInode
+    ASSERT_EQ(0, failed);
+    ASSERT_EQ(CURVEFS_ERROR::EXISTS, dCacheManager_->FlushAll());
+    ASSERT_EQ(1, failed);
+}
+
+TEST_F(TestWriteBackDentryCacheManager, DeletePendingDentryWithInode) {
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateInodeAndDentry(MakeInodeParam(1, 100),
+                                                   MakeDentry(1, "a", 100)));
+
+    // the inode is unlinked on metaserver later, so it's flushed first
+    {
+        InSequence s;
+        EXPECT_CALL(*metaClient_, CreateInode(_, _))
+            .WillOnce(Return(MetaStatusCode::OK));
+        EXPECT_CALL(*mockManager_, CreateDentry(_))
+            .WillOnce(Return(CURVEFS_ERROR::OK));
+        EXPECT_CALL(*mockManager_, DeleteDentry(1, "a", FsFileType::TYPE_S3))
+            .WillOnce(Return(CURVEFS_ERROR::OK));
+    }
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->DeleteDentry(1, "a", FsFileType::TYPE_S3));
+    ASSERT_EQ(0, dCacheManager_->PendingCount());
+}
+
+TEST_F(TestWriteBackDentryCacheManager, ListDentryFlushPending) {
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .WillOnce(Return(CURVEFS_ERROR::OK));
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateDentry(MakeDentry(1, "a", 100)));
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateDentry(MakeDentry(2, "a", 101)));
+
+    std::list<Dentry> dentrys = {MakeDentry(1, "a", 100)};
+    EXPECT_CALL(*mockManager_, ListDentry(1, _, 100, false, 0))
+        .WillOnce(DoAll(SetArgPointee<1>(dentrys),
+                        Return(CURVEFS_ERROR::OK)));
+    std::list<Dentry> out;
+    ASSERT_EQ(CURVEFS_ERROR::OK, dCacheManager_->ListDentry(1, &out, 100));
+    ASSERT_EQ(1, out.size());
+    ASSERT_EQ(1, dCacheManager_->PendingCount());
+
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .WillOnce(Return(CURVEFS_ERROR::OK));
+}
+
+TEST_F(TestWriteBackDentryCacheManager, ThrottleWhenTooManyPending) {
+    option_.maxPendingDentries = 10;
+    Init();
+
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .Times(10)
+        .WillRepeatedly(Return(CURVEFS_ERROR::OK));
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(CURVEFS_ERROR::OK,
+                  dCacheManager_->CreateDentry(
+                      MakeDentry(1, std::to_string(i), 100 + i)));
+    }
+    ASSERT_EQ(0, dCacheManager_->PendingCount());
+}
+
+TEST_F(TestWriteBackDentryCacheManager, FlushBackground) {
+    option_.flushIntervalMs = 10;
+    Init();
+
+    EXPECT_CALL(*mockManager_, CreateDentry(_))
+        .WillOnce(Return(CURVEFS_ERROR::OK));
+    ASSERT_EQ(CURVEFS_ERROR::OK,
+              dCacheManager_->CreateDentry(MakeDentry(1, "a", 100)));
+    for (int i = 0; i < 100 && dCacheManager_->PendingCount() != 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(0, dCacheManager_->PendingCount());
+}
+
+}  // namespace client
+}  // namespace curvefs
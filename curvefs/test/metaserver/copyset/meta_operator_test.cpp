@@ -143,6 +143,8 @@ TEST_F(MetaOperatorTest, OperatorTypeTest) {
     TEST_OPERATOR_TYPE(DeleteInode);
     TEST_OPERATOR_TYPE(CreateRootInode);
     TEST_OPERATOR_TYPE(CreateManageInode);
+    TEST_OPERATOR_TYPE(CreateInodeAndDentry);
+    TEST_OPERATOR_TYPE(AllocInodeIds);
     TEST_OPERATOR_TYPE(CreatePartition);
     TEST_OPERATOR_TYPE(DeletePartition);
     TEST_OPERATOR_TYPE(PrepareRenameTx);
@@ -190,6 +192,8 @@ TEST_F(MetaOperatorTest, OnApplyErrorTest) {
     OPERATOR_ON_APPLY_TEST(DeleteInode);
     OPERATOR_ON_APPLY_TEST(CreateRootInode);
     OPERATOR_ON_APPLY_TEST(CreateManageInode);
+    OPERATOR_ON_APPLY_TEST(CreateInodeAndDentry);
+    OPERATOR_ON_APPLY_TEST(AllocInodeIds);
     OPERATOR_ON_APPLY_TEST(CreatePartition);
     OPERATOR_ON_APPLY_TEST(DeletePartition);
     OPERATOR_ON_APPLY_TEST(PrepareRenameTx);
@@ -308,6 +312,8 @@ TEST_F(MetaOperatorTest, OnApplyFromLogErrorTest) {
     OPERATOR_ON_APPLY_FROM_LOG_TEST(DeleteInode);
     OPERATOR_ON_APPLY_FROM_LOG_TEST(CreateRootInode);
     OPERATOR_ON_APPLY_FROM_LOG_TEST(CreateManageInode);
+    OPERATOR_ON_APPLY_FROM_LOG_TEST(CreateInodeAndDentry);
+    OPERATOR_ON_APPLY_FROM_LOG_TEST(AllocInodeIds);
     OPERATOR_ON_APPLY_FROM_LOG_TEST(CreatePartition);
     OPERATOR_ON_APPLY_FROM_LOG_TEST(DeletePartition);
     OPERATOR_ON_APPLY_FROM_LOG_TEST(PrepareRenameTx);
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-09-17
+ */
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "curvefs/src/metaserver/copyset/meta_operator.h"
+#include "curvefs/src/metaserver/copyset/proposal_batcher.h"
+#include "curvefs/src/metaserver/copyset/raft_log_codec.h"
+#include "curvefs/test/metaserver/copyset/mock/mock_copyset_node.h"
+
+namespace curvefs {
+namespace metaserver {
+namespace copyset {
+
+using ::testing::_;
+using ::testing::Invoke;
+
+namespace {
+
+// closure of a synchronous request
+class SyncDoneClosure : public google::protobuf::Closure {
+ public:
+    void Run() override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        finished_ = true;
+        cond_.notify_one();
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lk(mtx_);
+        cond_.wait(lk, [this]() { return finished_; });
+        finished_ = false;
+    }
+
+ private:
+    std::mutex mtx_;
+    std::condition_variable cond_;
+    bool finished_ = false;
+};
+
+}  // namespace
+
+// Simulate a raft node that every log entry costs |kEntryLatencyUs| to
+// replicate, and measure creates per second of one copyset with concurrent
+// clients, with and without batching.
+TEST(ProposalBatcherBenchmarkTest, CreatesPerSecond) {
+    const int kClients = 32;
+    const int kEntryLatencyUs = 500;
+    const auto kDuration = std::chrono::milliseconds(500);
+
+    auto run = [&](uint32_t maxBatchSize) -> double {
+        MockCopysetNode node;
+        EXPECT_CALL(node, Propose(_))
+            .WillRepeatedly(Invoke([&](const braft::Task& task) {
+                std::this_thread::sleep_for(
+                    std::chrono::microseconds(kEntryLatencyUs));
+                task.done->Run();
+            }));
+
+        ProposalBatchOption option;
+        option.enable = true;
+        option.maxBatchSize = maxBatchSize;
+        ProposalBatcher batcher(&node, 1, 1);
+        EXPECT_TRUE(batcher.Start(option));
+
+        std::atomic<bool> stop(false);
+        std::atomic<uint64_t> creates(0);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < kClients; ++i) {
+            clients.emplace_back([&, i]() {
+                CreateInodeRequest request;
+                request.set_poolid(1);
+                request.set_copysetid(1);
+                request.set_partitionid(i);
+                request.set_fsid(1);
+                request.set_length(0);
+                request.set_uid(0);
+                request.set_gid(0);
+                request.set_mode(0644);
+                request.set_type(FsFileType::TYPE_FILE);
+                request.set_parent(1);
+                CreateInodeResponse response;
+                SyncDoneClosure done;
+
+                butil::IOBuf log;
+                ASSERT_TRUE(RaftLogCodec::Encode(OperatorType::CreateInode,
+                                                 &request, &log));
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto* op = new CreateInodeOperator(&node, nullptr,
+                                                       &request, &response,
+                                                       &done);
+                    butil::IOBuf copy(log);
+                    ASSERT_TRUE(batcher.Propose(op, &copy, 1));
+                    done.Wait();
+                    creates.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(kDuration);
+        stop.store(true);
+        for (auto& client : clients) {
+            client.join();
+        }
+        auto elapsed = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+        batcher.Stop();
+        return creates.load() / elapsed;
+    };
+
+    double unbatched = run(1);
+    double batched = run(ProposalBatchOption().maxBatchSize);
+    LOG(INFO) << "creates/s per copyset, unbatched: " << unbatched
+              << ", batched: " << batched;
+    ASSERT_GT(batched, unbatched);
+}
+
+}  // namespace copyset
+}  // namespace metaserver
+}  // namespace curvefs
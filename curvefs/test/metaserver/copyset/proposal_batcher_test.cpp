@@ -0,0 +1,242 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-30
+ */
+
+#include "curvefs/src/metaserver/copyset/proposal_batcher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "curvefs/src/metaserver/copyset/meta_operator.h"
+#include "curvefs/src/metaserver/copyset/meta_operator_closure.h"
+#include "curvefs/src/metaserver/copyset/raft_log_codec.h"
+#include "curvefs/test/metaserver/copyset/mock/mock_copyset_node.h"
+
+namespace curvefs {
+namespace metaserver {
+namespace copyset {
+
+using ::testing::_;
+using ::testing::Invoke;
+
+namespace {
+
+class CountDoneClosure : public google::protobuf::Closure {
+ public:
+    void Run() override {
+        count.fetch_add(1);
+    }
+
+    std::atomic<int> count{0};
+};
+
+struct ProposedTask {
+    butil::IOBuf data;
+    braft::Closure* done;
+    int64_t term;
+};
+
+}  // namespace
+
+class ProposalBatcherTest : public testing::Test {
+ protected:
+    void SetUp() override {
+        option_.enable = true;
+        option_.maxBatchSize = 4;
+        option_.maxBatchBytes = 1024 * 1024;
+        batcher_ = absl::make_unique<ProposalBatcher>(&node_, 1, 1);
+
+        EXPECT_CALL(node_, Propose(_))
+            .WillRepeatedly(Invoke([this](const braft::Task& task) {
+                std::unique_lock<std::mutex> lk(mtx_);
+                tasks_.push_back({*task.data, task.done, task.expected_term});
+                cond_.notify_all();
+                // block the batcher to make following operators queued
+                cond_.wait(lk, [this]() { return !blocked_; });
+            }));
+    }
+
+    void TearDown() override {
+        for (auto& request : requests_) {
+            delete request;
+        }
+        for (auto& response : responses_) {
+            delete response;
+        }
+    }
+
+    void Propose(uint32_t partitionId, int64_t term) {
+        auto* request = new UpdateInodeRequest();
+        request->set_poolid(1);
+        request->set_copysetid(1);
+        request->set_partitionid(partitionId);
+        request->set_fsid(1);
+        request->set_inodeid(1);
+        auto* response = new UpdateInodeResponse();
+        requests_.push_back(request);
+        responses_.push_back(response);
+
+        auto* op = new UpdateInodeOperator(&node_, nullptr, request, response,
+                                           &done_);
+        butil::IOBuf log;
+        ASSERT_TRUE(
+            RaftLogCodec::Encode(OperatorType::UpdateInode, request, &log));
+        ASSERT_TRUE(batcher_->Propose(op, &log, term));
+    }
+
+    void WaitProposed(size_t count) {
+        std::unique_lock<std::mutex> lk(mtx_);
+        cond_.wait(lk, [this, count]() { return tasks_.size() >= count; });
+    }
+
+    void Unblock() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        blocked_ = false;
+        cond_.notify_all();
+    }
+
+    // decode partition ids of operators in a proposed raft log entry
+    std::vector<uint64_t> DecodePartitionIds(const ProposedTask& task) {
+        std::vector<std::unique_ptr<MetaOperator>> ops;
+        EXPECT_TRUE(RaftLogCodec::DecodeBatch(&node_, task.data, &ops));
+        std::vector<uint64_t> partitionIds;
+        for (auto& op : ops) {
+            EXPECT_EQ(OperatorType::UpdateInode, op->GetOperatorType());
+            partitionIds.push_back(op->HashCode());
+        }
+        return partitionIds;
+    }
+
+ protected:
+    MockCopysetNode node_;
+    ProposalBatchOption option_;
+    std::unique_ptr<ProposalBatcher> batcher_;
+    CountDoneClosure done_;
+
+    std::vector<UpdateInodeRequest*> requests_;
+    std::vector<UpdateInodeResponse*> responses_;
+
+    std::mutex mtx_;
+    std::condition_variable cond_;
+    bool blocked_ = true;
+    std::vector<ProposedTask> tasks_;
+};
+
+TEST_F(ProposalBatcherTest, SingleOperatorTest) {
+    ASSERT_TRUE(batcher_->Start(option_));
+    Unblock();
+
+    Propose(1, 1);
+    batcher_->Stop();
+
+    // a lone operator is proposed as a normal raft log entry
+    ASSERT_EQ(1u, tasks_.size());
+    ASSERT_NE(nullptr, RaftLogCodec::Decode(&node_, tasks_[0].data));
+    ASSERT_NE(nullptr, dynamic_cast<MetaOperatorClosure*>(tasks_[0].done));
+    ASSERT_EQ(1, tasks_[0].term);
+
+    tasks_[0].done->status().set_error(EPERM, "not leader");
+    tasks_[0].done->Run();
+    ASSERT_EQ(1, done_.count.load());
+    ASSERT_EQ(MetaStatusCode::REDIRECTED, responses_[0]->statuscode());
+}
+
+TEST_F(ProposalBatcherTest, BatchOperatorsTest) {
+    ASSERT_TRUE(batcher_->Start(option_));
+
+    // operators queued while batcher is proposing are packed together, and
+    // each raft log entry contains at most |maxBatchSize| operators
+    Propose(0, 1);
+    WaitProposed(1);
+    for (uint32_t i = 1; i <= 10; ++i) {
+        Propose(i, 1);
+    }
+    Unblock();
+    batcher_->Stop();
+
+    ASSERT_EQ(4u, tasks_.size());
+    ASSERT_EQ(std::vector<uint64_t>({1, 2, 3, 4}),
+              DecodePartitionIds(tasks_[1]));
+    ASSERT_EQ(std::vector<uint64_t>({5, 6, 7, 8}),
+              DecodePartitionIds(tasks_[2]));
+    ASSERT_EQ(std::vector<uint64_t>({9, 10}), DecodePartitionIds(tasks_[3]));
+    for (size_t i = 1; i < tasks_.size(); ++i) {
+        ASSERT_NE(nullptr,
+                  dynamic_cast<BatchMetaOperatorClosure*>(tasks_[i].done));
+    }
+
+    // failed raft log entry redirects all operators in it
+    for (auto& task : tasks_) {
+        task.done->status().set_error(EPERM, "not leader");
+        task.done->Run();
+    }
+    ASSERT_EQ(11, done_.count.load());
+    for (auto* response : responses_) {
+        ASSERT_EQ(MetaStatusCode::REDIRECTED, response->statuscode());
+    }
+}
+
+TEST_F(ProposalBatcherTest, BatchOperatorsWithDifferentTermTest) {
+    ASSERT_TRUE(batcher_->Start(option_));
+
+    Propose(0, 1);
+    WaitProposed(1);
+    Propose(1, 1);
+    Propose(2, 2);
+    Propose(3, 2);
+    Unblock();
+    batcher_->Stop();
+
+    ASSERT_EQ(3u, tasks_.size());
+    ASSERT_EQ(1, tasks_[1].term);
+    ASSERT_EQ(std::vector<uint64_t>({1}), DecodePartitionIds(tasks_[1]));
+    ASSERT_EQ(2, tasks_[2].term);
+    ASSERT_EQ(std::vector<uint64_t>({2, 3}), DecodePartitionIds(tasks_[2]));
+
+    for (auto& task : tasks_) {
+        task.done->status().set_error(EPERM, "not leader");
+        task.done->Run();
+    }
+    ASSERT_EQ(4, done_.count.load());
+}
+
+TEST_F(ProposalBatcherTest, ProposeAfterStopTest) {
+    ASSERT_TRUE(batcher_->Start(option_));
+    batcher_->Stop();
+
+    UpdateInodeRequest request;
+    UpdateInodeResponse response;
+    UpdateInodeOperator op(&node_, nullptr, &request, &response, nullptr);
+    butil::IOBuf log;
+    log.append("hello");
+    ASSERT_FALSE(batcher_->Propose(&op, &log, 1));
+    ASSERT_EQ("hello", log.to_string());
+}
+
+}  // namespace copyset
+}  // namespace metaserver
+}  // namespace curvefs
@@ -26,6 +26,10 @@
 #include <google/protobuf/message.h>
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/metaserver/copyset/meta_operator.h"
 #include "curvefs/test/utils/protobuf_message_utils.h"
@@ -121,6 +125,8 @@ TEST(RaftLogCodecTest, DecodeFailedTest) {
     DECODE_FAILED_TEST(DeleteInode);
     DECODE_FAILED_TEST(CreateRootInode);
     DECODE_FAILED_TEST(CreateManageInode);
+    DECODE_FAILED_TEST(CreateInodeAndDentry);
+    DECODE_FAILED_TEST(AllocInodeIds);
     DECODE_FAILED_TEST(CreatePartition);
     DECODE_FAILED_TEST(DeletePartition);
     DECODE_FAILED_TEST(PrepareRenameTx);
@@ -154,6 +160,8 @@ TEST(RaftLogCodecTest, DecodeSuccessTest) {
     ENCODE_DECODE_TEST(DeleteInode);
     ENCODE_DECODE_TEST(CreateRootInode);
     ENCODE_DECODE_TEST(CreateManageInode);
+    ENCODE_DECODE_TEST(CreateInodeAndDentry);
+    ENCODE_DECODE_TEST(AllocInodeIds);
     ENCODE_DECODE_TEST(CreatePartition);
     ENCODE_DECODE_TEST(DeletePartition);
     ENCODE_DECODE_TEST(PrepareRenameTx);
@@ -161,6 +169,61 @@ TEST(RaftLogCodecTest, DecodeSuccessTest) {
 #undef ENCODE_DECODE_TEST
 }
 
+TEST(RaftLogCodecTest, EncodeAndDecodeBatchTest) {
+    std::vector<OperatorType> types{OperatorType::CreateInode,
+                                    OperatorType::CreateDentry,
+                                    OperatorType::UpdateInode};
+    std::vector<butil::IOBuf> logs(types.size());
+    for (size_t i = 0; i < types.size(); ++i) {
+        auto request = GenerateAnDefaultInitializedMessage(
+            std::string("curvefs.metaserver.") + OperatorTypeName(types[i]) +
+            "Request");
+        ASSERT_NE(nullptr, request);
+        ASSERT_TRUE(RaftLogCodec::Encode(types[i], request.get(), &logs[i]));
+    }
+
+    butil::IOBuf batch;
+    RaftLogCodec::EncodeBatch(logs, &batch);
+
+    // operators are decoded in the order they were encoded
+    std::vector<std::unique_ptr<MetaOperator>> ops;
+    ASSERT_TRUE(RaftLogCodec::DecodeBatch(nullptr, batch, &ops));
+    ASSERT_EQ(types.size(), ops.size());
+    for (size_t i = 0; i < types.size(); ++i) {
+        EXPECT_EQ(types[i], ops[i]->GetOperatorType());
+    }
+
+    // single operator log is also decoded by DecodeBatch
+    ops.clear();
+    ASSERT_TRUE(RaftLogCodec::DecodeBatch(nullptr, logs[0], &ops));
+    ASSERT_EQ(1u, ops.size());
+    EXPECT_EQ(types[0], ops[0]->GetOperatorType());
+
+    // batch log can't be decoded as single operator log
+    EXPECT_EQ(nullptr, RaftLogCodec::Decode(nullptr, batch));
+}
+
+TEST(RaftLogCodecTest, DecodeBatchFailedTest) {
+    std::vector<std::unique_ptr<MetaOperator>> ops;
+    ASSERT_FALSE(RaftLogCodec::DecodeBatch(nullptr, butil::IOBuf(), &ops));
+
+    auto request = GenerateAnDefaultInitializedMessage(
+        "curvefs.metaserver.CreateInodeRequest");
+    ASSERT_NE(nullptr, request);
+    std::vector<butil::IOBuf> logs(2);
+    ASSERT_TRUE(RaftLogCodec::Encode(OperatorType::CreateInode, request.get(),
+                                     &logs[0]));
+    ASSERT_TRUE(RaftLogCodec::Encode(OperatorType::CreateInode, request.get(),
+                                     &logs[1]));
+
+    // truncated batch log
+    butil::IOBuf batch;
+    RaftLogCodec::EncodeBatch(logs, &batch);
+    butil::IOBuf truncated;
+    batch.cutn(&truncated, batch.size() - logs[1].size());
+    ASSERT_FALSE(RaftLogCodec::DecodeBatch(nullptr, truncated, &ops));
+}
+
 }  // namespace copyset
 }  // namespace metaserver
 }  // namespace curvefs
@@ -89,6 +89,8 @@ TEST_F(MetaServerServiceTest2, ServiceOverload) {
     TEST_SERVICE_OVERLOAD(DeleteInode);
     TEST_SERVICE_OVERLOAD(CreateRootInode);
     TEST_SERVICE_OVERLOAD(CreateManageInode);
+    TEST_SERVICE_OVERLOAD(CreateInodeAndDentry);
+    TEST_SERVICE_OVERLOAD(AllocInodeIds);
     TEST_SERVICE_OVERLOAD(CreatePartition);
     TEST_SERVICE_OVERLOAD(DeletePartition);
     TEST_SERVICE_OVERLOAD(PrepareRenameTx);
@@ -123,6 +125,8 @@ TEST_F(MetaServerServiceTest2, CopysetNodeNotFound) {
     TEST_COPYSETNODE_NOTFOUND(DeleteInode);
     TEST_COPYSETNODE_NOTFOUND(CreateRootInode);
     TEST_COPYSETNODE_NOTFOUND(CreateManageInode);
+    TEST_COPYSETNODE_NOTFOUND(CreateInodeAndDentry);
+    TEST_COPYSETNODE_NOTFOUND(AllocInodeIds);
     TEST_COPYSETNODE_NOTFOUND(CreatePartition);
     TEST_COPYSETNODE_NOTFOUND(DeletePartition);
     TEST_COPYSETNODE_NOTFOUND(PrepareRenameTx);
@@ -64,6 +64,12 @@ class MockMetaStore : public curvefs::metaserver::MetaStore {
     MOCK_METHOD2(CreateManageInode,
                 MetaStatusCode(const CreateManageInodeRequest*,
                                                  CreateManageInodeResponse*));
+    MOCK_METHOD2(CreateInodeAndDentry,
+                 MetaStatusCode(const CreateInodeAndDentryRequest*,
+                                CreateInodeAndDentryResponse*));
+    MOCK_METHOD2(AllocInodeIds,
+                 MetaStatusCode(const AllocInodeIdsRequest*,
+                                AllocInodeIdsResponse*));
     MOCK_METHOD2(GetInode,
                  MetaStatusCode(const GetInodeRequest*, GetInodeResponse*));
     MOCK_METHOD2(BatchGetInodeAttr,
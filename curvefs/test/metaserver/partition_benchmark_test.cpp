@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-09-17
+ */
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "curvefs/src/metaserver/partition.h"
+#include "curvefs/src/metaserver/storage/rocksdb_storage.h"
+#include "curvefs/src/metaserver/storage/storage.h"
+#include "curvefs/test/metaserver/storage/utils.h"
+#include "src/fs/ext4_filesystem_impl.h"
+
+using ::curvefs::metaserver::storage::KVStorage;
+using ::curvefs::metaserver::storage::RandomStoragePath;
+using ::curvefs::metaserver::storage::RocksDBStorage;
+using ::curvefs::metaserver::storage::StorageOptions;
+
+namespace curvefs {
+namespace metaserver {
+
+namespace {
+auto localfs = curve::fs::Ext4FileSystemImpl::getInstance();
+}
+
+class PartitionBenchmarkTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        param_.fsId = 1;
+        param_.length = 0;
+        param_.uid = 0;
+        param_.gid = 0;
+        param_.mode = 0;
+        param_.type = FsFileType::TYPE_FILE;
+        param_.symlink = "";
+        param_.rdev = 0;
+
+        dataDir_ = RandomStoragePath();
+        StorageOptions options;
+        options.dataDir = dataDir_;
+        options.localFileSystem = localfs.get();
+        kvStorage_ = std::make_shared<RocksDBStorage>(options);
+        ASSERT_TRUE(kvStorage_->Open());
+    }
+
+    void TearDown() override {
+        ASSERT_TRUE(kvStorage_->Close());
+        ASSERT_EQ(0, system(("rm -rf " + dataDir_).c_str()));
+    }
+
+ protected:
+    InodeParam param_;
+    std::string dataDir_;
+    std::shared_ptr<KVStorage> kvStorage_;
+};
+
+// mdtest-like create benchmark: every raft log entry costs
+// |kEntryLatencyUs| to replicate, creating a file with CreateInode and
+// CreateDentry needs two entries, while CreateInodeAndDentry needs one.
+TEST_F(PartitionBenchmarkTest, CreateInodeAndDentry) {
+    const uint32_t kFiles = 1000;
+    const int kEntryLatencyUs = 200;
+
+    auto replicate = [&]() {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds(kEntryLatencyUs));
+    };
+
+    auto run = [&](uint32_t partitionId, bool compound) -> double {
+        PartitionInfo partitionInfo;
+        partitionInfo.set_fsid(1);
+        partitionInfo.set_poolid(2);
+        partitionInfo.set_copysetid(3);
+        partitionInfo.set_partitionid(partitionId);
+        partitionInfo.set_start(partitionId * 10000);
+        partitionInfo.set_end(partitionId * 10000 + kFiles);
+        Partition partition(partitionInfo, kvStorage_);
+
+        Inode parent;
+        InodeParam parentParam = param_;
+        parentParam.type = FsFileType::TYPE_DIRECTORY;
+        EXPECT_EQ(MetaStatusCode::OK,
+                  partition.CreateInode(parentParam, &parent));
+
+        InodeParam param = param_;
+        param.parent = parent.inodeid();
+        uint64_t entries = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kFiles; ++i) {
+            std::string name = "file" + std::to_string(i);
+            Inode inode;
+            if (compound) {
+                replicate();
+                ++entries;
+                EXPECT_EQ(MetaStatusCode::OK,
+                          partition.CreateInodeAndDentry(param, name, 0, 0, 0,
+                                                         &inode));
+                continue;
+            }
+
+            replicate();
+            ++entries;
+            EXPECT_EQ(MetaStatusCode::OK, partition.CreateInode(param, &inode));
+            Dentry dentry;
+            dentry.set_fsid(1);
+            dentry.set_parentinodeid(parent.inodeid());
+            dentry.set_name(name);
+            dentry.set_inodeid(inode.inodeid());
+            dentry.set_txid(0);
+            dentry.set_type(FsFileType::TYPE_FILE);
+            replicate();
+            ++entries;
+            EXPECT_EQ(MetaStatusCode::OK, partition.CreateDentry(dentry));
+        }
+        auto elapsed = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+        EXPECT_EQ(kFiles + 1, partition.GetInodeNum());
+        EXPECT_EQ(kFiles, partition.GetDentryNum());
+        LOG(INFO) << (compound ? "CreateInodeAndDentry" : "CreateInode+Dentry")
+                  << ", raft log entries: " << entries
+                  << ", creates/s: " << kFiles / elapsed;
+        return kFiles / elapsed;
+    };
+
+    double separate = run(1, false);
+    double compound = run(2, true);
+    ASSERT_GT(compound, separate);
+}
+
+}  // namespace metaserver
+}  // namespace curvefs
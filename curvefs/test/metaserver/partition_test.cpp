@@ -24,6 +24,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+
 #include "curvefs/test/metaserver/test_helper.h"
 
 #include "curvefs/src/metaserver/dentry_manager.h"
@@ -275,6 +276,325 @@ TEST_F(PartitionTest, dentrynum) {
     ASSERT_EQ(partition1.GetDentryNum(), 0);
 }
 
+TEST_F(PartitionTest, DentryVersion) {
+    PartitionInfo partitionInfo1;
+    partitionInfo1.set_fsid(1);
+    partitionInfo1.set_poolid(2);
+    partitionInfo1.set_copysetid(3);
+    partitionInfo1.set_partitionid(4);
+    partitionInfo1.set_start(100);
+    partitionInfo1.set_end(199);
+
+    Partition partition1(partitionInfo1, kvStorage_);
+
+    // directory 100 and 101
+    Inode inode;
+    param_.type = FsFileType::TYPE_DIRECTORY;
+    ASSERT_EQ(partition1.CreateInode(param_, &inode), MetaStatusCode::OK);
+    ASSERT_EQ(inode.inodeid(), 100);
+    ASSERT_EQ(partition1.CreateInode(param_, &inode), MetaStatusCode::OK);
+    ASSERT_EQ(inode.inodeid(), 101);
+    InodeAttr attr;
+    ASSERT_EQ(partition1.GetInodeAttr(1, 100, &attr), MetaStatusCode::OK);
+    ASSERT_FALSE(attr.has_dentryversion());
+
+    // bumped by creating and deleting dentries
+    Dentry dentry;
+    dentry.set_fsid(1);
+    dentry.set_inodeid(110);
+    dentry.set_parentinodeid(100);
+    dentry.set_name("a");
+    dentry.set_txid(0);
+    dentry.set_type(FsFileType::TYPE_FILE);
+    ASSERT_EQ(partition1.CreateDentry(dentry), MetaStatusCode::OK);
+    ASSERT_EQ(partition1.GetInodeAttr(1, 100, &attr), MetaStatusCode::OK);
+    ASSERT_EQ(attr.dentryversion(), 1);
+    ASSERT_EQ(partition1.DeleteDentry(dentry), MetaStatusCode::OK);
+    ASSERT_EQ(partition1.GetInodeAttr(1, 100, &attr), MetaStatusCode::OK);
+    ASSERT_EQ(attr.dentryversion(), 2);
+
+    // unset while a rename transaction under the directory is pending
+    dentry.set_name("b");
+    dentry.set_txid(1);
+    ASSERT_EQ(partition1.HandleRenameTx({dentry}), MetaStatusCode::OK);
+    ASSERT_EQ(partition1.GetInodeAttr(1, 100, &attr), MetaStatusCode::OK);
+    ASSERT_FALSE(attr.has_dentryversion());
+
+    // bumped again once the transaction is done by the next one
+    Dentry other = dentry;
+    other.set_parentinodeid(101);
+    other.set_name("c");
+    other.set_txid(2);
+    ASSERT_EQ(partition1.HandleRenameTx({other}), MetaStatusCode::OK);
+    ASSERT_EQ(partition1.GetInodeAttr(1, 100, &attr), MetaStatusCode::OK);
+    ASSERT_EQ(attr.dentryversion(), 4);
+    ASSERT_EQ(partition1.GetInodeAttr(1, 101, &attr), MetaStatusCode::OK);
+    ASSERT_FALSE(attr.has_dentryversion());
+}
+
+TEST_F(PartitionTest, CreateInodeAndDentry) {
+    PartitionInfo partitionInfo1;
+    partitionInfo1.set_fsid(1);
+    partitionInfo1.set_poolid(2);
+    partitionInfo1.set_copysetid(3);
+    partitionInfo1.set_partitionid(4);
+    partitionInfo1.set_start(100);
+    partitionInfo1.set_end(102);
+
+    Partition partition1(partitionInfo1, kvStorage_);
+
+    // create parent inode
+    Inode parent;
+    InodeParam parentParam = param_;
+    parentParam.type = FsFileType::TYPE_DIRECTORY;
+    ASSERT_EQ(partition1.CreateInode(parentParam, &parent),
+              MetaStatusCode::OK);
+    ASSERT_EQ(parent.inodeid(), 100);
+
+    // parent not belongs to this partition
+    Inode inode;
+    param_.parent = 200;
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, 0, 0, &inode),
+              MetaStatusCode::PARTITION_ID_MISSMATCH);
+
+    param_.parent = 100;
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, 0, 0, &inode),
+              MetaStatusCode::OK);
+    ASSERT_EQ(inode.inodeid(), 101);
+    ASSERT_EQ(partition1.GetInodeNum(), 2);
+    ASSERT_EQ(partition1.GetDentryNum(), 1);
+
+    Dentry dentry;
+    dentry.set_fsid(1);
+    dentry.set_parentinodeid(100);
+    dentry.set_name("file");
+    dentry.set_txid(0);
+    ASSERT_EQ(partition1.GetDentry(&dentry), MetaStatusCode::OK);
+    ASSERT_EQ(dentry.inodeid(), 101);
+    ASSERT_EQ(dentry.type(), FsFileType::TYPE_FILE);
+
+    // dentry exist, no inode is created
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, 0, 0, &inode),
+              MetaStatusCode::DENTRY_EXIST);
+    ASSERT_EQ(partition1.GetInodeNum(), 2);
+    ASSERT_EQ(partition1.GetDentryNum(), 1);
+
+    // no inode id left in this partition
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file2", 0, 0, 0, &inode),
+              MetaStatusCode::PARTITION_ALLOC_ID_FAIL);
+    ASSERT_EQ(partition1.GetDentryNum(), 1);
+
+    partition1.SetStatus(PartitionStatus::DELETING);
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file2", 0, 0, 0, &inode),
+              MetaStatusCode::PARTITION_DELETING);
+}
+
+TEST_F(PartitionTest, CreateInodeAndDentryRetry) {
+    PartitionInfo partitionInfo1;
+    partitionInfo1.set_fsid(1);
+    partitionInfo1.set_poolid(2);
+    partitionInfo1.set_copysetid(3);
+    partitionInfo1.set_partitionid(4);
+    partitionInfo1.set_start(100);
+    partitionInfo1.set_end(200);
+
+    Partition partition1(partitionInfo1, kvStorage_);
+
+    Inode parent;
+    InodeParam parentParam = param_;
+    parentParam.type = FsFileType::TYPE_DIRECTORY;
+    ASSERT_EQ(partition1.CreateInode(parentParam, &parent),
+              MetaStatusCode::OK);
+
+    Inode inode;
+    param_.parent = parent.inodeid();
+    param_.timestamp = absl::make_optional<struct timespec>({100, 200});
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, 0, 0, &inode),
+              MetaStatusCode::OK);
+    uint64_t inodeId = inode.inodeid();
+    InodeAttr attr;
+    ASSERT_EQ(partition1.GetInodeAttr(1, parent.inodeid(), &attr),
+              MetaStatusCode::OK);
+    InodeAttr parentAttr = attr;
+
+    // retry of the applied request returns the inode created before
+    Inode retried;
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, 0, 0,
+                                              &retried),
+              MetaStatusCode::OK);
+    ASSERT_EQ(retried.inodeid(), inodeId);
+    ASSERT_EQ(partition1.GetInodeNum(), 2);
+    ASSERT_EQ(partition1.GetDentryNum(), 1);
+    ASSERT_EQ(partition1.GetInodeAttr(1, parent.inodeid(), &attr),
+              MetaStatusCode::OK);
+    ASSERT_EQ(attr.mtime(), parentAttr.mtime());
+    ASSERT_EQ(attr.mtime_ns(), parentAttr.mtime_ns());
+
+    // another request creating the same name
+    param_.timestamp = absl::make_optional<struct timespec>({100, 201});
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, 0, 0,
+                                              &retried),
+              MetaStatusCode::DENTRY_EXIST);
+    ASSERT_EQ(partition1.GetInodeNum(), 2);
+}
+
+TEST_F(PartitionTest, CreateInodeAndDentryWithLeasedId) {
+    PartitionInfo partitionInfo1;
+    partitionInfo1.set_fsid(1);
+    partitionInfo1.set_poolid(2);
+    partitionInfo1.set_copysetid(3);
+    partitionInfo1.set_partitionid(4);
+    partitionInfo1.set_start(100);
+    partitionInfo1.set_end(200);
+
+    Partition partition1(partitionInfo1, kvStorage_);
+
+    Inode parent;
+    InodeParam parentParam = param_;
+    parentParam.type = FsFileType::TYPE_DIRECTORY;
+    ASSERT_EQ(partition1.CreateInode(parentParam, &parent),
+              MetaStatusCode::OK);
+
+    InodeIdLease lease;
+    ASSERT_EQ(partition1.AllocInodeIds(1, 4, 1000, 0, &lease),
+              MetaStatusCode::OK);
+    uint64_t leaseId = lease.leaseid();
+    uint64_t inodeId = lease.start() + 2;
+
+    Inode inode;
+    param_.parent = parent.inodeid();
+    param_.timestamp = absl::make_optional<struct timespec>({100, 200});
+
+    // not leased
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, inodeId,
+                                              leaseId + 1, &inode),
+              MetaStatusCode::INODE_ID_NOT_LEASED);
+    // not in this partition
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, 200,
+                                              leaseId, &inode),
+              MetaStatusCode::PARTITION_ID_MISSMATCH);
+    ASSERT_EQ(partition1.GetDentryNum(), 0);
+
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, inodeId,
+                                              leaseId, &inode),
+              MetaStatusCode::OK);
+    ASSERT_EQ(inode.inodeid(), inodeId);
+    ASSERT_EQ(partition1.GetInodeNum(), 2);
+    ASSERT_EQ(partition1.GetDentryNum(), 1);
+
+    Dentry dentry;
+    dentry.set_fsid(1);
+    dentry.set_parentinodeid(parent.inodeid());
+    dentry.set_name("file");
+    dentry.set_txid(0);
+    ASSERT_EQ(partition1.GetDentry(&dentry), MetaStatusCode::OK);
+    ASSERT_EQ(dentry.inodeid(), inodeId);
+
+    // retry of the applied request
+    Inode retried;
+    ASSERT_EQ(partition1.CreateInodeAndDentry(param_, "file", 0, inodeId,
+                                              leaseId, &retried),
+              MetaStatusCode::OK);
+    ASSERT_EQ(retried.inodeid(), inodeId);
+    ASSERT_EQ(partition1.GetInodeNum(), 2);
+}
+
+TEST_F(PartitionTest, AllocInodeIds) {
+    PartitionInfo partitionInfo1;
+    partitionInfo1.set_fsid(1);
+    partitionInfo1.set_poolid(2);
+    partitionInfo1.set_copysetid(3);
+    partitionInfo1.set_partitionid(4);
+    partitionInfo1.set_start(100);
+    partitionInfo1.set_end(109);
+
+    Partition partition1(partitionInfo1, kvStorage_);
+
+    InodeIdLease lease;
+    ASSERT_EQ(partition1.AllocInodeIds(2, 4, 1000, 0, &lease),
+              MetaStatusCode::PARTITION_ID_MISSMATCH);
+    ASSERT_EQ(partition1.AllocInodeIds(1, 0, 1000, 0, &lease),
+              MetaStatusCode::PARAM_ERROR);
+
+    // lease [100, 104)
+    ASSERT_EQ(partition1.AllocInodeIds(1, 4, 1000, 0, &lease),
+              MetaStatusCode::OK);
+    ASSERT_EQ(lease.start(), 100);
+    ASSERT_EQ(lease.end(), 104);
+    ASSERT_EQ(lease.expiretimems(), 1000);
+    uint64_t leaseId = lease.leaseid();
+    ASSERT_NE(leaseId, 0);
+
+    // ids allocated by partition skip the leased ones
+    Inode inode;
+    ASSERT_EQ(partition1.CreateInode(param_, &inode), MetaStatusCode::OK);
+    ASSERT_EQ(inode.inodeid(), 104);
+
+    // leased ids can be used out of order
+    param_.timestamp = absl::make_optional<struct timespec>({100, 200});
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(102, leaseId, param_, &inode),
+              MetaStatusCode::OK);
+    ASSERT_EQ(inode.inodeid(), 102);
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(101, leaseId, param_, &inode),
+              MetaStatusCode::OK);
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(105, leaseId, param_, &inode),
+              MetaStatusCode::INODE_ID_NOT_LEASED);
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(200, leaseId, param_, &inode),
+              MetaStatusCode::PARTITION_ID_MISSMATCH);
+
+    // a retry gets the inode created before, while another request with
+    // the same id fails
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(101, leaseId, param_, &inode),
+              MetaStatusCode::OK);
+    ASSERT_EQ(inode.inodeid(), 101);
+    InodeParam other = param_;
+    other.timestamp = absl::make_optional<struct timespec>({100, 201});
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(101, leaseId, other, &inode),
+              MetaStatusCode::INODE_EXIST);
+
+    // ids can only be used by the holder of the lease
+    ASSERT_EQ(
+        partition1.CreateInodeWithLeasedId(100, leaseId + 1, param_, &inode),
+        MetaStatusCode::INODE_ID_NOT_LEASED);
+
+    // the expired lease is reclaimed, only ids after the largest used one
+    // are leased again, with another lease id
+    ASSERT_EQ(partition1.AllocInodeIds(1, 10, 1000, 2000, &lease),
+              MetaStatusCode::OK);
+    ASSERT_EQ(lease.start(), 103);
+    ASSERT_EQ(lease.end(), 104);
+    ASSERT_NE(lease.leaseid(), leaseId);
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(100, leaseId, param_, &inode),
+              MetaStatusCode::INODE_ID_NOT_LEASED);
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(103, leaseId, param_, &inode),
+              MetaStatusCode::INODE_ID_NOT_LEASED);
+
+    // a retry still gets the inode after the lease is reclaimed
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(102, leaseId, param_, &inode),
+              MetaStatusCode::OK);
+    ASSERT_EQ(inode.inodeid(), 102);
+    leaseId = lease.leaseid();
+
+    // at most ids left in partition are leased
+    ASSERT_EQ(partition1.AllocInodeIds(1, 10, 1000, 2000, &lease),
+              MetaStatusCode::OK);
+    ASSERT_EQ(lease.start(), 105);
+    ASSERT_EQ(lease.end(), 110);
+    ASSERT_EQ(partition1.AllocInodeIds(1, 10, 1000, 2000, &lease),
+              MetaStatusCode::PARTITION_ALLOC_ID_FAIL);
+    ASSERT_EQ(partition1.GetStatus(), PartitionStatus::READONLY);
+
+    // leased ids are still usable after partition is readonly, and the
+    // lease is removed once all ids are used
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(103, leaseId, param_, &inode),
+              MetaStatusCode::OK);
+    ASSERT_EQ(partition1.CreateInodeWithLeasedId(109, lease.leaseid(),
+                                                 param_, &inode),
+              MetaStatusCode::OK);
+    ASSERT_EQ(partition1.GetPartitionInfo().inodeidleases_size(), 0);
+    ASSERT_EQ(partition1.GetPartitionInfo().freeinodeids_size(), 0);
+}
+
 TEST_F(PartitionTest, PARTITION_ID_MISSMATCH_ERROR) {
     PartitionInfo partitionInfo1;
     partitionInfo1.set_fsid(1);
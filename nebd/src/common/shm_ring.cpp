@@ -0,0 +1,374 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#include "nebd/src/common/shm_ring.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace nebd {
+namespace common {
+
+namespace {
+
+constexpr uint32_t kShmRingMagic = 0x4e524e47;  // "NRNG"
+constexpr uint32_t kShmRingVersion = 1;
+constexpr size_t kCacheLineSize = 64;
+constexpr size_t kPageSize = 4096;
+
+size_t AlignUp(size_t value, size_t align) {
+    return (value + align - 1) / align * align;
+}
+
+bool ValidOption(uint32_t depth, uint32_t slotSize) {
+    return depth != 0 && (depth & (depth - 1)) == 0 && slotSize != 0;
+}
+
+int FutexWait(std::atomic<uint32_t>* addr, uint32_t expected,
+              int timeoutMs) {
+    struct timespec ts;
+    ts.tv_sec = timeoutMs / 1000;
+    ts.tv_nsec = (timeoutMs % 1000) * 1000000L;
+    // 共享内存跨进程使用，不能使用FUTEX_PRIVATE_FLAG
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT,
+                   expected, &ts, nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>* addr) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE,
+            INT32_MAX, nullptr, nullptr, 0);
+}
+
+// 单个队列的游标，head和tail分别独占一个cache line，避免两端伪共享
+struct ShmRingIndex {
+    std::atomic<uint32_t> head;
+    char pad0[kCacheLineSize - sizeof(std::atomic<uint32_t>)];
+    std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> waiting;
+    char pad1[kCacheLineSize - 2 * sizeof(std::atomic<uint32_t>)];
+};
+
+template <typename Entry>
+bool Push(ShmRingIndex* index, Entry* entries, uint32_t mask,
+          const Entry& entry) {
+    uint32_t tail = index->tail.load(std::memory_order_relaxed);
+    uint32_t head = index->head.load(std::memory_order_acquire);
+    if (tail - head > mask) {
+        return false;
+    }
+
+    entries[tail & mask] = entry;
+    // 与消费者中waiting的写入和tail的读取构成Dekker同步，
+    // 保证消费者要么看到新的tail，要么生产者看到waiting
+    index->tail.store(tail + 1, std::memory_order_seq_cst);
+    if (index->waiting.load(std::memory_order_seq_cst) != 0) {
+        FutexWake(&index->tail);
+    }
+    return true;
+}
+
+template <typename Entry>
+bool Pop(ShmRingIndex* index, Entry* entries, uint32_t mask, Entry* entry) {
+    uint32_t head = index->head.load(std::memory_order_relaxed);
+    uint32_t tail = index->tail.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+
+    *entry = entries[head & mask];
+    index->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool Wait(ShmRingIndex* index, int timeoutMs) {
+    uint32_t head = index->head.load(std::memory_order_relaxed);
+    uint32_t tail = index->tail.load(std::memory_order_acquire);
+    if (head != tail) {
+        return true;
+    }
+
+    index->waiting.store(1, std::memory_order_seq_cst);
+    tail = index->tail.load(std::memory_order_seq_cst);
+    if (head == tail) {
+        FutexWait(&index->tail, tail, timeoutMs);
+    }
+    index->waiting.store(0, std::memory_order_relaxed);
+
+    return head != index->tail.load(std::memory_order_acquire);
+}
+
+}  // namespace
+
+struct ShmRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t depth;
+    uint32_t slotSize;
+    uint64_t sqOffset;
+    uint64_t cqOffset;
+    uint64_t arenaOffset;
+    int32_t clientPid;
+    std::atomic<int32_t> serverPid;
+    char pad[kCacheLineSize - 6 * sizeof(uint64_t)];
+
+    ShmRingIndex sq;
+    ShmRingIndex cq;
+};
+
+namespace {
+
+// 各段在共享内存中的偏移，只由depth决定
+struct ShmRingLayout {
+    explicit ShmRingLayout(uint32_t depth) {
+        sqOffset = AlignUp(sizeof(ShmRingHeader), kCacheLineSize);
+        cqOffset = sqOffset +
+            AlignUp(sizeof(ShmRingSqe) * depth, kCacheLineSize);
+        arenaOffset = AlignUp(cqOffset +
+            AlignUp(sizeof(ShmRingCqe) * depth, kCacheLineSize), kPageSize);
+    }
+
+    uint64_t sqOffset;
+    uint64_t cqOffset;
+    uint64_t arenaOffset;
+};
+
+}  // namespace
+
+ShmRing::~ShmRing() {
+    Detach();
+}
+
+size_t ShmRing::ComputeSize(uint32_t depth, uint32_t slotSize) {
+    ShmRingLayout layout(depth);
+    return layout.arenaOffset + static_cast<size_t>(depth) * slotSize;
+}
+
+int ShmRing::Create(const std::string& name, uint32_t depth,
+                    uint32_t slotSize) {
+    if (!ValidOption(depth, slotSize)) {
+        LOG(ERROR) << "Invalid shm ring option, depth: " << depth
+                   << ", slot size: " << slotSize;
+        return -1;
+    }
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        LOG(ERROR) << "shm_open " << name << " failed, errno: " << errno;
+        return -1;
+    }
+
+    size_t size = ComputeSize(depth, slotSize);
+    name_ = name;
+    if (!Map(fd, size, true)) {
+        close(fd);
+        Unlink();
+        return -1;
+    }
+    close(fd);
+
+    ShmRingLayout layout(depth);
+    header_->depth = depth;
+    header_->slotSize = slotSize;
+    header_->sqOffset = layout.sqOffset;
+    header_->cqOffset = layout.cqOffset;
+    header_->arenaOffset = layout.arenaOffset;
+    header_->clientPid = getpid();
+    header_->serverPid.store(0, std::memory_order_relaxed);
+    header_->version = kShmRingVersion;
+    // magic最后写入，part2据此判断ring是否初始化完成
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kShmRingMagic;
+
+    SetLayout(depth, slotSize);
+    clientPid_ = getpid();
+    return 0;
+}
+
+int ShmRing::Attach(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        LOG(ERROR) << "shm_open " << name << " failed, errno: " << errno;
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(ShmRingHeader)) {
+        LOG(ERROR) << "Invalid shm ring " << name;
+        close(fd);
+        return -1;
+    }
+
+    name_ = name;
+    bool ok = Map(fd, st.st_size, false);
+    close(fd);
+    if (!ok) {
+        return -1;
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // header由part1写入，只读取一次并校验，之后使用缓存的值
+    uint32_t magic = header_->magic;
+    uint32_t version = header_->version;
+    uint32_t depth = header_->depth;
+    uint32_t slotSize = header_->slotSize;
+    uint64_t sqOffset = header_->sqOffset;
+    uint64_t cqOffset = header_->cqOffset;
+    uint64_t arenaOffset = header_->arenaOffset;
+    pid_t clientPid = header_->clientPid;
+    ShmRingLayout layout(depth);
+    if (magic != kShmRingMagic || version != kShmRingVersion ||
+        !ValidOption(depth, slotSize) ||
+        ComputeSize(depth, slotSize) != size_ ||
+        sqOffset != layout.sqOffset || cqOffset != layout.cqOffset ||
+        arenaOffset != layout.arenaOffset) {
+        LOG(ERROR) << "Shm ring " << name << " header mismatch, magic: "
+                   << magic << ", version: " << version
+                   << ", depth: " << depth << ", slot size: " << slotSize
+                   << ", sq offset: " << sqOffset
+                   << ", cq offset: " << cqOffset
+                   << ", arena offset: " << arenaOffset
+                   << ", size: " << size_;
+        Detach();
+        return -1;
+    }
+
+    SetLayout(depth, slotSize);
+    clientPid_ = clientPid;
+    return 0;
+}
+
+void ShmRing::SetLayout(uint32_t depth, uint32_t slotSize) {
+    ShmRingLayout layout(depth);
+    char* base = static_cast<char*>(addr_);
+    depth_ = depth;
+    slotSize_ = slotSize;
+    sq_ = reinterpret_cast<ShmRingSqe*>(base + layout.sqOffset);
+    cq_ = reinterpret_cast<ShmRingCqe*>(base + layout.cqOffset);
+    arena_ = base + layout.arenaOffset;
+}
+
+bool ShmRing::Map(int fd, size_t size, bool create) {
+    if (create && ftruncate(fd, size) != 0) {
+        LOG(ERROR) << "ftruncate shm ring " << name_
+                   << " failed, errno: " << errno;
+        return false;
+    }
+
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    if (addr == MAP_FAILED) {
+        LOG(ERROR) << "mmap shm ring " << name_
+                   << " failed, errno: " << errno;
+        return false;
+    }
+
+    addr_ = addr;
+    size_ = size;
+    header_ = static_cast<ShmRingHeader*>(addr);
+    return true;
+}
+
+void ShmRing::Unlink() {
+    if (!name_.empty()) {
+        shm_unlink(name_.c_str());
+    }
+}
+
+void ShmRing::Detach() {
+    if (addr_ != nullptr) {
+        munmap(addr_, size_);
+        addr_ = nullptr;
+        size_ = 0;
+        header_ = nullptr;
+        depth_ = 0;
+        slotSize_ = 0;
+        clientPid_ = 0;
+        sq_ = nullptr;
+        cq_ = nullptr;
+        arena_ = nullptr;
+    }
+}
+
+bool ShmRing::PushSqe(const ShmRingSqe& sqe) {
+    return Push(&header_->sq, sq_, depth_ - 1, sqe);
+}
+
+bool ShmRing::PopSqe(ShmRingSqe* sqe) {
+    return Pop(&header_->sq, sq_, depth_ - 1, sqe);
+}
+
+bool ShmRing::PushCqe(const ShmRingCqe& cqe) {
+    return Push(&header_->cq, cq_, depth_ - 1, cqe);
+}
+
+bool ShmRing::PopCqe(ShmRingCqe* cqe) {
+    return Pop(&header_->cq, cq_, depth_ - 1, cqe);
+}
+
+bool ShmRing::WaitSqe(int timeoutMs) {
+    return Wait(&header_->sq, timeoutMs);
+}
+
+bool ShmRing::WaitCqe(int timeoutMs) {
+    return Wait(&header_->cq, timeoutMs);
+}
+
+void ShmRing::Wakeup() {
+    FutexWake(&header_->sq.tail);
+    FutexWake(&header_->cq.tail);
+}
+
+char* ShmRing::SlotBuffer(uint32_t tag) const {
+    return arena_ + static_cast<size_t>(tag) * slotSize_;
+}
+
+uint32_t ShmRing::Depth() const {
+    return depth_;
+}
+
+uint32_t ShmRing::SlotSize() const {
+    return slotSize_;
+}
+
+pid_t ShmRing::ClientPid() const {
+    return clientPid_;
+}
+
+pid_t ShmRing::ServerPid() const {
+    return header_->serverPid.load(std::memory_order_acquire);
+}
+
+void ShmRing::SetServerPid(pid_t pid) {
+    header_->serverPid.store(pid, std::memory_order_release);
+}
+
+}  // namespace common
+}  // namespace nebd
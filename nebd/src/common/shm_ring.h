@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#ifndef NEBD_SRC_COMMON_SHM_RING_H_
+#define NEBD_SRC_COMMON_SHM_RING_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "nebd/src/common/uncopyable.h"
+
+namespace nebd {
+namespace common {
+
+// 共享内存ring中的请求类型
+enum class ShmRingOp : uint32_t {
+    kRead = 0,
+    kWrite = 1,
+};
+
+// submission queue entry，由part1生产、part2消费
+// tag即请求占用的arena slot下标，完成时原样带回
+struct ShmRingSqe {
+    uint32_t op;
+    uint32_t tag;
+    uint64_t offset;
+    uint64_t length;
+};
+
+// completion queue entry，由part2生产、part1消费
+struct ShmRingCqe {
+    uint32_t tag;
+    int32_t ret;
+};
+
+// cqe中ret的取值
+constexpr int32_t kShmRingRetOk = 0;
+// io失败，part1直接返回错误
+constexpr int32_t kShmRingRetError = -1;
+// io失败但part2不向part1返回io错误，由part1通过rpc重新提交
+constexpr int32_t kShmRingRetResubmit = -2;
+
+// part2无法继续处理ring时写入的server pid，part1据此将在途请求转交给rpc
+constexpr pid_t kShmRingServerBroken = -1;
+
+struct ShmRingHeader;
+
+/**
+ * part1与part2之间基于共享内存的提交/完成队列
+ *
+ * 共享内存布局：| header | sq entries | cq entries | arena |
+ * arena被切分为depth个大小为slotSize的slot，第i个请求槽位的数据
+ * 固定放在第i个slot中，因此sq/cq中只需要传递slot下标。
+ * 由于同一时刻最多只有depth个请求在途，sq/cq永远不会溢出。
+ *
+ * sq和cq都是单生产者单消费者队列，多线程生产时需要调用方加锁。
+ * 消费者在队列为空时通过futex睡眠在对应的tail上，生产者仅在对端
+ * 处于等待状态时才会发起唤醒的系统调用。
+ */
+class ShmRing : public Uncopyable {
+ public:
+    ShmRing() = default;
+    ~ShmRing();
+
+    /**
+     * @brief 计算指定深度和slot大小的共享内存总大小
+     */
+    static size_t ComputeSize(uint32_t depth, uint32_t slotSize);
+
+    /**
+     * @brief 创建并初始化共享内存，由part1调用
+     * @param name: 共享内存名称，需以'/'开头
+     * @param depth: 队列深度，必须是2的幂
+     * @param slotSize: 每个slot的大小
+     * @return 成功返回0，失败返回-1
+     */
+    int Create(const std::string& name, uint32_t depth, uint32_t slotSize);
+
+    /**
+     * @brief 映射part1创建的共享内存，由part2调用
+     *        header中的队列深度、slot大小、各段偏移和part1的pid
+     *        在映射时校验并缓存，之后不再读取，避免part1修改header
+     *        导致越界访问
+     * @return 成功返回0，失败返回-1
+     */
+    int Attach(const std::string& name);
+
+    /**
+     * @brief 删除共享内存名称，已有的映射不受影响
+     */
+    void Unlink();
+
+    /**
+     * @brief 解除映射
+     */
+    void Detach();
+
+    bool PushSqe(const ShmRingSqe& sqe);
+    bool PopSqe(ShmRingSqe* sqe);
+    bool PushCqe(const ShmRingCqe& cqe);
+    bool PopCqe(ShmRingCqe* cqe);
+
+    /**
+     * @brief 等待sq/cq非空
+     * @param timeoutMs: 最长等待时间
+     * @return 队列非空返回true，超时或被Wakeup唤醒返回false
+     */
+    bool WaitSqe(int timeoutMs);
+    bool WaitCqe(int timeoutMs);
+
+    /**
+     * @brief 唤醒所有等待者，用于停止消费线程
+     */
+    void Wakeup();
+
+    char* SlotBuffer(uint32_t tag) const;
+
+    uint32_t Depth() const;
+    uint32_t SlotSize() const;
+
+    pid_t ClientPid() const;
+    pid_t ServerPid() const;
+    void SetServerPid(pid_t pid);
+
+    const std::string& Name() const {
+        return name_;
+    }
+
+ private:
+    bool Map(int fd, size_t size, bool create);
+
+    void SetLayout(uint32_t depth, uint32_t slotSize);
+
+ private:
+    std::string name_;
+    void* addr_ = nullptr;
+    size_t size_ = 0;
+
+    ShmRingHeader* header_ = nullptr;
+    uint32_t depth_ = 0;
+    uint32_t slotSize_ = 0;
+    pid_t clientPid_ = 0;
+    ShmRingSqe* sq_ = nullptr;
+    ShmRingCqe* cq_ = nullptr;
+    char* arena_ = nullptr;
+};
+
+}  // namespace common
+}  // namespace nebd
+
+#endif  // NEBD_SRC_COMMON_SHM_RING_H_
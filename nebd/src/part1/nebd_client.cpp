@@ -29,6 +29,7 @@
 #include <glog/logging.h>
 #include <gflags/gflags.h>
 #include <bthread/bthread.h>
+#include <butil/time.h>
 #include <string>
 
 #include "nebd/src/part1/async_request_closure.h"
@@ -134,6 +135,15 @@ void NebdClient::Uninit() {
         bthread::execution_queue_join(q);
     }
 
+    std::unordered_map<int, std::shared_ptr<ShmRingClient>> rings;
+    {
+        nebd::common::WriteLockGuard guard(ringLock_);
+        rings.swap(rings_);
+    }
+    for (auto& ring : rings) {
+        ring.second->Stop();
+    }
+
     LOG(INFO) << "NebdClient uninit success.";
     google::ShutdownGoogleLogging();
 }
@@ -150,6 +160,17 @@ int NebdClient::Open(const char* filename, const NebdOpenFlags* flags) {
         return -1;
     }
 
+    // 创建共享内存ring，part2 attach失败时读写仍走rpc
+    std::shared_ptr<ShmRingClient> ring;
+    if (option_.ringOption.enable) {
+        ring = std::make_shared<ShmRingClient>();
+        if (ring->Init(option_.ringOption) != 0) {
+            LOG(WARNING) << "Init shm ring failed, filename = " << filename;
+            ring.reset();
+        }
+    }
+    bool shmAttached = false;
+
     auto task = [&](brpc::Controller* cntl,
                     brpc::Channel* channel,
                     bool* rpcFailed) -> int64_t {
@@ -164,6 +185,10 @@ int NebdClient::Open(const char* filename, const NebdOpenFlags* flags) {
             *p = ConverToProtoOpenFlags(flags);
         }
 
+        if (ring != nullptr) {
+            request.set_shmname(ring->Name());
+        }
+
         stub.OpenFile(cntl, &request, &response, nullptr);
 
         *rpcFailed = cntl->Failed();
@@ -183,6 +208,7 @@ int NebdClient::Open(const char* filename, const NebdOpenFlags* flags) {
                 return -1;
             }
 
+            shmAttached = response.shmattached();
             return response.fd();
         }
     };
@@ -194,11 +220,27 @@ int NebdClient::Open(const char* filename, const NebdOpenFlags* flags) {
         return -1;
     }
 
+    if (ring != nullptr && shmAttached) {
+        ring->Start([this, fd](NebdClientAioContext* aioctx) {
+            ResubmitByRpc(fd, aioctx);
+        });
+        nebd::common::WriteLockGuard guard(ringLock_);
+        rings_[fd] = ring;
+    } else if (ring != nullptr) {
+        LOG(WARNING) << "nebd-server does not attach shm ring, "
+                     << "fall back to rpc, filename = " << filename;
+    }
+
     metaCache_->AddFileInfo({fd, filename, fileLock});
     return fd;
 }
 
 int NebdClient::Close(int fd) {
+    auto ring = RemoveShmRing(fd);
+    if (ring != nullptr) {
+        ring->Stop();
+    }
+
     auto task = [&](brpc::Controller* cntl,
                     brpc::Channel* channel,
                     bool* rpcFailed) -> int64_t {
@@ -340,6 +382,15 @@ int NebdClient::Discard(int fd, NebdClientAioContext* aioctx) {
 }
 
 int NebdClient::AioRead(int fd, NebdClientAioContext* aioctx) {
+    if (SubmitByShmRing(fd, aioctx)) {
+        return 0;
+    }
+
+    AioReadByRpc(fd, aioctx);
+    return 0;
+}
+
+void NebdClient::AioReadByRpc(int fd, NebdClientAioContext* aioctx) {
     auto task = [this, fd, aioctx]() {
         nebd::client::NebdFileService_Stub stub(&channel_);
         nebd::client::ReadRequest request;
@@ -355,13 +406,20 @@ int NebdClient::AioRead(int fd, NebdClientAioContext* aioctx) {
     };
 
     PushAsyncTask(task);
-
-    return 0;
 }
 
 static void EmptyDeleter(void* m) {}
 
 int NebdClient::AioWrite(int fd, NebdClientAioContext* aioctx) {
+    if (SubmitByShmRing(fd, aioctx)) {
+        return 0;
+    }
+
+    AioWriteByRpc(fd, aioctx);
+    return 0;
+}
+
+void NebdClient::AioWriteByRpc(int fd, NebdClientAioContext* aioctx) {
     auto task = [this, fd, aioctx]() {
         nebd::client::NebdFileService_Stub stub(&channel_);
         nebd::client::WriteRequest request;
@@ -380,8 +438,34 @@ int NebdClient::AioWrite(int fd, NebdClientAioContext* aioctx) {
     };
 
     PushAsyncTask(task);
+}
 
-    return 0;
+void NebdClient::ResubmitByRpc(int fd, NebdClientAioContext* aioctx) {
+    // 只走rpc，不再经过ring，避免part2持续要求重提时在ring上空转；
+    // 与rpc失败的重试一样，间隔rpcRetryIntervalUs后再提交
+    AsyncRpcTask* task = new AsyncRpcTask([this, fd, aioctx]() {
+        if (aioctx->op == LIBAIO_OP::LIBAIO_OP_READ) {
+            AioReadByRpc(fd, aioctx);
+        } else {
+            AioWriteByRpc(fd, aioctx);
+        }
+    });
+
+    bthread_timer_t timerId;
+    int ret = bthread_timer_add(
+        &timerId,
+        butil::microseconds_from_now(option_.requestOption.rpcRetryIntervalUs),
+        &NebdClient::RunResubmitTask, task);
+    if (ret != 0) {
+        LOG(WARNING) << "bthread_timer_add failed, resubmit immediately, "
+                     << "ret = " << ret;
+        RunResubmitTask(task);
+    }
+}
+
+void NebdClient::RunResubmitTask(void* arg) {
+    std::unique_ptr<AsyncRpcTask> task(static_cast<AsyncRpcTask*>(arg));
+    (*task)();
 }
 
 int NebdClient::Flush(int fd, NebdClientAioContext* aioctx) {
@@ -531,6 +615,21 @@ int NebdClient::InitNebdClientOption(Configuration* conf) {
 
     option_.requestOption = requestOption;
 
+    ret = conf->GetBoolValue("ring.enable", &option_.ringOption.enable);
+    LOG_IF(WARNING, ret != true)
+        << "Load ring.enable failed, use default value "
+        << option_.ringOption.enable;
+
+    ret = conf->GetUInt32Value("ring.depth", &option_.ringOption.depth);
+    LOG_IF(WARNING, ret != true)
+        << "Load ring.depth failed, use default value "
+        << option_.ringOption.depth;
+
+    ret = conf->GetUInt32Value("ring.slotSize", &option_.ringOption.slotSize);
+    LOG_IF(WARNING, ret != true)
+        << "Load ring.slotSize failed, use default value "
+        << option_.ringOption.slotSize;
+
     ret = conf->GetStringValue("log.path", &option_.logOption.logPath);
     LOG_IF(ERROR, ret != true) << "Load log.path failed";
     RETURN_IF_FALSE(ret);
@@ -634,5 +733,31 @@ int NebdClient::ExecAsyncRpcTask(void* meta,
     return 0;
 }
 
+bool NebdClient::SubmitByShmRing(int fd, NebdClientAioContext* aioctx) {
+    std::shared_ptr<ShmRingClient> ring;
+    {
+        nebd::common::ReadLockGuard guard(ringLock_);
+        auto iter = rings_.find(fd);
+        if (iter == rings_.end()) {
+            return false;
+        }
+        ring = iter->second;
+    }
+
+    return ring->Submit(aioctx);
+}
+
+std::shared_ptr<ShmRingClient> NebdClient::RemoveShmRing(int fd) {
+    nebd::common::WriteLockGuard guard(ringLock_);
+    auto iter = rings_.find(fd);
+    if (iter == rings_.end()) {
+        return nullptr;
+    }
+
+    auto ring = iter->second;
+    rings_.erase(iter);
+    return ring;
+}
+
 }  // namespace client
 }  // namespace nebd
@@ -29,6 +29,7 @@
 #include <functional>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "nebd/src/part1/nebd_common.h"
@@ -37,6 +38,8 @@
 #include "nebd/src/part1/libnebd.h"
 #include "nebd/src/part1/heartbeat_manager.h"
 #include "nebd/src/part1/nebd_metacache.h"
+#include "nebd/src/part1/shm_ring_client.h"
+#include "nebd/src/common/rw_lock.h"
 
 #include "include/curve_compiler_specific.h"
 
@@ -165,6 +168,27 @@ class NebdClient {
     std::string ReplaceSlash(const std::string& str);
 
     int64_t ExecuteSyncRpc(RpcTask task);
+
+    /**
+     * @brief 尝试通过共享内存ring提交读写请求
+     * @return 提交成功返回true，否则返回false，由调用方走rpc
+     */
+    bool SubmitByShmRing(int fd, NebdClientAioContext* aioctx);
+
+    std::shared_ptr<ShmRingClient> RemoveShmRing(int fd);
+
+    // 只通过rpc提交读写请求
+    void AioReadByRpc(int fd, NebdClientAioContext* aioctx);
+    void AioWriteByRpc(int fd, NebdClientAioContext* aioctx);
+
+    /**
+     * @brief ring的fallback，part2要求重提或者ring失效时调用，
+     *        间隔rpcRetryIntervalUs后通过rpc重新提交请求
+     */
+    void ResubmitByRpc(int fd, NebdClientAioContext* aioctx);
+
+    static void RunResubmitTask(void* arg);
+
     // 心跳管理模块
     std::shared_ptr<HeartbeatManager> heartbeatMgr_;
     // 缓存模块
@@ -176,6 +200,10 @@ class NebdClient {
 
     std::atomic<uint64_t> logId_{1};
 
+    // fd到共享内存ring的映射
+    nebd::common::RWLock ringLock_;
+    std::unordered_map<int, std::shared_ptr<ShmRingClient>> rings_;
+
  private:
     using AsyncRpcTask = std::function<void()>;
 
@@ -49,6 +49,16 @@ struct LogOption {
     std::string logPath;
 };
 
+// 共享内存ring配置项
+struct RingOption {
+    // 是否在open时与part2协商共享内存ring
+    bool enable = false;
+    // ring的深度，必须是2的幂
+    uint32_t depth = 64;
+    // 每个slot的大小，超过该大小的请求仍走rpc
+    uint32_t slotSize = 128 * 1024;
+};
+
 // nebd client配置项
 struct NebdClientOption {
     // part2 socket file address
@@ -59,6 +69,8 @@ struct NebdClientOption {
     RequestOption requestOption;
     // 日志配置项
     LogOption logOption;
+    // 共享内存ring配置项
+    RingOption ringOption;
 };
 
 // heartbeat配置项
@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#include "nebd/src/part1/shm_ring_client.h"
+
+#include <glog/logging.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "nebd/src/part1/async_request_closure.h"
+
+namespace nebd {
+namespace client {
+
+using nebd::common::kShmRingRetResubmit;
+using nebd::common::kShmRingServerBroken;
+using nebd::common::ShmRingCqe;
+using nebd::common::ShmRingOp;
+using nebd::common::ShmRingSqe;
+
+// 完成线程等待的超时时间，超时后检查part2是否存活
+constexpr int kRingWaitTimeoutMs = 1000;
+
+ShmRingClient::~ShmRingClient() {
+    Stop();
+}
+
+int ShmRingClient::Init(const RingOption& option) {
+    static std::atomic<uint32_t> counter{0};
+    std::string name = "/nebd-ring-" + std::to_string(getpid()) + "-" +
+        std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+
+    if (ring_.Create(name, option.depth, option.slotSize) != 0) {
+        LOG(ERROR) << "Create shm ring failed, name = " << name;
+        return -1;
+    }
+
+    freeTags_.reserve(option.depth);
+    for (uint32_t i = option.depth; i > 0; --i) {
+        freeTags_.push_back(i - 1);
+    }
+    inflight_.assign(option.depth, nullptr);
+    return 0;
+}
+
+void ShmRingClient::Start(const RingFallback& fallback) {
+    // part2已经完成映射，名称不再需要，避免进程退出后残留
+    ring_.Unlink();
+
+    fallback_ = fallback;
+    running_.store(true, std::memory_order_release);
+    completionThread_ =
+        std::thread(&ShmRingClient::CompletionThreadFunc, this);
+    LOG(INFO) << "Shm ring started, name = " << ring_.Name()
+              << ", server pid = " << ring_.ServerPid();
+}
+
+void ShmRingClient::Stop() {
+    if (completionThread_.joinable()) {
+        running_.store(false, std::memory_order_release);
+        ring_.Wakeup();
+        completionThread_.join();
+        // 正常情况下close之前请求都已返回
+        Break();
+    } else {
+        // 未启动时名称仍存在，需要删除
+        ring_.Unlink();
+    }
+    ring_.Detach();
+}
+
+bool ShmRingClient::Submit(NebdClientAioContext* aioctx) {
+    if (aioctx->op != LIBAIO_OP::LIBAIO_OP_READ &&
+        aioctx->op != LIBAIO_OP::LIBAIO_OP_WRITE) {
+        return false;
+    }
+    if (aioctx->length > ring_.SlotSize()) {
+        return false;
+    }
+
+    uint32_t tag = 0;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (broken_.load(std::memory_order_relaxed) || freeTags_.empty()) {
+            return false;
+        }
+        tag = freeTags_.back();
+        freeTags_.pop_back();
+    }
+
+    // 拷贝数据时不持锁，避免阻塞其他提交者和完成线程
+    if (aioctx->op == LIBAIO_OP::LIBAIO_OP_WRITE) {
+        memcpy(ring_.SlotBuffer(tag), aioctx->buf, aioctx->length);
+    }
+
+    ShmRingSqe sqe;
+    sqe.op = static_cast<uint32_t>(aioctx->op == LIBAIO_OP::LIBAIO_OP_READ
+                                       ? ShmRingOp::kRead
+                                       : ShmRingOp::kWrite);
+    sqe.tag = tag;
+    sqe.offset = aioctx->offset;
+    sqe.length = aioctx->length;
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (broken_.load(std::memory_order_relaxed)) {
+        freeTags_.push_back(tag);
+        return false;
+    }
+    inflight_[tag] = aioctx;
+    // 在途请求数不超过depth，sq不会满
+    CHECK(ring_.PushSqe(sqe));
+    return true;
+}
+
+void ShmRingClient::CompletionThreadFunc() {
+    ShmRingCqe cqe;
+    while (running_.load(std::memory_order_acquire)) {
+        if (!ring_.WaitCqe(kRingWaitTimeoutMs)) {
+            if (!ServerAlive()) {
+                LOG(WARNING) << "nebd-server " << ring_.ServerPid()
+                             << " exited or stopped, shm ring "
+                             << ring_.Name()
+                             << " falls back to rpc";
+                Break();
+                return;
+            }
+            continue;
+        }
+
+        while (ring_.PopCqe(&cqe)) {
+            NebdClientAioContext* aioctx = nullptr;
+            if (cqe.tag < inflight_.size()) {
+                std::lock_guard<std::mutex> lk(mtx_);
+                aioctx = inflight_[cqe.tag];
+                inflight_[cqe.tag] = nullptr;
+            }
+            if (aioctx == nullptr) {
+                LOG(ERROR) << "Unexpected completion, tag = " << cqe.tag;
+                continue;
+            }
+
+            if (cqe.ret >= 0 && aioctx->op == LIBAIO_OP::LIBAIO_OP_READ) {
+                memcpy(aioctx->buf, ring_.SlotBuffer(cqe.tag),
+                       aioctx->length);
+            }
+            ReleaseTag(cqe.tag);
+
+            if (cqe.ret == kShmRingRetResubmit) {
+                // part2不返回io错误，与rpc路径一致由rpc重试
+                LOG(WARNING) << "Resubmit " << OpTypeToString(aioctx->op)
+                             << " through rpc, offset = " << aioctx->offset
+                             << ", length = " << aioctx->length;
+                fallback_(aioctx);
+                continue;
+            }
+            if (cqe.ret < 0) {
+                LOG(ERROR) << OpTypeToString(aioctx->op)
+                           << " failed through shm ring, offset = "
+                           << aioctx->offset
+                           << ", length = " << aioctx->length;
+            }
+            aioctx->ret = cqe.ret < 0 ? -1 : 0;
+            aioctx->cb(aioctx);
+        }
+    }
+}
+
+bool ShmRingClient::ServerAlive() const {
+    pid_t pid = ring_.ServerPid();
+    if (pid == kShmRingServerBroken) {
+        return false;
+    }
+    return pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+void ShmRingClient::Break() {
+    std::vector<NebdClientAioContext*> pending;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        broken_.store(true, std::memory_order_release);
+        for (auto& aioctx : inflight_) {
+            if (aioctx != nullptr) {
+                pending.push_back(aioctx);
+                aioctx = nullptr;
+            }
+        }
+    }
+
+    for (auto* aioctx : pending) {
+        LOG(WARNING) << "Resubmit " << OpTypeToString(aioctx->op)
+                     << " through rpc, offset = " << aioctx->offset
+                     << ", length = " << aioctx->length;
+        fallback_(aioctx);
+    }
+}
+
+void ShmRingClient::ReleaseTag(uint32_t tag) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    freeTags_.push_back(tag);
+}
+
+}  // namespace client
+}  // namespace nebd
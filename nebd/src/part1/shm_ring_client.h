@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#ifndef NEBD_SRC_PART1_SHM_RING_CLIENT_H_
+#define NEBD_SRC_PART1_SHM_RING_CLIENT_H_
+
+#include <atomic>
+#include <functional>
+#include <mutex>    // NOLINT
+#include <string>
+#include <thread>   // NOLINT
+#include <vector>
+
+#include "nebd/src/common/shm_ring.h"
+#include "nebd/src/part1/libnebd.h"
+#include "nebd/src/part1/nebd_common.h"
+
+namespace nebd {
+namespace client {
+
+// ring不可用时，将请求交给rpc路径处理
+using RingFallback = std::function<void(NebdClientAioContext* aioctx)>;
+
+/**
+ * 单个打开文件的共享内存ring，part1侧
+ *
+ * open时创建共享内存并把名称带给part2，part2 attach成功后调用Start，
+ * 此后读写请求优先通过ring提交，由后台线程收割完成队列并回调。
+ * 请求超过slot大小或slot耗尽时，Submit返回false，由调用方走rpc。
+ * part2进程退出或停止处理ring后，ring被标记为不可用，在途请求通过
+ * fallback重新提交。part2要求重新提交的请求同样交给fallback。
+ */
+class ShmRingClient {
+ public:
+    ShmRingClient() = default;
+    ~ShmRingClient();
+
+    /**
+     * @brief 创建共享内存
+     * @return 成功返回0，失败返回-1
+     */
+    int Init(const RingOption& option);
+
+    const std::string& Name() const {
+        return ring_.Name();
+    }
+
+    /**
+     * @brief part2 attach成功后启动完成线程，并删除共享内存名称
+     */
+    void Start(const RingFallback& fallback);
+
+    /**
+     * @brief 停止完成线程并解除映射
+     */
+    void Stop();
+
+    /**
+     * @brief 通过ring提交读写请求
+     * @return 成功提交返回true，ring不可用时返回false
+     */
+    bool Submit(NebdClientAioContext* aioctx);
+
+    bool Broken() const {
+        return broken_.load(std::memory_order_acquire);
+    }
+
+ private:
+    void CompletionThreadFunc();
+
+    bool ServerAlive() const;
+
+    // 标记ring不可用，并将在途请求转交给rpc
+    void Break();
+
+    void ReleaseTag(uint32_t tag);
+
+ private:
+    nebd::common::ShmRing ring_;
+    RingFallback fallback_;
+
+    // 保护sq的生产端、空闲slot和在途请求
+    std::mutex mtx_;
+    std::vector<uint32_t> freeTags_;
+    std::vector<NebdClientAioContext*> inflight_;
+
+    std::atomic<bool> broken_{false};
+    std::atomic<bool> running_{false};
+    std::thread completionThread_;
+};
+
+}  // namespace client
+}  // namespace nebd
+
+#endif  // NEBD_SRC_PART1_SHM_RING_CLIENT_H_
@@ -122,6 +122,9 @@ const char HEARTBEATTIMEOUTSEC[] = "heartbeat.timeout.sec";
 const char HEARTBEATCHECKINTERVALMS[] = "heartbeat.check.interval.ms";
 const char CURVECLIENTCONFPATH[] = "curveclient.confPath";
 const char RESPONSERETURNRPCWHENIOERROR[] = "response.returnRpcWhenIoError";
+const char WRITEMERGEENABLE[] = "write.merge.enable";
+const char WRITEMERGEWINDOWUS[] = "write.merge.windowUs";
+const char WRITEMERGEMAXBYTES[] = "write.merge.maxBytes";
 
 }  // namespace server
 }  // namespace nebd
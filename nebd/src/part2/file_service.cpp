@@ -128,6 +128,10 @@ void NebdFileServiceImpl::OpenFile(
     if (fd > 0) {
         response->set_retcode(RetCode::kOK);
         response->set_fd(fd);
+        if (request->has_shmname()) {
+            response->set_shmattached(
+                AttachShmRing(fd, request->shmname()));
+        }
         LOG(INFO) << "Open file success. "
                   << "filename: " << request->filename()
                   << ", fd: " << fd;
@@ -309,6 +313,7 @@ void NebdFileServiceImpl::CloseFile(
     brpc::ClosureGuard doneGuard(done);
     response->set_retcode(RetCode::kNoOK);
 
+    DetachShmRing(request->fd());
     int rc = fileManager_->Close(request->fd(), true);
     if (rc < 0) {
         LOG(ERROR) << "Close file failed. "
@@ -358,5 +363,40 @@ void NebdFileServiceImpl::InvalidateCache(
     }
 }
 
+bool NebdFileServiceImpl::AttachShmRing(int fd, const std::string& shmName) {
+    auto ring = std::make_shared<ShmRingServer>(
+        fd, fileManager_, returnRpcWhenIoError_);
+    if (ring->Start(shmName) != 0) {
+        LOG(WARNING) << "Attach shm ring failed, fall back to rpc. "
+                     << "fd: " << fd << ", shm name: " << shmName;
+        return false;
+    }
+
+    std::shared_ptr<ShmRingServer> old;
+    {
+        std::lock_guard<std::mutex> lk(ringMtx_);
+        old = rings_[fd];
+        rings_[fd] = ring;
+    }
+    if (old != nullptr) {
+        old->Stop();
+    }
+    return true;
+}
+
+void NebdFileServiceImpl::DetachShmRing(int fd) {
+    std::shared_ptr<ShmRingServer> ring;
+    {
+        std::lock_guard<std::mutex> lk(ringMtx_);
+        auto iter = rings_.find(fd);
+        if (iter == rings_.end()) {
+            return;
+        }
+        ring = iter->second;
+        rings_.erase(iter);
+    }
+    ring->Stop();
+}
+
 }  // namespace server
 }  // namespace nebd
@@ -28,9 +28,12 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
 
 #include "nebd/proto/client.pb.h"
 #include "nebd/src/part2/file_manager.h"
+#include "nebd/src/part2/shm_ring_server.h"
 
 namespace nebd {
 namespace server {
@@ -91,9 +94,19 @@ class NebdFileServiceImpl : public nebd::client::NebdFileService {
                             nebd::client::InvalidateCacheResponse* response,
                             google::protobuf::Closure* done);
 
+ private:
+    // attach part1创建的共享内存ring，同一fd已有的ring会被替换
+    bool AttachShmRing(int fd, const std::string& shmName);
+
+    void DetachShmRing(int fd);
+
  private:
     std::shared_ptr<NebdFileManager> fileManager_;
     const bool returnRpcWhenIoError_;
+
+    // fd到共享内存ring的映射
+    std::mutex ringMtx_;
+    std::unordered_map<int, std::shared_ptr<ShmRingServer>> rings_;
 };
 
 }  // namespace server
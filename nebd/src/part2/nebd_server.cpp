@@ -148,7 +148,21 @@ bool NebdServer::InitCurveRequestExecutor() {
         return false;
     }
 
-    CurveRequestExecutor::GetInstance().Init(curveClient_);
+    WriteMergeOption mergeOption;
+    if (!conf_.GetBoolValue(WRITEMERGEENABLE, &mergeOption.enable)) {
+        LOG(WARNING) << "get " << WRITEMERGEENABLE << " fail, use default "
+                     << mergeOption.enable;
+    }
+    if (!conf_.GetUInt32Value(WRITEMERGEWINDOWUS, &mergeOption.windowUs)) {
+        LOG(WARNING) << "get " << WRITEMERGEWINDOWUS << " fail, use default "
+                     << mergeOption.windowUs;
+    }
+    if (!conf_.GetUInt32Value(WRITEMERGEMAXBYTES, &mergeOption.maxBytes)) {
+        LOG(WARNING) << "get " << WRITEMERGEMAXBYTES << " fail, use default "
+                     << mergeOption.maxBytes;
+    }
+
+    CurveRequestExecutor::GetInstance().Init(curveClient_, mergeOption);
     return true;
 }
 
@@ -80,8 +80,10 @@ std::string FileNameParser::Parse(const std::string& fileName) {
     return fileName.substr(beginPos, length);
 }
 
-void CurveRequestExecutor::Init(const std::shared_ptr<CurveClient> &client) {
+void CurveRequestExecutor::Init(const std::shared_ptr<CurveClient> &client,
+                                const WriteMergeOption& mergeOption) {
     client_ = client;
+    mergeOption_ = mergeOption;
 }
 
 std::shared_ptr<NebdFileInstance> CurveRequestExecutor::Open(
@@ -98,6 +100,7 @@ std::shared_ptr<NebdFileInstance> CurveRequestExecutor::Open(
         curveFileInstance->fd = fd;
         curveFileInstance->fileName = curveFileName;
         curveFileInstance->xattr[kSessionAttrKey] = "";
+        curveFileInstance->writeMerger = NewWriteMerger(fd);
 
         if (openFlags) {
             curveFileInstance->xattr[kOpenFlagsAttrKey] =
@@ -135,6 +138,7 @@ CurveRequestExecutor::Reopen(const std::string& filename,
         curveFileInstance->fd = fd;
         curveFileInstance->fileName = curveFileName;
         curveFileInstance->xattr[kSessionAttrKey] = newSessionId;
+        curveFileInstance->writeMerger = NewWriteMerger(fd);
         if (xattr.count(kOpenFlagsAttrKey)) {
             curveFileInstance->xattr[kOpenFlagsAttrKey] =
                 xattr.at(kOpenFlagsAttrKey);
@@ -197,6 +201,8 @@ int CurveRequestExecutor::Discard(NebdFileInstance* fd,
         return -1;
     }
 
+    FlushMergedWrites(fd, aioctx);
+
     CurveAioCombineContext* curveCombineCtx = new CurveAioCombineContext();
     curveCombineCtx->nebdCtx = aioctx;
     int ret = FromNebdCtxToCurveCtx(aioctx, &curveCombineCtx->curveCtx);
@@ -225,6 +231,8 @@ int CurveRequestExecutor::AioRead(
         return -1;
     }
 
+    FlushMergedWrites(fd, aioctx);
+
     CurveAioCombineContext *curveCombineCtx = new CurveAioCombineContext();
     curveCombineCtx->nebdCtx = aioctx;
     int ret = FromNebdCtxToCurveCtx(aioctx, &curveCombineCtx->curveCtx);
@@ -250,6 +258,11 @@ int CurveRequestExecutor::AioWrite(
         return -1;
     }
 
+    auto curveFileInstance = dynamic_cast<CurveFileInstance *>(fd);
+    if (curveFileInstance->writeMerger != nullptr) {
+        return curveFileInstance->writeMerger->Write(aioctx);
+    }
+
     CurveAioCombineContext *curveCombineCtx = new CurveAioCombineContext();
     curveCombineCtx->nebdCtx = aioctx;
     int ret = FromNebdCtxToCurveCtx(aioctx, &curveCombineCtx->curveCtx);
@@ -270,6 +283,11 @@ int CurveRequestExecutor::AioWrite(
 
 int CurveRequestExecutor::Flush(
     NebdFileInstance* fd, NebdServerAioContext* aioctx) {
+    auto curveFileInstance = dynamic_cast<CurveFileInstance *>(fd);
+    if (curveFileInstance != nullptr &&
+        curveFileInstance->writeMerger != nullptr) {
+        curveFileInstance->writeMerger->Flush();
+    }
 
     aioctx->ret = 0;
     aioctx->cb(aioctx);
@@ -336,6 +354,51 @@ int CurveRequestExecutor::FromNebdOpToCurveOp(LIBAIO_OP op, LIBCURVE_OP *out) {
     }
 }
 
+std::shared_ptr<WriteMerger> CurveRequestExecutor::NewWriteMerger(
+    int curveFd) {
+    if (!mergeOption_.enable) {
+        return nullptr;
+    }
+
+    auto client = client_;
+    return std::make_shared<WriteMerger>(
+        mergeOption_, [client, curveFd](MergedWrite* write) -> int {
+            CurveAioMergedContext* mergedCtx = new CurveAioMergedContext();
+            mergedCtx->write = write;
+            mergedCtx->curveCtx.offset = write->offset;
+            mergedCtx->curveCtx.length = write->length;
+            mergedCtx->curveCtx.op = LIBCURVE_OP_WRITE;
+            mergedCtx->curveCtx.buf = &write->data;
+            mergedCtx->curveCtx.cb = CurveAioMergedCallback;
+
+            int ret = client->AioWrite(curveFd, &mergedCtx->curveCtx,
+                                       curve::client::UserDataType::IOBuffer);
+            if (ret != LIBCURVE_ERROR::OK) {
+                delete mergedCtx;
+                return -1;
+            }
+            return 0;
+        });
+}
+
+void CurveRequestExecutor::FlushMergedWrites(NebdFileInstance* fd,
+                                             NebdServerAioContext* aioctx) {
+    auto curveFileInstance = dynamic_cast<CurveFileInstance *>(fd);
+    if (curveFileInstance != nullptr &&
+        curveFileInstance->writeMerger != nullptr) {
+        curveFileInstance->writeMerger->FlushOverlapped(aioctx->offset,
+                                                        aioctx->size);
+    }
+}
+
+void CurveAioMergedCallback(struct CurveAioContext* curveCtx) {
+    auto mergedCtx = reinterpret_cast<CurveAioMergedContext *>(
+        reinterpret_cast<char *>(curveCtx) -
+        offsetof(CurveAioMergedContext, curveCtx));
+    WriteMerger::OnWriteDone(mergedCtx->write, curveCtx->ret);
+    delete mergedCtx;
+}
+
 void CurveAioCallback(struct CurveAioContext* curveCtx) {
     auto curveCombineCtx = reinterpret_cast<CurveAioCombineContext *>(
         reinterpret_cast<char *>(curveCtx) -
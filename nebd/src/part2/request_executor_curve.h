@@ -27,6 +27,7 @@
 #include <memory>
 #include "nebd/src/part2/request_executor.h"
 #include "nebd/src/part2/define.h"
+#include "nebd/src/part2/write_merger.h"
 #include "include/client/libcurve.h"
 
 namespace nebd {
@@ -41,6 +42,8 @@ class CurveFileInstance : public NebdFileInstance {
 
     int fd = -1;
     std::string fileName;
+    // 写请求合并，未开启时为空
+    std::shared_ptr<WriteMerger> writeMerger;
 };
 
 class CurveAioCombineContext {
@@ -50,6 +53,14 @@ class CurveAioCombineContext {
 };
 void CurveAioCallback(struct CurveAioContext* curveCtx);
 
+// 合并后的写请求对应的curve异步请求上下文
+class CurveAioMergedContext {
+ public:
+    MergedWrite* write;
+    CurveAioContext curveCtx;
+};
+void CurveAioMergedCallback(struct CurveAioContext* curveCtx);
+
 class FileNameParser {
  public:
     /**
@@ -70,7 +81,8 @@ class CurveRequestExecutor : public NebdRequestExecutor {
         return executor;
     }
     ~CurveRequestExecutor() {}
-    void Init(const std::shared_ptr<CurveClient> &client);
+    void Init(const std::shared_ptr<CurveClient> &client,
+              const WriteMergeOption& mergeOption = WriteMergeOption());
     std::shared_ptr<NebdFileInstance> Open(const std::string& filename,
                                            const OpenFlags* openflags) override;
     std::shared_ptr<NebdFileInstance> Reopen(
@@ -121,8 +133,20 @@ class CurveRequestExecutor : public NebdRequestExecutor {
      */
      int FromNebdOpToCurveOp(LIBAIO_OP op, LIBCURVE_OP *out);
 
+    /**
+     * @brief 创建文件的写请求合并器，未开启合并时返回空
+     * @param[in] curveFd curve_client中文件的fd
+     */
+    std::shared_ptr<WriteMerger> NewWriteMerger(int curveFd);
+
+    /**
+     * @brief 下发与读/discard请求重叠的暂存写请求
+     */
+    void FlushMergedWrites(NebdFileInstance* fd, NebdServerAioContext* aioctx);
+
  private:
     std::shared_ptr<::curve::client::CurveClient> client_;
+    WriteMergeOption mergeOption_;
 };
 
 }  // namespace server
@@ -0,0 +1,210 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#include "nebd/src/part2/shm_ring_server.h"
+
+#include <brpc/closure_guard.h>
+#include <butil/iobuf.h>
+#include <glog/logging.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace nebd {
+namespace server {
+
+using nebd::common::kShmRingRetError;
+using nebd::common::kShmRingRetOk;
+using nebd::common::kShmRingRetResubmit;
+using nebd::common::kShmRingServerBroken;
+using nebd::common::ShmRingOp;
+using nebd::common::ShmRingSqe;
+
+// 处理线程等待的超时时间，超时后检查part1是否存活
+constexpr int kRingWaitTimeoutMs = 1000;
+
+static void EmptyDeleter(void* m) {}
+
+void ShmRingServiceCallback(NebdServerAioContext* context) {
+    CHECK(context != nullptr);
+    std::unique_ptr<ShmRingAioContext> contextGuard(
+        static_cast<ShmRingAioContext*>(context));
+    std::unique_ptr<butil::IOBuf> iobufGuard(
+        reinterpret_cast<butil::IOBuf*>(context->buf));
+    // 释放file entity的读锁
+    brpc::ClosureGuard doneGuard(context->done);
+
+    contextGuard->ring->Complete(contextGuard.get());
+}
+
+ShmRingServer::ShmRingServer(int fd,
+                             std::shared_ptr<NebdFileManager> fileManager,
+                             bool returnRpcWhenIoError)
+    : fd_(fd),
+      fileManager_(fileManager),
+      returnRpcWhenIoError_(returnRpcWhenIoError) {}
+
+ShmRingServer::~ShmRingServer() {
+    Stop();
+    ring_.Detach();
+}
+
+int ShmRingServer::Start(const std::string& name) {
+    if (ring_.Attach(name) != 0) {
+        LOG(ERROR) << "Attach shm ring failed, name: " << name
+                   << ", fd: " << fd_;
+        return -1;
+    }
+
+    ring_.SetServerPid(getpid());
+    running_.store(true, std::memory_order_release);
+    processThread_ = std::thread(&ShmRingServer::ProcessThreadFunc, this);
+    LOG(INFO) << "Shm ring attached, name: " << name
+              << ", fd: " << fd_
+              << ", client pid: " << ring_.ClientPid()
+              << ", depth: " << ring_.Depth()
+              << ", slot size: " << ring_.SlotSize();
+    return 0;
+}
+
+void ShmRingServer::Stop() {
+    if (processThread_.joinable()) {
+        running_.store(false, std::memory_order_release);
+        ring_.Wakeup();
+        processThread_.join();
+        LOG(INFO) << "Shm ring stopped, name: " << ring_.Name()
+                  << ", fd: " << fd_;
+    }
+}
+
+void ShmRingServer::ProcessThreadFunc() {
+    ShmRingSqe sqe;
+    while (running_.load(std::memory_order_acquire)) {
+        if (!ring_.WaitSqe(kRingWaitTimeoutMs)) {
+            if (!ClientAlive()) {
+                LOG(WARNING) << "nebd-client " << ring_.ClientPid()
+                             << " exited, stop processing shm ring "
+                             << ring_.Name();
+                return;
+            }
+            continue;
+        }
+
+        while (ring_.PopSqe(&sqe)) {
+            Process(sqe);
+        }
+    }
+}
+
+void ShmRingServer::Process(const ShmRingSqe& sqe) {
+    ShmRingAioContext* context = new (std::nothrow) ShmRingAioContext();
+    context->ring = shared_from_this();
+    context->tag = sqe.tag;
+    context->offset = sqe.offset;
+    context->size = sqe.length;
+    context->cb = ShmRingServiceCallback;
+    context->returnRpcWhenIoError = returnRpcWhenIoError_;
+
+    std::unique_ptr<butil::IOBuf> buf(new butil::IOBuf());
+    context->buf = buf.get();
+
+    if (sqe.tag >= ring_.Depth()) {
+        // 没有对应的slot，无法返回结果
+        LOG(ERROR) << "Invalid shm ring request, tag: " << sqe.tag;
+        delete context;
+        return;
+    }
+
+    int rc = -1;
+    if (sqe.length > ring_.SlotSize()) {
+        LOG(ERROR) << "Invalid shm ring request, tag: " << sqe.tag
+                   << ", length: " << sqe.length;
+    } else if (sqe.op == static_cast<uint32_t>(ShmRingOp::kWrite)) {
+        context->op = LIBAIO_OP::LIBAIO_OP_WRITE;
+        // slot在请求返回之前不会被part1复用，可以直接引用
+        buf->append_user_data(ring_.SlotBuffer(sqe.tag), sqe.length,
+                              EmptyDeleter);
+        rc = fileManager_->AioWrite(fd_, context);
+    } else if (sqe.op == static_cast<uint32_t>(ShmRingOp::kRead)) {
+        context->op = LIBAIO_OP::LIBAIO_OP_READ;
+        rc = fileManager_->AioRead(fd_, context);
+    }
+
+    if (rc < 0) {
+        LOG(ERROR) << Op2Str(context->op) << " file failed. "
+                   << "fd: " << fd_
+                   << ", offset: " << sqe.offset
+                   << ", size: " << sqe.length
+                   << ", return code: " << rc;
+        // 与rpc路径一致，提交失败直接返回错误
+        PushCqe(sqe.tag, kShmRingRetError);
+        delete context;
+        return;
+    }
+
+    buf.release();
+}
+
+void ShmRingServer::Complete(ShmRingAioContext* context) {
+    int32_t ret = kShmRingRetOk;
+    if (context->ret < 0) {
+        LOG(ERROR) << *context;
+        if (returnRpcWhenIoError_) {
+            ret = kShmRingRetError;
+        } else {
+            // 与rpc路径一致，不向part1返回io错误，由part1通过rpc重新提交
+            LOG(ERROR) << Op2Str(context->op)
+                       << " file failed, let nebd-client resubmit it"
+                       << " through rpc.";
+            ret = kShmRingRetResubmit;
+        }
+    } else if (context->op == LIBAIO_OP::LIBAIO_OP_READ) {
+        reinterpret_cast<butil::IOBuf*>(context->buf)->copy_to(
+            ring_.SlotBuffer(context->tag), context->size);
+    }
+
+    PushCqe(context->tag, ret);
+}
+
+void ShmRingServer::PushCqe(uint32_t tag, int32_t ret) {
+    std::lock_guard<std::mutex> lk(cqMtx_);
+    if (broken_) {
+        return;
+    }
+    // 在途请求数不超过depth时cq不会满，满了说明part1没有按约定使用ring
+    if (!ring_.PushCqe({tag, ret})) {
+        LOG(ERROR) << "Shm ring " << ring_.Name() << " cq is full, stop"
+                   << " processing it and let nebd-client resubmit the"
+                   << " inflight requests through rpc, fd: " << fd_;
+        broken_ = true;
+        running_.store(false, std::memory_order_release);
+        ring_.SetServerPid(kShmRingServerBroken);
+        ring_.Wakeup();
+    }
+}
+
+bool ShmRingServer::ClientAlive() const {
+    return kill(ring_.ClientPid(), 0) == 0 || errno != ESRCH;
+}
+
+}  // namespace server
+}  // namespace nebd
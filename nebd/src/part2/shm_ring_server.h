@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#ifndef NEBD_SRC_PART2_SHM_RING_SERVER_H_
+#define NEBD_SRC_PART2_SHM_RING_SERVER_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>    // NOLINT
+#include <string>
+#include <thread>   // NOLINT
+
+#include "nebd/src/common/shm_ring.h"
+#include "nebd/src/part2/define.h"
+#include "nebd/src/part2/file_manager.h"
+
+namespace nebd {
+namespace server {
+
+class ShmRingServer;
+
+// 通过共享内存ring提交的异步请求上下文
+struct ShmRingAioContext : public NebdServerAioContext {
+    std::shared_ptr<ShmRingServer> ring;
+    uint32_t tag = 0;
+};
+
+void ShmRingServiceCallback(NebdServerAioContext* context);
+
+/**
+ * 单个打开文件的共享内存ring，part2侧
+ *
+ * 后台线程从sq中取出读写请求，转换为NebdServerAioContext后交给
+ * NebdFileManager处理，请求返回时将结果写入cq并唤醒part1。
+ * 写请求直接引用arena中的数据，读请求返回后将数据拷贝到arena。
+ * 不向part1返回io错误时，cqe中带回kShmRingRetResubmit，由part1通过rpc
+ * 重新提交，与rpc路径的行为一致。
+ */
+class ShmRingServer : public std::enable_shared_from_this<ShmRingServer> {
+ public:
+    ShmRingServer(int fd,
+                  std::shared_ptr<NebdFileManager> fileManager,
+                  bool returnRpcWhenIoError);
+    ~ShmRingServer();
+
+    /**
+     * @brief 映射part1创建的共享内存并启动处理线程
+     * @return 成功返回0，失败返回-1
+     */
+    int Start(const std::string& name);
+
+    /**
+     * @brief 停止处理线程，在途请求返回后才会解除映射
+     */
+    void Stop();
+
+    /**
+     * @brief 请求返回后调用，将结果写入cq
+     */
+    void Complete(ShmRingAioContext* context);
+
+ private:
+    void ProcessThreadFunc();
+
+    void Process(const nebd::common::ShmRingSqe& sqe);
+
+    // 将结果写入cq，cq写入失败时停止处理ring
+    void PushCqe(uint32_t tag, int32_t ret);
+
+    bool ClientAlive() const;
+
+ private:
+    int fd_;
+    std::shared_ptr<NebdFileManager> fileManager_;
+    const bool returnRpcWhenIoError_;
+
+    nebd::common::ShmRing ring_;
+    // 保护cq的生产端，请求可能在多个线程中返回
+    std::mutex cqMtx_;
+    // cq写入失败后不再返回结果，由cqMtx_保护
+    bool broken_ = false;
+
+    std::atomic<bool> running_{false};
+    std::thread processThread_;
+};
+
+}  // namespace server
+}  // namespace nebd
+
+#endif  // NEBD_SRC_PART2_SHM_RING_SERVER_H_
@@ -0,0 +1,296 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-18
+ */
+
+#include "nebd/src/part2/write_merger.h"
+
+#include <bthread/unstable.h>
+#include <butil/time.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace nebd {
+namespace server {
+
+static double GetMergeRatio(void* arg) {
+    WriteMergeMetric* metric = static_cast<WriteMergeMetric*>(arg);
+    uint64_t submits = metric->submits.get_value();
+    if (submits == 0) {
+        return 0;
+    }
+    return static_cast<double>(metric->requests.get_value()) / submits;
+}
+
+WriteMergeMetric::WriteMergeMetric()
+    : requests("nebd_write_merge_requests"),
+      submits("nebd_write_merge_submits"),
+      ratio("nebd_write_merge_ratio", GetMergeRatio, this),
+      addedLatency("nebd_write_merge_added_latency") {}
+
+WriteMergeMetric* GetWriteMergeMetric() {
+    static WriteMergeMetric metric;
+    return &metric;
+}
+
+namespace {
+
+struct MergeTimerArg {
+    std::weak_ptr<WriteMerger> merger;
+    uint64_t seq;
+};
+
+}  // namespace
+
+WriteMerger::WriteMerger(const WriteMergeOption& option,
+                         const Submitter& submitter)
+    : option_(option), submitter_(submitter), inflight_(0), seq_(0) {}
+
+int WriteMerger::Write(NebdServerAioContext* aioctx) {
+    GetWriteMergeMetric()->requests << 1;
+
+    std::unique_ptr<MergedWrite> ready;
+    bool direct = false;
+    uint64_t armSeq = 0;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (pending_ == nullptr && inflight_ == 0) {
+            // 后端空闲，直接下发
+            direct = true;
+            ready = NewWrite(aioctx);
+            ++inflight_;
+        } else if (pending_ != nullptr && Mergeable(pending_.get(), aioctx)) {
+            Append(pending_.get(), aioctx);
+            if (pending_->length >= option_.maxBytes) {
+                ready = std::move(pending_);
+                ++inflight_;
+            }
+        } else {
+            // 不能合并，先下发已暂存的请求
+            if (pending_ != nullptr) {
+                ready = std::move(pending_);
+                ++inflight_;
+            }
+            pending_ = NewWrite(aioctx);
+            pending_->seq = ++seq_;
+            armSeq = pending_->seq;
+        }
+    }
+
+    if (armSeq != 0) {
+        ArmTimer(armSeq);
+    }
+
+    if (ready == nullptr) {
+        return 0;
+    }
+
+    if (!direct) {
+        Dispatch(std::move(ready));
+        return 0;
+    }
+
+    if (Submit(ready.get())) {
+        ready.release();
+        return 0;
+    }
+
+    // 直接下发失败时请求仍由调用方处理
+    ready.reset();
+    Release();
+    return -1;
+}
+
+void WriteMerger::FlushOverlapped(off_t offset, size_t length) {
+    std::unique_ptr<MergedWrite> ready;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (pending_ == nullptr ||
+            offset >= static_cast<off_t>(pending_->offset + pending_->length) ||
+            static_cast<off_t>(offset + length) <= pending_->offset) {
+            return;
+        }
+        ready = std::move(pending_);
+        ++inflight_;
+    }
+
+    Dispatch(std::move(ready));
+}
+
+void WriteMerger::Flush() {
+    std::unique_ptr<MergedWrite> ready;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (pending_ == nullptr) {
+            return;
+        }
+        ready = std::move(pending_);
+        ++inflight_;
+    }
+
+    Dispatch(std::move(ready));
+}
+
+void WriteMerger::OnWriteDone(MergedWrite* write, int ret) {
+    std::unique_ptr<MergedWrite> writeGuard(write);
+    std::shared_ptr<WriteMerger> merger = write->merger;
+
+    for (auto* aioctx : write->requests) {
+        aioctx->ret = ret < 0 ? ret : static_cast<int>(aioctx->size);
+        aioctx->cb(aioctx);
+    }
+
+    writeGuard.reset();
+    merger->Release();
+}
+
+bool WriteMerger::Mergeable(const MergedWrite* write,
+                            const NebdServerAioContext* aioctx) const {
+    off_t begin = std::min(write->offset, aioctx->offset);
+    off_t end = std::max<off_t>(write->offset + write->length,
+                                aioctx->offset + aioctx->size);
+    // 相邻或者重叠
+    return aioctx->offset <= static_cast<off_t>(write->offset + write->length)
+        && static_cast<off_t>(aioctx->offset + aioctx->size) >= write->offset
+        && static_cast<uint64_t>(end - begin) <= option_.maxBytes;
+}
+
+void WriteMerger::Append(MergedWrite* write, NebdServerAioContext* aioctx) {
+    butil::IOBuf* buf = reinterpret_cast<butil::IOBuf*>(aioctx->buf);
+    off_t oldBegin = write->offset;
+    off_t oldEnd = write->offset + write->length;
+    off_t newBegin = aioctx->offset;
+    off_t newEnd = aioctx->offset + aioctx->size;
+
+    butil::IOBuf old;
+    old.swap(write->data);
+    // 旧数据在新请求之前的部分
+    if (oldBegin < newBegin) {
+        old.cutn(&write->data, newBegin - oldBegin);
+    }
+    // 重叠部分以新请求为准
+    write->data.append(*buf);
+    off_t overlapEnd = std::min(oldEnd, newEnd);
+    off_t overlapBegin = std::max(oldBegin, newBegin);
+    if (overlapEnd > overlapBegin) {
+        old.pop_front(overlapEnd - overlapBegin);
+    }
+    // 旧数据在新请求之后的部分
+    write->data.append(old);
+
+    write->offset = std::min(oldBegin, newBegin);
+    write->length = std::max(oldEnd, newEnd) - write->offset;
+    write->requests.push_back(aioctx);
+    write->arriveUs.push_back(butil::gettimeofday_us());
+}
+
+std::unique_ptr<MergedWrite> WriteMerger::NewWrite(
+    NebdServerAioContext* aioctx) {
+    std::unique_ptr<MergedWrite> write(new MergedWrite());
+    write->offset = aioctx->offset;
+    write->length = aioctx->size;
+    write->data = *reinterpret_cast<butil::IOBuf*>(aioctx->buf);
+    write->requests.push_back(aioctx);
+    write->arriveUs.push_back(butil::gettimeofday_us());
+    return write;
+}
+
+bool WriteMerger::Submit(MergedWrite* write) {
+    WriteMergeMetric* metric = GetWriteMergeMetric();
+    metric->submits << 1;
+    uint64_t now = butil::gettimeofday_us();
+    for (auto arriveUs : write->arriveUs) {
+        metric->addedLatency << (now - arriveUs);
+    }
+
+    write->merger = shared_from_this();
+    return submitter_(write) == 0;
+}
+
+void WriteMerger::Dispatch(std::unique_ptr<MergedWrite> write) {
+    if (Submit(write.get())) {
+        write.release();
+        return;
+    }
+
+    LOG(ERROR) << "Submit merged write failed, offset: " << write->offset
+               << ", length: " << write->length
+               << ", requests: " << write->requests.size();
+    OnWriteDone(write.release(), -1);
+}
+
+void WriteMerger::Release() {
+    std::unique_ptr<MergedWrite> ready;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        --inflight_;
+        if (inflight_ == 0 && pending_ != nullptr) {
+            ready = std::move(pending_);
+            ++inflight_;
+        }
+    }
+
+    if (ready != nullptr) {
+        Dispatch(std::move(ready));
+    }
+}
+
+void WriteMerger::ArmTimer(uint64_t seq) {
+    if (option_.windowUs == 0) {
+        return;
+    }
+
+    MergeTimerArg* arg = new MergeTimerArg{shared_from_this(), seq};
+    bthread_timer_t timerId;
+    int ret = bthread_timer_add(&timerId,
+                                butil::microseconds_from_now(option_.windowUs),
+                                &WriteMerger::OnTimer, arg);
+    if (ret != 0) {
+        // 暂存请求仍会在后端请求返回时下发
+        LOG(WARNING) << "bthread_timer_add failed, ret = " << ret;
+        delete arg;
+    }
+}
+
+void WriteMerger::OnTimer(void* arg) {
+    std::unique_ptr<MergeTimerArg> timerArg(static_cast<MergeTimerArg*>(arg));
+    std::shared_ptr<WriteMerger> merger = timerArg->merger.lock();
+    if (merger != nullptr) {
+        merger->FlushIfSeq(timerArg->seq);
+    }
+}
+
+void WriteMerger::FlushIfSeq(uint64_t seq) {
+    std::unique_ptr<MergedWrite> ready;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (pending_ == nullptr || pending_->seq != seq) {
+            return;
+        }
+        ready = std::move(pending_);
+        ++inflight_;
+    }
+
+    Dispatch(std::move(ready));
+}
+
+}  // namespace server
+}  // namespace nebd
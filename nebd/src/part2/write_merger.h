@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-18
+ */
+
+#ifndef NEBD_SRC_PART2_WRITE_MERGER_H_
+#define NEBD_SRC_PART2_WRITE_MERGER_H_
+
+#include <bvar/bvar.h>
+#include <butil/iobuf.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "nebd/src/part2/define.h"
+
+namespace nebd {
+namespace server {
+
+// 写请求合并配置项
+struct WriteMergeOption {
+    // 是否合并相邻或重叠的写请求
+    bool enable = false;
+    // 请求在合并队列中的最长等待时间，0表示只在后端空闲时下发
+    uint32_t windowUs = 200;
+    // 合并后单个写请求的最大长度
+    uint32_t maxBytes = 1024 * 1024;
+};
+
+// 写请求合并的统计信息，所有文件共享
+struct WriteMergeMetric {
+    WriteMergeMetric();
+
+    // 经过合并队列的写请求数
+    bvar::Adder<uint64_t> requests;
+    // 实际下发给后端的写请求数
+    bvar::Adder<uint64_t> submits;
+    // 合并比例，requests / submits
+    bvar::PassiveStatus<double> ratio;
+    // 请求因等待合并而增加的延迟
+    bvar::LatencyRecorder addedLatency;
+};
+
+WriteMergeMetric* GetWriteMergeMetric();
+
+class WriteMerger;
+
+// 合并后的写请求
+struct MergedWrite {
+    std::shared_ptr<WriteMerger> merger;
+    off_t offset = 0;
+    size_t length = 0;
+    butil::IOBuf data;
+    // 被合并的原始请求及其到达时间
+    std::vector<NebdServerAioContext*> requests;
+    std::vector<uint64_t> arriveUs;
+    // 暂存时的序号，用于识别过期的定时器
+    uint64_t seq = 0;
+};
+
+/**
+ * 单个文件的写请求合并
+ *
+ * 后端没有在途请求时，写请求直接下发，不增加延迟；
+ * 后端忙时，写请求暂存在合并队列中，与后续相邻或重叠的写请求合并，
+ * 重叠部分以后到达的请求为准。暂存的请求在以下情况下发：
+ *   1. 后端在途请求全部返回
+ *   2. 合并长度达到maxBytes，或者到达不能合并的写请求
+ *   3. 等待时间超过windowUs
+ *   4. 有重叠的读/discard请求，或者flush
+ * 合并后的请求返回时，依次回调每个原始请求。
+ */
+class WriteMerger : public std::enable_shared_from_this<WriteMerger> {
+ public:
+    // 将合并后的请求下发给后端，成功返回0，请求返回后需调用OnWriteDone
+    using Submitter = std::function<int(MergedWrite* write)>;
+
+    WriteMerger(const WriteMergeOption& option, const Submitter& submitter);
+
+    /**
+     * @brief 提交写请求
+     * @return 成功返回0，直接下发失败时返回-1，此时请求未被接管
+     */
+    int Write(NebdServerAioContext* aioctx);
+
+    /**
+     * @brief 下发与[offset, offset + length)重叠的暂存请求
+     */
+    void FlushOverlapped(off_t offset, size_t length);
+
+    /**
+     * @brief 下发所有暂存请求
+     */
+    void Flush();
+
+    /**
+     * @brief 合并后的请求返回
+     * @param ret: 后端返回值，小于0表示失败
+     */
+    static void OnWriteDone(MergedWrite* write, int ret);
+
+ private:
+    bool Mergeable(const MergedWrite* write,
+                   const NebdServerAioContext* aioctx) const;
+
+    void Append(MergedWrite* write, NebdServerAioContext* aioctx);
+
+    std::unique_ptr<MergedWrite> NewWrite(NebdServerAioContext* aioctx);
+
+    // 下发给后端，成功时请求的所有权转移给后端
+    bool Submit(MergedWrite* write);
+
+    // 下发给后端，失败时回调所有原始请求
+    void Dispatch(std::unique_ptr<MergedWrite> write);
+
+    // 一个合并请求结束，后端空闲时下发暂存的请求
+    void Release();
+
+    void ArmTimer(uint64_t seq);
+
+    static void OnTimer(void* arg);
+
+    void FlushIfSeq(uint64_t seq);
+
+ private:
+    const WriteMergeOption option_;
+    Submitter submitter_;
+
+    std::mutex mtx_;
+    // 暂存的写请求
+    std::unique_ptr<MergedWrite> pending_;
+    // 后端在途的合并请求数
+    uint32_t inflight_;
+    uint64_t seq_;
+};
+
+}  // namespace server
+}  // namespace nebd
+
+#endif  // NEBD_SRC_PART2_WRITE_MERGER_H_
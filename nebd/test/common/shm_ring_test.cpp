@@ -0,0 +1,215 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <thread>   // NOLINT
+
+#include "nebd/src/common/shm_ring.h"
+
+namespace nebd {
+namespace common {
+
+static std::string TestRingName() {
+    return "/nebd-ring-test-" + std::to_string(getpid());
+}
+
+TEST(ShmRingTest, CreateAndAttach) {
+    ShmRing client;
+    ShmRing server;
+    std::string name = TestRingName();
+
+    // depth必须是2的幂
+    ASSERT_EQ(-1, client.Create(name, 3, 4096));
+    ASSERT_EQ(-1, server.Attach(name));
+
+    ASSERT_EQ(0, client.Create(name, 4, 4096));
+    // 重复创建失败
+    ShmRing other;
+    ASSERT_EQ(-1, other.Create(name, 4, 4096));
+
+    ASSERT_EQ(0, server.Attach(name));
+    ASSERT_EQ(4u, server.Depth());
+    ASSERT_EQ(4096u, server.SlotSize());
+    ASSERT_EQ(getpid(), server.ClientPid());
+    ASSERT_EQ(0, client.ServerPid());
+    server.SetServerPid(12345);
+    ASSERT_EQ(12345, client.ServerPid());
+
+    // unlink之后已有映射仍然可用，但不能再attach
+    client.Unlink();
+    ShmRing late;
+    ASSERT_EQ(-1, late.Attach(name));
+
+    // arena在两端可见
+    memset(client.SlotBuffer(3), 'a', 4096);
+    ASSERT_EQ('a', server.SlotBuffer(3)[0]);
+    ASSERT_EQ('a', server.SlotBuffer(3)[4095]);
+}
+
+TEST(ShmRingTest, AttachValidateHeader) {
+    ShmRing client;
+    std::string name = TestRingName();
+    ASSERT_EQ(0, client.Create(name, 4, 4096));
+
+    // 直接修改共享内存中的header，depth位于magic和version之后
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    ASSERT_GE(fd, 0);
+    void* addr = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    close(fd);
+    ASSERT_NE(MAP_FAILED, addr);
+    uint32_t* depth = static_cast<uint32_t*>(addr) + 2;
+    uint64_t* sqOffset = reinterpret_cast<uint64_t*>(depth + 2);
+
+    // 与共享内存大小不一致的depth
+    *depth = 2;
+    ShmRing server;
+    ASSERT_EQ(-1, server.Attach(name));
+    *depth = 4;
+
+    // 越界的队列偏移
+    uint64_t origin = *sqOffset;
+    *sqOffset = 1ULL << 40;
+    ASSERT_EQ(-1, server.Attach(name));
+    *sqOffset = origin;
+
+    // attach之后再修改header不影响已经映射的ring
+    ASSERT_EQ(0, server.Attach(name));
+    *depth = 1024;
+    ASSERT_EQ(4u, server.Depth());
+    ASSERT_EQ(4096u, server.SlotSize());
+    for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(client.PushSqe({0, i, 0, 0}));
+    }
+    ShmRingSqe sqe;
+    for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(server.PopSqe(&sqe));
+        ASSERT_EQ(i, sqe.tag);
+    }
+    ASSERT_FALSE(server.PopSqe(&sqe));
+
+    munmap(addr, 4096);
+    client.Unlink();
+}
+
+TEST(ShmRingTest, PushAndPop) {
+    ShmRing client;
+    ShmRing server;
+    std::string name = TestRingName();
+    ASSERT_EQ(0, client.Create(name, 4, 512));
+    ASSERT_EQ(0, server.Attach(name));
+    client.Unlink();
+
+    ShmRingSqe sqe;
+    ASSERT_FALSE(server.PopSqe(&sqe));
+    ASSERT_FALSE(server.WaitSqe(1));
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        ShmRingSqe in{static_cast<uint32_t>(ShmRingOp::kWrite), i,
+                      i * 512ull, 512};
+        ASSERT_TRUE(client.PushSqe(in));
+    }
+    // 队列已满
+    ASSERT_FALSE(client.PushSqe({0, 0, 0, 0}));
+
+    ASSERT_TRUE(server.WaitSqe(1));
+    for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(server.PopSqe(&sqe));
+        ASSERT_EQ(static_cast<uint32_t>(ShmRingOp::kWrite), sqe.op);
+        ASSERT_EQ(i, sqe.tag);
+        ASSERT_EQ(i * 512ull, sqe.offset);
+        ASSERT_EQ(512ull, sqe.length);
+        ASSERT_TRUE(server.PushCqe({sqe.tag, 0}));
+    }
+    ASSERT_FALSE(server.PopSqe(&sqe));
+
+    ShmRingCqe cqe;
+    for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(client.PopCqe(&cqe));
+        ASSERT_EQ(i, cqe.tag);
+        ASSERT_EQ(0, cqe.ret);
+    }
+    ASSERT_FALSE(client.PopCqe(&cqe));
+}
+
+TEST(ShmRingTest, WaitAndWakeup) {
+    ShmRing client;
+    ShmRing server;
+    std::string name = TestRingName();
+    ASSERT_EQ(0, client.Create(name, 64, 512));
+    ASSERT_EQ(0, server.Attach(name));
+    client.Unlink();
+
+    const uint32_t kCount = 100000;
+    std::thread consumer([&server, kCount]() {
+        uint32_t received = 0;
+        ShmRingSqe sqe;
+        while (received < kCount) {
+            if (!server.WaitSqe(1000)) {
+                continue;
+            }
+            while (server.PopSqe(&sqe)) {
+                ASSERT_EQ(received, sqe.offset);
+                ASSERT_TRUE(server.PushCqe({sqe.tag, 0}));
+                ++received;
+            }
+        }
+    });
+
+    uint32_t inflight = 0;
+    uint32_t completed = 0;
+    ShmRingCqe cqe;
+    for (uint32_t i = 0; i < kCount; ++i) {
+        while (inflight == client.Depth()) {
+            client.WaitCqe(1000);
+            while (client.PopCqe(&cqe)) {
+                --inflight;
+                ++completed;
+            }
+        }
+        ASSERT_TRUE(client.PushSqe({0, i % client.Depth(), i, 0}));
+        ++inflight;
+    }
+    while (completed < kCount) {
+        client.WaitCqe(1000);
+        while (client.PopCqe(&cqe)) {
+            ++completed;
+        }
+    }
+    consumer.join();
+
+    // 没有数据时Wakeup可以提前唤醒等待者
+    std::thread waiter([&server]() {
+        ASSERT_FALSE(server.WaitSqe(10000));
+    });
+    usleep(100 * 1000);
+    client.Wakeup();
+    waiter.join();
+}
+
+}  // namespace common
+}  // namespace nebd
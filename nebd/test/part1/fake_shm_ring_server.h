@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#ifndef NEBD_TEST_PART1_FAKE_SHM_RING_SERVER_H_
+#define NEBD_TEST_PART1_FAKE_SHM_RING_SERVER_H_
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "nebd/src/common/shm_ring.h"
+
+namespace nebd {
+namespace client {
+
+// 模拟part2：从sq中取出请求后立即完成，读请求以offset填充数据
+class FakeRingServer {
+ public:
+    int Start(const std::string& name) {
+        if (ring_.Attach(name) != 0) {
+            return -1;
+        }
+        ring_.SetServerPid(getpid());
+        running_ = true;
+        thread_ = std::thread(&FakeRingServer::Run, this);
+        return 0;
+    }
+
+    void Stop() {
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        ring_.Wakeup();
+        thread_.join();
+        ring_.Detach();
+    }
+
+    void SetRet(int32_t ret) {
+        ret_ = ret;
+    }
+
+    // 模拟part2停止处理ring，之后不再返回结果
+    void Break() {
+        broken_ = true;
+        ring_.SetServerPid(nebd::common::kShmRingServerBroken);
+    }
+
+    std::atomic<uint64_t> sqeCount{0};
+    std::atomic<uint64_t> writeBytes{0};
+
+ private:
+    void Run() {
+        nebd::common::ShmRingSqe sqe;
+        while (running_) {
+            if (!ring_.WaitSqe(100)) {
+                continue;
+            }
+            while (ring_.PopSqe(&sqe)) {
+                ++sqeCount;
+                if (sqe.op ==
+                    static_cast<uint32_t>(nebd::common::ShmRingOp::kRead)) {
+                    memset(ring_.SlotBuffer(sqe.tag),
+                           static_cast<int>(sqe.offset % 256), sqe.length);
+                } else {
+                    writeBytes += sqe.length;
+                }
+                if (!broken_) {
+                    ring_.PushCqe({sqe.tag, ret_.load()});
+                }
+            }
+        }
+    }
+
+    nebd::common::ShmRing ring_;
+    std::atomic<bool> running_{false};
+    std::atomic<int32_t> ret_{nebd::common::kShmRingRetOk};
+    std::atomic<bool> broken_{false};
+    std::thread thread_;
+};
+
+}  // namespace client
+}  // namespace nebd
+
+#endif  // NEBD_TEST_PART1_FAKE_SHM_RING_SERVER_H_
@@ -33,6 +33,7 @@
 #include "nebd/src/part1/libnebd_file.h"
 
 #include "nebd/test/part1/fake_file_service.h"
+#include "nebd/test/part1/fake_shm_ring_server.h"
 #include "nebd/test/part1/mock_file_service.h"
 #include "nebd/test/utils/config_generator.h"
 
@@ -40,6 +41,8 @@ const char* kFileName = "nebd-test-filename";
 const char* kFileNameWithSlash = "nebd-test-filenae//filename";
 const char* kNebdServerTestAddress = "./nebd-client-test.sock";
 const char* kNebdClientConf = "./nebd/test/part1/nebd-client-test.conf";
+const char* kNebdClientRingConf =
+    "./nebd/test/part1/nebd-client-ring-test.conf";
 const int64_t kFileSize = 10LL * 1024 * 1024 * 1024;
 const int64_t kBufSize = 1024;
 
@@ -567,6 +570,89 @@ TEST_F(NebdFileClientTest, ResponseFailTest) {
     StopServer();
 }
 
+TEST_F(NebdFileClientTest, ShmRingResubmitTest) {
+    AddMockService();
+    StartServer();
+
+    ASSERT_EQ(0, Init4Nebd(kNebdClientRingConf));
+
+    // part2 attach part1创建的ring
+    FakeRingServer ringServer;
+    EXPECT_CALL(mockService, OpenFile(_, _, _, _))
+        .Times(1)
+        .WillOnce(Invoke([&ringServer](
+                      google::protobuf::RpcController* cntl,
+                      const OpenFileRequest* request,
+                      OpenFileResponse* response,
+                      google::protobuf::Closure* done) {
+            brpc::ClosureGuard doneGuard(done);
+            response->set_retcode(RetCode::kOK);
+            response->set_fd(1);
+            response->set_shmattached(
+                ringServer.Start(request->shmname()) == 0);
+        }));
+    int fd = Open4Nebd(kFileName, nullptr);
+    ASSERT_EQ(1, fd);
+
+    WriteResponse response;
+    response.set_retcode(RetCode::kOK);
+    EXPECT_CALL(mockService, Write(_, _, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(
+            SetArgPointee<2>(response),
+            Invoke(MockClientFunc<WriteRequest, WriteResponse>)));
+
+    char buffer[kBufSize];
+    auto aioWrite = [&buffer, fd]() {
+        NebdClientAioContext* ctx = new NebdClientAioContext();
+        ctx->buf = buffer;
+        ctx->offset = 0;
+        ctx->length = kBufSize;
+        ctx->ret = -1;
+        ctx->op = LIBAIO_OP_WRITE;
+        ctx->cb = AioCallBack;
+        ctx->retryCount = 0;
+
+        aioOpReturn = false;
+        ASSERT_EQ(0, AioWrite4Nebd(fd, ctx));
+        std::unique_lock<std::mutex> ulk(mtx);
+        cond.wait(ulk, []() { return aioOpReturn.load(); });
+    };
+
+    // part2要求重提，请求间隔rpcRetryIntervalUs后只通过rpc重新提交，
+    // 不会再次进入ring
+    {
+        ringServer.SetRet(nebd::common::kShmRingRetResubmit);
+        auto start = std::chrono::steady_clock::now();
+        aioWrite();
+        auto end = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            end - start).count();
+        ASSERT_GE(elapsed, 100);
+        ASSERT_EQ(1, ringServer.sqeCount.load());
+    }
+
+    // part2停止处理ring，在途请求同样通过rpc重新提交
+    {
+        ringServer.SetRet(nebd::common::kShmRingRetOk);
+        ringServer.Break();
+        aioWrite();
+    }
+
+    CloseFileResponse closeResponse;
+    closeResponse.set_retcode(RetCode::kOK);
+    EXPECT_CALL(mockService, CloseFile(_, _, _, _))
+        .Times(1)
+        .WillOnce(DoAll(
+            SetArgPointee<2>(closeResponse),
+            Invoke(MockClientFunc<CloseFileRequest, CloseFileResponse>)));
+    ASSERT_EQ(0, Close4Nebd(fd));
+    ringServer.Stop();
+
+    ASSERT_NO_THROW(Uninit4Nebd());
+    StopServer();
+}
+
 TEST_F(NebdFileClientTest, InitAndUninitTest) {
     ASSERT_NO_FATAL_FAILURE(nebdClient.Uninit());
 
@@ -597,6 +683,12 @@ int main(int argc, char* argv[]) {
     generator.SetConfigOptions(nebdConfig);
     generator.Generate();
 
+    nebdConfig.emplace_back("ring.enable=true");
+    nebd::common::NebdClientConfigGenerator ringGenerator;
+    ringGenerator.SetConfigPath(kNebdClientRingConf);
+    ringGenerator.SetConfigOptions(nebdConfig);
+    ringGenerator.Generate();
+
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
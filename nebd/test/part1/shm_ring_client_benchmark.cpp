@@ -0,0 +1,255 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#include <brpc/channel.h>
+#include <brpc/closure_guard.h>
+#include <brpc/controller.h>
+#include <brpc/server.h>
+#include <butil/time.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <random>
+#include <vector>
+
+#include "nebd/proto/client.pb.h"
+#include "nebd/src/part1/shm_ring_client.h"
+#include "nebd/test/part1/fake_shm_ring_server.h"
+
+namespace nebd {
+namespace client {
+
+const char* kShmRingBenchAddress = "./nebd-shm-ring-bench.sock";
+const uint32_t kBlockSize = 4096;
+const uint64_t kFileSize = 1ULL * 1024 * 1024 * 1024;
+
+// rpc路径的模拟part2，请求到达后立即返回
+class BenchFileService : public NebdFileService {
+ public:
+    void Read(::google::protobuf::RpcController* controller,
+              const ::nebd::client::ReadRequest* request,
+              ::nebd::client::ReadResponse* response,
+              ::google::protobuf::Closure* done) override {
+        brpc::ClosureGuard doneGuard(done);
+        brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+        cntl->response_attachment().append(buffer_, request->size());
+        response->set_retcode(RetCode::kOK);
+    }
+
+    void Write(::google::protobuf::RpcController* controller,
+               const ::nebd::client::WriteRequest* request,
+               ::nebd::client::WriteResponse* response,
+               ::google::protobuf::Closure* done) override {
+        brpc::ClosureGuard doneGuard(done);
+        response->set_retcode(RetCode::kOK);
+    }
+
+ private:
+    char buffer_[kBlockSize] = {0};
+};
+
+// 保持队列深度不变的压测驱动，请求完成后立即提交下一个
+class BenchDriver {
+ public:
+    using SubmitFunc = std::function<void(NebdClientAioContext*)>;
+
+    struct Context {
+        NebdClientAioContext ctx;
+        BenchDriver* driver;
+        uint64_t startUs;
+        char buf[kBlockSize];
+    };
+
+    BenchDriver(LIBAIO_OP op, uint32_t depth, uint64_t total)
+        : op_(op), total_(total), contexts_(depth) {}
+
+    void Run(const SubmitFunc& submit) {
+        submit_ = submit;
+        uint64_t start = butil::gettimeofday_us();
+        for (auto& c : contexts_) {
+            c.driver = this;
+            c.ctx.length = kBlockSize;
+            c.ctx.op = op_;
+            c.ctx.cb = &BenchDriver::OnComplete;
+            c.ctx.buf = c.buf;
+            SubmitOne(&c);
+        }
+
+        std::unique_lock<std::mutex> lk(mtx_);
+        cv_.wait(lk, [this]() { return completed_ == total_; });
+        elapsedUs_ = butil::gettimeofday_us() - start;
+    }
+
+    double Iops() const {
+        return total_ * 1000000.0 / elapsedUs_;
+    }
+
+    double AvgLatencyUs() const {
+        return static_cast<double>(latencyUs_.load()) / total_;
+    }
+
+ private:
+    void SubmitOne(Context* c) {
+        if (submitted_.fetch_add(1) >= total_) {
+            return;
+        }
+        thread_local std::mt19937_64 rng(std::random_device{}());
+        c->ctx.offset = rng() % (kFileSize / kBlockSize) * kBlockSize;
+        c->ctx.ret = -1;
+        c->startUs = butil::gettimeofday_us();
+        submit_(&c->ctx);
+    }
+
+    static void OnComplete(NebdClientAioContext* ctx) {
+        Context* c = reinterpret_cast<Context*>(ctx);
+        BenchDriver* driver = c->driver;
+        ASSERT_EQ(0, ctx->ret);
+        driver->latencyUs_ += butil::gettimeofday_us() - c->startUs;
+        if (++driver->completed_ == driver->total_) {
+            std::lock_guard<std::mutex> lk(driver->mtx_);
+            driver->cv_.notify_one();
+            return;
+        }
+        driver->SubmitOne(c);
+    }
+
+    LIBAIO_OP op_;
+    uint64_t total_;
+    std::vector<Context> contexts_;
+    SubmitFunc submit_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> latencyUs_{0};
+    uint64_t elapsedUs_ = 0;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+};
+
+struct RpcBenchDone : public google::protobuf::Closure {
+    void Run() override {
+        std::unique_ptr<RpcBenchDone> selfGuard(this);
+        ctx->ret = (!cntl.Failed() && retCode() == RetCode::kOK) ? 0 : -1;
+        if (ctx->ret == 0 && ctx->op == LIBAIO_OP::LIBAIO_OP_READ) {
+            cntl.response_attachment().copy_to(ctx->buf, ctx->length);
+        }
+        ctx->cb(ctx);
+    }
+
+    RetCode retCode() const {
+        return ctx->op == LIBAIO_OP::LIBAIO_OP_READ ? readResponse.retcode()
+                                                    : writeResponse.retcode();
+    }
+
+    NebdClientAioContext* ctx;
+    brpc::Controller cntl;
+    ReadResponse readResponse;
+    WriteResponse writeResponse;
+};
+
+static void EmptyDeleter(void* m) {}
+
+// 与NebdClient的rpc路径一致：异步rpc，写数据零拷贝放入attachment
+static void SubmitByRpc(brpc::Channel* channel, NebdClientAioContext* ctx) {
+    NebdFileService_Stub stub(channel);
+    RpcBenchDone* done = new RpcBenchDone();
+    done->ctx = ctx;
+    done->cntl.set_timeout_ms(-1);
+    if (ctx->op == LIBAIO_OP::LIBAIO_OP_READ) {
+        ReadRequest request;
+        request.set_fd(1);
+        request.set_offset(ctx->offset);
+        request.set_size(ctx->length);
+        stub.Read(&done->cntl, &request, &done->readResponse, done);
+    } else {
+        WriteRequest request;
+        request.set_fd(1);
+        request.set_offset(ctx->offset);
+        request.set_size(ctx->length);
+        done->cntl.request_attachment().append_user_data(
+            ctx->buf, ctx->length, EmptyDeleter);
+        stub.Write(&done->cntl, &request, &done->writeResponse, done);
+    }
+}
+
+// 4K随机读写在unix socket rpc与共享内存ring两种传输下的对比，
+// 两端都不访问存储，仅衡量part1与part2之间的传输开销
+TEST(ShmRingClientBenchmark, AgainstRpc) {
+    const uint64_t kTotal = 200000;
+    const uint32_t kDepths[] = {1, 32};
+    const LIBAIO_OP kOps[] = {LIBAIO_OP::LIBAIO_OP_READ,
+                              LIBAIO_OP::LIBAIO_OP_WRITE};
+
+    unlink(kShmRingBenchAddress);
+    brpc::Server server;
+    BenchFileService service;
+    ASSERT_EQ(0, server.AddService(&service,
+                                   brpc::SERVER_DOESNT_OWN_SERVICE));
+    ASSERT_EQ(0, server.StartAtSockFile(kShmRingBenchAddress, nullptr));
+    brpc::Channel channel;
+    ASSERT_EQ(0, channel.InitWithSockFile(kShmRingBenchAddress, nullptr));
+
+    RingOption option;
+    option.enable = true;
+    option.depth = 64;
+    option.slotSize = kBlockSize;
+    ShmRingClient ring;
+    ASSERT_EQ(0, ring.Init(option));
+    FakeRingServer ringServer;
+    ASSERT_EQ(0, ringServer.Start(ring.Name()));
+    ring.Start([](NebdClientAioContext*) { FAIL(); });
+
+    printf("%-6s %-6s %-12s %-14s %-12s %-14s\n", "op", "depth",
+           "rpc iops", "rpc lat(us)", "ring iops", "ring lat(us)");
+    for (auto op : kOps) {
+        for (auto depth : kDepths) {
+            BenchDriver rpc(op, depth, kTotal);
+            rpc.Run([&channel](NebdClientAioContext* ctx) {
+                SubmitByRpc(&channel, ctx);
+            });
+
+            BenchDriver shm(op, depth, kTotal);
+            shm.Run([&ring](NebdClientAioContext* ctx) {
+                ASSERT_TRUE(ring.Submit(ctx));
+            });
+
+            printf("%-6s %-6u %-12.0f %-14.1f %-12.0f %-14.1f\n",
+                   op == LIBAIO_OP::LIBAIO_OP_READ ? "read" : "write",
+                   depth, rpc.Iops(), rpc.AvgLatencyUs(), shm.Iops(),
+                   shm.AvgLatencyUs());
+        }
+    }
+
+    ringServer.Stop();
+    ring.Stop();
+    server.Stop(0);
+    server.Join();
+    unlink(kShmRingBenchAddress);
+}
+
+}  // namespace client
+}  // namespace nebd
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-16
+ */
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>  // NOLINT
+#include <mutex>   // NOLINT
+#include <string>
+#include <vector>
+
+#include "nebd/src/common/shm_ring.h"
+#include "nebd/src/part1/shm_ring_client.h"
+#include "nebd/test/part1/fake_shm_ring_server.h"
+
+namespace nebd {
+namespace client {
+
+using nebd::common::kShmRingRetError;
+using nebd::common::ShmRing;
+
+const uint32_t kBlockSize = 4096;
+
+struct TestAioContext {
+    NebdClientAioContext ctx;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool done = false;
+
+    void Wait() {
+        std::unique_lock<std::mutex> lk(mtx);
+        cv.wait(lk, [this]() { return done; });
+        done = false;
+    }
+};
+
+static void TestAioCallback(NebdClientAioContext* ctx) {
+    TestAioContext* tctx = reinterpret_cast<TestAioContext*>(ctx);
+    std::lock_guard<std::mutex> lk(tctx->mtx);
+    tctx->done = true;
+    tctx->cv.notify_one();
+}
+
+TEST(ShmRingClientTest, SubmitAndComplete) {
+    RingOption option;
+    option.enable = true;
+    option.depth = 2;
+    option.slotSize = kBlockSize;
+
+    ShmRingClient client;
+    ASSERT_EQ(0, client.Init(option));
+    FakeRingServer server;
+    ASSERT_EQ(0, server.Start(client.Name()));
+
+    std::vector<NebdClientAioContext*> fallbacks;
+    client.Start([&fallbacks](NebdClientAioContext* aioctx) {
+        fallbacks.push_back(aioctx);
+    });
+
+    char buf[2 * kBlockSize];
+    TestAioContext tctx;
+    tctx.ctx.offset = 3;
+    tctx.ctx.length = kBlockSize;
+    tctx.ctx.op = LIBAIO_OP::LIBAIO_OP_READ;
+    tctx.ctx.cb = TestAioCallback;
+    tctx.ctx.buf = buf;
+    tctx.ctx.ret = -1;
+
+    // 读请求返回后数据拷贝到用户buf
+    ASSERT_TRUE(client.Submit(&tctx.ctx));
+    tctx.Wait();
+    ASSERT_EQ(0, tctx.ctx.ret);
+    ASSERT_EQ(3, buf[0]);
+    ASSERT_EQ(3, buf[kBlockSize - 1]);
+
+    // 写请求
+    tctx.ctx.op = LIBAIO_OP::LIBAIO_OP_WRITE;
+    ASSERT_TRUE(client.Submit(&tctx.ctx));
+    tctx.Wait();
+    ASSERT_EQ(0, tctx.ctx.ret);
+    ASSERT_EQ(kBlockSize, server.writeBytes.load());
+
+    // 超过slot大小或者非读写请求走rpc
+    tctx.ctx.length = 2 * kBlockSize;
+    ASSERT_FALSE(client.Submit(&tctx.ctx));
+    tctx.ctx.length = kBlockSize;
+    tctx.ctx.op = LIBAIO_OP::LIBAIO_OP_FLUSH;
+    ASSERT_FALSE(client.Submit(&tctx.ctx));
+
+    // part2返回错误
+    server.SetRet(kShmRingRetError);
+    tctx.ctx.op = LIBAIO_OP::LIBAIO_OP_READ;
+    ASSERT_TRUE(client.Submit(&tctx.ctx));
+    tctx.Wait();
+    ASSERT_EQ(-1, tctx.ctx.ret);
+
+    server.Stop();
+    client.Stop();
+    ASSERT_TRUE(client.Broken());
+    ASSERT_TRUE(fallbacks.empty());
+}
+
+TEST(ShmRingClientTest, NotAttached) {
+    RingOption option;
+    option.depth = 4;
+    option.slotSize = kBlockSize;
+
+    std::string name;
+    {
+        ShmRingClient client;
+        ASSERT_EQ(0, client.Init(option));
+        name = client.Name();
+    }
+
+    // 未启动的ring析构时删除共享内存
+    ShmRing ring;
+    ASSERT_EQ(-1, ring.Attach(name));
+}
+
+}  // namespace client
+}  // namespace nebd
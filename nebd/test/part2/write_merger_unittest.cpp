@@ -0,0 +1,245 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-18
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "nebd/src/part2/write_merger.h"
+
+namespace nebd {
+namespace server {
+
+static std::mutex doneMtx;
+static std::vector<NebdServerAioContext*> doneRequests;
+
+static void WriteMergerTestCallback(NebdServerAioContext* context) {
+    std::lock_guard<std::mutex> lk(doneMtx);
+    doneRequests.push_back(context);
+}
+
+class WriteMergerTest : public ::testing::Test {
+ public:
+    void SetUp() override {
+        doneRequests.clear();
+        submitRet_ = 0;
+        option_.enable = true;
+        option_.windowUs = 0;
+        option_.maxBytes = 16;
+    }
+
+    void TearDown() override {
+        for (auto* write : submitted_) {
+            delete write;
+        }
+        submitted_.clear();
+    }
+
+    std::shared_ptr<WriteMerger> NewMerger() {
+        return std::make_shared<WriteMerger>(
+            option_, [this](MergedWrite* write) {
+                std::lock_guard<std::mutex> lk(submitMtx_);
+                if (submitRet_ == 0) {
+                    submitted_.push_back(write);
+                }
+                return submitRet_;
+            });
+    }
+
+    NebdServerAioContext* NewRequest(off_t offset, const std::string& data) {
+        contexts_.emplace_back(new NebdServerAioContext());
+        bufs_.emplace_back(new butil::IOBuf());
+        NebdServerAioContext* aioctx = contexts_.back().get();
+        aioctx->offset = offset;
+        aioctx->size = data.size();
+        aioctx->op = LIBAIO_OP::LIBAIO_OP_WRITE;
+        aioctx->cb = WriteMergerTestCallback;
+        bufs_.back()->append(data);
+        aioctx->buf = bufs_.back().get();
+        return aioctx;
+    }
+
+    MergedWrite* TakeSubmitted(size_t index) {
+        std::lock_guard<std::mutex> lk(submitMtx_);
+        MergedWrite* write = submitted_[index];
+        submitted_[index] = nullptr;
+        return write;
+    }
+
+    size_t SubmittedCount() {
+        std::lock_guard<std::mutex> lk(submitMtx_);
+        return submitted_.size();
+    }
+
+ protected:
+    WriteMergeOption option_;
+    int submitRet_;
+    std::mutex submitMtx_;
+    std::vector<MergedWrite*> submitted_;
+    std::vector<std::unique_ptr<NebdServerAioContext>> contexts_;
+    std::vector<std::unique_ptr<butil::IOBuf>> bufs_;
+};
+
+TEST_F(WriteMergerTest, MergeWhileBackendBusy) {
+    auto merger = NewMerger();
+
+    // 后端空闲时直接下发
+    auto* first = NewRequest(0, "aaaa");
+    ASSERT_EQ(0, merger->Write(first));
+    ASSERT_EQ(1, SubmittedCount());
+
+    // 后端忙时暂存并合并相邻请求
+    auto* r1 = NewRequest(4, "bbbb");
+    auto* r2 = NewRequest(8, "cccc");
+    auto* r3 = NewRequest(2, "dd");
+    ASSERT_EQ(0, merger->Write(r1));
+    ASSERT_EQ(0, merger->Write(r2));
+    ASSERT_EQ(0, merger->Write(r3));
+    ASSERT_EQ(1, SubmittedCount());
+
+    // 第一个请求返回后下发合并后的请求
+    WriteMerger::OnWriteDone(TakeSubmitted(0), 4);
+    ASSERT_EQ(1, doneRequests.size());
+    ASSERT_EQ(first, doneRequests[0]);
+    ASSERT_EQ(4, first->ret);
+    ASSERT_EQ(2, SubmittedCount());
+
+    MergedWrite* merged = TakeSubmitted(1);
+    ASSERT_EQ(2, merged->offset);
+    ASSERT_EQ(10, merged->length);
+    // 在前面相邻的请求同样可以合并
+    ASSERT_EQ("ddbbbbcccc", merged->data.to_string());
+    ASSERT_EQ(3, merged->requests.size());
+
+    WriteMerger::OnWriteDone(merged, 10);
+    ASSERT_EQ(4, doneRequests.size());
+    ASSERT_EQ(4, r1->ret);
+    ASSERT_EQ(4, r2->ret);
+    ASSERT_EQ(2, r3->ret);
+
+    // 后端再次空闲，请求直接下发
+    ASSERT_EQ(0, merger->Write(NewRequest(100, "x")));
+    ASSERT_EQ(3, SubmittedCount());
+    WriteMerger::OnWriteDone(TakeSubmitted(2), 1);
+}
+
+TEST_F(WriteMergerTest, OverlapInMiddle) {
+    auto merger = NewMerger();
+    ASSERT_EQ(0, merger->Write(NewRequest(100, "z")));
+
+    ASSERT_EQ(0, merger->Write(NewRequest(4, "aaaaaaaa")));
+    ASSERT_EQ(0, merger->Write(NewRequest(6, "bb")));
+    ASSERT_EQ(0, merger->Write(NewRequest(0, "cccc")));
+    merger->Flush();
+    ASSERT_EQ(2, SubmittedCount());
+
+    MergedWrite* merged = TakeSubmitted(1);
+    ASSERT_EQ(0, merged->offset);
+    ASSERT_EQ("ccccaabbaaaa", merged->data.to_string());
+    WriteMerger::OnWriteDone(merged, 12);
+    WriteMerger::OnWriteDone(TakeSubmitted(0), 1);
+    ASSERT_EQ(4, doneRequests.size());
+}
+
+TEST_F(WriteMergerTest, FlushPendingRequests) {
+    auto merger = NewMerger();
+    ASSERT_EQ(0, merger->Write(NewRequest(100, "z")));
+
+    // 不相邻的请求触发下发
+    ASSERT_EQ(0, merger->Write(NewRequest(0, "aaaa")));
+    ASSERT_EQ(0, merger->Write(NewRequest(8, "bbbb")));
+    ASSERT_EQ(2, SubmittedCount());
+    ASSERT_EQ(0, submitted_[1]->offset);
+
+    // 合并长度达到maxBytes时下发
+    ASSERT_EQ(0, merger->Write(NewRequest(12, "cccc")));
+    ASSERT_EQ(2, SubmittedCount());
+    ASSERT_EQ(0, merger->Write(NewRequest(16, "dddddddd")));
+    ASSERT_EQ(3, SubmittedCount());
+    ASSERT_EQ(8, submitted_[2]->offset);
+    ASSERT_EQ(16, submitted_[2]->length);
+
+    // 合并后超过maxBytes的请求不合并
+    ASSERT_EQ(0, merger->Write(NewRequest(24, "eeee")));
+    ASSERT_EQ(0, merger->Write(NewRequest(28, std::string(14, 'f'))));
+    ASSERT_EQ(4, SubmittedCount());
+    ASSERT_EQ(24, submitted_[3]->offset);
+    ASSERT_EQ(4, submitted_[3]->length);
+
+    // 重叠的读请求触发下发
+    merger->FlushOverlapped(0, 28);
+    ASSERT_EQ(4, SubmittedCount());
+    merger->FlushOverlapped(41, 1);
+    ASSERT_EQ(5, SubmittedCount());
+    ASSERT_EQ(28, submitted_[4]->offset);
+
+    for (size_t i = 0; i < 5; ++i) {
+        MergedWrite* write = TakeSubmitted(i);
+        WriteMerger::OnWriteDone(write, write->length);
+    }
+    ASSERT_EQ(7, doneRequests.size());
+}
+
+TEST_F(WriteMergerTest, FlushAfterWindow) {
+    option_.windowUs = 1000;
+    auto merger = NewMerger();
+    ASSERT_EQ(0, merger->Write(NewRequest(100, "z")));
+    ASSERT_EQ(0, merger->Write(NewRequest(0, "aaaa")));
+    ASSERT_EQ(1, SubmittedCount());
+
+    // 后端请求未返回，等待时间超过窗口后下发
+    for (int i = 0; i < 100 && SubmittedCount() < 2; ++i) {
+        usleep(10 * 1000);
+    }
+    ASSERT_EQ(2, SubmittedCount());
+    WriteMerger::OnWriteDone(TakeSubmitted(0), 1);
+    WriteMerger::OnWriteDone(TakeSubmitted(1), 4);
+    ASSERT_EQ(2, doneRequests.size());
+}
+
+TEST_F(WriteMergerTest, SubmitFailed) {
+    auto merger = NewMerger();
+
+    // 直接下发失败时请求交还给调用方
+    submitRet_ = -1;
+    auto* direct = NewRequest(0, "aaaa");
+    ASSERT_EQ(-1, merger->Write(direct));
+    ASSERT_TRUE(doneRequests.empty());
+
+    submitRet_ = 0;
+    ASSERT_EQ(0, merger->Write(NewRequest(100, "z")));
+    auto* pending = NewRequest(0, "aaaa");
+    ASSERT_EQ(0, merger->Write(pending));
+
+    // 暂存请求下发失败时回调错误
+    submitRet_ = -1;
+    WriteMerger::OnWriteDone(TakeSubmitted(0), 1);
+    ASSERT_EQ(2, doneRequests.size());
+    ASSERT_EQ(pending, doneRequests[1]);
+    ASSERT_EQ(-1, pending->ret);
+}
+
+}  // namespace server
+}  // namespace nebd
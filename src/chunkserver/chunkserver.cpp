@@ -37,12 +37,14 @@
 #include "src/chunkserver/braft_cli_service.h"
 #include "src/chunkserver/braft_cli_service2.h"
 #include "src/chunkserver/chunkserver_helper.h"
+#include "src/chunkserver/datastore/define.h"
 #include "src/common/concurrent/task_thread_pool.h"
 #include "src/common/uri_parser.h"
 #include "src/chunkserver/raftsnapshot/curve_snapshot_attachment.h"
 #include "src/chunkserver/raftsnapshot/curve_file_service.h"
 #include "src/chunkserver/raftsnapshot/curve_snapshot_storage.h"
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
+#include "src/chunkserver/raftlog/shared_wal_log_storage.h"
 #include "src/common/curve_version.h"
 
 using ::curve::fs::LocalFileSystem;
@@ -85,6 +87,7 @@ int ChunkServer::Run(int argc, char** argv) {
     gflags::ParseCommandLineFlags(&argc, &argv, true);
 
     RegisterCurveSegmentLogStorageOrDie();
+    RegisterSharedWalLogStorageOrDie();
 
     // ==========================加载配置项===============================//
     LOG(INFO) << "Loading Configuration.";
@@ -129,11 +132,16 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to initialize concurrentapply module!";
 
     // 初始化本地文件系统
-    std::shared_ptr<LocalFileSystem> fs(
-        LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));
+    bool enableIOUring;
+    LOG_IF(FATAL, !conf.GetBoolValue("fs.enable_io_uring", &enableIOUring));
+    std::shared_ptr<LocalFileSystem> fs(LocalFsFactory::CreateFs(
+        enableIOUring ? FileSystemType::EXT4_IOURING : FileSystemType::EXT4,
+        ""));
     LocalFileSystemOption lfsOption;
     LOG_IF(FATAL, !conf.GetBoolValue(
         "fs.enable_renameat2", &lfsOption.enableRenameat2));
+    LOG_IF(FATAL, !conf.GetUInt32Value(
+        "fs.io_uring_queue_depth", &lfsOption.ioUringQueueDepth));
     LOG_IF(FATAL, 0 != fs->Init(lfsOption))
         << "Failed to initialize local filesystem module!";
 
@@ -506,6 +514,17 @@ void ChunkServer::InitChunkFilePoolOptions(
             &chunkFilePoolOptions->bytesPerWrite));
         LOG_IF(FATAL, !conf->GetUInt32Value("chunkfilepool.clean.throttle_iops",
             &chunkFilePoolOptions->iops4clean));
+        LOG_IF(FATAL, !conf->GetBoolValue("chunkfilepool.clean.zero_range",
+            &chunkFilePoolOptions->cleanWithZeroRange));
+        LOG_IF(FATAL, !conf->GetUInt32Value(
+            "chunkfilepool.refill.low_watermark",
+            &chunkFilePoolOptions->refillLowWatermark));
+        LOG_IF(FATAL, !conf->GetUInt32Value(
+            "chunkfilepool.refill.high_watermark",
+            &chunkFilePoolOptions->refillHighWatermark));
+        LOG_IF(FATAL, !conf->GetUInt32Value(
+            "chunkfilepool.refill.reserve_percent",
+            &chunkFilePoolOptions->refillReservePercent));
 
         if (0 == chunkFilePoolOptions->bytesPerWrite
             || chunkFilePoolOptions->bytesPerWrite > 1 * 1024 * 1024
@@ -613,6 +632,19 @@ void ChunkServer::InitCopysetNodeOptions(
         LOG_IF(FATAL, !conf->GetUInt32Value("copyset.sync_trigger_seconds",
                 &copysetNodeOptions->syncTriggerSeconds));
     }
+
+    // crc表在不开O_DSYNC时随chunk sync持久化，开O_DSYNC时随每次写持久化
+    LOG_IF(FATAL, !conf->GetUInt32Value("copyset.data_crc_block_size",
+            &copysetNodeOptions->dataCrcBlockSize));
+    uint32_t blockSize = copysetNodeOptions->dataCrcBlockSize;
+    uint32_t chunkSize = copysetNodeOptions->maxChunkSize;
+    LOG_IF(FATAL, blockSize != 0 &&
+        (blockSize % copysetNodeOptions->pageSize != 0 ||
+         chunkSize % blockSize != 0 ||
+         chunkSize / blockSize > kMaxBlockCrcNum))
+        << "Invalid copyset.data_crc_block_size: " << blockSize
+        << ", it must be a multiple of page size and divide chunk size"
+        << " into no more than " << kMaxBlockCrcNum << " blocks";
 }
 
 void ChunkServer::InitCopyerOptions(
@@ -661,6 +693,8 @@ void ChunkServer::InitScanOptions(
         &scanOptions->intervalSec));
     LOG_IF(FATAL, !conf->GetUInt64Value("copyset.scan_size_byte",
         &scanOptions->scanSize));
+    LOG_IF(FATAL, !conf->GetUInt64Value("copyset.full_scan_interval_sec",
+        &scanOptions->fullScanIntervalSec));
     LOG_IF(FATAL, !conf->GetUInt32Value("global.meta_page_size",
         &scanOptions->chunkMetaPageSize));
     LOG_IF(FATAL, !conf->GetUInt64Value("copyset.scan_rpc_timeout_ms",
@@ -220,6 +220,7 @@ void CSCopysetMetric::MonitorCurveSegmentLogStorage(
     std::string walSegmentCountPrefix = Prefix() + "_walsegment_count";
     walSegmentCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         walSegmentCountPrefix, GetLogStorageWalSegmentCountFunc, logStorage);
+    logStorage->GetSyncLatencyRecorder()->expose(Prefix(), "wal_sync");
 }
 
 ChunkServerMetric::ChunkServerMetric()
@@ -392,6 +393,13 @@ void ChunkServerMetric::MonitorChunkFilePool(FilePool* chunkFilePool) {
     std::string chunkLeftPrefix = Prefix() + "_chunkfilepool_left";
     chunkLeft_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         chunkLeftPrefix, GetChunkLeftFunc, chunkFilePool);
+
+    FilePoolMetricPtr poolMetric = chunkFilePool->GetMetric();
+    std::string poolPrefix = Prefix() + "_chunkfilepool";
+    poolMetric->getFileHit.expose_as(poolPrefix, "get_hit");
+    poolMetric->getFileMiss.expose_as(poolPrefix, "get_miss");
+    poolMetric->getFileLatency.expose(poolPrefix, "get_lat");
+    poolMetric->refilledFiles.expose_as(poolPrefix, "refilled");
 }
 
 void ChunkServerMetric::MonitorWalFilePool(FilePool* walFilePool) {
@@ -27,6 +27,9 @@
 namespace curve {
 namespace chunkserver {
 
+// 缓存的压缩对象头部数量
+static const uint64_t kCompressedHeaderCacheCount = 4096;
+
 std::ostream& operator<<(std::ostream& out, const AsyncDownloadContext& rhs) {
     out  << "{ location: " << rhs.location
         << ", offset: " << rhs.offset
@@ -84,7 +87,8 @@ void OriginCopyer::DeleteExpiredCurveCache(void* arg) {
 
 OriginCopyer::OriginCopyer()
     : curveClient_(nullptr)
-    , s3Client_(nullptr) {}
+    , s3Client_(nullptr)
+    , compressedHeaders_(kCompressedHeaderCacheCount) {}
 
 int OriginCopyer::Init(const CopyerOptions& options) {
     curveFileTimeoutSec_ = options.curveFileTimeoutSec;
@@ -163,6 +167,11 @@ void OriginCopyer::DownloadAsync(DownloadClosure* done) {
                        context->size, context->buf,
                        done);
         doneGuard.release();
+    } else if (type == OriginType::CompressedS3Origin) {
+        DownloadFromCompressedS3(originPath, context->offset,
+                                 context->size, context->buf,
+                                 done);
+        doneGuard.release();
     } else {
         LOG(ERROR) << "Unknown origin location."
                    << "location: " << context->location;
@@ -203,6 +212,151 @@ void OriginCopyer::DownloadFromS3(const string& objectName,
     doneGuard.release();
 }
 
+void OriginCopyer::DownloadFromCompressedS3(const string& objectName,
+                                           off_t off,
+                                           size_t size,
+                                           char* buf,
+                                           DownloadClosure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    if (s3Client_ == nullptr) {
+        LOG(ERROR) << "Failed to get s3 object."
+                   << "s3 adapter is disabled";
+        done->SetFailed();
+        return;
+    }
+
+    std::shared_ptr<CompressedObject> header;
+    if (compressedHeaders_.Get(objectName, &header)) {
+        ReadCompressedFrames(objectName, header, off, size, buf, done);
+        doneGuard.release();
+        return;
+    }
+
+    auto headerBuf = std::make_shared<std::string>(
+        CompressedObject::kFixedHeaderSize, '\0');
+    GetObjectAsyncCallBack cb =
+        [=] (const S3Adapter* adapter,
+             const std::shared_ptr<GetObjectAsyncContext>& context) {
+            brpc::ClosureGuard doneGuard(done);
+            auto parsed = std::make_shared<CompressedObject>();
+            if (context->retCode != 0 ||
+                !parsed->ParseFixedHeader(headerBuf->data(),
+                                          headerBuf->size())) {
+                LOG(ERROR) << "Read compressed object header failed."
+                           << "object name: " << objectName
+                           << " ,return code: " << context->retCode;
+                done->SetFailed();
+                return;
+            }
+            ReadCompressedFrameTable(objectName, parsed, off, size, buf,
+                                     done);
+            doneGuard.release();
+        };
+
+    auto context = std::make_shared<GetObjectAsyncContext>();
+    context->key = objectName;
+    context->buf = &(*headerBuf)[0];
+    context->offset = 0;
+    context->len = headerBuf->size();
+    context->cb = cb;
+
+    s3Client_->GetObjectAsync(context);
+    doneGuard.release();
+}
+
+void OriginCopyer::ReadCompressedFrameTable(
+    const string& objectName,
+    std::shared_ptr<CompressedObject> header,
+    off_t off,
+    size_t size,
+    char* buf,
+    DownloadClosure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    if (header->FrameTableSize() == 0) {
+        // 对象中没有数据
+        LOG(ERROR) << "Compressed object is empty."
+                   << "object name: " << objectName;
+        done->SetFailed();
+        return;
+    }
+
+    auto tableBuf = std::make_shared<std::string>(
+        header->FrameTableSize(), '\0');
+    GetObjectAsyncCallBack cb =
+        [=] (const S3Adapter* adapter,
+             const std::shared_ptr<GetObjectAsyncContext>& context) {
+            brpc::ClosureGuard doneGuard(done);
+            if (context->retCode != 0 ||
+                !header->ParseFrameTable(tableBuf->data(),
+                                         tableBuf->size())) {
+                LOG(ERROR) << "Read compressed object frame table failed."
+                           << "object name: " << objectName
+                           << " ,return code: " << context->retCode;
+                done->SetFailed();
+                return;
+            }
+            compressedHeaders_.Put(objectName, header);
+            ReadCompressedFrames(objectName, header, off, size, buf, done);
+            doneGuard.release();
+        };
+
+    auto context = std::make_shared<GetObjectAsyncContext>();
+    context->key = objectName;
+    context->buf = &(*tableBuf)[0];
+    context->offset = CompressedObject::kFixedHeaderSize;
+    context->len = tableBuf->size();
+    context->cb = cb;
+
+    s3Client_->GetObjectAsync(context);
+    doneGuard.release();
+}
+
+void OriginCopyer::ReadCompressedFrames(
+    const string& objectName,
+    std::shared_ptr<CompressedObject> header,
+    off_t off,
+    size_t size,
+    char* buf,
+    DownloadClosure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    uint64_t objOffset = 0;
+    uint64_t objLen = 0;
+    if (!header->GetFrameRange(off, size, &objOffset, &objLen)) {
+        LOG(ERROR) << "Download range exceeds compressed object."
+                   << "object name: " << objectName
+                   << " ,offset: " << off
+                   << " ,size: " << size
+                   << " ,raw length: " << header->GetRawLength();
+        done->SetFailed();
+        return;
+    }
+
+    auto frames = std::make_shared<std::string>(objLen, '\0');
+    GetObjectAsyncCallBack cb =
+        [=] (const S3Adapter* adapter,
+             const std::shared_ptr<GetObjectAsyncContext>& context) {
+            brpc::ClosureGuard doneGuard(done);
+            if (context->retCode != 0 ||
+                !header->DecodeRange(frames->data(), frames->size(),
+                                     off, size, buf)) {
+                LOG(ERROR) << "Read compressed object failed."
+                           << "object name: " << objectName
+                           << " ,return code: " << context->retCode;
+                done->SetFailed();
+            }
+        };
+
+    auto context = std::make_shared<GetObjectAsyncContext>();
+    context->key = objectName;
+    context->buf = &(*frames)[0];
+    context->offset = objOffset;
+    context->len = objLen;
+    context->cb = cb;
+
+    s3Client_->GetObjectAsync(context);
+    doneGuard.release();
+}
+
 void OriginCopyer::DownloadFromCurve(const string& fileName,
                                     off_t off,
                                     size_t size,
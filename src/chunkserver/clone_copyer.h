@@ -36,6 +36,8 @@
 #include "src/client/client_common.h"
 #include "include/client/libcurve.h"
 #include "src/common/s3_adapter.h"
+#include "src/common/compression.h"
+#include "src/common/lru_cache.h"
 
 namespace curve {
 namespace chunkserver {
@@ -47,6 +49,8 @@ using curve::common::LocationOperator;
 using curve::common::OriginType;
 using curve::common::GetObjectAsyncCallBack;
 using curve::common::GetObjectAsyncContext;
+using curve::common::CompressedObject;
+using curve::common::LRUCache;
 using std::string;
 
 class DownloadClosure;
@@ -123,6 +127,27 @@ class OriginCopyer {
                        size_t size,
                        char* buf,
                        DownloadClosure* done);
+    /**
+     * 从压缩对象中读取原始数据的一部分，对象头部解析后缓存，
+     * 之后只需要读取覆盖请求范围的帧
+     */
+    void DownloadFromCompressedS3(const string& objectName,
+                                  off_t off,
+                                  size_t size,
+                                  char* buf,
+                                  DownloadClosure* done);
+    void ReadCompressedFrameTable(const string& objectName,
+                                  std::shared_ptr<CompressedObject> header,
+                                  off_t off,
+                                  size_t size,
+                                  char* buf,
+                                  DownloadClosure* done);
+    void ReadCompressedFrames(const string& objectName,
+                              std::shared_ptr<CompressedObject> header,
+                              off_t off,
+                              size_t size,
+                              char* buf,
+                              DownloadClosure* done);
     void DownloadFromCurve(const string& fileName,
                           off_t off,
                           size_t size,
@@ -143,6 +168,9 @@ class OriginCopyer {
     std::shared_ptr<FileClient> curveClient_;
     // 负责跟s3交互
     std::shared_ptr<S3Adapter>  s3Client_;
+    // 压缩对象名->对象头部 的缓存
+    LRUCache<std::string, std::shared_ptr<CompressedObject>>
+        compressedHeaders_;
     // 保护fdMap_的互斥锁
     std::mutex  mtx_;
     // 文件名->文件fd 的映射
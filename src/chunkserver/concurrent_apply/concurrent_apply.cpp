@@ -114,11 +114,11 @@ void ConcurrentApplyModule::Run(ThreadPoolType type, int index) {
     while (start_) {
         switch (type) {
         case ThreadPoolType::READ:
-            rapplyMap_[index]->tq.Pop()();
+            rapplyMap_[index]->tq.RunOne();
             break;
 
         case ThreadPoolType::WRITE:
-            wapplyMap_[index]->tq.Pop()();
+            wapplyMap_[index]->tq.RunOne();
             break;
         }
     }
@@ -32,12 +32,12 @@
 #include <utility>
 #include <condition_variable>    // NOLINT
 
-#include "src/common/concurrent/task_queue.h"
+#include "src/common/concurrent/mpsc_task_queue.h"
 #include "src/common/concurrent/count_down_event.h"
 #include "proto/chunk.pb.h"
 #include "include/curve_compiler_specific.h"
 
-using curve::common::TaskQueue;
+using curve::common::MPSCTaskQueue;
 using curve::common::CountDownEvent;
 using curve::chunkserver::CHUNK_OP_TYPE;
 
@@ -82,13 +82,14 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
      */
     template<class F, class... Args>
     bool Push(uint64_t key, CHUNK_OP_TYPE optype, F&& f, Args&&... args) {
-        auto task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
         switch (Schedule(optype)) {
             case ThreadPoolType::READ:
-                rapplyMap_[Hash(key, rconcurrentsize_)]->tq.Push(task);
+                rapplyMap_[Hash(key, rconcurrentsize_)]->tq.Push(
+                    std::forward<F>(f), std::forward<Args>(args)...);
                 break;
             case ThreadPoolType::WRITE:
-                wapplyMap_[Hash(key, wconcurrentsize_)]->tq.Push(task);
+                wapplyMap_[Hash(key, wconcurrentsize_)]->tq.Push(
+                    std::forward<F>(f), std::forward<Args>(args)...);
                 break;
         }
 
@@ -119,7 +120,7 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
     typedef uint8_t threadIndex;
     typedef struct taskthread {
         std::thread th;
-        TaskQueue tq;
+        MPSCTaskQueue tq;
         taskthread(size_t capacity):tq(capacity) {}
         ~taskthread() = default;
     } taskthread_t;
@@ -133,6 +133,9 @@ struct CopysetNodeOptions {
     uint64_t syncThreshold = 64 * 1024;
     // check syncing interval
     uint32_t checkSyncingIntervalMs = 500u;
+    // the size of data block covered by one crc kept in chunk metapage,
+    // 0 means not to keep the crc of data
+    uint32_t dataCrcBlockSize = 0;
 
     CopysetNodeOptions();
 };
@@ -41,6 +41,7 @@
 #include "src/chunkserver/raftsnapshot/curve_filesystem_adaptor.h"
 #include "src/chunkserver/chunk_closure.h"
 #include "src/chunkserver/op_request.h"
+#include "src/common/concurrent/count_down_event.h"
 #include "src/common/concurrent/task_thread_pool.h"
 #include "src/fs/fs_common.h"
 #include "src/chunkserver/copyset_node_manager.h"
@@ -74,7 +75,9 @@ CopysetNode::CopysetNode(const LogicPoolID &logicPoolId,
     chunkDataApath_(),
     chunkDataRpath_(),
     appliedIndex_(0),
+    dispatchedIndex_(0),
     leaderTerm_(-1),
+    following_(false),
     scaning_(false),
     lastScanSec_(0),
     lastSnapshotIndex_(0),
@@ -130,6 +133,7 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
     dsOptions.locationLimit = options.locationLimit;
     dsOptions.enableOdsyncWhenOpenChunkFile =
         options.enableOdsyncWhenOpenChunkFile;
+    dsOptions.crcBlockSize = options.dataCrcBlockSize;
     dataStore_ = std::make_shared<CSDataStore>(options.localFileSystem,
                                                options.chunkFilePool,
                                                dsOptions);
@@ -294,7 +298,7 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
                                   iter.index(),
                                   doneGuard.release());
             concurrentapply_->Push(
-                opRequest->ChunkId(), opRequest->OpType(), task);
+                opRequest->ChunkId(), opRequest->OpType(), std::move(task));
         } else {
             // 获取log entry
             butil::IOBuf log = iter.data();
@@ -314,8 +318,9 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
                                   dataStore_,
                                   std::move(request),
                                   data);
-            concurrentapply_->Push(chunkId, request.optype(), task);
+            concurrentapply_->Push(chunkId, request.optype(), std::move(task));
         }
+        dispatchedIndex_.store(iter.index(), std::memory_order_release);
     }
 }
 
@@ -346,9 +351,12 @@ void CopysetNode::save_snapshot_background(::braft::SnapshotWriter *writer,
      */
     concurrentapply_->Flush();
 
-    if (!enableOdsyncWhenOpenChunkFile_) {
-        ForceSyncAllChunks();
-    }
+    /**
+     * 等待上次快照之后写过的chunk sync完成，chunk的数据crc表也在sync时
+     * 落盘，快照之后的写在crash之后会被回放并重新计算crc。
+     * O_DSYNC模式下数据已经落盘，这里只需要写入延迟持久化的crc表
+     */
+    ForceSyncAllChunks();
 
     /**
      * 2.保存配置版本: conf.epoch，注意conf.epoch是存放在data目录下
@@ -542,12 +550,14 @@ void CopysetNode::on_configuration_committed(const Configuration& conf,
 }
 
 void CopysetNode::on_stop_following(const ::braft::LeaderChangeContext &ctx) {
+    following_.store(false, std::memory_order_release);
     LOG(INFO) << "Copyset: " << GroupIdString()
               << ", peer id: " << peerId_.to_string()
               << " stops following" << ctx;
 }
 
 void CopysetNode::on_start_following(const ::braft::LeaderChangeContext &ctx) {
+    following_.store(true, std::memory_order_release);
     LOG(INFO) << "Copyset: " << GroupIdString()
               << ", peer id: " << peerId_.to_string()
               << "start following" << ctx;
@@ -927,6 +937,14 @@ void CopysetNode::GetStatus(NodeStatus *status) {
     raftNode_->get_status(status);
 }
 
+bool CopysetNode::IsFollowerReadable(uint64_t appliedIndex) const {
+    // 每个follower读请求都会调用，只检查原子变量，不通过GetStatus获取
+    // raft node的锁。读请求在并发层中排在已经分发的日志之后执行
+    return appliedIndex != 0 &&
+           following_.load(std::memory_order_acquire) &&
+           dispatchedIndex_.load(std::memory_order_acquire) >= appliedIndex;
+}
+
 bool CopysetNode::GetLeaderStatus(NodeStatus *leaderStaus) {
     NodeStatus status;
     GetStatus(&status);
@@ -1004,11 +1022,11 @@ void CopysetNode::ForceSyncAllChunks() {
         std::this_thread::sleep_for(
             std::chrono::milliseconds(checkSyncingIntervalMs_));
     }
-    SyncAllChunks();
+    SyncAllChunks(true);
     isSyncing_ = false;
 }
 
-void CopysetNode::SyncAllChunks() {
+void CopysetNode::SyncAllChunks(bool wait) {
     std::deque<ChunkID> temp;
     {
         curve::common::LockGuard lg(chunkIdsLock_);
@@ -1018,6 +1036,11 @@ void CopysetNode::SyncAllChunks() {
     for (auto chunkId : temp) {
         chunkIds.insert(chunkId);
     }
+    if (chunkIds.empty()) {
+        return;
+    }
+    auto event = std::make_shared<curve::common::CountDownEvent>(
+        chunkIds.size());
     for (ChunkID chunk : chunkIds) {
         copysetSyncPool_->Enqueue([=]() {
             CSErrorCode r = dataStore_->SyncChunk(chunk);
@@ -1027,8 +1050,12 @@ void CopysetNode::SyncAllChunks() {
                        << ", chunkid: " << chunk
                        << " data store return: " << r;
             }
+            event->Signal();
         });
     }
+    if (wait) {
+        event->Wait();
+    }
 }
 
 void SyncChunkThread::Init(CopysetNode* node) {
@@ -249,6 +249,14 @@ class CopysetNode : public braft::StateMachine,
      */
     virtual uint64_t GetAppliedIndex() const;
 
+    /**
+     * @brief: 当前节点作为follower时能否直接处理读请求，要求正常跟随leader，
+     *         并且已经分发到并发层的日志不落后于client已知的applied index。
+     *         只用于快照、克隆源等不会再修改的数据
+     * @param appliedIndex: client已知的applied index
+     */
+    virtual bool IsFollowerReadable(uint64_t appliedIndex) const;
+
     /**
      * @brief: 查询配置变更的状态
      * @param type[out]: 配置变更类型
@@ -441,7 +449,11 @@ class CopysetNode : public braft::StateMachine,
 
     void HandleSyncTimerOut();
 
-    void SyncAllChunks();
+    /**
+     * sync上次sync之后写过的chunk
+     * @param wait: 是否等待所有chunk sync完成
+     */
+    void SyncAllChunks(bool wait = false);
 
     void ForceSyncAllChunks();
 
@@ -491,8 +503,12 @@ class CopysetNode : public braft::StateMachine,
     std::unique_ptr<ConfEpochFile> epochFile_;
     // 复制组的apply index
     std::atomic<uint64_t> appliedIndex_;
+    // on_apply已经分发到并发层的最大日志index
+    std::atomic<uint64_t> dispatchedIndex_;
     // 复制组当前任期，如果<=0表明不是leader
     std::atomic<int64_t> leaderTerm_;
+    // 是否正在跟随leader
+    std::atomic<bool> following_;
     // 复制组数据回收站目录
     std::string recyclerUri_;
     // 复制组的metric信息
@@ -37,6 +37,24 @@ bool ValidMinIoAlignment(const char* flagname, uint32_t value) {
     return common::is_aligned(value, 512);
 }
 
+// crc32c of [pos, pos + length) of buf, without copying the data
+uint32_t IOBufCRC32(const butil::IOBuf& buf, size_t pos, size_t length) {
+    uint32_t crc = 0;
+    size_t blockNum = buf.backing_block_num();
+    for (size_t i = 0; i < blockNum && length > 0; ++i) {
+        butil::StringPiece block = buf.backing_block(i);
+        if (pos >= block.size()) {
+            pos -= block.size();
+            continue;
+        }
+        size_t len = std::min(block.size() - pos, length);
+        crc = ::curve::common::CRC32(crc, block.data() + pos, len);
+        length -= len;
+        pos = 0;
+    }
+    return crc;
+}
+
 }  // namespace
 
 DEFINE_uint32(minIoAlignment, 512,
@@ -55,6 +73,8 @@ ChunkFileMetaPage::ChunkFileMetaPage(const ChunkFileMetaPage& metaPage) {
     } else {
         bitmap = nullptr;
     }
+    crcBlockSize = metaPage.crcBlockSize;
+    blockCrcs = metaPage.blockCrcs;
 }
 
 ChunkFileMetaPage& ChunkFileMetaPage::operator =(
@@ -71,6 +91,8 @@ ChunkFileMetaPage& ChunkFileMetaPage::operator =(
     } else {
         bitmap = nullptr;
     }
+    crcBlockSize = metaPage.crcBlockSize;
+    blockCrcs = metaPage.blockCrcs;
     return *this;
 }
 
@@ -96,6 +118,16 @@ void ChunkFileMetaPage::encode(char* buf) {
         memcpy(buf + len, bitmap->GetBitmap(), bitmapBytes);
         len += bitmapBytes;
     }
+    // Version 3 chunk need serialized the crc table of data blocks
+    if (version == FORMAT_VERSION_V3) {
+        memcpy(buf + len, &crcBlockSize, sizeof(crcBlockSize));
+        len += sizeof(crcBlockSize);
+        uint32_t crcNum = blockCrcs.size();
+        memcpy(buf + len, &crcNum, sizeof(crcNum));
+        len += sizeof(crcNum);
+        memcpy(buf + len, blockCrcs.data(), crcNum * sizeof(uint32_t));
+        len += crcNum * sizeof(uint32_t);
+    }
     uint32_t crc = ::curve::common::CRC32(buf, len);
     memcpy(buf + len, &crc, sizeof(crc));
 }
@@ -121,6 +153,24 @@ CSErrorCode ChunkFileMetaPage::decode(const char* buf) {
         size_t bitmapBytes = (bitmap->Size() + 8 - 1) >> 3;
         len += bitmapBytes;
     }
+    crcBlockSize = 0;
+    blockCrcs.clear();
+    if (version == FORMAT_VERSION_V3) {
+        memcpy(&crcBlockSize, buf + len, sizeof(crcBlockSize));
+        len += sizeof(crcBlockSize);
+        uint32_t crcNum = 0;
+        memcpy(&crcNum, buf + len, sizeof(crcNum));
+        len += sizeof(crcNum);
+        // the table is limited to half of the smallest metapage
+        if (crcBlockSize == 0 || crcNum > kMaxBlockCrcNum) {
+            LOG(ERROR) << "Invalid crc table, block size: " << crcBlockSize
+                       << ", crc num: " << crcNum;
+            return CSErrorCode::FileFormatError;
+        }
+        blockCrcs.resize(crcNum);
+        memcpy(blockCrcs.data(), buf + len, crcNum * sizeof(uint32_t));
+        len += crcNum * sizeof(uint32_t);
+    }
     uint32_t crc =  ::curve::common::CRC32(buf, len);
     uint32_t recordCrc;
     memcpy(&recordCrc, buf + len, sizeof(recordCrc));
@@ -132,11 +182,12 @@ CSErrorCode ChunkFileMetaPage::decode(const char* buf) {
 
     // TODO(yyk) check version compatibility, currrent simple error handing,
     // need detailed implementation later
-    if (!(version == FORMAT_VERSION || version == FORMAT_VERSION_V2)) {
+    if (!(version == FORMAT_VERSION || version == FORMAT_VERSION_V2 ||
+          version == FORMAT_VERSION_V3)) {
         LOG(ERROR) << "File format version incompatible."
                    << "file version: " << version
                    << ", valid version: [" << FORMAT_VERSION
-                   << ", " << FORMAT_VERSION_V2 << "]";
+                   << ", " << FORMAT_VERSION_V3 << "]";
         return CSErrorCode::IncompatibleError;
     }
     return CSErrorCode::Success;
@@ -160,7 +211,10 @@ CSChunkFile::CSChunkFile(std::shared_ptr<LocalFileSystem> lfs,
       chunkFilePool_(chunkFilePool),
       lfs_(lfs),
       metric_(options.metric),
-      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile) {
+      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile),
+      crcBlockSize_(options.crcBlockSize),
+      crcDirty_(false),
+      scanDirty_(true) {
     CHECK(!baseDir_.empty()) << "Create chunk file failed";
     CHECK(lfs_ != nullptr) << "Create chunk file failed";
     metaPage_.sn = options.sn;
@@ -208,6 +262,13 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
         std::unique_ptr<char[]> buf(new char[pageSize_]);
         memset(buf.get(), 0, pageSize_);
         metaPage_.version = FORMAT_VERSION_V2;
+        // Only normal chunk has the crc table, the metapage of clone chunk
+        // may be occupied by the location and the bitmap
+        if (crcBlockSize_ > 0 && metaPage_.location.empty()) {
+            metaPage_.version = FORMAT_VERSION_V3;
+            metaPage_.crcBlockSize = crcBlockSize_;
+            metaPage_.blockCrcs.assign(size_ / crcBlockSize_, 0);
+        }
         metaPage_.encode(buf.get());
 
         int rc = chunkFilePool_->GetFile(chunkFilePath, buf.get(), true);
@@ -313,6 +374,7 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
                    << (isCloneChunk_ ? pageSize_ : FLAGS_minIoAlignment);
         return CSErrorCode::InvalidArgError;
     }
+    SetScanDirty(true);
     // Curve will ensure that all previous requests arrive or time out
     // before issuing new requests after user initiate a snapshot request.
     // Therefore, this is only a log recovery request, and it must have been
@@ -413,6 +475,11 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
                    << ",chunk sn: " << metaPage_.sn;
         return CSErrorCode::InternalError;
     }
+    // The crc table is only persisted in Sync(), in both modes the chunks
+    // written since last raft snapshot are synced before saving the next
+    // one, and the writes after it are replayed after crash, which
+    // recomputes their crcs. So no metapage write is added to each write.
+    updateBlockCrc(buf, offset, length);
     // If it is a clone chunk, the bitmap will be updated
     CSErrorCode errorCode = flush();
     if (errorCode != CSErrorCode::Success) {
@@ -439,6 +506,12 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
 
 CSErrorCode CSChunkFile::Sync() {
     WriteLockGuard writeGuard(rwLock_);
+    CSErrorCode errorCode = persistBlockCrc();
+    if (errorCode != CSErrorCode::Success) {
+        LOG(ERROR) << "Sync crc table failed, "
+                   << "ChunkID:" << chunkId_;
+        return errorCode;
+    }
     int rc = SyncData();
     if (rc < 0) {
         LOG(ERROR) << "Sync data failed, "
@@ -464,6 +537,7 @@ CSErrorCode CSChunkFile::Paste(const char * buf, off_t offset, size_t length) {
                    << ", align: " << pageSize_;
         return CSErrorCode::InvalidArgError;
     }
+    SetScanDirty(true);
 
     // The request above must be pagesize aligned
     // the starting page index number of the paste area
@@ -545,11 +619,23 @@ CSErrorCode CSChunkFile::Read(char * buf, off_t offset, size_t length) {
                    << ",chunk sn: " << metaPage_.sn;
         return CSErrorCode::InternalError;
     }
-    return CSErrorCode::Success;
+    return verifyBlockCrc(buf, offset, length);
 }
 
 CSErrorCode CSChunkFile::ReadMetaPage(char * buf) {
     ReadLockGuard readGuard(rwLock_);
+    // The crc table is persisted at different time on different replicas,
+    // and it is compared by GetBlockCrc(), so return the metapage without
+    // the table to keep the metapage of the replicas comparable
+    if (metaPage_.version == FORMAT_VERSION_V3) {
+        ChunkFileMetaPage tempMeta = metaPage_;
+        tempMeta.version = FORMAT_VERSION_V2;
+        tempMeta.crcBlockSize = 0;
+        tempMeta.blockCrcs.clear();
+        memset(buf, 0, pageSize_);
+        tempMeta.encode(buf);
+        return CSErrorCode::Success;
+    }
     int rc = readMetaPage(buf);
     if (rc < 0) {
         LOG(ERROR) << "Read chunk meta page failed."
@@ -756,6 +842,7 @@ CSErrorCode CSChunkFile::DeleteSnapshotOrCorrectSn(SequenceNum correctedSn)  {
      */
     SequenceNum chunkSn = std::max(metaPage_.correctedSn, metaPage_.sn);
     if (correctedSn > chunkSn) {
+        SetScanDirty(true);
         ChunkFileMetaPage tempMeta = metaPage_;
         tempMeta.correctedSn = correctedSn;
         CSErrorCode errorCode = updateMetaPage(&tempMeta);
@@ -822,6 +909,66 @@ CSErrorCode CSChunkFile::GetHash(off_t offset,
     return CSErrorCode::Success;
 }
 
+CSErrorCode CSChunkFile::GetBlockCrc(off_t offset,
+                                     size_t length,
+                                     uint32_t blockSize,
+                                     uint32_t* crc,
+                                     uint32_t* badBlocks) {
+    ReadLockGuard readGuard(rwLock_);
+    if (blockSize == 0 || !CheckOffsetAndLength(offset, length, blockSize)) {
+        LOG(ERROR) << "Get block crc failed, invalid offset or length."
+                   << "ChunkID: " << chunkId_
+                   << ", offset: " << offset
+                   << ", length: " << length
+                   << ", block size: " << blockSize;
+        return CSErrorCode::InvalidArgError;
+    }
+
+    std::unique_ptr<char[]> buf(new(std::nothrow) char[length]);
+    if (nullptr == buf) {
+        return CSErrorCode::InternalError;
+    }
+    int rc = readData(buf.get(), offset, length);
+    if (rc < 0) {
+        LOG(ERROR) << "Read chunk file failed."
+                   << "ChunkID: " << chunkId_
+                   << ",chunk sn: " << metaPage_.sn;
+        return CSErrorCode::InternalError;
+    }
+
+    // the table is only comparable if it covers the same blocks
+    bool useTable = metaPage_.crcBlockSize == blockSize;
+    uint32_t bad = 0;
+    uint32_t result = 0;
+    for (uint64_t pos = 0; pos < length; pos += blockSize) {
+        uint32_t blockCrc = ::curve::common::CRC32(buf.get() + pos,
+                                                   blockSize);
+        uint32_t expected = useTable ?
+            metaPage_.blockCrcs[(offset + pos) / blockSize] : 0;
+        if (expected != 0 && expected != blockCrc) {
+            LOG(ERROR) << "Data crc mismatch found by scan, the data may be"
+                       << " corrupted. ChunkID: " << chunkId_
+                       << ", block offset: " << offset + pos
+                       << ", block size: " << blockSize
+                       << ", expected crc: " << expected
+                       << ", actual crc: " << blockCrc;
+            ++bad;
+        }
+        result = ::curve::common::CRC32(
+            result, reinterpret_cast<const char*>(&blockCrc),
+            sizeof(blockCrc));
+    }
+    // keep the corrupted chunk in the incremental scans until repaired
+    if (bad > 0) {
+        SetScanDirty(true);
+    }
+    *crc = result;
+    if (badBlocks != nullptr) {
+        *badBlocks = bad;
+    }
+    return CSErrorCode::Success;
+}
+
 bool CSChunkFile::needCreateSnapshot(SequenceNum sn) {
     // The maximum value of correctSn_ and sn_ can represent
     // the true sequence number of the chunk file
@@ -895,6 +1042,75 @@ bool CSChunkFile::needCow(SequenceNum sn) {
     return true;
 }
 
+void CSChunkFile::updateBlockCrc(const butil::IOBuf& buf,
+                                 off_t offset,
+                                 size_t length) {
+    uint32_t blockSize = metaPage_.crcBlockSize;
+    if (blockSize == 0 || length == 0) {
+        return;
+    }
+    uint64_t begin = offset;
+    uint64_t end = offset + length;
+    uint32_t beginIndex = begin / blockSize;
+    uint32_t endIndex = (end - 1) / blockSize;
+    for (uint32_t i = beginIndex; i <= endIndex; ++i) {
+        uint64_t blockOff = static_cast<uint64_t>(i) * blockSize;
+        if (blockOff >= begin && blockOff + blockSize <= end) {
+            metaPage_.blockCrcs[i] =
+                IOBufCRC32(buf, blockOff - offset, blockSize);
+        } else {
+            // the crc of the partially written block is unknown
+            // unless we read the rest of the block
+            metaPage_.blockCrcs[i] = 0;
+        }
+    }
+    crcDirty_ = true;
+}
+
+CSErrorCode CSChunkFile::verifyBlockCrc(const char* buf,
+                                        off_t offset,
+                                        size_t length) {
+    uint32_t blockSize = metaPage_.crcBlockSize;
+    if (blockSize == 0) {
+        return CSErrorCode::Success;
+    }
+    // start from the first block fully covered by the read
+    uint64_t end = offset + length;
+    uint32_t index = (offset + blockSize - 1) / blockSize;
+    for (uint64_t blockOff = static_cast<uint64_t>(index) * blockSize;
+         blockOff + blockSize <= end;
+         blockOff += blockSize, ++index) {
+        uint32_t expected = metaPage_.blockCrcs[index];
+        if (expected == 0) {
+            continue;
+        }
+        uint32_t actual = ::curve::common::CRC32(buf + (blockOff - offset),
+                                                 blockSize);
+        if (actual != expected) {
+            LOG(ERROR) << "Data crc mismatch, the data may be corrupted."
+                       << "ChunkID: " << chunkId_
+                       << ", block offset: " << blockOff
+                       << ", block size: " << blockSize
+                       << ", expected crc: " << expected
+                       << ", actual crc: " << actual;
+            return CSErrorCode::CrcCheckError;
+        }
+    }
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSChunkFile::persistBlockCrc() {
+    if (!crcDirty_) {
+        return CSErrorCode::Success;
+    }
+    CSErrorCode errorCode = updateMetaPage(&metaPage_);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
+    crcDirty_ = false;
+    return CSErrorCode::Success;
+}
+
 CSErrorCode CSChunkFile::updateMetaPage(ChunkFileMetaPage* metaPage) {
     std::unique_ptr<char[]> buf(new char[pageSize_]);
     memset(buf.get(), 0, pageSize_);
@@ -918,7 +1134,19 @@ CSErrorCode CSChunkFile::loadMetaPage() {
                    << " filepath = " << path();
         return CSErrorCode::InternalError;
     }
-    return metaPage_.decode(buf.get());
+    CSErrorCode errorCode = metaPage_.decode(buf.get());
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
+    if (metaPage_.crcBlockSize > 0 &&
+        metaPage_.blockCrcs.size() * metaPage_.crcBlockSize != size_) {
+        LOG(ERROR) << "The crc table does not match the chunk size."
+                   << " filepath = " << path()
+                   << ", crc block size: " << metaPage_.crcBlockSize
+                   << ", crc num: " << metaPage_.blockCrcs.size();
+        return CSErrorCode::FileFormatError;
+    }
+    return CSErrorCode::Success;
 }
 
 CSErrorCode CSChunkFile::copy2Snapshot(off_t offset, size_t length) {
@@ -976,6 +1204,11 @@ CSErrorCode CSChunkFile::copy2Snapshot(off_t offset, size_t length) {
 }
 
 CSErrorCode CSChunkFile::flush() {
+    // Nothing to update for normal chunk, avoid copying the metapage
+    // on every write
+    if (!isCloneChunk_ && dirtyPages_.empty()) {
+        return CSErrorCode::Success;
+    }
     ChunkFileMetaPage tempMeta = metaPage_;
     bool needUpdateMeta = dirtyPages_.size() > 0;
     bool clearClone = false;
@@ -64,8 +64,12 @@ struct DataStoreMetric;
  * version: 1 byte
  * sn: 8 bytes
  * correctedSn: 8 bytes
+ * location size: 8 bytes
+ * [location + bitmap]: only for clone chunk
+ * [crcBlockSize: 4 bytes + crcNum: 4 bytes + crcs: crcNum * 4 bytes]:
+ *      only for version 3
  * crc: 4 bytes
- * padding: 4075 bytes
+ * padding: the rest bytes of the page
  */
 struct ChunkFileMetaPage {
     // File format version
@@ -80,12 +84,19 @@ struct ChunkFileMetaPage {
     // Indicates the state of the page in the current Chunk,
     // if it is not CloneChunk, it is nullptr
     std::shared_ptr<Bitmap> bitmap;
+    // The size of the data block covered by one crc in blockCrcs,
+    // 0 means the chunk has no data crc table (version < 3)
+    uint32_t crcBlockSize;
+    // crc32c of each data block, 0 means the crc of the block is unknown,
+    // for example, the block is never written or partially written
+    std::vector<uint32_t> blockCrcs;
 
     ChunkFileMetaPage() : version(FORMAT_VERSION)
                         , sn(0)
                         , correctedSn(0)
                         , location("")
-                        , bitmap(nullptr) {}
+                        , bitmap(nullptr)
+                        , crcBlockSize(0) {}
     ChunkFileMetaPage(const ChunkFileMetaPage& metaPage);
     ChunkFileMetaPage& operator = (const ChunkFileMetaPage& metaPage);
 
@@ -112,6 +123,9 @@ struct ChunkOptions {
     PageSizeType    pageSize;
     // enable O_DSYNC When Open ChunkFile
     bool enableOdsyncWhenOpenChunkFile;
+    // The size of the data block covered by one crc in the metapage,
+    // only used when creating a non-clone chunk, 0 means disabled
+    uint32_t crcBlockSize;
     // datastore internal statistical metric
     std::shared_ptr<DataStoreMetric> metric;
 
@@ -122,6 +136,8 @@ struct ChunkOptions {
                    , location("")
                    , chunkSize(0)
                    , pageSize(0)
+                   , enableOdsyncWhenOpenChunkFile(false)
+                   , crcBlockSize(0)
                    , metric(nullptr) {}
 };
 
@@ -252,6 +268,27 @@ class CSChunkFile {
     CSErrorCode GetHash(off_t offset,
                         size_t length,
                         std::string *hash);
+    /**
+     * Get the crc of the data blocks in the specified area for scan, the
+     * crc of each block is calculated from the data read from disk, and
+     * checked against the crc table in metapage if it is known there, so
+     * the corruption of data at rest is found on the replica itself.
+     * Replicas with the same data get the same result, no matter whether
+     * they have the crc table or not.
+     * There may be concurrency, add read lock
+     * @param offset: the starting offset, must be aligned to blockSize
+     * @param length: the length, must be aligned to blockSize
+     * @param blockSize: the size of the block covered by one crc
+     * @param[out] crc: crc32c of the crc array of the blocks
+     * @param[out] badBlocks: number of blocks whose data mismatches
+     *                        the crc table
+     * @return: error code
+     */
+    CSErrorCode GetBlockCrc(off_t offset,
+                            size_t length,
+                            uint32_t blockSize,
+                            uint32_t* crc,
+                            uint32_t* badBlocks = nullptr);
     /**
      * Get chunkFileMetaPage
      * @return: metapage
@@ -264,6 +301,19 @@ class CSChunkFile {
         metaPage_ = metaPage;
     }
 
+    /**
+     * Whether the chunk is changed since it was scanned last time,
+     * the new created or reloaded chunk is dirty, and so is the chunk
+     * whose data is found mismatching the crc table by scan
+     */
+    bool IsScanDirty() const {
+        return scanDirty_.load(std::memory_order_acquire);
+    }
+
+    void SetScanDirty(bool dirty) {
+        scanDirty_.store(dirty, std::memory_order_release);
+    }
+
     void SetSyncInfo(std::shared_ptr<std::atomic<uint64_t>> rate,
         std::shared_ptr<std::condition_variable> cond) {
         chunkrate_ = rate;
@@ -315,6 +365,20 @@ class CSChunkFile {
      * to a normal chunk
      */
     CSErrorCode flush();
+    /**
+     * Update the crc table after writing data, the blocks fully covered by
+     * the write get the new crc, the partially covered ones become unknown
+     */
+    void updateBlockCrc(const butil::IOBuf& buf, off_t offset, size_t length);
+    /**
+     * Verify the data read against the crc table, only the blocks fully
+     * covered by the read and with known crc are checked
+     */
+    CSErrorCode verifyBlockCrc(const char* buf, off_t offset, size_t length);
+    /**
+     * Persist the crc table if it is changed since last persisting
+     */
+    CSErrorCode persistBlockCrc();
 
     inline string path() {
         return baseDir_ + "/" +
@@ -432,6 +496,12 @@ class CSChunkFile {
     std::shared_ptr<DataStoreMetric> metric_;
     // enable O_DSYNC When Open ChunkFile
     bool enableOdsyncWhenOpenChunkFile_;
+    // crc block size for new chunk file, 0 means no crc table
+    uint32_t crcBlockSize_;
+    // the crc table in memory is newer than the one on disk
+    bool crcDirty_;
+    // changed since last scan, used by incremental scan
+    std::atomic<bool> scanDirty_;
 };
 }  // namespace chunkserver
 }  // namespace curve
@@ -43,7 +43,8 @@ CSDataStore::CSDataStore(std::shared_ptr<LocalFileSystem> lfs,
       locationLimit_(options.locationLimit),
       chunkFilePool_(chunkFilePool),
       lfs_(lfs),
-      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile) {
+      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile),
+      crcBlockSize_(options.crcBlockSize) {
     CHECK(!baseDir_.empty()) << "Create datastore failed";
     CHECK(lfs_ != nullptr) << "Create datastore failed";
     CHECK(chunkFilePool_ != nullptr) << "Create datastore failed";
@@ -251,6 +252,7 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
         options.pageSize = pageSize_;
         options.metric = metric_;
         options.enableOdsyncWhenOpenChunkFile = enableOdsyncWhenOpenChunkFile_;
+        options.crcBlockSize = crcBlockSize_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
             return errorCode;
@@ -388,6 +390,26 @@ CSErrorCode CSDataStore::GetChunkHash(ChunkID id,
     return chunkFile->GetHash(offset, length, hash);
 }
 
+CSErrorCode CSDataStore::GetChunkBlockCrc(ChunkID id,
+                                          off_t offset,
+                                          size_t length,
+                                          uint32_t blockSize,
+                                          uint32_t* crc,
+                                          uint32_t* badBlocks) {
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile == nullptr) {
+        return CSErrorCode::ChunkNotExistError;
+    }
+    return chunkFile->GetBlockCrc(offset, length, blockSize, crc, badBlocks);
+}
+
+void CSDataStore::MarkChunkScanned(ChunkID id) {
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile != nullptr) {
+        chunkFile->SetScanDirty(false);
+    }
+}
+
 DataStoreStatus CSDataStore::GetStatus() {
     DataStoreStatus status;
     status.chunkFileCount = metric_->chunkFileCount.get_value();
@@ -422,5 +444,9 @@ ChunkMap CSDataStore::GetChunkMap() {
     return metaCache_.GetMap();
 }
 
+void CSDataStore::ForEachChunk(const ChunkVisitor& visitor) {
+    metaCache_.ForEach(visitor);
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -30,6 +30,7 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <functional>
 #include <condition_variable>
 
 #include "include/curve_compiler_specific.h"
@@ -61,6 +62,15 @@ struct DataStoreOptions {
     PageSizeType                        pageSize;
     uint32_t                            locationLimit;
     bool                                enableOdsyncWhenOpenChunkFile;
+    // the size of data block covered by one crc in the metapage of
+    // new chunks, 0 means not to keep the data crc
+    uint32_t                            crcBlockSize;
+
+    DataStoreOptions() : chunkSize(0)
+                       , pageSize(0)
+                       , locationLimit(0)
+                       , enableOdsyncWhenOpenChunkFile(false)
+                       , crcBlockSize(0) {}
 };
 
 /**
@@ -92,48 +102,88 @@ struct DataStoreMetric {
 using DataStoreMetricPtr = std::shared_ptr<DataStoreMetric>;
 
 using ChunkMap = std::unordered_map<ChunkID, CSChunkFilePtr>;
-// For the mapping from chunkid to chunkfile,
-// use read-write lock to protect the map operation
+using ChunkVisitor = std::function<void(ChunkID, const CSChunkFilePtr&)>;
+
+// For the mapping from chunkid to chunkfile.
+// The map is split into kMetaCacheShardNum shards by chunk id, every shard
+// is protected by its own read-write lock, so that operations on different
+// chunks of one copyset do not contend on a single lock
 class CSMetaCache {
  public:
+    // number of shards, must be a power of 2
+    static const uint32_t kMetaCacheShardNum = 64;
+
     CSMetaCache() : cvar_(nullptr),
         sumChunkRate_(std::make_shared<std::atomic<uint64_t>>()) {}
     virtual ~CSMetaCache() {}
 
+    // Return a copy of all the chunks, the shards are copied one by one,
+    // so it is not an atomic snapshot of the whole cache
     ChunkMap GetMap() {
-        ReadLockGuard readGuard(rwLock_);
-        return chunkMap_;
+        ChunkMap result;
+        for (auto& shard : shards_) {
+            ReadLockGuard readGuard(shard.rwLock);
+            result.insert(shard.chunkMap.begin(), shard.chunkMap.end());
+        }
+        return result;
+    }
+
+    /**
+     * Visit all the chunks in the cache without copying the map
+     * @param visitor: called with the shard read lock held, so it should be
+     *                 lightweight and must not modify the cache
+     */
+    void ForEach(const ChunkVisitor& visitor) {
+        for (auto& shard : shards_) {
+            ReadLockGuard readGuard(shard.rwLock);
+            for (const auto& item : shard.chunkMap) {
+                visitor(item.first, item.second);
+            }
+        }
+    }
+
+    size_t Size() {
+        size_t size = 0;
+        for (auto& shard : shards_) {
+            ReadLockGuard readGuard(shard.rwLock);
+            size += shard.chunkMap.size();
+        }
+        return size;
     }
 
     CSChunkFilePtr Get(ChunkID id) {
-        ReadLockGuard readGuard(rwLock_);
-        if (chunkMap_.find(id) == chunkMap_.end()) {
+        Shard& shard = GetShard(id);
+        ReadLockGuard readGuard(shard.rwLock);
+        auto iter = shard.chunkMap.find(id);
+        if (iter == shard.chunkMap.end()) {
             return nullptr;
         }
-        return chunkMap_[id];
+        return iter->second;
     }
 
     CSChunkFilePtr Set(ChunkID id, CSChunkFilePtr chunkFile) {
-        WriteLockGuard writeGuard(rwLock_);
-       // When two write requests are concurrently created to create a chunk
-       // file, return the first set chunkFile
-        if (chunkMap_.find(id) == chunkMap_.end()) {
+        Shard& shard = GetShard(id);
+        WriteLockGuard writeGuard(shard.rwLock);
+        // When two write requests are concurrently created to create a chunk
+        // file, return the first set chunkFile
+        auto ret = shard.chunkMap.emplace(id, chunkFile);
+        if (ret.second) {
             chunkFile->SetSyncInfo(sumChunkRate_, cvar_);
-            chunkMap_[id] = chunkFile;
         }
-        return chunkMap_[id];
+        return ret.first->second;
     }
 
     void Remove(ChunkID id) {
-        WriteLockGuard writeGuard(rwLock_);
-        if (chunkMap_.find(id) != chunkMap_.end()) {
-            chunkMap_.erase(id);
-        }
+        Shard& shard = GetShard(id);
+        WriteLockGuard writeGuard(shard.rwLock);
+        shard.chunkMap.erase(id);
     }
 
     void Clear() {
-        WriteLockGuard writeGuard(rwLock_);
-        chunkMap_.clear();
+        for (auto& shard : shards_) {
+            WriteLockGuard writeGuard(shard.rwLock);
+            shard.chunkMap.clear();
+        }
     }
 
     void SetCondPtr(std::shared_ptr<std::condition_variable> cond) {
@@ -145,12 +195,24 @@ class CSMetaCache {
         CSChunkFile::syncThreshold_ = threshold;
     }
 
+ private:
+    struct Shard {
+        RWLock      rwLock;
+        ChunkMap    chunkMap;
+    };
+
+    Shard& GetShard(ChunkID id) {
+        // chunk ids are allocated sequentially, mix the bits so that
+        // neighbouring ids spread over different shards evenly
+        uint64_t hash = id * 0x9E3779B97F4A7C15ULL;
+        return shards_[(hash >> 32) & (kMetaCacheShardNum - 1)];
+    }
+
  private:
     std::shared_ptr<std::condition_variable> cvar_;
     // sum of all chunks rate
     std::shared_ptr<std::atomic<uint64_t>> sumChunkRate_;
-    RWLock      rwLock_;
-    ChunkMap    chunkMap_;
+    Shard       shards_[kMetaCacheShardNum];
 };
 
 class CSDataStore {
@@ -318,6 +380,31 @@ class CSDataStore {
                                      off_t offset,
                                      size_t length,
                                      std::string* hash);
+
+    /**
+     * Get the crc of the data blocks of Chunk, used by scan to compare
+     * the replicas, the data is read and also verified against the crc
+     * table kept in the metapage
+     * @param id[in]: chunk id
+     * @param offset[in]: the starting offset, aligned to blockSize
+     * @param length[in]: the length, aligned to blockSize
+     * @param blockSize[in]: the size of data block covered by one crc
+     * @param crc[out]: crc of the block crcs
+     * @param badBlocks[out]: number of blocks mismatching the crc table
+     * @return: return error code
+     */
+    virtual CSErrorCode GetChunkBlockCrc(ChunkID id,
+                                         off_t offset,
+                                         size_t length,
+                                         uint32_t blockSize,
+                                         uint32_t* crc,
+                                         uint32_t* badBlocks);
+    /**
+     * Mark the chunk is scanned, it becomes dirty again when changed,
+     * incremental scan skips the chunks which are not dirty
+     * @param id[in]: chunk id
+     */
+    virtual void MarkChunkScanned(ChunkID id);
     /**
      * Get internal statistics of DataStore
      * @return: internal statistics of datastore
@@ -326,6 +413,13 @@ class CSDataStore {
 
     virtual ChunkMap GetChunkMap();
 
+    /**
+     * Visit all the chunks of the DataStore without copying the chunk map
+     * @param visitor: called with the chunk id and the chunk file,
+     *                 must not create or delete chunks of this DataStore
+     */
+    virtual void ForEachChunk(const ChunkVisitor& visitor);
+
     void SetCacheCondPtr(std::shared_ptr<std::condition_variable> cond) {
         metaCache_.SetCondPtr(cond);
     }
@@ -359,6 +453,8 @@ class CSDataStore {
     DataStoreMetricPtr metric_;
     // enable O_DSYNC When Open ChunkFile
     bool enableOdsyncWhenOpenChunkFile_;
+    // crc block size of new chunks
+    uint32_t crcBlockSize_;
 };
 
 }  // namespace chunkserver
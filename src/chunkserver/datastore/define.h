@@ -35,9 +35,13 @@ namespace chunkserver {
 using curve::common::Bitmap;
 
 // In zeroed chunk file, the version is 2,
-// otherwise, the version is 1
+// otherwise, the version is 1.
+// Zeroed chunk file with a data crc table in metapage, the version is 3
 const uint8_t FORMAT_VERSION = 1;
 const uint8_t FORMAT_VERSION_V2 = 2;
+const uint8_t FORMAT_VERSION_V3 = 3;
+// The crc table takes at most half of a 4KB metapage
+const uint32_t kMaxBlockCrcNum = 512;
 const SequenceNum kInvalidSeq = 0;
 
 DECLARE_uint32(minIoAlignment);
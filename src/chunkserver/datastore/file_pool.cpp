@@ -39,8 +39,11 @@
 #include "src/common/configuration.h"
 #include "src/common/crc32.h"
 #include "src/common/curve_define.h"
+#include "src/common/timeutility.h"
 
 using curve::common::kFilePoolMaigic;
+using curve::common::TimeUtility;
+using curve::fs::FileSystemInfo;
 
 namespace curve {
 namespace chunkserver {
@@ -50,6 +53,7 @@ const char* FilePoolHelper::kFilePoolPath = "chunkfilepool_path";
 const char* FilePoolHelper::kCRC = "crc";
 const uint32_t FilePoolHelper::kPersistSize = 4096;
 const std::string FilePool::kCleanChunkSuffix_ = ".clean";  // NOLINT
+const std::string FilePool::kRefillChunkSuffix_ = ".refill";  // NOLINT
 const std::chrono::milliseconds FilePool::kSuccessSleepMsec_(10);
 const std::chrono::milliseconds FilePool::kFailSleepMsec_(500);
 
@@ -201,10 +205,13 @@ int FilePoolHelper::DecodeMetaInfoFromMetaFile(
 }
 
 FilePool::FilePool(std::shared_ptr<LocalFileSystem> fsptr)
-    : currentmaxfilenum_(0) {
+    : currentmaxfilenum_(0),
+      refilling_(false),
+      metric_(std::make_shared<FilePoolMetric>()) {
     CHECK(fsptr != nullptr) << "fs ptr allocate failed!";
     fsptr_ = fsptr;
     cleanAlived_ = false;
+    zeroRangeSupported_ = true;
 
     writeBuffer_.reset(new char[poolOpt_.bytesPerWrite]);
     memset(writeBuffer_.get(), 0, poolOpt_.bytesPerWrite);
@@ -212,6 +219,14 @@ FilePool::FilePool(std::shared_ptr<LocalFileSystem> fsptr)
 
 bool FilePool::Initialize(const FilePoolOptions& cfopt) {
     poolOpt_ = cfopt;
+    if (RefillEnabled() &&
+        poolOpt_.refillHighWatermark < poolOpt_.refillLowWatermark) {
+        LOG(ERROR) << "refill high watermark "
+                   << poolOpt_.refillHighWatermark
+                   << " is less than low watermark "
+                   << poolOpt_.refillLowWatermark;
+        return false;
+    }
     if (poolOpt_.getFileFromPool) {
         if (!CheckValid()) {
             LOG(ERROR) << "check valid failed!";
@@ -271,27 +286,47 @@ bool FilePool::CleanChunk(uint64_t chunkid, bool onlyMarked) {
             LOG(ERROR) << "Fallocate file failed: " << chunkpath;
             return false;
         }
-    } else {
-        int nbytes;
-        uint64_t nwrite = 0;
-        uint64_t ntotal = chunklen;
-        uint32_t bytesPerWrite = poolOpt_.bytesPerWrite;
-        char* buffer = writeBuffer_.get();
-
-        while (nwrite < ntotal) {
-            nbytes = fsptr_->Write(fd, buffer, nwrite,
-                std::min(ntotal - nwrite, (uint64_t)bytesPerWrite));
-            if (nbytes < 0) {
-                LOG(ERROR) << "Write file failed: " << chunkpath;
-                return false;
-            } else if (fsptr_->Fsync(fd) < 0) {
-                LOG(ERROR) << "Fsync file failed: " << chunkpath;
-                return false;
-            }
+    } else if (!WriteZero(fd, chunklen)) {
+        LOG(ERROR) << "Write zero failed: " << chunkpath;
+        return false;
+    }
+
+    std::string targetpath = chunkpath + kCleanChunkSuffix_;
+    ret = fsptr_->Rename(chunkpath, targetpath);
+    if (ret < 0) {
+        LOG(ERROR) << "Rename file failed: " << chunkpath;
+        return false;
+    }
 
-            cleanThrottle_.Add(false, bytesPerWrite);
-            nwrite += nbytes;
+    return true;
+}
+
+bool FilePool::ZeroRangeChunk(uint64_t chunkid) {
+    std::string chunkpath = currentdir_ + "/" + std::to_string(chunkid);
+    int ret = fsptr_->Open(chunkpath, O_RDWR);
+    if (ret < 0) {
+        LOG(ERROR) << "Open file failed: " << chunkpath;
+        return false;
+    }
+
+    int fd = ret;
+    auto defer = [&](...){ fsptr_->Close(fd); };
+    std::shared_ptr<void> _(nullptr, defer);
+
+    uint64_t chunklen = poolOpt_.fileSize + poolOpt_.metaPageSize;
+    ret = fsptr_->Fallocate(fd, FALLOC_FL_ZERO_RANGE, 0, chunklen);
+    if (ret < 0) {
+        LOG(ERROR) << "Fallocate file failed: " << chunkpath;
+        if (ret == -EOPNOTSUPP) {
+            zeroRangeSupported_ = false;
         }
+        return false;
+    }
+    // Make the zeroed extents durable before the chunk is renamed
+    // to the clean one
+    if (fsptr_->Fsync(fd) < 0) {
+        LOG(ERROR) << "Fsync file failed: " << chunkpath;
+        return false;
     }
 
     std::string targetpath = chunkpath + kCleanChunkSuffix_;
@@ -304,6 +339,27 @@ bool FilePool::CleanChunk(uint64_t chunkid, bool onlyMarked) {
     return true;
 }
 
+bool FilePool::WriteZero(int fd, uint64_t length) {
+    int nbytes;
+    uint64_t nwrite = 0;
+    uint32_t bytesPerWrite = poolOpt_.bytesPerWrite;
+    char* buffer = writeBuffer_.get();
+
+    while (nwrite < length) {
+        nbytes = fsptr_->Write(fd, buffer, nwrite,
+            std::min(length - nwrite, (uint64_t)bytesPerWrite));
+        if (nbytes < 0) {
+            return false;
+        } else if (fsptr_->Fsync(fd) < 0) {
+            return false;
+        }
+
+        cleanThrottle_.Add(false, bytesPerWrite);
+        nwrite += nbytes;
+    }
+    return true;
+}
+
 bool FilePool::CleaningChunk() {
     auto popBack = [this](std::vector<uint64_t>* chunks,
         uint64_t* chunksLeft) -> uint64_t {
@@ -332,8 +388,16 @@ bool FilePool::CleaningChunk() {
         return false;
     }
 
-    // Fill zero to specify chunk
-    if (!CleanChunk(chunkid, false)) {
+    // Fill zero to specify chunk, the chunk is zeroed by writing if
+    // the file system turns out not to support zero range
+    bool zeroRange = poolOpt_.cleanWithZeroRange && zeroRangeSupported_;
+    bool ret = zeroRange ? ZeroRangeChunk(chunkid) : CleanChunk(chunkid, false);
+    if (!ret && zeroRange && !zeroRangeSupported_) {
+        LOG(WARNING) << "Zero range is not supported, "
+                     << "fall back to writing zeros";
+        ret = CleanChunk(chunkid, false);
+    }
+    if (!ret) {
         pushBack(&dirtyChunks_, chunkid, &currentState_.dirtyChunksLeft);
         return false;
     }
@@ -343,15 +407,103 @@ bool FilePool::CleaningChunk() {
     return true;
 }
 
+bool FilePool::NeedRefill() {
+    if (!RefillEnabled()) {
+        return false;
+    }
+
+    size_t left = Size();
+    if (refilling_ && left >= poolOpt_.refillHighWatermark) {
+        LOG(INFO) << "Stop refilling, pool size = " << left;
+        refilling_ = false;
+    } else if (!refilling_ && left < poolOpt_.refillLowWatermark) {
+        LOG(INFO) << "Start refilling, pool size = " << left;
+        refilling_ = true;
+    }
+    return refilling_;
+}
+
+bool FilePool::RefillChunk() {
+    uint64_t chunklen = poolOpt_.fileSize + poolOpt_.metaPageSize;
+    FileSystemInfo info;
+    if (fsptr_->Statfs(currentdir_, &info) < 0) {
+        LOG(ERROR) << "Statfs failed: " << currentdir_;
+        return false;
+    }
+    if (info.available < chunklen ||
+        (info.available - chunklen) * 100 <
+            info.total * poolOpt_.refillReservePercent) {
+        LOG_EVERY_N(WARNING, 100) << "Not enough space to refill pool"
+                                  << ", available = " << info.available
+                                  << ", total = " << info.total;
+        return false;
+    }
+
+    uint64_t chunkid;
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        currentmaxfilenum_.fetch_add(1);
+        chunkid = currentmaxfilenum_.load();
+    }
+    std::string chunkpath = currentdir_ + "/" + std::to_string(chunkid);
+    std::string tmppath = chunkpath + kRefillChunkSuffix_;
+
+    int fd = fsptr_->Open(tmppath, O_RDWR | O_CREAT);
+    if (fd < 0) {
+        LOG(ERROR) << "Open file failed: " << tmppath;
+        return false;
+    }
+
+    // The fallocated extents read as zero, they are written with zeros
+    // unless zero range is preferred, so that the first write to the
+    // chunk does not need to convert the unwritten extents
+    bool ok = fsptr_->Fallocate(fd, 0, 0, chunklen) == 0;
+    if (ok && !poolOpt_.cleanWithZeroRange) {
+        ok = WriteZero(fd, chunklen);
+    } else if (ok) {
+        ok = fsptr_->Fsync(fd) == 0;
+    }
+    fsptr_->Close(fd);
+    if (!ok) {
+        LOG(ERROR) << "Allocate file failed: " << tmppath;
+        fsptr_->Delete(tmppath);
+        return false;
+    }
+
+    std::string targetpath = chunkpath + kCleanChunkSuffix_;
+    if (fsptr_->Rename(tmppath, targetpath) < 0) {
+        LOG(ERROR) << "Rename file failed: " << tmppath;
+        fsptr_->Delete(tmppath);
+        return false;
+    }
+
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        cleanChunks_.push_back(chunkid);
+        currentState_.cleanChunksLeft++;
+        currentState_.preallocatedChunksLeft++;
+    }
+    metric_->refilledFiles << 1;
+    LOG(INFO) << "Refill chunk success, chunkid: " << chunkid;
+    return true;
+}
+
 void FilePool::CleanWorker() {
     auto sleepInterval = kSuccessSleepMsec_;
     while (cleanSleeper_.wait_for(sleepInterval)) {
-        sleepInterval = CleaningChunk() ? kSuccessSleepMsec_ : kFailSleepMsec_;
+        // Refilling goes first, cleaning still makes progress
+        // when there is no space to refill
+        bool ret = NeedRefill() && RefillChunk();
+        if (!ret && poolOpt_.needClean) {
+            ret = CleaningChunk();
+        }
+        sleepInterval = ret ? kSuccessSleepMsec_ : kFailSleepMsec_;
     }
 }
 
 bool FilePool::StartCleaning() {
-    if (poolOpt_.needClean && !cleanAlived_.exchange(true)) {
+    if ((poolOpt_.needClean || RefillEnabled()) &&
+        !cleanAlived_.exchange(true)) {
         ReadWriteThrottleParams params;
         params.iopsTotal = ThrottleParams(poolOpt_.iops4clean, 0, 0);
         cleanThrottle_.UpdateThrottleParams(params);
@@ -412,6 +564,7 @@ int FilePool::GetFile(const std::string& targetpath,
                       bool needClean) {
     int ret = -1;
     int retry = 0;
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
 
     while (retry < poolOpt_.retryTimes) {
         uint64_t chunkID;
@@ -420,6 +573,7 @@ int FilePool::GetFile(const std::string& targetpath,
             bool isCleaned = false;
             if (!GetChunk(needClean, &chunkID, &isCleaned)) {
                 LOG(ERROR) << "No avaliable chunk!";
+                metric_->getFileMiss << 1;
                 break;
             }
             srcpath = currentdir_ + "/" + std::to_string(chunkID);
@@ -467,6 +621,13 @@ int FilePool::GetFile(const std::string& targetpath,
         }
         retry++;
     }
+
+    if (ret == 0) {
+        if (poolOpt_.getFileFromPool) {
+            metric_->getFileHit << 1;
+        }
+        metric_->getFileLatency << TimeUtility::GetTimeofDayUs() - startUs;
+    }
     return ret;
 }
 
@@ -637,6 +798,15 @@ bool FilePool::ScanInternal() {
     for (auto& iter : tmpvec) {
         bool isCleaned = false;
         std::string chunkNum = iter;
+        // Left behind by an interrupted refilling
+        if (::curve::common::StringEndsWith(iter, kRefillChunkSuffix_)) {
+            LOG(INFO) << "delete unfinished refill file " << iter;
+            if (fsptr_->Delete(currentdir_ + "/" + iter) < 0) {
+                LOG(ERROR) << "delete file failed! [" << iter << "]";
+                return false;
+            }
+            continue;
+        }
         if (::curve::common::StringEndsWith(iter, kCleanChunkSuffix_)) {
             isCleaned = true;
             chunkNum = iter.substr(0, iter.size() - suffixLen);
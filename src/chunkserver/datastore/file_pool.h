@@ -24,6 +24,7 @@
 #define SRC_CHUNKSERVER_DATASTORE_FILE_POOL_H_
 
 #include <glog/logging.h>
+#include <bvar/bvar.h>
 
 #include <set>
 #include <mutex>  // NOLINT
@@ -63,6 +64,18 @@ struct FilePoolOptions {
     uint32_t    metaFileSize;
     // retry times for get file
     uint16_t    retryTimes;
+    // Zero the chunk by fallocate(FALLOC_FL_ZERO_RANGE) instead of
+    // writing zeros when cleaning chunk in background, it falls back to
+    // writing zeros if the file system does not support it
+    bool        cleanWithZeroRange;
+    // Allocate new files in background once the number of files left in
+    // the pool drops below refillLowWatermark, until it reaches
+    // refillHighWatermark, 0 means disable refilling
+    uint32_t    refillLowWatermark;
+    uint32_t    refillHighWatermark;
+    // Stop refilling if the free space of the disk would drop below
+    // this percent of the total space
+    uint32_t    refillReservePercent;
 
     FilePoolOptions() {
         getFileFromPool = true;
@@ -73,6 +86,10 @@ struct FilePoolOptions {
         fileSize = 0;
         metaPageSize = 0;
         retryTimes = 5;
+        cleanWithZeroRange = false;
+        refillLowWatermark = 0;
+        refillHighWatermark = 0;
+        refillReservePercent = 10;
         ::memset(metaPath, 0, 256);
         ::memset(filePoolDir, 0, 256);
     }
@@ -92,6 +109,21 @@ typedef struct FilePoolState {
     uint32_t    metaPageSize;
 } FilePoolState_t;
 
+/**
+ * Metric of FilePool
+ * getFileHit: GetFile served by a file pre-allocated in the pool
+ * getFileMiss: GetFile found the pool empty
+ * getFileLatency: latency of the successful GetFile
+ * refilledFiles: the number of files allocated by refilling
+ */
+struct FilePoolMetric {
+    bvar::Adder<uint64_t> getFileHit;
+    bvar::Adder<uint64_t> getFileMiss;
+    bvar::LatencyRecorder getFileLatency;
+    bvar::Adder<uint64_t> refilledFiles;
+};
+using FilePoolMetricPtr = std::shared_ptr<FilePoolMetric>;
+
 class FilePoolHelper {
  public:
     static const char* kFileSize;
@@ -173,6 +205,13 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
         return poolOpt_;
     }
 
+    /**
+     * Get the metric of the current FilePool
+     */
+    FilePoolMetricPtr GetMetric() const {
+        return metric_;
+    }
+
     /**
      * @brief: Return the suffix of clean chunk
      */
@@ -194,7 +233,8 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
     }
 
     /**
-     * @brief: Start thread for cleaning chunk
+     * @brief: Start thread for cleaning chunk, which also refills
+     *         the pool if refilling is enabled
      * @return: Return true if success, otherwise return false
      */
     bool StartCleaning();
@@ -244,12 +284,49 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
      */
     bool CleanChunk(uint64_t chunkid, bool onlyMarked);
 
+    /**
+     * @brief: Zero the chunk by fallocate(FALLOC_FL_ZERO_RANGE) and fsync
+     *         it before renaming it to the clean one, used by the
+     *         background cleaning only
+     * @param chunkid: The chunk to be cleaned
+     * @return: Return true if success, else return false
+     */
+    bool ZeroRangeChunk(uint64_t chunkid);
+
     /**
      * @brief: Clean chunk one by one
      * @return: Return true if clean chunk success, otherwise retrun false
      */
     bool CleaningChunk();
 
+    /**
+     * @brief: Write zeros to the file with the throttle of cleaning
+     * @param fd: The file descriptor
+     * @param length: The bytes to write from offset 0
+     * @return: Return true if success, else return false
+     */
+    bool WriteZero(int fd, uint64_t length);
+
+    /**
+     * @brief: Whether refilling is enabled by the options
+     */
+    bool RefillEnabled() const {
+        return poolOpt_.getFileFromPool && poolOpt_.refillLowWatermark > 0;
+    }
+
+    /**
+     * @brief: Whether the pool should be refilled, refilling starts when
+     *         the pool drops below the low watermark and stops when it
+     *         reaches the high watermark
+     */
+    bool NeedRefill();
+
+    /**
+     * @brief: Allocate one clean chunk and add it to the pool
+     * @return: Return true if success, else return false
+     */
+    bool RefillChunk();
+
     /**
      * @brief: The function of thread for cleaning chunk
      */
@@ -259,6 +336,10 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
     // The suffix of clean chunk file (".0")
     static const std::string kCleanChunkSuffix_;
 
+    // The suffix of chunk file being refilled, it is renamed to
+    // the clean chunk once allocated, and deleted on scan if left behind
+    static const std::string kRefillChunkSuffix_;
+
     // Sets a pause between cleaning when clean chunk success
     static const std::chrono::milliseconds kSuccessSleepMsec_;
 
@@ -304,6 +385,14 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
 
     // The buffer for write chunk file
     std::unique_ptr<char[]> writeBuffer_;
+
+    // Whether the file system supports FALLOC_FL_ZERO_RANGE
+    Atomic<bool> zeroRangeSupported_;
+
+    // Whether the pool is being refilled, only used by the clean thread
+    bool refilling_;
+
+    FilePoolMetricPtr metric_;
 };
 }   // namespace chunkserver
 }   // namespace curve
@@ -112,6 +112,11 @@ void ChunkOpRequest::RedirectChunkRequest() {
     response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED);
 }
 
+bool ChunkOpRequest::FollowerReadable() const {
+    return request_->followerread() && request_->has_appliedindex() &&
+           node_->IsFollowerReadable(request_->appliedindex());
+}
+
 int ChunkOpRequest::Encode(const ChunkRequest *request,
                            const butil::IOBuf *data,
                            butil::IOBuf *log) {
@@ -235,14 +240,34 @@ ReadChunkRequest::ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
     ChunkOpRequest(nodePtr, cntl, request, response, done),
     cloneMgr_(cloneMgr),
     concurrentApplyModule_(nodePtr->GetConcurrentApplyModule()),
-    applyIndex(0) {
+    applyIndex(0),
+    followerRead_(false) {
 }
 
 void ReadChunkRequest::Process() {
     brpc::ClosureGuard doneGuard(done_);
 
     if (!node_->IsLeaderTerm()) {
-        RedirectChunkRequest();
+        if (!FollowerReadable()) {
+            RedirectChunkRequest();
+            return;
+        }
+
+        /**
+         * follower上的日志在提交给状态机时就更新了raft的applied index，
+         * 而日志对应的写请求可能还在并发层中排队，所以读请求也放到chunk
+         * 对应的写队列中，保证排在之前的写请求之后执行
+         */
+        followerRead_ = true;
+        auto thisPtr
+            = std::dynamic_pointer_cast<ReadChunkRequest>(shared_from_this());
+        auto task = std::bind(&ReadChunkRequest::OnApply,
+                              thisPtr,
+                              node_->GetAppliedIndex(),
+                              doneGuard.release());
+        concurrentApplyModule_->Push(
+            request_->chunkid(), CHUNK_OP_TYPE::CHUNK_OP_WRITE,
+            std::move(task));
         return;
     }
 
@@ -285,7 +310,7 @@ void ReadChunkRequest::Process() {
                               node_->GetAppliedIndex(),
                               doneGuard.release());
         concurrentApplyModule_->Push(
-            request_->chunkid(), request_->optype(), task);
+            request_->chunkid(), request_->optype(), std::move(task));
         return;
     }
 
@@ -325,7 +350,12 @@ void ReadChunkRequest::OnApply(uint64_t index,
                 CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
             break;
         }
-        // 如果需要从源端拷贝数据，需要将请求转发给clone manager处理
+        // 如果需要从源端拷贝数据，需要将请求转发给clone manager处理，
+        // 拷贝的数据要经过raft写入，follower上不能处理，让client去读leader
+        if (followerRead_ && (needLazyClone || NeedClone(chunkInfo))) {
+            RedirectChunkRequest();
+            break;
+        }
         if ( needLazyClone || NeedClone(chunkInfo) ) {
             applyIndex = index;
             std::shared_ptr<CloneTask> cloneTask =
@@ -415,6 +445,15 @@ void ReadChunkRequest::ReadChunk() {
     } else if (CSErrorCode::ChunkNotExistError == ret) {
         response_->set_status(
             CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST);
+    } else if (CSErrorCode::CrcCheckError == ret) {
+        LOG(ERROR) << "read failed, data crc mismatch: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunkid: " << request_->chunkid()
+                   << " offset: " << request_->offset()
+                   << " read len :" << size;
+        response_->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL);
     } else if (CSErrorCode::InternalError == ret) {
         LOG(FATAL) << "read failed: "
                    << " logic pool id: " << request_->logicpoolid()
@@ -548,6 +587,23 @@ void WriteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
     }
 }
 
+void ReadSnapshotRequest::Process() {
+    if (node_->IsLeaderTerm() || !FollowerReadable()) {
+        ChunkOpRequest::Process();
+        return;
+    }
+
+    // 快照数据不会再变化，数据足够新的follower可以直接读取，
+    // 与ReadChunk相同，放到并发层中排在之前的写请求之后执行
+    brpc::ClosureGuard doneGuard(done_);
+    auto task = std::bind(&ChunkOpRequest::OnApply,
+                          shared_from_this(),
+                          node_->GetAppliedIndex(),
+                          doneGuard.release());
+    node_->GetConcurrentApplyModule()->Push(
+        request_->chunkid(), request_->optype(), std::move(task));
+}
+
 void ReadSnapshotRequest::OnApply(uint64_t index,
                                   ::google::protobuf::Closure *done) {
     brpc::ClosureGuard doneGuard(done);
@@ -874,25 +930,9 @@ void ScanChunkRequest::OnApply(uint64_t index,
     // read and calculate crc, build scanmap
     uint32_t crc = 0;
     size_t size = request_->size();
-    std::unique_ptr<char[]> readBuffer(new(std::nothrow)char[size]);
-    CHECK(nullptr != readBuffer)
-        << "new readBuffer failed " << strerror(errno);
-    // scan chunk metapage or user data
-    auto ret = 0;
-    if (request_->has_readmetapage() && request_->readmetapage()) {
-        ret = datastore_->ReadChunkMetaPage(request_->chunkid(),
-                                            request_->sn(),
-                                            readBuffer.get());
-    } else {
-        ret = datastore_->ReadChunk(request_->chunkid(),
-                                    request_->sn(),
-                                    readBuffer.get(),
-                                    request_->offset(),
-                                    size);
-    }
+    auto ret = ScanChunk(datastore_, *request_, &crc);
 
     if (CSErrorCode::Success == ret) {
-        crc = ::curve::common::CRC32(readBuffer.get(), size);
         // build scanmap
         ScanMap scanMap;
         scanMap.set_logicalpoolid(request_->logicpoolid());
@@ -929,26 +969,9 @@ void ScanChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,  /
                                                const butil::IOBuf &data) {
     uint32_t crc = 0;
     size_t size = request.size();
-    std::unique_ptr<char[]> readBuffer(new(std::nothrow)char[size]);
-    CHECK(nullptr != readBuffer)
-        << "new readBuffer failed " << strerror(errno);
-
-    // scan chunk metapage or user data
-    auto ret = 0;
-    if (request.has_readmetapage() && request.readmetapage()) {
-        ret = datastore->ReadChunkMetaPage(request.chunkid(),
-                                            request.sn(),
-                                            readBuffer.get());
-    } else {
-        ret = datastore->ReadChunk(request.chunkid(),
-                                    request.sn(),
-                                    readBuffer.get(),
-                                    request.offset(),
-                                    size);
-    }
+    auto ret = ScanChunk(datastore, request, &crc);
 
     if (CSErrorCode::Success == ret) {
-        crc = ::curve::common::CRC32(readBuffer.get(), size);
         BuildAndSendScanMap(request, index_, crc);
     } else if (CSErrorCode::ChunkNotExistError == ret) {
         LOG(ERROR) << "scan failed: chunk not exist, "
@@ -977,6 +1000,64 @@ void ScanChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,  /
     }
 }
 
+CSErrorCode ScanChunkRequest::ScanChunk(
+    std::shared_ptr<CSDataStore> datastore,
+    const ChunkRequest &request, uint32_t *crc) {
+    size_t size = request.size();
+    ScanMetric& metric = ScanMetric::GetInstance();
+    // compare the crcs of data blocks, the data is also verified against
+    // the crc table kept in metapage
+    if (request.has_crcblocksize() && request.crcblocksize() > 0) {
+        uint32_t badBlocks = 0;
+        CSErrorCode ret = datastore->GetChunkBlockCrc(request.chunkid(),
+                                                      request.offset(),
+                                                      size,
+                                                      request.crcblocksize(),
+                                                      crc,
+                                                      &badBlocks);
+        if (CSErrorCode::Success == ret) {
+            metric.scannedBytes << size;
+            if (badBlocks > 0) {
+                metric.crcMismatchBlocks << badBlocks;
+                LOG(ERROR) << "scan found data mismatching the crc table,"
+                           << " logic pool id: " << request.logicpoolid()
+                           << " copyset id: " << request.copysetid()
+                           << " chunkid: " << request.chunkid()
+                           << " offset: " << request.offset()
+                           << " len: " << size
+                           << " bad blocks: " << badBlocks;
+            }
+        }
+        return ret;
+    }
+
+    std::unique_ptr<char[]> readBuffer(new(std::nothrow)char[size]);
+    CHECK(nullptr != readBuffer)
+        << "new readBuffer failed " << strerror(errno);
+
+    // scan chunk metapage or user data
+    CSErrorCode ret;
+    if (request.has_readmetapage() && request.readmetapage()) {
+        // the metapage is the first range scanned of a chunk, any change
+        // applied after it makes the chunk dirty again
+        datastore->MarkChunkScanned(request.chunkid());
+        ret = datastore->ReadChunkMetaPage(request.chunkid(),
+                                           request.sn(),
+                                           readBuffer.get());
+    } else {
+        ret = datastore->ReadChunk(request.chunkid(),
+                                   request.sn(),
+                                   readBuffer.get(),
+                                   request.offset(),
+                                   size);
+    }
+    if (CSErrorCode::Success == ret) {
+        *crc = ::curve::common::CRC32(readBuffer.get(), size);
+        metric.scannedBytes << size;
+    }
+    return ret;
+}
+
 void ScanChunkRequest::BuildAndSendScanMap(const ChunkRequest &request,
                                            uint64_t index, uint32_t crc) {
     // send rpc to leader
@@ -122,6 +122,12 @@ class ChunkOpRequest : public std::enable_shared_from_this<ChunkOpRequest> {
      */
     virtual void RedirectChunkRequest();
 
+    /**
+     * 请求读取的是不可变的数据，并且当前follower的数据足够新，
+     * 可以不经过raft直接处理
+     */
+    bool FollowerReadable() const;
+
  public:
     /**
      * Op序列化工具函数
@@ -209,7 +215,8 @@ class ReadChunkRequest : public ChunkOpRequest {
 
  public:
     ReadChunkRequest() :
-        ChunkOpRequest() {}
+        ChunkOpRequest(),
+        followerRead_(false) {}
     ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
                      CloneManager* cloneMgr,
                      RpcController *cntl,
@@ -241,6 +248,8 @@ class ReadChunkRequest : public ChunkOpRequest {
     ConcurrentApplyModule* concurrentApplyModule_;
     // 保存 apply index
     uint64_t applyIndex;
+    // 是否由follower直接处理
+    bool followerRead_;
 };
 
 class WriteChunkRequest : public ChunkOpRequest {
@@ -281,6 +290,7 @@ class ReadSnapshotRequest : public ChunkOpRequest {
                        done) {}
     virtual ~ReadSnapshotRequest() = default;
 
+    void Process() override;
     void OnApply(uint64_t index, ::google::protobuf::Closure *done) override;
     void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
                         const ChunkRequest &request,
@@ -386,6 +396,13 @@ class ScanChunkRequest : public ChunkOpRequest {
  private:
     void BuildAndSendScanMap(const ChunkRequest &request, uint64_t index,
                              uint32_t crc);
+    /**
+     * Calculate the crc of the scan range, the range is the metapage,
+     * the data blocks crc table or the raw data
+     */
+    static CSErrorCode ScanChunk(std::shared_ptr<CSDataStore> datastore,
+                                 const ChunkRequest &request,
+                                 uint32_t *crc);
     ScanManager* scanManager_;
     uint64_t index_;
     PeerId peer_;
@@ -94,9 +94,19 @@ int CurveSegment::create() {
     }
     _meta.bytes += _meta_page_size;
     _update_meta_page();
+    _init_sync_group();
     return _fd >= 0 ? 0 : -1;
 }
 
+void CurveSegment::_init_sync_group() {
+    if (FLAGS_walGroupSync && !FLAGS_enableWalDirectWrite && _is_open) {
+        _sync_group = WalSyncGroup::GetGroup(_path);
+        LOG_IF(WARNING, _sync_group == nullptr)
+            << "Fail to get wal sync group of " << _path
+            << ", sync the segment alone";
+    }
+}
+
 struct CurveSegment::EntryHeader {
     int64_t term;
     int type;
@@ -223,6 +233,7 @@ int CurveSegment::load(braft::ConfigurationManager* configuration_manager) {
     ::lseek(_fd, entry_off, SEEK_SET);
 
     _meta.bytes = entry_off;
+    _init_sync_group();
     return ret;
 }
 
@@ -625,6 +636,9 @@ int CurveSegment::sync(bool will_sync) {
         // CHECK(_is_open);
         if (!FLAGS_enableWalDirectWrite && braft::FLAGS_raft_sync
                                             && will_sync) {
+            if (_sync_group != nullptr) {
+                return _sync_group->Sync(_fd);
+            }
             return braft::raft_fsync(_fd);
         } else {
             return 0;
@@ -55,6 +55,7 @@
 #include <string>
 #include "src/chunkserver/datastore/file_pool.h"
 #include "src/chunkserver/raftlog/segment.h"
+#include "src/chunkserver/raftlog/wal_sync_group.h"
 
 namespace curve {
 namespace chunkserver {
@@ -76,7 +77,8 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
         _first_index(first_index), _last_index(first_index - 1),
         _checksum_type(checksum_type),
         _walFilePool(walFilePool),
-        _meta_page_size(walFilePool->GetFilePoolOpt().metaPageSize) {
+        _meta_page_size(walFilePool->GetFilePoolOpt().metaPageSize),
+        _sync_group(nullptr) {
     }
     CurveSegment(const std::string& path, const int64_t first_index,
                  const int64_t last_index, int checksum_type,
@@ -86,7 +88,8 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
         _first_index(first_index), _last_index(last_index),
         _checksum_type(checksum_type),
         _walFilePool(walFilePool),
-        _meta_page_size(walFilePool->GetFilePoolOpt().metaPageSize) {
+        _meta_page_size(walFilePool->GetFilePoolOpt().metaPageSize),
+        _sync_group(nullptr) {
     }
     ~CurveSegment() {
         if (_fd >= 0) {
@@ -162,6 +165,8 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
 
     int _update_meta_page();
 
+    void _init_sync_group();
+
     std::string _path;
     CurveSegmentMeta _meta;
     mutable braft::raft_mutex_t _mutex;
@@ -174,6 +179,8 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
     std::vector<std::pair<int64_t, int64_t> > _offset_and_term;
     std::shared_ptr<FilePool> _walFilePool;
     uint32_t _meta_page_size;
+    // group sync of the wal on the same disk, nullptr if disabled
+    WalSyncGroup* _sync_group;
 };
 
 }  // namespace chunkserver
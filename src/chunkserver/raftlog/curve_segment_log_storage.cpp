@@ -40,6 +40,7 @@
 
 #include <braft/protobuf_file.h>
 #include <braft/local_storage.pb.h>
+#include <butil/time.h>
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
 #include "src/chunkserver/datastore/file_pool.h"
 #include "src/chunkserver/raftlog/define.h"
@@ -418,7 +419,17 @@ int CurveSegmentLogStorage::append_entry(const braft::LogEntry* entry) {
     }
     _last_log_index.fetch_add(1, butil::memory_order_release);
 
-    return segment->sync(_enable_sync);
+    return sync_segment(segment);
+}
+
+int CurveSegmentLogStorage::sync_segment(
+                    const scoped_refptr<Segment>& segment) {
+    butil::Timer timer;
+    timer.start();
+    int ret = segment->sync(_enable_sync);
+    timer.stop();
+    _sync_latency << timer.u_elapsed();
+    return ret;
 }
 
 int CurveSegmentLogStorage::append_entries(
@@ -449,7 +460,7 @@ int CurveSegmentLogStorage::append_entries(
         _last_log_index.fetch_add(1, butil::memory_order_release);
         last_segment = segment;
     }
-    last_segment->sync(_enable_sync);
+    sync_segment(last_segment);
     return entries.size();
 }
 
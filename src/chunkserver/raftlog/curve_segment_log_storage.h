@@ -47,6 +47,7 @@
 #include <braft/log_entry.h>
 #include <braft/storage.h>
 #include <braft/util.h>
+#include <bvar/bvar.h>
 #include <map>
 #include <vector>
 #include <string>
@@ -165,6 +166,11 @@ class CurveSegmentLogStorage : public braft::LogStorage {
 
     LogStorageStatus GetStatus();
 
+    // latency of syncing the wal after append
+    bvar::LatencyRecorder* GetSyncLatencyRecorder() {
+        return &_sync_latency;
+    }
+
  private:
     scoped_refptr<Segment> open_segment(size_t to_write);
     int save_meta(const int64_t log_index);
@@ -172,6 +178,7 @@ class CurveSegmentLogStorage : public braft::LogStorage {
     int list_segments(bool is_empty);
     int load_segments(braft::ConfigurationManager* configuration_manager);
     int get_segment(int64_t log_index, scoped_refptr<Segment>* ptr);
+    int sync_segment(const scoped_refptr<Segment>& segment);
     void pop_segments(
             int64_t first_index_kept,
             std::vector<scoped_refptr<Segment> >* poped);
@@ -190,6 +197,7 @@ class CurveSegmentLogStorage : public braft::LogStorage {
     std::shared_ptr<FilePool> _walFilePool;
     int _checksum_type;
     bool _enable_sync;
+    bvar::LatencyRecorder _sync_latency;
 };
 
 }  // namespace chunkserver
@@ -0,0 +1,669 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-24
+ */
+
+#include <braft/fsync.h>
+#include <braft/util.h>
+#include <butil/crc32c.h>
+#include <butil/fd_utility.h>
+#include <butil/file_util.h>
+#include <butil/files/dir_reader_posix.h>
+#include <butil/files/file_path.h>
+#include <butil/raw_pack.h>
+#include <butil/string_printf.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "src/chunkserver/raftlog/define.h"
+#include "src/chunkserver/raftlog/shared_wal.h"
+
+namespace curve {
+namespace chunkserver {
+
+DEFINE_uint64(sharedWalFileSize, 64 * 1024 * 1024,
+              "size of one file of the shared wal");
+
+namespace {
+
+uint32_t GetChecksum(int checksumType, const char* data, size_t len) {
+    if (checksumType == CHECKSUM_CRC32) {
+        return braft::crc32(data, len);
+    }
+    return braft::murmurhash32(data, len);
+}
+
+uint32_t GetChecksum(int checksumType, const butil::IOBuf& data) {
+    if (checksumType == CHECKSUM_CRC32) {
+        return braft::crc32(data);
+    }
+    return braft::murmurhash32(data);
+}
+
+}  // namespace
+
+SharedWal::WalFile::~WalFile() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+SharedWal::SharedWal(const std::string& dir, const std::string& copysetRoot,
+                     uint64_t fileSize)
+    : dir_(dir),
+      copysetRoot_(copysetRoot),
+      fileSize_(fileSize),
+      checksumType_(CHECKSUM_MURMURHASH32),
+      syncGroup_(nullptr),
+      current_(nullptr),
+      writeOffset_(0) {}
+
+SharedWal::~SharedWal() {}
+
+int SharedWal::Init() {
+    butil::FilePath dirPath(dir_);
+    butil::File::Error e;
+    if (!butil::CreateDirectoryAndGetError(dirPath, &e, true)) {
+        LOG(ERROR) << "Fail to create " << dir_ << " : " << e;
+        return -1;
+    }
+    if (butil::crc32c::IsFastCrc32Supported()) {
+        checksumType_ = CHECKSUM_CRC32;
+    }
+
+    std::vector<uint64_t> ids;
+    butil::DirReaderPosix dirReader(dir_.c_str());
+    if (!dirReader.IsValid()) {
+        LOG(ERROR) << "Fail to read dir " << dir_;
+        return -1;
+    }
+    while (dirReader.Next()) {
+        uint64_t id = 0;
+        if (sscanf(dirReader.name(), SHARED_WAL_FILE_PATTERN, &id) == 1) {
+            ids.push_back(id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    for (uint64_t id : ids) {
+        std::string path = dir_ + "/" +
+                           butil::string_printf(SHARED_WAL_FILE_PATTERN, id);
+        int fd = ::open(path.c_str(), O_RDWR | O_NOATIME);
+        if (fd < 0) {
+            PLOG(ERROR) << "Fail to open " << path;
+            return -1;
+        }
+        butil::make_close_on_exec(fd);
+        WalFilePtr file = std::make_shared<WalFile>(id, fd, path);
+        files_[id] = file;
+        if (ReplayFile(file) != 0) {
+            return -1;
+        }
+    }
+
+    // always append to a new file, the tail of the last one may be torn
+    if (OpenNewFileLocked() != 0) {
+        return -1;
+    }
+    if (FLAGS_walGroupSync) {
+        syncGroup_ = WalSyncGroup::GetGroup(dir_);
+    }
+    LOG(INFO) << "Init shared wal " << dir_ << " success, replayed "
+              << ids.size() << " files of " << logs_.size() << " copysets";
+    return 0;
+}
+
+int SharedWal::ReplayFile(const WalFilePtr& file) {
+    uint64_t offset = 0;
+    uint64_t count = 0;
+    while (true) {
+        RecordHeader header;
+        butil::IOBuf data;
+        int ret = LoadRecord(file, offset, &header, &data);
+        if (ret != 0) {
+            LOG_IF(WARNING, ret < 0) << "Stop replaying " << file->path
+                                     << " at corrupted offset " << offset;
+            break;
+        }
+        ApplyRecord(file, header, offset);
+        offset += kSharedWalHeaderSize + header.dataLen;
+        ++count;
+    }
+    LOG(INFO) << "Replayed " << count << " records of " << file->path;
+    return 0;
+}
+
+void SharedWal::ApplyRecord(const WalFilePtr& file,
+                            const RecordHeader& header, uint64_t offset) {
+    CopysetLog& log = logs_[header.copysetId];
+    switch (header.type) {
+    case RECORD_TYPE_RESET:
+        log.entries.clear();
+        log.firstIndex = header.index;
+        return;
+    case RECORD_TYPE_TRUNCATE_SUFFIX:
+        while (!log.entries.empty() && log.lastIndex() > header.index) {
+            log.entries.pop_back();
+        }
+        return;
+    default:
+        break;
+    }
+
+    int64_t index = header.index;
+    if (log.entries.empty() || index < log.firstIndex ||
+        index > log.lastIndex() + 1) {
+        // the entries before are truncated, or in the deleted files
+        log.entries.clear();
+        log.firstIndex = index;
+    } else {
+        // the conflicting entries are overwritten
+        while (log.lastIndex() >= index) {
+            log.entries.pop_back();
+        }
+    }
+    Location location;
+    location.fileId = file->id;
+    location.offset = offset;
+    location.length = kSharedWalHeaderSize + header.dataLen;
+    location.term = header.term;
+    location.type = header.type;
+    log.entries.push_back(location);
+
+    int64_t& maxIndex = file->maxIndex[header.copysetId];
+    maxIndex = std::max(maxIndex, index);
+}
+
+int SharedWal::LoadRecord(const WalFilePtr& file, uint64_t offset,
+                          RecordHeader* header, butil::IOBuf* data) {
+    butil::IOPortal buf;
+    ssize_t n = braft::file_pread(&buf, file->fd, offset,
+                                  kSharedWalHeaderSize);
+    if (n != static_cast<ssize_t>(kSharedWalHeaderSize)) {
+        return n < 0 ? -1 : 1;
+    }
+
+    char headerBuf[kSharedWalHeaderSize];
+    const char* p = static_cast<const char*>(
+        buf.fetch(headerBuf, kSharedWalHeaderSize));
+    uint32_t magic = 0;
+    uint32_t metaField = 0;
+    uint64_t term = 0;
+    uint64_t index = 0;
+    uint32_t headerChecksum = 0;
+    butil::RawUnpacker unpacker(p);
+    unpacker.unpack32(magic)
+            .unpack32(metaField)
+            .unpack64(header->copysetId)
+            .unpack64(term)
+            .unpack64(index)
+            .unpack32(header->dataLen)
+            .unpack32(header->dataChecksum)
+            .unpack32(headerChecksum);
+    if (magic != kSharedWalMagic) {
+        // zero means the end of the file
+        return magic == 0 ? 1 : -1;
+    }
+    header->type = metaField >> 24;
+    header->checksumType = (metaField << 8) >> 24;
+    header->term = static_cast<int64_t>(term);
+    header->index = static_cast<int64_t>(index);
+    if (headerChecksum != GetChecksum(header->checksumType, p,
+                                      kSharedWalHeaderSize - 4)) {
+        LOG(ERROR) << "Found corrupted header at offset " << offset
+                   << " of " << file->path;
+        return -1;
+    }
+
+    if (data != nullptr) {
+        butil::IOPortal body;
+        n = braft::file_pread(&body, file->fd, offset + kSharedWalHeaderSize,
+                              header->dataLen);
+        if (n != static_cast<ssize_t>(header->dataLen)) {
+            return n < 0 ? -1 : 1;
+        }
+        if (header->dataChecksum != GetChecksum(header->checksumType, body)) {
+            LOG(ERROR) << "Found corrupted data at offset " << offset
+                       << " of " << file->path;
+            return -1;
+        }
+        data->swap(body);
+    }
+    return 0;
+}
+
+void SharedWal::EncodeRecord(int type, uint64_t copysetId, int64_t term,
+                             int64_t index, butil::IOBuf* data,
+                             butil::IOBuf* out) {
+    char header[kSharedWalHeaderSize];
+    const uint32_t metaField = (type << 24) | (checksumType_ << 16);
+    butil::RawPacker packer(header);
+    packer.pack32(kSharedWalMagic)
+          .pack32(metaField)
+          .pack64(copysetId)
+          .pack64(term)
+          .pack64(index)
+          .pack32(data->length())
+          .pack32(GetChecksum(checksumType_, *data));
+    packer.pack32(GetChecksum(checksumType_, header,
+                              kSharedWalHeaderSize - 4));
+    out->append(header, kSharedWalHeaderSize);
+    out->append(*data);
+}
+
+int SharedWal::OpenNewFileLocked() {
+    uint64_t id = files_.empty() ? 1 : files_.rbegin()->first + 1;
+    std::string path = dir_ + "/" +
+                       butil::string_printf(SHARED_WAL_FILE_PATTERN, id);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_NOATIME,
+                    0644);
+    if (fd < 0) {
+        PLOG(ERROR) << "Fail to create " << path;
+        return -1;
+    }
+    butil::make_close_on_exec(fd);
+
+    // make the new file durable in the dir
+    int dirFd = ::open(dir_.c_str(), O_RDONLY);
+    if (dirFd < 0 || braft::raft_fsync(dirFd) != 0) {
+        PLOG(ERROR) << "Fail to sync dir " << dir_;
+        if (dirFd >= 0) {
+            ::close(dirFd);
+        }
+        ::close(fd);
+        return -1;
+    }
+    ::close(dirFd);
+
+    current_ = std::make_shared<WalFile>(id, fd, path);
+    files_[id] = current_;
+    writeOffset_ = 0;
+    LOG(INFO) << "Open new shared wal file " << path;
+    return 0;
+}
+
+int64_t SharedWal::WriteLocked(butil::IOBuf* records) {
+    if (writeOffset_ > 0 && writeOffset_ + records->length() > fileSize_) {
+        if (OpenNewFileLocked() != 0) {
+            return -1;
+        }
+    }
+
+    int64_t offset = writeOffset_;
+    while (!records->empty()) {
+        ssize_t n = records->pcut_into_file_descriptor(
+            current_->fd, writeOffset_, records->length());
+        if (n < 0) {
+            PLOG(ERROR) << "Fail to write " << current_->path;
+            // the tail of the file may be torn, so the records after it
+            // could not be replayed, write the following ones to a new file
+            OpenNewFileLocked();
+            return -1;
+        }
+        writeOffset_ += n;
+    }
+    return offset;
+}
+
+int SharedWal::SyncFile(const WalFilePtr& file) {
+    if (syncGroup_ != nullptr) {
+        return syncGroup_->Sync(file->fd);
+    }
+    return braft::raft_fsync(file->fd) == 0 ? 0 : -errno;
+}
+
+int SharedWal::Attach(uint64_t copysetId, int64_t firstIndex, bool fresh,
+                      braft::ConfigurationManager* confManager,
+                      int64_t* lastIndex) {
+    if (fresh && Reset(copysetId, firstIndex) != 0) {
+        return -1;
+    }
+
+    std::vector<std::pair<int64_t, Location>> confs;
+    std::unordered_map<uint64_t, WalFilePtr> confFiles;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        CopysetLog& log = logs_[copysetId];
+        while (!log.entries.empty() && log.firstIndex < firstIndex) {
+            log.entries.pop_front();
+            ++log.firstIndex;
+        }
+        if (log.entries.empty()) {
+            log.firstIndex = firstIndex;
+        } else if (log.firstIndex > firstIndex) {
+            LOG(ERROR) << "Entries of copyset " << copysetId << " in ["
+                       << firstIndex << ", " << log.firstIndex
+                       << ") are lost in shared wal " << dir_;
+            return -1;
+        }
+        log.attached = true;
+        *lastIndex = log.lastIndex();
+
+        for (size_t i = 0; i < log.entries.size(); ++i) {
+            const Location& location = log.entries[i];
+            if (location.type == braft::ENTRY_TYPE_CONFIGURATION) {
+                confs.emplace_back(log.firstIndex + i, location);
+                confFiles[location.fileId] = files_[location.fileId];
+            }
+        }
+    }
+
+    for (const auto& conf : confs) {
+        RecordHeader header;
+        butil::IOBuf data;
+        const WalFilePtr& file = confFiles[conf.second.fileId];
+        if (LoadRecord(file, conf.second.offset, &header, &data) != 0) {
+            return -1;
+        }
+        scoped_refptr<braft::LogEntry> entry = new braft::LogEntry();
+        entry->id.index = conf.first;
+        entry->id.term = header.term;
+        butil::Status status = braft::parse_configuration_meta(data, entry);
+        if (!status.ok()) {
+            LOG(ERROR) << "Fail to parse configuration of copyset "
+                       << copysetId << " at index " << conf.first;
+            return -1;
+        }
+        confManager->add(braft::ConfigurationEntry(*entry));
+    }
+    return 0;
+}
+
+void SharedWal::Detach(uint64_t copysetId) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto iter = logs_.find(copysetId);
+    if (iter != logs_.end()) {
+        iter->second.attached = false;
+    }
+}
+
+int SharedWal::Append(uint64_t copysetId,
+                      const std::vector<braft::LogEntry*>& entries,
+                      bool sync) {
+    butil::IOBuf records;
+    std::vector<RecordHeader> headers;
+    headers.reserve(entries.size());
+    for (const braft::LogEntry* entry : entries) {
+        butil::IOBuf data;
+        switch (entry->type) {
+        case braft::ENTRY_TYPE_DATA:
+            data.append(entry->data);
+            break;
+        case braft::ENTRY_TYPE_NO_OP:
+            break;
+        case braft::ENTRY_TYPE_CONFIGURATION:
+            {
+                butil::Status status =
+                    braft::serialize_configuration_meta(entry, data);
+                if (!status.ok()) {
+                    LOG(ERROR) << "Fail to serialize ConfigurationPBMeta"
+                               << ", copyset: " << copysetId;
+                    return 0;
+                }
+            }
+            break;
+        default:
+            LOG(FATAL) << "unknow entry type: " << entry->type
+                       << ", copyset: " << copysetId;
+            return 0;
+        }
+
+        RecordHeader header;
+        header.type = entry->type;
+        header.checksumType = checksumType_;
+        header.copysetId = copysetId;
+        header.term = entry->id.term;
+        header.index = entry->id.index;
+        header.dataLen = data.length();
+        header.dataChecksum = 0;
+        headers.push_back(header);
+        EncodeRecord(entry->type, copysetId, entry->id.term, entry->id.index,
+                     &data, &records);
+    }
+
+    WalFilePtr file;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        int64_t offset = WriteLocked(&records);
+        if (offset < 0) {
+            return 0;
+        }
+        file = current_;
+        for (const auto& header : headers) {
+            ApplyRecord(file, header, offset);
+            offset += kSharedWalHeaderSize + header.dataLen;
+        }
+    }
+
+    if (sync) {
+        int ret = SyncFile(file);
+        if (ret != 0) {
+            LOG(ERROR) << "Fail to sync " << file->path << ", error: "
+                       << strerror(-ret);
+            return 0;
+        }
+    }
+    return entries.size();
+}
+
+braft::LogEntry* SharedWal::Get(uint64_t copysetId, int64_t index) {
+    Location location;
+    WalFilePtr file;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        auto iter = logs_.find(copysetId);
+        if (iter == logs_.end()) {
+            return nullptr;
+        }
+        const CopysetLog& log = iter->second;
+        if (index < log.firstIndex || index > log.lastIndex()) {
+            return nullptr;
+        }
+        location = log.entries[index - log.firstIndex];
+        auto fileIter = files_.find(location.fileId);
+        if (fileIter == files_.end()) {
+            return nullptr;
+        }
+        file = fileIter->second;
+    }
+
+    RecordHeader header;
+    butil::IOBuf data;
+    if (LoadRecord(file, location.offset, &header, &data) != 0) {
+        return nullptr;
+    }
+    CHECK_EQ(copysetId, header.copysetId);
+    CHECK_EQ(index, header.index);
+    braft::LogEntry* entry = new braft::LogEntry();
+    entry->AddRef();
+    switch (header.type) {
+    case braft::ENTRY_TYPE_DATA:
+        entry->data.swap(data);
+        break;
+    case braft::ENTRY_TYPE_NO_OP:
+        CHECK(data.empty()) << "Data of NO_OP must be empty";
+        break;
+    case braft::ENTRY_TYPE_CONFIGURATION:
+        {
+            butil::Status status =
+                braft::parse_configuration_meta(data, entry);
+            if (!status.ok()) {
+                LOG(WARNING) << "Fail to parse ConfigurationPBMeta"
+                             << ", copyset: " << copysetId;
+                entry->Release();
+                return nullptr;
+            }
+        }
+        break;
+    default:
+        CHECK(false) << "Unknown entry type, copyset: " << copysetId;
+        break;
+    }
+    entry->id.index = index;
+    entry->id.term = header.term;
+    entry->type = static_cast<braft::EntryType>(header.type);
+    return entry;
+}
+
+int64_t SharedWal::GetTerm(uint64_t copysetId, int64_t index) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto iter = logs_.find(copysetId);
+    if (iter == logs_.end()) {
+        return 0;
+    }
+    const CopysetLog& log = iter->second;
+    if (index < log.firstIndex || index > log.lastIndex()) {
+        return 0;
+    }
+    return log.entries[index - log.firstIndex].term;
+}
+
+int SharedWal::WriteControlRecord(int type, uint64_t copysetId,
+                                  int64_t index) {
+    butil::IOBuf data;
+    butil::IOBuf record;
+    EncodeRecord(type, copysetId, 0, index, &data, &record);
+
+    WalFilePtr file;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        int64_t offset = WriteLocked(&record);
+        if (offset < 0) {
+            return -1;
+        }
+        file = current_;
+        RecordHeader header;
+        header.type = type;
+        header.checksumType = checksumType_;
+        header.copysetId = copysetId;
+        header.term = 0;
+        header.index = index;
+        header.dataLen = 0;
+        header.dataChecksum = 0;
+        ApplyRecord(file, header, offset);
+    }
+    return SyncFile(file) == 0 ? 0 : -1;
+}
+
+int SharedWal::TruncateSuffix(uint64_t copysetId, int64_t lastIndexKept) {
+    return WriteControlRecord(RECORD_TYPE_TRUNCATE_SUFFIX, copysetId,
+                              lastIndexKept);
+}
+
+int SharedWal::Reset(uint64_t copysetId, int64_t nextLogIndex) {
+    return WriteControlRecord(RECORD_TYPE_RESET, copysetId, nextLogIndex);
+}
+
+void SharedWal::TruncatePrefix(uint64_t copysetId, int64_t firstIndexKept) {
+    std::vector<WalFilePtr> removed;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        CopysetLog& log = logs_[copysetId];
+        while (!log.entries.empty() && log.firstIndex < firstIndexKept) {
+            log.entries.pop_front();
+            ++log.firstIndex;
+        }
+        if (log.entries.empty()) {
+            log.firstIndex = std::max(log.firstIndex, firstIndexKept);
+        }
+        CollectGarbageLocked(&removed);
+    }
+
+    for (const auto& file : removed) {
+        int ret = ::unlink(file->path.c_str());
+        LOG_IF(INFO, ret == 0) << "Deleted shared wal file " << file->path;
+        PLOG_IF(ERROR, ret != 0) << "Fail to delete " << file->path;
+    }
+}
+
+void SharedWal::CollectGarbageLocked(std::vector<WalFilePtr>* removed) {
+    // only the oldest files are deleted, so the truncate_suffix and reset
+    // records are never deleted before the entries they drop
+    for (auto iter = files_.begin(); iter != files_.end();) {
+        if (iter->second == current_ || IsFileInUseLocked(iter->second)) {
+            break;
+        }
+        removed->push_back(iter->second);
+        iter = files_.erase(iter);
+    }
+}
+
+bool SharedWal::IsFileInUseLocked(const WalFilePtr& file) {
+    for (const auto& item : file->maxIndex) {
+        auto iter = logs_.find(item.first);
+        if (iter == logs_.end()) {
+            continue;
+        }
+        const CopysetLog& log = iter->second;
+        if (!log.attached) {
+            // the copyset dir is moved to trash when the copyset is
+            // deleted, otherwise the copyset is not loaded yet
+            std::string path = copysetRoot_ + "/" +
+                               std::to_string(item.first);
+            if (::access(path.c_str(), F_OK) == 0) {
+                return true;
+            }
+            continue;
+        }
+        if (item.second >= log.firstIndex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t SharedWal::FileCount() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return files_.size();
+}
+
+SharedWal* SharedWal::GetInstance(const std::string& logPath) {
+    // logPath is <copyset root>/<group id>/log, and the shared wal is
+    // placed beside the copyset root
+    butil::FilePath copysetRoot = butil::FilePath(logPath).DirName().DirName();
+    std::string dir = copysetRoot.DirName().Append(SHARED_WAL_DIR).value();
+
+    // the instances live as long as the process
+    static std::mutex mtx;
+    static std::map<std::string, SharedWal*>* instances =
+        new std::map<std::string, SharedWal*>();
+    std::lock_guard<std::mutex> lk(mtx);
+    auto iter = instances->find(dir);
+    if (iter != instances->end()) {
+        return iter->second;
+    }
+
+    SharedWal* wal = new SharedWal(dir, copysetRoot.value(),
+                                   FLAGS_sharedWalFileSize);
+    if (wal->Init() != 0) {
+        delete wal;
+        return nullptr;
+    }
+    instances->emplace(dir, wal);
+    return wal;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-24
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_H_
+#define SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_H_
+
+#include <braft/configuration_manager.h>
+#include <braft/log_entry.h>
+#include <butil/iobuf.h>
+#include <gflags/gflags.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/chunkserver/raftlog/wal_sync_group.h"
+
+namespace curve {
+namespace chunkserver {
+
+DECLARE_uint64(sharedWalFileSize);
+
+#define SHARED_WAL_DIR "shared_wal"
+#define SHARED_WAL_FILE_PATTERN "shared_wal_%020" PRIu64
+
+// Format of record header, all fields are in network order
+// | ------------------------- magic (32bits) ------------------------- |
+// | record-type (8bits) | checksum_type (8bits) | reserved (16bits)   |
+// | ----------------------- copyset id (64bits) ---------------------- |
+// | -------------------------- term (64bits) ------------------------- |
+// | -------------------------- index (64bits) ------------------------ |
+// | ------------------------ data len (32bits) ----------------------- |
+// | data_checksum (32bits) | header checksum (32bits)                  |
+const size_t kSharedWalHeaderSize = 44;
+const uint32_t kSharedWalMagic = 0x43535741;
+
+// types of the records other than the braft entry types
+enum SharedWalRecordType {
+    // drop the entries of the copyset after index
+    RECORD_TYPE_TRUNCATE_SUFFIX = 100,
+    // drop all the entries of the copyset, the next one is index
+    RECORD_TYPE_RESET = 101,
+};
+
+/**
+ * One append-only log stream shared by all the copysets on a disk.
+ *
+ * The log entries of all the copysets are appended to the current file
+ * of the stream, so the wal writes of the disk are sequential no matter
+ * how many copysets there are. The stream is split into files of
+ * FLAGS_sharedWalFileSize, the index of every copyset is kept in memory
+ * and rebuilt by replaying all the files on start. truncate_suffix and
+ * reset are recorded in the stream, truncate_prefix is recorded in the
+ * log meta of the copyset by the caller. The oldest files are deleted
+ * once none of the entries in them are needed by any copyset.
+ */
+class SharedWal {
+ public:
+    SharedWal(const std::string& dir, const std::string& copysetRoot,
+              uint64_t fileSize);
+    ~SharedWal();
+
+    /**
+     * Replay the files in dir to rebuild the index of all the copysets,
+     * and open a new file to append
+     * @return: 0 on success, -1 on failure
+     */
+    int Init();
+
+    /**
+     * Attach a copyset to the stream when its log storage is inited
+     * @param copysetId: id of the copyset
+     * @param firstIndex: first log index in the log meta of the copyset
+     * @param fresh: the copyset has no log meta, entries in the stream
+     *               left by an old copyset with the same id are dropped
+     * @param confManager: configuration entries are added to it
+     * @param lastIndex: last log index of the copyset
+     * @return: 0 on success, -1 on failure
+     */
+    int Attach(uint64_t copysetId, int64_t firstIndex, bool fresh,
+               braft::ConfigurationManager* confManager,
+               int64_t* lastIndex);
+
+    void Detach(uint64_t copysetId);
+
+    /**
+     * Append the entries of a copyset and sync them if sync is true
+     * @return: number of entries appended
+     */
+    int Append(uint64_t copysetId,
+               const std::vector<braft::LogEntry*>& entries, bool sync);
+
+    braft::LogEntry* Get(uint64_t copysetId, int64_t index);
+
+    // @return: term of the entry, 0 if it doesn't exist
+    int64_t GetTerm(uint64_t copysetId, int64_t index);
+
+    // drop the entries before firstIndexKept and delete the useless files
+    void TruncatePrefix(uint64_t copysetId, int64_t firstIndexKept);
+
+    // @return: 0 on success, -1 on failure
+    int TruncateSuffix(uint64_t copysetId, int64_t lastIndexKept);
+
+    // @return: 0 on success, -1 on failure
+    int Reset(uint64_t copysetId, int64_t nextLogIndex);
+
+    // @return: number of files of the stream
+    uint32_t FileCount();
+
+    /**
+     * Get the stream of the disk where the copyset log is located,
+     * the stream is created and inited on first use
+     * @param logPath: <copyset root>/<group id>/log
+     * @return: nullptr on failure
+     */
+    static SharedWal* GetInstance(const std::string& logPath);
+
+ private:
+    struct WalFile {
+        WalFile(uint64_t id, int fd, const std::string& path)
+            : id(id), fd(fd), path(path) {}
+        ~WalFile();
+
+        uint64_t id;
+        int fd;
+        std::string path;
+        // copyset id => max index of the copyset's entries in the file
+        std::unordered_map<uint64_t, int64_t> maxIndex;
+    };
+    using WalFilePtr = std::shared_ptr<WalFile>;
+
+    struct Location {
+        uint64_t fileId;
+        uint64_t offset;
+        uint32_t length;
+        int64_t term;
+        int type;
+    };
+
+    struct CopysetLog {
+        CopysetLog() : firstIndex(1), attached(false) {}
+        int64_t lastIndex() const {
+            return firstIndex + static_cast<int64_t>(entries.size()) - 1;
+        }
+
+        // index of entries.front(), or the next index if entries is empty
+        int64_t firstIndex;
+        std::deque<Location> entries;
+        bool attached;
+    };
+
+    struct RecordHeader {
+        int type;
+        int checksumType;
+        uint64_t copysetId;
+        int64_t term;
+        int64_t index;
+        uint32_t dataLen;
+        uint32_t dataChecksum;
+    };
+
+    int ReplayFile(const WalFilePtr& file);
+
+    void ApplyRecord(const WalFilePtr& file, const RecordHeader& header,
+                     uint64_t offset);
+
+    // load the record at offset, data is not loaded if nullptr
+    // @return: 0 on success, 1 on incomplete record, -1 on corruption
+    int LoadRecord(const WalFilePtr& file, uint64_t offset,
+                   RecordHeader* header, butil::IOBuf* data);
+
+    void EncodeRecord(int type, uint64_t copysetId, int64_t term,
+                      int64_t index, butil::IOBuf* data, butil::IOBuf* out);
+
+    // write the records to the current file, must hold mtx_
+    // @return: offset written to, -1 on failure
+    int64_t WriteLocked(butil::IOBuf* records);
+
+    // must hold mtx_
+    int OpenNewFileLocked();
+
+    int SyncFile(const WalFilePtr& file);
+
+    int WriteControlRecord(int type, uint64_t copysetId, int64_t index);
+
+    // must hold mtx_
+    void CollectGarbageLocked(std::vector<WalFilePtr>* removed);
+
+    // must hold mtx_
+    bool IsFileInUseLocked(const WalFilePtr& file);
+
+ private:
+    std::string dir_;
+    std::string copysetRoot_;
+    uint64_t fileSize_;
+    int checksumType_;
+    // nullptr if group sync is disabled
+    WalSyncGroup* syncGroup_;
+
+    std::mutex mtx_;
+    // file id => file, the last one is the current file to append
+    std::map<uint64_t, WalFilePtr> files_;
+    WalFilePtr current_;
+    uint64_t writeOffset_;
+    std::unordered_map<uint64_t, CopysetLog> logs_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_H_
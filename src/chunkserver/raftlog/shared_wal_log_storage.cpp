@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-24
+ */
+
+#include <braft/local_storage.pb.h>
+#include <braft/protobuf_file.h>
+#include <butil/file_util.h>
+#include <butil/files/file_path.h>
+#include <butil/strings/string_number_conversions.h>
+#include <butil/time.h>
+#include "src/chunkserver/raftlog/shared_wal_log_storage.h"
+#include "src/chunkserver/raftlog/define.h"
+
+namespace curve {
+namespace chunkserver {
+
+void RegisterSharedWalLogStorageOrDie() {
+    static SharedWalLogStorage logStorage;
+    braft::log_storage_extension()->RegisterOrDie(
+                                    "curve_shared", &logStorage);
+}
+
+SharedWalLogStorage::~SharedWalLogStorage() {
+    if (_wal != nullptr) {
+        _wal->Detach(_copyset_id);
+    }
+}
+
+int SharedWalLogStorage::init(
+                    braft::ConfigurationManager* configuration_manager) {
+    butil::FilePath dir_path(_path);
+    std::string group_id = dir_path.DirName().BaseName().value();
+    if (!butil::StringToUint64(group_id, &_copyset_id)) {
+        LOG(ERROR) << "Invalid log path of shared wal: " << _path;
+        return -1;
+    }
+
+    butil::File::Error e;
+    if (!butil::CreateDirectoryAndGetError(
+                dir_path, &e, braft::FLAGS_raft_create_parent_directories)) {
+        LOG(ERROR) << "Fail to create " << dir_path.value() << " : " << e;
+        return -1;
+    }
+
+    _wal = SharedWal::GetInstance(_path);
+    if (_wal == nullptr) {
+        LOG(ERROR) << "Fail to get shared wal, path: " << _path;
+        return -1;
+    }
+
+    bool fresh = false;
+    if (load_meta() != 0) {
+        if (errno != ENOENT) {
+            return -1;
+        }
+        LOG(WARNING) << _path << " is empty";
+        fresh = true;
+        _first_log_index.store(1);
+        if (save_meta(1) != 0) {
+            return -1;
+        }
+    }
+
+    int64_t last_index = 0;
+    if (_wal->Attach(_copyset_id, first_log_index(), fresh,
+                     configuration_manager, &last_index) != 0) {
+        LOG(ERROR) << "Fail to attach to shared wal, path: " << _path;
+        return -1;
+    }
+    _last_log_index.store(last_index);
+    LOG(INFO) << "Init shared wal log storage " << _path
+              << " first_log_index: " << first_log_index()
+              << " last_log_index: " << last_index;
+    return 0;
+}
+
+int SharedWalLogStorage::load_meta() {
+    std::string meta_path(_path);
+    meta_path.append("/" BRAFT_SEGMENT_META_FILE);
+
+    braft::ProtoBufFile pb_file(meta_path);
+    braft::LogPBMeta meta;
+    if (0 != pb_file.load(&meta)) {
+        PLOG_IF(ERROR, errno != ENOENT)
+                << "Fail to load meta from " << meta_path;
+        return -1;
+    }
+    _first_log_index.store(meta.first_log_index());
+    return 0;
+}
+
+int SharedWalLogStorage::save_meta(const int64_t log_index) {
+    butil::Timer timer;
+    timer.start();
+
+    std::string meta_path(_path);
+    meta_path.append("/" BRAFT_SEGMENT_META_FILE);
+
+    braft::LogPBMeta meta;
+    meta.set_first_log_index(log_index);
+    braft::ProtoBufFile pb_file(meta_path);
+    int ret = pb_file.save(&meta, braft::raft_sync_meta());
+
+    timer.stop();
+    PLOG_IF(ERROR, ret != 0) << "Fail to save meta to " << meta_path;
+    LOG(INFO) << "log save_meta " << meta_path << " first_log_index: "
+              << log_index << " time: " << timer.u_elapsed();
+    return ret;
+}
+
+braft::LogEntry* SharedWalLogStorage::get_entry(const int64_t index) {
+    if (index < first_log_index() || index > last_log_index()) {
+        return NULL;
+    }
+    return _wal->Get(_copyset_id, index);
+}
+
+int64_t SharedWalLogStorage::get_term(const int64_t index) {
+    if (index < first_log_index() || index > last_log_index()) {
+        return 0;
+    }
+    return _wal->GetTerm(_copyset_id, index);
+}
+
+int SharedWalLogStorage::append_entry(const braft::LogEntry* entry) {
+    std::vector<braft::LogEntry*> entries(
+        1, const_cast<braft::LogEntry*>(entry));
+    return append_entries(entries, NULL) == 1 ? 0 : EIO;
+}
+
+int SharedWalLogStorage::append_entries(
+                    const std::vector<braft::LogEntry*>& entries,
+                    braft::IOMetric* metric) {
+    if (entries.empty()) {
+        return 0;
+    }
+    if (_last_log_index.load(butil::memory_order_relaxed) + 1
+            != entries.front()->id.index) {
+        LOG(FATAL) << "There's gap between appending entries and"
+                   << " _last_log_index path: " << _path;
+        return -1;
+    }
+    int ret = _wal->Append(_copyset_id, entries, braft::FLAGS_raft_sync);
+    _last_log_index.fetch_add(ret, butil::memory_order_release);
+    return ret;
+}
+
+int SharedWalLogStorage::truncate_prefix(const int64_t first_index_kept) {
+    if (first_log_index() >= first_index_kept) {
+        return 0;
+    }
+    // save meta first like CurveSegmentLogStorage, the new process would
+    // see the latest first_log_index even if the process crashes
+    if (save_meta(first_index_kept) != 0) {
+        PLOG(ERROR) << "Fail to save meta, path: " << _path;
+        return -1;
+    }
+    _first_log_index.store(first_index_kept, butil::memory_order_release);
+    if (last_log_index() < first_index_kept - 1) {
+        _last_log_index.store(first_index_kept - 1,
+                              butil::memory_order_release);
+    }
+    _wal->TruncatePrefix(_copyset_id, first_index_kept);
+    return 0;
+}
+
+int SharedWalLogStorage::truncate_suffix(const int64_t last_index_kept) {
+    if (_wal->TruncateSuffix(_copyset_id, last_index_kept) != 0) {
+        LOG(ERROR) << "Fail to truncate suffix to " << last_index_kept
+                   << ", path: " << _path;
+        return -1;
+    }
+    _last_log_index.store(last_index_kept, butil::memory_order_release);
+    return 0;
+}
+
+int SharedWalLogStorage::reset(const int64_t next_log_index) {
+    if (next_log_index <= 0) {
+        LOG(ERROR) << "Invalid next_log_index=" << next_log_index
+                   << " path: " << _path;
+        return EINVAL;
+    }
+    // the reset record must be durable before the meta, otherwise the
+    // stale entries after next_log_index would be loaded after restart
+    if (_wal->Reset(_copyset_id, next_log_index) != 0) {
+        LOG(ERROR) << "Fail to reset shared wal, path: " << _path;
+        return -1;
+    }
+    _first_log_index.store(next_log_index, butil::memory_order_relaxed);
+    _last_log_index.store(next_log_index - 1, butil::memory_order_relaxed);
+    if (save_meta(next_log_index) != 0) {
+        PLOG(ERROR) << "Fail to save meta, path: " << _path;
+        return -1;
+    }
+    return 0;
+}
+
+braft::LogStorage* SharedWalLogStorage::new_instance(
+    const std::string& uri) const {
+    return new SharedWalLogStorage(uri);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-24
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_LOG_STORAGE_H_
+#define SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_LOG_STORAGE_H_
+
+#include <butil/atomicops.h>
+#include <braft/log_entry.h>
+#include <braft/storage.h>
+#include <string>
+#include <vector>
+#include "src/chunkserver/raftlog/shared_wal.h"
+
+namespace curve {
+namespace chunkserver {
+
+void RegisterSharedWalLogStorageOrDie();
+
+// LogStorage of the "curve_shared" scheme, the entries of all the copysets
+// on a disk are appended to one SharedWal, only the log meta which records
+// the first log index is kept in the log dir of the copyset.
+//
+// log uri: curve_shared://<copyset root>/<group id>/log
+class SharedWalLogStorage : public braft::LogStorage {
+ public:
+    explicit SharedWalLogStorage(const std::string& path)
+        : _path(path)
+        , _copyset_id(0)
+        , _wal(nullptr)
+        , _first_log_index(1)
+        , _last_log_index(0)
+    {}
+
+    SharedWalLogStorage()
+        : _copyset_id(0)
+        , _wal(nullptr)
+        , _first_log_index(1)
+        , _last_log_index(0)
+    {}
+
+    virtual ~SharedWalLogStorage();
+
+    // init logstorage, attach the copyset to the shared wal of the disk
+    virtual int init(braft::ConfigurationManager* configuration_manager);
+
+    virtual int64_t first_log_index() {
+        return _first_log_index.load(butil::memory_order_acquire);
+    }
+
+    virtual int64_t last_log_index() {
+        return _last_log_index.load(butil::memory_order_acquire);
+    }
+
+    virtual braft::LogEntry* get_entry(const int64_t index);
+
+    virtual int64_t get_term(const int64_t index);
+
+    virtual int append_entry(const braft::LogEntry* entry);
+
+    virtual int append_entries(const std::vector<braft::LogEntry*>& entries,
+                               braft::IOMetric* metric);
+
+    virtual int truncate_prefix(const int64_t first_index_kept);
+
+    virtual int truncate_suffix(const int64_t last_index_kept);
+
+    virtual int reset(const int64_t next_log_index);
+
+    virtual LogStorage* new_instance(const std::string& uri) const;
+
+ private:
+    int save_meta(const int64_t log_index);
+    int load_meta();
+
+    std::string _path;
+    uint64_t _copyset_id;
+    SharedWal* _wal;
+    butil::atomic<int64_t> _first_log_index;
+    butil::atomic<int64_t> _last_log_index;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_LOG_STORAGE_H_
@@ -0,0 +1,229 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-22
+ */
+
+#include <braft/fsync.h>
+#include <butil/time.h>
+#include <glog/logging.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <errno.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+
+#include "src/chunkserver/raftlog/wal_sync_group.h"
+
+namespace curve {
+namespace chunkserver {
+
+DEFINE_bool(walGroupSync, false, "sync the wal of all the copysets on"
+            " one disk in group, only works without wal direct write");
+DEFINE_uint32(walGroupSyncMaxDelayUs, 200, "max time in us to wait for"
+              " more wal sync requests of a group sync window");
+DEFINE_uint32(walGroupSyncMaxBatch, 256, "max number of wal sync requests"
+              " of a group sync window");
+
+WalSyncGroup::WalSyncGroup(const std::string& name)
+    : name_(name),
+      maxDelayUs_(0),
+      maxBatch_(1),
+      running_(false) {}
+
+WalSyncGroup::~WalSyncGroup() {
+    Stop();
+}
+
+int WalSyncGroup::Start(uint32_t maxDelayUs, uint32_t maxBatch) {
+    if (running_.load()) {
+        return 0;
+    }
+    if (maxBatch == 0) {
+        LOG(ERROR) << "Invalid max batch of wal sync group " << name_;
+        return -1;
+    }
+    maxDelayUs_ = maxDelayUs;
+    maxBatch_ = maxBatch;
+
+    std::string prefix = "wal_sync_group_" + name_;
+    requestCount_.expose_as(prefix, "request_count");
+    windowCount_.expose_as(prefix, "window_count");
+    syncCount_.expose_as(prefix, "sync_count");
+    windowSize_.expose(prefix, "window_size");
+    windowLatency_.expose(prefix, "window_lat");
+
+    ring_.reset(new curve::fs::IOUring());
+    if (ring_->Init(maxBatch_) != 0) {
+        LOG(WARNING) << "io_uring is not supported, wal sync group "
+                     << name_ << " syncs the files one by one";
+        ring_.reset();
+    }
+
+    running_.store(true);
+    thread_ = std::thread(&WalSyncGroup::Run, this);
+    LOG(INFO) << "Start wal sync group " << name_
+              << ", max delay us: " << maxDelayUs_
+              << ", max batch: " << maxBatch_;
+    return 0;
+}
+
+void WalSyncGroup::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<bthread::Mutex> lk(mtx_);
+        queueCond_.notify_all();
+    }
+    thread_.join();
+    if (ring_ != nullptr) {
+        ring_->Fini();
+        ring_.reset();
+    }
+    LOG(INFO) << "Stop wal sync group " << name_;
+}
+
+int WalSyncGroup::Sync(int fd) {
+    requestCount_ << 1;
+    SyncRequest request(fd);
+    std::unique_lock<bthread::Mutex> lk(mtx_);
+    if (!running_.load()) {
+        lk.unlock();
+        return braft::raft_fsync(fd) == 0 ? 0 : -errno;
+    }
+    queue_.push_back(&request);
+    queueCond_.notify_one();
+    while (!request.done) {
+        doneCond_.wait(lk);
+    }
+    return request.result;
+}
+
+void WalSyncGroup::Run() {
+    std::vector<SyncRequest*> batch;
+    while (true) {
+        {
+            std::unique_lock<bthread::Mutex> lk(mtx_);
+            while (running_.load() && queue_.empty()) {
+                queueCond_.wait(lk);
+            }
+            if (queue_.empty()) {
+                break;
+            }
+
+            // wait for the requests of the other copysets in this window
+            int64_t deadline = butil::gettimeofday_us() + maxDelayUs_;
+            while (running_.load() && queue_.size() < maxBatch_) {
+                int64_t now = butil::gettimeofday_us();
+                if (now >= deadline) {
+                    break;
+                }
+                queueCond_.wait_for(lk, deadline - now);
+            }
+
+            size_t count = std::min<size_t>(queue_.size(), maxBatch_);
+            batch.assign(queue_.begin(), queue_.begin() + count);
+            queue_.erase(queue_.begin(), queue_.begin() + count);
+        }
+
+        SyncBatch(batch);
+    }
+}
+
+void WalSyncGroup::SyncBatch(const std::vector<SyncRequest*>& batch) {
+    butil::Timer timer;
+    timer.start();
+
+    // the segment of a copyset may be synced more than once in a window
+    std::unordered_map<int, int> results;
+    std::vector<int> fds;
+    for (auto request : batch) {
+        if (results.emplace(request->fd, 0).second) {
+            fds.push_back(request->fd);
+        }
+    }
+
+    std::vector<int> rets;
+    if (ring_ != nullptr) {
+        bool datasync = !braft::FLAGS_raft_use_fsync_rather_than_fdatasync;
+        ring_->FsyncBatch(fds, datasync, &rets);
+    } else {
+        for (int fd : fds) {
+            rets.push_back(braft::raft_fsync(fd) == 0 ? 0 : -errno);
+        }
+    }
+    for (size_t i = 0; i < fds.size(); ++i) {
+        LOG_IF(ERROR, rets[i] != 0) << "Fail to sync wal fd " << fds[i]
+                                    << " in group " << name_
+                                    << ", error: " << strerror(-rets[i]);
+        results[fds[i]] = rets[i];
+    }
+
+    {
+        std::lock_guard<bthread::Mutex> lk(mtx_);
+        for (auto request : batch) {
+            request->result = results[request->fd];
+            request->done = true;
+        }
+        doneCond_.notify_all();
+    }
+
+    timer.stop();
+    windowCount_ << 1;
+    syncCount_ << fds.size();
+    windowSize_ << batch.size();
+    windowLatency_ << timer.u_elapsed();
+}
+
+WalSyncGroup* WalSyncGroup::GetGroup(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        LOG(ERROR) << "Fail to stat " << path << ", error: "
+                   << strerror(errno);
+        return nullptr;
+    }
+
+    // the groups live as long as the process
+    static std::mutex mtx;
+    static std::map<dev_t, WalSyncGroup*>* groups =
+        new std::map<dev_t, WalSyncGroup*>();
+    std::lock_guard<std::mutex> lk(mtx);
+    auto iter = groups->find(st.st_dev);
+    if (iter != groups->end()) {
+        return iter->second;
+    }
+
+    std::string name = std::to_string(major(st.st_dev)) + "_"
+                     + std::to_string(minor(st.st_dev));
+    WalSyncGroup* group = new WalSyncGroup(name);
+    if (group->Start(FLAGS_walGroupSyncMaxDelayUs,
+                     FLAGS_walGroupSyncMaxBatch) != 0) {
+        delete group;
+        return nullptr;
+    }
+    groups->emplace(st.st_dev, group);
+    return group;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-22
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_WAL_SYNC_GROUP_H_
+#define SRC_CHUNKSERVER_RAFTLOG_WAL_SYNC_GROUP_H_
+
+#include <bthread/condition_variable.h>
+#include <bthread/mutex.h>
+#include <bvar/bvar.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/fs/iouring.h"
+
+namespace curve {
+namespace chunkserver {
+
+DECLARE_bool(walGroupSync);
+DECLARE_uint32(walGroupSyncMaxDelayUs);
+DECLARE_uint32(walGroupSyncMaxBatch);
+
+/**
+ * Group commit of the wal syncs of all the copysets on one disk.
+ *
+ * The sync requests arriving within one window (at most maxDelayUs after
+ * the first one, or maxBatch requests) are handled together: each fd is
+ * synced once, and all the fdatasyncs are submitted with one
+ * io_uring_enter(), so the file system merges them into one journal
+ * commit and one device cache flush. Falls back to fdatasync one by one
+ * if io_uring is not supported.
+ */
+class WalSyncGroup {
+ public:
+    explicit WalSyncGroup(const std::string& name);
+    ~WalSyncGroup();
+
+    /**
+     * Start the sync thread
+     * @param maxDelayUs: max time to wait for more requests after the
+     *                    first one of a window, 0 means no waiting
+     * @param maxBatch: max number of requests of a window
+     * @return: 0 on success, -1 on failure
+     */
+    int Start(uint32_t maxDelayUs, uint32_t maxBatch);
+
+    /**
+     * Stop the sync thread, the queued requests are synced before return
+     */
+    void Stop();
+
+    /**
+     * Wait until fd is synced in a window
+     * @return: 0 on success, -errno on failure
+     */
+    int Sync(int fd);
+
+    /**
+     * Get the group of the disk where the path is located, the group is
+     * created and started with the flags on first use
+     * @return: nullptr if the path doesn't exist
+     */
+    static WalSyncGroup* GetGroup(const std::string& path);
+
+ private:
+    struct SyncRequest {
+        explicit SyncRequest(int fd) : fd(fd), result(0), done(false) {}
+        int fd;
+        int result;
+        bool done;
+    };
+
+    void Run();
+
+    void SyncBatch(const std::vector<SyncRequest*>& batch);
+
+ private:
+    std::string name_;
+    uint32_t maxDelayUs_;
+    uint32_t maxBatch_;
+
+    bthread::Mutex mtx_;
+    // signaled when a request is queued
+    bthread::ConditionVariable queueCond_;
+    // signaled when a window is synced
+    bthread::ConditionVariable doneCond_;
+    std::vector<SyncRequest*> queue_;
+
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    // nullptr if io_uring is not supported
+    std::unique_ptr<curve::fs::IOUring> ring_;
+
+    // number of sync requests of the copysets
+    bvar::Adder<uint64_t> requestCount_;
+    // number of windows
+    bvar::Adder<uint64_t> windowCount_;
+    // number of fdatasyncs issued to the disk
+    bvar::Adder<uint64_t> syncCount_;
+    // requests per window
+    bvar::LatencyRecorder windowSize_;
+    // time to sync one window
+    bvar::LatencyRecorder windowLatency_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_WAL_SYNC_GROUP_H_
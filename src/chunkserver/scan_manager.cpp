@@ -35,6 +35,7 @@ int ScanManager::Init(const ScanManagerOptions &options) {
     timeoutMs_ = options.timeoutMs;
     retry_ = options.retry;
     retryIntervalUs_ = options.retryIntervalUs;
+    fullScanIntervalSec_ = options.fullScanIntervalSec;
     jobWaitInterval_.Init(options.intervalSec * 1000);
     // reuse timeout 1000ms as send scan task interval
     scanTaskWaitInterval_.Init(options.timeoutMs);
@@ -113,14 +114,15 @@ void ScanManager::StartScanJob(ScanKey key) {
         return;
     }
 
-    LOG(INFO) << "Start scan job(" << key.first
-              << ", " << key.second << ").";
     std::shared_ptr<ScanJob> job = std::make_shared<ScanJob>();
     job->poolId = key.first;
     job->id = key.second;
     job->type = ScanType::Init;
     job->isFinished = true;
     job->dataStore = nodePtr->GetDataStore();
+    job->fullScan = NeedFullScan(key);
+    LOG(INFO) << "Start " << (job->fullScan ? "full" : "incremental")
+              << " scan job(" << key.first << ", " << key.second << ").";
     nodePtr->SetScan(true);
     nodePtr->GetFailedScanMap().clear();
     jobMapLock_.WRLock();
@@ -156,7 +158,7 @@ bool ScanManager::GenScanJob(std::shared_ptr<ScanJob> job) {
     bool done = false;
     switch (job->type) {
         case ScanType::Init:
-            job->chunkMap = job->dataStore->GetChunkMap();
+            CollectChunks(job);
             job->type = ScanType::NewMap;
             break;
         case ScanType::NewMap:
@@ -225,10 +227,21 @@ int ScanManager::ScanJobProcess(const std::shared_ptr<ScanJob> job) {
     while (iter != job->chunkMap.end()) {
         // check chunk version
         auto csChunkFile = iter->second;
-        if (csChunkFile->GetChunkFileMetaPage().version !=
-            FORMAT_VERSION_V2) {
+        uint8_t version = csChunkFile->GetChunkFileMetaPage().version;
+        if (version != FORMAT_VERSION_V2 && version != FORMAT_VERSION_V3) {
             iter++;
         } else {
+            // chunk with data crc table compares the block crcs, which
+            // also verifies the data read against the table
+            uint32_t crcBlockSize = 0;
+            if (version == FORMAT_VERSION_V3) {
+                crcBlockSize =
+                    csChunkFile->GetChunkFileMetaPage().crcBlockSize;
+                // the scan slices must be made of whole blocks
+                if (crcBlockSize == 0 || scanSize_ % crcBlockSize != 0) {
+                    crcBlockSize = 0;
+                }
+            }
             // split scan chunk request
             uint32_t currentOffset = 0;
             bool scanChunkMetaPage = true;
@@ -236,6 +249,8 @@ int ScanManager::ScanJobProcess(const std::shared_ptr<ScanJob> job) {
                 // check is leader, if not cancel the job
                 if (!nodePtr->IsLeaderTerm() ||
                     toStop_.load(std::memory_order_acquire)) {
+                    // the chunk may be marked scanned before canceled
+                    csChunkFile->SetScanDirty(true);
                     CancelScanJob(job->poolId, job->id);
                     return -1;
                 }
@@ -271,6 +286,9 @@ int ScanManager::ScanJobProcess(const std::shared_ptr<ScanJob> job) {
                     request->set_size(chunkMetaPageSize_);
                 } else {
                     request->set_size(scanSize_);
+                    if (crcBlockSize > 0) {
+                        request->set_crcblocksize(crcBlockSize);
+                    }
                 }
                 ScanChunkClosure *done = new ScanChunkClosure(request,
                                                               response);
@@ -416,6 +434,10 @@ void ScanManager::ScanJobFinish(std::shared_ptr<ScanJob> job) {
         uint64_t now = ::curve::common::TimeUtility::GetTimeofDaySec();
         nodePtr->SetLastScan(now);
         nodePtr->SetScan(false);
+        if (job->fullScan) {
+            LockGuard guard(lastFullScanLock_);
+            lastFullScanSec_[key] = now;
+        }
         WriteLockGuard writeGuard(jobMapLock_);
         jobs_.erase(key);
         LOG(INFO) << "Scan job (" << key.first << ", "
@@ -432,6 +454,47 @@ std::shared_ptr<ScanJob> ScanManager::GetJob(ScanKey key) {
     return nullptr;
 }
 
+bool ScanManager::NeedFullScan(ScanKey key) {
+    if (fullScanIntervalSec_ == 0) {
+        return true;
+    }
+    uint64_t now = ::curve::common::TimeUtility::GetTimeofDaySec();
+    LockGuard guard(lastFullScanLock_);
+    // the chunks are all dirty after the chunkserver started, so the first
+    // incremental scan scans all of them, count the full scan from now
+    auto iter = lastFullScanSec_.find(key);
+    if (iter == lastFullScanSec_.end()) {
+        lastFullScanSec_.emplace(key, now);
+        return false;
+    }
+    return now - iter->second >= fullScanIntervalSec_;
+}
+
+void ScanManager::CollectChunks(std::shared_ptr<ScanJob> job) {
+    uint64_t skippedBytes = 0;
+    job->chunkMap.clear();
+    // visit the chunks in place rather than copying the whole chunk map,
+    // as an incremental scan only takes the changed chunks
+    job->dataStore->ForEachChunk(
+        [this, &job, &skippedBytes](ChunkID id, const CSChunkFilePtr& chunk) {
+            if (job->fullScan || chunk->IsScanDirty()) {
+                job->chunkMap.emplace(id, chunk);
+            } else {
+                skippedBytes += chunkSize_;
+            }
+        });
+
+    if (job->fullScan) {
+        ScanMetric::GetInstance().fullScanCount << 1;
+        return;
+    }
+    ScanMetric::GetInstance().incrementalScanCount << 1;
+    ScanMetric::GetInstance().skippedBytes << skippedBytes;
+    LOG(INFO) << "Incremental scan job(" << job->poolId << ", " << job->id
+              << "), skip " << skippedBytes << " bytes of unchanged chunks, "
+              << job->chunkMap.size() << " chunks to scan.";
+}
+
 void ScanManager::SetScanJobType(ScanKey key, ScanType type) {
     auto job = GetJob(key);
     if (nullptr != job) {
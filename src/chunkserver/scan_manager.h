@@ -24,6 +24,7 @@
 #define SRC_CHUNKSERVER_SCAN_MANAGER_H_
 
 #include <google/protobuf/util/message_differencer.h>
+#include <bvar/bvar.h>
 #include <vector>
 #include <memory>
 #include <utility>
@@ -41,6 +42,8 @@
 
 using curve::common::Thread;
 using curve::common::RWLock;
+using curve::common::Mutex;
+using curve::common::LockGuard;
 using curve::common::WaitInterval;
 
 namespace curve {
@@ -62,9 +65,40 @@ struct ScanManagerOptions {
     uint64_t timeoutMs;
     uint32_t retry;
     uint64_t retryIntervalUs;
+    // the interval of full scan of a copyset, the scans between two full
+    // scans only scan the chunks changed since last scan,
+    // 0 means always full scan. A full scan reads the data of every chunk,
+    // and verifies it against the data crc table if the chunk has one
+    uint64_t fullScanIntervalSec = 0;
     CopysetNodeManager* copysetNodeManager;
 };
 
+/**
+ * scan metric, the bytes are counted on all the replicas
+ */
+struct ScanMetric {
+    // bytes read from disk to build the scanmap
+    bvar::Adder<uint64_t> scannedBytes;
+    // data blocks mismatching the crc table kept in metapage
+    bvar::Adder<uint64_t> crcMismatchBlocks;
+    // bytes of the unchanged chunks skipped by incremental scan
+    bvar::Adder<uint64_t> skippedBytes;
+    bvar::Adder<uint64_t> fullScanCount;
+    bvar::Adder<uint64_t> incrementalScanCount;
+
+    ScanMetric()
+        : scannedBytes("chunkserver_scan_scanned_bytes"),
+          crcMismatchBlocks("chunkserver_scan_crc_mismatch_blocks"),
+          skippedBytes("chunkserver_scan_skipped_bytes"),
+          fullScanCount("chunkserver_scan_full_count"),
+          incrementalScanCount("chunkserver_scan_incremental_count") {}
+
+    static ScanMetric& GetInstance() {
+        static ScanMetric metric;
+        return metric;
+    }
+};
+
 /**
  *  scan state machine type
  */
@@ -95,7 +129,9 @@ struct ScanJob {
     RWLock taskLock;
     ChunkMap chunkMap;
     std::shared_ptr<CSDataStore> dataStore;
-    ScanJob() : type(ScanType::Init) {}
+    // scan all the chunks or only the changed ones
+    bool fullScan;
+    ScanJob() : type(ScanType::Init), fullScan(true) {}
 };
 
 class ScanManager {
@@ -234,6 +270,20 @@ class ScanManager {
      */
     std::shared_ptr<ScanJob> GetJob(ScanKey key);
 
+    /**
+     * @brief decide whether the scan of copyset should be a full scan
+     * @param[in] key: the key of copyset
+     * @return true if full scan interval passed since last full scan
+     */
+    bool NeedFullScan(ScanKey key);
+
+    /**
+     * @brief collect the chunks to scan into the job, the chunks not
+     *        changed since last scan are skipped by incremental scan
+     * @param[in] job: the scan job
+     */
+    void CollectChunks(std::shared_ptr<ScanJob> job);
+
     // scan process thread
     Thread scanThread_;
     std::atomic<bool> toStop_;
@@ -250,6 +300,10 @@ class ScanManager {
     uint64_t timeoutMs_;
     uint32_t retry_;
     uint64_t retryIntervalUs_;
+    uint64_t fullScanIntervalSec_;
+    // the time of last full scan of the copysets
+    std::map<ScanKey, uint64_t> lastFullScanSec_;
+    Mutex lastFullScanLock_;
 };
 }  // namespace chunkserver
 }  // namespace curve
@@ -192,7 +192,11 @@ void ClientClosure::Run() {
         case CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED:
             MetricHelper::IncremRedirectRPCCount(fileMetric_, reqCtx_->optype_);
             needRetry = true;
-            OnRedirected();
+            // follower的数据不够新时拒绝处理，重试时发送给leader，
+            // 不需要更新leader信息
+            if (!reqDone_->IsFollowerRead()) {
+                OnRedirected();
+            }
             break;
 
         // 2.2 Copyset不存在，大概率都是配置变更了
@@ -253,6 +257,13 @@ void ClientClosure::Run() {
         }
     }
 
+    if (reqDone_->IsFollowerRead()) {
+        bool failed = status_ != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS &&
+                      status_ != CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST;
+        client_->GetReplicaSelector()->OnDone(
+            chunkserverID_, cntl_->latency_us(), failed);
+    }
+
     if (needRetry) {
         doneGuard.release();
         OnRetry();
@@ -544,6 +555,14 @@ void ReadChunkSnapClosure::OnSuccess() {
     ClientClosure::OnSuccess();
 
     reqCtx_->readData_ = cntl_->response_attachment();
+
+    // 记录copyset的appliedindex，之后的读请求可以由follower处理
+    if (response_->has_appliedindex()) {
+        metaCache_->UpdateAppliedIndex(
+            reqCtx_->idinfo_.lpid_,
+            reqCtx_->idinfo_.cpid_,
+            response_->appliedindex());
+    }
 }
 
 void DeleteChunkSnapClosure::SendRetryRequest() {
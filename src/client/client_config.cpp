@@ -75,6 +75,12 @@ int ClientConfig::Init(const std::string& configpath) {
     LOG_IF(ERROR, ret == false) << "config no chunkserver.enableAppliedIndexRead info";     // NOLINT
     RETURN_IF_FALSE(ret);
 
+    ret = conf_.GetBoolValue("chunkserver.enableFollowerRead",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableFollowerRead);          // NOLINT
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.enableFollowerRead info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableFollowerRead;
+
     ret = conf_.GetUInt32Value("chunkserver.opMaxRetry",
           &fileServiceOption_.ioOpt.ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry);    // NOLINT
     LOG_IF(ERROR, ret == false) << "config no chunkserver.opMaxRetry info";
@@ -159,6 +165,24 @@ int ClientConfig::Init(const std::string& configpath) {
     LOG_IF(ERROR, ret == false) << "config no schedule.threadpoolSize info";
     RETURN_IF_FALSE(ret);
 
+    ret = conf_.GetBoolValue("schedule.coalesce.enable",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.coalesce.enable info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceOpt.enable;
+
+    ret = conf_.GetUInt32Value("schedule.coalesce.maxBytes",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceOpt.maxBytes);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.coalesce.maxBytes info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceOpt.maxBytes;
+
+    ret = conf_.GetUInt32Value("schedule.coalesce.maxDelayUs",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceOpt.maxDelayUs);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.coalesce.maxDelayUs info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceOpt.maxDelayUs;
+
     ret = conf_.GetUInt32Value("mds.refreshTimesPerLease",
         &fileServiceOption_.leaseOpt.mdsRefreshTimesPerLease);
     LOG_IF(ERROR, ret == false) << "config no mds.refreshTimesPerLease info";
@@ -256,6 +280,76 @@ int ClientConfig::Init(const std::string& configpath) {
         << "config no throttle.enable info, using default value "
         << fileServiceOption_.ioOpt.throttleOption.enable;
 
+    ret = conf_.GetBoolValue(
+        "readCache.enable",
+        &fileServiceOption_.ioOpt.readCacheOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.enable info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.enable;
+
+    ret = conf_.GetUInt32Value(
+        "readCache.blockSize",
+        &fileServiceOption_.ioOpt.readCacheOpt.blockSize);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.blockSize info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.blockSize;
+
+    ret = conf_.GetUInt64Value(
+        "readCache.capacityMB",
+        &fileServiceOption_.ioOpt.readCacheOpt.capacityMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.capacityMB info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.capacityMB;
+
+    ret = conf_.GetStringValue(
+        "readCache.sharedPath",
+        &fileServiceOption_.ioOpt.readCacheOpt.sharedPath);
+    LOG_IF(INFO, ret == false)
+        << "config no readCache.sharedPath info, use process read cache";
+
+    if (fileServiceOption_.ioOpt.readCacheOpt.blockSize == 0 ||
+        !common::is_aligned(fileServiceOption_.ioOpt.readCacheOpt.blockSize,
+                            512)) {
+        LOG(ERROR) << "readCache.blockSize must be positive and align to 512";
+        RETURN_IF_FALSE(false);
+    }
+
+    ret = conf_.GetBoolValue(
+        "readAhead.enable",
+        &fileServiceOption_.ioOpt.readAheadOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no readAhead.enable info, using default value "
+        << fileServiceOption_.ioOpt.readAheadOpt.enable;
+
+    ret = conf_.GetUInt32Value(
+        "readAhead.initWindowKB",
+        &fileServiceOption_.ioOpt.readAheadOpt.initWindowKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readAhead.initWindowKB info, using default value "
+        << fileServiceOption_.ioOpt.readAheadOpt.initWindowKB;
+
+    ret = conf_.GetUInt32Value(
+        "readAhead.maxWindowKB",
+        &fileServiceOption_.ioOpt.readAheadOpt.maxWindowKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readAhead.maxWindowKB info, using default value "
+        << fileServiceOption_.ioOpt.readAheadOpt.maxWindowKB;
+
+    ret = conf_.GetUInt32Value(
+        "readAhead.triggerCount",
+        &fileServiceOption_.ioOpt.readAheadOpt.triggerCount);
+    LOG_IF(WARNING, ret == false)
+        << "config no readAhead.triggerCount info, using default value "
+        << fileServiceOption_.ioOpt.readAheadOpt.triggerCount;
+
+    if (fileServiceOption_.ioOpt.readAheadOpt.initWindowKB == 0 ||
+        fileServiceOption_.ioOpt.readAheadOpt.initWindowKB >
+            fileServiceOption_.ioOpt.readAheadOpt.maxWindowKB) {
+        LOG(ERROR) << "readAhead.initWindowKB must be positive and not "
+                      "greater than readAhead.maxWindowKB";
+        RETURN_IF_FALSE(false);
+    }
+
     ret = conf_.GetBoolValue("discard.enable",
                              &fileServiceOption_.ioOpt.discardOption.enable);
     LOG_IF(ERROR, ret == false) << "config no discard.enable info";
@@ -136,6 +136,17 @@ struct FileMetric {
 
     DiscardMetric discardMetric;
 
+    // rpcs sent for coalesced requests
+    PerSecondMetric coalescedRPC;
+    // rpcs saved by coalescing requests
+    PerSecondMetric coalesceSavedRPC;
+
+    // 由读缓存返回以及没有命中读缓存的读请求
+    PerSecondMetric readCacheHit;
+    PerSecondMetric readCacheMiss;
+    // 顺序读预读的字节数
+    PerSecondMetric readAheadBytes;
+
     explicit FileMetric(const std::string& name)
         : filename(name),
           inflightRPCNum(prefix, filename + "_inflight_rpc_num"),
@@ -149,7 +160,12 @@ struct FileMetric {
           userDiscard(prefix, filename + "_discard"),
           getLeaderRetryQPS(prefix, filename + "_get_leader_retry_rpc"),
           suspendRPCMetric(prefix, filename + "_suspend_io_num"),
-          discardMetric(prefix + filename) {}
+          discardMetric(prefix + filename),
+          coalescedRPC(prefix, filename + "_coalesced_rpc"),
+          coalesceSavedRPC(prefix, filename + "_coalesce_saved_rpc"),
+          readCacheHit(prefix, filename + "_read_cache_hit"),
+          readCacheMiss(prefix, filename + "_read_cache_miss"),
+          readAheadBytes(prefix, filename + "_read_ahead_bytes") {}
 };
 
 // 用于全局mds接口统计信息调用信息统计
@@ -487,6 +503,13 @@ class MetricHelper {
         }
     }
 
+    static void IncremCoalescedRPC(FileMetric* fm, size_t requests) {
+        if (fm != nullptr) {
+            fm->coalescedRPC.count << 1;
+            fm->coalesceSavedRPC.count << requests - 1;
+        }
+    }
+
     static void IncremIOSuspendNum(FileMetric* fm) {
         if (fm != nullptr) {
             fm->suspendRPCMetric.count << 1;
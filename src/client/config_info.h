@@ -157,24 +157,43 @@ struct FailureRequestOption {
 /**
  * 发送rpc给chunkserver的配置
  * @chunkserverEnableAppliedIndexRead: 是否开启使用appliedindex read
+ * @chunkserverEnableFollowerRead: 读取快照以及只读打开的克隆源文件时，是否将
+ *                                 读请求发送给copyset中负载最低的副本而不是
+ *                                 leader
  * @inflightOpt: 一个文件向chunkserver发送请求时的inflight 请求控制配置
  * @failRequestOpt: rpc发送失败之后，需要进行rpc重试的相关配置
  */
 struct IOSenderOption {
     bool chunkserverEnableAppliedIndexRead;
+    bool chunkserverEnableFollowerRead = false;
     InFlightIOCntlInfo inflightOpt;
     FailureRequestOption failRequestOpt;
 };
 
+/**
+ * scheduler模块请求合并配置信息
+ * @enable: 是否将同一个chunk上相邻的请求合并为一个rpc发送
+ * @maxBytes: 合并后请求的最大字节数
+ * @maxDelayUs: 请求等待后续相邻请求的最长时间，只有该线程上一次的请求发生了
+ *              合并才会等待，否则只合并队列中已有的请求
+ */
+struct RequestCoalesceOption {
+    bool enable = false;
+    uint32_t maxBytes = 128 * 1024;
+    uint32_t maxDelayUs = 50;
+};
+
 /**
  * scheduler模块基本配置信息，schedule模块是用于分发用户请求，每个文件有自己的schedule
  * 线程池，线程池中的线程各自配置一个队列
  * @scheduleQueueCapacity: schedule模块配置的队列深度
  * @scheduleThreadpoolSize: schedule模块线程池大小
+ * @coalesceOpt: 请求合并配置
  */
 struct RequestScheduleOption {
     uint32_t scheduleQueueCapacity = 1024;
     uint32_t scheduleThreadpoolSize = 2;
+    RequestCoalesceOption coalesceOpt;
     IOSenderOption ioSenderOpt;
 };
 
@@ -258,6 +277,36 @@ struct ThrottleOption {
     bool enable = false;
 };
 
+/**
+ * client端的数据读缓存配置
+ * @enable: 是否开启读缓存
+ * @blockSize: 缓存块大小，只有完整覆盖缓存块的读请求才会填充缓存
+ * @capacityMB: 缓存容量，进程内打开的所有文件共享
+ * @sharedPath: 不为空时缓存保存在该路径映射的共享内存文件中，
+ *              由同一主机上的多个进程共享，例如/dev/shm/curve_read_cache
+ */
+struct ReadCacheOption {
+    bool enable = false;
+    uint32_t blockSize = 4096;
+    uint64_t capacityMB = 256;
+    std::string sharedPath;
+};
+
+/**
+ * client端顺序读的预读配置
+ * @enable: 是否开启预读，预读的数据保存在读缓存中，
+ *          读缓存未开启时使用文件私有的缓存，容量为最大预读窗口的两倍
+ * @initWindowKB: 识别到顺序读之后第一次预读的大小
+ * @maxWindowKB: 顺序读持续时预读窗口成倍增长，直到该上限
+ * @triggerCount: 连续多少个顺序读请求之后开始预读
+ */
+struct ReadAheadOption {
+    bool enable = false;
+    uint32_t initWindowKB = 128;
+    uint32_t maxWindowKB = 4096;
+    uint32_t triggerCount = 2;
+};
+
 /**
  * IOOption存储了当前io 操作所需要的所有配置信息
  */
@@ -270,6 +319,8 @@ struct IOOption {
     CloseFdThreadOption closeFdThreadOption;
     ThrottleOption throttleOption;
     DiscardOption discardOption;
+    ReadCacheOption readCacheOpt;
+    ReadAheadOption readAheadOpt;
 };
 
 /**
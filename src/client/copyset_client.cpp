@@ -125,9 +125,18 @@ int CopysetClient::ReadChunk(const ChunkIDInfo& idinfo, uint64_t sn,
     auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
         ReadChunkClosure *readDone = new ReadChunkClosure(this, done);
         senderPtr->ReadChunk(idinfo, sn, offset, length,
-                             appliedindex, sourceInfo, readDone);
+                             appliedindex, sourceInfo, readDone,
+                             reqclosure->IsFollowerRead());
     };
 
+    // 只读打开的克隆源数据不会再被修改，可以由follower处理。
+    // 其他只读打开的文件仍可能被别的client写入，读请求只发送给leader
+    if (iosenderopt_.chunkserverEnableFollowerRead &&
+        metaCache_->GetLatestFileStatus() == FileStatus::BeingCloned) {
+        return DoFollowerReadTask(idinfo, appliedindex, task,
+                                  doneGuard.release());
+    }
+
     return DoRPCTask(idinfo, task, doneGuard.release());
 }
 
@@ -186,12 +195,24 @@ int CopysetClient::WriteChunk(const ChunkIDInfo& idinfo,
 
 int CopysetClient::ReadChunkSnapshot(const ChunkIDInfo& idinfo,
     uint64_t sn, off_t offset, size_t length, Closure *done) {
+    RequestClosure* reqclosure = static_cast<RequestClosure*>(done);
+    uint64_t appliedindex = 0;
+    if (iosenderopt_.chunkserverEnableFollowerRead) {
+        appliedindex = metaCache_->GetAppliedIndex(idinfo.lpid_, idinfo.cpid_);
+    }
 
     auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
         ReadChunkSnapClosure *readDone = new ReadChunkSnapClosure(this, done);
-        senderPtr->ReadChunkSnapshot(idinfo, sn, offset, length, readDone);
+        senderPtr->ReadChunkSnapshot(idinfo, sn, offset, length, readDone,
+                                     appliedindex,
+                                     reqclosure->IsFollowerRead());
     };
 
+    // 快照数据不会再被修改，可以由follower处理
+    if (iosenderopt_.chunkserverEnableFollowerRead) {
+        return DoFollowerReadTask(idinfo, appliedindex, task, done);
+    }
+
     return DoRPCTask(idinfo, task, done);
 }
 
@@ -253,6 +274,7 @@ int CopysetClient::DoRPCTask(const ChunkIDInfo& idinfo,
     butil::EndPoint leaderAddr;
     brpc::ClosureGuard doneGuard(done);
 
+    reqclosure->SetFollowerRead(false);
     while (reqclosure->GetRetriedTimes() <
         iosenderopt_.failRequestOpt.chunkserverOPMaxRetry) {
         reqclosure->IncremRetriedTimes();
@@ -279,5 +301,38 @@ int CopysetClient::DoRPCTask(const ChunkIDInfo& idinfo,
 
     return 0;
 }
+
+int CopysetClient::DoFollowerReadTask(const ChunkIDInfo& idinfo,
+    uint64_t appliedindex,
+    std::function<void(Closure* done,
+    std::shared_ptr<RequestSender> senderptr)> task, Closure *done) {
+    RequestClosure* reqclosure = static_cast<RequestClosure*>(done);
+
+    // 只有第一次发送时选择副本，follower数据落后或者处理失败时，
+    // 重试的请求都发送给leader
+    if (appliedindex == 0 || reqclosure->GetRetriedTimes() != 0) {
+        return DoRPCTask(idinfo, task, done);
+    }
+
+    CopysetInfo<ChunkServerID> cpinfo =
+        metaCache_->GetServerList(idinfo.lpid_, idinfo.cpid_);
+    int index = replicaSelector_.Select(cpinfo.csinfos_);
+    if (index < 0) {
+        return DoRPCTask(idinfo, task, done);
+    }
+
+    const CopysetPeerInfo<ChunkServerID>& peer = cpinfo.csinfos_[index];
+    auto senderPtr = senderManager_->GetOrCreateSender(
+        peer.peerID, peer.externalAddr.addr_, iosenderopt_);
+    if (nullptr == senderPtr) {
+        return DoRPCTask(idinfo, task, done);
+    }
+
+    reqclosure->IncremRetriedTimes();
+    reqclosure->SetFollowerRead(true);
+    replicaSelector_.OnSend(peer.peerID);
+    task(done, senderPtr);
+    return 0;
+}
 }   // namespace client
 }   // namespace curve
@@ -33,6 +33,7 @@
 #include "src/client/client_common.h"
 #include "src/client/client_metric.h"
 #include "src/client/config_info.h"
+#include "src/client/replica_selector.h"
 #include "src/client/request_context.h"
 #include "src/client/request_sender_manager.h"
 #include "src/common/concurrent/concurrent.h"
@@ -216,6 +217,13 @@ class CopysetClient {
         }
     }
 
+    /**
+     * 发送给follower的读请求返回时更新副本的负载信息
+     */
+    ReplicaSelector* GetReplicaSelector() {
+        return &replicaSelector_;
+    }
+
  private:
     friend class WriteChunkClosure;
     friend class ReadChunkClosure;
@@ -237,6 +245,16 @@ class CopysetClient {
         std::function<void(Closure*, std::shared_ptr<RequestSender>)> task,
         Closure *done);
 
+    /**
+     * 执行读取不可变数据的rpc task，第一次发送时选择copyset中负载最低的
+     * 副本，重试时通过DoRPCTask发送给leader
+     * @param[in]: appliedindex为follower需要读到的appliedindex，
+     *             为0时follower无法判断数据是否足够新，直接发送给leader
+     */
+    int DoFollowerReadTask(const ChunkIDInfo& idinfo, uint64_t appliedindex,
+        std::function<void(Closure*, std::shared_ptr<RequestSender>)> task,
+        Closure *done);
+
  private:
     // 元数据缓存
     MetaCache            *metaCache_;
@@ -258,6 +276,9 @@ class CopysetClient {
 
     // 是否在停止状态中，如果是在关闭过程中且session失效，需要将rpc直接返回不下发
     bool exitFlag_;
+
+    // 开启follower read时根据副本的负载选择读请求的目标
+    ReplicaSelector replicaSelector_;
 };
 
 }   // namespace client
@@ -72,7 +72,15 @@ bool FileInstance::Initialize(const std::string& filename,
 
         finfo_.fullPathName = filename;
 
-        if (!iomanager4file_.Initialize(filename, fileopt_.ioOpt,
+        IOOption ioOpt = fileopt_.ioOpt;
+        if (!readonly_) {
+            // 可写打开的文件数据随时可能被修改，读请求只发送给leader
+            ioOpt.ioSenderOpt.chunkserverEnableFollowerRead = false;
+            ioOpt.reqSchdulerOpt.ioSenderOpt.chunkserverEnableFollowerRead =
+                false;
+        }
+
+        if (!iomanager4file_.Initialize(filename, ioOpt,
                                         mdsclient_.get())) {
             LOG(ERROR) << "Init io context manager failed, filename = "
                        << filename;
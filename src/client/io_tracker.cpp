@@ -57,6 +57,8 @@ IOTracker::IOTracker(IOManager* iomanager,
     id_         = tracekerID_.fetch_add(1, std::memory_order_relaxed);
     scc_        = nullptr;
     aioctx_     = nullptr;
+    readCache_  = nullptr;
+    readAhead_  = false;
     data_       = nullptr;
     type_       = OpType::UNKNOWN;
     errcode_    = LIBCURVE_ERROR::OK;
@@ -469,9 +471,12 @@ void IOTracker::Done() {
     }
 
     if (errcode_ == LIBCURVE_ERROR::OK) {
-        uint64_t duration = TimeUtility::GetTimeofDayUs() - opStartTimePoint_;
-        MetricHelper::UserLatencyRecord(fileMetric_, duration, type_);
-        MetricHelper::IncremUserQPSCount(fileMetric_, length_, type_);
+        if (!readAhead_) {
+            uint64_t duration =
+                TimeUtility::GetTimeofDayUs() - opStartTimePoint_;
+            MetricHelper::UserLatencyRecord(fileMetric_, duration, type_);
+            MetricHelper::IncremUserQPSCount(fileMetric_, length_, type_);
+        }
 
         // copy read data to user buffer
         if (OpType::READ == type_ || OpType::READ_SNAP == type_) {
@@ -504,8 +509,15 @@ void IOTracker::Done() {
                            << ", filename: " << fileMetric_->filename
                            << ", offset: " << offset_
                            << ", length: " << length_;
+            } else if (readCache_ != nullptr && OpType::READ == type_) {
+                readCache_->Fill(fillToken_, offset_, length_, readData);
             }
         }
+    } else if (readAhead_) {
+        // 预读失败不影响用户的读请求，用户读请求会重新读取这部分数据
+        LOG(WARNING) << "file [" << fileMetric_->filename << "]"
+                     << ", read ahead failed, offset = " << offset_
+                     << ", length = " << length_;
     } else {
         MetricHelper::IncremUserEPSCount(fileMetric_, type_);
         if (type_ == OpType::READ || type_ == OpType::WRITE) {
@@ -531,6 +543,12 @@ void IOTracker::Done() {
         }
     }
 
+    // 写请求返回前淘汰缓存，之后的读请求不会读到旧数据
+    if (readCache_ != nullptr &&
+        (OpType::WRITE == type_ || OpType::DISCARD == type_)) {
+        readCache_->EndWrite(offset_, length_);
+    }
+
     DestoryRequestList();
 
     // scc_和aioctx都为空的时候肯定是个同步调用
@@ -36,6 +36,7 @@
 #include "src/client/io_condition_varaiable.h"
 #include "src/client/mds_client.h"
 #include "src/client/metacache.h"
+#include "src/client/read_cache.h"
 #include "src/client/request_context.h"
 #include "src/client/request_scheduler.h"
 #include "src/common/throttle.h"
@@ -210,6 +211,24 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
         userDataType_ = dataType;
     }
 
+    /**
+     * @brief 设置文件的读缓存，读请求成功后用读到的数据填充缓存，
+     *        写请求和discard结束时淘汰对应的缓存
+     */
+    void SetReadCache(FileReadCache* readCache) {
+        readCache_ = readCache;
+        if (readCache_ != nullptr) {
+            fillToken_ = readCache_->BeginFill();
+        }
+    }
+
+    /**
+     * @brief 标记为预读请求，预读请求不计入用户读请求的metric
+     */
+    void SetReadAhead() {
+        readAhead_ = true;
+    }
+
     /**
      * @brief prepare space to store read data
      * @param subIoCount #space to store read data
@@ -359,6 +378,13 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
     // 快照克隆系统异步调用回调指针
     SnapCloneClosure* scc_;
 
+    // 文件的读缓存，为空时不使用缓存
+    FileReadCache* readCache_;
+    FileReadCache::FillToken fillToken_;
+
+    // 是否为顺序读的预读请求
+    bool readAhead_;
+
     bool disableStripe_;
 
     // read/write operations will hold segment's read lock,
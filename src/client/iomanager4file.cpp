@@ -23,6 +23,7 @@
 #include <glog/logging.h>
 
 #include <chrono>   // NOLINT
+#include <cstdlib>
 
 #include "src/client/metacache.h"
 #include "src/client/iomanager4file.h"
@@ -54,6 +55,36 @@ bool IOManager4File::Initialize(const std::string& filename,
         LOG(ERROR) << "allocate client metric failed!";
         return false;
     }
+    mc_.ExposeMemoryMetric(filename);
+
+    if (ioopt_.readCacheOpt.enable) {
+        // 缓存可能由访问不同集群的进程共享，key中需要包含集群id
+        ClusterContext clsctx;
+        if (mdsclient != nullptr &&
+            mdsclient->GetClusterInfo(&clsctx) == LIBCURVE_ERROR::OK) {
+            readCache_.reset(new FileReadCache(
+                ReadCacheStore::GetInstance(ioopt_.readCacheOpt),
+                ReadCacheClusterId(clsctx.clusterId), fileMetric_));
+        } else {
+            LOG(WARNING) << "Get cluster id failed, disable read cache, "
+                         << "filename = " << filename;
+        }
+    }
+    if (readCache_ == nullptr && ioopt_.readAheadOpt.enable) {
+        // 没有开启读缓存时，预读的数据保存在文件私有的缓存中，
+        // 容量为最大预读窗口的两倍
+        uint64_t capacity = 2ULL * ioopt_.readAheadOpt.maxWindowKB * 1024;
+        readCache_.reset(new FileReadCache(
+            std::make_shared<MemoryReadCacheStore>(
+                ioopt_.readCacheOpt.blockSize, capacity,
+                "curve_client_" + filename + "_read_ahead"),
+            0, fileMetric_));
+    }
+
+    if (ioopt_.readAheadOpt.enable) {
+        streamDetector_.reset(new StreamDetector(
+            ioopt_.readAheadOpt, ioopt_.readCacheOpt.blockSize));
+    }
 
     // IO Manager中不控制inflight IO数量，所以传入UINT64_MAX
     // 但是IO Manager需要控制所有inflight IO在关闭的时候都被回收掉
@@ -134,6 +165,7 @@ void IOManager4File::UnInitialize() {
         exit_ = true;
 
         delete scheduler_;
+        readCache_.reset();
         delete fileMetric_;
         scheduler_ = nullptr;
         fileMetric_ = nullptr;
@@ -145,10 +177,17 @@ int IOManager4File::Read(char* buf, off_t offset,
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
     FlightIOGuard guard(this);
 
+    ReadAhead(offset, length, mdsclient);
+
+    if (ReadFromCache(buf, offset, length)) {
+        return length;
+    }
+
     butil::IOBuf data;
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_, disableStripe_);
     temp.SetUserDataType(UserDataType::IOBuffer);
+    temp.SetReadCache(readCache_.get());
     temp.StartRead(&data, offset, length, mdsclient, this->GetFileInfo(),
                    throttle_.get());
 
@@ -172,8 +211,13 @@ int IOManager4File::Write(const char* buf,
     butil::IOBuf data;
     data.append_user_data(const_cast<char*>(buf), length, TrivialDeleter);
 
+    if (readCache_ != nullptr) {
+        readCache_->BeginWrite(offset, length);
+    }
+
     IOTracker temp(this, &mc_, scheduler_, fileMetric_, disableStripe_);
     temp.SetUserDataType(UserDataType::IOBuffer);
+    temp.SetReadCache(readCache_.get());
     temp.StartWrite(&data, offset, length, mdsclient, this->GetFileInfo(),
                     this->GetFileEpoch(),
                     throttle_.get());
@@ -196,13 +240,27 @@ int IOManager4File::AioRead(CurveAioContext* ctx, MDSClient* mdsclient,
     }
 
     temp->SetUserDataType(dataType);
+    temp->SetReadCache(readCache_.get());
     inflightCntl_.IncremInflightNum();
-    auto task = [this, ctx, mdsclient, temp]() {
+    auto task = [this, ctx, mdsclient, temp, dataType]() {
+        if (AioReadFromCache(ctx, dataType)) {
+            ctx->ret = ctx->length;
+            ctx->cb(ctx);
+            HandleAsyncIOResponse(temp);
+            return;
+        }
+
         temp->StartAioRead(ctx, mdsclient, this->GetFileInfo(),
                            throttle_.get());
     };
 
+    // 用户的读请求入队后ctx可能随时被回调释放，预读前先保存请求范围
+    off_t offset = ctx->offset;
+    size_t length = ctx->length;
     taskPool_.Enqueue(task);
+
+    // 预读在用户的读请求之后发起
+    ReadAhead(offset, length, mdsclient);
     return LIBCURVE_ERROR::OK;
 }
 
@@ -219,7 +277,12 @@ int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient,
         return LIBCURVE_ERROR::OK;
     }
 
+    if (readCache_ != nullptr) {
+        readCache_->BeginWrite(ctx->offset, ctx->length);
+    }
+
     temp->SetUserDataType(dataType);
+    temp->SetReadCache(readCache_.get());
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
         temp->StartAioWrite(ctx, mdsclient, this->GetFileInfo(),
@@ -240,7 +303,12 @@ int IOManager4File::Discard(off_t offset, size_t length, MDSClient* mdsclient) {
 
     FlightIOGuard guard(this);
 
+    if (readCache_ != nullptr) {
+        readCache_->BeginWrite(offset, length);
+    }
+
     IOTracker tracker(this, &mc_, scheduler_, fileMetric_);
+    tracker.SetReadCache(readCache_.get());
     tracker.StartDiscard(offset, length, mdsclient, GetFileInfo(),
                          discardTaskManager_.get());
     return tracker.Wait();
@@ -265,6 +333,11 @@ int IOManager4File::AioDiscard(CurveAioContext* aioctx, MDSClient* mdsclient) {
         return LIBCURVE_ERROR::OK;
     }
 
+    if (readCache_ != nullptr) {
+        readCache_->BeginWrite(aioctx->offset, aioctx->length);
+    }
+
+    ioTracker->SetReadCache(readCache_.get());
     inflightCntl_.IncremInflightNum();
     auto task = [this, aioctx, mdsclient, ioTracker]() {
         ioTracker->StartAioDiscard(aioctx, mdsclient, this->GetFileInfo(),
@@ -277,6 +350,116 @@ int IOManager4File::AioDiscard(CurveAioContext* aioctx, MDSClient* mdsclient) {
 
 void IOManager4File::UpdateFileInfo(const FInfo_t& fi) {
     mc_.UpdateFileInfo(fi);
+    UpdateReadCacheVersion();
+}
+
+void IOManager4File::UpdateReadCacheVersion() {
+    if (readCache_ != nullptr) {
+        readCache_->UpdateVersion(mc_.InodeId(), mc_.GetLatestFileSn(),
+                                  mc_.GetFileEpoch()->epoch);
+    }
+}
+
+bool IOManager4File::ReadFromCache(char* buf, off_t offset, size_t length) {
+    if (readCache_ == nullptr) {
+        return false;
+    }
+
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    if (!readCache_->Read(offset, length, buf)) {
+        return false;
+    }
+
+    MetricHelper::UserLatencyRecord(
+        fileMetric_, TimeUtility::GetTimeofDayUs() - startUs, OpType::READ);
+    MetricHelper::IncremUserQPSCount(fileMetric_, length, OpType::READ);
+    return true;
+}
+
+bool IOManager4File::AioReadFromCache(CurveAioContext* ctx,
+                                      UserDataType dataType) {
+    if (readCache_ == nullptr) {
+        return false;
+    }
+
+    if (dataType == UserDataType::RawBuffer) {
+        return ReadFromCache(static_cast<char*>(ctx->buf), ctx->offset,
+                             ctx->length);
+    }
+
+    char* data = static_cast<char*>(malloc(ctx->length));
+    if (data == nullptr) {
+        return false;
+    }
+    if (!ReadFromCache(data, ctx->offset, ctx->length)) {
+        free(data);
+        return false;
+    }
+
+    butil::IOBuf* userData = reinterpret_cast<butil::IOBuf*>(ctx->buf);
+    userData->clear();
+    userData->append_user_data(data, ctx->length, free);
+    return true;
+}
+
+namespace {
+
+// 预读请求的上下文，预读完成后数据已经填充到缓存中，直接释放
+struct ReadAheadContext : public CurveAioContext {
+    butil::IOBuf data;
+};
+
+void ReadAheadDone(CurveAioContext* ctx) {
+    delete static_cast<ReadAheadContext*>(ctx);
+}
+
+}  // namespace
+
+void IOManager4File::ReadAhead(off_t offset, size_t length,
+                               MDSClient* mdsclient) {
+    if (streamDetector_ == nullptr) {
+        return;
+    }
+
+    ReadAheadRange range;
+    if (!streamDetector_->OnRead(offset, length, GetFileInfo()->length,
+                                 &range)) {
+        return;
+    }
+
+    ReadAheadContext* ctx = new (std::nothrow) ReadAheadContext();
+    if (ctx == nullptr) {
+        return;
+    }
+    ctx->offset = range.offset;
+    ctx->length = range.length;
+    ctx->ret = 0;
+    ctx->op = LIBCURVE_OP_READ;
+    ctx->cb = ReadAheadDone;
+    ctx->buf = &ctx->data;
+
+    IOTracker* tracker = new (std::nothrow)
+        IOTracker(this, &mc_, scheduler_, fileMetric_, disableStripe_);
+    if (tracker == nullptr) {
+        delete ctx;
+        return;
+    }
+
+    tracker->SetUserDataType(UserDataType::IOBuffer);
+    tracker->SetReadAhead();
+    tracker->SetReadCache(readCache_.get());
+    fileMetric_->readAheadBytes.count << range.length;
+
+    DVLOG(9) << "read ahead, offset = " << range.offset
+             << ", length = " << range.length;
+
+    inflightCntl_.IncremInflightNum();
+    auto task = [this, ctx, mdsclient, tracker]() {
+        tracker->StartAioRead(ctx, mdsclient, this->GetFileInfo(),
+                              throttle_.get());
+    };
+
+    taskPool_.Enqueue(task);
 }
 
 void IOManager4File::UpdateFileThrottleParams(
@@ -38,6 +38,8 @@
 #include "src/client/iomanager.h"
 #include "src/client/mds_client.h"
 #include "src/client/metacache.h"
+#include "src/client/read_ahead.h"
+#include "src/client/read_cache.h"
 #include "src/client/request_scheduler.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/common/concurrent/task_thread_pool.h"
@@ -183,6 +185,7 @@ class IOManager4File : public IOManager {
 
     void UpdateFileEpoch(const FileEpoch& fEpoch) {
         mc_.UpdateFileEpoch(fEpoch);
+        UpdateReadCacheVersion();
     }
 
     const FileEpoch* GetFileEpoch() const {
@@ -201,6 +204,7 @@ class IOManager4File : public IOManager {
      */
     void SetLatestFileSn(uint64_t newSn) {
         mc_.SetLatestFileSn(newSn);
+        UpdateReadCacheVersion();
     }
 
     /**
@@ -260,6 +264,22 @@ class IOManager4File : public IOManager {
 
     bool IsNeedDiscard(size_t len) const;
 
+    /**
+     * @brief 从读缓存读取数据，命中时记录用户读请求的metric
+     * @return 数据全部在缓存中返回true
+     */
+    bool ReadFromCache(char* buf, off_t offset, size_t length);
+    bool AioReadFromCache(CurveAioContext* ctx, UserDataType dataType);
+
+    // 文件的sn或者epoch变化后，之前缓存的数据不再使用
+    void UpdateReadCacheVersion();
+
+    /**
+     * @brief 用户读请求到达时检测顺序读，需要时发起异步预读，
+     *        预读的数据填充到读缓存中
+     */
+    void ReadAhead(off_t offset, size_t length, MDSClient* mdsclient);
+
  private:
     // 每个IOManager都有其IO配置，保存在iooption里
     IOOption ioopt_;
@@ -306,6 +326,12 @@ class IOManager4File : public IOManager {
     bool disableStripe_;
 
     std::unique_ptr<DiscardTaskManager> discardTaskManager_;
+
+    // 读缓存，读缓存和预读都未开启时为空
+    std::unique_ptr<FileReadCache> readCache_;
+
+    // 顺序读检测，未开启预读时为空
+    std::unique_ptr<StreamDetector> streamDetector_;
 };
 
 }  // namespace client
@@ -167,7 +167,7 @@ void LeaseExecutor::CheckNeedUpdateFileInfo(const FInfo& fileInfo) {
         LOG(INFO) << "Update file sn, new file sn = " << newSn
                   << ", current sn = " << currentFileSn
                   << ", filename = " << fullFileName_;
-        metaCache->SetLatestFileSn(newSn);
+        iomanager_->SetLatestFileSn(newSn);
     }
 
     FileStatus currentFileStatus = metaCache->GetLatestFileStatus();
@@ -55,12 +55,15 @@ void MetaCache::Init(const MetaCacheOption& metaCacheOpt,
     unstableHelper_.Init(metacacheopt_.chunkserverUnstableOption);
 }
 
+void MetaCache::UpdateFileInfo(const FInfo& fileInfo) {
+    fileInfo_ = fileInfo;
+    segments_.Init(fileInfo.length, fileInfo.segmentsize, fileInfo.chunksize,
+                   metacacheopt_.discardGranularity);
+}
+
 MetaCacheErrorType MetaCache::GetChunkInfoByIndex(ChunkIndex chunkidx,
                                                   ChunkIDInfo* chunxinfo) {
-    ReadLockGuard rdlk(rwlock4ChunkInfo_);
-    auto iter = chunkindex2idMap_.find(chunkidx);
-    if (iter != chunkindex2idMap_.end()) {
-        *chunxinfo = iter->second;
+    if (segments_.GetChunkInfo(chunkidx, chunxinfo)) {
         return MetaCacheErrorType::OK;
     }
     return MetaCacheErrorType::CHUNKINFO_NOT_FOUND;
@@ -68,23 +71,18 @@ MetaCacheErrorType MetaCache::GetChunkInfoByIndex(ChunkIndex chunkidx,
 
 void MetaCache::UpdateChunkInfoByIndex(ChunkIndex cindex,
                                        const ChunkIDInfo& cinfo) {
-    WriteLockGuard wrlk(rwlock4ChunkInfo_);
-    chunkindex2idMap_[cindex] = cinfo;
+    segments_.UpdateChunkInfo(cindex, cinfo);
 }
 
 bool MetaCache::IsLeaderMayChange(LogicPoolID logicPoolId,
                                   CopysetID copysetId) {
-    rwlock4ChunkInfo_.RDLock();
-    auto iter = lpcsid2CopsetInfoMap_.find(
+    auto* entry = lpcsid2CopsetInfoMap_.Find(
         CalcLogicPoolCopysetID(logicPoolId, copysetId));
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4ChunkInfo_.Unlock();
+    if (entry == nullptr) {
         return false;
     }
 
-    bool flag = iter->second.LeaderMayChange();
-    rwlock4ChunkInfo_.Unlock();
-    return flag;
+    return entry->leader.Load().leaderMayChange;
 }
 
 int MetaCache::GetLeader(LogicPoolID logicPoolId,
@@ -95,17 +93,28 @@ int MetaCache::GetLeader(LogicPoolID logicPoolId,
                          FileMetric* fm) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
-    CopysetInfo<ChunkServerID> targetInfo;
-    rwlock4CopysetInfo_.RDLock();
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4CopysetInfo_.Unlock();
+    auto* entry = lpcsid2CopsetInfoMap_.Find(key);
+    if (entry == nullptr) {
         LOG(ERROR) << "server list not exist, LogicPoolID = " << logicPoolId
                    << ", CopysetID = " << copysetId;
         return -1;
     }
-    targetInfo = iter->second;
-    rwlock4CopysetInfo_.Unlock();
+
+    // leader已知且稳定时无锁返回
+    if (!refresh) {
+        CopysetLeader leader = entry->leader.Load();
+        if (!leader.leaderMayChange && leader.valid) {
+            *serverId = leader.id;
+            *serverAddr = EndPoint(butil::int2ip(leader.ip), leader.port);
+            return 0;
+        }
+    }
+
+    CopysetInfo<ChunkServerID> targetInfo;
+    {
+        ReadLockGuard rdlk(rwlock4CopysetInfo_);
+        targetInfo = entry->info;
+    }
 
     int ret = 0;
     if (refresh || targetInfo.LeaderMayChange()) {
@@ -237,13 +246,14 @@ CopysetInfo<ChunkServerID> MetaCache::GetServerList(LogicPoolID logicPoolId,
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
     CopysetInfo<ChunkServerID> ret;
 
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    auto* entry = lpcsid2CopsetInfoMap_.Find(key);
+    if (entry == nullptr) {
         // it's impossible to get here
         return ret;
     }
-    return iter->second;
+
+    ReadLockGuard rdlk(rwlock4CopysetInfo_);
+    return entry->info;
 }
 
 /**
@@ -256,22 +266,45 @@ int MetaCache::UpdateLeader(LogicPoolID logicPoolId,
                             const EndPoint& leaderAddr) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    auto* entry = lpcsid2CopsetInfoMap_.Find(key);
+    if (entry == nullptr) {
         // it's impossible to get here
         return -1;
     }
 
     PeerAddr csAddr(leaderAddr);
-    return iter->second.UpdateLeaderInfo(csAddr);
+    ReadLockGuard rdlk(rwlock4CopysetInfo_);
+    int ret = entry->info.UpdateLeaderInfo(csAddr);
+    PublishLeader(entry);
+    return ret;
 }
 
 void MetaCache::UpdateCopysetInfo(LogicPoolID logicPoolid, CopysetID copysetid,
                                   const CopysetInfo<ChunkServerID>& csinfo) {
     const auto key = CalcLogicPoolCopysetID(logicPoolid, copysetid);
+    auto* entry = lpcsid2CopsetInfoMap_.FindOrEmplace(key);
     WriteLockGuard wrlk(rwlock4CopysetInfo_);
-    lpcsid2CopsetInfoMap_[key] = csinfo;
+    entry->info = csinfo;
+    PublishLeader(entry);
+}
+
+void MetaCache::PublishLeader(CopysetCacheEntry* entry) {
+    entry->leader.Update([entry](CopysetLeader* leader) {
+        CopysetInfo<ChunkServerID>& info = entry->info;
+        info.spinlock_.Lock();
+        int16_t index = info.GetCurrentLeaderIndex();
+        leader->valid = false;
+        if (index >= 0 && static_cast<size_t>(index) < info.csinfos_.size()) {
+            const EndPoint& addr = info.csinfos_[index].externalAddr.addr_;
+            // unix socket地址无法保存在定长结构中，走加锁路径
+            leader->valid = addr.socket_file.empty();
+            leader->id = info.csinfos_[index].peerID;
+            leader->ip = butil::ip2int(addr.ip);
+            leader->port = addr.port;
+        }
+        leader->leaderMayChange = info.LeaderMayChange();
+        info.spinlock_.UnLock();
+    });
 }
 
 void MetaCache::UpdateAppliedIndex(LogicPoolID logicPoolId,
@@ -279,26 +312,25 @@ void MetaCache::UpdateAppliedIndex(LogicPoolID logicPoolId,
                                    uint64_t appliedindex) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
-    ReadLockGuard wrlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    // appliedindex是原子变量，不需要加锁
+    auto* entry = lpcsid2CopsetInfoMap_.Find(key);
+    if (entry == nullptr) {
         return;
     }
 
-    iter->second.UpdateAppliedIndex(appliedindex);
+    entry->info.UpdateAppliedIndex(appliedindex);
 }
 
 uint64_t MetaCache::GetAppliedIndex(LogicPoolID logicPoolId,
                                     CopysetID copysetId) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    auto* entry = lpcsid2CopsetInfoMap_.Find(key);
+    if (entry == nullptr) {
         return 0;
     }
 
-    return iter->second.GetAppliedIndex();
+    return entry->info.GetAppliedIndex();
 }
 
 void MetaCache::UpdateChunkInfoByID(ChunkID cid, const ChunkIDInfo& cidinfo) {
@@ -338,17 +370,19 @@ void MetaCache::SetChunkserverUnstable(ChunkServerID csid) {
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
     for (auto it : copysetIDSet) {
         const auto key = CalcLogicPoolCopysetID(it.lpid, it.cpid);
-        auto cpinfo = lpcsid2CopsetInfoMap_.find(key);
-        if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
+        auto* entry = lpcsid2CopsetInfoMap_.Find(key);
+        if (entry != nullptr) {
             ChunkServerID leaderid;
-            if (cpinfo->second.GetCurrentLeaderID(&leaderid)) {
+            if (entry->info.GetCurrentLeaderID(&leaderid)) {
                 if (leaderid == csid) {
                     // 只设置leaderid为当前serverid的Lcopyset
-                    cpinfo->second.SetLeaderUnstableFlag();
+                    entry->info.SetLeaderUnstableFlag();
+                    PublishLeader(entry);
                 }
             } else {
                 // 当前copyset集群信息未知，直接设置LeaderUnStable
-                cpinfo->second.SetLeaderUnstableFlag();
+                entry->info.SetLeaderUnstableFlag();
+                PublishLeader(entry);
             }
         }
     }
@@ -362,16 +396,16 @@ void MetaCache::AddCopysetIDInfo(ChunkServerID csid,
 
 void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
                                  const CopysetInfo<ChunkServerID>& cpinfo) {
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
     const auto key = CalcLogicPoolCopysetID(lpid, cpinfo.cpid_);
     // 先获取原来的chunkserver到copyset映射
-    auto previouscpinfo = lpcsid2CopsetInfoMap_.find(key);
-    if (previouscpinfo != lpcsid2CopsetInfoMap_.end()) {
+    auto* previouscpinfo = lpcsid2CopsetInfoMap_.Find(key);
+    if (previouscpinfo != nullptr) {
+        ReadLockGuard rdlk(rwlock4CopysetInfo_);
         std::vector<ChunkServerID> newID;
         std::vector<ChunkServerID> changedID;
 
         // 先判断当前copyset有没有变更chunkserverid
-        for (auto iter : previouscpinfo->second.csinfos_) {
+        for (auto iter : previouscpinfo->info.csinfos_) {
             changedID.push_back(iter.peerID);
         }
 
@@ -406,47 +440,40 @@ void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
 
 CopysetInfo<ChunkServerID> MetaCache::GetCopysetinfo(
     LogicPoolID lpid, CopysetID csid) {
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
     const auto key = CalcLogicPoolCopysetID(lpid, csid);
-    auto cpinfo = lpcsid2CopsetInfoMap_.find(key);
-    if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
-        return cpinfo->second;
+    auto* entry = lpcsid2CopsetInfoMap_.Find(key);
+    if (entry != nullptr) {
+        ReadLockGuard rdlk(rwlock4CopysetInfo_);
+        return entry->info;
     }
     return CopysetInfo<ChunkServerID>();
 }
 
 FileSegment* MetaCache::GetFileSegment(SegmentIndex segmentIndex) {
-    {
-        ReadLockGuard lk(rwlock4Segments_);
-        auto iter = segments_.find(segmentIndex);
-        if (iter != segments_.end()) {
-            return &iter->second;
-        }
-    }
-
-    WriteLockGuard lk(rwlock4Segments_);
-    auto ret = segments_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(segmentIndex),
-        std::forward_as_tuple(segmentIndex,
-                              fileInfo_.segmentsize,
-                              metacacheopt_.discardGranularity));
-
-    return &(ret.first->second);
+    return segments_.GetFileSegment(segmentIndex);
 }
 
 void MetaCache::CleanChunksInSegment(SegmentIndex segmentIndex) {
-    WriteLockGuard lk(rwlock4chunkInfoMap_);
     ChunkIndex beginChunkIndex = static_cast<uint64_t>(segmentIndex) *
                                  fileInfo_.segmentsize / fileInfo_.chunksize;
     ChunkIndex endChunkIndex = static_cast<uint64_t>(segmentIndex + 1) *
                                fileInfo_.segmentsize / fileInfo_.chunksize;
 
-    auto currentIndex = beginChunkIndex;
-    while (currentIndex < endChunkIndex) {
-        chunkindex2idMap_.erase(currentIndex);
-        ++currentIndex;
-    }
+    segments_.CleanChunks(beginChunkIndex, endChunkIndex);
+}
+
+uint64_t MetaCache::MemoryUsage() const {
+    return segments_.MemoryUsage() + lpcsid2CopsetInfoMap_.MemoryUsage();
+}
+
+static uint64_t GetMetaCacheMemoryUsage(void* arg) {
+    return static_cast<MetaCache*>(arg)->MemoryUsage();
+}
+
+void MetaCache::ExposeMemoryMetric(const std::string& filename) {
+    memoryMetric_.reset(new bvar::PassiveStatus<uint64_t>(
+        "curve_client", filename + "_metacache_bytes",
+        GetMetaCacheMemoryUsage, this));
 }
 
 }   // namespace client
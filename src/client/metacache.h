@@ -22,6 +22,9 @@
 #ifndef SRC_CLIENT_METACACHE_H_
 #define SRC_CLIENT_METACACHE_H_
 
+#include <bvar/bvar.h>
+
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -31,14 +34,19 @@
 #include "src/client/client_metric.h"
 #include "src/client/mds_client.h"
 #include "src/client/metacache_struct.h"
+#include "src/client/segment_table.h"
 #include "src/client/service_helper.h"
 #include "src/client/unstable_helper.h"
+#include "src/common/concurrent/append_only_hash_map.h"
 #include "src/common/concurrent/rw_lock.h"
+#include "src/common/concurrent/seqlock.h"
 
 namespace curve {
 namespace client {
 
+using curve::common::AppendOnlyHashMap;
 using curve::common::RWLock;
+using curve::common::SeqLockValue;
 
 enum class MetaCacheErrorType {
     OK = 0,
@@ -52,9 +60,6 @@ class MetaCache {
  public:
     using LogicPoolCopysetID = uint64_t;
     using ChunkInfoMap = std::unordered_map<ChunkID, ChunkIDInfo>;
-    using CopysetInfoMap =
-        std::unordered_map<LogicPoolCopysetID, CopysetInfo<ChunkServerID>>;
-    using ChunkIndexInfoMap = std::unordered_map<ChunkIndex, ChunkIDInfo>;
 
     MetaCache() = default;
     virtual ~MetaCache() = default;
@@ -202,7 +207,7 @@ class MetaCache {
     UpdateChunkserverCopysetInfo(LogicPoolID lpid,
                                  const CopysetInfo<ChunkServerID> &cpinfo);
 
-    void UpdateFileInfo(const FInfo &fileInfo) { fileInfo_ = fileInfo; }
+    void UpdateFileInfo(const FInfo &fileInfo);
 
     const FInfo *GetFileInfo() const { return &fileInfo_; }
 
@@ -253,7 +258,44 @@ class MetaCache {
      */
     virtual void CleanChunksInSegment(SegmentIndex segmentIndex);
 
+    /**
+     * @brief 元数据缓存占用的内存，包括chunk索引、segment和copyset信息
+     */
+    uint64_t MemoryUsage() const;
+
+    /**
+     * @brief 以metric暴露当前文件元数据缓存占用的内存
+     * @param filename 文件名，metric名为curve_client_{filename}_metacache_bytes
+     */
+    void ExposeMemoryMetric(const std::string &filename);
+
  private:
+    // IO路径上需要的copyset leader信息，可以无锁读取
+    struct CopysetLeader {
+        ChunkServerID id = 0;
+        uint32_t ip = 0;
+        int32_t port = 0;
+        // leader是否已知
+        bool valid = false;
+        bool leaderMayChange = false;
+    };
+
+    struct CopysetCacheEntry {
+        // 受rwlock4CopysetInfo_保护，其中的appliedindex可以无锁访问
+        CopysetInfo<ChunkServerID> info;
+        // info中leader信息的副本，info变化后由PublishLeader更新
+        SeqLockValue<CopysetLeader> leader;
+    };
+
+    using CopysetInfoMap =
+        AppendOnlyHashMap<LogicPoolCopysetID, CopysetCacheEntry>;
+
+    /**
+     * 根据copyset info更新无锁读取的leader信息，
+     * 调用者需持有rwlock4CopysetInfo_的读锁或写锁
+     */
+    static void PublishLeader(CopysetCacheEntry* entry);
+
     /**
      * @brief 从mds更新copyset复制组信息
      * @param logicPoolId 逻辑池id
@@ -287,22 +329,18 @@ class MetaCache {
     MDSClient *mdsclient_;
     MetaCacheOption metacacheopt_;
 
-    // chunkindex到chunkidinfo的映射表
-    CURVE_CACHELINE_ALIGNMENT ChunkIndexInfoMap chunkindex2idMap_;
+    // 按segment分页的chunk索引以及FileSegment，IO路径无锁读取
+    CURVE_CACHELINE_ALIGNMENT SegmentTable segments_;
 
-    CURVE_CACHELINE_ALIGNMENT RWLock rwlock4Segments_;
-    CURVE_CACHELINE_ALIGNMENT std::unordered_map<SegmentIndex, FileSegment>
-        segments_;  // NOLINT
-
-    // logicalpoolid和copysetid到copysetinfo的映射表
+    // logicalpoolid和copysetid到copysetinfo的映射表，IO路径无锁读取
     CURVE_CACHELINE_ALIGNMENT CopysetInfoMap lpcsid2CopsetInfoMap_;
 
     // chunkid到chunkidinfo的映射表
     CURVE_CACHELINE_ALIGNMENT ChunkInfoMap chunkid2chunkInfoMap_;
 
-    // 三个读写锁分别保护上述三个映射表
+    // 保护chunkid2chunkInfoMap_
     CURVE_CACHELINE_ALIGNMENT RWLock rwlock4chunkInfoMap_;
-    CURVE_CACHELINE_ALIGNMENT RWLock rwlock4ChunkInfo_;
+    // 保护lpcsid2CopsetInfoMap_中copyset info的非原子成员
     CURVE_CACHELINE_ALIGNMENT RWLock rwlock4CopysetInfo_;
 
     // chunkserverCopysetIDMap_存放当前chunkserver到copyset的映射
@@ -323,6 +361,8 @@ class MetaCache {
     FileEpoch fEpoch_;
 
     UnstableHelper unstableHelper_;
+
+    std::unique_ptr<bvar::PassiveStatus<uint64_t>> memoryMetric_;
 };
 
 }  // namespace client
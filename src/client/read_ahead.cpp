@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-25
+ */
+
+#include "src/client/read_ahead.h"
+
+#include <algorithm>
+
+namespace curve {
+namespace client {
+
+StreamDetector::StreamDetector(const ReadAheadOption& opt, uint32_t align)
+    : align_(std::max<uint32_t>(align, 1)),
+      triggerCount_(std::max<uint32_t>(opt.triggerCount, 1)),
+      // 窗口至少为一个对齐单位
+      initWindow_(std::max<uint64_t>(
+          AlignDown(static_cast<uint64_t>(opt.initWindowKB) * 1024), align_)),
+      maxWindow_(std::max<uint64_t>(
+          AlignDown(static_cast<uint64_t>(opt.maxWindowKB) * 1024),
+          initWindow_)),
+      nextOffset_(0),
+      seqCount_(0),
+      window_(initWindow_),
+      prefetchEnd_(0) {}
+
+void StreamDetector::Reset(uint64_t nextOffset) {
+    nextOffset_ = nextOffset;
+    seqCount_ = 1;
+    window_ = initWindow_;
+    prefetchEnd_ = 0;
+}
+
+bool StreamDetector::OnRead(uint64_t offset, uint64_t length,
+                            uint64_t fileLength, ReadAheadRange* range) {
+    if (length == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    uint64_t end = offset + length;
+    bool sequential = (offset == nextOffset_ && seqCount_ > 0) ||
+                      (offset >= nextOffset_ && offset < prefetchEnd_);
+    if (!sequential) {
+        Reset(end);
+    } else {
+        nextOffset_ = std::max(nextOffset_, end);
+        seqCount_ = std::min(seqCount_ + 1, triggerCount_);
+    }
+
+    if (seqCount_ < triggerCount_) {
+        return false;
+    }
+
+    // 已预读的数据还足够后续的读请求使用
+    if (prefetchEnd_ > end && prefetchEnd_ - end >= window_ / 2) {
+        return false;
+    }
+
+    // 上一次预读的数据已经被读了一半以上，顺序读仍在持续，扩大窗口
+    if (prefetchEnd_ != 0) {
+        window_ = std::min(window_ * 2, maxWindow_);
+    }
+
+    uint64_t begin = AlignDown(std::max(prefetchEnd_, end));
+    if (begin >= fileLength) {
+        return false;
+    }
+
+    range->offset = begin;
+    range->length = std::min(window_, fileLength - begin);
+    prefetchEnd_ = begin + range->length;
+    return true;
+}
+
+}  // namespace client
+}  // namespace curve
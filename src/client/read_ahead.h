@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-25
+ */
+
+
+#ifndef SRC_CLIENT_READ_AHEAD_H_
+#define SRC_CLIENT_READ_AHEAD_H_
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+
+#include "src/client/config_info.h"
+
+namespace curve {
+namespace client {
+
+struct ReadAheadRange {
+    uint64_t offset = 0;
+    uint64_t length = 0;
+};
+
+/**
+ * 识别文件上的顺序读流，并计算需要预读的范围
+ *
+ * 读请求从上一个读请求的结束位置开始，或者落在已经预读的范围内时认为是
+ * 顺序的，后一种情况用于异步读请求乱序到达的场景。连续triggerCount个
+ * 顺序读请求之后开始预读，之后每当已预读但还没有被读到的数据少于半个
+ * 窗口时发起下一次预读，并将窗口加倍直到maxWindowKB。出现非顺序的读
+ * 请求时窗口恢复为initWindowKB。
+ */
+class StreamDetector {
+ public:
+    /**
+     * @param align 预读范围的对齐大小，与读缓存的块大小相同，
+     *        保证预读的数据可以完整地填充缓存块
+     */
+    StreamDetector(const ReadAheadOption& opt, uint32_t align);
+
+    /**
+     * @brief 用户读请求到达时调用
+     * @param fileLength 文件大小，预读范围不会超过文件末尾
+     * @param[out] range 需要预读的范围
+     * @return 需要发起预读时返回true
+     */
+    bool OnRead(uint64_t offset, uint64_t length, uint64_t fileLength,
+                ReadAheadRange* range);
+
+    uint64_t Window() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return window_;
+    }
+
+ private:
+    uint64_t AlignDown(uint64_t value) const {
+        return value / align_ * align_;
+    }
+
+    void Reset(uint64_t nextOffset);
+
+ private:
+    const uint32_t align_;
+    const uint32_t triggerCount_;
+    const uint64_t initWindow_;
+    const uint64_t maxWindow_;
+
+    mutable std::mutex mtx_;
+
+    // 顺序读流中下一个读请求的期望位置
+    uint64_t nextOffset_;
+    // 连续的顺序读请求个数
+    uint32_t seqCount_;
+    // 下一次预读的大小
+    uint64_t window_;
+    // 已经发起预读的结束位置，为0表示还没有预读
+    uint64_t prefetchEnd_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_READ_AHEAD_H_
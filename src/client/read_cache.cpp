@@ -0,0 +1,432 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-24
+ */
+
+#include "src/client/read_cache.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sched.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>  // NOLINT
+
+namespace curve {
+namespace client {
+
+namespace {
+
+const char* kReadCacheMetricPrefix = "curve_client_read_cache";
+
+// 共享内存文件头部占用的大小，保证写代数和槽位按页对齐
+const size_t kSharedHeaderSize = 4096;
+
+const uint32_t kMaxRemoveRetry = 1000;
+
+}  // namespace
+
+uint64_t ReadCacheClusterId(const std::string& uuid) {
+    // FNV-1a，std::hash的结果不保证在不同的构建之间一致
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (unsigned char c : uuid) {
+        h ^= c;
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+const uint32_t ReadCacheStore::kWriteGenSlots;
+
+std::shared_ptr<ReadCacheStore> ReadCacheStore::GetInstance(
+    const ReadCacheOption& opt) {
+    static std::mutex mtx;
+    static std::shared_ptr<ReadCacheStore> instance;
+
+    std::lock_guard<std::mutex> lk(mtx);
+    if (instance != nullptr) {
+        return instance;
+    }
+
+    uint64_t capacity = opt.capacityMB * 1024 * 1024;
+    if (!opt.sharedPath.empty()) {
+        std::shared_ptr<SharedReadCacheStore> shared =
+            std::make_shared<SharedReadCacheStore>(opt.blockSize, capacity,
+                                                   opt.sharedPath);
+        if (shared->Init()) {
+            instance = shared;
+            return instance;
+        }
+        LOG(WARNING) << "Init shared read cache failed, path = "
+                     << opt.sharedPath << ", use process read cache instead";
+    }
+
+    instance = std::make_shared<MemoryReadCacheStore>(opt.blockSize, capacity);
+    return instance;
+}
+
+const uint32_t MemoryReadCacheStore::kShards;
+
+MemoryReadCacheStore::MemoryReadCacheStore(uint32_t blockSize,
+                                           uint64_t capacity)
+    : MemoryReadCacheStore(blockSize, capacity, kReadCacheMetricPrefix) {}
+
+MemoryReadCacheStore::MemoryReadCacheStore(uint32_t blockSize,
+                                           uint64_t capacity,
+                                           const std::string& metricPrefix)
+    : ReadCacheStore(blockSize),
+      metrics_(std::make_shared<common::CacheMetrics>(metricPrefix)),
+      writeGenBuffer_(new std::atomic<uint64_t>[kWriteGenSlots]()) {
+    writeGens_ = writeGenBuffer_.get();
+    uint64_t blocksPerShard =
+        std::max<uint64_t>(1, capacity / blockSize / kShards);
+    for (uint32_t i = 0; i < kShards; ++i) {
+        shards_.emplace_back(new Shard(blocksPerShard, metrics_));
+    }
+}
+
+bool MemoryReadCacheStore::Get(const ReadCacheKey& key, uint32_t offset,
+                               uint32_t length, char* buf) {
+    Block block;
+    if (!GetShard(key)->Get(key, &block)) {
+        return false;
+    }
+
+    // 块的数据不会再修改，可以在锁外拷贝
+    std::memcpy(buf, block->data() + offset, length);
+    return true;
+}
+
+void MemoryReadCacheStore::Put(const ReadCacheKey& key,
+                               const butil::IOBuf& data, size_t pos) {
+    Block block = std::make_shared<std::string>(blockSize_, '\0');
+    if (data.copy_to(&(*block)[0], blockSize_, pos) != blockSize_) {
+        return;
+    }
+    GetShard(key)->Put(key, block);
+}
+
+void MemoryReadCacheStore::Remove(const ReadCacheKey& key) {
+    GetShard(key)->Remove(key);
+}
+
+const uint64_t SharedReadCacheStore::kMagic;
+
+SharedReadCacheStore::SharedReadCacheStore(uint32_t blockSize,
+                                           uint64_t capacity,
+                                           const std::string& path)
+    : ReadCacheStore(blockSize),
+      path_(path),
+      slotCount_(std::max<uint64_t>(1, capacity / blockSize)),
+      addr_(nullptr),
+      slots_(nullptr),
+      data_(nullptr) {}
+
+SharedReadCacheStore::~SharedReadCacheStore() {
+    if (addr_ != nullptr) {
+        munmap(addr_, MappedSize());
+    }
+}
+
+size_t SharedReadCacheStore::MappedSize() const {
+    return kSharedHeaderSize + kWriteGenSlots * sizeof(uint64_t) +
+           slotCount_ * sizeof(Slot) + slotCount_ * blockSize_;
+}
+
+bool SharedReadCacheStore::Init() {
+    int fd = open(path_.c_str(), O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        LOG(ERROR) << "Open read cache file failed, path = " << path_
+                   << ", error = " << strerror(errno);
+        return false;
+    }
+
+    // 多个进程同时打开时，由第一个进程初始化文件
+    if (flock(fd, LOCK_EX) != 0) {
+        LOG(ERROR) << "Lock read cache file failed, path = " << path_
+                   << ", error = " << strerror(errno);
+        close(fd);
+        return false;
+    }
+
+    bool ok = false;
+    do {
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            LOG(ERROR) << "Stat read cache file failed, path = " << path_
+                       << ", error = " << strerror(errno);
+            break;
+        }
+
+        size_t size = MappedSize();
+        bool fresh = st.st_size == 0;
+        if (fresh && ftruncate(fd, size) != 0) {
+            LOG(ERROR) << "Truncate read cache file failed, path = " << path_
+                       << ", error = " << strerror(errno);
+            break;
+        }
+        if (!fresh && static_cast<size_t>(st.st_size) != size) {
+            LOG(ERROR) << "Read cache file size mismatch, path = " << path_
+                       << ", size = " << st.st_size << ", expected = " << size;
+            break;
+        }
+
+        void* addr =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            LOG(ERROR) << "Mmap read cache file failed, path = " << path_
+                       << ", error = " << strerror(errno);
+            break;
+        }
+
+        Header* header = static_cast<Header*>(addr);
+        if (fresh) {
+            header->blockSize = blockSize_;
+            header->slots = slotCount_;
+            header->writeGenSlots = kWriteGenSlots;
+            header->magic = kMagic;
+        } else if (header->magic != kMagic ||
+                   header->blockSize != blockSize_ ||
+                   header->slots != slotCount_ ||
+                   header->writeGenSlots != kWriteGenSlots) {
+            LOG(ERROR) << "Read cache file layout mismatch, path = " << path_
+                       << ", block size = " << header->blockSize
+                       << ", slots = " << header->slots;
+            munmap(addr, size);
+            break;
+        }
+
+        addr_ = addr;
+        writeGens_ = reinterpret_cast<std::atomic<uint64_t>*>(
+            static_cast<char*>(addr) + kSharedHeaderSize);
+        slots_ = reinterpret_cast<Slot*>(writeGens_ + kWriteGenSlots);
+        data_ = reinterpret_cast<char*>(slots_ + slotCount_);
+        ok = true;
+    } while (0);
+
+    flock(fd, LOCK_UN);
+    close(fd);
+
+    if (ok) {
+        metrics_ =
+            std::make_shared<common::CacheMetrics>(kReadCacheMetricPrefix);
+        LOG(INFO) << "Init shared read cache success, path = " << path_
+                  << ", block size = " << blockSize_
+                  << ", slots = " << slotCount_;
+    }
+    return ok;
+}
+
+bool SharedReadCacheStore::Match(const Slot* slot,
+                                 const ReadCacheKey& key) const {
+    return slot->version.load(std::memory_order_relaxed) == key.version &&
+           slot->fileId.load(std::memory_order_relaxed) == key.fileId &&
+           slot->clusterId.load(std::memory_order_relaxed) == key.clusterId &&
+           slot->blockIndex.load(std::memory_order_relaxed) == key.blockIndex;
+}
+
+bool SharedReadCacheStore::Get(const ReadCacheKey& key, uint32_t offset,
+                               uint32_t length, char* buf) {
+    const Slot* slot = GetSlot(key);
+    uint64_t seq = slot->seq.load(std::memory_order_acquire);
+    bool hit = false;
+    if (!(seq & 1) && Match(slot, key)) {
+        std::memcpy(buf, SlotData(slot) + offset, length);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // 拷贝期间槽位被改写，调用者会丢弃buf中的数据
+        hit = seq == slot->seq.load(std::memory_order_relaxed);
+    }
+
+    if (hit) {
+        metrics_->OnCacheHit();
+    } else {
+        metrics_->OnCacheMiss();
+    }
+    return hit;
+}
+
+bool SharedReadCacheStore::BeginWrite(Slot* slot, uint64_t* seq) {
+    // 其他写者正在写这个槽位时放弃
+    uint64_t current = slot->seq.load(std::memory_order_relaxed);
+    if ((current & 1) ||
+        !slot->seq.compare_exchange_strong(current, current + 1,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    *seq = current;
+    return true;
+}
+
+void SharedReadCacheStore::EndWrite(Slot* slot, uint64_t seq) {
+    slot->seq.store(seq + 2, std::memory_order_release);
+}
+
+void SharedReadCacheStore::Put(const ReadCacheKey& key,
+                               const butil::IOBuf& data, size_t pos) {
+    Slot* slot = GetSlot(key);
+    uint64_t seq;
+    if (!BeginWrite(slot, &seq)) {
+        return;
+    }
+
+    if (data.copy_to(SlotData(slot), blockSize_, pos) == blockSize_) {
+        slot->clusterId.store(key.clusterId, std::memory_order_relaxed);
+        slot->fileId.store(key.fileId, std::memory_order_relaxed);
+        slot->version.store(key.version, std::memory_order_relaxed);
+        slot->blockIndex.store(key.blockIndex, std::memory_order_relaxed);
+    } else {
+        slot->version.store(0, std::memory_order_relaxed);
+    }
+    EndWrite(slot, seq);
+}
+
+void SharedReadCacheStore::Remove(const ReadCacheKey& key) {
+    Slot* slot = GetSlot(key);
+    // 淘汰不能因为并发的写者而放弃，需要等待其完成。写者所在的进程
+    // 退出时槽位一直处于写状态，不会再被读到，等待一段时间后放弃
+    uint64_t seq;
+    uint32_t retry = 0;
+    while (!BeginWrite(slot, &seq)) {
+        if (++retry > kMaxRemoveRetry) {
+            return;
+        }
+        sched_yield();
+    }
+
+    if (Match(slot, key)) {
+        slot->version.store(0, std::memory_order_relaxed);
+    }
+    EndWrite(slot, seq);
+}
+
+FileReadCache::FileReadCache(std::shared_ptr<ReadCacheStore> store,
+                             uint64_t clusterId, FileMetric* metric)
+    : store_(std::move(store)),
+      blockSize_(store_->BlockSize()),
+      clusterId_(clusterId),
+      metric_(metric),
+      fileId_(0),
+      version_(0) {}
+
+void FileReadCache::UpdateVersion(uint64_t fileId, uint64_t seqnum,
+                                  uint64_t epoch) {
+    // 0表示缓存不可用
+    uint64_t version = (seqnum << 32 | (epoch & 0xFFFFFFFF)) | (1ULL << 63);
+    fileId_.store(fileId, std::memory_order_relaxed);
+    version_.store(version, std::memory_order_release);
+}
+
+bool FileReadCache::Read(off_t offset, size_t length, char* buf) {
+    ReadCacheKey key;
+    key.clusterId = clusterId_;
+    key.version = version_.load(std::memory_order_acquire);
+    key.fileId = fileId_.load(std::memory_order_relaxed);
+    if (key.version == 0 || length == 0) {
+        return false;
+    }
+
+    uint64_t end = offset + length;
+    uint64_t pos = offset;
+    while (pos < end) {
+        key.blockIndex = pos / blockSize_;
+        uint32_t inBlock = pos % blockSize_;
+        uint32_t n = std::min<uint64_t>(blockSize_ - inBlock, end - pos);
+        if (!store_->Get(key, inBlock, n, buf + (pos - offset))) {
+            if (metric_ != nullptr) {
+                metric_->readCacheMiss.count << 1;
+            }
+            return false;
+        }
+        pos += n;
+    }
+
+    if (metric_ != nullptr) {
+        metric_->readCacheHit.count << 1;
+    }
+    return true;
+}
+
+FileReadCache::FillToken FileReadCache::BeginFill() const {
+    FillToken token;
+    token.version = version_.load(std::memory_order_acquire);
+    token.fileId = fileId_.load(std::memory_order_relaxed);
+    token.writeGen = store_->WriteGen(clusterId_, token.fileId);
+    return token;
+}
+
+void FileReadCache::Fill(const FillToken& token, off_t offset, size_t length,
+                         const butil::IOBuf& data) {
+    if (token.version == 0 ||
+        token.writeGen != store_->WriteGen(clusterId_, token.fileId)) {
+        return;
+    }
+
+    // 只填充完整覆盖的块
+    uint64_t first = (offset + blockSize_ - 1) / blockSize_;
+    uint64_t last = (offset + length) / blockSize_;
+    if (first >= last) {
+        return;
+    }
+
+    ReadCacheKey key{clusterId_, token.fileId, token.version, 0};
+    for (key.blockIndex = first; key.blockIndex < last; ++key.blockIndex) {
+        store_->Put(key, data, key.blockIndex * blockSize_ - offset);
+    }
+
+    // 填充期间有写请求开始或结束，它的淘汰可能发生在填充之前
+    if (token.writeGen != store_->WriteGen(clusterId_, token.fileId)) {
+        RemoveBlocks(token, first, last);
+    }
+}
+
+void FileReadCache::BeginWrite(off_t offset, size_t length) {
+    Invalidate(offset, length);
+}
+
+void FileReadCache::EndWrite(off_t offset, size_t length) {
+    Invalidate(offset, length);
+}
+
+void FileReadCache::Invalidate(off_t offset, size_t length) {
+    store_->BumpWriteGen(clusterId_, fileId_.load(std::memory_order_relaxed));
+    FillToken token = BeginFill();
+    if (token.version == 0 || length == 0) {
+        return;
+    }
+    RemoveBlocks(token, offset / blockSize_,
+                 (offset + length + blockSize_ - 1) / blockSize_);
+}
+
+void FileReadCache::RemoveBlocks(const FillToken& token, uint64_t first,
+                                 uint64_t last) {
+    ReadCacheKey key{clusterId_, token.fileId, token.version, 0};
+    for (key.blockIndex = first; key.blockIndex < last; ++key.blockIndex) {
+        store_->Remove(key);
+    }
+}
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,341 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-24
+ */
+
+#ifndef SRC_CLIENT_READ_CACHE_H_
+#define SRC_CLIENT_READ_CACHE_H_
+
+#include <butil/iobuf.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/client/client_metric.h"
+#include "src/client/config_info.h"
+#include "src/common/lru_cache.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * 缓存块的key，version由文件的sn和epoch计算，
+ * 文件打快照或者epoch变化后旧的缓存块不会再被命中。
+ * 不同集群的文件id可能相同，clusterId由集群的uuid计算
+ */
+struct ReadCacheKey {
+    uint64_t clusterId;
+    uint64_t fileId;
+    uint64_t version;
+    uint64_t blockIndex;
+
+    bool operator==(const ReadCacheKey& other) const {
+        return clusterId == other.clusterId && fileId == other.fileId &&
+               version == other.version && blockIndex == other.blockIndex;
+    }
+};
+
+struct ReadCacheKeyHash {
+    size_t operator()(const ReadCacheKey& key) const {
+        uint64_t h = key.clusterId * 0x9E3779B97F4A7C15ULL;
+        h ^= key.fileId + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= key.version + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= key.blockIndex + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+}  // namespace client
+}  // namespace curve
+
+namespace std {
+template <>
+struct hash<curve::client::ReadCacheKey>
+    : public curve::client::ReadCacheKeyHash {};
+}  // namespace std
+
+namespace curve {
+namespace client {
+
+/**
+ * @brief 由集群的uuid计算缓存key中的clusterId，不同进程中的结果相同
+ */
+uint64_t ReadCacheClusterId(const std::string& uuid);
+
+/**
+ * 缓存块的存储，按固定大小的块保存数据
+ */
+class ReadCacheStore {
+ public:
+    explicit ReadCacheStore(uint32_t blockSize) : blockSize_(blockSize) {}
+    virtual ~ReadCacheStore() = default;
+
+    /**
+     * @brief 读取缓存块中[offset, offset + length)的数据
+     * @return 缓存块存在返回true
+     */
+    virtual bool Get(const ReadCacheKey& key, uint32_t offset,
+                     uint32_t length, char* buf) = 0;
+
+    /**
+     * @brief 保存缓存块，数据为data中从pos开始的一个块
+     */
+    virtual void Put(const ReadCacheKey& key, const butil::IOBuf& data,
+                     size_t pos) = 0;
+
+    virtual void Remove(const ReadCacheKey& key) = 0;
+
+    /**
+     * @brief 文件的写代数，本地写请求开始和结束时递增。读请求开始之后
+     *        写代数变化时，读到的数据不填充缓存。
+     *        写代数保存在与缓存块相同的存储中，共享缓存时其他进程的写
+     *        请求同样可见；不同文件可能映射到同一个计数，只会多放弃填充
+     */
+    uint64_t WriteGen(uint64_t clusterId, uint64_t fileId) const {
+        return GetWriteGen(clusterId, fileId)->load();
+    }
+
+    void BumpWriteGen(uint64_t clusterId, uint64_t fileId) {
+        GetWriteGen(clusterId, fileId)->fetch_add(1);
+    }
+
+    uint32_t BlockSize() const {
+        return blockSize_;
+    }
+
+    /**
+     * @brief 获取进程内所有文件共享的缓存，第一次调用时按opt创建，
+     *        共享内存文件无法使用时退化为进程内缓存
+     */
+    static std::shared_ptr<ReadCacheStore> GetInstance(
+        const ReadCacheOption& opt);
+
+ protected:
+    static const uint32_t kWriteGenSlots = 4096;
+
+    std::atomic<uint64_t>* GetWriteGen(uint64_t clusterId,
+                                       uint64_t fileId) const {
+        ReadCacheKey key{clusterId, fileId, 0, 0};
+        return &writeGens_[ReadCacheKeyHash()(key) % kWriteGenSlots];
+    }
+
+ protected:
+    const uint32_t blockSize_;
+    // kWriteGenSlots个写代数，由子类分配
+    std::atomic<uint64_t>* writeGens_ = nullptr;
+};
+
+/**
+ * 进程内的缓存，按key分片的LRU
+ */
+class MemoryReadCacheStore : public ReadCacheStore {
+ public:
+    MemoryReadCacheStore(uint32_t blockSize, uint64_t capacity);
+
+    /**
+     * @param metricPrefix 缓存metric的前缀，用于区分文件私有的缓存
+     */
+    MemoryReadCacheStore(uint32_t blockSize, uint64_t capacity,
+                         const std::string& metricPrefix);
+
+    bool Get(const ReadCacheKey& key, uint32_t offset, uint32_t length,
+             char* buf) override;
+
+    void Put(const ReadCacheKey& key, const butil::IOBuf& data,
+             size_t pos) override;
+
+    void Remove(const ReadCacheKey& key) override;
+
+    std::shared_ptr<common::CacheMetrics> GetCacheMetrics() const {
+        return metrics_;
+    }
+
+ private:
+    using Block = std::shared_ptr<std::string>;
+
+    struct BlockTraits {
+        static uint64_t CountBytes(const Block& block) {
+            return block->size();
+        }
+    };
+
+    using Shard = common::LRUCache<ReadCacheKey, Block,
+                                   common::CacheTraits<ReadCacheKey>,
+                                   BlockTraits>;
+
+    static const uint32_t kShards = 16;
+
+    Shard* GetShard(const ReadCacheKey& key) {
+        return shards_[ReadCacheKeyHash()(key) % kShards].get();
+    }
+
+ private:
+    std::shared_ptr<common::CacheMetrics> metrics_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::unique_ptr<std::atomic<uint64_t>[]> writeGenBuffer_;
+};
+
+/**
+ * 映射共享内存文件的缓存，同一主机上打开相同卷的多个进程共享缓存数据
+ *
+ * 缓存块按key的hash直接映射到槽位，冲突时覆盖旧的块。每个槽位由序列号
+ * 保护：写者通过CAS将序列号置为奇数后写入，读者拷贝数据后检查序列号
+ * 没有变化，因此不同进程之间不需要加锁。
+ * 文件的写代数也保存在共享内存中，一个进程的写请求会阻止其他进程在
+ * 此期间发起的读请求填充缓存。
+ */
+class SharedReadCacheStore : public ReadCacheStore {
+ public:
+    SharedReadCacheStore(uint32_t blockSize, uint64_t capacity,
+                         const std::string& path);
+    ~SharedReadCacheStore();
+
+    /**
+     * @brief 打开或创建共享内存文件，已有文件的布局与配置不同时失败
+     */
+    bool Init();
+
+    bool Get(const ReadCacheKey& key, uint32_t offset, uint32_t length,
+             char* buf) override;
+
+    void Put(const ReadCacheKey& key, const butil::IOBuf& data,
+             size_t pos) override;
+
+    void Remove(const ReadCacheKey& key) override;
+
+ private:
+    struct Header {
+        uint64_t magic;
+        uint64_t blockSize;
+        uint64_t slots;
+        uint64_t writeGenSlots;
+    };
+
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        std::atomic<uint64_t> clusterId;
+        std::atomic<uint64_t> fileId;
+        // 0表示槽位为空
+        std::atomic<uint64_t> version;
+        std::atomic<uint64_t> blockIndex;
+    };
+
+    // 布局变化时需要修改，旧的共享内存文件会打开失败
+    static const uint64_t kMagic = 0x6375727665726379ULL;
+
+    Slot* GetSlot(const ReadCacheKey& key) const {
+        return &slots_[ReadCacheKeyHash()(key) % slotCount_];
+    }
+
+    char* SlotData(const Slot* slot) const {
+        return data_ + (slot - slots_) * blockSize_;
+    }
+
+    bool Match(const Slot* slot, const ReadCacheKey& key) const;
+
+    // 成功时返回写之前的序列号
+    bool BeginWrite(Slot* slot, uint64_t* seq);
+
+    void EndWrite(Slot* slot, uint64_t seq);
+
+    size_t MappedSize() const;
+
+ private:
+    const std::string path_;
+    const uint64_t slotCount_;
+
+    void* addr_;
+    Slot* slots_;
+    char* data_;
+
+    std::shared_ptr<common::CacheMetrics> metrics_;
+};
+
+/**
+ * 单个文件的读缓存
+ *
+ * 只有完整覆盖一个缓存块的读请求才会填充这个块，读请求需要的块全部在
+ * 缓存中时才由缓存返回。本地的写请求在开始和结束时都会淘汰对应的块，
+ * 并且递增store中的写代数：读请求开始之后有写请求发生时，读到的数据
+ * 不会被填充，避免旧数据覆盖新写入的数据。
+ */
+class FileReadCache {
+ public:
+    /**
+     * @param clusterId 文件所在集群，由ReadCacheClusterId计算
+     */
+    FileReadCache(std::shared_ptr<ReadCacheStore> store, uint64_t clusterId,
+                  FileMetric* metric);
+
+    // 读请求开始时的状态，填充时用于检查期间是否有写请求
+    struct FillToken {
+        uint64_t fileId = 0;
+        uint64_t version = 0;
+        uint64_t writeGen = 0;
+    };
+
+    /**
+     * @brief 文件信息更新时调用，sn或者epoch变化后之前的缓存全部失效
+     */
+    void UpdateVersion(uint64_t fileId, uint64_t seqnum, uint64_t epoch);
+
+    /**
+     * @brief 从缓存读取[offset, offset + length)，只要有一个块不在缓存
+     *        中就返回false
+     */
+    bool Read(off_t offset, size_t length, char* buf);
+
+    FillToken BeginFill() const;
+
+    /**
+     * @brief 用读请求返回的数据填充缓存
+     */
+    void Fill(const FillToken& token, off_t offset, size_t length,
+              const butil::IOBuf& data);
+
+    /**
+     * @brief 写请求或discard开始和结束时调用，淘汰对应的缓存块
+     */
+    void BeginWrite(off_t offset, size_t length);
+    void EndWrite(off_t offset, size_t length);
+
+ private:
+    void Invalidate(off_t offset, size_t length);
+
+    // 淘汰[first, last)范围内的块
+    void RemoveBlocks(const FillToken& token, uint64_t first, uint64_t last);
+
+ private:
+    std::shared_ptr<ReadCacheStore> store_;
+    const uint32_t blockSize_;
+    const uint64_t clusterId_;
+    FileMetric* metric_;
+
+    std::atomic<uint64_t> fileId_;
+    std::atomic<uint64_t> version_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_READ_CACHE_H_
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-26
+ */
+
+#include "src/client/replica_selector.h"
+
+#include <algorithm>
+
+#include "src/common/timeutility.h"
+
+namespace curve {
+namespace client {
+
+using curve::common::ReadLockGuard;
+using curve::common::TimeUtility;
+using curve::common::WriteLockGuard;
+
+const uint64_t ReplicaSelector::kFailureLatencyUs;
+const uint64_t ReplicaSelector::kLatencyExpireUs;
+
+int ReplicaSelector::Select(
+    const std::vector<CopysetPeerInfo<ChunkServerID>>& peers) {
+    if (peers.empty()) {
+        return -1;
+    }
+
+    uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+    uint32_t start = next_.fetch_add(1, std::memory_order_relaxed);
+    int selected = -1;
+    uint64_t minCost = 0;
+    for (size_t i = 0; i < peers.size(); ++i) {
+        int index = (start + i) % peers.size();
+        uint64_t cost = Cost(GetPeerLoad(peers[index].peerID), nowUs);
+        if (selected < 0 || cost < minCost) {
+            selected = index;
+            minCost = cost;
+        }
+    }
+
+    return selected;
+}
+
+void ReplicaSelector::OnSend(ChunkServerID id) {
+    GetPeerLoad(id)->inflight.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ReplicaSelector::OnDone(ChunkServerID id, uint64_t latencyUs,
+                             bool failed) {
+    PeerLoad* load = GetPeerLoad(id);
+    uint64_t inflight = load->inflight.load(std::memory_order_relaxed);
+    while (inflight > 0 &&
+           !load->inflight.compare_exchange_weak(inflight, inflight - 1,
+                                                 std::memory_order_relaxed)) {
+    }
+
+    if (failed) {
+        latencyUs = std::max(latencyUs, kFailureLatencyUs);
+    }
+    latencyUs = std::max<uint64_t>(latencyUs, 1);
+
+    // 指数加权平均，失败时直接使用较大的延时，让后续请求尽快避开
+    uint64_t old = load->latencyUs.load(std::memory_order_relaxed);
+    uint64_t avg = (old == 0 || failed) ? latencyUs
+                                        : old - old / 8 + latencyUs / 8;
+    load->latencyUs.store(std::max<uint64_t>(avg, 1),
+                          std::memory_order_relaxed);
+    load->updateTimeUs.store(TimeUtility::GetTimeofDayUs(),
+                             std::memory_order_relaxed);
+}
+
+ReplicaSelector::PeerLoad* ReplicaSelector::GetPeerLoad(ChunkServerID id) {
+    {
+        ReadLockGuard lk(rwlock_);
+        auto it = loads_.find(id);
+        if (it != loads_.end()) {
+            return it->second.get();
+        }
+    }
+
+    WriteLockGuard lk(rwlock_);
+    std::unique_ptr<PeerLoad>& load = loads_[id];
+    if (load == nullptr) {
+        load.reset(new PeerLoad());
+    }
+    return load.get();
+}
+
+uint64_t ReplicaSelector::Cost(PeerLoad* load, uint64_t nowUs) const {
+    uint64_t latencyUs = load->latencyUs.load(std::memory_order_relaxed);
+    uint64_t updateTimeUs = load->updateTimeUs.load(std::memory_order_relaxed);
+    if (nowUs > updateTimeUs + kLatencyExpireUs) {
+        // 没有延时记录或者已经过期时按照inflight请求数选择
+        latencyUs = 1;
+    }
+
+    return latencyUs *
+           (load->inflight.load(std::memory_order_relaxed) + 1);
+}
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-26
+ */
+
+
+#ifndef SRC_CLIENT_REPLICA_SELECTOR_H_
+#define SRC_CLIENT_REPLICA_SELECTOR_H_
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "src/client/client_common.h"
+#include "src/client/metacache_struct.h"
+#include "src/common/concurrent/rw_lock.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * 读取不可变数据(快照、只读打开的克隆源文件)时，在copyset的所有副本中
+ * 选择负载最低的一个，避免读请求集中在leader上
+ *
+ * 每个chunkserver记录inflight请求数和平均延时，负载为两者的乘积。
+ * 一段时间没有请求的chunkserver延时记录会过期，重新参与选择，
+ * 避免一次失败后一直不被选中。
+ */
+class ReplicaSelector {
+ public:
+    ReplicaSelector() : next_(0) {}
+
+    /**
+     * @brief 选择负载最低的副本
+     * @return 选中副本在peers中的下标，peers为空时返回-1
+     */
+    int Select(const std::vector<CopysetPeerInfo<ChunkServerID>>& peers);
+
+    /**
+     * @brief 请求发送给chunkserver之前调用
+     */
+    void OnSend(ChunkServerID id);
+
+    /**
+     * @brief 请求返回时调用
+     * @param latencyUs 请求的延时
+     * @param failed 请求失败或者副本无法处理时为true，记录为较大的延时
+     */
+    void OnDone(ChunkServerID id, uint64_t latencyUs, bool failed);
+
+ private:
+    struct PeerLoad {
+        std::atomic<uint64_t> inflight{0};
+        // 平均延时，为0表示还没有记录
+        std::atomic<uint64_t> latencyUs{0};
+        std::atomic<uint64_t> updateTimeUs{0};
+    };
+
+    // 请求失败时记录的延时
+    static const uint64_t kFailureLatencyUs = 1000 * 1000;
+    // 延时记录的有效时间
+    static const uint64_t kLatencyExpireUs = 10 * 1000 * 1000;
+
+    PeerLoad* GetPeerLoad(ChunkServerID id);
+
+    uint64_t Cost(PeerLoad* load, uint64_t nowUs) const;
+
+ private:
+    curve::common::RWLock rwlock_;
+    std::unordered_map<ChunkServerID, std::unique_ptr<PeerLoad>> loads_;
+
+    // 负载相同时轮流选择
+    std::atomic<uint32_t> next_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_REPLICA_SELECTOR_H_
@@ -175,6 +175,82 @@ void PaddingReadClosure::GenAlignedRequest() {
     alignedCtx_->id_ = RequestContext::GetNextRequestContextId();
 }
 
+CoalescedRequestClosure::CoalescedRequestClosure(
+    const std::vector<RequestContext*>& requests)
+    : RequestClosure(requests.front()),
+      requests_(requests),
+      coalescedCtx_(nullptr) {
+    // rpc closures log the io id of the tracker and record the
+    // metric of the file, borrow them from the first request
+    SetIOTracker(reqCtx_->done_->GetIOTracker());
+    SetFileMetric(reqCtx_->done_->GetMetric());
+    // the coalesced rpc takes one inflight token for all the requests
+    SetIOManager(reqCtx_->done_->GetIOManager());
+    GenCoalescedRequest();
+}
+
+void CoalescedRequestClosure::Run() {
+    std::unique_ptr<CoalescedRequestClosure> selfGuard(this);
+    std::unique_ptr<RequestContext> ctxGuard(coalescedCtx_);
+
+    ReleaseInflightRPCToken();
+
+    if (IsSuspendRPC()) {
+        MetricHelper::DecremIOSuspendNum(GetMetric());
+    }
+
+    const int errCode = GetErrorCode();
+    for (auto req : requests_) {
+        brpc::ClosureGuard doneGuard(req->done_);
+        if (errCode != 0) {
+            req->done_->SetFailed(errCode);
+            continue;
+        }
+
+        if (req->optype_ == OpType::READ) {
+            // split read data to each request without copy
+            auto nc = coalescedCtx_->readData_.cutn(&req->readData_,
+                                                    req->rawlength_);
+            if (nc != req->rawlength_) {
+                LOG(ERROR) << "Split read data failed, cut bytes: " << nc
+                           << ", expected bytes: " << req->rawlength_
+                           << ", request context: " << *req;
+                req->done_->SetFailed(-1);
+                continue;
+            }
+        }
+        req->done_->SetFailed(0);
+    }
+}
+
+void CoalescedRequestClosure::GenCoalescedRequest() {
+    coalescedCtx_ = new RequestContext();
+
+    coalescedCtx_->optype_ = reqCtx_->optype_;
+    coalescedCtx_->padding.aligned = true;
+
+    coalescedCtx_->idinfo_ = reqCtx_->idinfo_;
+    coalescedCtx_->offset_ = reqCtx_->offset_;
+    coalescedCtx_->subIoIndex_ = reqCtx_->subIoIndex_;
+    coalescedCtx_->done_ = this;
+    coalescedCtx_->fileId_ = reqCtx_->fileId_;
+    coalescedCtx_->epoch_ = reqCtx_->epoch_;
+    coalescedCtx_->seq_ = reqCtx_->seq_;
+    coalescedCtx_->appliedindex_ = reqCtx_->appliedindex_;
+    coalescedCtx_->sourceInfo_ = reqCtx_->sourceInfo_;
+    coalescedCtx_->id_ = RequestContext::GetNextRequestContextId();
+
+    size_t length = 0;
+    for (auto req : requests_) {
+        length += req->rawlength_;
+        if (req->optype_ == OpType::WRITE) {
+            // only reference the data blocks
+            coalescedCtx_->writeData_.append(req->writeData_);
+        }
+    }
+    coalescedCtx_->rawlength_ = length;
+}
+
 void PaddingReadClosure::HandleError(int errCode) {
     brpc::ClosureGuard doneGuard(reqCtx_->done_);
     reqCtx_->done_->SetFailed(errCode);
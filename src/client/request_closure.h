@@ -26,6 +26,8 @@
 // for Closure
 #include <google/protobuf/stubs/callback.h>
 
+#include <vector>
+
 #include "include/curve_compiler_specific.h"
 #include "src/client/client_common.h"
 
@@ -98,6 +100,10 @@ class CURVE_CACHELINE_ALIGNMENT RequestClosure
         ioManager_ = ioManager;
     }
 
+    IOManager* GetIOManager() const {
+        return ioManager_;
+    }
+
     /**
      * @brief 设置当前closure重试次数
      */
@@ -148,6 +154,17 @@ class CURVE_CACHELINE_ALIGNMENT RequestClosure
         return suspendRPC_;
     }
 
+    /**
+     * 设置当前的rpc是否发送给了负载最低的副本而不是leader
+     */
+    void SetFollowerRead(bool followerRead) {
+        followerRead_ = followerRead;
+    }
+
+    bool IsFollowerRead() const {
+        return followerRead_;
+    }
+
  protected:
     // request context of this closure
     RequestContext* reqCtx_ = nullptr;
@@ -159,6 +176,9 @@ class CURVE_CACHELINE_ALIGNMENT RequestClosure
     // suspend io标志
     bool suspendRPC_ = false;
 
+    // 当前的rpc是否由follower处理
+    bool followerRead_ = false;
+
     // whether own inflight count
     bool ownInflight_ = false;
 
@@ -222,6 +242,38 @@ class PaddingReadClosure : public RequestClosure {
     RequestScheduler* scheduler_;
 };
 
+// CoalescedRequestClosure is used to process coalesced requests
+// it forms one request covering the adjacent requests of the same chunk,
+// and dispatches the result to each of them when the rpc returns
+class CoalescedRequestClosure : public RequestClosure {
+ public:
+    explicit CoalescedRequestClosure(
+        const std::vector<RequestContext*>& requests);
+
+    void Run() override;
+
+    RequestContext* GetReqCtx() override {
+        return coalescedCtx_;
+    }
+
+    RequestContext* CoalescedRequest() const {
+        return coalescedCtx_;
+    }
+
+ private:
+    /**
+     * @brief Generate the request covering all the coalesced requests
+     */
+    void GenCoalescedRequest();
+
+ private:
+    // coalesced requests, sorted by offset and adjacent to each other
+    std::vector<RequestContext*> requests_;
+
+    // request context covering all the coalesced requests
+    RequestContext* coalescedCtx_;
+};
+
 }  // namespace client
 }  // namespace curve
 
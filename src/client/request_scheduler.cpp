@@ -25,6 +25,10 @@
 #include <brpc/closure_guard.h>
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <vector>
+
 #include "src/client/request_context.h"
 #include "src/client/request_closure.h"
 #include "src/client/chunk_closure.h"
@@ -39,6 +43,7 @@ int RequestScheduler::Init(const RequestScheduleOption& reqSchdulerOpt,
                            FileMetric* fm) {
     blockIO_.store(false);
     reqschopt_ = reqSchdulerOpt;
+    fileMetric_ = fm;
 
     int rc = 0;
     rc = queue_.Init(reqschopt_.scheduleQueueCapacity);
@@ -61,7 +66,11 @@ int RequestScheduler::Init(const RequestScheduleOption& reqSchdulerOpt,
               << "scheduleQueueCapacity = "
               << reqschopt_.scheduleQueueCapacity
               << ", scheduleThreadpoolSize = "
-              << reqschopt_.scheduleThreadpoolSize;
+              << reqschopt_.scheduleThreadpoolSize
+              << ", coalesce enable = " << reqschopt_.coalesceOpt.enable
+              << ", coalesce maxBytes = " << reqschopt_.coalesceOpt.maxBytes
+              << ", coalesce maxDelayUs = "
+              << reqschopt_.coalesceOpt.maxDelayUs;
     return 0;
 }
 
@@ -141,6 +150,7 @@ void RequestScheduler::WakeupBlockQueueAtExit() {
 }
 
 void RequestScheduler::Process() {
+    bool sequential = false;
     while ((running_.load(std::memory_order_acquire) ||
             !queue_.Empty())  // flush all request in the queue
            && !stop_.load(std::memory_order_acquire)) {
@@ -148,7 +158,9 @@ void RequestScheduler::Process() {
         BBQItem<RequestContext*> item = queue_.TakeFront();
         if (!item.IsStop()) {
             RequestContext* req = item.Item();
-            if (req->padding.aligned) {
+            if (req->padding.aligned && reqschopt_.coalesceOpt.enable) {
+                ProcessCoalesced(req, &sequential);
+            } else if (req->padding.aligned) {
                 ProcessAligned(req);
             } else {
                 ProcessUnaligned(req);
@@ -207,6 +219,74 @@ void RequestScheduler::ProcessAligned(RequestContext* ctx) {
     }
 }
 
+bool RequestScheduler::Coalescable(const RequestContext* prev,
+                                   const RequestContext* next) {
+    // requests reading from clone source are handled by chunkserver
+    // with the source location, keep them as they are
+    return next->padding.aligned &&
+           next->optype_ == prev->optype_ &&
+           next->idinfo_.lpid_ == prev->idinfo_.lpid_ &&
+           next->idinfo_.cpid_ == prev->idinfo_.cpid_ &&
+           next->idinfo_.cid_ == prev->idinfo_.cid_ &&
+           next->seq_ == prev->seq_ &&
+           next->appliedindex_ == prev->appliedindex_ &&
+           (next->optype_ == OpType::READ ||
+            (next->fileId_ == prev->fileId_ &&
+             next->epoch_ == prev->epoch_)) &&
+           !prev->sourceInfo_.IsValid() &&
+           !next->sourceInfo_.IsValid() &&
+           static_cast<uint64_t>(next->offset_) ==
+               prev->offset_ + prev->rawlength_;
+}
+
+void RequestScheduler::ProcessCoalesced(RequestContext* ctx,
+                                        bool* sequential) {
+    if ((ctx->optype_ != OpType::READ && ctx->optype_ != OpType::WRITE) ||
+        ctx->sourceInfo_.IsValid()) {
+        ProcessAligned(ctx);
+        return;
+    }
+
+    const RequestCoalesceOption& opt = reqschopt_.coalesceOpt;
+    std::vector<RequestContext*> requests(1, ctx);
+    uint64_t bytes = ctx->rawlength_;
+
+    auto adjacent = [&](BBQItem<RequestContext*>& item) {
+        return !item.IsStop() &&
+               Coalescable(requests.back(), item.Item()) &&
+               bytes + item.Item()->rawlength_ <= opt.maxBytes;
+    };
+
+    // only wait for the following requests if the thread is serving
+    // sequential requests, the total wait is bounded by maxDelayUs
+    auto deadline = std::chrono::steady_clock::now() +
+        std::chrono::microseconds(*sequential ? opt.maxDelayUs : 0);
+    BBQItem<RequestContext*> next(nullptr);
+    while (bytes < opt.maxBytes) {
+        auto timeout = std::max(deadline - std::chrono::steady_clock::now(),
+            std::chrono::steady_clock::duration::zero());
+        if (!queue_.TakeFrontIf(adjacent, timeout, &next)) {
+            break;
+        }
+        requests.push_back(next.Item());
+        bytes += next.Item()->rawlength_;
+    }
+
+    *sequential = requests.size() > 1;
+    if (requests.size() == 1) {
+        ProcessAligned(ctx);
+        return;
+    }
+
+    // the coalesced rpc takes a single inflight token, taking one for each
+    // request could leave a batch holding some tokens while waiting for
+    // the rest, and deadlock with other batches doing the same
+    MetricHelper::IncremCoalescedRPC(fileMetric_, requests.size());
+
+    CoalescedRequestClosure* done = new CoalescedRequestClosure(requests);
+    ProcessAligned(done->CoalescedRequest());
+}
+
 void RequestScheduler::ProcessUnaligned(RequestContext* ctx) {
     brpc::ClosureGuard doneGuard(ctx->done_);
     if (ctx->optype_ != OpType::READ && ctx->optype_ != OpType::WRITE) {
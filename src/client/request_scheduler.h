@@ -52,7 +52,8 @@ class RequestScheduler : public Uncopyable {
         : running_(false),
           stop_(true),
           client_(),
-          blockingQueue_(true) {}
+          blockingQueue_(true),
+          fileMetric_(nullptr) {}
     virtual ~RequestScheduler();
 
     /**
@@ -142,6 +143,23 @@ class RequestScheduler : public Uncopyable {
 
     void ProcessUnaligned(RequestContext* ctx);
 
+    /**
+     * Take the queued requests adjacent to ctx and send them with ctx
+     * in one rpc
+     * @param ctx: the request taken from the queue
+     * @param sequential: whether the last requests of the thread were
+     *                    coalesced, the thread waits for the following
+     *                    requests only if it's true, and it's updated
+     *                    by whether ctx is coalesced
+     */
+    void ProcessCoalesced(RequestContext* ctx, bool* sequential);
+
+    /**
+     * Whether next could be sent in one rpc following prev
+     */
+    static bool Coalescable(const RequestContext* prev,
+                            const RequestContext* next);
+
     void WaitValidSession() {
         // lease续约失败的时候需要阻塞IO直到续约成功
         if (blockIO_.load(std::memory_order_acquire) && blockingQueue_) {
@@ -176,6 +194,8 @@ class RequestScheduler : public Uncopyable {
     std::condition_variable leaseRefreshcv_;
     // 阻塞队列
     bool blockingQueue_;
+    // metric of the file, for counting coalesced rpcs
+    FileMetric* fileMetric_;
 };
 
 }   // namespace client
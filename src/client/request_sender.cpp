@@ -79,7 +79,8 @@ int RequestSender::ReadChunk(const ChunkIDInfo& idinfo,
                              size_t length,
                              uint64_t appliedindex,
                              const RequestSourceInfo& sourceInfo,
-                             ClientClosure *done) {
+                             ClientClosure *done,
+                             bool followerRead) {
     brpc::ClosureGuard doneGuard(done);
     brpc::Controller *cntl = new brpc::Controller();
     ChunkResponse *response = new ChunkResponse();
@@ -104,6 +105,12 @@ int RequestSender::ReadChunk(const ChunkIDInfo& idinfo,
         request.set_appliedindex(appliedindex);
     }
 
+    // follower需要根据appliedindex判断自己的数据是否足够新
+    if (followerRead && appliedindex > 0) {
+        request.set_appliedindex(appliedindex);
+        request.set_followerread(true);
+    }
+
     ChunkService_Stub stub(&channel_);
     stub.ReadChunk(cntl, &request, response, doneGuard.release());
 
@@ -158,7 +165,9 @@ int RequestSender::ReadChunkSnapshot(const ChunkIDInfo& idinfo,
                                      uint64_t sn,
                                      off_t offset,
                                      size_t length,
-                                     ClientClosure *done) {
+                                     ClientClosure *done,
+                                     uint64_t appliedindex,
+                                     bool followerRead) {
     brpc::ClosureGuard doneGuard(done);
     brpc::Controller *cntl = new brpc::Controller();
     ChunkResponse *response = new ChunkResponse();
@@ -174,6 +183,10 @@ int RequestSender::ReadChunkSnapshot(const ChunkIDInfo& idinfo,
     request.set_sn(sn);
     request.set_offset(offset);
     request.set_size(length);
+    if (followerRead && appliedindex > 0) {
+        request.set_appliedindex(appliedindex);
+        request.set_followerread(true);
+    }
     ChunkService_Stub stub(&channel_);
     stub.ReadChunkSnapshot(cntl, &request, response, doneGuard.release());
 
@@ -62,6 +62,7 @@ class RequestSender {
      * @param appliedindex:需要读到>=appliedIndex的数据
      * @param sourceInfo 数据源信息
      * @param done:上一层异步回调的closure
+     * @param followerRead:读取的是不可变的数据，允许follower处理
      */
     int ReadChunk(const ChunkIDInfo& idinfo,
                   uint64_t sn,
@@ -69,7 +70,8 @@ class RequestSender {
                   size_t length,
                   uint64_t appliedindex,
                   const RequestSourceInfo& sourceInfo,
-                  ClientClosure *done);
+                  ClientClosure *done,
+                  bool followerRead = false);
 
     /**
    * 写Chunk
@@ -100,12 +102,16 @@ class RequestSender {
      * @param offset:读的偏移
      * @param length:读的长度
      * @param done:上一层异步回调的closure
+     * @param appliedindex:follower处理时需要读到>=appliedIndex的数据
+     * @param followerRead:是否允许follower处理
      */
     int ReadChunkSnapshot(const ChunkIDInfo& idinfo,
                           uint64_t sn,
                           off_t offset,
                           size_t length,
-                          ClientClosure *done);
+                          ClientClosure *done,
+                          uint64_t appliedindex = 0,
+                          bool followerRead = false);
 
     /**
      * 删除此次转储时产生的或者历史遗留的快照
@@ -0,0 +1,238 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-23
+ */
+
+#include "src/client/segment_table.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace curve {
+namespace client {
+
+namespace {
+
+const uint64_t kChunkExist = 1;
+const uint64_t kChunkCached = 2;
+
+}  // namespace
+
+const uint32_t SegmentTable::kDefaultChunksPerSegment;
+const uint32_t SegmentTable::kWordsPerChunk;
+
+SegmentTable::Page::Page(SegmentIndex segmentIndex, uint32_t segmentSize,
+                         uint32_t discardGranularity, uint32_t chunks)
+    : segment(segmentIndex, segmentSize, discardGranularity),
+      seq(0),
+      words(new std::atomic<uint64_t>[chunks * kWordsPerChunk]) {
+    for (uint32_t i = 0; i < chunks * kWordsPerChunk; ++i) {
+        words[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+SegmentTable::Directory::Directory(size_t n)
+    : size(n), pages(new std::atomic<Page*>[n]) {
+    for (size_t i = 0; i < n; ++i) {
+        pages[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SegmentTable::SegmentTable()
+    : directory_(new Directory(0)),
+      chunksPerSegment_(kDefaultChunksPerSegment),
+      // 未设置文件布局时segment大小为0，discard bitmap为空
+      segmentSize_(0),
+      discardGranularity_(1),
+      memoryBytes_(sizeof(SegmentTable) + sizeof(Directory)) {}
+
+SegmentTable::~SegmentTable() {
+    delete directory_.load(std::memory_order_relaxed);
+}
+
+void SegmentTable::Init(uint64_t fileLength, uint64_t segmentSize,
+                        uint64_t chunkSize, uint32_t discardGranularity) {
+    if (segmentSize == 0 || chunkSize == 0 || segmentSize % chunkSize != 0 ||
+        discardGranularity == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    uint32_t chunksPerSegment = segmentSize / chunkSize;
+    if (chunksPerSegment == ChunksPerSegment() &&
+        segmentSize == segmentSize_ &&
+        discardGranularity == discardGranularity_) {
+        return;
+    }
+
+    if (!pages_.empty()) {
+        LOG(WARNING) << "Segment table is in use, ignore new layout"
+                     << ", segment size = " << segmentSize
+                     << ", chunk size = " << chunkSize;
+        return;
+    }
+
+    chunksPerSegment_.store(chunksPerSegment, std::memory_order_relaxed);
+    segmentSize_ = segmentSize;
+    discardGranularity_ = discardGranularity;
+
+    size_t segments = (fileLength + segmentSize - 1) / segmentSize;
+    Directory* old = directory_.load(std::memory_order_relaxed);
+    if (segments > old->size) {
+        directory_.store(new Directory(segments), std::memory_order_release);
+        retired_.emplace_back(old);
+        memoryBytes_.fetch_add(segments * sizeof(std::atomic<Page*>),
+                               std::memory_order_relaxed);
+    }
+}
+
+bool SegmentTable::GetChunkInfo(ChunkIndex chunkIndex,
+                                ChunkIDInfo* info) const {
+    uint32_t chunksPerSegment = ChunksPerSegment();
+    const Page* page = FindPage(chunkIndex / chunksPerSegment);
+    if (page == nullptr) {
+        return false;
+    }
+
+    const std::atomic<uint64_t>* words =
+        &page->words[(chunkIndex % chunksPerSegment) * kWordsPerChunk];
+    uint64_t cid, ids, flags, seq;
+    do {
+        seq = page->seq.load(std::memory_order_acquire);
+        if (seq & 1) {
+            continue;
+        }
+        cid = words[0].load(std::memory_order_relaxed);
+        ids = words[1].load(std::memory_order_relaxed);
+        flags = words[2].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) || seq != page->seq.load(std::memory_order_relaxed));
+
+    if (!(flags & kChunkCached)) {
+        return false;
+    }
+
+    info->cid_ = cid;
+    info->cpid_ = static_cast<CopysetID>(ids);
+    info->lpid_ = static_cast<LogicPoolID>(ids >> 32);
+    info->chunkExist = flags & kChunkExist;
+    return true;
+}
+
+void SegmentTable::UpdateChunkInfo(ChunkIndex chunkIndex,
+                                   const ChunkIDInfo& info) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    uint32_t chunksPerSegment = ChunksPerSegment();
+    Page* page = GetOrAllocatePage(chunkIndex / chunksPerSegment);
+
+    std::atomic<uint64_t>* words =
+        &page->words[(chunkIndex % chunksPerSegment) * kWordsPerChunk];
+    uint64_t seq = page->seq.load(std::memory_order_relaxed);
+    page->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    words[0].store(info.cid_, std::memory_order_relaxed);
+    words[1].store(static_cast<uint64_t>(info.lpid_) << 32 | info.cpid_,
+                   std::memory_order_relaxed);
+    words[2].store(kChunkCached | (info.chunkExist ? kChunkExist : 0),
+                   std::memory_order_relaxed);
+    page->seq.store(seq + 2, std::memory_order_release);
+}
+
+void SegmentTable::CleanChunks(ChunkIndex begin, ChunkIndex end) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    uint32_t chunksPerSegment = ChunksPerSegment();
+    ChunkIndex index = begin;
+    while (index < end) {
+        // 当前页内需要清除的范围
+        ChunkIndex pageEnd = std::min<ChunkIndex>(
+            end, (index / chunksPerSegment + 1) * chunksPerSegment);
+        Page* page = FindPage(index / chunksPerSegment);
+        if (page != nullptr) {
+            uint32_t from = (index % chunksPerSegment) * kWordsPerChunk;
+            uint32_t to = from + (pageEnd - index) * kWordsPerChunk;
+            uint64_t seq = page->seq.load(std::memory_order_relaxed);
+            page->seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (uint32_t i = from; i < to; ++i) {
+                page->words[i].store(0, std::memory_order_relaxed);
+            }
+            page->seq.store(seq + 2, std::memory_order_release);
+        }
+        index = pageEnd;
+    }
+}
+
+FileSegment* SegmentTable::GetFileSegment(SegmentIndex segmentIndex) {
+    Page* page = FindPage(segmentIndex);
+    if (page != nullptr) {
+        return &page->segment;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    return &GetOrAllocatePage(segmentIndex)->segment;
+}
+
+SegmentTable::Page* SegmentTable::FindPage(SegmentIndex segmentIndex) const {
+    const Directory* directory = directory_.load(std::memory_order_acquire);
+    if (segmentIndex >= directory->size) {
+        return nullptr;
+    }
+    return directory->pages[segmentIndex].load(std::memory_order_acquire);
+}
+
+SegmentTable::Page* SegmentTable::GetOrAllocatePage(
+    SegmentIndex segmentIndex) {
+    Directory* directory = directory_.load(std::memory_order_relaxed);
+    if (segmentIndex >= directory->size) {
+        size_t size = std::max<size_t>(directory->size * 2, segmentIndex + 1);
+        Directory* grown = new Directory(size);
+        for (size_t i = 0; i < directory->size; ++i) {
+            grown->pages[i].store(
+                directory->pages[i].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+        }
+        directory_.store(grown, std::memory_order_release);
+        retired_.emplace_back(directory);
+        memoryBytes_.fetch_add(size * sizeof(std::atomic<Page*>),
+                               std::memory_order_relaxed);
+        directory = grown;
+    }
+
+    Page* page = directory->pages[segmentIndex].load(std::memory_order_relaxed);
+    if (page != nullptr) {
+        return page;
+    }
+
+    page = new Page(segmentIndex, segmentSize_, discardGranularity_,
+                    ChunksPerSegment());
+    pages_.emplace_back(page);
+    memoryBytes_.fetch_add(PageBytes(), std::memory_order_relaxed);
+    directory->pages[segmentIndex].store(page, std::memory_order_release);
+    return page;
+}
+
+uint64_t SegmentTable::PageBytes() const {
+    return sizeof(Page) +
+           ChunksPerSegment() * kWordsPerChunk * sizeof(std::atomic<uint64_t>) +
+           segmentSize_ / discardGranularity_ / 8;
+}
+
+}  // namespace client
+}  // namespace curve
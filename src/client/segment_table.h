@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-23
+ */
+
+#ifndef SRC_CLIENT_SEGMENT_TABLE_H_
+#define SRC_CLIENT_SEGMENT_TABLE_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "src/client/client_common.h"
+#include "src/client/metacache_struct.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * 文件的chunk索引表，按segment分页
+ *
+ * 每个segment对应一页，页中保存segment的FileSegment以及segment内
+ * 所有chunk的ChunkIDInfo，按chunk index直接寻址。页在第一次访问时分配，
+ * 未访问过的segment只占用页目录中的一个指针。
+ *
+ * 读chunk信息和获取FileSegment不加锁：页目录扩容时旧目录保留到析构，
+ * 页内的chunk信息由页的序列号保护(seqlock)。更新操作之间由互斥锁串行。
+ */
+class SegmentTable {
+ public:
+    // 未设置文件信息时(例如快照client)每页的chunk数
+    static const uint32_t kDefaultChunksPerSegment = 64;
+
+    SegmentTable();
+    ~SegmentTable();
+
+    SegmentTable(const SegmentTable&) = delete;
+    SegmentTable& operator=(const SegmentTable&) = delete;
+
+    /**
+     * @brief 设置文件的布局，只在分配第一页之前生效
+     * @param fileLength 文件长度，用于预分配页目录
+     */
+    void Init(uint64_t fileLength, uint64_t segmentSize, uint64_t chunkSize,
+              uint32_t discardGranularity);
+
+    /**
+     * @brief 获取chunk信息，无锁
+     * @return chunk信息存在返回true
+     */
+    bool GetChunkInfo(ChunkIndex chunkIndex, ChunkIDInfo* info) const;
+
+    void UpdateChunkInfo(ChunkIndex chunkIndex, const ChunkIDInfo& info);
+
+    /**
+     * @brief 清除[begin, end)范围内的chunk信息
+     */
+    void CleanChunks(ChunkIndex begin, ChunkIndex end);
+
+    /**
+     * @brief 获取segment的FileSegment，不存在时分配
+     */
+    FileSegment* GetFileSegment(SegmentIndex segmentIndex);
+
+    /**
+     * @brief 页目录和已分配页占用的内存
+     */
+    uint64_t MemoryUsage() const {
+        return memoryBytes_.load(std::memory_order_relaxed);
+    }
+
+    uint32_t ChunksPerSegment() const {
+        return chunksPerSegment_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    // 每个chunk信息占用的字数
+    static const uint32_t kWordsPerChunk = 3;
+
+    struct Page {
+        Page(SegmentIndex segmentIndex, uint32_t segmentSize,
+             uint32_t discardGranularity, uint32_t chunks);
+
+        FileSegment segment;
+        // 奇数表示正在更新页内的chunk信息
+        std::atomic<uint64_t> seq;
+        std::unique_ptr<std::atomic<uint64_t>[]> words;
+    };
+
+    struct Directory {
+        explicit Directory(size_t n);
+
+        const size_t size;
+        std::unique_ptr<std::atomic<Page*>[]> pages;
+    };
+
+    Page* FindPage(SegmentIndex segmentIndex) const;
+
+    // 调用者需持有mtx_
+    Page* GetOrAllocatePage(SegmentIndex segmentIndex);
+
+    uint64_t PageBytes() const;
+
+ private:
+    std::atomic<Directory*> directory_;
+    // 扩容后的旧目录，析构时释放
+    std::vector<std::unique_ptr<Directory>> retired_;
+    // 已分配的页，析构时释放
+    std::vector<std::unique_ptr<Page>> pages_;
+
+    std::atomic<uint32_t> chunksPerSegment_;
+    uint32_t segmentSize_;
+    uint32_t discardGranularity_;
+
+    std::atomic<uint64_t> memoryBytes_;
+
+    // 保护更新操作
+    std::mutex mtx_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_SEGMENT_TABLE_H_
@@ -0,0 +1,309 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-29
+ */
+
+#include "src/common/compression.h"
+
+#include <butil/third_party/snappy/snappy.h>
+#include <glog/logging.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace curve {
+namespace common {
+
+namespace {
+
+const char kMagic[] = "CURVECZ1";
+const uint32_t kMagicSize = 8;
+
+void PutUint32(char* buf, uint32_t value) {
+    for (int i = 3; i >= 0; --i) {
+        buf[i] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+void PutUint64(char* buf, uint64_t value) {
+    for (int i = 7; i >= 0; --i) {
+        buf[i] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+uint32_t GetUint32(const char* buf) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value = (value << 8) | static_cast<unsigned char>(buf[i]);
+    }
+    return value;
+}
+
+uint64_t GetUint64(const char* buf) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | static_cast<unsigned char>(buf[i]);
+    }
+    return value;
+}
+
+}  // namespace
+
+bool StringToCompressType(const std::string& str, CompressType* type) {
+    if (str == "none") {
+        *type = CompressType::kNone;
+    } else if (str == "snappy") {
+        *type = CompressType::kSnappy;
+    } else if (str == "zlib") {
+        *type = CompressType::kZlib;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string CompressTypeToString(CompressType type) {
+    switch (type) {
+        case CompressType::kNone:
+            return "none";
+        case CompressType::kSnappy:
+            return "snappy";
+        case CompressType::kZlib:
+            return "zlib";
+        default:
+            return "unknown";
+    }
+}
+
+bool Compress(CompressType type, const char* in, size_t len,
+              std::string* out) {
+    switch (type) {
+        case CompressType::kSnappy:
+            butil::snappy::Compress(in, len, out);
+            return true;
+        case CompressType::kZlib: {
+            uLongf outLen = compressBound(len);
+            out->resize(outLen);
+            int ret = compress2(reinterpret_cast<Bytef*>(&(*out)[0]), &outLen,
+                                reinterpret_cast<const Bytef*>(in), len,
+                                Z_DEFAULT_COMPRESSION);
+            if (ret != Z_OK) {
+                LOG(ERROR) << "zlib compress failed, ret = " << ret;
+                return false;
+            }
+            out->resize(outLen);
+            return true;
+        }
+        default:
+            LOG(ERROR) << "Unsupported compress type "
+                       << static_cast<uint32_t>(type);
+            return false;
+    }
+}
+
+bool Decompress(CompressType type, const char* in, size_t len, char* out,
+                size_t outLen) {
+    switch (type) {
+        case CompressType::kSnappy: {
+            size_t rawLen = 0;
+            if (!butil::snappy::GetUncompressedLength(in, len, &rawLen) ||
+                rawLen != outLen) {
+                LOG(ERROR) << "snappy data corrupted, expected length = "
+                           << outLen;
+                return false;
+            }
+            return butil::snappy::RawUncompress(in, len, out);
+        }
+        case CompressType::kZlib: {
+            uLongf rawLen = outLen;
+            int ret = uncompress(reinterpret_cast<Bytef*>(out), &rawLen,
+                                 reinterpret_cast<const Bytef*>(in), len);
+            if (ret != Z_OK || rawLen != outLen) {
+                LOG(ERROR) << "zlib uncompress failed, ret = " << ret
+                           << ", length = " << rawLen
+                           << ", expected length = " << outLen;
+                return false;
+            }
+            return true;
+        }
+        default:
+            LOG(ERROR) << "Unsupported compress type "
+                       << static_cast<uint32_t>(type);
+            return false;
+    }
+}
+
+const uint32_t CompressedObject::kFixedHeaderSize;
+
+CompressedObject::CompressedObject()
+    : type_(CompressType::kNone),
+      frameSize_(0),
+      rawLength_(0),
+      frameCount_(0) {}
+
+bool CompressedObject::Encode(CompressType type, uint32_t frameSize,
+                              const char* data, uint64_t len,
+                              std::string* out) {
+    if (type == CompressType::kNone || frameSize == 0) {
+        return false;
+    }
+
+    uint32_t frameCount = (len + frameSize - 1) / frameSize;
+    std::vector<std::string> frames(frameCount);
+    uint64_t dataSize = 0;
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        uint64_t offset = static_cast<uint64_t>(i) * frameSize;
+        uint64_t frameLen = std::min<uint64_t>(frameSize, len - offset);
+        if (!Compress(type, data + offset, frameLen, &frames[i])) {
+            return false;
+        }
+        dataSize += frames[i].size();
+    }
+
+    uint64_t headerSize =
+        kFixedHeaderSize + static_cast<uint64_t>(frameCount) * sizeof(uint64_t);
+    out->clear();
+    out->resize(headerSize);
+    char* header = &(*out)[0];
+    memcpy(header, kMagic, kMagicSize);
+    PutUint32(header + 8, static_cast<uint32_t>(type));
+    PutUint32(header + 12, frameSize);
+    PutUint64(header + 16, len);
+    PutUint32(header + 24, frameCount);
+    PutUint32(header + 28, 0);
+
+    uint64_t end = 0;
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        end += frames[i].size();
+        PutUint64(header + kFixedHeaderSize + i * sizeof(uint64_t), end);
+    }
+
+    out->reserve(headerSize + dataSize);
+    for (auto& frame : frames) {
+        out->append(frame);
+    }
+    return true;
+}
+
+bool CompressedObject::ParseFixedHeader(const char* buf, size_t len) {
+    if (len < kFixedHeaderSize || memcmp(buf, kMagic, kMagicSize) != 0) {
+        LOG(ERROR) << "Invalid compressed object header";
+        return false;
+    }
+
+    type_ = static_cast<CompressType>(GetUint32(buf + 8));
+    frameSize_ = GetUint32(buf + 12);
+    rawLength_ = GetUint64(buf + 16);
+    frameCount_ = GetUint32(buf + 24);
+    if ((type_ != CompressType::kSnappy && type_ != CompressType::kZlib) ||
+        frameSize_ == 0 ||
+        frameCount_ != (rawLength_ + frameSize_ - 1) / frameSize_) {
+        LOG(ERROR) << "Invalid compressed object header"
+                   << ", type = " << static_cast<uint32_t>(type_)
+                   << ", frame size = " << frameSize_
+                   << ", raw length = " << rawLength_
+                   << ", frame count = " << frameCount_;
+        return false;
+    }
+    return true;
+}
+
+bool CompressedObject::ParseFrameTable(const char* buf, size_t len) {
+    if (len < FrameTableSize()) {
+        LOG(ERROR) << "Compressed object frame table is truncated"
+                   << ", length = " << len
+                   << ", expected = " << FrameTableSize();
+        return false;
+    }
+
+    frameEnds_.resize(frameCount_);
+    uint64_t prev = 0;
+    for (uint32_t i = 0; i < frameCount_; ++i) {
+        frameEnds_[i] = GetUint64(buf + i * sizeof(uint64_t));
+        if (frameEnds_[i] < prev) {
+            LOG(ERROR) << "Invalid compressed object frame table";
+            return false;
+        }
+        prev = frameEnds_[i];
+    }
+    return true;
+}
+
+bool CompressedObject::GetFrameRange(uint64_t offset, uint64_t len,
+                                     uint64_t* objOffset,
+                                     uint64_t* objLen) const {
+    if (len == 0 || offset + len > rawLength_ ||
+        frameEnds_.size() != frameCount_) {
+        return false;
+    }
+
+    uint32_t first = offset / frameSize_;
+    uint32_t last = (offset + len - 1) / frameSize_;
+    *objOffset = HeaderSize() + FrameBegin(first);
+    *objLen = frameEnds_[last] - FrameBegin(first);
+    return true;
+}
+
+bool CompressedObject::DecodeRange(const char* frames, uint64_t framesLen,
+                                   uint64_t offset, uint64_t len,
+                                   char* out) const {
+    uint64_t objOffset = 0;
+    uint64_t objLen = 0;
+    if (!GetFrameRange(offset, len, &objOffset, &objLen) ||
+        framesLen < objLen) {
+        return false;
+    }
+
+    uint32_t first = offset / frameSize_;
+    uint32_t last = (offset + len - 1) / frameSize_;
+    uint64_t base = FrameBegin(first);
+    std::string partial;
+    for (uint32_t i = first; i <= last; ++i) {
+        const char* frame = frames + FrameBegin(i) - base;
+        uint64_t frameLen = frameEnds_[i] - FrameBegin(i);
+        uint64_t rawBegin = static_cast<uint64_t>(i) * frameSize_;
+        uint64_t rawLen = std::min<uint64_t>(frameSize_,
+                                             rawLength_ - rawBegin);
+        // 需要的数据在当前帧中的范围
+        uint64_t from = std::max(offset, rawBegin);
+        uint64_t to = std::min(offset + len, rawBegin + rawLen);
+
+        if (from == rawBegin && to == rawBegin + rawLen) {
+            // 整帧直接解压到输出
+            if (!Decompress(type_, frame, frameLen, out + (from - offset),
+                            rawLen)) {
+                return false;
+            }
+        } else {
+            partial.resize(rawLen);
+            if (!Decompress(type_, frame, frameLen, &partial[0], rawLen)) {
+                return false;
+            }
+            memcpy(out + (from - offset), partial.data() + (from - rawBegin),
+                   to - from);
+        }
+    }
+    return true;
+}
+
+}  // namespace common
+}  // namespace curve
@@ -0,0 +1,167 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-29
+ */
+
+#ifndef SRC_COMMON_COMPRESSION_H_
+#define SRC_COMMON_COMPRESSION_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace curve {
+namespace common {
+
+// 压缩算法，数值会持久化，只能追加
+enum class CompressType : uint32_t {
+    kNone = 0,
+    // 压缩和解压速度快，压缩率较低
+    kSnappy = 1,
+    // 压缩率高，压缩速度较慢
+    kZlib = 2,
+};
+
+/**
+ * @brief 解析压缩算法名称，可选值为none、snappy、zlib
+ * @return 名称合法返回true
+ */
+bool StringToCompressType(const std::string& str, CompressType* type);
+
+std::string CompressTypeToString(CompressType type);
+
+/**
+ * @brief 压缩数据
+ * @param type 压缩算法，不能为kNone
+ * @param in 原始数据
+ * @param len 原始数据长度
+ * @param[out] out 压缩后的数据
+ * @return 成功返回true
+ */
+bool Compress(CompressType type, const char* in, size_t len, std::string* out);
+
+/**
+ * @brief 解压数据，解压后的长度必须为outLen
+ * @return 成功返回true
+ */
+bool Decompress(CompressType type, const char* in, size_t len, char* out,
+                size_t outLen);
+
+/**
+ * 分帧压缩的对象
+ *
+ * 原始数据按frameSize切分后分别压缩，对象格式如下：
+ *
+ * | 固定头部(32字节) | 帧索引(每帧8字节) | 帧1 | 帧2 | ... |
+ *
+ * 固定头部依次为magic(8字节)、压缩算法(4字节)、帧大小(4字节)、
+ * 原始数据长度(8字节)、帧数量(4字节)和保留字段(4字节)，
+ * 帧索引为每一帧的结束位置相对第一帧起始位置的偏移，整数均为大端序。
+ *
+ * 每一帧可以单独解压，读取原始数据的一部分时只需要读取对应的帧，
+ * 因此对象可以按范围读取。
+ */
+class CompressedObject {
+ public:
+    static const uint32_t kFixedHeaderSize = 32;
+
+    CompressedObject();
+
+    /**
+     * @brief 分帧压缩数据生成对象
+     * @param type 压缩算法
+     * @param frameSize 帧大小
+     * @param data 原始数据
+     * @param len 原始数据长度
+     * @param[out] out 对象数据
+     * @return 成功返回true
+     */
+    static bool Encode(CompressType type, uint32_t frameSize,
+                       const char* data, uint64_t len, std::string* out);
+
+    /**
+     * @brief 解析对象开头的固定头部
+     * @param buf 对象开头的kFixedHeaderSize字节
+     * @return 格式合法返回true
+     */
+    bool ParseFixedHeader(const char* buf, size_t len);
+
+    /**
+     * @brief 解析固定头部之后的帧索引
+     * @param buf 对象中[kFixedHeaderSize, HeaderSize())范围的数据
+     * @return 格式合法返回true
+     */
+    bool ParseFrameTable(const char* buf, size_t len);
+
+    // 帧索引的长度，解析固定头部之后可用
+    uint64_t FrameTableSize() const {
+        return static_cast<uint64_t>(frameCount_) * sizeof(uint64_t);
+    }
+
+    // 固定头部和帧索引的总长度
+    uint64_t HeaderSize() const {
+        return kFixedHeaderSize + FrameTableSize();
+    }
+
+    /**
+     * @brief 计算原始数据[offset, offset + len)所在的帧在对象中的范围
+     * @param[out] objOffset 帧在对象中的起始位置
+     * @param[out] objLen 帧的总长度
+     * @return 范围合法返回true
+     */
+    bool GetFrameRange(uint64_t offset, uint64_t len, uint64_t* objOffset,
+                       uint64_t* objLen) const;
+
+    /**
+     * @brief 解压原始数据[offset, offset + len)
+     * @param frames GetFrameRange返回的范围内的对象数据
+     * @param framesLen frames的长度
+     * @param[out] out 原始数据
+     * @return 成功返回true
+     */
+    bool DecodeRange(const char* frames, uint64_t framesLen, uint64_t offset,
+                     uint64_t len, char* out) const;
+
+    CompressType GetCompressType() const {
+        return type_;
+    }
+
+    uint64_t GetRawLength() const {
+        return rawLength_;
+    }
+
+ private:
+    // 第index帧在数据区中的起始位置
+    uint64_t FrameBegin(uint32_t index) const {
+        return index == 0 ? 0 : frameEnds_[index - 1];
+    }
+
+ private:
+    CompressType type_;
+    uint32_t frameSize_;
+    uint64_t rawLength_;
+    uint32_t frameCount_;
+    // 每一帧的结束位置，相对于数据区起始位置
+    std::vector<uint64_t> frameEnds_;
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_COMPRESSION_H_
@@ -0,0 +1,235 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-22
+ */
+
+#ifndef SRC_COMMON_CONCURRENT_APPEND_ONLY_HASH_MAP_H_
+#define SRC_COMMON_CONCURRENT_APPEND_ONLY_HASH_MAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+namespace curve {
+namespace common {
+
+/**
+ * Hash map whose entries are never erased, with lock-free lookups.
+ *
+ * Values are allocated once and keep their address until the map is
+ * destroyed, so a pointer returned by Find() stays valid and the value
+ * itself decides how it is synchronized (atomics, SeqLockValue, ...).
+ * Insertions are serialized by a mutex and publish new nodes with release
+ * stores. When the table grows, the chains are rebuilt in a new bucket
+ * array and the old one is kept until destruction, so readers still
+ * walking it are safe; the retired arrays are bounded by the size of the
+ * current one.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class AppendOnlyHashMap {
+ public:
+    explicit AppendOnlyHashMap(size_t buckets = 16)
+        : table_(new Table(RoundUpPowerOf2(buckets))), size_(0) {}
+
+    ~AppendOnlyHashMap() {
+        Table* current = table_.load(std::memory_order_relaxed);
+        current->ForEachNode([](Node* node) { delete node->entry; });
+        delete current;
+        for (auto* table : retired_) {
+            delete table;
+        }
+    }
+
+    AppendOnlyHashMap(const AppendOnlyHashMap&) = delete;
+    AppendOnlyHashMap& operator=(const AppendOnlyHashMap&) = delete;
+
+    /**
+     * Find the value of @key, return nullptr if not exist. Lock free.
+     */
+    Value* Find(const Key& key) const {
+        const Table* table = table_.load(std::memory_order_acquire);
+        return table->Find(key, hash_(key));
+    }
+
+    /**
+     * Find the value of @key, construct it from @args if not exist.
+     */
+    template <typename... Args>
+    Value* FindOrEmplace(const Key& key, Args&&... args) {
+        size_t hash = hash_(key);
+        std::lock_guard<std::mutex> lk(mtx_);
+        Table* table = table_.load(std::memory_order_relaxed);
+        Value* value = table->Find(key, hash);
+        if (value != nullptr) {
+            return value;
+        }
+
+        if (size_ + 1 > 2 * table->Buckets()) {
+            table = Grow(table);
+        }
+
+        Entry* entry = new Entry(key, std::forward<Args>(args)...);
+        table->Insert(entry, hash);
+        size_.store(size_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+        return &entry->value;
+    }
+
+    /**
+     * Call @f(key, value*) for every entry. Entries inserted concurrently
+     * may or may not be visited.
+     */
+    template <typename F>
+    void ForEach(F f) const {
+        const Table* table = table_.load(std::memory_order_acquire);
+        table->ForEachNode([&f](Node* node) {
+            f(node->entry->key, &node->entry->value);
+        });
+    }
+
+    size_t Size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Memory used by the buckets and chain nodes, excluding the values.
+     */
+    size_t MemoryUsage() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        size_t bytes = sizeof(*this) + Size() * sizeof(Entry);
+        bytes += table_.load(std::memory_order_relaxed)->MemoryUsage();
+        for (auto* table : retired_) {
+            bytes += table->MemoryUsage();
+        }
+        return bytes;
+    }
+
+ private:
+    struct Entry {
+        template <typename... Args>
+        explicit Entry(const Key& k, Args&&... args)
+            : key(k), value(std::forward<Args>(args)...) {}
+
+        const Key key;
+        Value value;
+    };
+
+    struct Node {
+        Node(Entry* e, size_t h, Node* n) : entry(e), hash(h), next(n) {}
+
+        Entry* const entry;
+        const size_t hash;
+        Node* const next;
+    };
+
+    class Table {
+     public:
+        explicit Table(size_t buckets)
+            : mask_(buckets - 1), buckets_(new std::atomic<Node*>[buckets]) {
+            for (size_t i = 0; i < buckets; ++i) {
+                buckets_[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        // only the chain nodes are freed, entries are shared by tables
+        ~Table() {
+            ForEachNode([](Node* node) { delete node; });
+        }
+
+        size_t Buckets() const { return mask_ + 1; }
+
+        Value* Find(const Key& key, size_t hash) const {
+            Node* node =
+                buckets_[hash & mask_].load(std::memory_order_acquire);
+            for (; node != nullptr; node = node->next) {
+                if (node->hash == hash && node->entry->key == key) {
+                    return &node->entry->value;
+                }
+            }
+            return nullptr;
+        }
+
+        void Insert(Entry* entry, size_t hash) {
+            std::atomic<Node*>& head = buckets_[hash & mask_];
+            Node* node =
+                new Node(entry, hash, head.load(std::memory_order_relaxed));
+            head.store(node, std::memory_order_release);
+        }
+
+        template <typename F>
+        void ForEachNode(F f) const {
+            for (size_t i = 0; i <= mask_; ++i) {
+                Node* node = buckets_[i].load(std::memory_order_acquire);
+                while (node != nullptr) {
+                    // f may free the node
+                    Node* next = node->next;
+                    f(node);
+                    node = next;
+                }
+            }
+        }
+
+        size_t MemoryUsage() const {
+            size_t nodes = 0;
+            ForEachNode([&nodes](Node*) { ++nodes; });
+            return sizeof(*this) + Buckets() * sizeof(std::atomic<Node*>) +
+                   nodes * sizeof(Node);
+        }
+
+     private:
+        const size_t mask_;
+        std::unique_ptr<std::atomic<Node*>[]> buckets_;
+    };
+
+    Table* Grow(Table* old) {
+        Table* table = new Table(old->Buckets() * 2);
+        old->ForEachNode([table](Node* node) {
+            table->Insert(node->entry, node->hash);
+        });
+        table_.store(table, std::memory_order_release);
+        retired_.push_back(old);
+        return table;
+    }
+
+    static size_t RoundUpPowerOf2(size_t n) {
+        size_t ret = 1;
+        while (ret < n) {
+            ret <<= 1;
+        }
+        return ret;
+    }
+
+ private:
+    Hash hash_;
+    std::atomic<Table*> table_;
+    std::atomic<size_t> size_;
+
+    // protect insertion and retired_
+    mutable std::mutex mtx_;
+    std::vector<Table*> retired_;
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_CONCURRENT_APPEND_ONLY_HASH_MAP_H_
@@ -24,6 +24,7 @@
 #define SRC_COMMON_CONCURRENT_BOUNDED_BLOCKING_QUEUE_H_
 
 #include <cassert>
+#include <chrono>               //NOLINT
 #include <cstdio>
 #include <condition_variable>   //NOLINT
 #include <deque>
@@ -120,6 +121,35 @@ class BoundedBlockingDeque : public Uncopyable {
         return front;
     }
 
+    /**
+     * Wait at most timeout for the queue to be non-empty, and take
+     * the front item only if it satisfies pred
+     * @param pred: called with the front item under the lock
+     * @param timeout: max time to wait if the queue is empty
+     * @param[out] item: the front item taken
+     * @return true if the front item is taken, false if timed out
+     *         or the front item does not satisfy pred
+     */
+    template <typename Pred, typename Rep, typename Period>
+    bool TakeFrontIf(Pred pred,
+                     const std::chrono::duration<Rep, Period>& timeout,
+                     T* item) {
+        std::unique_lock<std::mutex> guard(mutex_);
+        if (!notEmpty_.wait_for(guard, timeout,
+                                [this]() { return !deque_.empty(); })) {
+            return false;
+        }
+        if (!pred(deque_.front())) {
+            // pass the wakeup on, other takers may want the item
+            notEmpty_.notify_one();
+            return false;
+        }
+        *item = std::move(deque_.front());
+        deque_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
     T TakeBack() {
         std::unique_lock<std::mutex> guard(mutex_);
         while (deque_.empty()) {
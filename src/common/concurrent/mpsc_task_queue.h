@@ -0,0 +1,263 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-26
+ */
+
+#ifndef SRC_COMMON_CONCURRENT_MPSC_TASK_QUEUE_H_
+#define SRC_COMMON_CONCURRENT_MPSC_TASK_QUEUE_H_
+
+#include <atomic>
+#include <condition_variable>   // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>                // NOLINT
+#include <new>
+#include <thread>               // NOLINT
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace curve {
+namespace common {
+
+/**
+ * Bounded lock-free task queue with multiple producers and one consumer.
+ *
+ * Tasks are stored in place in the slots of a ring, so pushing a task
+ * allocates nothing unless the callable is larger than kInlineTaskSize.
+ * A slot is claimed by a CAS on the enqueue position and published by its
+ * sequence number, the consumer runs the task directly in the slot.
+ * Both sides spin for a while and then park when the queue is empty or
+ * full, so an idle queue costs no cpu.
+ */
+class MPSCTaskQueue {
+ public:
+    static const size_t kInlineTaskSize = 256;
+
+    // @param capacity: rounded up to the power of 2, at least 2
+    explicit MPSCTaskQueue(size_t capacity)
+        : mask_(RoundUpPowerOf2(capacity) - 1),
+          slots_(mask_ + 1),
+          enqueuePos_(0),
+          dequeuePos_(0),
+          consumerParked_(false),
+          parkedProducers_(0) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MPSCTaskQueue() {
+        // destroy the tasks not run
+        while (TryPop(false)) {}
+    }
+
+    MPSCTaskQueue(const MPSCTaskQueue&) = delete;
+    MPSCTaskQueue& operator=(const MPSCTaskQueue&) = delete;
+
+    /**
+     * Push a task, wait if the queue is full. Thread safe.
+     */
+    template<class F, class... Args>
+    void Push(F&& f, Args&&... args) {
+        Emplace(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    }
+
+    /**
+     * Run one task, wait if the queue is empty.
+     * Must be called by one thread only.
+     */
+    void RunOne() {
+        for (int i = 0; !TryPop(true); ++i) {
+            if (i < kSpinCount) {
+                continue;
+            } else if (i < kSpinCount + kYieldCount) {
+                std::this_thread::yield();
+                continue;
+            }
+            ParkConsumer();
+            i = 0;
+        }
+    }
+
+ private:
+    using RunFunc = void (*)(void* storage, bool run);
+
+    struct Slot {
+        std::atomic<size_t> seq;
+        RunFunc func;
+        typename std::aligned_storage<
+            kInlineTaskSize, alignof(std::max_align_t)>::type storage;
+    };
+
+    static const int kSpinCount = 128;
+    static const int kYieldCount = 16;
+
+    template<class T>
+    static void RunInline(void* storage, bool run) {
+        T* task = static_cast<T*>(storage);
+        if (run) {
+            (*task)();
+        }
+        task->~T();
+    }
+
+    template<class T>
+    static void RunHeap(void* storage, bool run) {
+        T* task = *static_cast<T**>(storage);
+        if (run) {
+            (*task)();
+        }
+        delete task;
+    }
+
+    template<class T>
+    static typename std::enable_if<
+        sizeof(T) <= kInlineTaskSize, RunFunc>::type
+    Construct(void* storage, T&& task) {
+        new (storage) T(std::move(task));
+        return &RunInline<T>;
+    }
+
+    template<class T>
+    static typename std::enable_if<
+        (sizeof(T) > kInlineTaskSize), RunFunc>::type
+    Construct(void* storage, T&& task) {
+        *static_cast<T**>(storage) = new T(std::move(task));
+        return &RunHeap<T>;
+    }
+
+    template<class T>
+    void Emplace(T&& task) {
+        using Task = typename std::decay<T>::type;
+        Slot* slot = nullptr;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (int i = 0; ; ++i) {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) -
+                            static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // full, the slot is not consumed yet
+                if (i >= kSpinCount) {
+                    ParkProducer(pos);
+                    i = 0;
+                }
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        Task tmp(std::forward<T>(task));
+        slot->func = Construct<Task>(&slot->storage, std::move(tmp));
+        slot->seq.store(pos + 1, std::memory_order_release);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerParked_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lk(mtx_);
+            notEmpty_.notify_one();
+        }
+    }
+
+    bool TryPop(bool run) {
+        Slot* slot = &slots_[dequeuePos_ & mask_];
+        if (slot->seq.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+            return false;
+        }
+        slot->func(&slot->storage, run);
+        slot->seq.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+        ++dequeuePos_;
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parkedProducers_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lk(mtx_);
+            notFull_.notify_one();
+        }
+        return true;
+    }
+
+    bool Readable() const {
+        const Slot& slot = slots_[dequeuePos_ & mask_];
+        return slot.seq.load(std::memory_order_acquire) == dequeuePos_ + 1;
+    }
+
+    bool Writable(size_t pos) const {
+        const Slot& slot = slots_[pos & mask_];
+        return slot.seq.load(std::memory_order_acquire) >= pos;
+    }
+
+    void ParkConsumer() {
+        std::unique_lock<std::mutex> lk(mtx_);
+        consumerParked_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        notEmpty_.wait(lk, [this]() { return Readable(); });
+        consumerParked_.store(false, std::memory_order_relaxed);
+    }
+
+    void ParkProducer(size_t pos) {
+        std::unique_lock<std::mutex> lk(mtx_);
+        parkedProducers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        notFull_.wait(lk, [this, pos]() { return Writable(pos); });
+        parkedProducers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    static size_t RoundUpPowerOf2(size_t n) {
+        // the sequence of a slot could not tell full from empty
+        // if there is only one slot
+        size_t size = 2;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+ private:
+    static const size_t kCacheLineSize = 64;
+
+    // the positions written by the producers and the consumer are padded
+    // to different cache lines, alignas is avoided since the queue is
+    // allocated by new
+    const size_t mask_;
+    std::vector<Slot> slots_;
+    char pad0_[kCacheLineSize];
+    std::atomic<size_t> enqueuePos_;
+    char pad1_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+    // only accessed by the consumer
+    size_t dequeuePos_;
+    char pad2_[kCacheLineSize - sizeof(size_t)];
+
+    std::atomic<bool> consumerParked_;
+    std::atomic<int> parkedProducers_;
+    std::mutex mtx_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+};
+
+}   // namespace common
+}   // namespace curve
+
+#endif  // SRC_COMMON_CONCURRENT_MPSC_TASK_QUEUE_H_
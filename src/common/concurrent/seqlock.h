@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-22
+ */
+
+#ifndef SRC_COMMON_CONCURRENT_SEQLOCK_H_
+#define SRC_COMMON_CONCURRENT_SEQLOCK_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace curve {
+namespace common {
+
+/**
+ * A small trivially copyable value protected by a sequence lock.
+ *
+ * Readers never block or write shared memory: they copy the value and
+ * retry if a writer was active meanwhile. Writers are serialized by the
+ * sequence number itself, so the value is meant for read-mostly data
+ * whose updates are rare, e.g. the leader of a copyset.
+ */
+template <typename T>
+class SeqLockValue {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLockValue requires a trivially copyable type");
+
+ public:
+    SeqLockValue() : SeqLockValue(T()) {}
+
+    explicit SeqLockValue(const T& value) : seq_(0) {
+        WriteWords(value);
+    }
+
+    SeqLockValue(const SeqLockValue&) = delete;
+    SeqLockValue& operator=(const SeqLockValue&) = delete;
+
+    /**
+     * Return a consistent copy of the value. Thread safe and lock free.
+     */
+    T Load() const {
+        uint64_t words[kWords];
+        uint64_t seq;
+        do {
+            seq = seq_.load(std::memory_order_acquire);
+            if (seq & 1) {
+                continue;
+            }
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) || seq != seq_.load(std::memory_order_relaxed));
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    void Store(const T& value) {
+        uint64_t seq = BeginWrite();
+        WriteWords(value);
+        EndWrite(seq);
+    }
+
+    /**
+     * Modify the value in place, @f is called with a T* and runs exclusively
+     * with other writers.
+     */
+    template <typename F>
+    void Update(F f) {
+        uint64_t seq = BeginWrite();
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        f(&value);
+        WriteWords(value);
+        EndWrite(seq);
+    }
+
+ private:
+    static const size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) /
+                                 sizeof(uint64_t);
+
+    uint64_t BeginWrite() {
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        while (true) {
+            if (seq & 1) {
+                seq = seq_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (seq_.compare_exchange_weak(seq, seq + 1,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        // order the odd sequence before the stores of the value
+        std::atomic_thread_fence(std::memory_order_release);
+        return seq;
+    }
+
+    void EndWrite(uint64_t seq) {
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    void WriteWords(const T& value) {
+        uint64_t words[kWords] = {0};
+        std::memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+ private:
+    std::atomic<uint64_t> seq_;
+    std::atomic<uint64_t> words_[kWords];
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_CONCURRENT_SEQLOCK_H_
@@ -56,6 +56,7 @@ const char* kLazyStr = "Lazy";
 const char* kStatusStr = "Status";
 const char* kTypeStr = "Type";
 const char* kInodeStr = "Inode";
+const char* kCompressTypeStr = "CompressType";
 
 const char* kCodeStr = "Code";
 const char* kMessageStr = "Message";
@@ -59,6 +59,7 @@ extern const char* kLazyStr;
 extern const char* kStatusStr;
 extern const char* kTypeStr;
 extern const char* kInodeStr;
+extern const char* kCompressTypeStr;
 
 // json key
 extern const char* kCodeStr;
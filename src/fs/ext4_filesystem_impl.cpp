@@ -29,6 +29,7 @@
 
 #include "src/common/string_util.h"
 #include "src/fs/ext4_filesystem_impl.h"
+#include "src/fs/iobuf_util.h"
 #include "src/fs/wrap_posix.h"
 
 #define MIN_KERNEL_VERSION KERNEL_VERSION(3, 15, 0)
@@ -331,29 +332,47 @@ int Ext4FileSystemImpl::Write(int fd,
 }
 
 int Ext4FileSystemImpl::Write(int fd,
-                              butil::IOBuf buf,
+                              const butil::IOBuf& buf,
                               uint64_t offset,
                               int length) {
     int remainLength = length;
     int relativeOffset = 0;
     int retryTimes = 0;
+    std::vector<struct iovec> iov;
+    IOBufWriteMetric* metric = IOBufWriteMetric::GetInstance();
+
+    if (length < 0 || buf.size() < static_cast<size_t>(length)) {
+        LOG(ERROR) << "IOBuf size " << buf.size()
+                   << " is less than write length " << length;
+        return -EINVAL;
+    }
 
     while (remainLength > 0) {
-        ssize_t ret = buf.pcut_into_file_descriptor(fd, offset, remainLength);
+        // write the iobuf blocks by reference, no data is copied
+        IOBufToIOVec(buf, relativeOffset, remainLength, &iov);
+        ssize_t ret = posixWrapper_->pwritev(fd, iov.data(), iov.size(),
+                                             offset);
         if (ret < 0) {
             if (errno == EINTR || retryTimes < MAX_RETYR_TIME) {
                 ++retryTimes;
                 continue;
             }
-            LOG(ERROR) << "IOBuf::pcut_into_file_descriptor failed: "
-                       << strerror(errno);
+            LOG(ERROR) << "pwritev failed: " << strerror(errno);
             return -errno;
         }
+        if (ret == 0) {
+            LOG(ERROR) << "pwritev wrote nothing, fd: " << fd
+                       << ", offset: " << offset;
+            return -EIO;
+        }
+        metric->segments << iov.size();
 
         remainLength -= ret;
         offset += ret;
+        relativeOffset += ret;
     }
 
+    metric->writeBytes << length;
     return length;
 }
 
@@ -54,7 +54,8 @@ class Ext4FileSystemImpl : public LocalFileSystem {
     int List(const string& dirPath, vector<std::string>* names) override;
     int Read(int fd, char* buf, uint64_t offset, int length) override;
     int Write(int fd, const char* buf, uint64_t offset, int length) override;
-    int Write(int fd, butil::IOBuf buf, uint64_t offset, int length) override;
+    int Write(int fd, const butil::IOBuf& buf, uint64_t offset,
+              int length) override;
     int Sync(int fd) override;
     int Append(int fd, const char* buf, int length) override;
     int Fallocate(int fd, int op, uint64_t offset,
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-22
+ */
+
+#include <limits.h>
+
+#include <algorithm>
+
+#include "src/fs/iobuf_util.h"
+
+namespace curve {
+namespace fs {
+
+IOBufWriteMetric* IOBufWriteMetric::GetInstance() {
+    static IOBufWriteMetric metric;
+    return &metric;
+}
+
+size_t IOBufToIOVec(const butil::IOBuf& buf, size_t pos, size_t length,
+                    std::vector<struct iovec>* iov) {
+    iov->clear();
+    size_t referenced = 0;
+    size_t blockNum = buf.backing_block_num();
+    for (size_t i = 0; i < blockNum && referenced < length &&
+                       iov->size() < IOV_MAX; ++i) {
+        butil::StringPiece block = buf.backing_block(i);
+        size_t blockSize = block.size();
+        // skip the blocks before pos
+        if (pos >= blockSize) {
+            pos -= blockSize;
+            continue;
+        }
+        size_t len = std::min(blockSize - pos, length - referenced);
+        struct iovec vec;
+        vec.iov_base = const_cast<char*>(block.data() + pos);
+        vec.iov_len = len;
+        iov->push_back(vec);
+        referenced += len;
+        pos = 0;
+    }
+    return referenced;
+}
+
+}  // namespace fs
+}  // namespace curve
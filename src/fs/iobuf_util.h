@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-22
+ */
+
+#ifndef SRC_FS_IOBUF_UTIL_H_
+#define SRC_FS_IOBUF_UTIL_H_
+
+#include <sys/uio.h>
+#include <butil/iobuf.h>
+#include <bvar/bvar.h>
+
+#include <vector>
+
+namespace curve {
+namespace fs {
+
+/**
+ * Metric of the iobuf write path of local filesystem.
+ * The data is written from the iobuf blocks by reference with pwritev,
+ * every byte counted here is written without being copied.
+ */
+struct IOBufWriteMetric {
+    // bytes written directly from the iobuf blocks
+    bvar::Adder<uint64_t> writeBytes;
+    // iovec segments of each pwritev
+    bvar::IntRecorder segments;
+
+    IOBufWriteMetric()
+        : writeBytes("lfs_iobuf_write_bytes"),
+          segments("lfs_iobuf_write_segments") {}
+
+    static IOBufWriteMetric* GetInstance();
+};
+
+/**
+ * Fill iov with the references of the iobuf blocks in [pos, pos + length),
+ * no data is copied, at most IOV_MAX segments are filled
+ * @param buf: iobuf to be written
+ * @param pos: start position in iobuf
+ * @param length: bytes expected to be referenced
+ * @param iov[out]: the iovecs referencing the iobuf blocks
+ * @return: bytes referenced by iov, which may be less than length
+ */
+size_t IOBufToIOVec(const butil::IOBuf& buf, size_t pos, size_t length,
+                    std::vector<struct iovec>* iov);
+
+}  // namespace fs
+}  // namespace curve
+
+#endif  // SRC_FS_IOBUF_UTIL_H_
@@ -0,0 +1,492 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-15
+ */
+
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "src/fs/iouring.h"
+
+namespace curve {
+namespace fs {
+
+namespace {
+
+// user data of the nops replacing the abandoned sqes, never a request
+const uint64_t kAbandonedUserData = 1;
+
+// backoff of the completion thread while waiting for completions fails
+const uint32_t kMinReapBackoffMs = 1;
+const uint32_t kMaxReapBackoffMs = 1000;
+
+int SysIOUringSetup(uint32_t entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int SysIOUringEnter(int fd, uint32_t toSubmit, uint32_t minComplete,
+                    uint32_t flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit,
+                                    minComplete, flags, nullptr, 0));
+}
+
+}  // namespace
+
+IOUring::IOUring()
+    : ringFd_(-1),
+      queueDepth_(0),
+      sqRing_(MAP_FAILED),
+      sqRingSize_(0),
+      sqHead_(nullptr),
+      sqTail_(nullptr),
+      sqMask_(nullptr),
+      sqArray_(nullptr),
+      sqes_(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+      sqesSize_(0),
+      cqRing_(MAP_FAILED),
+      cqRingSize_(0),
+      cqHead_(nullptr),
+      cqTail_(nullptr),
+      cqMask_(nullptr),
+      cqes_(nullptr),
+      pending_(0),
+      inflight_(0),
+      submitting_(false),
+      running_(false) {}
+
+IOUring::~IOUring() {
+    Fini();
+}
+
+int IOUring::Init(uint32_t queueDepth) {
+    if (Inited()) {
+        return 0;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = SysIOUringSetup(queueDepth, &params);
+    if (fd < 0) {
+        LOG(ERROR) << "io_uring_setup failed: " << strerror(errno)
+                   << ", queue depth: " << queueDepth;
+        return -errno;
+    }
+    ringFd_ = fd;
+    queueDepth_ = params.sq_entries;
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cqRingSize_ = params.cq_off.cqes +
+                  params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+
+    sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED) {
+        LOG(ERROR) << "mmap io_uring sq ring failed: " << strerror(errno);
+        int ret = -errno;
+        ReleaseRing();
+        return ret;
+    }
+
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+            LOG(ERROR) << "mmap io_uring cq ring failed: " << strerror(errno);
+            int ret = -errno;
+            ReleaseRing();
+            return ret;
+        }
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = static_cast<struct io_uring_sqe*>(
+        mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES));
+    if (sqes_ == MAP_FAILED) {
+        LOG(ERROR) << "mmap io_uring sqes failed: " << strerror(errno);
+        int ret = -errno;
+        ReleaseRing();
+        return ret;
+    }
+
+    char* sq = static_cast<char*>(sqRing_);
+    sqHead_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    sqMask_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    sqArray_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+
+    char* cq = static_cast<char*>(cqRing_);
+    cqHead_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    cqMask_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    running_.store(true);
+    reaper_ = std::thread(&IOUring::ReapCompletions, this);
+
+    LOG(INFO) << "io_uring init success, sq entries: " << params.sq_entries
+              << ", cq entries: " << params.cq_entries;
+    return 0;
+}
+
+void IOUring::Fini() {
+    if (!Inited()) {
+        return;
+    }
+
+    bool stopping = false;
+    {
+        std::unique_lock<std::mutex> lk(sqMtx_);
+        if (running_.load()) {
+            running_.store(false);
+            stopping = true;
+            // wake up the submitters waiting for free entries
+            sqCond_.notify_all();
+            sqCond_.wait(lk, [this]() { return inflight_ < queueDepth_; });
+            // a nop with zero user data tells the completion thread to
+            // exit, draining makes it complete after all the requests
+            // submitted before it
+            PrepareSqe(IORING_OP_NOP, -1, 0, 0, 0, 0, 0, IOSQE_IO_DRAIN);
+        }
+    }
+    if (stopping) {
+        Submit();
+        reaper_.join();
+    }
+    ReleaseRing();
+}
+
+void IOUring::ReleaseRing() {
+    if (sqes_ != MAP_FAILED) {
+        munmap(sqes_, sqesSize_);
+        sqes_ = static_cast<struct io_uring_sqe*>(MAP_FAILED);
+    }
+    if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+        munmap(cqRing_, cqRingSize_);
+    }
+    cqRing_ = MAP_FAILED;
+    if (sqRing_ != MAP_FAILED) {
+        munmap(sqRing_, sqRingSize_);
+        sqRing_ = MAP_FAILED;
+    }
+    if (ringFd_ >= 0) {
+        ::close(ringFd_);
+        ringFd_ = -1;
+    }
+}
+
+int IOUring::PRead(int fd, char* buf, uint64_t offset, uint32_t length) {
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = length;
+    return SubmitAndWait(IORING_OP_READV, fd, reinterpret_cast<uint64_t>(&iov),
+                         1, offset, 0);
+}
+
+int IOUring::PWrite(int fd, const char* buf, uint64_t offset,
+                    uint32_t length) {
+    struct iovec iov;
+    iov.iov_base = const_cast<char*>(buf);
+    iov.iov_len = length;
+    return PWritev(fd, &iov, 1, offset);
+}
+
+int IOUring::PWritev(int fd, const struct iovec* iov, int iovcnt,
+                     uint64_t offset) {
+    return SubmitAndWait(IORING_OP_WRITEV, fd,
+                         reinterpret_cast<uint64_t>(iov), iovcnt, offset, 0);
+}
+
+int IOUring::Fsync(int fd, bool datasync) {
+    return SubmitAndWait(IORING_OP_FSYNC, fd, 0, 0, 0,
+                         datasync ? IORING_FSYNC_DATASYNC : 0);
+}
+
+void IOUring::FsyncBatch(const std::vector<int>& fds, bool datasync,
+                         std::vector<int>* results) {
+    results->assign(fds.size(), -EINVAL);
+    uint32_t flags = datasync ? IORING_FSYNC_DATASYNC : 0;
+    std::vector<IOUringRequest> requests(fds.size());
+    size_t queued = 0;
+    while (queued < fds.size()) {
+        {
+            // queue as many as the ring allows and submit them before
+            // waiting for free entries again, so the sqes of this batch
+            // never wait for each other
+            std::unique_lock<std::mutex> lk(sqMtx_);
+            sqCond_.wait(lk, [this]() {
+                return !running_.load() || inflight_ < queueDepth_;
+            });
+            if (!running_.load()) {
+                break;
+            }
+            while (queued < fds.size() && inflight_ < queueDepth_) {
+                PrepareSqe(IORING_OP_FSYNC, fds[queued], 0, 0, 0, flags,
+                           reinterpret_cast<uint64_t>(&requests[queued]));
+                ++queued;
+            }
+        }
+        Submit();
+    }
+
+    // the fds not queued keep -EINVAL as the ring is stopped
+    for (size_t i = 0; i < queued; ++i) {
+        (*results)[i] = requests[i].Wait();
+    }
+}
+
+int IOUring::PReadAsync(int fd, char* buf, uint64_t offset, uint32_t length,
+                        IOUringCallback done) {
+    IOUringAsyncRequest* request = new IOUringAsyncRequest(std::move(done));
+    request->iov.iov_base = buf;
+    request->iov.iov_len = length;
+    return SubmitAsync(IORING_OP_READV, fd,
+                       reinterpret_cast<uint64_t>(&request->iov), 1, offset,
+                       0, request);
+}
+
+int IOUring::PWriteAsync(int fd, const char* buf, uint64_t offset,
+                         uint32_t length, IOUringCallback done) {
+    IOUringAsyncRequest* request = new IOUringAsyncRequest(std::move(done));
+    request->iov.iov_base = const_cast<char*>(buf);
+    request->iov.iov_len = length;
+    return SubmitAsync(IORING_OP_WRITEV, fd,
+                       reinterpret_cast<uint64_t>(&request->iov), 1, offset,
+                       0, request);
+}
+
+int IOUring::PWritevAsync(int fd, const struct iovec* iov, int iovcnt,
+                          uint64_t offset, IOUringCallback done) {
+    return SubmitAsync(IORING_OP_WRITEV, fd, reinterpret_cast<uint64_t>(iov),
+                       iovcnt, offset, 0,
+                       new IOUringAsyncRequest(std::move(done)));
+}
+
+int IOUring::FsyncAsync(int fd, bool datasync, IOUringCallback done) {
+    return SubmitAsync(IORING_OP_FSYNC, fd, 0, 0, 0,
+                       datasync ? IORING_FSYNC_DATASYNC : 0,
+                       new IOUringAsyncRequest(std::move(done)));
+}
+
+int IOUring::SubmitAsync(uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+                         uint64_t offset, uint32_t flags,
+                         IOUringAsyncRequest* request) {
+    if (!Enqueue(opcode, fd, addr, len, offset, flags,
+                 reinterpret_cast<uint64_t>(
+                     static_cast<IOUringRequest*>(request)))) {
+        delete request;
+        return -EINVAL;
+    }
+    Submit();
+    return 0;
+}
+
+int IOUring::SubmitAndWait(uint8_t opcode, int fd, uint64_t addr,
+                           uint32_t len, uint64_t offset, uint32_t flags) {
+    IOUringRequest request;
+    if (!Enqueue(opcode, fd, addr, len, offset, flags,
+                 reinterpret_cast<uint64_t>(&request))) {
+        return -EINVAL;
+    }
+    Submit();
+    return request.Wait();
+}
+
+bool IOUring::Enqueue(uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+                      uint64_t offset, uint32_t flags, uint64_t userData) {
+    std::unique_lock<std::mutex> lk(sqMtx_);
+    // the cq is twice as large as the sq, so limiting the inflight requests
+    // to the sq entries guarantees the completion queue never overflows
+    sqCond_.wait(lk, [this]() {
+        return !running_.load() || inflight_ < queueDepth_;
+    });
+    // checked with sqMtx_ held, so the sqe is never queued after the stop
+    // nop of Fini
+    if (!running_.load()) {
+        return false;
+    }
+
+    PrepareSqe(opcode, fd, addr, len, offset, flags, userData);
+    return true;
+}
+
+void IOUring::PrepareSqe(uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+                         uint64_t offset, uint32_t flags, uint64_t userData,
+                         uint8_t sqeFlags) {
+    uint32_t tail = *sqTail_;
+    uint32_t index = tail & *sqMask_;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->flags = sqeFlags;
+    sqe->fd = fd;
+    sqe->addr = addr;
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->rw_flags = flags;
+    sqe->user_data = userData;
+    sqArray_[index] = index;
+    __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+
+    ++pending_;
+    ++inflight_;
+}
+
+void IOUring::Submit() {
+    std::unique_lock<std::mutex> lk(sqMtx_);
+    if (submitting_) {
+        // the thread in submitting will submit our sqe later
+        return;
+    }
+
+    submitting_ = true;
+    std::vector<IOUringRequest*> abandoned;
+    int error = 0;
+    while (pending_ > 0) {
+        uint32_t toSubmit = pending_;
+        pending_ = 0;
+        lk.unlock();
+        while (toSubmit > 0) {
+            int ret = SysIOUringEnter(ringFd_, toSubmit, 0, 0);
+            if (ret < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                error = errno;
+                LOG(ERROR) << "io_uring_enter submit failed: "
+                           << strerror(error);
+                break;
+            }
+            toSubmit -= ret;
+        }
+        lk.lock();
+        if (error != 0) {
+            AbandonUnsubmitted(&abandoned);
+            break;
+        }
+    }
+    submitting_ = false;
+    lk.unlock();
+
+    // not completed with sqMtx_ held, which the callbacks of async
+    // requests may run into through other locks
+    for (IOUringRequest* request : abandoned) {
+        request->Complete(-error);
+    }
+}
+
+void IOUring::AbandonUnsubmitted(std::vector<IOUringRequest*>* abandoned) {
+    // sqTail_ is stable with sqMtx_ held, and the kernel only consumes
+    // sqes in io_uring_enter, which nobody is calling now
+    uint32_t head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    uint32_t tail = *sqTail_;
+    for (uint32_t i = head; i != tail; ++i) {
+        struct io_uring_sqe* sqe = &sqes_[sqArray_[i & *sqMask_]];
+        uint64_t userData = sqe->user_data;
+        if (userData != 0 && userData != kAbandonedUserData) {
+            abandoned->push_back(reinterpret_cast<IOUringRequest*>(userData));
+        }
+        // the nops are submitted with the next sqes, they still occupy
+        // the ring until completed
+        if (userData != 0) {
+            uint8_t sqeFlags = sqe->flags;
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_NOP;
+            sqe->flags = sqeFlags;
+            sqe->user_data = kAbandonedUserData;
+        }
+    }
+    pending_ = tail - head;
+}
+
+void IOUring::ReapCompletions() {
+    bool stop = false;
+    uint32_t backoffMs = kMinReapBackoffMs;
+    std::vector<std::pair<IOUringRequest*, int>> completions;
+    while (!stop) {
+        uint32_t head = *cqHead_;
+        uint32_t tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            int ret = SysIOUringEnter(ringFd_, 0, 1, IORING_ENTER_GETEVENTS);
+            if (ret < 0 && errno != EINTR) {
+                // the inflight requests are still owned by the kernel and
+                // can't be failed here, back off until it recovers
+                LOG_EVERY_N(ERROR, 100) << "io_uring_enter wait failed: "
+                                        << strerror(errno) << ", retry in "
+                                        << backoffMs << "ms";
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds(backoffMs));
+                backoffMs = std::min(backoffMs * 2, kMaxReapBackoffMs);
+            }
+            continue;
+        }
+        backoffMs = kMinReapBackoffMs;
+
+        uint32_t completed = 0;
+        completions.clear();
+        while (head != tail) {
+            struct io_uring_cqe* cqe = &cqes_[head & *cqMask_];
+            uint64_t userData = cqe->user_data;
+            int result = cqe->res;
+            ++head;
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+            ++completed;
+
+            if (userData == 0) {
+                stop = true;
+                continue;
+            }
+            if (userData == kAbandonedUserData) {
+                continue;
+            }
+            completions.emplace_back(
+                reinterpret_cast<IOUringRequest*>(userData), result);
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(sqMtx_);
+            inflight_ -= completed;
+            sqCond_.notify_all();
+        }
+        // free the entries before completing, so the submitters waiting
+        // for them don't wait for the callbacks of async requests
+        for (auto& completion : completions) {
+            completion.first->Complete(completion.second);
+        }
+    }
+}
+
+}  // namespace fs
+}  // namespace curve
@@ -0,0 +1,243 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-15
+ */
+
+#ifndef SRC_FS_IOURING_H_
+#define SRC_FS_IOURING_H_
+
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+namespace curve {
+namespace fs {
+
+// called with the result of an async request on the completion thread,
+// bytes read/written or 0 for fsync on success, -errno on failure
+using IOUringCallback = std::function<void(int result)>;
+
+/**
+ * One io request submitted to the ring, the submitter waits on it until
+ * the completion thread fills the result
+ */
+class IOUringRequest {
+ public:
+    IOUringRequest() : done_(false), result_(0) {}
+    virtual ~IOUringRequest() = default;
+
+    virtual void Complete(int result) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        result_ = result;
+        done_ = true;
+        cond_.notify_one();
+    }
+
+    // @return: bytes read/written or 0 for fsync on success,
+    //          -errno on failure
+    int Wait() {
+        std::unique_lock<std::mutex> lk(mtx_);
+        cond_.wait(lk, [this]() { return done_; });
+        return result_;
+    }
+
+ private:
+    std::mutex mtx_;
+    std::condition_variable cond_;
+    bool done_;
+    int result_;
+};
+
+/**
+ * Request of async io, nobody waits on it, it runs the callback and
+ * releases itself when completed
+ */
+class IOUringAsyncRequest : public IOUringRequest {
+ public:
+    explicit IOUringAsyncRequest(IOUringCallback done)
+        : callback_(std::move(done)) {}
+
+    void Complete(int result) override {
+        callback_(result);
+        delete this;
+    }
+
+    // iovec of single buffer io, valid until the request completes
+    struct iovec iov;
+
+ private:
+    IOUringCallback callback_;
+};
+
+/**
+ * A thin wrapper of io_uring built directly on the system calls.
+ *
+ * Requests from all the threads are queued to one submission queue, the
+ * thread which finds no submission in progress submits all the queued
+ * requests with one io_uring_enter() call, so concurrent requests are
+ * submitted in batch. A dedicated thread reaps the completions and wakes
+ * up the submitters.
+ *
+ * PRead/PWrite/Fsync block the caller until the request completes, the
+ * *Async versions return once the request is queued and run the callback
+ * on the completion thread, so one thread can keep many requests inflight.
+ */
+class IOUring {
+ public:
+    IOUring();
+    ~IOUring();
+
+    /**
+     * Setup the ring and start the completion thread
+     * @param queueDepth: number of entries of the submission queue,
+     *                    also the max number of inflight requests
+     * @return: 0 on success, -errno on failure
+     */
+    int Init(uint32_t queueDepth);
+
+    /**
+     * Stop the completion thread and release the ring,
+     * all the inflight requests are waited before return
+     */
+    void Fini();
+
+    bool Inited() const { return ringFd_ >= 0; }
+
+    int PRead(int fd, char* buf, uint64_t offset, uint32_t length);
+
+    int PWrite(int fd, const char* buf, uint64_t offset, uint32_t length);
+
+    // vectored write, iov must be valid until the request completes
+    int PWritev(int fd, const struct iovec* iov, int iovcnt,
+                uint64_t offset);
+
+    /**
+     * @param datasync: true for fdatasync semantic, otherwise fsync
+     */
+    int Fsync(int fd, bool datasync);
+
+    /**
+     * Fsync all the fds and wait for them, the requests are submitted
+     * together so the file system can merge them into one journal commit
+     * @param results: result of each fd, 0 on success, -errno on failure
+     */
+    void FsyncBatch(const std::vector<int>& fds, bool datasync,
+                    std::vector<int>* results);
+
+    /**
+     * Async io, the buffers must be valid until |done| is called.
+     * Queuing waits while the ring is full. |done| runs on the completion
+     * thread, it must not block or submit requests to this ring.
+     * @return: 0 if queued, then |done| is called exactly once,
+     *          -errno if not queued, then |done| is never called
+     */
+    int PReadAsync(int fd, char* buf, uint64_t offset, uint32_t length,
+                   IOUringCallback done);
+
+    int PWriteAsync(int fd, const char* buf, uint64_t offset,
+                    uint32_t length, IOUringCallback done);
+
+    int PWritevAsync(int fd, const struct iovec* iov, int iovcnt,
+                     uint64_t offset, IOUringCallback done);
+
+    int FsyncAsync(int fd, bool datasync, IOUringCallback done);
+
+ private:
+    // fill one sqe and submit it, return the result of completion
+    int SubmitAndWait(uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+                      uint64_t offset, uint32_t flags);
+
+    // fill one sqe and submit it without waiting, |request| is released
+    // here if it can't be queued
+    int SubmitAsync(uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+                    uint64_t offset, uint32_t flags,
+                    IOUringAsyncRequest* request);
+
+    // push one sqe to the submission queue, wait if the ring is full,
+    // return false if the ring is stopped
+    bool Enqueue(uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+                 uint64_t offset, uint32_t flags, uint64_t userData);
+
+    // fill the next sqe and count it as pending, the caller must hold
+    // sqMtx_ and make sure the ring is not full
+    void PrepareSqe(uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+                    uint64_t offset, uint32_t flags, uint64_t userData,
+                    uint8_t sqeFlags = 0);
+
+    // submit the queued sqes if there is no other submitter
+    void Submit();
+
+    // the sqes not consumed by the kernel after io_uring_enter failed are
+    // turned into nops, and their requests are returned in |abandoned| to
+    // be completed with the error after sqMtx_ is released, the caller
+    // must hold sqMtx_
+    void AbandonUnsubmitted(std::vector<IOUringRequest*>* abandoned);
+
+    void ReapCompletions();
+
+    void ReleaseRing();
+
+ private:
+    int ringFd_;
+    uint32_t queueDepth_;
+
+    // mmaped submission queue
+    void* sqRing_;
+    size_t sqRingSize_;
+    uint32_t* sqHead_;
+    uint32_t* sqTail_;
+    uint32_t* sqMask_;
+    uint32_t* sqArray_;
+    struct io_uring_sqe* sqes_;
+    size_t sqesSize_;
+
+    // mmaped completion queue
+    void* cqRing_;
+    size_t cqRingSize_;
+    uint32_t* cqHead_;
+    uint32_t* cqTail_;
+    uint32_t* cqMask_;
+    struct io_uring_cqe* cqes_;
+
+    // protect the submission queue
+    std::mutex sqMtx_;
+    std::condition_variable sqCond_;
+    // number of sqes queued but not submitted
+    uint32_t pending_;
+    // number of requests submitted or queued but not completed
+    uint32_t inflight_;
+    bool submitting_;
+
+    // changed with sqMtx_ held, so no sqe is queued after the stop nop
+    std::atomic<bool> running_;
+    std::thread reaper_;
+};
+
+}  // namespace fs
+}  // namespace curve
+
+#endif  // SRC_FS_IOURING_H_
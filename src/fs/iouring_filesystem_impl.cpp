@@ -0,0 +1,244 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-15
+ */
+
+#include <glog/logging.h>
+#include <limits.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+
+#include "src/fs/iouring_filesystem_impl.h"
+#include "src/fs/ext4_filesystem_impl.h"
+#include "src/fs/iobuf_util.h"
+
+namespace curve {
+namespace fs {
+
+std::shared_ptr<IOUringFileSystemImpl> IOUringFileSystemImpl::self_ = nullptr;
+std::mutex IOUringFileSystemImpl::mutex_;
+
+IOUringFileSystemImpl::IOUringFileSystemImpl(
+    std::shared_ptr<LocalFileSystem> ext4)
+    : ext4_(ext4) {
+    CHECK(ext4_ != nullptr) << "Ext4 local fs is null";
+}
+
+IOUringFileSystemImpl::~IOUringFileSystemImpl() {
+    ring_.Fini();
+}
+
+std::shared_ptr<IOUringFileSystemImpl> IOUringFileSystemImpl::getInstance() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (self_ == nullptr) {
+        self_ = std::shared_ptr<IOUringFileSystemImpl>(
+            new(std::nothrow) IOUringFileSystemImpl(
+                Ext4FileSystemImpl::getInstance()));
+        CHECK(self_ != nullptr) << "Failed to new io_uring local fs.";
+    }
+    return self_;
+}
+
+int IOUringFileSystemImpl::Init(const LocalFileSystemOption& option) {
+    int ret = ext4_->Init(option);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = ring_.Init(option.ioUringQueueDepth);
+    if (ret != 0) {
+        LOG(ERROR) << "Init io_uring failed, queue depth: "
+                   << option.ioUringQueueDepth;
+        return ret;
+    }
+    return 0;
+}
+
+int IOUringFileSystemImpl::Statfs(const string& path,
+                                  struct FileSystemInfo *info) {
+    return ext4_->Statfs(path, info);
+}
+
+int IOUringFileSystemImpl::Open(const string& path, int flags) {
+    return ext4_->Open(path, flags);
+}
+
+int IOUringFileSystemImpl::Close(int fd) {
+    return ext4_->Close(fd);
+}
+
+int IOUringFileSystemImpl::Delete(const string& path) {
+    return ext4_->Delete(path);
+}
+
+int IOUringFileSystemImpl::Mkdir(const string& dirPath) {
+    return ext4_->Mkdir(dirPath);
+}
+
+bool IOUringFileSystemImpl::DirExists(const string& dirPath) {
+    return ext4_->DirExists(dirPath);
+}
+
+bool IOUringFileSystemImpl::FileExists(const string& filePath) {
+    return ext4_->FileExists(filePath);
+}
+
+int IOUringFileSystemImpl::Rename(const string& oldPath,
+                                  const string& newPath,
+                                  unsigned int flags) {
+    return ext4_->Rename(oldPath, newPath, flags);
+}
+
+int IOUringFileSystemImpl::List(const string& dirPath,
+                                vector<std::string> *names) {
+    return ext4_->List(dirPath, names);
+}
+
+int IOUringFileSystemImpl::Read(int fd,
+                                char *buf,
+                                uint64_t offset,
+                                int length) {
+    int remainLength = length;
+    int relativeOffset = 0;
+    while (remainLength > 0) {
+        int ret = ring_.PRead(fd, buf + relativeOffset, offset, remainLength);
+        // 如果offset大于文件长度，read会返回0
+        if (ret == 0) {
+            LOG(WARNING) << "io_uring read returns zero."
+                         << "offset: " << offset
+                         << ", length: " << remainLength;
+            break;
+        }
+        if (ret < 0) {
+            if (ret == -EINTR || ret == -EAGAIN) {
+                continue;
+            }
+            LOG(ERROR) << "io_uring read failed: " << strerror(-ret);
+            return ret;
+        }
+        remainLength -= ret;
+        offset += ret;
+        relativeOffset += ret;
+    }
+    return length - remainLength;
+}
+
+int IOUringFileSystemImpl::Write(int fd,
+                                 const char *buf,
+                                 uint64_t offset,
+                                 int length) {
+    int remainLength = length;
+    int relativeOffset = 0;
+    while (remainLength > 0) {
+        int ret = ring_.PWrite(fd, buf + relativeOffset, offset, remainLength);
+        if (ret == 0) {
+            LOG(ERROR) << "io_uring write returns zero, offset: " << offset
+                       << ", length: " << remainLength;
+            return -EIO;
+        }
+        if (ret < 0) {
+            if (ret == -EINTR || ret == -EAGAIN) {
+                continue;
+            }
+            LOG(ERROR) << "io_uring write failed: " << strerror(-ret);
+            return ret;
+        }
+        remainLength -= ret;
+        offset += ret;
+        relativeOffset += ret;
+    }
+    return length;
+}
+
+int IOUringFileSystemImpl::Write(int fd,
+                                 const butil::IOBuf& buf,
+                                 uint64_t offset,
+                                 int length) {
+    int remainLength = length;
+    int relativeOffset = 0;
+    std::vector<struct iovec> iov;
+    IOBufWriteMetric* metric = IOBufWriteMetric::GetInstance();
+    while (remainLength > 0) {
+        // write the iobuf blocks by reference, no data is copied
+        size_t bytes = IOBufToIOVec(buf, relativeOffset, remainLength, &iov);
+        if (bytes == 0) {
+            LOG(ERROR) << "IOBuf size " << buf.size()
+                       << " is less than write length " << length;
+            return -EINVAL;
+        }
+
+        int ret = ring_.PWritev(fd, iov.data(), iov.size(), offset);
+        if (ret == 0) {
+            LOG(ERROR) << "io_uring writev returns zero, offset: " << offset
+                       << ", length: " << remainLength;
+            return -EIO;
+        }
+        if (ret < 0) {
+            if (ret == -EINTR || ret == -EAGAIN) {
+                continue;
+            }
+            LOG(ERROR) << "io_uring writev failed: " << strerror(-ret);
+            return ret;
+        }
+        metric->segments << iov.size();
+        remainLength -= ret;
+        offset += ret;
+        relativeOffset += ret;
+    }
+    metric->writeBytes << length;
+    return length;
+}
+
+int IOUringFileSystemImpl::Sync(int fd) {
+    int rc = ring_.Fsync(fd, true);
+    if (rc < 0) {
+        LOG(ERROR) << "io_uring fdatasync failed: " << strerror(-rc);
+        return rc;
+    }
+    return 0;
+}
+
+int IOUringFileSystemImpl::Append(int fd,
+                                  const char *buf,
+                                  int length) {
+    return ext4_->Append(fd, buf, length);
+}
+
+int IOUringFileSystemImpl::Fallocate(int fd,
+                                     int op,
+                                     uint64_t offset,
+                                     int length) {
+    return ext4_->Fallocate(fd, op, offset, length);
+}
+
+int IOUringFileSystemImpl::Fstat(int fd, struct stat *info) {
+    return ext4_->Fstat(fd, info);
+}
+
+int IOUringFileSystemImpl::Fsync(int fd) {
+    int rc = ring_.Fsync(fd, false);
+    if (rc < 0) {
+        LOG(ERROR) << "io_uring fsync failed: " << strerror(-rc);
+        return rc;
+    }
+    return 0;
+}
+
+}  // namespace fs
+}  // namespace curve
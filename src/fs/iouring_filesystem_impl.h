@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-15
+ */
+
+#ifndef SRC_FS_IOURING_FILESYSTEM_IMPL_H_
+#define SRC_FS_IOURING_FILESYSTEM_IMPL_H_
+
+#include <butil/iobuf.h>
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "src/fs/local_filesystem.h"
+#include "src/fs/iouring.h"
+
+namespace curve {
+namespace fs {
+
+/**
+ * Local filesystem which issues data io (read/write/sync) through io_uring,
+ * so that a few apply threads can keep the device queue deep.
+ * The metadata operations are delegated to the ext4 implementation.
+ */
+class IOUringFileSystemImpl : public LocalFileSystem {
+ public:
+    virtual ~IOUringFileSystemImpl();
+    static std::shared_ptr<IOUringFileSystemImpl> getInstance();
+
+    int Init(const LocalFileSystemOption& option) override;
+    int Statfs(const string& path, struct FileSystemInfo* info) override;
+    int Open(const string& path, int flags) override;
+    int Close(int fd) override;
+    int Delete(const string& path) override;
+    int Mkdir(const string& dirPath) override;
+    bool DirExists(const string& dirPath) override;
+    bool FileExists(const string& filePath) override;
+    int Rename(const string& oldPath,
+               const string& newPath,
+               unsigned int flags = 0) override;
+    int List(const string& dirPath, vector<std::string>* names) override;
+    int Read(int fd, char* buf, uint64_t offset, int length) override;
+    int Write(int fd, const char* buf, uint64_t offset, int length) override;
+    int Write(int fd, const butil::IOBuf& buf, uint64_t offset,
+              int length) override;
+    int Sync(int fd) override;
+    int Append(int fd, const char* buf, int length) override;
+    int Fallocate(int fd, int op, uint64_t offset,
+                  int length) override;
+    int Fstat(int fd, struct stat* info) override;
+    int Fsync(int fd) override;
+
+ private:
+    explicit IOUringFileSystemImpl(std::shared_ptr<LocalFileSystem> ext4);
+
+ private:
+    static std::shared_ptr<IOUringFileSystemImpl> self_;
+    static std::mutex mutex_;
+    // filesystem for the metadata operations
+    std::shared_ptr<LocalFileSystem> ext4_;
+    IOUring ring_;
+};
+
+}  // namespace fs
+}  // namespace curve
+
+#endif  // SRC_FS_IOURING_FILESYSTEM_IMPL_H_
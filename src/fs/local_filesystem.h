@@ -45,7 +45,10 @@ namespace fs {
 
 struct LocalFileSystemOption {
     bool enableRenameat2;
-    LocalFileSystemOption() : enableRenameat2(false) {}
+    // queue depth of io_uring, only used by FileSystemType::EXT4_IOURING
+    uint32_t ioUringQueueDepth;
+    LocalFileSystemOption() : enableRenameat2(false),
+                              ioUringQueueDepth(128) {}
 };
 
 class LocalFileSystem {
@@ -163,12 +166,12 @@ class LocalFileSystem {
     /**
      * 向文件指定区域写入数据
      * @param fd：文件句柄id，通过Open接口获取
-     * @param buf：待写入数据
+     * @param buf：待写入数据，直接以iobuf block的引用写入，不拷贝数据
      * @param offset：写入区域的起始偏移
      * @param length：写入数据的长度
      * @return 返回成功写入的数据长度，失败返回-1
      */
-    virtual int Write(int fd, butil::IOBuf buf, uint64_t offset,
+    virtual int Write(int fd, const butil::IOBuf& buf, uint64_t offset,
                       int length) = 0;
 
     /**
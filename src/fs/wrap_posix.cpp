@@ -96,6 +96,13 @@ ssize_t PosixWrapper::pwrite(int fd,
     return ::pwrite(fd, buf, count, offset);
 }
 
+ssize_t PosixWrapper::pwritev(int fd,
+                              const struct iovec *iov,
+                              int iovcnt,
+                              off_t offset) {
+    return ::pwritev(fd, iov, iovcnt, offset);
+}
+
 int PosixWrapper::fdatasync(int fd) {
     return ::fdatasync(fd);
 }
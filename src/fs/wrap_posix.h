@@ -30,6 +30,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/utsname.h>
+#include <sys/uio.h>
 #include <linux/fs.h>
 #include <dirent.h>
 #include <string>
@@ -60,6 +61,10 @@ class PosixWrapper {
                            const void *buf,
                            size_t count,
                            off_t offset);
+    virtual ssize_t pwritev(int fd,
+                            const struct iovec *iov,
+                            int iovcnt,
+                            off_t offset);
     virtual int fdatasync(int fd);
     virtual int fstat(int fd, struct stat *buf);
     virtual int fallocate(int fd, int mode, off_t offset, off_t len);
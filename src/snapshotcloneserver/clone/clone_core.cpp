@@ -513,7 +513,19 @@ int CloneCoreImpl::BuildFileInfoFromSnapshot(
         snapMeta.GetChunkDataName(chunkIndex, &chunkDataName);
         uint64_t segmentIndex = chunkIndex / chunkPerSegment;
         CloneChunkInfo info;
-        info.location = chunkDataName.ToDataChunkKey();
+        std::string hash;
+        if (snapMeta.GetChunkContent(chunkIndex, &hash)) {
+            // 全零的chunk不需要克隆，按内容去重的chunk从共享数据克隆
+            if (hash.empty()) {
+                continue;
+            }
+            info.location = ToContentChunkDataName(hash).ToDataChunkKey();
+        } else {
+            info.location = chunkDataName.ToDataChunkKey();
+            CompressType compressType;
+            info.compressed =
+                snapMeta.GetChunkCompressType(chunkIndex, &compressType);
+        }
         info.needRecover = true;
         if (IsRecover(task)) {
             info.seqNum = chunkDataName.chunkSeqNum_;
@@ -719,7 +731,10 @@ int CloneCoreImpl::CreateCloneChunk(
     for (auto & cloneSegmentInfo : *segInfos) {
         for (auto & cloneChunkInfo : cloneSegmentInfo.second) {
             std::string location;
-            if (IsSnapshot(task)) {
+            if (IsSnapshot(task) && cloneChunkInfo.second.compressed) {
+                location = LocationOperator::GenerateCompressedS3Location(
+                    cloneChunkInfo.second.location);
+            } else if (IsSnapshot(task)) {
                 location = LocationOperator::GenerateS3Location(
                     cloneChunkInfo.second.location);
             } else {
@@ -206,6 +206,8 @@ struct CloneChunkInfo {
     uint64_t seqNum;
     // chunk是否需要recover
     bool needRecover;
+    // s3上的对象是否经过压缩
+    bool compressed = false;
 };
 
 // 克隆/恢复所需segment信息，key是ChunkIndex In Segment, value是chunk信息
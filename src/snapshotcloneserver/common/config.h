@@ -26,11 +26,13 @@
 
 #include<string>
 #include <vector>
+#include "src/common/compression.h"
 #include "src/common/concurrent/dlock.h"
 
 namespace curve {
 namespace snapshotcloneserver {
 
+using curve::common::CompressType;
 using curve::common::DLockOpts;
 
 // curve client options
@@ -71,6 +73,14 @@ struct SnapshotCloneServerOptions {
     uint32_t mdsSessionTimeUs;
     // ReadChunkSnapshot同时进行的异步请求数量
     uint32_t readChunkSnapshotConcurrency;
+    // 所有转储任务同时上传的分片数量，即上传线程池的线程数
+    uint32_t transferUploadPartConcurrency = 64;
+    // 转储分片缓冲区的总大小(MB)，限制读取和上传中的分片占用的内存
+    uint64_t transferBufferPoolSizeMB = 1024;
+    // 是否按内容去重保存快照的chunk数据，全零的chunk不保存数据
+    bool enableChunkDedup = false;
+    // 创建快照请求未指定压缩算法时使用的默认值
+    CompressType snapshotCompressType = CompressType::kNone;
 
     // 用于Lazy克隆元数据部分的线程池线程数
     int stage1PoolThreadNum;
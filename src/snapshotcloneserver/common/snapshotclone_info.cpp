@@ -94,6 +94,7 @@ bool SnapshotInfo::SerializeToString(std::string *value) const {
     data.set_filelength(fileLength_);
     data.set_stripeunit(stripeUnit_);
     data.set_stripecount(stripeCount_);
+    data.set_compresstype(static_cast<uint32_t>(compressType_));
     data.set_time(time_);
     data.set_status(static_cast<int>(status_));
     return data.SerializeToString(value);
@@ -120,6 +121,11 @@ bool SnapshotInfo::ParseFromString(const std::string &value) {
     } else {
         stripeCount_ = 0;
     }
+    if (data.has_compresstype()) {
+        compressType_ = static_cast<CompressType>(data.compresstype());
+    } else {
+        compressType_ = CompressType::kNone;
+    }
     time_ = data.time();
     status_ = static_cast<Status>(data.status());
     return ret;
@@ -136,6 +142,8 @@ std::ostream& operator<<(std::ostream& os, const SnapshotInfo &snapshotInfo) {
     os << ", fileLength : " << snapshotInfo.GetFileLength();
     os << ", stripeUnit :" << snapshotInfo.GetStripeUnit();
     os << ", stripeCount :" << snapshotInfo.GetStripeCount();
+    os << ", compressType : "
+       << curve::common::CompressTypeToString(snapshotInfo.GetCompressType());
     os << ", time : " << snapshotInfo.GetCreateTime();
     os << ", status : " << static_cast<int>(snapshotInfo.GetStatus());
     os << " }";
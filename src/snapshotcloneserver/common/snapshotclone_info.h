@@ -28,11 +28,14 @@
 #include <map>
 #include <memory>
 
+#include "src/common/compression.h"
 #include "src/common/snapshotclone/snapshotclone_define.h"
 
 namespace curve {
 namespace snapshotcloneserver {
 
+using curve::common::CompressType;
+
 enum class CloneStatus {
     done = 0,
     cloning = 1,
@@ -268,6 +271,7 @@ class SnapshotInfo {
         fileLength_(0),
         stripeUnit_(0),
         stripeCount_(0),
+        compressType_(CompressType::kNone),
         time_(0),
         status_(Status::pending) {}
 
@@ -285,6 +289,7 @@ class SnapshotInfo {
         fileLength_(0),
         stripeUnit_(0),
         stripeCount_(0),
+        compressType_(CompressType::kNone),
         time_(0),
         status_(Status::pending) {}
     SnapshotInfo(UUID uuid,
@@ -309,6 +314,7 @@ class SnapshotInfo {
         fileLength_(filelength),
         stripeUnit_(stripeUnit),
         stripeCount_(stripeCount),
+        compressType_(CompressType::kNone),
         time_(time),
         status_(status) {}
 
@@ -392,6 +398,14 @@ class SnapshotInfo {
         return stripeCount_;
     }
 
+    void SetCompressType(CompressType compressType) {
+        compressType_ = compressType;
+    }
+
+    CompressType GetCompressType() const {
+        return compressType_;
+    }
+
     void SetCreateTime(uint64_t createTime) {
         time_ = createTime;
     }
@@ -433,6 +447,8 @@ class SnapshotInfo {
     uint64_t stripeUnit_;
     // stripe count
     uint64_t stripeCount_;
+    // 快照chunk对象的压缩算法，创建快照时确定，之后不再改变
+    CompressType compressType_;
     // 快照创建时间
     uint64_t time_;
     // 快照处理的状态
@@ -145,6 +145,15 @@ class SnapshotCloneMetaStore {
      * @return: 0 获取成功/ -1 获取失败
      */
     virtual int GetCloneInfoList(std::vector<CloneInfo> *list) = 0;
+
+    // 按内容去重保存的chunk数据对象的引用，每个引用对应一个快照的一个chunk，
+    // 重复添加或删除同一个引用是幂等的
+    virtual int AddChunkDataRef(const std::string &hash,
+                                const std::string &ref) = 0;
+    virtual int DeleteChunkDataRef(const std::string &hash,
+                                   const std::string &ref) = 0;
+    virtual int GetChunkDataRefCount(const std::string &hash,
+                                     uint32_t *count) = 0;
 };
 
 }  // namespace snapshotcloneserver
@@ -294,6 +294,51 @@ int SnapshotCloneMetaStoreEtcd::GetCloneInfoList(std::vector<CloneInfo> *list) {
     return -1;
 }
 
+int SnapshotCloneMetaStoreEtcd::AddChunkDataRef(const std::string &hash,
+    const std::string &ref) {
+    std::string key = codec_->EncodeChunkDataRefKey(hash, ref);
+    int errCode = client_->Put(key, ref);
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "Put chunk data ref into etcd err"
+                   << ", errcode = " << errCode
+                   << ", hash = " << hash
+                   << ", ref = " << ref;
+        return -1;
+    }
+    return 0;
+}
+
+int SnapshotCloneMetaStoreEtcd::DeleteChunkDataRef(const std::string &hash,
+    const std::string &ref) {
+    std::string key = codec_->EncodeChunkDataRefKey(hash, ref);
+    int errCode = client_->Delete(key);
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "delete chunk data ref from etcd err"
+                   << ", errcode = " << errCode
+                   << ", hash = " << hash
+                   << ", ref = " << ref;
+        return -1;
+    }
+    return 0;
+}
+
+int SnapshotCloneMetaStoreEtcd::GetChunkDataRefCount(const std::string &hash,
+    uint32_t *count) {
+    std::string startKey = SnapshotCloneCodec::GetChunkDataRefKeyPrefix(hash);
+    std::string endKey = SnapshotCloneCodec::GetChunkDataRefKeyEnd(hash);
+    std::vector<std::string> out;
+    int errCode = client_->List(startKey, endKey, &out);
+    if (errCode != EtcdErrCode::EtcdOK &&
+        errCode != EtcdErrCode::EtcdKeyNotExist) {
+        LOG(ERROR) << "list chunk data ref from etcd err"
+                   << ", errcode = " << errCode
+                   << ", hash = " << hash;
+        return -1;
+    }
+    *count = out.size();
+    return 0;
+}
+
 int SnapshotCloneMetaStoreEtcd::LoadSnapshotInfos() {
     std::string startKey = SnapshotCloneCodec::GetSnapshotInfoKeyPrefix();
     std::string endKey = SnapshotCloneCodec::GetSnapshotInfoKeyEnd();
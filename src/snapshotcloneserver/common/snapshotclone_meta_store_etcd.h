@@ -81,6 +81,15 @@ class SnapshotCloneMetaStoreEtcd : public SnapshotCloneMetaStore {
 
     int GetCloneInfoList(std::vector<CloneInfo> *list) override;
 
+    int AddChunkDataRef(const std::string &hash,
+                        const std::string &ref) override;
+
+    int DeleteChunkDataRef(const std::string &hash,
+                           const std::string &ref) override;
+
+    int GetChunkDataRefCount(const std::string &hash,
+                             uint32_t *count) override;
+
  private:
     /**
      * @brief 加载快照信息
@@ -23,7 +23,9 @@
 #include "src/snapshotcloneserver/common/snapshotclone_metric.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_task.h"
 #include "src/snapshotcloneserver/clone/clone_task.h"
+#include "src/common/timeutility.h"
 
+using ::curve::common::TimeUtility;
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -38,12 +40,26 @@ void SnapshotInfoMetric::Update(SnapshotTaskInfo *taskInfo) {
     metric.Set("ChunkSize", std::to_string(snapInfo.GetChunkSize()));
     metric.Set("SegmentSize", std::to_string(snapInfo.GetSegmentSize()));
     metric.Set("FileLength", std::to_string(snapInfo.GetFileLength()));
+    metric.Set("CompressType",
+        curve::common::CompressTypeToString(snapInfo.GetCompressType()));
     metric.Set("CreateTime", std::to_string(snapInfo.GetCreateTime()));
     metric.Set("Status", std::to_string(
         static_cast<int>(snapInfo.GetStatus())));
 
     metric.Set("Progress", std::to_string(taskInfo->GetProgress()));
 
+    // 转储数据的吞吐，单位bytes/s
+    uint64_t transferBytes = taskInfo->GetTransferBytes();
+    uint64_t transferBandwidth = 0;
+    uint64_t startTime = taskInfo->GetTransferStartTime();
+    uint64_t now = TimeUtility::GetTimeofDayUs();
+    if (startTime != 0 && now > startTime) {
+        transferBandwidth = transferBytes * 1000000 / (now - startTime);
+    }
+    metric.Set("TransferBytes", std::to_string(transferBytes));
+    metric.Set("TransferBandwidth", std::to_string(transferBandwidth));
+    metric.Set("DedupBytes", std::to_string(taskInfo->GetDedupBytes()));
+
     metric.Update();
 }
 
@@ -59,6 +59,13 @@ bool SnapshotCloneCodec::DecodeCloneInfoData(
     return data->ParseFromString(value);
 }
 
+std::string SnapshotCloneCodec::EncodeChunkDataRefKey(
+    const std::string &hash, const std::string &ref) {
+    std::string key = SnapshotCloneCodec::GetChunkDataRefKeyPrefix(hash);
+    key += ref;
+    return key;
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
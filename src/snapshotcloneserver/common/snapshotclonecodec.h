@@ -32,6 +32,7 @@ using ::curve::common::SNAPINFOKEYPREFIX;
 using ::curve::common::SNAPINFOKEYEND;
 using ::curve::common::CLONEINFOKEYPREFIX;
 using ::curve::common::CLONEINFOKEYEND;
+using ::curve::common::CHUNKDATAREFKEYPREFIX;
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -46,6 +47,9 @@ class SnapshotCloneCodec {
     bool EncodeCloneInfoData(const CloneInfo &data, std::string *value);
     bool DecodeCloneInfoData(const std::string &value, CloneInfo *data);
 
+    std::string EncodeChunkDataRefKey(const std::string &hash,
+                                      const std::string &ref);
+
     static std::string GetSnapshotInfoKeyPrefix() {
         return std::string(SNAPINFOKEYPREFIX);
     }
@@ -61,6 +65,15 @@ class SnapshotCloneCodec {
     static std::string GetCloneInfoKeyEnd() {
         return std::string(CLONEINFOKEYEND);
     }
+
+    // 同一个chunk数据对象的引用都在[prefix + hash + "/", prefix + hash + "0")
+    static std::string GetChunkDataRefKeyPrefix(const std::string &hash) {
+        return std::string(CHUNKDATAREFKEYPREFIX) + hash + "/";
+    }
+
+    static std::string GetChunkDataRefKeyEnd(const std::string &hash) {
+        return std::string(CHUNKDATAREFKEYPREFIX) + hash + "0";
+    }
 };
 
 }  // namespace snapshotcloneserver
@@ -30,26 +30,53 @@
 #include "src/snapshotcloneserver/snapshot/snapshot_task.h"
 
 #include "src/common/uuid.h"
+#include "src/common/timeutility.h"
 
 using ::curve::common::UUIDGenerator;
+using ::curve::common::TimeUtility;
 using ::curve::common::NameLockGuard;
 using ::curve::common::LockGuard;
 
 namespace curve {
 namespace snapshotcloneserver {
 
+namespace {
+
+// chunk对共享数据的引用，每个快照的每个chunk各自持有一个引用
+std::string MakeChunkContentRef(const UUID &uuid, ChunkIndexType chunkIndex) {
+    return uuid + "-" + std::to_string(chunkIndex);
+}
+
+}  // namespace
+
 int SnapshotCoreImpl::Init() {
     int ret = threadPool_->Start();
     if (ret < 0) {
         LOG(ERROR) << "SnapshotCoreImpl, thread start fail, ret = " << ret;
         return ret;
     }
+    ret = uploadThreadPool_->Start();
+    if (ret < 0) {
+        LOG(ERROR) << "SnapshotCoreImpl, upload thread start fail"
+                   << ", ret = " << ret;
+        return ret;
+    }
+
+    // 至少保证每个转储线程能同时读取一个分片
+    uint32_t bufferNum = 0;
+    if (chunkSplitSize_ != 0) {
+        bufferNum = transferBufferPoolSizeMB_ * 1024 * 1024 / chunkSplitSize_;
+    }
+    bufferNum = std::max(bufferNum, snapshotCoreThreadNum_);
+    bufferPool_ = std::make_shared<TransferBufferPool>(
+        chunkSplitSize_, bufferNum);
     return kErrCodeSuccess;
 }
 
 int SnapshotCoreImpl::CreateSnapshotPre(const std::string &file,
     const std::string &user,
     const std::string &snapshotName,
+    CompressType compressType,
     SnapshotInfo *snapInfo) {
     NameLockGuard lockGuard(snapshotNameLock_, file);
     std::vector<SnapshotInfo> fileInfo;
@@ -112,6 +139,7 @@ int SnapshotCoreImpl::CreateSnapshotPre(const std::string &file,
 
     UUID uuid = UUIDGenerator().GenerateUUID();
     SnapshotInfo info(uuid, user, file, snapshotName);
+    info.SetCompressType(compressType);
     info.SetStatus(Status::pending);
     ret = metaStore_->AddSnapshot(info);
     if (ret < 0) {
@@ -285,20 +313,22 @@ void SnapshotCoreImpl::HandleCreateSnapshotTask(
     task->UpdateMetric();
 
     if (existIndexData) {
-        ret = TransferSnapshotData(indexData,
+        ret = TransferSnapshotData(&indexData,
             *info,
             segInfos,
             [this] (const ChunkDataName &chunkDataName) {
                 return dataStore_->ChunkDataExist(chunkDataName);
             },
+            fileSnapshotMap,
             task);
     } else {
-        ret = TransferSnapshotData(indexData,
+        ret = TransferSnapshotData(&indexData,
             *info,
             segInfos,
             [&fileSnapshotMap] (const ChunkDataName &chunkDataName) {
                 return fileSnapshotMap.IsExistChunk(chunkDataName);
             },
+            fileSnapshotMap,
             task);
     }
     if (ret < 0) {
@@ -386,7 +416,15 @@ void SnapshotCoreImpl::CancelAfterTransferSnapshotData(
     for (auto &chunkIndex : chunkIndexVec) {
         ChunkDataName chunkDataName;
         indexData.GetChunkDataName(chunkIndex, &chunkDataName);
-        if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
+        std::string hash;
+        if (indexData.GetChunkContent(chunkIndex, &hash)) {
+            int ret = ReleaseChunkContent(hash,
+                MakeChunkContentRef(task->GetUuid(), chunkIndex));
+            if (ret < 0) {
+                HandleCreateSnapshotError(task);
+                return;
+            }
+        } else if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
             (dataStore_->ChunkDataExist(chunkDataName))) {
             int ret =  dataStore_->DeleteChunkData(chunkDataName);
             if (ret < 0) {
@@ -773,10 +811,11 @@ int SnapshotCoreImpl::BuildSegmentInfo(
 }
 
 int SnapshotCoreImpl::TransferSnapshotData(
-    const ChunkIndexData indexData,
+    ChunkIndexData *indexData,
     const SnapshotInfo &info,
     const std::map<uint64_t, SegmentInfo> &segInfos,
     const ChunkDataExistFilter &filter,
+    const FileSnapMap &fileSnapshotMap,
     std::shared_ptr<SnapshotTaskInfo> task) {
     int ret = 0;
     uint64_t segmentSize = info.GetSegmentSize();
@@ -789,7 +828,7 @@ int SnapshotCoreImpl::TransferSnapshotData(
         return kErrCodeChunkSizeNotAligned;
     }
 
-    std::vector<ChunkIndexType> chunkIndexVec = indexData.GetAllChunkIndex();
+    std::vector<ChunkIndexType> chunkIndexVec = indexData->GetAllChunkIndex();
 
     uint32_t totalProgress = kProgressTransferSnapshotDataComplete -
         kProgressTransferSnapshotDataStart;
@@ -825,10 +864,48 @@ int SnapshotCoreImpl::TransferSnapshotData(
         }
     }
 
+    // 过滤条件只计算一次，同时确定需要转储的chunk的压缩算法，
+    // 压缩算法取自快照元数据，服务端配置变更不影响已创建的快照
+    CompressType snapCompressType = info.GetCompressType();
+    std::vector<bool> needTransfer(chunkIndexVec.size());
+    bool compressUpdated = false;
+    for (size_t i = 0; i < chunkIndexVec.size(); i++) {
+        ChunkDataName chunkDataName;
+        indexData->GetChunkDataName(chunkIndexVec[i], &chunkDataName);
+        needTransfer[i] = !filter(chunkDataName);
+        CompressType compressType;
+        if (needTransfer[i] && !enableChunkDedup_ &&
+            snapCompressType != CompressType::kNone &&
+            !indexData->GetChunkCompressType(chunkIndexVec[i],
+                &compressType)) {
+            indexData->PutChunkCompressType(chunkIndexVec[i],
+                snapCompressType);
+            compressUpdated = true;
+        }
+    }
+    // 压缩算法需要在对象写入之前记录到索引块中，转储中断后重试时，
+    // 已经存在的对象仍然能够按记录的算法读取
+    if (compressUpdated) {
+        ChunkIndexDataName name(task->GetFileName(), info.GetSeqNum());
+        ret = dataStore_->PutChunkIndexData(name, *indexData);
+        if (ret < 0) {
+            LOG(ERROR) << "PutChunkIndexData error, "
+                       << " ret = " << ret
+                       << ", uuid = " << task->GetUuid();
+            return ret;
+        }
+    }
+
+    task->SetTransferStartTime(TimeUtility::GetTimeofDayUs());
     auto tracker = std::make_shared<TaskTracker>();
-    for (auto &chunkIndex : chunkIndexVec) {
+    bool indexUpdated = false;
+    // 按内容去重的chunk转储完成后，需要将数据的hash记录到索引块中
+    std::vector<std::shared_ptr<TransferSnapshotDataChunkTaskInfo>>
+        dedupTaskInfos;
+    for (size_t i = 0; i < chunkIndexVec.size(); i++) {
+        ChunkIndexType chunkIndex = chunkIndexVec[i];
         ChunkDataName chunkDataName;
-        indexData.GetChunkDataName(chunkIndex, &chunkDataName);
+        indexData->GetChunkDataName(chunkIndex, &chunkDataName);
         uint64_t segNum = chunkIndex / chunkPerSegment;
         uint64_t chunkIndexInSegment = chunkIndex % chunkPerSegment;
 
@@ -836,13 +913,27 @@ int SnapshotCoreImpl::TransferSnapshotData(
         if (it != segInfos.end()) {
             ChunkIDInfo cidInfo =
                 it->second.chunkvec[chunkIndexInSegment];
-            if (!filter(chunkDataName)) {
+            std::string hash;
+            CompressType compressType;
+            if (needTransfer[i]) {
                 auto taskInfo =
                     std::make_shared<TransferSnapshotDataChunkTaskInfo>(
                         chunkDataName, chunkSize, cidInfo, chunkSplitSize_,
                         clientAsyncMethodRetryTimeSec_,
                         clientAsyncMethodRetryIntervalMs_,
-                        readChunkSnapshotConcurrency_);
+                        readChunkSnapshotConcurrency_,
+                        bufferPool_,
+                        uploadThreadPool_,
+                        task);
+                if (enableChunkDedup_) {
+                    taskInfo->EnableDedup(metaStore_,
+                        &chunkContentLock_,
+                        MakeChunkContentRef(task->GetUuid(), chunkIndex));
+                    dedupTaskInfos.push_back(taskInfo);
+                } else {
+                    indexData->GetChunkCompressType(chunkIndex,
+                        &taskInfo->compressType_);
+                }
                 UUID taskId = UUIDGenerator().GenerateUUID();
                 auto task = new TransferSnapshotDataChunkTask(
                     taskId,
@@ -852,6 +943,29 @@ int SnapshotCoreImpl::TransferSnapshotData(
                 task->SetTracker(tracker);
                 tracker->AddOneTrace();
                 threadPool_->PushTask(task);
+            } else if (fileSnapshotMap.GetChunkContent(chunkDataName, &hash)) {
+                // 之前的快照已经按内容去重保存了相同的chunk，引用同一份数据
+                if (!hash.empty()) {
+                    NameLockGuard lockGuard(chunkContentLock_, hash);
+                    ret = metaStore_->AddChunkDataRef(hash,
+                        MakeChunkContentRef(task->GetUuid(), chunkIndex));
+                    if (ret < 0) {
+                        LOG(ERROR) << "AddChunkDataRef fail"
+                                   << ", ret = " << ret
+                                   << ", hash = " << hash
+                                   << ", chunkDataName = "
+                                   << chunkDataName.ToDataChunkKey()
+                                   << ", uuid = " << task->GetUuid();
+                        break;
+                    }
+                }
+                indexData->PutChunkContent(chunkIndex, hash);
+                indexUpdated = true;
+            } else if (fileSnapshotMap.GetChunkCompressType(chunkDataName,
+                &compressType)) {
+                // 引用之前快照的压缩对象
+                indexData->PutChunkCompressType(chunkIndex, compressType);
+                indexUpdated = true;
             } else {
                 DLOG(INFO) << "find data object exist, skip chunkDataName = "
                            << chunkDataName.ToDataChunkKey();
@@ -865,7 +979,7 @@ int SnapshotCoreImpl::TransferSnapshotData(
             LOG(ERROR) << "TransferSnapshotDataChunk tracker GetResult fail"
                        << ", ret = " << ret
                        << ", uuid = " << task->GetUuid();
-            return ret;
+            break;
         }
 
         task->SetProgress(static_cast<uint32_t>(
@@ -873,22 +987,79 @@ int SnapshotCoreImpl::TransferSnapshotData(
         task->UpdateMetric();
         index++;
         if (task->IsCanceled()) {
-            return kErrCodeSuccess;
+            break;
         }
     }
-    // 最后剩余数量不足的任务
+    // 最后剩余数量不足的任务，失败或取消时也需要等待已提交的任务结束，
+    // 使已经增加的共享数据引用能够记录到索引块中
     tracker->Wait();
-    ret = tracker->GetResult();
+    if (ret >= 0) {
+        ret = tracker->GetResult();
+        if (ret < 0) {
+            LOG(ERROR) << "TransferSnapshotDataChunk tracker GetResult fail"
+                       << ", ret = " << ret
+                       << ", uuid = " << task->GetUuid();
+        }
+    }
+
+    for (auto &taskInfo : dedupTaskInfos) {
+        if (taskInfo->contentDone_) {
+            indexData->PutChunkContent(taskInfo->name_.chunkIndex_,
+                taskInfo->contentHash_);
+            indexUpdated = true;
+        }
+    }
+    if (indexUpdated) {
+        ChunkIndexDataName name(task->GetFileName(), info.GetSeqNum());
+        int ret2 = dataStore_->PutChunkIndexData(name, *indexData);
+        if (ret2 < 0) {
+            LOG(ERROR) << "PutChunkIndexData error, "
+                       << " ret = " << ret2
+                       << ", uuid = " << task->GetUuid();
+            return ret2;
+        }
+    }
     if (ret < 0) {
-        LOG(ERROR) << "TransferSnapshotDataChunk tracker GetResult fail"
-                   << ", ret = " << ret
-                   << ", uuid = " << task->GetUuid();
         return ret;
     }
-
     return kErrCodeSuccess;
 }
 
+int SnapshotCoreImpl::ReleaseChunkContent(const std::string &hash,
+    const std::string &ref) {
+    // 全零的chunk没有保存数据
+    if (hash.empty()) {
+        return kErrCodeSuccess;
+    }
+    NameLockGuard lockGuard(chunkContentLock_, hash);
+    int ret = metaStore_->DeleteChunkDataRef(hash, ref);
+    if (ret < 0) {
+        LOG(ERROR) << "DeleteChunkDataRef error"
+                   << ", ret = " << ret
+                   << ", hash = " << hash
+                   << ", ref = " << ref;
+        return ret;
+    }
+    uint32_t refCount = 0;
+    ret = metaStore_->GetChunkDataRefCount(hash, &refCount);
+    if (ret < 0) {
+        LOG(ERROR) << "GetChunkDataRefCount error"
+                   << ", ret = " << ret
+                   << ", hash = " << hash;
+        return ret;
+    }
+    ChunkDataName contentName = ToContentChunkDataName(hash);
+    if (0 == refCount && dataStore_->ChunkDataExist(contentName)) {
+        ret = dataStore_->DeleteChunkData(contentName);
+        if (ret < 0) {
+            LOG(ERROR) << "DeleteChunkData error"
+                       << ", ret = " << ret
+                       << ", hash = " << hash;
+            return ret;
+        }
+    }
+    return kErrCodeSuccess;
+}
 
 int SnapshotCoreImpl::DeleteSnapshotPre(
     UUID uuid,
@@ -1006,7 +1177,15 @@ void SnapshotCoreImpl::HandleDeleteSnapshotTask(
         for (auto &chunkIndex : chunkIndexVec) {
             ChunkDataName chunkDataName;
             indexData.GetChunkDataName(chunkIndex, &chunkDataName);
-            if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
+            std::string hash;
+            if (indexData.GetChunkContent(chunkIndex, &hash)) {
+                ret = ReleaseChunkContent(hash,
+                    MakeChunkContentRef(uuid, chunkIndex));
+                if (ret < 0) {
+                    HandleDeleteSnapshotError(task);
+                    return;
+                }
+            } else if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
                 (dataStore_->ChunkDataExist(chunkDataName))) {
                 ret =  dataStore_->DeleteChunkData(chunkDataName);
                 if (ret < 0) {
@@ -43,6 +43,7 @@ namespace curve {
 namespace snapshotcloneserver {
 
 class SnapshotTaskInfo;
+class TransferBufferPool;
 
 /**
  * @brief 文件的快照索引块映射表
@@ -68,6 +69,45 @@ struct FileSnapMap {
         }
         return find;
     }
+
+    /**
+     * @brief 获取映射表中相同chunk数据按内容去重保存的hash
+     *
+     * @param name chunk数据对象
+     * @param[out] hash chunk数据的hash
+     *
+     * @retval true 存在
+     * @retval false 不存在或者没有按内容去重保存
+     */
+    bool GetChunkContent(const ChunkDataName &name, std::string *hash) const {
+        for (auto &v : maps) {
+            if (v.IsExistChunkDataName(name) &&
+                v.GetChunkContent(name.chunkIndex_, hash)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 获取映射表中相同chunk数据对象的压缩算法
+     *
+     * @param name chunk数据对象
+     * @param[out] type 压缩算法
+     *
+     * @retval true 存在且压缩保存
+     * @retval false 不存在或者没有压缩
+     */
+    bool GetChunkCompressType(const ChunkDataName &name,
+        CompressType *type) const {
+        for (auto &v : maps) {
+            if (v.IsExistChunkDataName(name) &&
+                v.GetChunkCompressType(name.chunkIndex_, type)) {
+                return true;
+            }
+        }
+        return false;
+    }
 };
 
 /**
@@ -84,6 +124,7 @@ class SnapshotCore {
      * @param file 文件名
      * @param user 用户名
      * @param snapshotName 快照名
+     * @param compressType 快照chunk对象的压缩算法，记录在快照元数据中
      * @param[out] snapInfo 快照信息
      *
      * @return 错误码
@@ -91,6 +132,7 @@ class SnapshotCore {
     virtual int CreateSnapshotPre(const std::string &file,
         const std::string &user,
         const std::string &snapshotName,
+        CompressType compressType,
         SnapshotInfo *snapInfo) = 0;
 
     /**
@@ -195,21 +237,27 @@ class SnapshotCoreImpl : public SnapshotCore {
       clientAsyncMethodRetryTimeSec_(option.clientAsyncMethodRetryTimeSec),
       clientAsyncMethodRetryIntervalMs_(
                 option.clientAsyncMethodRetryIntervalMs),
-      readChunkSnapshotConcurrency_(option.readChunkSnapshotConcurrency) {
+      readChunkSnapshotConcurrency_(option.readChunkSnapshotConcurrency),
+      transferBufferPoolSizeMB_(option.transferBufferPoolSizeMB),
+      enableChunkDedup_(option.enableChunkDedup) {
         threadPool_ = std::make_shared<ThreadPool>(
             option.snapshotCoreThreadNum);
+        uploadThreadPool_ = std::make_shared<ThreadPool>(
+            option.transferUploadPartConcurrency);
     }
 
     int Init();
 
     ~SnapshotCoreImpl() {
         threadPool_->Stop();
+        uploadThreadPool_->Stop();
     }
 
     // 公有接口定义见SnapshotCore接口注释
     int CreateSnapshotPre(const std::string &file,
         const std::string &user,
         const std::string &snapshotName,
+        CompressType compressType,
         SnapshotInfo *snapInfo) override;
 
     void HandleCreateSnapshotTask(
@@ -308,19 +356,21 @@ class SnapshotCoreImpl : public SnapshotCore {
     /**
      * @brief 转储快照过程
      *
-     * @param indexData 索引块
+     * @param[in,out] indexData 索引块，按内容去重时记录chunk数据的hash
      * @param info 快照信息
      * @param segInfos Segment信息
      * @param filter 转储数据块过滤器
+     * @param fileSnapshotMap 快照文件映射表
      * @param task 快照任务信息
      *
      * @return  错误码
      */
     int TransferSnapshotData(
-        const ChunkIndexData indexData,
+        ChunkIndexData *indexData,
         const SnapshotInfo &info,
         const std::map<uint64_t, SegmentInfo> &segInfos,
         const ChunkDataExistFilter &filter,
+        const FileSnapMap &fileSnapshotMap,
         std::shared_ptr<SnapshotTaskInfo> task);
 
     /**
@@ -403,6 +453,17 @@ class SnapshotCoreImpl : public SnapshotCore {
     int ClearErrorSnapBeforeCreateSnapshot(
         std::shared_ptr<SnapshotTaskInfo> task);
 
+    /**
+     * @brief 释放chunk对共享数据的引用，没有引用时删除共享数据
+     *
+     * @param hash chunk数据的hash
+     * @param ref chunk对共享数据的引用
+     *
+     * @return 错误码
+     */
+    int ReleaseChunkContent(const std::string &hash,
+        const std::string &ref);
+
  private:
     // curvefs客户端对象
     std::shared_ptr<CurveFsClient> client_;
@@ -415,9 +476,15 @@ class SnapshotCoreImpl : public SnapshotCore {
 
     // 执行并发步骤的线程池
     std::shared_ptr<ThreadPool> threadPool_;
+    // 上传转储分片的线程池，读取分片和上传分片并行进行
+    std::shared_ptr<ThreadPool> uploadThreadPool_;
+    // 转储分片的缓冲区池
+    std::shared_ptr<TransferBufferPool> bufferPool_;
 
     // 锁住打快照的文件名，防止并发同时对其打快照，同一文件的快照需排队
     NameLock snapshotNameLock_;
+    // 锁住chunk数据的hash，互斥共享数据的上传、引用和删除
+    NameLock chunkContentLock_;
 
     // 转储chunk分片大小
     uint64_t chunkSplitSize_;
@@ -435,6 +502,10 @@ class SnapshotCoreImpl : public SnapshotCore {
     uint64_t clientAsyncMethodRetryIntervalMs_;
     // 异步ReadChunkSnapshot的并发数
     uint32_t readChunkSnapshotConcurrency_;
+    // 转储分片缓冲区的总大小(MB)
+    uint64_t transferBufferPoolSizeMB_;
+    // 是否按内容去重保存chunk数据
+    bool enableChunkDedup_;
 };
 
 }  // namespace snapshotcloneserver
@@ -65,6 +65,13 @@ bool ChunkIndexData::Serialize(std::string *data) const {
                 ChunkDataName(fileName_, m.second, m.first).
                 ToDataChunkKey()});
     }
+    for (const auto &m : this->contentMap_) {
+        map.mutable_contentmap()->insert({m.first, m.second});
+    }
+    for (const auto &m : this->compressMap_) {
+        map.mutable_compressmap()->insert(
+            {m.first, static_cast<uint32_t>(m.second)});
+    }
     // Todo：可以转化为stream给adpater接口使用SerializeToOstream
     return map.SerializeToString(data);
 }
@@ -82,6 +89,13 @@ bool ChunkIndexData::Unserialize(const std::string &data) {
                 return false;
             }
         }
+        for (const auto &m : map.contentmap()) {
+            this->contentMap_.emplace(m.first, m.second);
+        }
+        for (const auto &m : map.compressmap()) {
+            this->compressMap_.emplace(m.first,
+                static_cast<CompressType>(m.second));
+        }
         return true;
     } else {
         return false;
@@ -99,6 +113,26 @@ bool ChunkIndexData::GetChunkDataName(ChunkIndexType index,
     }
 }
 
+bool ChunkIndexData::GetChunkContent(ChunkIndexType index,
+    std::string *hash) const {
+    auto it = contentMap_.find(index);
+    if (it == contentMap_.end()) {
+        return false;
+    }
+    *hash = it->second;
+    return true;
+}
+
+bool ChunkIndexData::GetChunkCompressType(ChunkIndexType index,
+    CompressType *type) const {
+    auto it = compressMap_.find(index);
+    if (it == compressMap_.end()) {
+        return false;
+    }
+    *type = it->second;
+    return true;
+}
+
 bool ChunkIndexData::IsExistChunkDataName(const ChunkDataName &name) const {
     if (fileName_ != name.fileName_) {
         return false;
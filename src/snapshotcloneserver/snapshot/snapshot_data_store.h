@@ -32,10 +32,12 @@
 #include <string>
 #include <memory>
 
+#include "src/common/compression.h"
 #include "src/common/concurrent/concurrent.h"
 
 using ::curve::common::SpinLock;
 using ::curve::common::LockGuard;
+using ::curve::common::CompressType;
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -90,6 +92,20 @@ inline bool operator==(const ChunkDataName &lhs, const ChunkDataName &rhs) {
  */
 bool ToChunkDataName(const std::string &name, ChunkDataName *cName);
 
+// 内容去重的chunk数据对象的文件名前缀，curve的文件名以"/"开头，不会冲突
+const char kChunkContentNamePrefix[] = "content_";
+
+/**
+ * @brief 内容去重时保存chunk数据的对象，由所有内容相同的chunk共享
+ *
+ * @param hash chunk数据的hash
+ *
+ * @return chunk数据对象名
+ */
+inline ChunkDataName ToContentChunkDataName(const std::string &hash) {
+    return ChunkDataName(kChunkContentNamePrefix + hash, 0, 0);
+}
+
 class ChunkIndexDataName {
  public:
     ChunkIndexDataName()
@@ -136,6 +152,41 @@ class ChunkIndexData {
         chunkMap_.emplace(name.chunkIndex_, name.chunkSeqNum_);
     }
 
+    /**
+     * @brief 记录chunk数据的hash，数据保存在hash对应的共享对象中
+     *
+     * @param index chunk索引
+     * @param hash chunk数据的hash，为空表示全零的chunk
+     */
+    void PutChunkContent(ChunkIndexType index, const std::string &hash) {
+        contentMap_[index] = hash;
+    }
+
+    /**
+     * @brief 获取chunk数据的hash
+     *
+     * @return chunk按内容去重保存返回true，否则数据保存在
+     *         GetChunkDataName对应的对象中
+     */
+    bool GetChunkContent(ChunkIndexType index, std::string *hash) const;
+
+    /**
+     * @brief 记录chunk对象的压缩算法，对象格式见CompressedObject
+     *
+     * @param index chunk索引
+     * @param type 压缩算法
+     */
+    void PutChunkCompressType(ChunkIndexType index, CompressType type) {
+        compressMap_[index] = type;
+    }
+
+    /**
+     * @brief 获取chunk对象的压缩算法
+     *
+     * @return chunk对象压缩保存返回true
+     */
+    bool GetChunkCompressType(ChunkIndexType index, CompressType *type) const;
+
     bool GetChunkDataName(ChunkIndexType index, ChunkDataName* nameOut) const;
 
     bool IsExistChunkDataName(const ChunkDataName &name) const;
@@ -155,6 +206,10 @@ class ChunkIndexData {
     std::string fileName_;
     // 快照文件索引信息map
     std::map<ChunkIndexType, SnapshotSeqType> chunkMap_;
+    // 按内容去重保存的chunk的数据hash
+    std::map<ChunkIndexType, std::string> contentMap_;
+    // 压缩保存的chunk对象的压缩算法
+    std::map<ChunkIndexType, CompressType> compressMap_;
 };
 
 
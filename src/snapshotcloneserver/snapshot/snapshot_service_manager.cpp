@@ -29,6 +29,7 @@ namespace curve {
 namespace snapshotcloneserver {
 
 int SnapshotServiceManager::Init(const SnapshotCloneServerOptions &option) {
+    defaultCompressType_ = option.snapshotCompressType;
     std::shared_ptr<ThreadPool> pool =
         std::make_shared<ThreadPool>(option.snapshotPoolThreadNum);
     return taskMgr_->Init(pool, option);
@@ -45,9 +46,20 @@ void SnapshotServiceManager::Stop() {
 int SnapshotServiceManager::CreateSnapshot(const std::string &file,
     const std::string &user,
     const std::string &snapshotName,
+    const std::string &compressType,
     UUID *uuid) {
+    CompressType type = defaultCompressType_;
+    if (!compressType.empty() &&
+        !curve::common::StringToCompressType(compressType, &type)) {
+        LOG(ERROR) << "CreateSnapshot invalid compressType, "
+                   << "file = " << file
+                   << ", snapshotName = " << snapshotName
+                   << ", compressType = " << compressType;
+        return kErrCodeInvalidRequest;
+    }
     SnapshotInfo snapInfo;
-    int ret = core_->CreateSnapshotPre(file, user, snapshotName, &snapInfo);
+    int ret = core_->CreateSnapshotPre(file, user, snapshotName, type,
+        &snapInfo);
     if (ret < 0) {
         if (kErrCodeTaskExist == ret) {
             // 任务已存在的情况下返回成功，使接口幂等
@@ -81,6 +81,8 @@ class FileSnapshotInfo {
         fileSnapObj["Name"] = snap.GetSnapshotName();
         fileSnapObj["Time"] = snap.GetCreateTime();
         fileSnapObj["FileLength"] = snap.GetFileLength();
+        fileSnapObj["CompressType"] =
+            curve::common::CompressTypeToString(snap.GetCompressType());
         fileSnapObj["Status"] = static_cast<int>(snap.GetStatus());
         fileSnapObj["Progress"] = GetSnapProgress();
         return fileSnapObj;
@@ -95,6 +97,12 @@ class FileSnapshotInfo {
         snapInfo.SetSnapshotName(jsonObj["Name"].asString());
         snapInfo.SetCreateTime(jsonObj["Time"].asUInt64());
         snapInfo.SetFileLength(jsonObj["FileLength"].asUInt64());
+        CompressType compressType = CompressType::kNone;
+        if (jsonObj.isMember("CompressType")) {
+            curve::common::StringToCompressType(
+                jsonObj["CompressType"].asString(), &compressType);
+        }
+        snapInfo.SetCompressType(compressType);
         snapInfo.SetStatus(static_cast<Status>(jsonObj["Status"].asUInt()));
         SetSnapshotInfo(snapInfo);
         SetSnapProgress(jsonObj["Progress"].asUInt());
@@ -160,7 +168,8 @@ class SnapshotServiceManager {
         std::shared_ptr<SnapshotTaskManager> taskMgr,
         std::shared_ptr<SnapshotCore> core)
           : taskMgr_(taskMgr),
-            core_(core) {}
+            core_(core),
+            defaultCompressType_(CompressType::kNone) {}
 
     virtual ~SnapshotServiceManager() {}
 
@@ -190,6 +199,7 @@ class SnapshotServiceManager {
      * @param file 文件名
      * @param user 文件所属用户
      * @param snapshotName 快照名
+     * @param compressType 压缩算法名称，为空时使用服务端默认配置
      * @param uuid 快照uuid
      *
      * @return 错误码
@@ -197,6 +207,7 @@ class SnapshotServiceManager {
     virtual int CreateSnapshot(const std::string &file,
         const std::string &user,
         const std::string &snapshotName,
+        const std::string &compressType,
         UUID *uuid);
 
     /**
@@ -305,6 +316,8 @@ class SnapshotServiceManager {
     std::shared_ptr<SnapshotTaskManager> taskMgr_;
     // 快照核心模块
     std::shared_ptr<SnapshotCore> core_;
+    // 创建快照未指定压缩算法时使用的默认值
+    CompressType defaultCompressType_;
 };
 
 }  // namespace snapshotcloneserver
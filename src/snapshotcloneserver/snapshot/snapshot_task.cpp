@@ -20,14 +20,81 @@
  * Author: xuchaojie
  */
 
+#include <openssl/sha.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <list>
+#include <string>
 
+#include "src/common/compression.h"
+#include "src/common/concurrent/name_lock.h"
 #include "src/common/timeutility.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_task.h"
 
+using ::curve::common::CompressedObject;
+using ::curve::common::CompressTypeToString;
+using ::curve::common::NameLockGuard;
+
 namespace curve {
 namespace snapshotcloneserver {
 
+namespace {
+
+// 等待缓冲区的超时时间，超时后先处理已完成的读取结果
+const uint32_t kWaitBufferMs = 100;
+
+bool IsZeroChunk(const char *buf, uint64_t len) {
+    return len == 0 ||
+        (buf[0] == 0 && memcmp(buf, buf + 1, len - 1) == 0);
+}
+
+std::string ComputeChunkContentHash(const char *buf, uint64_t len) {
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char *>(buf), len, digest);
+    static const char kHex[] = "0123456789abcdef";
+    std::string hash;
+    hash.reserve(2 * SHA256_DIGEST_LENGTH);
+    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+        hash.push_back(kHex[digest[i] >> 4]);
+        hash.push_back(kHex[digest[i] & 0xf]);
+    }
+    return hash;
+}
+
+}  // namespace
+
+bool TransferBufferPool::Get(uint32_t waitMs, std::unique_ptr<char[]> *buf) {
+    std::unique_lock<Mutex> lk(mtx_);
+    if (freeBuffers_.empty() && allocated_ >= maxBufferNum_) {
+        cv_.wait_for(lk, std::chrono::milliseconds(waitMs), [this]() {
+            return !freeBuffers_.empty() || allocated_ < maxBufferNum_;
+        });
+    }
+
+    if (!freeBuffers_.empty()) {
+        *buf = std::move(freeBuffers_.back());
+        freeBuffers_.pop_back();
+        return true;
+    }
+    if (allocated_ < maxBufferNum_) {
+        ++allocated_;
+        lk.unlock();
+        buf->reset(new char[bufferSize_]);
+        return true;
+    }
+    return false;
+}
+
+void TransferBufferPool::Put(std::unique_ptr<char[]> buf) {
+    {
+        std::lock_guard<Mutex> lk(mtx_);
+        freeBuffers_.emplace_back(std::move(buf));
+    }
+    cv_.notify_one();
+}
+
 void ReadChunkSnapshotClosure::Run() {
     std::unique_ptr<ReadChunkSnapshotClosure> self_guard(this);
     context_->retCode = GetRetCode();
@@ -45,25 +112,55 @@ void ReadChunkSnapshotClosure::Run() {
     return;
 }
 
+void TransferSnapshotDataPartTask::Run() {
+    std::unique_ptr<TransferSnapshotDataPartTask> self_guard(this);
+    int ret = dataStore_->DataChunkTranferAddPart(
+        taskInfo_->name_,
+        transferTask_,
+        context_->partIndex,
+        context_->len,
+        context_->buf.get());
+    if (ret < 0) {
+        LOG(ERROR) << "DataChunkTranferAddPart fail"
+                   << ", ret = " << ret
+                   << ", chunkDataName = "
+                   << taskInfo_->name_.ToDataChunkKey()
+                   << ", index = " << context_->partIndex;
+    } else if (taskInfo_->snapshotTask_ != nullptr) {
+        taskInfo_->snapshotTask_->AddTransferBytes(context_->len);
+    }
+    // 先归还缓冲区，等待缓冲区的转储任务可以尽快继续读取
+    context_.reset();
+    GetTracker()->HandleResponse(ret);
+}
+
 /**
  * @brief 转储快照的单个chunk
  * @detail
  *  由于单个chunk过大，chunk转储分片进行，分片大小为chunkSplitSize_，
  *  步骤如下：
  *  1. 创建一个转储任务transferTask，并调用DataChunkTranferInit初始化
- *  2. 调用ReadChunkSnapshot从curvefs读取chunk的一个分片
- *  3. 调用DataChunkTranferAddPart转储一个分片
- *  4. 重复2、3直到所有分片转储完成，调用DataChunkTranferComplete结束转储任务
- *  5. 中间如有读取或转储发生错误，则调用DataChunkTranferAbort放弃转储，
- *  并返回错误码
+ *  2. 从缓冲区池获取缓冲区，调用ReadChunkSnapshot从curvefs读取chunk的一个分片
+ *  3. 读取完成的分片交给上传线程池，异步调用DataChunkTranferAddPart转储
+ *  4. 重复2、3直到所有分片读取完成，等待所有分片上传完成后，
+ *  调用DataChunkTranferComplete结束转储任务
+ *  5. 中间如有读取或转储发生错误，等待已提交的上传结束后
+ *  调用DataChunkTranferAbort放弃转储，并返回错误码
+ *
+ *  读取和上传并行进行，同时读取和上传中的分片总数由缓冲区池限制
  *
  * @return 错误码
  */
 int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
+    if (taskInfo_->enableDedup_) {
+        return TransferSnapshotDataChunkDedup();
+    }
+    if (taskInfo_->compressType_ != CompressType::kNone) {
+        return TransferSnapshotDataChunkCompressed();
+    }
+
     ChunkDataName name = taskInfo_->name_;
-    uint64_t chunkSize = taskInfo_->chunkSize_;
     ChunkIDInfo cidInfo = taskInfo_->cidInfo_;
-    uint64_t chunkSplitSize = taskInfo_->chunkSplitSize_;
 
     std::shared_ptr<TransferTask> transferTask =
         std::make_shared<TransferTask>();
@@ -79,49 +176,12 @@ int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
         return ret;
     }
 
-    auto tracker = std::make_shared<ReadChunkSnapshotTaskTracker>();
-    for (uint64_t i = 0;
-        i < chunkSize / chunkSplitSize;
-        i++) {
-        auto context = std::make_shared<ReadChunkSnapshotContext>();
-        context->cidInfo = taskInfo_->cidInfo_;
-        context->seqNum = taskInfo_->name_.chunkSeqNum_;
-        context->partIndex = i;
-        context->buf = std::unique_ptr<char[]>(new char[chunkSplitSize]);
-        context->len = chunkSplitSize;
-        context->startTime = TimeUtility::GetTimeofDaySec();
-        context->clientAsyncMethodRetryTimeSec =
-            taskInfo_->clientAsyncMethodRetryTimeSec_;
-        ret = StartAsyncReadChunkSnapshot(tracker, context);
-        if (ret < 0) {
-            break;
-        }
-        if (tracker->GetTaskNum() >= taskInfo_->readChunkSnapshotConcurrency_) {
-            tracker->WaitSome(1);
-        }
-        std::list<ReadChunkSnapshotContextPtr> results =
-            tracker->PopResultContexts();
-        ret = HandleReadChunkSnapshotResultsAndRetry(
-            tracker, transferTask, results);
-        if (ret < 0) {
-            break;
-        }
-    }
+    auto uploadTracker = std::make_shared<TaskTracker>();
+    ret = ReadChunkSnapshotParts(uploadTracker, transferTask);
+    // 已提交的上传需要全部结束之后才能结束或放弃转储任务
+    uploadTracker->Wait();
     if (ret >= 0) {
-        do {
-            tracker->WaitSome(1);
-            std::list<ReadChunkSnapshotContextPtr> results =
-                tracker->PopResultContexts();
-            if (0 == results.size()) {
-                // 已经完成，没有新的结果了
-                break;
-            }
-            ret = HandleReadChunkSnapshotResultsAndRetry(
-                tracker, transferTask, results);
-            if (ret < 0) {
-                break;
-            }
-        } while (true);
+        ret = uploadTracker->GetResult();
         if (ret >= 0) {
             ret =
                 dataStore_->DataChunkTranferComplete(name, transferTask);
@@ -153,6 +213,227 @@ int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
     return kErrCodeSuccess;
 }
 
+/**
+ * @brief 按内容去重转储快照的单个chunk
+ * @detail
+ *  1. 读取整个chunk的数据
+ *  2. 全零的chunk不保存数据，只在索引中记录空的hash
+ *  3. 计算chunk数据的hash，持有hash锁检查共享对象的引用计数，
+ *  没有引用时上传数据到hash对应的共享对象，之后增加本chunk的引用
+ *
+ *  引用以快照和chunk索引为key，重试转储时重复增加引用是幂等的
+ *
+ * @return 错误码
+ */
+int TransferSnapshotDataChunkTask::TransferSnapshotDataChunkDedup() {
+    uint64_t chunkSize = taskInfo_->chunkSize_;
+    ChunkIDInfo cidInfo = taskInfo_->cidInfo_;
+    auto snapshotTask = taskInfo_->snapshotTask_;
+
+    chunkBuf_.reset(new char[chunkSize]);
+    auto uploadTracker = std::make_shared<TaskTracker>();
+    int ret = ReadChunkSnapshotParts(uploadTracker, nullptr);
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (IsZeroChunk(chunkBuf_.get(), chunkSize)) {
+        taskInfo_->contentHash_.clear();
+        taskInfo_->contentDone_ = true;
+        if (snapshotTask != nullptr) {
+            snapshotTask->AddDedupBytes(chunkSize);
+        }
+        return kErrCodeSuccess;
+    }
+
+    std::string hash = ComputeChunkContentHash(chunkBuf_.get(), chunkSize);
+    NameLockGuard lockGuard(*taskInfo_->contentLock_, hash);
+    uint32_t refCount = 0;
+    ret = taskInfo_->metaStore_->GetChunkDataRefCount(hash, &refCount);
+    if (ret < 0) {
+        LOG(ERROR) << "GetChunkDataRefCount fail"
+                   << ", ret = " << ret
+                   << ", hash = " << hash
+                   << ", chunkDataName = "
+                   << taskInfo_->name_.ToDataChunkKey();
+        return ret;
+    }
+    if (0 == refCount) {
+        ret = UploadChunkObject(ToContentChunkDataName(hash),
+            chunkBuf_.get(), chunkSize, taskInfo_->chunkSplitSize_);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    ret = taskInfo_->metaStore_->AddChunkDataRef(hash, taskInfo_->contentRef_);
+    if (ret < 0) {
+        LOG(ERROR) << "AddChunkDataRef fail"
+                   << ", ret = " << ret
+                   << ", hash = " << hash
+                   << ", ref = " << taskInfo_->contentRef_
+                   << ", logicalPool = " << cidInfo.lpid_
+                   << ", copysetId = " << cidInfo.cpid_
+                   << ", chunkId = " << cidInfo.cid_;
+        return ret;
+    }
+    taskInfo_->contentHash_ = hash;
+    taskInfo_->contentDone_ = true;
+    if (snapshotTask != nullptr && refCount > 0) {
+        snapshotTask->AddDedupBytes(chunkSize);
+    }
+    return kErrCodeSuccess;
+}
+
+/**
+ * @brief 压缩转储快照的单个chunk
+ * @detail
+ *  读取整个chunk的数据后按chunkSplitSize_分帧压缩，压缩后的对象
+ *  作为一个分片上传，对象格式见CompressedObject
+ *
+ * @return 错误码
+ */
+int TransferSnapshotDataChunkTask::TransferSnapshotDataChunkCompressed() {
+    uint64_t chunkSize = taskInfo_->chunkSize_;
+    ChunkIDInfo cidInfo = taskInfo_->cidInfo_;
+
+    chunkBuf_.reset(new char[chunkSize]);
+    auto uploadTracker = std::make_shared<TaskTracker>();
+    int ret = ReadChunkSnapshotParts(uploadTracker, nullptr);
+    if (ret < 0) {
+        return ret;
+    }
+
+    std::string obj;
+    if (!CompressedObject::Encode(taskInfo_->compressType_,
+            taskInfo_->chunkSplitSize_, chunkBuf_.get(), chunkSize, &obj)) {
+        LOG(ERROR) << "Compress chunk fail"
+                   << ", compressType = "
+                   << CompressTypeToString(taskInfo_->compressType_)
+                   << ", chunkDataName = "
+                   << taskInfo_->name_.ToDataChunkKey()
+                   << ", logicalPool = " << cidInfo.lpid_
+                   << ", copysetId = " << cidInfo.cpid_
+                   << ", chunkId = " << cidInfo.cid_;
+        return kErrCodeInternalError;
+    }
+    // 原始数据已经不再需要
+    chunkBuf_.reset();
+    return UploadChunkObject(taskInfo_->name_, obj.data(), obj.size(),
+        obj.size());
+}
+
+int TransferSnapshotDataChunkTask::UploadChunkObject(
+    const ChunkDataName &name,
+    const char *buf,
+    uint64_t len,
+    uint64_t partSize) {
+    std::shared_ptr<TransferTask> transferTask =
+        std::make_shared<TransferTask>();
+    int ret = dataStore_->DataChunkTranferInit(name, transferTask);
+    if (ret < 0) {
+        LOG(ERROR) << "DataChunkTranferInit error, "
+                   << " ret = " << ret
+                   << ", chunkDataName = " << name.ToDataChunkKey();
+        return ret;
+    }
+    for (uint64_t i = 0; i * partSize < len; i++) {
+        uint64_t offset = i * partSize;
+        ret = dataStore_->DataChunkTranferAddPart(name,
+            transferTask,
+            i,
+            std::min(partSize, len - offset),
+            buf + offset);
+        if (ret < 0) {
+            LOG(ERROR) << "DataChunkTranferAddPart fail"
+                       << ", ret = " << ret
+                       << ", chunkDataName = " << name.ToDataChunkKey()
+                       << ", index = " << i;
+            break;
+        }
+    }
+    if (ret >= 0) {
+        ret = dataStore_->DataChunkTranferComplete(name, transferTask);
+        if (ret < 0) {
+            LOG(ERROR) << "DataChunkTranferComplete fail"
+                       << ", ret = " << ret
+                       << ", chunkDataName = " << name.ToDataChunkKey();
+        }
+    }
+    if (ret < 0) {
+        int ret2 = dataStore_->DataChunkTranferAbort(name, transferTask);
+        if (ret2 < 0) {
+            LOG(ERROR) << "DataChunkTranferAbort fail"
+                       << ", ret = " << ret2
+                       << ", chunkDataName = " << name.ToDataChunkKey();
+        }
+        return ret;
+    }
+    if (taskInfo_->snapshotTask_ != nullptr) {
+        taskInfo_->snapshotTask_->AddTransferBytes(len);
+    }
+    return kErrCodeSuccess;
+}
+
+int TransferSnapshotDataChunkTask::ReadChunkSnapshotParts(
+    std::shared_ptr<TaskTracker> uploadTracker,
+    std::shared_ptr<TransferTask> transferTask) {
+    uint64_t chunkSize = taskInfo_->chunkSize_;
+    uint64_t chunkSplitSize = taskInfo_->chunkSplitSize_;
+    int ret = kErrCodeSuccess;
+
+    auto tracker = std::make_shared<ReadChunkSnapshotTaskTracker>();
+    for (uint64_t i = 0;
+        i < chunkSize / chunkSplitSize;
+        i++) {
+        auto context = std::make_shared<ReadChunkSnapshotContext>();
+        context->cidInfo = taskInfo_->cidInfo_;
+        context->seqNum = taskInfo_->name_.chunkSeqNum_;
+        context->partIndex = i;
+        context->bufferPool = taskInfo_->bufferPool_;
+        ret = AllocateBuffer(tracker, uploadTracker, transferTask, context);
+        if (ret < 0) {
+            return ret;
+        }
+        context->len = chunkSplitSize;
+        context->startTime = TimeUtility::GetTimeofDaySec();
+        context->clientAsyncMethodRetryTimeSec =
+            taskInfo_->clientAsyncMethodRetryTimeSec_;
+        ret = StartAsyncReadChunkSnapshot(tracker, context);
+        if (ret < 0) {
+            return ret;
+        }
+        if (tracker->GetTaskNum() >= taskInfo_->readChunkSnapshotConcurrency_) {
+            tracker->WaitSome(1);
+        }
+        std::list<ReadChunkSnapshotContextPtr> results =
+            tracker->PopResultContexts();
+        ret = HandleReadChunkSnapshotResultsAndRetry(
+            tracker, uploadTracker, transferTask, results);
+        if (ret < 0) {
+            return ret;
+        }
+        ret = uploadTracker->GetResult();
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    do {
+        tracker->WaitSome(1);
+        std::list<ReadChunkSnapshotContextPtr> results =
+            tracker->PopResultContexts();
+        if (0 == results.size()) {
+            // 已经完成，没有新的结果了
+            break;
+        }
+        ret = HandleReadChunkSnapshotResultsAndRetry(
+            tracker, uploadTracker, transferTask, results);
+        if (ret < 0) {
+            return ret;
+        }
+    } while (true);
+    return kErrCodeSuccess;
+}
+
 int TransferSnapshotDataChunkTask::StartAsyncReadChunkSnapshot(
     std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
     std::shared_ptr<ReadChunkSnapshotContext> context) {
@@ -186,8 +467,32 @@ int TransferSnapshotDataChunkTask::StartAsyncReadChunkSnapshot(
     return kErrCodeSuccess;
 }
 
+int TransferSnapshotDataChunkTask::AllocateBuffer(
+    std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
+    std::shared_ptr<TaskTracker> uploadTracker,
+    std::shared_ptr<TransferTask> transferTask,
+    std::shared_ptr<ReadChunkSnapshotContext> context) {
+    // 缓冲区可能被本任务已读取完成但还未上传的分片占用，
+    // 等待期间需要继续处理读取结果，否则可能互相等待
+    while (!taskInfo_->bufferPool_->Get(kWaitBufferMs, &context->buf)) {
+        std::list<ReadChunkSnapshotContextPtr> results =
+            tracker->PopResultContexts();
+        int ret = HandleReadChunkSnapshotResultsAndRetry(
+            tracker, uploadTracker, transferTask, results);
+        if (ret < 0) {
+            return ret;
+        }
+        ret = uploadTracker->GetResult();
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    return kErrCodeSuccess;
+}
+
 int TransferSnapshotDataChunkTask::HandleReadChunkSnapshotResultsAndRetry(
     std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
+    std::shared_ptr<TaskTracker> uploadTracker,
     std::shared_ptr<TransferTask> transferTask,
     const std::list<ReadChunkSnapshotContextPtr> &results) {
     int ret = kErrCodeSuccess;
@@ -210,21 +515,23 @@ int TransferSnapshotDataChunkTask::HandleReadChunkSnapshotResultsAndRetry(
                            << ", ret = " << ret;
                 return ret;
             }
+        } else if (chunkBuf_ != nullptr) {
+            // 按内容去重时需要整个chunk的数据计算hash，拷贝后归还缓冲区
+            memcpy(chunkBuf_.get() + context->partIndex * context->len,
+                   context->buf.get(),
+                   context->len);
         } else {
-            ret = dataStore_->DataChunkTranferAddPart(
-                taskInfo_->name_,
+            TaskIdType taskId = taskInfo_->name_.ToDataChunkKey() + "_" +
+                                std::to_string(context->partIndex);
+            auto task = new TransferSnapshotDataPartTask(
+                taskId,
+                taskInfo_,
                 transferTask,
-                context->partIndex,
-                context->len,
-                context->buf.get());
-            if (ret < 0) {
-                LOG(ERROR) << "DataChunkTranferAddPart fail"
-                           << ", ret = " << ret
-                           << ", chunkDataName = "
-                           << taskInfo_->name_.ToDataChunkKey()
-                           << ", index = " << context->partIndex;
-                return ret;
-            }
+                context,
+                dataStore_);
+            task->SetTracker(uploadTracker);
+            uploadTracker->AddOneTrace();
+            taskInfo_->uploadThreadPool_->PushTask(task);
         }
     }
     return ret;
@@ -23,9 +23,11 @@
 #ifndef SRC_SNAPSHOTCLONESERVER_SNAPSHOT_SNAPSHOT_TASK_H_
 #define SRC_SNAPSHOTCLONESERVER_SNAPSHOT_SNAPSHOT_TASK_H_
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <list>
+#include <vector>
 
 #include "src/snapshotcloneserver/snapshot/snapshot_core.h"
 #include "src/common/snapshotclone/snapshotclone_define.h"
@@ -51,7 +53,10 @@ class SnapshotTaskInfo : public TaskInfo {
         std::shared_ptr<SnapshotInfoMetric> metric)
         : TaskInfo(),
           snapshotInfo_(snapInfo),
-          metric_(metric) {}
+          metric_(metric),
+          transferStartTime_(0),
+          transferBytes_(0),
+          dedupBytes_(0) {}
 
     /**
      * @brief 获取快照信息
@@ -84,11 +89,56 @@ class SnapshotTaskInfo : public TaskInfo {
         metric_->Update(this);
     }
 
+    /**
+     * @brief 开始转储数据，记录开始时间用于计算转储吞吐
+     *
+     * @param timeUs 开始时间(us)
+     */
+    void SetTransferStartTime(uint64_t timeUs) {
+        transferStartTime_ = timeUs;
+    }
+
+    uint64_t GetTransferStartTime() const {
+        return transferStartTime_;
+    }
+
+    /**
+     * @brief 累加已上传的数据量
+     *
+     * @param bytes 上传成功的字节数
+     */
+    void AddTransferBytes(uint64_t bytes) {
+        transferBytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    uint64_t GetTransferBytes() const {
+        return transferBytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 累加按内容去重后不需要上传的数据量，包括全零的chunk
+     *
+     * @param bytes 去重的字节数
+     */
+    void AddDedupBytes(uint64_t bytes) {
+        dedupBytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    uint64_t GetDedupBytes() const {
+        return dedupBytes_.load(std::memory_order_relaxed);
+    }
+
  private:
     // 快照信息
     SnapshotInfo snapshotInfo_;
     // metric 信息
     std::shared_ptr<SnapshotInfoMetric> metric_;
+    // 开始转储数据的时间(us)
+    std::atomic<uint64_t> transferStartTime_;
+    // 已上传的数据量
+    std::atomic<uint64_t> transferBytes_;
+    // 去重的数据量
+    std::atomic<uint64_t> dedupBytes_;
 };
 
 
@@ -173,7 +223,64 @@ class SnapshotDeleteTask : public SnapshotTask {
     }
 };
 
+/**
+ * @brief 转储分片的缓冲区池
+ * @detail
+ *  缓冲区在读取分片之前获取，直到分片上传完成之后才归还，
+ *  限制所有转储任务读取和上传中的分片占用的总内存
+ */
+class TransferBufferPool {
+ public:
+    /**
+     * @brief 构造函数
+     *
+     * @param bufferSize 缓冲区大小，即转储分片大小
+     * @param maxBufferNum 最多分配的缓冲区数量
+     */
+    TransferBufferPool(uint64_t bufferSize, uint32_t maxBufferNum)
+        : bufferSize_(bufferSize),
+          maxBufferNum_(maxBufferNum),
+          allocated_(0) {}
+
+    /**
+     * @brief 获取一个缓冲区，缓冲区用完时最多等待waitMs
+     *
+     * @param waitMs 最长等待时间
+     * @param[out] buf 缓冲区
+     *
+     * @return 获取成功返回true，超时返回false
+     */
+    bool Get(uint32_t waitMs, std::unique_ptr<char[]> *buf);
+
+    /**
+     * @brief 归还缓冲区
+     *
+     * @param buf 缓冲区
+     */
+    void Put(std::unique_ptr<char[]> buf);
+
+    uint64_t GetBufferSize() const {
+        return bufferSize_;
+    }
+
+ private:
+    const uint64_t bufferSize_;
+    const uint32_t maxBufferNum_;
+    // 已分配的缓冲区数量，包括空闲和使用中的
+    uint32_t allocated_;
+    std::vector<std::unique_ptr<char[]>> freeBuffers_;
+    Mutex mtx_;
+    ConditionVariable cv_;
+};
+
 struct ReadChunkSnapshotContext {
+    ~ReadChunkSnapshotContext() {
+        // 分片读取失败放弃或者上传完成后，缓冲区都归还给缓冲区池
+        if (bufferPool != nullptr && buf != nullptr) {
+            bufferPool->Put(std::move(buf));
+        }
+    }
+
     // chunkid 信息
     ChunkIDInfo cidInfo;
     // seq
@@ -182,6 +289,8 @@ struct ReadChunkSnapshotContext {
     uint64_t partIndex;
     // 分片的buffer
     std::unique_ptr<char[]> buf;
+    // buffer所属的缓冲区池
+    std::shared_ptr<TransferBufferPool> bufferPool;
     // 分片长度
     uint64_t len;
     // 返回值
@@ -215,6 +324,26 @@ struct TransferSnapshotDataChunkTaskInfo : public TaskInfo {
     uint64_t clientAsyncMethodRetryTimeSec_;
     uint64_t clientAsyncMethodRetryIntervalMs_;
     uint32_t readChunkSnapshotConcurrency_;
+    // 分片缓冲区池
+    std::shared_ptr<TransferBufferPool> bufferPool_;
+    // 上传分片的线程池
+    std::shared_ptr<ThreadPool> uploadThreadPool_;
+    // 所属的快照任务，用于统计转储吞吐
+    std::shared_ptr<SnapshotTaskInfo> snapshotTask_;
+    // 是否按内容去重保存chunk数据
+    bool enableDedup_;
+    // 保存chunk数据引用的元数据存储
+    std::shared_ptr<SnapshotCloneMetaStore> metaStore_;
+    // 按hash互斥chunk数据的上传和引用
+    NameLock *contentLock_;
+    // 本chunk对共享数据的引用
+    std::string contentRef_;
+    // 转储完成后chunk数据的hash，为空表示全零的chunk
+    std::string contentHash_;
+    // 是否已经按内容去重保存
+    bool contentDone_;
+    // chunk对象的压缩算法
+    CompressType compressType_;
 
     TransferSnapshotDataChunkTaskInfo(const ChunkDataName &name,
         uint64_t chunkSize,
@@ -222,14 +351,65 @@ struct TransferSnapshotDataChunkTaskInfo : public TaskInfo {
         uint64_t chunkSplitSize,
         uint64_t clientAsyncMethodRetryTimeSec,
         uint64_t clientAsyncMethodRetryIntervalMs,
-        uint32_t readChunkSnapshotConcurrency)
+        uint32_t readChunkSnapshotConcurrency,
+        std::shared_ptr<TransferBufferPool> bufferPool,
+        std::shared_ptr<ThreadPool> uploadThreadPool,
+        std::shared_ptr<SnapshotTaskInfo> snapshotTask)
         : name_(name),
           chunkSize_(chunkSize),
           cidInfo_(cidInfo),
           chunkSplitSize_(chunkSplitSize),
           clientAsyncMethodRetryTimeSec_(clientAsyncMethodRetryTimeSec),
           clientAsyncMethodRetryIntervalMs_(clientAsyncMethodRetryIntervalMs),
-          readChunkSnapshotConcurrency_(readChunkSnapshotConcurrency) {}
+          readChunkSnapshotConcurrency_(readChunkSnapshotConcurrency),
+          bufferPool_(bufferPool),
+          uploadThreadPool_(uploadThreadPool),
+          snapshotTask_(snapshotTask),
+          enableDedup_(false),
+          contentLock_(nullptr),
+          contentDone_(false),
+          compressType_(CompressType::kNone) {}
+
+    /**
+     * @brief 开启按内容去重，chunk数据保存在hash对应的共享对象中
+     *
+     * @param metaStore 元数据存储
+     * @param contentLock hash锁
+     * @param contentRef 本chunk对共享数据的引用
+     */
+    void EnableDedup(std::shared_ptr<SnapshotCloneMetaStore> metaStore,
+        NameLock *contentLock,
+        const std::string &contentRef) {
+        enableDedup_ = true;
+        metaStore_ = metaStore;
+        contentLock_ = contentLock;
+        contentRef_ = contentRef;
+    }
+};
+
+/**
+ * @brief 上传快照chunk的一个分片
+ */
+class TransferSnapshotDataPartTask : public TrackerTask {
+ public:
+    TransferSnapshotDataPartTask(const TaskIdType &taskId,
+        std::shared_ptr<TransferSnapshotDataChunkTaskInfo> taskInfo,
+        std::shared_ptr<TransferTask> transferTask,
+        ReadChunkSnapshotContextPtr context,
+        std::shared_ptr<SnapshotDataStore> dataStore)
+        : TrackerTask(taskId),
+          taskInfo_(taskInfo),
+          transferTask_(transferTask),
+          context_(context),
+          dataStore_(dataStore) {}
+
+    void Run() override;
+
+ private:
+    std::shared_ptr<TransferSnapshotDataChunkTaskInfo> taskInfo_;
+    std::shared_ptr<TransferTask> transferTask_;
+    ReadChunkSnapshotContextPtr context_;
+    std::shared_ptr<SnapshotDataStore> dataStore_;
 };
 
 class TransferSnapshotDataChunkTask : public TrackerTask {
@@ -261,6 +441,65 @@ class TransferSnapshotDataChunkTask : public TrackerTask {
      */
     int TransferSnapshotDataChunk();
 
+    /**
+     * @brief 按内容去重转储快照单个chunk
+     *
+     * @return 错误码
+     */
+    int TransferSnapshotDataChunkDedup();
+
+    /**
+     * @brief 读取chunk的所有分片，读取成功的分片交给上传线程池上传，
+     *        按内容去重时拷贝到chunkBuf_中
+     *
+     * @param uploadTracker 上传分片追踪器
+     * @param transferTask 转储任务
+     *
+     * @return 错误码
+     */
+    int ReadChunkSnapshotParts(
+        std::shared_ptr<TaskTracker> uploadTracker,
+        std::shared_ptr<TransferTask> transferTask);
+
+    /**
+     * @brief 压缩转储快照单个chunk
+     *
+     * @return 错误码
+     */
+    int TransferSnapshotDataChunkCompressed();
+
+    /**
+     * @brief 同步上传整个对象
+     *
+     * @param name 对象名
+     * @param buf 对象数据
+     * @param len 对象长度
+     * @param partSize 分片大小
+     *
+     * @return 错误码
+     */
+    int UploadChunkObject(const ChunkDataName &name,
+        const char *buf,
+        uint64_t len,
+        uint64_t partSize);
+
+    /**
+     * @brief 为分片获取缓冲区，等待期间继续处理已完成的读取结果，
+     *        使已读取的分片能够上传并归还缓冲区
+     *
+     * @param tracker 异步ReadSnapshotChunk追踪器
+     * @param uploadTracker 上传分片追踪器
+     * @param transferTask 转储任务
+     * @param context ReadSnapshotChunk上下文
+     *
+     * @return 错误码
+     */
+    int AllocateBuffer(
+        std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
+        std::shared_ptr<TaskTracker> uploadTracker,
+        std::shared_ptr<TransferTask> transferTask,
+        std::shared_ptr<ReadChunkSnapshotContext> context);
+
     /**
      * @brief 开始异步ReadSnapshotChunk
      *
@@ -274,9 +513,11 @@ class TransferSnapshotDataChunkTask : public TrackerTask {
         std::shared_ptr<ReadChunkSnapshotContext> context);
 
     /**
-     * @brief 处理ReadChunkSnapshot的结果并重试
+     * @brief 处理ReadChunkSnapshot的结果并重试，读取成功的分片交给
+     *        上传线程池异步上传
      *
      * @param tracker 异步ReadSnapshotChunk追踪器
+     * @param uploadTracker 上传分片追踪器
      * @param transferTask 转储任务
      * @param results ReadChunkSnapshot结果列表
      *
@@ -284,6 +525,7 @@ class TransferSnapshotDataChunkTask : public TrackerTask {
      */
     int HandleReadChunkSnapshotResultsAndRetry(
         std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
+        std::shared_ptr<TaskTracker> uploadTracker,
         std::shared_ptr<TransferTask> transferTask,
         const std::list<ReadChunkSnapshotContextPtr> &results);
 
@@ -291,6 +533,8 @@ class TransferSnapshotDataChunkTask : public TrackerTask {
     std::shared_ptr<TransferSnapshotDataChunkTaskInfo> taskInfo_;
     std::shared_ptr<CurveFsClient> client_;
     std::shared_ptr<SnapshotDataStore> dataStore_;
+    // 按内容去重时保存整个chunk的数据
+    std::unique_ptr<char[]> chunkBuf_;
 };
 
 
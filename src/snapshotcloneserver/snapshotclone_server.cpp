@@ -81,6 +81,28 @@ void InitSnapshotCloneServerOptions(std::shared_ptr<Configuration> conf,
                                         &serverOption->mdsSessionTimeUs);
     conf->GetValueFatalIfFail("server.readChunkSnapshotConcurrency",
             &serverOption->readChunkSnapshotConcurrency);
+    LOG_IF(WARNING, !conf->GetUInt32Value(
+        "server.transferUploadPartConcurrency",
+        &serverOption->transferUploadPartConcurrency))
+        << "config no server.transferUploadPartConcurrency info, "
+        << "using default value "
+        << serverOption->transferUploadPartConcurrency;
+    LOG_IF(WARNING, !conf->GetUInt64Value("server.transferBufferPoolSizeMB",
+        &serverOption->transferBufferPoolSizeMB))
+        << "config no server.transferBufferPoolSizeMB info, "
+        << "using default value " << serverOption->transferBufferPoolSizeMB;
+    LOG_IF(WARNING, !conf->GetBoolValue("server.enableChunkDedup",
+        &serverOption->enableChunkDedup))
+        << "config no server.enableChunkDedup info, using default value "
+        << serverOption->enableChunkDedup;
+    std::string compressType = "none";
+    LOG_IF(WARNING, !conf->GetStringValue("server.snapshotCompressType",
+        &compressType))
+        << "config no server.snapshotCompressType info, "
+        << "using default value " << compressType;
+    LOG_IF(FATAL, !curve::common::StringToCompressType(compressType,
+        &serverOption->snapshotCompressType))
+        << "invalid server.snapshotCompressType " << compressType;
 
     conf->GetValueFatalIfFail("server.stage1PoolThreadNum",
                                      &serverOption->stage1PoolThreadNum);
@@ -27,6 +27,7 @@
 #include <limits>
 
 #include "json/json.h"
+#include "src/common/compression.h"
 #include "src/common/snapshotclone/snapshotclone_define.h"
 #include "src/common/uuid.h"
 #include "src/common/string_util.h"
@@ -106,6 +107,9 @@ void SnapshotCloneServiceImpl::HandleCreateSnapshotAction(
         bcntl->http_request().uri().GetQuery(kFileStr);
     const std::string *name =
         bcntl->http_request().uri().GetQuery(kNameStr);
+    const std::string *compress =
+        bcntl->http_request().uri().GetQuery(kCompressTypeStr);
+    CompressType compressType;
     if ((version == nullptr) ||
         (user == nullptr) ||
         (file == nullptr) ||
@@ -113,18 +117,28 @@ void SnapshotCloneServiceImpl::HandleCreateSnapshotAction(
         (version->empty()) ||
         (user->empty()) ||
         (file->empty()) ||
-        (name->empty())) {
+        (name->empty()) ||
+        ((compress != nullptr) &&
+            !curve::common::StringToCompressType(*compress,
+                &compressType))) {
         HandleBadRequestError(bcntl, requestId);
         return;
     }
+    // 未指定压缩算法时使用服务端默认配置
+    std::string compressStr = "";
+    if (compress != nullptr) {
+        compressStr = *compress;
+    }
     LOG(INFO) << "CreateSnapshot:"
               << " Version = " << *version
               << ", User = " << *user
               << ", File = " << *file
               << ", Name = " << *name
+              << ", CompressType = " << compressStr
               << ", requestId = " << requestId;
     UUID uuid;
-    int ret = snapshotManager_->CreateSnapshot(*file, *user, *name, &uuid);
+    int ret = snapshotManager_->CreateSnapshot(*file, *user, *name,
+        compressStr, &uuid);
     if (ret < 0) {
         bcntl->http_response().set_status_code(
             brpc::HTTP_STATUS_INTERNAL_SERVER_ERROR);
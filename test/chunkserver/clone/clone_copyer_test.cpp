@@ -242,6 +242,107 @@ TEST_F(CloneCopyerTest, BasicTest) {
     }
 }
 
+TEST_F(CloneCopyerTest, CompressedS3Test) {
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.curveConf = CURVE_CONF;
+    options.s3Conf = S3_CONF;
+    options.curveUser.owner = ROOT_OWNER;
+    options.curveUser.password = ROOT_PWD;
+    options.curveClient = curveClient_;
+    options.s3Client = s3Client_;
+    options.curveFileTimeoutSec = EXPIRED_USE;
+    EXPECT_CALL(*curveClient_, Init(StrEq(CURVE_CONF)))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(0, copyer.Init(options));
+
+    std::string raw(8192, 'a');
+    for (size_t i = 0; i < raw.size(); i++) {
+        raw[i] = 'a' + i % 7 + i / 1024;
+    }
+    std::string obj;
+    ASSERT_TRUE(CompressedObject::Encode(curve::common::CompressType::kSnappy,
+        1024, raw.data(), raw.size(), &obj));
+    auto readObject =
+        [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+            ASSERT_EQ("test", context->key);
+            ASSERT_LE(context->offset + context->len, obj.size());
+            memcpy(context->buf, obj.data() + context->offset, context->len);
+            context->retCode = 0;
+            context->cb(s3Client_.get(), context);
+        };
+
+    char* buf = new char[4096];
+    AsyncDownloadContext context;
+    context.location = "test@s3z";
+    context.offset = 1000;
+    context.size = 3000;
+    context.buf = buf;
+    MockDownloadClosure closure(&context);
+
+    /* 用例:第一次读取压缩对象
+     * 预期:依次读取固定头部、帧索引和覆盖请求范围的帧，解压出原始数据
+     */
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .Times(3)
+        .WillRepeatedly(Invoke(readObject));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(0, memcmp(buf, raw.data() + 1000, 3000));
+    closure.Reset();
+
+    /* 用例:再次读取压缩对象
+     * 预期:对象头部已经缓存，只读取覆盖请求范围的帧
+     */
+    context.offset = 4096;
+    context.size = 4096;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillOnce(Invoke(readObject));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(0, memcmp(buf, raw.data() + 4096, 4096));
+    closure.Reset();
+
+    /* 用例:读取范围超出对象的原始数据
+     * 预期:返回失败
+     */
+    context.offset = 8192;
+    context.size = 4096;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .Times(0);
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_TRUE(closure.IsFailed());
+    closure.Reset();
+
+    /* 用例:读取的帧数据损坏
+     * 预期:返回失败
+     */
+    context.offset = 0;
+    context.size = 4096;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillOnce(Invoke(
+            [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+                memset(context->buf, 0xff, context->len);
+                context->retCode = 0;
+                context->cb(s3Client_.get(), context);
+            }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_TRUE(closure.IsFailed());
+    closure.Reset();
+
+    delete [] buf;
+
+    EXPECT_CALL(*curveClient_, UnInit())
+        .Times(1);
+    EXPECT_CALL(*s3Client_, Deinit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+}
+
 TEST_F(CloneCopyerTest, DisableTest) {
     OriginCopyer copyer;
     CopyerOptions options;
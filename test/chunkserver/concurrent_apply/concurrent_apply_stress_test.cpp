@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-26
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/mpsc_task_queue.h"
+#include "src/common/concurrent/task_queue.h"
+
+namespace curve {
+namespace chunkserver {
+namespace concurrent {
+
+using curve::common::MPSCTaskQueue;
+using curve::common::TaskQueue;
+using Clock = std::chrono::steady_clock;
+
+const int kApplyThreads = 10;
+const int kOpsPerCopyset = 20000;
+
+void RunTask(TaskQueue* queue) {
+    queue->Pop()();
+}
+
+void RunTask(MPSCTaskQueue* queue) {
+    queue->RunOne();
+}
+
+// every copyset pushes ops of its chunks to the apply threads like
+// CopysetNode::on_apply, and the time from push to run is recorded
+template<class Queue>
+void ApplyBenchmark(const char* name, int copysets, size_t depth) {
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::vector<int64_t>> latencies(kApplyThreads);
+    for (int i = 0; i < kApplyThreads; ++i) {
+        queues.emplace_back(new Queue(depth));
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<bool> stop(kApplyThreads, false);
+    for (int i = 0; i < kApplyThreads; ++i) {
+        workers.emplace_back([&, i]() {
+            latencies[i].reserve(kOpsPerCopyset * copysets / kApplyThreads);
+            while (!stop[i]) {
+                RunTask(queues[i].get());
+            }
+        });
+    }
+
+    auto start = Clock::now();
+    std::vector<std::thread> producers;
+    for (int c = 0; c < copysets; ++c) {
+        producers.emplace_back([&, c]() {
+            for (int i = 0; i < kOpsPerCopyset; ++i) {
+                int index = (c * 7 + i) % kApplyThreads;
+                std::vector<int64_t>* lat = &latencies[index];
+                queues[index]->Push([lat](Clock::time_point pushed) {
+                    lat->push_back(std::chrono::duration_cast<
+                        std::chrono::nanoseconds>(
+                            Clock::now() - pushed).count());
+                }, Clock::now());
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    for (int i = 0; i < kApplyThreads; ++i) {
+        queues[i]->Push([&stop, i]() { stop[i] = true; });
+    }
+    for (auto& t : workers) {
+        t.join();
+    }
+    auto end = Clock::now();
+
+    std::vector<int64_t> all;
+    for (auto& lat : latencies) {
+        all.insert(all.end(), lat.begin(), lat.end());
+    }
+    ASSERT_EQ(static_cast<size_t>(kOpsPerCopyset) * copysets, all.size());
+    std::sort(all.begin(), all.end());
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-14s copysets: %2d, depth: %4zu, ops: %10.0f op/s, "
+           "p50: %8.2f us, p99: %8.2f us\n",
+           name, copysets, depth, all.size() / seconds,
+           all[all.size() / 2] / 1000.0,
+           all[all.size() * 99 / 100] / 1000.0);
+}
+
+TEST(ConcurrentApplyStressTest, TaskQueueCompareTest) {
+    for (size_t depth : {1, 128}) {
+        for (int copysets : {8, 16, 32, 64}) {
+            ApplyBenchmark<TaskQueue>("TaskQueue", copysets, depth);
+            ApplyBenchmark<MPSCTaskQueue>("MPSCTaskQueue", copysets, depth);
+        }
+    }
+}
+
+}  // namespace concurrent
+}  // namespace chunkserver
+}  // namespace curve
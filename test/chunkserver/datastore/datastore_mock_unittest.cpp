@@ -22,6 +22,7 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <set>
 #include <string>
 #include <memory>
 
@@ -213,7 +214,8 @@ class CSDataStore_test : public testing::Test {
             ON_CALL(*lfs_,
                     Write(Ge(1), Matcher<const char*>(NotNull()), Ge(0), Gt(0)))
                 .WillByDefault(ReturnArg<3>());
-            ON_CALL(*lfs_, Write(Ge(1), Matcher<butil::IOBuf>(_), Ge(0), Gt(0)))
+            ON_CALL(*lfs_, Write(Ge(1), Matcher<const butil::IOBuf&>(_),
+                                 Ge(0), Gt(0)))
                 .WillByDefault(ReturnArg<3>());
             // fake read chunk1 metapage
             FakeEncodeChunk(chunk1MetaPage, 0, 2);
@@ -700,7 +702,8 @@ TEST_F(CSDataStore_test, WriteChunkTest1) {
                         Return(PAGE_SIZE)));
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(4, Matcher<butil::IOBuf>(_), PAGE_SIZE + offset, length))
+                Write(4, Matcher<const butil::IOBuf&>(_),
+                      PAGE_SIZE + offset, length))
         .Times(1);
 
     EXPECT_EQ(CSErrorCode::Success, dataStore->WriteChunk(id,
@@ -872,7 +875,8 @@ TEST_F(CSDataStore_test, WriteChunkTest4) {
 
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(3, Matcher<butil::IOBuf>(_), PAGE_SIZE + offset, length))
+                Write(3, Matcher<const butil::IOBuf&>(_),
+                      PAGE_SIZE + offset, length))
         .Times(1);
 
     EXPECT_EQ(CSErrorCode::Success,
@@ -960,7 +964,7 @@ TEST_F(CSDataStore_test, WriteChunkTest6) {
     EXPECT_CALL(*lfs_, Write(3, Matcher<const char*>(NotNull()), 0, PAGE_SIZE))
         .Times(1);
     // will write data
-    EXPECT_CALL(*lfs_, Write(3, Matcher<butil::IOBuf>(_),
+    EXPECT_CALL(*lfs_, Write(3, Matcher<const butil::IOBuf&>(_),
                              PAGE_SIZE + offset, length))
         .Times(1);
 
@@ -1034,7 +1038,7 @@ TEST_F(CSDataStore_test, WriteChunkTest7) {
     EXPECT_CALL(*lfs_, Write(4, Matcher<const char*>(NotNull()), 0, PAGE_SIZE))
         .Times(1);
     // will write data
-    EXPECT_CALL(*lfs_, Write(3, Matcher<butil::IOBuf>(_),
+    EXPECT_CALL(*lfs_, Write(3, Matcher<const butil::IOBuf&>(_),
                              PAGE_SIZE + offset, length))
         .Times(1);
 
@@ -1051,7 +1055,7 @@ TEST_F(CSDataStore_test, WriteChunkTest7) {
     ASSERT_EQ(2, info.snapSn);
 
     // 再次写同一个page的数据，不再进行cow，而是直接写入数据
-    EXPECT_CALL(*lfs_, Write(3, Matcher<butil::IOBuf>(_),
+    EXPECT_CALL(*lfs_, Write(3, Matcher<const butil::IOBuf&>(_),
                              PAGE_SIZE + offset, length))
         .Times(1);
     EXPECT_EQ(CSErrorCode::Success,
@@ -1110,7 +1114,8 @@ TEST_F(CSDataStore_test, WriteChunkTest9) {
         .Times(1);
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(1, Matcher<butil::IOBuf>(_), PAGE_SIZE + offset, length))
+                Write(1, Matcher<const butil::IOBuf&>(_),
+                      PAGE_SIZE + offset, length))
         .Times(1);
 
     EXPECT_EQ(CSErrorCode::Success,
@@ -1163,7 +1168,8 @@ TEST_F(CSDataStore_test, WriteChunkTest10) {
     // will not cow
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(1, Matcher<butil::IOBuf>(_), PAGE_SIZE + offset, length))
+                Write(1, Matcher<const butil::IOBuf&>(_),
+                      PAGE_SIZE + offset, length))
         .Times(1);
 
     EXPECT_EQ(CSErrorCode::Success,
@@ -1296,7 +1302,7 @@ TEST_F(CSDataStore_test, WriteChunkTest13) {
         id = 3;  // not exist
         offset = PAGE_SIZE;
         length = 2 * PAGE_SIZE;
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_),
                                  PAGE_SIZE + offset, length))
             .Times(1);
         // update metapage
@@ -1325,7 +1331,7 @@ TEST_F(CSDataStore_test, WriteChunkTest13) {
         id = 3;  // not exist
         offset = PAGE_SIZE;
         length = 2 * PAGE_SIZE;
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_),
                                  PAGE_SIZE + offset, length))
             .Times(1);
         EXPECT_CALL(*lfs_,
@@ -1357,7 +1363,7 @@ TEST_F(CSDataStore_test, WriteChunkTest13) {
         std::unique_ptr<char[]> buf(new char[length]);
 
         // [2 * PAGE_SIZE, 4 * PAGE_SIZE)区域已写过，[0, PAGE_SIZE)为metapage
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_),
                                  offset + PAGE_SIZE, length))
             .Times(1);
         EXPECT_CALL(*lfs_,
@@ -1389,7 +1395,7 @@ TEST_F(CSDataStore_test, WriteChunkTest13) {
         std::unique_ptr<char[]> buf(new char[length]);
 
         // [PAGE_SIZE, 4 * PAGE_SIZE)区域已写过，[0, PAGE_SIZE)为metapage
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_),
                                  offset + PAGE_SIZE, length))
             .Times(1);
         EXPECT_CALL(*lfs_,
@@ -1514,7 +1520,7 @@ TEST_F(CSDataStore_test, WriteChunkTest14) {
         offset = PAGE_SIZE;
         length = 2 * PAGE_SIZE;
         sn = 3;  // sn > chunk.sn;sn == correctedsn
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_),
                                  PAGE_SIZE + offset, length))
             .Times(1);
         // update metapage
@@ -1550,7 +1556,7 @@ TEST_F(CSDataStore_test, WriteChunkTest14) {
         std::unique_ptr<char[]> buf(new char[length]);
 
         // [2 * PAGE_SIZE, 4 * PAGE_SIZE)区域已写过，[0, PAGE_SIZE)为metapage
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_),
                                  offset + PAGE_SIZE, length))
             .Times(1);
         EXPECT_CALL(*lfs_,
@@ -1581,7 +1587,7 @@ TEST_F(CSDataStore_test, WriteChunkTest14) {
         LOG(INFO) << "case 4";
         sn = 4;
         // 不会写数据
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_), _, _))
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_), _, _))
             .Times(0);
 
         std::unique_ptr<char[]> buf(new char[length]);
@@ -1654,7 +1660,8 @@ TEST_F(CSDataStore_test, WriteChunkTest15) {
         .Times(0);
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(1, Matcher<butil::IOBuf>(_), PAGE_SIZE + offset, length))
+                Write(1, Matcher<const butil::IOBuf&>(_),
+                      PAGE_SIZE + offset, length))
         .Times(1);
 
     EXPECT_EQ(CSErrorCode::Success,
@@ -1716,7 +1723,8 @@ TEST_F(CSDataStore_test, WriteChunkTest16) {
         .Times(1);
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(1, Matcher<butil::IOBuf>(_), PAGE_SIZE + offset, length))
+                Write(1, Matcher<const butil::IOBuf&>(_),
+                      PAGE_SIZE + offset, length))
         .Times(1);
 
     EXPECT_EQ(CSErrorCode::Success,
@@ -1991,7 +1999,8 @@ TEST_F(CSDataStore_test, WriteChunkErrorTest3) {
         .Times(1);
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(3, Matcher<butil::IOBuf>(_), PAGE_SIZE + offset, length))
+                Write(3, Matcher<const butil::IOBuf&>(_),
+                      PAGE_SIZE + offset, length))
         .Times(1);
 
     LOG(INFO) << "case 5";
@@ -2062,7 +2071,8 @@ TEST_F(CSDataStore_test, WriteChunkErrorTest4) {
         .Times(1);
     // write chunk failed
     EXPECT_CALL(*lfs_,
-                Write(3, Matcher<butil::IOBuf>(_), PAGE_SIZE + offset, length))
+                Write(3, Matcher<const butil::IOBuf&>(_),
+                      PAGE_SIZE + offset, length))
         .WillOnce(Return(-UT_ERRNO));
 
     EXPECT_EQ(CSErrorCode::InternalError,
@@ -2075,7 +2085,8 @@ TEST_F(CSDataStore_test, WriteChunkErrorTest4) {
     // 再次写入直接写chunk文件
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(3, Matcher<butil::IOBuf>(_), PAGE_SIZE + offset, length))
+                Write(3, Matcher<const butil::IOBuf&>(_),
+                      PAGE_SIZE + offset, length))
         .Times(1);
 
     EXPECT_EQ(CSErrorCode::Success,
@@ -2281,7 +2292,7 @@ TEST_F(CSDataStore_test, WriteChunkErrorTest6) {
         id = 3;  // not exist
         offset = PAGE_SIZE;
         length = 2 * PAGE_SIZE;
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_),
                                  PAGE_SIZE + offset, length))
             .WillOnce(Return(-UT_ERRNO));
         // update metapage
@@ -2305,7 +2316,7 @@ TEST_F(CSDataStore_test, WriteChunkErrorTest6) {
         id = 3;  // not exist
         offset = PAGE_SIZE;
         length = 2 * PAGE_SIZE;
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_),
                                  PAGE_SIZE + offset, length))
             .Times(1);
         // update metapage
@@ -2701,7 +2712,8 @@ TEST_F(CSDataStore_test, ReadSnapshotChunkTest3) {
         .Times(1);
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(1, Matcher<butil::IOBuf>(_), offset + PAGE_SIZE, length))
+                Write(1, Matcher<const butil::IOBuf&>(_),
+                      offset + PAGE_SIZE, length))
         .Times(1);
     EXPECT_EQ(CSErrorCode::Success,
               dataStore->WriteChunk(id,
@@ -2807,7 +2819,8 @@ TEST_F(CSDataStore_test, ReadSnapshotChunkErrorTest1) {
         .Times(1);
     // will write data
     EXPECT_CALL(*lfs_,
-                Write(1, Matcher<butil::IOBuf>(_), offset + PAGE_SIZE, length))
+                Write(1, Matcher<const butil::IOBuf&>(_),
+                      offset + PAGE_SIZE, length))
         .Times(1);
     EXPECT_EQ(CSErrorCode::Success,
               dataStore->WriteChunk(id,
@@ -4195,6 +4208,35 @@ TEST_F(CSDataStore_test, GetStatusTest) {
         .Times(1);
 }
 
+/*
+ * 遍历chunk测试
+ */
+TEST_F(CSDataStore_test, ForEachChunkTest) {
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    ChunkMap chunkMap = dataStore->GetChunkMap();
+    ASSERT_EQ(2, chunkMap.size());
+
+    std::set<ChunkID> ids;
+    dataStore->ForEachChunk([&](ChunkID id, const CSChunkFilePtr& chunk) {
+        ASSERT_NE(nullptr, chunk);
+        ASSERT_EQ(chunkMap[id], chunk);
+        ids.insert(id);
+    });
+    ASSERT_EQ(2, ids.size());
+    ASSERT_EQ(1, ids.count(1));
+    ASSERT_EQ(1, ids.count(2));
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+}
+
 TEST_F(CSDataStore_test, CloneChunkUnAlignedTest) {
     // initialize
     FakeEnv();
@@ -4248,7 +4290,8 @@ TEST_F(CSDataStore_test, CloneChunkUnAlignedTest) {
 
     // read/write/paste offset are not aligned to pagesize
     {
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_), _, _)).Times(0);
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_), _, _))
+            .Times(0);
         EXPECT_CALL(*lfs_, Read(4, _, _, _)).Times(0);
 
         ASSERT_EQ(CSErrorCode::InvalidArgError,
@@ -4306,7 +4349,8 @@ TEST_F(CSDataStore_test, CloneChunkUnAlignedTest) {
 
     // read/write/paste length are not aligned to pagesize
     {
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_), _, _)).Times(0);
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_), _, _))
+            .Times(0);
         EXPECT_CALL(*lfs_, Read(4, _, _, _)).Times(0);
 
         ASSERT_EQ(CSErrorCode::InvalidArgError,
@@ -4428,7 +4472,7 @@ TEST_F(CSDataStore_test, CloneChunkAlignedTest) {
     {
         EXPECT_CALL(*lfs_, Write(4, Matcher<const char*>(_), 0, PAGE_SIZE))
             .Times(2);
-        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const butil::IOBuf&>(_),
                     PAGE_SIZE + offset, length))
             .Times(1);
 
@@ -4484,7 +4528,7 @@ TEST_F(CSDataStore_test, NormalChunkAlignmentTest) {
 
     // write unaligned test
     {
-        EXPECT_CALL(*lfs_, Write(0, Matcher<butil::IOBuf>(_), _, _))
+        EXPECT_CALL(*lfs_, Write(0, Matcher<const butil::IOBuf&>(_), _, _))
             .Times(0);
 
         EXPECT_EQ(CSErrorCode::InvalidArgError,
@@ -4506,7 +4550,7 @@ TEST_F(CSDataStore_test, NormalChunkAlignmentTest) {
 
     // write aligned test
     {
-        EXPECT_CALL(*lfs_, Write(3, Matcher<butil::IOBuf>(_), _, _))
+        EXPECT_CALL(*lfs_, Write(3, Matcher<const butil::IOBuf&>(_), _, _))
             .Times(AtLeast(1))
             .WillRepeatedly(Return(0));
 
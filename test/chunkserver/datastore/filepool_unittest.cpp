@@ -498,6 +498,12 @@ TEST_F(CSFilePool_test, WithoutPoolConcurrentGetAndRecycle) {
         LOG(INFO) << "pool2 size=" << filename.size();
         ASSERT_EQ(filename.size(), 0);
     }
+
+    /* step 6. files allocated directly are neither hits nor misses */
+    auto metric = chunkFilePoolPtr_->GetMetric();
+    ASSERT_EQ(0, metric->getFileHit.get_value());
+    ASSERT_EQ(0, metric->getFileMiss.get_value());
+    ASSERT_EQ(TOTAL_FILE_NUM, metric->getFileLatency.count());
 }
 
 TEST_F(CSFilePool_test, CleanChunkTest) {
@@ -563,6 +569,71 @@ TEST_F(CSFilePool_test, CleanChunkTest) {
     }
 }
 
+TEST_F(CSFilePool_test, RefillTest) {
+    std::string filePool = "./cspooltest/filePool.meta";
+
+    FilePoolOptions cfop;
+    cfop.fileSize = 4096;
+    cfop.metaPageSize = 4096;
+    cfop.refillLowWatermark = 110;
+    cfop.refillHighWatermark = 120;
+    cfop.refillReservePercent = 0;
+    memcpy(cfop.metaPath, filePool.c_str(), filePool.size());
+
+    // CASE 1: high watermark is less than low watermark
+    cfop.refillHighWatermark = 100;
+    ASSERT_FALSE(chunkFilePoolPtr_->Initialize(cfop));
+    cfop.refillHighWatermark = 120;
+
+    // CASE 2: unfinished refill file is deleted on scan
+    std::string leftover = std::string(FILEPOOL_DIR) + "101.refill";
+    int fd = fsptr->Open(leftover.c_str(), O_RDWR | O_CREAT);
+    ASSERT_GT(fd, 0);
+    fsptr->Close(fd);
+    ASSERT_TRUE(chunkFilePoolPtr_->Initialize(cfop));
+    ASSERT_FALSE(fsptr->FileExists(leftover));
+    ASSERT_EQ(100, chunkFilePoolPtr_->Size());
+
+    // CASE 3: refill up to the high watermark
+    ASSERT_TRUE(chunkFilePoolPtr_->StartCleaning());
+    sleep(2);
+    auto currentStat = chunkFilePoolPtr_->GetState();
+    ASSERT_EQ(120, chunkFilePoolPtr_->Size());
+    ASSERT_EQ(50, currentStat.dirtyChunksLeft);
+    ASSERT_EQ(70, currentStat.cleanChunksLeft);
+    auto metric = chunkFilePoolPtr_->GetMetric();
+    ASSERT_EQ(20, metric->refilledFiles.get_value());
+
+    // CASE 4: no refill until the pool drops below the low watermark
+    char metapage[4096], data[8192];
+    memset(metapage, '1', sizeof(metapage));
+    for (int i = 1; i <= 10; i++) {
+        std::string filename = "test" + std::to_string(i);
+        ASSERT_EQ(0, chunkFilePoolPtr_->GetFile(filename, metapage, true));
+        ASSERT_EQ(0, fsptr->Delete(filename));
+    }
+    sleep(1);
+    ASSERT_EQ(110, chunkFilePoolPtr_->Size());
+    ASSERT_EQ(10, metric->getFileHit.get_value());
+    ASSERT_EQ(0, metric->getFileMiss.get_value());
+    ASSERT_EQ(10, metric->getFileLatency.count());
+
+    ASSERT_EQ(0, chunkFilePoolPtr_->GetFile("test11", metapage, true));
+    sleep(2);
+    ASSERT_TRUE(chunkFilePoolPtr_->StopCleaning());
+    ASSERT_EQ(120, chunkFilePoolPtr_->Size());
+    ASSERT_EQ(31, metric->refilledFiles.get_value());
+
+    // the refilled chunk is zeroed
+    fd = fsptr->Open("test11", O_RDWR);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(8192, fsptr->Read(fd, data, 0, 8192));
+    for (int j = 0; j < 4096; j++) ASSERT_EQ(data[j], '1');
+    for (int j = 4096; j < 8192; j++) ASSERT_EQ(data[j], '\0');
+    ASSERT_EQ(0, fsptr->Close(fd));
+    ASSERT_EQ(0, fsptr->Delete("test11"));
+}
+
 TEST(CSFilePool, GetFileDirectlyTest) {
     std::shared_ptr<FilePool> chunkFilePoolPtr_;
     std::shared_ptr<LocalFileSystem> fsptr;
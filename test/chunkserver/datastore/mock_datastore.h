@@ -68,6 +68,14 @@ class MockDataStore : public CSDataStore {
     MOCK_METHOD2(GetChunkInfo, CSErrorCode(ChunkID, CSChunkInfo*));
     MOCK_METHOD0(GetStatus, DataStoreStatus());
     MOCK_METHOD0(GetChunkMap, ChunkMap());
+    MOCK_METHOD1(ForEachChunk, void(const ChunkVisitor&));
+    MOCK_METHOD6(GetChunkBlockCrc, CSErrorCode(ChunkID,
+                                               off_t,
+                                               size_t,
+                                               uint32_t,
+                                               uint32_t*,
+                                               uint32_t*));
+    MOCK_METHOD1(MarkChunkScanned, void(ChunkID));
 };
 
 }  // namespace chunkserver
@@ -0,0 +1,181 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-24
+ */
+
+#include <gtest/gtest.h>
+#include <braft/configuration_manager.h>
+#include <braft/log_entry.h>
+
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/raftlog/shared_wal.h"
+
+namespace curve {
+namespace chunkserver {
+
+const char kSharedWalTestDir[] = "./shared-wal-data";
+
+class SharedWalTest : public testing::Test {
+ protected:
+    void SetUp() {
+        walDir_ = std::string(kSharedWalTestDir) + "/" SHARED_WAL_DIR;
+        copysetRoot_ = std::string(kSharedWalTestDir) + "/copysets";
+        std::string cmd = std::string("mkdir -p ") + copysetRoot_ + "/1 "
+                        + copysetRoot_ + "/2";
+        ::system(cmd.c_str());
+    }
+    void TearDown() {
+        std::string cmd = std::string("rm -rf ") + kSharedWalTestDir;
+        ::system(cmd.c_str());
+    }
+
+    void Append(SharedWal* wal, uint64_t copysetId, int64_t term,
+                int64_t start, int64_t end, size_t size = 64) {
+        std::vector<braft::LogEntry*> entries;
+        for (int64_t i = start; i <= end; ++i) {
+            braft::LogEntry* entry = new braft::LogEntry();
+            entry->AddRef();
+            entry->type = braft::ENTRY_TYPE_DATA;
+            entry->id.term = term;
+            entry->id.index = i;
+            entry->data.append(std::string(size, 'a' + i % 26));
+            entries.push_back(entry);
+        }
+        ASSERT_EQ(entries.size(),
+                  static_cast<size_t>(wal->Append(copysetId, entries, true)));
+        for (auto entry : entries) {
+            entry->Release();
+        }
+    }
+
+    void CheckEntry(SharedWal* wal, uint64_t copysetId, int64_t index,
+                    int64_t term, size_t size = 64) {
+        braft::LogEntry* entry = wal->Get(copysetId, index);
+        ASSERT_NE(nullptr, entry);
+        ASSERT_EQ(index, entry->id.index);
+        ASSERT_EQ(term, entry->id.term);
+        ASSERT_EQ(std::string(size, 'a' + index % 26),
+                  entry->data.to_string());
+        ASSERT_EQ(term, wal->GetTerm(copysetId, index));
+        entry->Release();
+    }
+
+    std::string walDir_;
+    std::string copysetRoot_;
+    braft::ConfigurationManager confManager_;
+};
+
+TEST_F(SharedWalTest, AppendAndGetTest) {
+    SharedWal wal(walDir_, copysetRoot_, 64 * 1024 * 1024);
+    ASSERT_EQ(0, wal.Init());
+    int64_t lastIndex = -1;
+    ASSERT_EQ(0, wal.Attach(1, 1, true, &confManager_, &lastIndex));
+    ASSERT_EQ(0, lastIndex);
+    ASSERT_EQ(0, wal.Attach(2, 1, true, &confManager_, &lastIndex));
+    ASSERT_EQ(0, lastIndex);
+
+    // the entries of two copysets are interleaved in one file
+    for (int64_t i = 1; i <= 10; ++i) {
+        Append(&wal, 1, 1, i, i);
+        Append(&wal, 2, 2, i, i);
+    }
+    ASSERT_EQ(1u, wal.FileCount());
+    for (int64_t i = 1; i <= 10; ++i) {
+        CheckEntry(&wal, 1, i, 1);
+        CheckEntry(&wal, 2, i, 2);
+    }
+    ASSERT_EQ(nullptr, wal.Get(1, 11));
+    ASSERT_EQ(nullptr, wal.Get(3, 1));
+    ASSERT_EQ(0, wal.GetTerm(1, 0));
+}
+
+TEST_F(SharedWalTest, ReplayTest) {
+    int64_t lastIndex = -1;
+    {
+        SharedWal wal(walDir_, copysetRoot_, 64 * 1024 * 1024);
+        ASSERT_EQ(0, wal.Init());
+        ASSERT_EQ(0, wal.Attach(1, 1, true, &confManager_, &lastIndex));
+        ASSERT_EQ(0, wal.Attach(2, 1, true, &confManager_, &lastIndex));
+        Append(&wal, 1, 1, 1, 10);
+        Append(&wal, 2, 1, 1, 10);
+        // conflicting entries of copyset 1 are overwritten
+        ASSERT_EQ(0, wal.TruncateSuffix(1, 5));
+        Append(&wal, 1, 2, 6, 8);
+        // copyset 2 installs a snapshot
+        ASSERT_EQ(0, wal.Reset(2, 100));
+        ASSERT_EQ(nullptr, wal.Get(2, 1));
+    }
+
+    SharedWal wal(walDir_, copysetRoot_, 64 * 1024 * 1024);
+    ASSERT_EQ(0, wal.Init());
+    ASSERT_EQ(2u, wal.FileCount());
+    ASSERT_EQ(0, wal.Attach(1, 1, false, &confManager_, &lastIndex));
+    ASSERT_EQ(8, lastIndex);
+    for (int64_t i = 1; i <= 5; ++i) {
+        CheckEntry(&wal, 1, i, 1);
+    }
+    for (int64_t i = 6; i <= 8; ++i) {
+        CheckEntry(&wal, 1, i, 2);
+    }
+    ASSERT_EQ(0, wal.Attach(2, 100, false, &confManager_, &lastIndex));
+    ASSERT_EQ(99, lastIndex);
+
+    // first index in the meta is larger than the first entry
+    wal.Detach(1);
+    ASSERT_EQ(0, wal.Attach(1, 4, false, &confManager_, &lastIndex));
+    ASSERT_EQ(8, lastIndex);
+    ASSERT_EQ(nullptr, wal.Get(1, 3));
+    CheckEntry(&wal, 1, 4, 1);
+
+    // a new copyset with the same id drops the stale entries
+    ASSERT_EQ(0, wal.Attach(1, 1, true, &confManager_, &lastIndex));
+    ASSERT_EQ(0, lastIndex);
+    ASSERT_EQ(nullptr, wal.Get(1, 4));
+}
+
+TEST_F(SharedWalTest, GarbageCollectTest) {
+    SharedWal wal(walDir_, copysetRoot_, 16 * 1024);
+    ASSERT_EQ(0, wal.Init());
+    int64_t lastIndex = -1;
+    ASSERT_EQ(0, wal.Attach(1, 1, true, &confManager_, &lastIndex));
+    ASSERT_EQ(0, wal.Attach(2, 1, true, &confManager_, &lastIndex));
+    for (int64_t i = 1; i <= 20; ++i) {
+        Append(&wal, 1, 1, i, i, 4096);
+    }
+    Append(&wal, 2, 1, 1, 1, 4096);
+    uint32_t fileCount = wal.FileCount();
+    ASSERT_GT(fileCount, 5u);
+
+    // the files are in use until both copysets truncate them
+    wal.TruncatePrefix(2, 2);
+    ASSERT_EQ(fileCount, wal.FileCount());
+    wal.TruncatePrefix(1, 10);
+    ASSERT_LT(wal.FileCount(), fileCount);
+    ASSERT_EQ(nullptr, wal.Get(1, 9));
+    CheckEntry(&wal, 1, 10, 1, 4096);
+
+    // all the files except the current one are deleted
+    wal.TruncatePrefix(1, 21);
+    ASSERT_EQ(1u, wal.FileCount());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
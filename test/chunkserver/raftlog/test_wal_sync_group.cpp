@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-22
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/chunkserver/raftlog/wal_sync_group.h"
+#include "test/chunkserver/raftlog/common.h"
+
+namespace curve {
+namespace chunkserver {
+
+const int kFileNum = 16;
+
+class WalSyncGroupTest : public testing::Test {
+ protected:
+    void SetUp() {
+        std::string cmd = std::string("mkdir ") + kRaftLogDataDir;
+        ::system(cmd.c_str());
+        for (int i = 0; i < kFileNum; ++i) {
+            std::string path = std::string(kRaftLogDataDir)
+                             + "sync_" + std::to_string(i);
+            int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            ASSERT_GE(fd, 0);
+            fds_.push_back(fd);
+        }
+    }
+    void TearDown() {
+        for (int fd : fds_) {
+            ::close(fd);
+        }
+        std::string cmd = std::string("rm -rf ") + kRaftLogDataDir;
+        ::system(cmd.c_str());
+    }
+
+    std::vector<int> fds_;
+};
+
+TEST_F(WalSyncGroupTest, ConcurrentSyncTest) {
+    WalSyncGroup group("test");
+    ASSERT_EQ(-1, group.Start(100, 0));
+    ASSERT_EQ(0, group.Start(1000, 8));
+
+    // every thread writes and syncs its own file like a copyset
+    std::vector<std::thread> threads;
+    std::vector<int> failed(kFileNum, 0);
+    for (int i = 0; i < kFileNum; ++i) {
+        threads.emplace_back([&, i]() {
+            char buf[4096] = {'a'};
+            ssize_t len = sizeof(buf);
+            for (int j = 0; j < 100; ++j) {
+                if (::pwrite(fds_[i], buf, len, j * len) != len ||
+                    group.Sync(fds_[i]) != 0) {
+                    ++failed[i];
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (int i = 0; i < kFileNum; ++i) {
+        ASSERT_EQ(0, failed[i]);
+    }
+
+    // the error of a fd is returned to its own requester
+    ASSERT_EQ(-EBADF, group.Sync(-1));
+
+    // sync alone after stopped
+    group.Stop();
+    ASSERT_EQ(0, group.Sync(fds_[0]));
+}
+
+TEST_F(WalSyncGroupTest, GetGroupTest) {
+    ASSERT_EQ(nullptr, WalSyncGroup::GetGroup("./not-exist-dir"));
+    WalSyncGroup* group = WalSyncGroup::GetGroup(kRaftLogDataDir);
+    ASSERT_NE(nullptr, group);
+    // the files on the same disk share one group
+    ASSERT_EQ(group, WalSyncGroup::GetGroup("./"));
+    ASSERT_EQ(0, group->Sync(fds_[0]));
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -125,8 +125,13 @@ TEST_F(ScanManagerTest, ScanJobTest) {
                 .Times(1).WillOnce(ReturnRef(failedMap));
     EXPECT_CALL(*copysetNode_, SetScan(_)).Times(2);
     EXPECT_CALL(*copysetNode_, SetLastScan(_)).Times(1);
-    EXPECT_CALL(*dataStore_, GetChunkMap())
-                .Times(1).WillOnce(Return(chunkMap));
+    EXPECT_CALL(*dataStore_, ForEachChunk(_))
+                .Times(1).WillOnce(Invoke([&chunkMap](
+                    const ChunkVisitor& visitor) {
+                    for (const auto& item : chunkMap) {
+                        visitor(item.first, item.second);
+                    }
+                }));
     EXPECT_CALL(*copysetNode_, ListPeers(_)).Times(1)
                 .WillOnce(SetArgPointee<0>(peers));
     EXPECT_CALL(*copysetNode_, IsLeaderTerm())
@@ -141,6 +146,71 @@ TEST_F(ScanManagerTest, ScanJobTest) {
     scanManager_->Fini();
 }
 
+TEST_F(ScanManagerTest, IncrementalScanJobTest) {
+    // the first scan after init is incremental
+    defaultOptions_.fullScanIntervalSec = 3600;
+    EXPECT_CALL(*copysetNodeManager_, GetCopysetNodeOptions())
+                .Times(1).WillOnce(ReturnRef(options));
+    ASSERT_EQ(0, scanManager_->Init(defaultOptions_));
+
+    // chunk 2 is not changed since last scan
+    std::shared_ptr<LocalFileSystem> lfs = LocalFsFactory::
+                                           CreateFs(FileSystemType::EXT4, "");
+    ChunkOptions chunkOptions;
+    chunkOptions.baseDir = "/";
+    CSChunkFile *cleanChunk = new CSChunkFile(lfs, nullptr, chunkOptions);
+    ChunkFileMetaPage metaPage2;
+    metaPage2.version = 2;
+    cleanChunk->SetChunkFileMetaPage(metaPage2);
+    cleanChunk->SetScanDirty(false);
+    ASSERT_TRUE(csChunkFile_->IsScanDirty());
+    ChunkMap chunkMap;
+    chunkMap.emplace(1, csChunkFile_);
+    chunkMap.emplace(2, cleanChunk);
+
+    scanManager_->Enqueue(1, 10000);
+    std::vector<ScanMap> failedMap;
+    std::vector<Peer> peers(3);
+    dataStore_ = std::make_shared<MockDataStore>();
+    copysetNode_ = std::make_shared<MockCopysetNode>();
+    EXPECT_CALL(*copysetNodeManager_, GetCopysetNode(_, _))
+                .Times(3).WillRepeatedly(Return(copysetNode_));
+    EXPECT_CALL(*copysetNode_, GetDataStore())
+                .Times(6).WillRepeatedly(Return(dataStore_));
+    EXPECT_CALL(*copysetNode_, GetFailedScanMap())
+                .Times(1).WillOnce(ReturnRef(failedMap));
+    EXPECT_CALL(*copysetNode_, SetScan(_)).Times(2);
+    EXPECT_CALL(*copysetNode_, SetLastScan(_)).Times(1);
+    EXPECT_CALL(*dataStore_, ForEachChunk(_))
+                .Times(1).WillOnce(Invoke([&chunkMap](
+                    const ChunkVisitor& visitor) {
+                    for (const auto& item : chunkMap) {
+                        visitor(item.first, item.second);
+                    }
+                }));
+    EXPECT_CALL(*copysetNode_, ListPeers(_)).Times(1)
+                .WillOnce(SetArgPointee<0>(peers));
+    EXPECT_CALL(*copysetNode_, IsLeaderTerm())
+                .Times(10).WillRepeatedly(Return(true));
+    // only the metapage and 4 slices of chunk 1 are scanned
+    EXPECT_CALL(*copysetNode_, Propose(_)).Times(5).
+                WillRepeatedly(Invoke([](const braft::Task& task){
+                task.done->Run();
+            }));
+
+    uint64_t skippedBytes =
+        ScanMetric::GetInstance().skippedBytes.get_value();
+    uint64_t incrementalCount =
+        ScanMetric::GetInstance().incrementalScanCount.get_value();
+    ASSERT_EQ(0, scanManager_->Run());
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    scanManager_->Fini();
+    ASSERT_EQ(skippedBytes + options.maxChunkSize,
+              ScanMetric::GetInstance().skippedBytes.get_value());
+    ASSERT_EQ(incrementalCount + 1,
+              ScanMetric::GetInstance().incrementalScanCount.get_value());
+}
+
 TEST_F(ScanManagerTest, CompareMapSuccessTest) {
     // make key
     ScanKey key(1, 10000);
@@ -432,8 +502,13 @@ TEST_F(ScanManagerTest, CancelScanJobAfterTransferLeaderTest) {
     EXPECT_CALL(*copysetNode_, GetFailedScanMap())
                 .Times(2).WillRepeatedly(ReturnRef(failedMap));
     EXPECT_CALL(*copysetNode_, SetScan(_)).Times(2);
-    EXPECT_CALL(*dataStore_, GetChunkMap())
-                .Times(1).WillOnce(Return(chunkMap));
+    EXPECT_CALL(*dataStore_, ForEachChunk(_))
+                .Times(1).WillOnce(Invoke([&chunkMap](
+                    const ChunkVisitor& visitor) {
+                    for (const auto& item : chunkMap) {
+                        visitor(item.first, item.second);
+                    }
+                }));
     EXPECT_CALL(*copysetNode_, ListPeers(_)).Times(1)
                 .WillOnce(SetArgPointee<0>(peers));
     EXPECT_CALL(*copysetNode_, IsLeaderTerm())
@@ -25,6 +25,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>  // NOLINT
 #include <tuple>
 #include <vector>
 
@@ -110,5 +112,92 @@ TEST_F(MetaCacheTest, TestCleanChunksInSegment) {
     }
 }
 
+namespace {
+
+CopysetInfo<ChunkServerID> MakeCopyset(LogicPoolID lpid, CopysetID cpid) {
+    CopysetInfo<ChunkServerID> copyset;
+    copyset.lpid_ = lpid;
+    copyset.cpid_ = cpid;
+    for (ChunkServerID id = 1; id <= 3; ++id) {
+        EndPoint ep;
+        butil::str2endpoint("127.0.0.1", 9000 + id, &ep);
+        copyset.AddCopysetPeerInfo(
+            CopysetPeerInfo<ChunkServerID>(id, PeerAddr(ep), PeerAddr(ep)));
+    }
+    return copyset;
+}
+
+}  // namespace
+
+TEST_F(MetaCacheTest, TestGetLeaderFromCache) {
+    auto copyset = MakeCopyset(1, 2);
+    copyset.UpdateLeaderIndex(1);
+    metaCache_.UpdateCopysetInfo(1, 2, copyset);
+
+    ChunkServerID id = 0;
+    EndPoint ep;
+    ASSERT_EQ(0, metaCache_.GetLeader(1, 2, &id, &ep));
+    ASSERT_EQ(2, id);
+    ASSERT_EQ(9002, ep.port);
+    ASSERT_EQ(-1, metaCache_.GetLeader(1, 3, &id, &ep));
+
+    // leader changed
+    EndPoint leader;
+    butil::str2endpoint("127.0.0.1", 9003, &leader);
+    ASSERT_EQ(0, metaCache_.UpdateLeader(1, 2, leader));
+    ASSERT_EQ(0, metaCache_.GetLeader(1, 2, &id, &ep));
+    ASSERT_EQ(3, id);
+    ASSERT_EQ(leader, ep);
+
+    // unstable chunkserver which is not the leader
+    metaCache_.AddCopysetIDInfo(1, CopysetIDInfo(1, 2));
+    metaCache_.AddCopysetIDInfo(3, CopysetIDInfo(1, 2));
+    metaCache_.SetChunkserverUnstable(1);
+    ASSERT_FALSE(metaCache_.IsLeaderMayChange(1, 2));
+
+    // unstable leader
+    metaCache_.SetChunkserverUnstable(3);
+    ASSERT_TRUE(metaCache_.IsLeaderMayChange(1, 2));
+    ASSERT_TRUE(metaCache_.GetCopysetinfo(1, 2).LeaderMayChange());
+
+    metaCache_.UpdateAppliedIndex(1, 2, 100);
+    ASSERT_EQ(100, metaCache_.GetAppliedIndex(1, 2));
+    ASSERT_EQ(0, metaCache_.GetAppliedIndex(1, 3));
+}
+
+TEST_F(MetaCacheTest, TestGetLeaderConcurrently) {
+    auto copyset = MakeCopyset(1, 2);
+    copyset.UpdateLeaderIndex(0);
+    metaCache_.UpdateCopysetInfo(1, 2, copyset);
+
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> mismatch(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            ChunkServerID id;
+            EndPoint ep;
+            while (!stop.load()) {
+                if (metaCache_.GetLeader(1, 2, &id, &ep) != 0 ||
+                    ep.port != static_cast<int>(9000 + id)) {
+                    ++mismatch;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 100000; ++i) {
+        EndPoint leader;
+        butil::str2endpoint("127.0.0.1", 9001 + i % 3, &leader);
+        ASSERT_EQ(0, metaCache_.UpdateLeader(1, 2, leader));
+    }
+
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    ASSERT_EQ(0, mismatch.load());
+}
+
 }  // namespace client
 }  // namespace curve
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-25
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/client/read_ahead.h"
+
+namespace curve {
+namespace client {
+
+namespace {
+
+const uint32_t kAlign = 4096;
+const uint64_t kFileLength = 1ULL << 30;
+
+ReadAheadOption MakeOption() {
+    ReadAheadOption opt;
+    opt.enable = true;
+    opt.initWindowKB = 64;
+    opt.maxWindowKB = 256;
+    opt.triggerCount = 2;
+    return opt;
+}
+
+}  // namespace
+
+TEST(StreamDetectorTest, TestSequentialTrigger) {
+    StreamDetector detector(MakeOption(), kAlign);
+    ReadAheadRange range;
+
+    // 第一个读请求不触发预读
+    ASSERT_FALSE(detector.OnRead(0, 16384, kFileLength, &range));
+
+    // 连续两个顺序读请求之后开始预读，从当前读请求的结束位置开始
+    ASSERT_TRUE(detector.OnRead(16384, 16384, kFileLength, &range));
+    ASSERT_EQ(32768, range.offset);
+    ASSERT_EQ(64 * 1024, range.length);
+
+    // 已预读的数据还有一半以上没有读到，不再预读
+    ASSERT_FALSE(detector.OnRead(32768, 16384, kFileLength, &range));
+
+    ASSERT_FALSE(detector.OnRead(49152, 16384, kFileLength, &range));
+
+    // 剩余不足半个窗口时发起下一次预读，窗口加倍
+    ASSERT_TRUE(detector.OnRead(65536, 16384, kFileLength, &range));
+    ASSERT_EQ(32768 + 64 * 1024, range.offset);
+    ASSERT_EQ(128 * 1024, range.length);
+}
+
+TEST(StreamDetectorTest, TestWindowGrowth) {
+    StreamDetector detector(MakeOption(), kAlign);
+    ReadAheadRange range;
+
+    uint64_t offset = 0;
+    uint64_t prefetchEnd = 0;
+    const uint64_t length = 65536;
+    for (int i = 0; i < 64; ++i) {
+        if (detector.OnRead(offset, length, kFileLength, &range)) {
+            // 预读范围连续且对齐，不超过最大窗口
+            if (prefetchEnd != 0) {
+                ASSERT_EQ(prefetchEnd, range.offset);
+            }
+            ASSERT_EQ(0, range.offset % kAlign);
+            ASSERT_LE(range.length, 256 * 1024);
+            prefetchEnd = range.offset + range.length;
+        }
+        offset += length;
+        if (i > 0) {
+            ASSERT_GT(prefetchEnd, offset);
+        }
+    }
+    ASSERT_EQ(256 * 1024, detector.Window());
+}
+
+TEST(StreamDetectorTest, TestRandomReset) {
+    StreamDetector detector(MakeOption(), kAlign);
+    ReadAheadRange range;
+
+    ASSERT_FALSE(detector.OnRead(0, 65536, kFileLength, &range));
+    ASSERT_TRUE(detector.OnRead(65536, 65536, kFileLength, &range));
+    ASSERT_TRUE(detector.OnRead(131072, 65536, kFileLength, &range));
+    ASSERT_EQ(128 * 1024, detector.Window());
+
+    // 非顺序的读请求重置窗口
+    ASSERT_FALSE(detector.OnRead(1 << 20, 4096, kFileLength, &range));
+    ASSERT_EQ(64 * 1024, detector.Window());
+    ASSERT_FALSE(detector.OnRead(0, 4096, kFileLength, &range));
+
+    // 落在预读范围内的乱序请求仍然认为是顺序的
+    ASSERT_TRUE(detector.OnRead(4096, 4096, kFileLength, &range));
+    ASSERT_EQ(8192, range.offset);
+    ASSERT_FALSE(detector.OnRead(16384, 4096, kFileLength, &range));
+    ASSERT_FALSE(detector.OnRead(12288, 4096, kFileLength, &range));
+}
+
+TEST(StreamDetectorTest, TestFileEnd) {
+    StreamDetector detector(MakeOption(), kAlign);
+    ReadAheadRange range;
+    const uint64_t fileLength = 81920;
+
+    ASSERT_FALSE(detector.OnRead(0, 8192, fileLength, &range));
+
+    // 预读范围不超过文件末尾
+    ASSERT_TRUE(detector.OnRead(8192, 8192, fileLength, &range));
+    ASSERT_EQ(16384, range.offset);
+    ASSERT_EQ(fileLength - 16384, range.length);
+
+    ASSERT_FALSE(detector.OnRead(16384, 65536, fileLength, &range));
+}
+
+}  // namespace client
+}  // namespace curve
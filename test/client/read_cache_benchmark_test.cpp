@@ -0,0 +1,171 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-24
+ */
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/client/read_cache.h"
+#include "src/common/timeutility.h"
+
+// 参数与fio的同名参数含义相同
+DEFINE_string(read_cache_bench_rw, "randrw",
+              "io pattern, read/randread/randrw");
+DEFINE_uint32(read_cache_bench_bs, 4096, "io size");
+DEFINE_uint64(read_cache_bench_size_mb, 512, "size of the file");
+DEFINE_uint32(read_cache_bench_rwmixread, 90,
+              "percentage of reads in randrw");
+DEFINE_uint32(read_cache_bench_numjobs, 4, "threads issuing io");
+DEFINE_uint64(read_cache_bench_ios, 200000, "ios issued by each thread");
+DEFINE_uint64(read_cache_bench_capacity_mb, 256, "read cache capacity");
+DEFINE_uint32(read_cache_bench_miss_latency_us, 0,
+              "latency added to reads missing the cache, simulates the "
+              "round trip to chunkserver");
+
+namespace curve {
+namespace client {
+
+using curve::common::TimeUtility;
+
+// 测量读缓存在fio类似负载下的命中率以及IOPS，未命中的读请求
+// 从内存中的数据返回并填充缓存
+class ReadCacheBenchmark : public ::testing::TestWithParam<bool> {
+ protected:
+    void SetUp() override {
+        uint64_t capacity = FLAGS_read_cache_bench_capacity_mb * 1024 * 1024;
+        if (GetParam()) {
+            path_ = "./read_cache_bench_" + std::to_string(getpid());
+            std::shared_ptr<SharedReadCacheStore> store =
+                std::make_shared<SharedReadCacheStore>(kBlockSize, capacity,
+                                                       path_);
+            ASSERT_TRUE(store->Init());
+            store_ = store;
+        } else {
+            store_ = std::make_shared<MemoryReadCacheStore>(kBlockSize,
+                                                            capacity);
+        }
+        cache_.reset(new FileReadCache(store_, 1, nullptr));
+        cache_->UpdateVersion(1, 1, 1);
+    }
+
+    void TearDown() override {
+        cache_.reset();
+        store_.reset();
+        if (!path_.empty()) {
+            unlink(path_.c_str());
+        }
+    }
+
+    void RunThread(int seed) {
+        const uint64_t bs = FLAGS_read_cache_bench_bs;
+        const uint64_t blocks = FLAGS_read_cache_bench_size_mb * 1024 * 1024 /
+                                bs;
+        const std::string& rw = FLAGS_read_cache_bench_rw;
+        std::mt19937_64 rand(seed);
+        std::vector<char> buf(bs);
+        butil::IOBuf data;
+        data.append(std::string(bs, 'a'));
+        uint64_t next = seed * blocks / FLAGS_read_cache_bench_numjobs;
+
+        for (uint64_t i = 0; i < FLAGS_read_cache_bench_ios; ++i) {
+            off_t offset;
+            if (rw == "read") {
+                offset = (next++ % blocks) * bs;
+            } else {
+                offset = rand() % blocks * bs;
+            }
+
+            if (rw == "randrw" &&
+                rand() % 100 >= FLAGS_read_cache_bench_rwmixread) {
+                cache_->BeginWrite(offset, bs);
+                cache_->EndWrite(offset, bs);
+                ++writes_;
+                continue;
+            }
+
+            if (cache_->Read(offset, bs, buf.data())) {
+                ++hits_;
+                continue;
+            }
+
+            auto token = cache_->BeginFill();
+            if (FLAGS_read_cache_bench_miss_latency_us > 0) {
+                usleep(FLAGS_read_cache_bench_miss_latency_us);
+            }
+            cache_->Fill(token, offset, bs, data);
+            ++misses_;
+        }
+    }
+
+ protected:
+    static const uint32_t kBlockSize = 4096;
+
+    std::string path_;
+    std::shared_ptr<ReadCacheStore> store_;
+    std::unique_ptr<FileReadCache> cache_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> writes_{0};
+};
+
+const uint32_t ReadCacheBenchmark::kBlockSize;
+
+TEST_P(ReadCacheBenchmark, Run) {
+    const uint32_t numjobs = FLAGS_read_cache_bench_numjobs;
+    std::vector<std::thread> workers;
+
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    for (uint32_t i = 0; i < numjobs; ++i) {
+        workers.emplace_back([this, i]() { RunThread(i); });
+    }
+    for (auto& t : workers) {
+        t.join();
+    }
+    uint64_t elapsedUs = TimeUtility::GetTimeofDayUs() - startUs;
+
+    uint64_t reads = hits_ + misses_;
+    uint64_t ios = reads + writes_;
+    ASSERT_EQ(numjobs * FLAGS_read_cache_bench_ios, ios);
+    LOG(INFO) << "read cache benchmark, store: "
+              << (GetParam() ? "shared" : "memory")
+              << ", rw: " << FLAGS_read_cache_bench_rw
+              << ", bs: " << FLAGS_read_cache_bench_bs
+              << ", numjobs: " << numjobs
+              << ", iops: " << ios * 1000000 / (elapsedUs + 1)
+              << ", read bw: "
+              << reads * FLAGS_read_cache_bench_bs / (elapsedUs + 1)
+              << " MB/s"
+              << ", hit ratio: " << (reads ? hits_ * 100 / reads : 0) << "%";
+}
+
+INSTANTIATE_TEST_CASE_P(ReadCacheBenchmark, ReadCacheBenchmark,
+                        ::testing::Values(false, true));
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,266 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-24
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "src/client/read_cache.h"
+
+namespace curve {
+namespace client {
+
+namespace {
+
+const uint32_t kBlockSize = 4096;
+const uint64_t kClusterId = 1;
+
+butil::IOBuf MakeData(size_t length, char c) {
+    butil::IOBuf data;
+    data.append(std::string(length, c));
+    return data;
+}
+
+}  // namespace
+
+class FileReadCacheTest : public ::testing::TestWithParam<bool> {
+ protected:
+    void SetUp() override {
+        if (GetParam()) {
+            path_ = "./read_cache_test_" + std::to_string(getpid());
+            std::shared_ptr<SharedReadCacheStore> store =
+                std::make_shared<SharedReadCacheStore>(kBlockSize,
+                                                       1024 * kBlockSize,
+                                                       path_);
+            ASSERT_TRUE(store->Init());
+            store_ = store;
+        } else {
+            store_ = std::make_shared<MemoryReadCacheStore>(
+                kBlockSize, 1024 * kBlockSize);
+        }
+
+        cache_.reset(new FileReadCache(store_, kClusterId, nullptr));
+        cache_->UpdateVersion(1, 1, 1);
+    }
+
+    void TearDown() override {
+        cache_.reset();
+        store_.reset();
+        if (!path_.empty()) {
+            unlink(path_.c_str());
+        }
+    }
+
+ protected:
+    std::string path_;
+    std::shared_ptr<ReadCacheStore> store_;
+    std::unique_ptr<FileReadCache> cache_;
+};
+
+TEST_P(FileReadCacheTest, TestFillAndRead) {
+    char buf[4 * kBlockSize];
+
+    ASSERT_FALSE(cache_->Read(0, kBlockSize, buf));
+
+    // 只填充完整覆盖的块，即[4096, 12288)
+    auto token = cache_->BeginFill();
+    cache_->Fill(token, 512, 3 * kBlockSize, MakeData(3 * kBlockSize, 'a'));
+    ASSERT_FALSE(cache_->Read(0, kBlockSize, buf));
+    ASSERT_FALSE(cache_->Read(3 * kBlockSize, kBlockSize, buf));
+    ASSERT_TRUE(cache_->Read(kBlockSize, 2 * kBlockSize, buf));
+    ASSERT_EQ(std::string(2 * kBlockSize, 'a'),
+              std::string(buf, 2 * kBlockSize));
+
+    // 不对齐的读请求也可以由缓存返回
+    ASSERT_TRUE(cache_->Read(kBlockSize + 512, kBlockSize, buf));
+    ASSERT_EQ(std::string(kBlockSize, 'a'), std::string(buf, kBlockSize));
+
+    // 部分命中时不由缓存返回
+    ASSERT_FALSE(cache_->Read(kBlockSize, 3 * kBlockSize, buf));
+}
+
+TEST_P(FileReadCacheTest, TestWriteInvalidate) {
+    char buf[2 * kBlockSize];
+
+    auto token = cache_->BeginFill();
+    cache_->Fill(token, 0, 2 * kBlockSize, MakeData(2 * kBlockSize, 'a'));
+    ASSERT_TRUE(cache_->Read(0, 2 * kBlockSize, buf));
+
+    // 写请求淘汰所有重叠的块
+    cache_->BeginWrite(kBlockSize + 512, 512);
+    ASSERT_TRUE(cache_->Read(0, kBlockSize, buf));
+    ASSERT_FALSE(cache_->Read(kBlockSize, kBlockSize, buf));
+    cache_->EndWrite(kBlockSize + 512, 512);
+
+    // 读请求开始后有写请求，读到的数据不填充缓存
+    token = cache_->BeginFill();
+    cache_->BeginWrite(0, 512);
+    cache_->EndWrite(0, 512);
+    cache_->Fill(token, 0, 2 * kBlockSize, MakeData(2 * kBlockSize, 'b'));
+    ASSERT_FALSE(cache_->Read(0, kBlockSize, buf));
+    ASSERT_FALSE(cache_->Read(kBlockSize, kBlockSize, buf));
+
+    // 写请求结束之后开始的读请求可以填充
+    token = cache_->BeginFill();
+    cache_->Fill(token, 0, 2 * kBlockSize, MakeData(2 * kBlockSize, 'c'));
+    ASSERT_TRUE(cache_->Read(0, 2 * kBlockSize, buf));
+    ASSERT_EQ(std::string(2 * kBlockSize, 'c'),
+              std::string(buf, 2 * kBlockSize));
+}
+
+TEST_P(FileReadCacheTest, TestVersionChange) {
+    char buf[kBlockSize];
+
+    auto token = cache_->BeginFill();
+    cache_->Fill(token, 0, kBlockSize, MakeData(kBlockSize, 'a'));
+    ASSERT_TRUE(cache_->Read(0, kBlockSize, buf));
+
+    // 打快照后sn变化
+    cache_->UpdateVersion(1, 2, 1);
+    ASSERT_FALSE(cache_->Read(0, kBlockSize, buf));
+
+    // epoch变化
+    token = cache_->BeginFill();
+    cache_->Fill(token, 0, kBlockSize, MakeData(kBlockSize, 'b'));
+    ASSERT_TRUE(cache_->Read(0, kBlockSize, buf));
+    cache_->UpdateVersion(1, 2, 2);
+    ASSERT_FALSE(cache_->Read(0, kBlockSize, buf));
+
+    // 读请求期间版本变化，填充的块不会被读到
+    token = cache_->BeginFill();
+    cache_->UpdateVersion(1, 3, 2);
+    cache_->Fill(token, 0, kBlockSize, MakeData(kBlockSize, 'c'));
+    ASSERT_FALSE(cache_->Read(0, kBlockSize, buf));
+
+    // 不同文件的缓存相互独立
+    FileReadCache other(store_, kClusterId, nullptr);
+    other.UpdateVersion(2, 3, 2);
+    token = other.BeginFill();
+    other.Fill(token, 0, kBlockSize, MakeData(kBlockSize, 'd'));
+    ASSERT_TRUE(other.Read(0, kBlockSize, buf));
+    ASSERT_FALSE(cache_->Read(0, kBlockSize, buf));
+
+    // 不同集群中id相同的文件也相互独立
+    FileReadCache otherCluster(store_, kClusterId + 1, nullptr);
+    otherCluster.UpdateVersion(2, 3, 2);
+    ASSERT_FALSE(otherCluster.Read(0, kBlockSize, buf));
+}
+
+INSTANTIATE_TEST_CASE_P(FileReadCacheTest, FileReadCacheTest,
+                        ::testing::Values(false, true));
+
+TEST(ReadCacheStoreTest, TestMemoryStoreCapacity) {
+    // 每个分片最少保存一个块
+    MemoryReadCacheStore store(kBlockSize, 64 * kBlockSize);
+    ReadCacheKey key{kClusterId, 1, 1, 0};
+    butil::IOBuf data = MakeData(kBlockSize, 'a');
+    for (key.blockIndex = 0; key.blockIndex < 1024; ++key.blockIndex) {
+        store.Put(key, data, 0);
+    }
+
+    char buf[kBlockSize];
+    uint64_t cached = 0;
+    for (key.blockIndex = 0; key.blockIndex < 1024; ++key.blockIndex) {
+        if (store.Get(key, 0, kBlockSize, buf)) {
+            ++cached;
+        }
+    }
+    ASSERT_LE(cached, 64);
+    ASSERT_GT(cached, 0);
+
+    // 最近写入的块不会被淘汰
+    key.blockIndex = 1023;
+    ASSERT_TRUE(store.Get(key, 0, kBlockSize, buf));
+}
+
+TEST(ReadCacheStoreTest, TestSharedStoreReopen) {
+    std::string path = "./read_cache_reopen_" + std::to_string(getpid());
+    ReadCacheKey key{kClusterId, 1, 1, 7};
+    char buf[kBlockSize];
+    {
+        SharedReadCacheStore store(kBlockSize, 16 * kBlockSize, path);
+        ASSERT_TRUE(store.Init());
+        store.Put(key, MakeData(kBlockSize, 'a'), 0);
+    }
+
+    // 其他进程打开时可以读到之前的缓存
+    {
+        SharedReadCacheStore store(kBlockSize, 16 * kBlockSize, path);
+        ASSERT_TRUE(store.Init());
+        ASSERT_TRUE(store.Get(key, 512, 512, buf));
+        ASSERT_EQ(std::string(512, 'a'), std::string(buf, 512));
+        store.Remove(key);
+        ASSERT_FALSE(store.Get(key, 0, kBlockSize, buf));
+    }
+
+    // 布局不同时打开失败
+    {
+        SharedReadCacheStore store(kBlockSize, 32 * kBlockSize, path);
+        ASSERT_FALSE(store.Init());
+    }
+
+    unlink(path.c_str());
+}
+
+TEST(ReadCacheStoreTest, TestSharedStoreWriteGen) {
+    std::string path = "./read_cache_write_gen_" + std::to_string(getpid());
+    char buf[kBlockSize];
+
+    // 两个store映射同一个文件，模拟同一主机上的两个进程
+    std::shared_ptr<SharedReadCacheStore> writerStore =
+        std::make_shared<SharedReadCacheStore>(kBlockSize, 16 * kBlockSize,
+                                               path);
+    ASSERT_TRUE(writerStore->Init());
+    std::shared_ptr<SharedReadCacheStore> readerStore =
+        std::make_shared<SharedReadCacheStore>(kBlockSize, 16 * kBlockSize,
+                                               path);
+    ASSERT_TRUE(readerStore->Init());
+
+    FileReadCache writer(writerStore, kClusterId, nullptr);
+    writer.UpdateVersion(1, 1, 1);
+    FileReadCache reader(readerStore, kClusterId, nullptr);
+    reader.UpdateVersion(1, 1, 1);
+
+    // 读请求开始后其他进程有写请求，读到的旧数据不填充缓存
+    auto token = reader.BeginFill();
+    writer.BeginWrite(0, 512);
+    writer.EndWrite(0, 512);
+    reader.Fill(token, 0, kBlockSize, MakeData(kBlockSize, 'a'));
+    ASSERT_FALSE(reader.Read(0, kBlockSize, buf));
+    ASSERT_FALSE(writer.Read(0, kBlockSize, buf));
+
+    // 其他集群的写请求不影响填充
+    FileReadCache otherCluster(writerStore, kClusterId + 1, nullptr);
+    otherCluster.UpdateVersion(1, 1, 1);
+    token = reader.BeginFill();
+    otherCluster.BeginWrite(0, 512);
+    otherCluster.EndWrite(0, 512);
+    reader.Fill(token, 0, kBlockSize, MakeData(kBlockSize, 'b'));
+    ASSERT_TRUE(writer.Read(0, kBlockSize, buf));
+    ASSERT_EQ(std::string(kBlockSize, 'b'), std::string(buf, kBlockSize));
+
+    unlink(path.c_str());
+}
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-26
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "src/client/replica_selector.h"
+
+namespace curve {
+namespace client {
+
+namespace {
+
+std::vector<CopysetPeerInfo<ChunkServerID>> MakePeers() {
+    std::vector<CopysetPeerInfo<ChunkServerID>> peers;
+    for (ChunkServerID id = 1; id <= 3; ++id) {
+        CopysetPeerInfo<ChunkServerID> peer;
+        peer.peerID = id;
+        peers.push_back(peer);
+    }
+    return peers;
+}
+
+}  // namespace
+
+TEST(ReplicaSelectorTest, TestSpreadWithoutHistory) {
+    ReplicaSelector selector;
+    auto peers = MakePeers();
+
+    ASSERT_EQ(-1, selector.Select({}));
+
+    // 没有延时记录时按inflight请求数选择，请求分散到所有副本
+    std::vector<int> count(peers.size(), 0);
+    for (int i = 0; i < 30; ++i) {
+        int index = selector.Select(peers);
+        ASSERT_GE(index, 0);
+        selector.OnSend(peers[index].peerID);
+        ++count[index];
+    }
+    for (int c : count) {
+        ASSERT_EQ(10, c);
+    }
+}
+
+TEST(ReplicaSelectorTest, TestPreferLowLatency) {
+    ReplicaSelector selector;
+    auto peers = MakePeers();
+
+    selector.OnSend(1);
+    selector.OnDone(1, 5000, false);
+    selector.OnSend(2);
+    selector.OnDone(2, 100, false);
+    selector.OnSend(3);
+    selector.OnDone(3, 1000, false);
+
+    ASSERT_EQ(1, selector.Select(peers));
+
+    // inflight请求多时选择其他副本
+    for (int i = 0; i < 10; ++i) {
+        selector.OnSend(2);
+    }
+    ASSERT_EQ(2, selector.Select(peers));
+}
+
+TEST(ReplicaSelectorTest, TestAvoidFailedPeer) {
+    ReplicaSelector selector;
+    auto peers = MakePeers();
+
+    for (ChunkServerID id = 1; id <= 3; ++id) {
+        selector.OnSend(id);
+        selector.OnDone(id, 1000, false);
+    }
+
+    // 失败的副本之后不会被选中
+    selector.OnSend(1);
+    selector.OnDone(1, 100, true);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_NE(0, selector.Select(peers));
+    }
+}
+
+}  // namespace client
+}  // namespace curve
@@ -26,8 +26,11 @@
 #include <brpc/channel.h>
 #include <butil/iobuf.h>
 
+#include <atomic>
+
 #include "src/client/request_scheduler.h"
 #include "src/client/client_common.h"
+#include "src/client/iomanager.h"
 #include "test/client/mock/mock_meta_cache.h"
 #include "test/client/mock/mock_chunkservice.h"
 #include "test/client/mock/mock_request_context.h"
@@ -38,6 +41,23 @@ namespace client {
 
 using ::testing::AnyNumber;
 
+// count the inflight rpc tokens taken by the requests
+class TokenCountIOManager : public IOManager {
+ public:
+    void GetInflightRpcToken() override {
+        ++taken;
+    }
+
+    void ReleaseInflightRpcToken() override {
+        ++released;
+    }
+
+    void HandleAsyncIOResponse(IOTracker* iotracker) override {}
+
+    std::atomic<int> taken{0};
+    std::atomic<int> released{0};
+};
+
 TEST(RequestSchedulerTest, fake_server_test) {
     RequestScheduleOption opt;
     opt.scheduleQueueCapacity = 4096;
@@ -567,6 +587,116 @@ TEST(RequestSchedulerTest, fake_server_test) {
     ASSERT_EQ(0, server.Join());
 }
 
+TEST(RequestSchedulerTest, CoalesceTest) {
+    RequestScheduleOption opt;
+    opt.scheduleQueueCapacity = 4096;
+    opt.scheduleThreadpoolSize = 1;
+    opt.ioSenderOpt.failRequestOpt.chunkserverRPCTimeoutMS = 200;
+    opt.ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry = 5;
+    opt.ioSenderOpt.failRequestOpt.chunkserverOPRetryIntervalUS = 5000;
+    opt.coalesceOpt.enable = true;
+    opt.coalesceOpt.maxBytes = 4096;
+    opt.coalesceOpt.maxDelayUs = 100 * 1000;
+
+    brpc::Server server;
+    std::string listenAddr = "127.0.0.1:9109";
+    FakeChunkServiceImpl fakeChunkService;
+    ASSERT_EQ(server.AddService(&fakeChunkService,
+                                brpc::SERVER_DOESNT_OWN_SERVICE), 0);
+    brpc::ServerOptions option;
+    option.idle_timeout_sec = -1;
+    ASSERT_EQ(server.Start(listenAddr.c_str(), &option), 0);
+
+    RequestScheduler requestScheduler;
+    MockMetaCache mockMetaCache;
+    mockMetaCache.DelegateToFake();
+    EXPECT_CALL(mockMetaCache, GetLeader(_, _, _, _, _, _))
+        .Times(AnyNumber());
+
+    FileMetric fm("coalesce_test");
+    IOTracker iot(nullptr, nullptr, nullptr, &fm);
+    TokenCountIOManager ioManager;
+    ASSERT_EQ(0, requestScheduler.Init(opt, &mockMetaCache, &fm));
+
+    const size_t len = 8;
+    auto newRequest = [&](OpType type, off_t offset, char c,
+                          curve::common::CountDownEvent* cond) {
+        RequestContext *reqCtx = new FakeRequestContext();
+        reqCtx->optype_ = type;
+        reqCtx->idinfo_ = ChunkIDInfo(1, 1, 100001);
+        reqCtx->offset_ = offset;
+        reqCtx->rawlength_ = len;
+        if (type == OpType::WRITE) {
+            reqCtx->writeData_.append(std::string(len, c));
+        }
+
+        RequestClosure *reqDone = new FakeRequestClosure(cond, reqCtx);
+        reqDone->SetFileMetric(&fm);
+        reqDone->SetIOTracker(&iot);
+        reqDone->SetIOManager(&ioManager);
+        reqCtx->done_ = reqDone;
+        return reqCtx;
+    };
+
+    // adjacent writes queued before running are sent in one rpc
+    {
+        curve::common::CountDownEvent cond(4);
+        std::vector<RequestContext *> reqCtxs;
+        for (int i = 0; i < 4; i++) {
+            reqCtxs.push_back(newRequest(OpType::WRITE, i * len, 'a' + i,
+                                         &cond));
+            requestScheduler.GetQueue()->PutBack(
+                BBQItem<RequestContext*>(reqCtxs.back()));
+        }
+        ASSERT_EQ(0, requestScheduler.Run());
+        cond.Wait();
+        for (auto reqCtx : reqCtxs) {
+            ASSERT_EQ(0, reqCtx->done_->GetErrorCode());
+        }
+        ASSERT_EQ(1, fm.coalescedRPC.count.get_value());
+        ASSERT_EQ(3, fm.coalesceSavedRPC.count.get_value());
+        // one inflight token for the coalesced rpc
+        ASSERT_EQ(1, ioManager.taken.load());
+        ASSERT_EQ(1, ioManager.released.load());
+    }
+
+    // the thread serving sequential requests waits for the adjacent reads,
+    // and the read data is split to each request
+    {
+        curve::common::CountDownEvent cond(4);
+        std::vector<RequestContext *> reqCtxs;
+        for (int i = 0; i < 4; i++) {
+            reqCtxs.push_back(newRequest(OpType::READ, i * len, 0, &cond));
+        }
+        ASSERT_EQ(0, requestScheduler.ScheduleRequest(reqCtxs));
+        cond.Wait();
+        for (int i = 0; i < 4; i++) {
+            ASSERT_EQ(0, reqCtxs[i]->done_->GetErrorCode());
+            ASSERT_EQ(std::string(len, 'a' + i),
+                      reqCtxs[i]->readData_.to_string());
+        }
+        ASSERT_EQ(2, fm.coalescedRPC.count.get_value());
+        ASSERT_EQ(6, fm.coalesceSavedRPC.count.get_value());
+    }
+
+    // requests not adjacent are sent one by one
+    {
+        curve::common::CountDownEvent cond(2);
+        std::vector<RequestContext *> reqCtxs;
+        reqCtxs.push_back(newRequest(OpType::READ, 0, 0, &cond));
+        reqCtxs.push_back(newRequest(OpType::READ, 4 * len, 0, &cond));
+        ASSERT_EQ(0, requestScheduler.ScheduleRequest(reqCtxs));
+        cond.Wait();
+        ASSERT_EQ(std::string(len, 'a'), reqCtxs[0]->readData_.to_string());
+        ASSERT_EQ(2, fm.coalescedRPC.count.get_value());
+        ASSERT_EQ(6, fm.coalesceSavedRPC.count.get_value());
+    }
+
+    requestScheduler.Fini();
+    ASSERT_EQ(0, server.Stop(0));
+    ASSERT_EQ(0, server.Join());
+}
+
 TEST(RequestSchedulerTest, CommonTest) {
     RequestScheduleOption opt;
     opt.scheduleQueueCapacity = 4096;
@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-23
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/client/segment_table.h"
+
+namespace curve {
+namespace client {
+
+TEST(SegmentTableTest, TestUpdateAndGet) {
+    SegmentTable table;
+    table.Init(100 * GiB, 1 * GiB, 16 * MiB, 4 * KiB);
+    ASSERT_EQ(64, table.ChunksPerSegment());
+
+    ChunkIDInfo info;
+    ASSERT_FALSE(table.GetChunkInfo(0, &info));
+    uint64_t initBytes = table.MemoryUsage();
+
+    // 只分配访问过的segment对应的页
+    table.UpdateChunkInfo(65, ChunkIDInfo(100, 1, 2));
+    ASSERT_TRUE(table.GetChunkInfo(65, &info));
+    ASSERT_EQ(100, info.cid_);
+    ASSERT_EQ(1, info.lpid_);
+    ASSERT_EQ(2, info.cpid_);
+    ASSERT_FALSE(table.GetChunkInfo(64, &info));
+    ASSERT_FALSE(table.GetChunkInfo(0, &info));
+    uint64_t onePageBytes = table.MemoryUsage() - initBytes;
+    ASSERT_GT(onePageBytes, 64 * sizeof(ChunkIDInfo) / 2);
+
+    // 同一页内的更新不再分配内存
+    table.UpdateChunkInfo(127, ChunkIDInfo(101, 1, 3));
+    ASSERT_EQ(initBytes + onePageBytes, table.MemoryUsage());
+
+    // FileSegment与chunk信息共用一页
+    FileSegment* segment = table.GetFileSegment(1);
+    ASSERT_EQ(segment, table.GetFileSegment(1));
+    ASSERT_EQ(initBytes + onePageBytes, table.MemoryUsage());
+    ASSERT_NE(segment, table.GetFileSegment(2));
+    ASSERT_EQ(initBytes + 2 * onePageBytes, table.MemoryUsage());
+
+    // 清除跨页的范围
+    table.UpdateChunkInfo(128, ChunkIDInfo(102, 1, 4));
+    table.CleanChunks(100, 129);
+    ASSERT_TRUE(table.GetChunkInfo(65, &info));
+    ASSERT_FALSE(table.GetChunkInfo(127, &info));
+    ASSERT_FALSE(table.GetChunkInfo(128, &info));
+}
+
+TEST(SegmentTableTest, TestLayout) {
+    SegmentTable table;
+    ASSERT_EQ(SegmentTable::kDefaultChunksPerSegment,
+              table.ChunksPerSegment());
+
+    // 非法的布局被忽略
+    table.Init(100 * GiB, 1 * GiB, 0, 4 * KiB);
+    ASSERT_EQ(SegmentTable::kDefaultChunksPerSegment,
+              table.ChunksPerSegment());
+
+    table.Init(100 * GiB, 512 * MiB, 16 * MiB, 4 * KiB);
+    ASSERT_EQ(32, table.ChunksPerSegment());
+
+    // 已分配页之后不再改变布局
+    table.UpdateChunkInfo(0, ChunkIDInfo(1, 1, 1));
+    table.Init(100 * GiB, 1 * GiB, 16 * MiB, 4 * KiB);
+    ASSERT_EQ(32, table.ChunksPerSegment());
+
+    ChunkIDInfo info;
+    ASSERT_TRUE(table.GetChunkInfo(0, &info));
+    ASSERT_EQ(1, info.cid_);
+}
+
+TEST(SegmentTableTest, TestGrowDirectory) {
+    // 未设置布局时目录按需扩容
+    SegmentTable table;
+    const ChunkIndex kChunks = 64 * 1000;
+    for (ChunkIndex idx = 0; idx < kChunks; idx += 7) {
+        table.UpdateChunkInfo(idx, ChunkIDInfo(idx + 1, 1, idx % 100));
+    }
+
+    ChunkIDInfo info;
+    for (ChunkIndex idx = 0; idx < kChunks; ++idx) {
+        if (idx % 7 == 0) {
+            ASSERT_TRUE(table.GetChunkInfo(idx, &info));
+            ASSERT_EQ(idx + 1, info.cid_);
+            ASSERT_EQ(idx % 100, info.cpid_);
+        } else {
+            ASSERT_FALSE(table.GetChunkInfo(idx, &info));
+        }
+    }
+}
+
+TEST(SegmentTableTest, TestConcurrentUpdateAndGet) {
+    SegmentTable table;
+    table.Init(64 * GiB, 1 * GiB, 16 * MiB, 4 * KiB);
+    const ChunkIndex kChunks = 64 * 64;
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> torn(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            ChunkIDInfo info;
+            ChunkIndex idx = 0;
+            while (!stop.load()) {
+                // 写入时chunk id、copyset id和logical pool id保持一致
+                if (table.GetChunkInfo(idx, &info) &&
+                    (info.cid_ != info.cpid_ || info.cid_ != info.lpid_)) {
+                    ++torn;
+                }
+                idx = (idx + 13) % kChunks;
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 2; ++i) {
+        writers.emplace_back([&table, i, kChunks]() {
+            for (uint32_t n = 1; n <= 50; ++n) {
+                for (ChunkIndex idx = i; idx < kChunks; idx += 2) {
+                    table.UpdateChunkInfo(idx, ChunkIDInfo(n, n, n));
+                }
+                table.CleanChunks(0, kChunks / 2);
+            }
+        });
+    }
+
+    for (auto& t : writers) {
+        t.join();
+    }
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    ASSERT_EQ(0, torn.load());
+}
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-22
+ */
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/client/io_tracker.h"
+#include "src/client/mds_client.h"
+#include "src/client/metacache.h"
+#include "src/client/splitor.h"
+#include "src/common/timeutility.h"
+
+DEFINE_uint64(splitor_bench_ios, 200000, "ios issued by each thread");
+
+namespace curve {
+namespace client {
+
+using curve::common::TimeUtility;
+
+// 测量多线程下IO拆分以及获取leader的吞吐，即每个IO在client端查询metacache的开销
+class SplitorBenchmark : public ::testing::TestWithParam<int> {
+ protected:
+    void SetUp() override {
+        IOSplitOption splitOpt;
+        splitOpt.fileIOSplitMaxSizeKB = 64;
+        Splitor::Init(splitOpt);
+
+        fileInfo_.fullPathName = "/SplitorBenchmark";
+        fileInfo_.length = kFileLength;
+        fileInfo_.segmentsize = kSegmentSize;
+        fileInfo_.chunksize = kChunkSize;
+        metaCache_.UpdateFileInfo(fileInfo_);
+
+        for (CopysetID cpid = 1; cpid <= kCopysets; ++cpid) {
+            CopysetInfo<ChunkServerID> copyset;
+            copyset.lpid_ = 1;
+            copyset.cpid_ = cpid;
+            for (ChunkServerID id = 1; id <= 3; ++id) {
+                EndPoint ep;
+                butil::str2endpoint("127.0.0.1", 9000 + id, &ep);
+                copyset.AddCopysetPeerInfo(CopysetPeerInfo<ChunkServerID>(
+                    id, PeerAddr(ep), PeerAddr(ep)));
+            }
+            copyset.UpdateLeaderIndex(cpid % 3);
+            metaCache_.UpdateCopysetInfo(1, cpid, copyset);
+        }
+
+        for (ChunkIndex idx = 0; idx < kFileLength / kChunkSize; ++idx) {
+            metaCache_.UpdateChunkInfoByIndex(
+                idx, ChunkIDInfo(idx + 1, 1, idx % kCopysets + 1));
+        }
+    }
+
+    void RunThread(int seed, std::atomic<uint64_t>* failed) {
+        std::mt19937_64 rand(seed);
+        std::vector<RequestContext*> requests;
+        ChunkServerID leaderId;
+        EndPoint leaderAddr;
+
+        for (uint64_t i = 0; i < FLAGS_splitor_bench_ios; ++i) {
+            off_t offset = rand() % (kFileLength / kIOSize) * kIOSize;
+
+            // segment的读锁在IO返回时释放，这里没有请求获取写锁
+            IOTracker iotracker(nullptr, &metaCache_, nullptr, nullptr);
+            iotracker.SetOpType(OpType::READ);
+            int ret = Splitor::IO2ChunkRequests(
+                &iotracker, &metaCache_, &requests, nullptr, offset, kIOSize,
+                &mdsClient_, metaCache_.GetFileInfo(),
+                metaCache_.GetFileEpoch());
+            if (ret != 0 || requests.size() != 1) {
+                ++*failed;
+            }
+
+            for (auto* request : requests) {
+                // 与RequestSender下发请求前相同，查询copyset的leader
+                if (metaCache_.GetLeader(request->idinfo_.lpid_,
+                                         request->idinfo_.cpid_, &leaderId,
+                                         &leaderAddr) != 0) {
+                    ++*failed;
+                }
+                request->UnInit();
+                delete request;
+            }
+            requests.clear();
+        }
+    }
+
+ protected:
+    static constexpr uint64_t kFileLength = 4ull * 1024 * 1024 * 1024 * 1024;
+    static constexpr uint64_t kSegmentSize = 1ull * 1024 * 1024 * 1024;
+    static constexpr uint64_t kChunkSize = 16ull * 1024 * 1024;
+    static constexpr uint64_t kIOSize = 4096;
+    static constexpr CopysetID kCopysets = 100;
+
+    FInfo fileInfo_;
+    MetaCache metaCache_;
+    MDSClient mdsClient_;
+};
+
+TEST_P(SplitorBenchmark, IOSplitThroughput) {
+    const int threads = GetParam();
+    std::atomic<uint64_t> failed(0);
+    std::vector<std::thread> workers;
+
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([this, i, &failed]() { RunThread(i, &failed); });
+    }
+    for (auto& t : workers) {
+        t.join();
+    }
+    uint64_t elapsedUs = TimeUtility::GetTimeofDayUs() - startUs;
+
+    ASSERT_EQ(0, failed.load());
+    uint64_t totalIOs = threads * FLAGS_splitor_bench_ios;
+    LOG(INFO) << "IOSplit benchmark, threads: " << threads
+              << ", ios: " << totalIOs
+              << ", elapsed: " << elapsedUs / 1000 << " ms"
+              << ", throughput: " << totalIOs * 1000000 / (elapsedUs + 1)
+              << " ios/s";
+}
+
+INSTANTIATE_TEST_CASE_P(SplitorBenchmark, SplitorBenchmark,
+                        ::testing::Values(1, 4, 16, 32));
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-29
+ */
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "src/common/compression.h"
+#include "src/common/timeutility.h"
+
+DEFINE_uint32(compress_bench_chunk_mb, 16, "size of each chunk object");
+DEFINE_uint32(compress_bench_frame_kb, 1024, "frame size, i.e. chunkSplitSize");
+DEFINE_uint32(compress_bench_chunks, 4, "chunks encoded and decoded");
+DEFINE_uint32(compress_bench_zero_percent, 30,
+              "percentage of zero frames, unused space in vm images");
+DEFINE_uint32(compress_bench_random_percent, 20,
+              "percentage of random frames, already compressed files");
+
+namespace curve {
+namespace common {
+
+// 测量每种压缩算法编码和解码chunk对象的吞吐以及压缩率，
+// 数据由全零、随机以及文本类的帧混合而成，模拟虚拟机镜像
+class CompressionBenchmark : public ::testing::TestWithParam<CompressType> {
+ protected:
+    void SetUp() override {
+        const uint64_t chunkSize =
+            static_cast<uint64_t>(FLAGS_compress_bench_chunk_mb) << 20;
+        const uint64_t frameSize =
+            static_cast<uint64_t>(FLAGS_compress_bench_frame_kb) << 10;
+        static const char* kWords[] = {
+            "curve ", "chunk ", "segment ", "snapshot ", "clone ",
+            "\n", "0x00ff ", "int main() { return 0; } ",
+        };
+
+        std::mt19937_64 rand(1);
+        data_.resize(chunkSize);
+        for (uint64_t off = 0; off < chunkSize; off += frameSize) {
+            uint64_t len = std::min(frameSize, chunkSize - off);
+            uint32_t kind = rand() % 100;
+            char* frame = &data_[off];
+            if (kind < FLAGS_compress_bench_zero_percent) {
+                memset(frame, 0, len);
+            } else if (kind < FLAGS_compress_bench_zero_percent +
+                                  FLAGS_compress_bench_random_percent) {
+                for (uint64_t i = 0; i < len; ++i) {
+                    frame[i] = static_cast<char>(rand());
+                }
+            } else {
+                uint64_t i = 0;
+                while (i < len) {
+                    const char* word = kWords[rand() % 8];
+                    size_t n = std::min<size_t>(strlen(word), len - i);
+                    memcpy(frame + i, word, n);
+                    i += n;
+                }
+            }
+        }
+    }
+
+ protected:
+    std::string data_;
+};
+
+TEST_P(CompressionBenchmark, Run) {
+    const uint32_t frameSize = FLAGS_compress_bench_frame_kb << 10;
+    const uint32_t chunks = FLAGS_compress_bench_chunks;
+    std::string obj;
+
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    for (uint32_t i = 0; i < chunks; ++i) {
+        ASSERT_TRUE(CompressedObject::Encode(GetParam(), frameSize,
+                                             data_.data(), data_.size(),
+                                             &obj));
+    }
+    uint64_t encodeUs = TimeUtility::GetTimeofDayUs() - startUs;
+
+    CompressedObject header;
+    ASSERT_TRUE(header.ParseFixedHeader(obj.data(), obj.size()));
+    ASSERT_TRUE(header.ParseFrameTable(
+        obj.data() + CompressedObject::kFixedHeaderSize,
+        obj.size() - CompressedObject::kFixedHeaderSize));
+    uint64_t objOffset, objLen;
+    ASSERT_TRUE(header.GetFrameRange(0, data_.size(), &objOffset, &objLen));
+
+    std::string out(data_.size(), 0);
+    startUs = TimeUtility::GetTimeofDayUs();
+    for (uint32_t i = 0; i < chunks; ++i) {
+        ASSERT_TRUE(header.DecodeRange(obj.data() + objOffset, objLen, 0,
+                                       data_.size(), &out[0]));
+    }
+    uint64_t decodeUs = TimeUtility::GetTimeofDayUs() - startUs;
+    ASSERT_TRUE(out == data_);
+
+    uint64_t bytes = static_cast<uint64_t>(chunks) * data_.size();
+    LOG(INFO) << "compression benchmark, codec: "
+              << CompressTypeToString(GetParam())
+              << ", frame size: " << frameSize
+              << ", ratio: " << obj.size() * 100 / data_.size() << "%"
+              << ", encode: " << bytes / (encodeUs + 1) << " MB/s"
+              << ", decode: " << bytes / (decodeUs + 1) << " MB/s";
+}
+
+INSTANTIATE_TEST_CASE_P(CompressionBenchmark, CompressionBenchmark,
+                        ::testing::Values(CompressType::kSnappy,
+                                          CompressType::kZlib));
+
+}  // namespace common
+}  // namespace curve
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-29
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/common/compression.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+// 一半重复一半随机的数据
+std::string MakeData(size_t len) {
+    std::string data(len, 'a');
+    uint32_t seed = 1;
+    for (size_t i = 0; i < len; i += 2) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = static_cast<char>(seed >> 16);
+    }
+    return data;
+}
+
+bool ParseObject(const std::string& obj, CompressedObject* header) {
+    return header->ParseFixedHeader(obj.data(), obj.size()) &&
+           header->ParseFrameTable(
+               obj.data() + CompressedObject::kFixedHeaderSize,
+               obj.size() - CompressedObject::kFixedHeaderSize);
+}
+
+}  // namespace
+
+TEST(CompressionTest, TestCompressType) {
+    CompressType type;
+    ASSERT_TRUE(StringToCompressType("none", &type));
+    ASSERT_EQ(CompressType::kNone, type);
+    ASSERT_TRUE(StringToCompressType("snappy", &type));
+    ASSERT_EQ(CompressType::kSnappy, type);
+    ASSERT_TRUE(StringToCompressType("zlib", &type));
+    ASSERT_EQ(CompressType::kZlib, type);
+    ASSERT_FALSE(StringToCompressType("lz4", &type));
+    ASSERT_EQ("zlib", CompressTypeToString(CompressType::kZlib));
+}
+
+class CompressedObjectTest : public ::testing::TestWithParam<CompressType> {};
+
+TEST_P(CompressedObjectTest, TestEncodeAndDecodeRange) {
+    const uint32_t frameSize = 4096;
+    // 最后一帧不满
+    std::string data = MakeData(4 * frameSize + 100);
+
+    std::string obj;
+    ASSERT_TRUE(CompressedObject::Encode(GetParam(), frameSize, data.data(),
+                                         data.size(), &obj));
+    ASSERT_LT(obj.size(), data.size());
+
+    CompressedObject header;
+    ASSERT_TRUE(ParseObject(obj, &header));
+    ASSERT_EQ(GetParam(), header.GetCompressType());
+    ASSERT_EQ(data.size(), header.GetRawLength());
+    ASSERT_EQ(CompressedObject::kFixedHeaderSize + 5 * sizeof(uint64_t),
+              header.HeaderSize());
+
+    // 整帧、跨帧以及帧内的部分数据
+    std::pair<uint64_t, uint64_t> ranges[] = {
+        {0, data.size()},
+        {frameSize, frameSize},
+        {frameSize - 10, 20},
+        {100, 200},
+        {4 * frameSize + 50, 50},
+    };
+    for (auto& range : ranges) {
+        uint64_t objOffset, objLen;
+        ASSERT_TRUE(header.GetFrameRange(range.first, range.second,
+                                         &objOffset, &objLen));
+        ASSERT_LE(objOffset + objLen, obj.size());
+
+        std::string out(range.second, 0);
+        ASSERT_TRUE(header.DecodeRange(obj.data() + objOffset, objLen,
+                                       range.first, range.second, &out[0]));
+        ASSERT_EQ(data.substr(range.first, range.second), out);
+    }
+
+    // 超出原始数据的范围
+    uint64_t objOffset, objLen;
+    ASSERT_FALSE(header.GetFrameRange(data.size() - 10, 20, &objOffset,
+                                      &objLen));
+}
+
+TEST_P(CompressedObjectTest, TestCorruptedObject) {
+    const uint32_t frameSize = 4096;
+    std::string data = MakeData(2 * frameSize);
+    std::string obj;
+    ASSERT_TRUE(CompressedObject::Encode(GetParam(), frameSize, data.data(),
+                                         data.size(), &obj));
+
+    CompressedObject header;
+    std::string bad = obj;
+    bad[0] = 'x';
+    ASSERT_FALSE(header.ParseFixedHeader(bad.data(), bad.size()));
+    ASSERT_FALSE(header.ParseFixedHeader(obj.data(), 10));
+
+    // 帧数据损坏时解压失败
+    ASSERT_TRUE(ParseObject(obj, &header));
+    bad = obj;
+    for (size_t i = header.HeaderSize(); i < bad.size(); ++i) {
+        bad[i] = ~bad[i];
+    }
+    uint64_t objOffset, objLen;
+    ASSERT_TRUE(header.GetFrameRange(0, frameSize, &objOffset, &objLen));
+    std::string out(frameSize, 0);
+    ASSERT_FALSE(header.DecodeRange(bad.data() + objOffset, objLen, 0,
+                                    frameSize, &out[0]));
+}
+
+INSTANTIATE_TEST_CASE_P(CompressedObjectTest, CompressedObjectTest,
+                        ::testing::Values(CompressType::kSnappy,
+                                          CompressType::kZlib));
+
+}  // namespace common
+}  // namespace curve
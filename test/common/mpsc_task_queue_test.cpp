@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-26
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/mpsc_task_queue.h"
+
+namespace curve {
+namespace common {
+
+TEST(MPSCTaskQueueTest, FifoTest) {
+    MPSCTaskQueue queue(8);
+    std::vector<int> result;
+    for (int i = 0; i < 8; ++i) {
+        queue.Push([&result](int n) { result.push_back(n); }, i);
+    }
+    for (int i = 0; i < 8; ++i) {
+        queue.RunOne();
+    }
+    ASSERT_EQ(8u, result.size());
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(i, result[i]);
+    }
+}
+
+TEST(MPSCTaskQueueTest, LargeTaskTest) {
+    // tasks larger than the slot are stored on heap
+    MPSCTaskQueue queue(1);
+    std::array<char, MPSCTaskQueue::kInlineTaskSize * 2> data;
+    data.fill('a');
+    char got = 0;
+    queue.Push([data, &got]() { got = data.back(); });
+    queue.RunOne();
+    ASSERT_EQ('a', got);
+
+    // the tasks not run are destroyed with the queue
+    auto counter = std::make_shared<int>(0);
+    {
+        MPSCTaskQueue queue2(4);
+        queue2.Push([counter]() {});
+        queue2.Push([counter, data]() {});
+        ASSERT_EQ(3, counter.use_count());
+    }
+    ASSERT_EQ(1, counter.use_count());
+}
+
+TEST(MPSCTaskQueueTest, MultiProducerTest) {
+    // small capacity makes the producers wait for the consumer
+    MPSCTaskQueue queue(2);
+    const int kProducer = 8;
+    const int kTaskPerProducer = 10000;
+    std::vector<int> last(kProducer, -1);
+    std::atomic<bool> ordered(true);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducer; ++p) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < kTaskPerProducer; ++i) {
+                queue.Push([&last, &ordered, p, i]() {
+                    // tasks of one producer are run in order
+                    if (last[p] + 1 != i) {
+                        ordered = false;
+                    }
+                    last[p] = i;
+                });
+            }
+        });
+    }
+
+    std::thread consumer([&]() {
+        for (int i = 0; i < kProducer * kTaskPerProducer; ++i) {
+            queue.RunOne();
+        }
+    });
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    consumer.join();
+    ASSERT_TRUE(ordered.load());
+    for (int p = 0; p < kProducer; ++p) {
+        ASSERT_EQ(kTaskPerProducer - 1, last[p]);
+    }
+}
+
+TEST(MPSCTaskQueueTest, ParkTest) {
+    // the consumer parks on the empty queue and wakes up on push
+    MPSCTaskQueue queue(4);
+    std::atomic<int> count(0);
+    std::thread consumer([&]() {
+        for (int i = 0; i < 3; ++i) {
+            queue.RunOne();
+        }
+    });
+    for (int i = 0; i < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        queue.Push([&count]() { count++; });
+    }
+    consumer.join();
+    ASSERT_EQ(3, count.load());
+}
+
+}  // namespace common
+}  // namespace curve
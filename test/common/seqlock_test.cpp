@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-22
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/append_only_hash_map.h"
+#include "src/common/concurrent/seqlock.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+// the fields are always written with the same value, a torn read shows
+// different ones
+struct Triple {
+    uint64_t a = 0;
+    uint32_t b = 0;
+    uint16_t c = 0;
+};
+
+}  // namespace
+
+TEST(SeqLockValueTest, LoadStoreTest) {
+    SeqLockValue<Triple> value;
+    ASSERT_EQ(0, value.Load().a);
+
+    Triple t;
+    t.a = 1;
+    t.b = 2;
+    t.c = 3;
+    value.Store(t);
+    Triple got = value.Load();
+    ASSERT_EQ(1, got.a);
+    ASSERT_EQ(2, got.b);
+    ASSERT_EQ(3, got.c);
+
+    value.Update([](Triple* v) { v->b = 20; });
+    got = value.Load();
+    ASSERT_EQ(1, got.a);
+    ASSERT_EQ(20, got.b);
+    ASSERT_EQ(3, got.c);
+}
+
+TEST(SeqLockValueTest, ConcurrentTest) {
+    SeqLockValue<Triple> value;
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> torn(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            while (!stop.load()) {
+                Triple t = value.Load();
+                if (t.a != t.b || static_cast<uint16_t>(t.a) != t.c) {
+                    ++torn;
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 2; ++i) {
+        writers.emplace_back([&value, i]() {
+            for (uint32_t n = 0; n < 200000; ++n) {
+                if (i == 0) {
+                    Triple t;
+                    t.a = t.b = t.c = n;
+                    value.Store(t);
+                } else {
+                    value.Update([n](Triple* t) {
+                        t->a = t->b = t->c = n;
+                    });
+                }
+            }
+        });
+    }
+
+    for (auto& t : writers) {
+        t.join();
+    }
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    ASSERT_EQ(0, torn.load());
+}
+
+TEST(AppendOnlyHashMapTest, FindAndEmplaceTest) {
+    AppendOnlyHashMap<uint64_t, std::string> map(2);
+    ASSERT_EQ(nullptr, map.Find(1));
+
+    std::string* value = map.FindOrEmplace(1, "one");
+    ASSERT_EQ("one", *value);
+    // existing value is not replaced
+    ASSERT_EQ(value, map.FindOrEmplace(1, "other"));
+    ASSERT_EQ("one", *map.Find(1));
+
+    // growing keeps the address of values
+    for (uint64_t i = 2; i <= 1000; ++i) {
+        map.FindOrEmplace(i, std::to_string(i));
+    }
+    ASSERT_EQ(1000, map.Size());
+    ASSERT_EQ(value, map.Find(1));
+    for (uint64_t i = 2; i <= 1000; ++i) {
+        ASSERT_EQ(std::to_string(i), *map.Find(i));
+    }
+    ASSERT_EQ(nullptr, map.Find(1001));
+
+    uint64_t sum = 0;
+    map.ForEach([&sum](uint64_t key, std::string*) { sum += key; });
+    ASSERT_EQ(1000 * 1001 / 2, sum);
+    ASSERT_GT(map.MemoryUsage(), 1000 * sizeof(std::string));
+}
+
+TEST(AppendOnlyHashMapTest, ConcurrentTest) {
+    AppendOnlyHashMap<uint64_t, std::atomic<uint64_t>> map;
+    const uint64_t kKeys = 100000;
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> wrong(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            uint64_t key = 0;
+            while (!stop.load()) {
+                auto* value = map.Find(key);
+                if (value != nullptr && value->load() != key) {
+                    ++wrong;
+                }
+                key = (key + 7) % kKeys;
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 2; ++i) {
+        writers.emplace_back([&map, i, kKeys]() {
+            for (uint64_t key = i; key < kKeys; key += 2) {
+                map.FindOrEmplace(key, key);
+            }
+        });
+    }
+
+    for (auto& t : writers) {
+        t.join();
+    }
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    ASSERT_EQ(0, wrong.load());
+    ASSERT_EQ(kKeys, map.Size());
+    for (uint64_t key = 0; key < kKeys; ++key) {
+        ASSERT_EQ(key, map.Find(key)->load());
+    }
+}
+
+}  // namespace common
+}  // namespace curve
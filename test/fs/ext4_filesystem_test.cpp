@@ -30,6 +30,7 @@
 
 #include "test/fs/mock_posix_wrapper.h"
 #include "src/fs/ext4_filesystem_impl.h"
+#include "src/fs/iobuf_util.h"
 
 using ::testing::_;
 using ::testing::Ge;
@@ -43,6 +44,8 @@ using ::testing::StrEq;
 using ::testing::ElementsAre;
 using ::testing::SetArgPointee;
 using ::testing::ReturnArg;
+using ::testing::Invoke;
+using ::testing::SetErrnoAndReturn;
 
 namespace curve {
 namespace fs {
@@ -492,6 +495,71 @@ TEST_F(Ext4LocalFileSystemTest, WriteIOBufTest) {
     }
 }
 
+TEST_F(Ext4LocalFileSystemTest, WriteIOBufZeroCopyTest) {
+    // iobuf composed of 3 blocks, pwritev writes it partially
+    std::string part1(1024, 'a');
+    std::string part2(1024, 'b');
+    std::string part3(2048, 'c');
+    butil::IOBuf data;
+    data.append_user_data(&part1[0], part1.size(), [](void*) {});
+    data.append_user_data(&part2[0], part2.size(), [](void*) {});
+    data.append_user_data(&part3[0], part3.size(), [](void*) {});
+
+    EXPECT_CALL(*wrapper, pwritev(666, _, 3, 0))
+        .WillOnce(Invoke([&](int, const struct iovec* iov, int, off_t) {
+            // the iovecs reference the iobuf blocks, no data is copied
+            EXPECT_EQ(&part1[0], iov[0].iov_base);
+            EXPECT_EQ(&part2[0], iov[1].iov_base);
+            EXPECT_EQ(&part3[0], iov[2].iov_base);
+            return 1536;
+        }));
+    EXPECT_CALL(*wrapper, pwritev(666, _, 2, 1536))
+        .WillOnce(Invoke([&](int, const struct iovec* iov, int, off_t) {
+            EXPECT_EQ(&part2[512], iov[0].iov_base);
+            EXPECT_EQ(512, iov[0].iov_len);
+            EXPECT_EQ(&part3[0], iov[1].iov_base);
+            EXPECT_EQ(2048, iov[1].iov_len);
+            return 2560;
+        }));
+    ASSERT_EQ(4096, lfs->Write(666, data, 0, 4096));
+    // iobuf is not consumed
+    ASSERT_EQ(4096, data.size());
+
+    // pwritev failed, retried MAX_RETYR_TIME times
+    EXPECT_CALL(*wrapper, pwritev(666, _, _, _))
+        .Times(MAX_RETYR_TIME + 1)
+        .WillRepeatedly(SetErrnoAndReturn(EIO, -1));
+    ASSERT_EQ(-EIO, lfs->Write(666, data, 0, 4096));
+
+    // pwritev wrote nothing
+    EXPECT_CALL(*wrapper, pwritev(666, _, _, _))
+        .WillOnce(Return(0));
+    ASSERT_EQ(-EIO, lfs->Write(666, data, 0, 4096));
+
+    // iobuf is shorter than length, nothing is written
+    EXPECT_CALL(*wrapper, pwritev(_, _, _, _)).Times(0);
+    ASSERT_EQ(-EINVAL, lfs->Write(666, data, 0, 8192));
+}
+
+TEST_F(Ext4LocalFileSystemTest, WriteIOBufMetricTest) {
+    auto posixWrapper = std::make_shared<PosixWrapper>();
+    lfs->SetPosixWrapper(posixWrapper);
+    int fd = posixWrapper->open("/dev/null", O_WRONLY, 0644);
+    ASSERT_GE(fd, 0);
+
+    IOBufWriteMetric* metric = IOBufWriteMetric::GetInstance();
+    for (uint64_t length = 4096; length <= 1024 * 1024; length *= 2) {
+        butil::IOBuf data;
+        data.resize(length, 'a');
+        uint64_t before = metric->writeBytes.get_value();
+        ASSERT_EQ(length, lfs->Write(fd, data, 0, length));
+        // all the bytes are written by reference
+        ASSERT_EQ(before + length, metric->writeBytes.get_value());
+    }
+
+    posixWrapper->close(fd);
+}
+
 // test Fallocate
 TEST_F(Ext4LocalFileSystemTest, FallocateTest) {
     // success
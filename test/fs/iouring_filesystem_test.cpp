@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2022-08-15
+ */
+
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <butil/iobuf.h>
+
+#include <condition_variable>  // NOLINT
+#include <cstdlib>
+#include <future>  // NOLINT
+#include <iostream>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/fs/local_filesystem.h"
+#include "src/fs/iouring.h"
+
+namespace curve {
+namespace fs {
+
+const char kTestDir[] = "./iouring_fs_test";  // NOLINT
+
+class IOUringFileSystemTest : public testing::Test {
+ public:
+    void SetUp() {
+        lfs_ = LocalFsFactory::CreateFs(FileSystemType::EXT4_IOURING, "");
+        ASSERT_NE(nullptr, lfs_);
+        LocalFileSystemOption option;
+        option.ioUringQueueDepth = 16;
+        int ret = lfs_->Init(option);
+        // io_uring is not supported by the kernel or forbidden by seccomp,
+        // any other failure is a bug
+        supported_ = (ret != -ENOSYS && ret != -EPERM);
+        if (!supported_) {
+            std::cout << "[  SKIPPED ] io_uring is not supported, ret = "
+                      << ret << std::endl;
+            return;
+        }
+        ASSERT_EQ(0, ret);
+        ASSERT_EQ(0, lfs_->Mkdir(kTestDir));
+    }
+
+    void TearDown() {
+        if (supported_) {
+            lfs_->Delete(kTestDir);
+        }
+    }
+
+ protected:
+    std::shared_ptr<LocalFileSystem> lfs_;
+    bool supported_;
+};
+
+TEST_F(IOUringFileSystemTest, CreateTest) {
+    std::shared_ptr<LocalFileSystem> lfs =
+        LocalFsFactory::CreateFs(FileSystemType::EXT4_IOURING, "");
+    // singleton
+    ASSERT_EQ(lfs_.get(), lfs.get());
+    ASSERT_NE(lfs.get(),
+              LocalFsFactory::CreateFs(FileSystemType::EXT4, "").get());
+}
+
+TEST_F(IOUringFileSystemTest, ReadWriteTest) {
+    if (!supported_) {
+        return;
+    }
+    std::string path = std::string(kTestDir) + "/file";
+    int fd = lfs_->Open(path, O_RDWR | O_CREAT);
+    ASSERT_GE(fd, 0);
+
+    const int kLength = 8192;
+    char writeBuf[kLength];
+    char readBuf[kLength];
+    memset(writeBuf, 'a', kLength);
+    ASSERT_EQ(kLength, lfs_->Write(fd, writeBuf, 0, kLength));
+    ASSERT_EQ(0, lfs_->Sync(fd));
+    ASSERT_EQ(kLength, lfs_->Read(fd, readBuf, 0, kLength));
+    ASSERT_EQ(0, memcmp(writeBuf, readBuf, kLength));
+
+    // read beyond the end of file
+    ASSERT_EQ(0, lfs_->Read(fd, readBuf, kLength, kLength));
+
+    // io at a non-zero offset with a length different from it
+    ASSERT_EQ(100, lfs_->Write(fd, writeBuf, 3, 100));
+    ASSERT_EQ(100, lfs_->Read(fd, readBuf, 3, 100));
+    ASSERT_EQ(0, memcmp(writeBuf, readBuf, 100));
+
+    // write iobuf composed of several blocks
+    butil::IOBuf iobuf;
+    std::string part1(4096, 'b');
+    std::string part2(4096, 'c');
+    iobuf.append(part1);
+    iobuf.append(part2);
+    ASSERT_EQ(kLength, lfs_->Write(fd, iobuf, kLength, kLength));
+    ASSERT_EQ(0, lfs_->Fsync(fd));
+    ASSERT_EQ(kLength, lfs_->Read(fd, readBuf, kLength, kLength));
+    ASSERT_EQ(part1 + part2, std::string(readBuf, kLength));
+
+    ASSERT_EQ(0, lfs_->Close(fd));
+}
+
+TEST_F(IOUringFileSystemTest, ConcurrentTest) {
+    if (!supported_) {
+        return;
+    }
+    std::string path = std::string(kTestDir) + "/concurrent";
+    int fd = lfs_->Open(path, O_RDWR | O_CREAT);
+    ASSERT_GE(fd, 0);
+
+    // more threads than the queue depth
+    const int kThreadNum = 32;
+    const int kIoNum = 100;
+    const int kLength = 4096;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreadNum; ++i) {
+        threads.emplace_back([&, i]() {
+            char writeBuf[kLength];
+            char readBuf[kLength];
+            memset(writeBuf, i, kLength);
+            for (int j = 0; j < kIoNum; ++j) {
+                uint64_t offset =
+                    static_cast<uint64_t>(i * kIoNum + j) * kLength;
+                ASSERT_EQ(kLength,
+                          lfs_->Write(fd, writeBuf, offset, kLength));
+                ASSERT_EQ(kLength, lfs_->Read(fd, readBuf, offset, kLength));
+                ASSERT_EQ(0, memcmp(writeBuf, readBuf, kLength));
+            }
+            ASSERT_EQ(0, lfs_->Sync(fd));
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(0, lfs_->Close(fd));
+}
+
+TEST(IOUringTest, AsyncTest) {
+    IOUring ring;
+    int ret = ring.Init(4);
+    if (ret == -ENOSYS || ret == -EPERM) {
+        std::cout << "[  SKIPPED ] io_uring is not supported, ret = "
+                  << ret << std::endl;
+        return;
+    }
+    ASSERT_EQ(0, ret);
+    ASSERT_EQ(0, ::system("mkdir -p ./iouring_async_test"));
+    int fd = ::open("./iouring_async_test/file", O_RDWR | O_CREAT, 0644);
+    ASSERT_GE(fd, 0);
+
+    // one thread keeps more requests inflight than the queue depth
+    const int kIoNum = 16;
+    const int kLength = 4096;
+    std::vector<std::string> writeBufs;
+    std::vector<std::string> readBufs(kIoNum, std::string(kLength, 0));
+    for (int i = 0; i < kIoNum; ++i) {
+        writeBufs.emplace_back(kLength, 'a' + i);
+    }
+    std::mutex mtx;
+    std::condition_variable cond;
+    int done = 0;
+    std::vector<int> results(kIoNum, 0);
+    auto waitAll = [&]() {
+        std::unique_lock<std::mutex> lk(mtx);
+        cond.wait(lk, [&]() { return done == kIoNum; });
+        done = 0;
+    };
+    auto doneFor = [&](int i) {
+        return [&, i](int result) {
+            std::lock_guard<std::mutex> lk(mtx);
+            results[i] = result;
+            ++done;
+            cond.notify_one();
+        };
+    };
+
+    for (int i = 0; i < kIoNum; ++i) {
+        ASSERT_EQ(0, ring.PWriteAsync(fd, writeBufs[i].data(),
+                                      static_cast<uint64_t>(i) * kLength,
+                                      kLength, doneFor(i)));
+    }
+    waitAll();
+    for (int i = 0; i < kIoNum; ++i) {
+        ASSERT_EQ(kLength, results[i]);
+        ASSERT_EQ(0, ring.PReadAsync(fd, &readBufs[i][0],
+                                     static_cast<uint64_t>(i) * kLength,
+                                     kLength, doneFor(i)));
+    }
+    waitAll();
+    for (int i = 0; i < kIoNum; ++i) {
+        ASSERT_EQ(kLength, results[i]);
+        ASSERT_EQ(writeBufs[i], readBufs[i]);
+    }
+
+    std::promise<int> synced;
+    ASSERT_EQ(0, ring.FsyncAsync(fd, true, [&](int result) {
+        synced.set_value(result);
+    }));
+    ASSERT_EQ(0, synced.get_future().get());
+
+    ring.Fini();
+    ASSERT_EQ(-EINVAL, ring.FsyncAsync(fd, true, [](int) {
+        FAIL() << "not queued";
+    }));
+    ::close(fd);
+    ASSERT_EQ(0, ::system("rm -rf ./iouring_async_test"));
+}
+
+TEST(IOUringTest, NotInitedTest) {
+    IOUring ring;
+    ASSERT_FALSE(ring.Inited());
+    char buf[4096];
+    ASSERT_EQ(-EINVAL, ring.PRead(0, buf, 0, sizeof(buf)));
+    ring.Fini();
+}
+
+}  // namespace fs
+}  // namespace curve
@@ -46,6 +46,7 @@ class MockPosixWrapper : public PosixWrapper {
     MOCK_METHOD1(closedir, int(DIR*));
     MOCK_METHOD4(pread, ssize_t(int, void*, size_t, off_t));
     MOCK_METHOD4(pwrite, ssize_t(int, const void*, size_t, off_t));
+    MOCK_METHOD4(pwritev, ssize_t(int, const struct iovec*, int, off_t));
     MOCK_METHOD4(fallocate, int(int, int, off_t, off_t));
     MOCK_METHOD2(fstat, int(int, struct stat*));
     MOCK_METHOD1(fsync, int(int));
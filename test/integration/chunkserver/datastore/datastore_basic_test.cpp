@@ -20,6 +20,10 @@
  * Author: yangyaokai
  */
 
+#include <fcntl.h>
+
+#include <memory>
+
 #include "test/integration/chunkserver/datastore/datastore_integration_base.h"
 
 namespace curve {
@@ -192,5 +196,170 @@ TEST_F(BasicTestSuit, BasicTest) {
     ASSERT_FALSE(lfs_->FileExists(chunkPath));
 }
 
+/**
+ * Data crc table test
+ * crc is updated on write, verified on read and survives restart
+ */
+TEST_F(BasicTestSuit, DataCrcTest) {
+    const uint32_t blockSize = 32 * 1024;
+    DataStoreOptions options;
+    options.baseDir = baseDir;
+    options.chunkSize = CHUNK_SIZE;
+    options.pageSize = PAGE_SIZE;
+    options.crcBlockSize = blockSize;
+    dataStore_ = std::make_shared<CSDataStore>(lfs_, filePool_, options);
+    ASSERT_TRUE(dataStore_->Initialize());
+
+    ChunkID id = 1;
+    SequenceNum sn = 1;
+    std::string chunkPath = baseDir + "/" +
+        FileNameOperator::GenerateChunkFileName(id);
+
+    // block 0 and 1 are fully written, block 2 is partially written
+    std::unique_ptr<char[]> buf(new char[2 * blockSize]);
+    memset(buf.get(), 'a', 2 * blockSize);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id, sn, buf.get(), 0, 2 * blockSize,
+                                     nullptr));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id, sn, buf.get(), 2 * blockSize,
+                                     PAGE_SIZE, nullptr));
+    std::unique_ptr<char[]> readbuf(new char[3 * blockSize]);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->ReadChunk(id, sn, readbuf.get(), 0, 3 * blockSize));
+    ASSERT_EQ(0, memcmp(buf.get(), readbuf.get(), 2 * blockSize));
+
+    // the block crcs are calculated from the data and match the table
+    std::unique_ptr<char[]> chunkbuf(new char[CHUNK_SIZE]);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->ReadChunk(id, sn, chunkbuf.get(), 0, CHUNK_SIZE));
+    uint32_t expected = 0;
+    for (uint32_t off = 0; off < CHUNK_SIZE; off += blockSize) {
+        uint32_t blockCrc =
+            ::curve::common::CRC32(chunkbuf.get() + off, blockSize);
+        expected = ::curve::common::CRC32(
+            expected, reinterpret_cast<const char*>(&blockCrc),
+            sizeof(blockCrc));
+    }
+    uint32_t crc = 0;
+    uint32_t badBlocks = 0;
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkBlockCrc(id, 0, CHUNK_SIZE, blockSize,
+                                           &crc, &badBlocks));
+    ASSERT_EQ(expected, crc);
+    ASSERT_EQ(0u, badBlocks);
+
+    // block size not matching the table, the table is not checked
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkBlockCrc(id, 0, CHUNK_SIZE, 2 * blockSize,
+                                           &crc, &badBlocks));
+    ASSERT_EQ(0u, badBlocks);
+
+    // the metapage for scan does not contain the crc table
+    char metapage[PAGE_SIZE];
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->ReadChunkMetaPage(id, sn, metapage));
+    ChunkFileMetaPage metaPage;
+    ASSERT_EQ(CSErrorCode::Success, metaPage.decode(metapage));
+    ASSERT_EQ(FORMAT_VERSION_V2, metaPage.version);
+    ASSERT_EQ(0u, metaPage.crcBlockSize);
+
+    // persist the crc table and corrupt block 0 behind the datastore
+    ASSERT_EQ(CSErrorCode::Success, dataStore_->SyncChunk(id));
+    int fd = lfs_->Open(chunkPath, O_RDWR);
+    ASSERT_GE(fd, 0);
+    char corrupt[PAGE_SIZE];
+    memset(corrupt, 'b', PAGE_SIZE);
+    ASSERT_EQ(static_cast<int>(PAGE_SIZE),
+              lfs_->Write(fd, corrupt, PAGE_SIZE, PAGE_SIZE));
+    ASSERT_EQ(0, lfs_->Close(fd));
+
+    ASSERT_EQ(CSErrorCode::CrcCheckError,
+              dataStore_->ReadChunk(id, sn, readbuf.get(), 0, blockSize));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->ReadChunk(id, sn, readbuf.get(), blockSize,
+                                    blockSize));
+    // partial read of the block is not verified
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->ReadChunk(id, sn, readbuf.get(), 0, PAGE_SIZE));
+
+    // scan reads the data, so the corruption of a chunk unchanged since
+    // last scan changes the crc and the block is found mismatching the
+    // table, the chunk is scanned again by the next incremental scan
+    dataStore_->MarkChunkScanned(id);
+    ASSERT_FALSE(dataStore_->GetChunkMap()[id]->IsScanDirty());
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkBlockCrc(id, 0, CHUNK_SIZE, blockSize,
+                                           &crc, &badBlocks));
+    ASSERT_NE(expected, crc);
+    ASSERT_EQ(1u, badBlocks);
+    ASSERT_TRUE(dataStore_->GetChunkMap()[id]->IsScanDirty());
+
+    // the crc table is loaded after restart
+    dataStore_ = std::make_shared<CSDataStore>(lfs_, filePool_, options);
+    ASSERT_TRUE(dataStore_->Initialize());
+    ASSERT_EQ(CSErrorCode::CrcCheckError,
+              dataStore_->ReadChunk(id, sn, readbuf.get(), 0, blockSize));
+
+    // rewriting the whole block fixes the crc
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id, sn, buf.get(), 0, blockSize,
+                                     nullptr));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->ReadChunk(id, sn, readbuf.get(), 0, blockSize));
+}
+
+TEST_F(BasicTestSuit, DataCrcWithOdsyncTest) {
+    const uint32_t blockSize = 32 * 1024;
+    DataStoreOptions options;
+    options.baseDir = baseDir;
+    options.chunkSize = CHUNK_SIZE;
+    options.pageSize = PAGE_SIZE;
+    options.crcBlockSize = blockSize;
+    options.enableOdsyncWhenOpenChunkFile = true;
+    dataStore_ = std::make_shared<CSDataStore>(lfs_, filePool_, options);
+    ASSERT_TRUE(dataStore_->Initialize());
+
+    ChunkID id = 1;
+    SequenceNum sn = 1;
+    std::string chunkPath = baseDir + "/" +
+        FileNameOperator::GenerateChunkFileName(id);
+
+    std::unique_ptr<char[]> buf(new char[blockSize]);
+    memset(buf.get(), 'a', blockSize);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id, sn, buf.get(), 0, blockSize,
+                                     nullptr));
+
+    // the crc table is not persisted with the write, a restart before
+    // sync loses the crc, the write is replayed from raft log in that case
+    char corrupt[PAGE_SIZE];
+    memset(corrupt, 'b', PAGE_SIZE);
+    auto corruptBlock = [&]() {
+        int fd = lfs_->Open(chunkPath, O_RDWR);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(static_cast<int>(PAGE_SIZE),
+                  lfs_->Write(fd, corrupt, PAGE_SIZE, PAGE_SIZE));
+        ASSERT_EQ(0, lfs_->Close(fd));
+    };
+    corruptBlock();
+    dataStore_ = std::make_shared<CSDataStore>(lfs_, filePool_, options);
+    ASSERT_TRUE(dataStore_->Initialize());
+    std::unique_ptr<char[]> readbuf(new char[blockSize]);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->ReadChunk(id, sn, readbuf.get(), 0, blockSize));
+
+    // replay the write, the crc table is persisted on sync
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id, sn, buf.get(), 0, blockSize,
+                                     nullptr));
+    ASSERT_EQ(CSErrorCode::Success, dataStore_->SyncChunk(id));
+    corruptBlock();
+    dataStore_ = std::make_shared<CSDataStore>(lfs_, filePool_, options);
+    ASSERT_TRUE(dataStore_->Initialize());
+    ASSERT_EQ(CSErrorCode::CrcCheckError,
+              dataStore_->ReadChunk(id, sn, readbuf.get(), 0, blockSize));
+}
+
 }  // namespace chunkserver
 }  // namespace curve
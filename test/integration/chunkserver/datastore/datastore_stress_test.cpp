@@ -20,6 +20,9 @@
  * Author: yangyaokai
  */
 
+#include <memory>
+#include <vector>
+
 #include "test/integration/chunkserver/datastore/datastore_integration_base.h"
 
 namespace curve {
@@ -116,5 +119,108 @@ TEST_F(StressTestSuit, StressTest) {
     RunStress(50, 50, 100000);
 }
 
+// 测试chunk查找随线程数的扩展性, 每个线程执行相同数量的请求
+TEST_F(StressTestSuit, MetaCacheScaleTest) {
+    InitChunkPool(100);
+    const int kChunkNum = 100;
+    const int kIoNumPerThread = 20000;
+    size_t length = PAGE_SIZE;
+    char buf[PAGE_SIZE] = {0};
+    SequenceNum sn = 1;
+
+    for (ChunkID id = 1; id <= kChunkNum; ++id) {
+        ASSERT_EQ(CSErrorCode::Success,
+            dataStore_->WriteChunk(id, sn, buf, 0, length, nullptr));
+    }
+
+    auto RunScale = [&](int threadNum, bool isRead) {
+        std::vector<Thread> threads;
+        uint64_t beginTime = TimeUtility::GetTimeofDayUs();
+        for (int i = 0; i < threadNum; ++i) {
+            threads.emplace_back([&, i]() {
+                unsigned int seed = i;
+                char data[PAGE_SIZE] = {0};
+                for (int j = 0; j < kIoNumPerThread; ++j) {
+                    ChunkID id = rand_r(&seed) % kChunkNum + 1;
+                    off_t offset = (rand_r(&seed) % (CHUNK_SIZE / PAGE_SIZE))
+                                   * PAGE_SIZE;
+                    if (isRead) {
+                        dataStore_->ReadChunk(id, sn, data, offset, length);
+                    } else {
+                        dataStore_->WriteChunk(id, sn, data,
+                                               offset, length, nullptr);
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        uint64_t endTime = TimeUtility::GetTimeofDayUs();
+        uint64_t ioNum = static_cast<uint64_t>(threadNum) * kIoNumPerThread;
+        printf("%s thread number: %d, io num: %lu, time used: %lu us,"
+               " iops: %lu\n", isRead ? "read" : "write", threadNum, ioNum,
+               endTime - beginTime, ioNum * 1000000L / (endTime - beginTime));
+    };
+
+    printf("===============TEST METACACHE SCALE==================\n");
+    for (int threadNum = 1; threadNum <= 64; threadNum *= 2) {
+        RunScale(threadNum, true);
+    }
+    for (int threadNum = 1; threadNum <= 64; threadNum *= 2) {
+        RunScale(threadNum, false);
+    }
+}
+
+// 测试在metapage中维护数据块crc对写性能的影响
+TEST_F(StressTestSuit, DataCrcOverheadTest) {
+    InitChunkPool(20);
+    const int kChunkNum = 10;
+    const int kIoNum = 20000;
+    const uint32_t kCrcBlockSize = 32 * 1024;
+    SequenceNum sn = 1;
+    std::unique_ptr<char[]> data(new char[kCrcBlockSize]);
+    memset(data.get(), 'a', kCrcBlockSize);
+
+    // chunks are created with crc table or not according to the datastore
+    // options, so each round writes to its own chunks
+    auto RunWrite = [&](uint32_t crcBlockSize, ChunkID firstId,
+                        size_t length) -> uint64_t {
+        DataStoreOptions options;
+        options.baseDir = baseDir;
+        options.chunkSize = CHUNK_SIZE;
+        options.pageSize = PAGE_SIZE;
+        options.crcBlockSize = crcBlockSize;
+        dataStore_ = std::make_shared<CSDataStore>(lfs_, filePool_, options);
+        EXPECT_TRUE(dataStore_->Initialize());
+
+        unsigned int seed = 1;
+        uint64_t beginTime = TimeUtility::GetTimeofDayUs();
+        for (int i = 0; i < kIoNum; ++i) {
+            ChunkID id = firstId + rand_r(&seed) % kChunkNum;
+            off_t offset = (rand_r(&seed) % (CHUNK_SIZE / length)) * length;
+            dataStore_->WriteChunk(id, sn, data.get(), offset, length,
+                                   nullptr);
+        }
+        uint64_t endTime = TimeUtility::GetTimeofDayUs();
+        uint64_t iops = kIoNum * 1000000L / (endTime - beginTime);
+        printf("crc block size: %u, io size: %zu, time used: %lu us,"
+               " iops: %lu\n", crcBlockSize, length,
+               endTime - beginTime, iops);
+        return iops;
+    };
+
+    printf("===============TEST DATA CRC OVERHEAD==================\n");
+    // full block writes calculate the crc, partial block writes only
+    // invalidate it
+    for (size_t length : {static_cast<size_t>(kCrcBlockSize),
+                          static_cast<size_t>(PAGE_SIZE)}) {
+        uint64_t base = RunWrite(0, 1, length);
+        uint64_t withCrc = RunWrite(kCrcBlockSize, kChunkNum + 1, length);
+        printf("io size: %zu, write overhead: %.2f%%\n", length,
+               100.0 * (static_cast<double>(base) - withCrc) / base);
+    }
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -106,6 +106,33 @@ int FakeSnapshotCloneMetaStore::GetSnapshotList(const std::string &name,
     return -1;
 }
 
+int FakeSnapshotCloneMetaStore::AddChunkDataRef(const std::string &hash,
+    const std::string &ref) {
+    std::lock_guard<std::mutex> guard(chunkDataRefs_mutex_);
+    chunkDataRefs_[hash].insert(ref);
+    return 0;
+}
+
+int FakeSnapshotCloneMetaStore::DeleteChunkDataRef(const std::string &hash,
+    const std::string &ref) {
+    std::lock_guard<std::mutex> guard(chunkDataRefs_mutex_);
+    auto it = chunkDataRefs_.find(hash);
+    if (it != chunkDataRefs_.end()) {
+        it->second.erase(ref);
+        if (it->second.empty()) {
+            chunkDataRefs_.erase(it);
+        }
+    }
+    return 0;
+}
+
+int FakeSnapshotCloneMetaStore::GetChunkDataRefCount(const std::string &hash,
+    uint32_t *count) {
+    std::lock_guard<std::mutex> guard(chunkDataRefs_mutex_);
+    auto it = chunkDataRefs_.find(hash);
+    *count = (it == chunkDataRefs_.end()) ? 0 : it->second.size();
+    return 0;
+}
 int FakeSnapshotCloneMetaStore::GetSnapshotList(
     std::vector<SnapshotInfo> *list) {
     std::lock_guard<std::mutex> guard(snapInfos_mutex);
@@ -49,10 +49,11 @@ class MockSnapshotCore : public SnapshotCore {
     MockSnapshotCore() {}
     virtual ~MockSnapshotCore() {}
 
-    MOCK_METHOD4(CreateSnapshotPre,
+    MOCK_METHOD5(CreateSnapshotPre,
         int(const std::string &file,
         const std::string &user,
         const std::string &snapshotName,
+        CompressType compressType,
         SnapshotInfo *snapInfo));
 
     MOCK_METHOD1(HandleCreateSnapshotTask,
@@ -108,6 +109,12 @@ class MockSnapshotCloneMetaStore : public SnapshotCloneMetaStore {
         int(const std::string &fileName, std::vector<CloneInfo> *list));
     MOCK_METHOD1(GetCloneInfoList,
         int(std::vector<CloneInfo> *list));
+    MOCK_METHOD2(AddChunkDataRef,
+        int(const std::string &hash, const std::string &ref));
+    MOCK_METHOD2(DeleteChunkDataRef,
+        int(const std::string &hash, const std::string &ref));
+    MOCK_METHOD2(GetChunkDataRefCount,
+        int(const std::string &hash, uint32_t *count));
 };
 
 class MockSnapshotDataStore : public SnapshotDataStore {
@@ -271,10 +278,11 @@ class MockSnapshotServiceManager : public SnapshotServiceManager {
     MockSnapshotServiceManager() :
      SnapshotServiceManager(nullptr, nullptr) {}
     ~MockSnapshotServiceManager() {}
-    MOCK_METHOD4(CreateSnapshot,
+    MOCK_METHOD5(CreateSnapshot,
         int(const std::string &file,
         const std::string &user,
         const std::string &desc,
+        const std::string &compressType,
         UUID *uuid));
 
     MOCK_METHOD3(DeleteSnapshot,
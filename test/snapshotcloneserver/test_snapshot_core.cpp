@@ -23,6 +23,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <thread>  // NOLINT
+
 #include "src/snapshotcloneserver/snapshot/snapshot_core.h"
 #include "src/common/snapshotclone/snapshotclone_define.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_task.h"
@@ -40,6 +42,7 @@ using ::testing::AllOf;
 using ::testing::SetArgPointee;
 using ::testing::Invoke;
 using ::testing::DoAll;
+using ::testing::SaveArg;
 
 class TestSnapshotCoreImpl : public ::testing::Test {
  public:
@@ -108,8 +111,10 @@ TEST_F(TestSnapshotCoreImpl, TestCreateSnapshotPreSuccess) {
                     Return(LIBCURVE_ERROR::OK)));
     EXPECT_CALL(*metaStore_, AddSnapshot(_))
         .WillOnce(Return(kErrCodeSuccess));
-    int ret = core_->CreateSnapshotPre(file, user, desc, &info);
+    int ret = core_->CreateSnapshotPre(file, user, desc,
+        CompressType::kZlib, &info);
     ASSERT_EQ(kErrCodeSuccess, ret);
+    ASSERT_EQ(CompressType::kZlib, info.GetCompressType());
 }
 
 TEST_F(TestSnapshotCoreImpl, TestCreateSnapshotPreTaskExist) {
@@ -129,7 +134,8 @@ TEST_F(TestSnapshotCoreImpl, TestCreateSnapshotPreTaskExist) {
         .WillOnce(DoAll(
                 SetArgPointee<1>(list),
                 Return(kErrCodeSuccess)));
-    int ret = core_->CreateSnapshotPre(file, user, desc, &info);
+    int ret = core_->CreateSnapshotPre(file, user, desc,
+        CompressType::kNone, &info);
     ASSERT_EQ(kErrCodeTaskExist, ret);
 }
 
@@ -149,7 +155,8 @@ TEST_F(TestSnapshotCoreImpl, TestCreateSnapshotPreAddSnapshotFail) {
                     Return(LIBCURVE_ERROR::OK)));
     EXPECT_CALL(*metaStore_, AddSnapshot(_))
         .WillOnce(Return(kErrCodeInternalError));
-    int ret = core_->CreateSnapshotPre(file, user, desc, &info);
+    int ret = core_->CreateSnapshotPre(file, user, desc,
+        CompressType::kNone, &info);
     ASSERT_EQ(kErrCodeInternalError, ret);
 }
 
@@ -166,7 +173,8 @@ TEST_F(TestSnapshotCoreImpl, TestCreateSnapshotPreFileNotExist) {
         .WillOnce(DoAll(
                     SetArgPointee<2>(fInfo),
                     Return(-LIBCURVE_ERROR::NOTEXIST)));
-    int ret = core_->CreateSnapshotPre(file, user, desc, &info);
+    int ret = core_->CreateSnapshotPre(file, user, desc,
+        CompressType::kNone, &info);
     ASSERT_EQ(kErrCodeFileNotExist, ret);
 }
 
@@ -184,7 +192,8 @@ TEST_F(TestSnapshotCoreImpl, TestCreateSnapshotPreInvalidUser) {
         .WillOnce(DoAll(
                     SetArgPointee<2>(fInfo),
                     Return(-LIBCURVE_ERROR::AUTHFAIL)));
-    int ret = core_->CreateSnapshotPre(file, user, desc, &info);
+    int ret = core_->CreateSnapshotPre(file, user, desc,
+        CompressType::kNone, &info);
     ASSERT_EQ(kErrCodeInvalidUser, ret);
 }
 
@@ -201,7 +210,8 @@ TEST_F(TestSnapshotCoreImpl, TestCreateSnapshotPreInternalError) {
         .WillOnce(DoAll(
                     SetArgPointee<2>(fInfo),
                     Return(-LIBCURVE_ERROR::FAILED)));
-    int ret = core_->CreateSnapshotPre(file, user, desc, &info);
+    int ret = core_->CreateSnapshotPre(file, user, desc,
+        CompressType::kNone, &info);
     ASSERT_EQ(kErrCodeInternalError, ret);
 }
 
@@ -219,7 +229,8 @@ TEST_F(TestSnapshotCoreImpl, TestCreateSnapshotPreFailStatusInvalid) {
         .WillOnce(DoAll(
                     SetArgPointee<2>(fInfo),
                     Return(LIBCURVE_ERROR::OK)));
-    int ret = core_->CreateSnapshotPre(file, user, desc, &info);
+    int ret = core_->CreateSnapshotPre(file, user, desc,
+        CompressType::kNone, &info);
     ASSERT_EQ(kErrCodeFileStatusInvalid, ret);
 }
 
@@ -516,6 +527,317 @@ TEST_F(TestSnapshotCoreImpl,
 
     ASSERT_TRUE(task->IsFinish());
     ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
+    ASSERT_EQ(8 * option.chunkSplitSize, task->GetTransferBytes());
+}
+
+TEST(TestTransferBufferPool, TestGetAndPut) {
+    TransferBufferPool pool(4096, 2);
+    std::unique_ptr<char[]> buf1, buf2, buf3;
+    ASSERT_TRUE(pool.Get(10, &buf1));
+    ASSERT_TRUE(pool.Get(10, &buf2));
+    ASSERT_NE(nullptr, buf1);
+    ASSERT_NE(nullptr, buf2);
+
+    // 缓冲区用完之后等待超时
+    ASSERT_FALSE(pool.Get(10, &buf3));
+
+    // 归还之后可以复用
+    char *addr = buf1.get();
+    pool.Put(std::move(buf1));
+    ASSERT_TRUE(pool.Get(10, &buf3));
+    ASSERT_EQ(addr, buf3.get());
+
+    // 等待期间归还的缓冲区可以被获取
+    std::thread t([&pool, &buf2]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        pool.Put(std::move(buf2));
+    });
+    ASSERT_TRUE(pool.Get(10000, &buf1));
+    t.join();
+}
+
+TEST_F(TestSnapshotCoreImpl,
+    TestHandleCreateSnapshotTaskDedupSuccess) {
+    option.enableChunkDedup = true;
+    core_ = std::make_shared<SnapshotCoreImpl>(client_,
+            metaStore_,
+            dataStore_,
+            snapshotRef_,
+            option);
+    ASSERT_EQ(core_->Init(), 0);
+
+    UUID uuid = "uuid1";
+    std::string user = "user1";
+    std::string fileName = "file1";
+    std::string desc = "snap1";
+    uint64_t seqNum = 100;
+
+    SnapshotInfo info(uuid, user, fileName, desc);
+    info.SetStatus(Status::pending);
+
+    auto snapshotInfoMetric = std::make_shared<SnapshotInfoMetric>(uuid);
+    std::shared_ptr<SnapshotTaskInfo> task =
+        std::make_shared<SnapshotTaskInfo>(info, snapshotInfoMetric);
+
+    EXPECT_CALL(*client_, CreateSnapshot(fileName, user, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<2>(seqNum),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    FInfo snapInfo;
+    snapInfo.seqnum = 100;
+    snapInfo.chunksize = 2 * option.chunkSplitSize;
+    snapInfo.segmentsize = 2 * snapInfo.chunksize;
+    snapInfo.length = 2 * snapInfo.segmentsize;
+    snapInfo.ctime = 10;
+    EXPECT_CALL(*client_, GetSnapshot(fileName, user, seqNum, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<3>(snapInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*metaStore_, CASSnapshot(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+    EXPECT_CALL(*metaStore_, UpdateSnapshot(_))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    SegmentInfo segInfo1;
+    segInfo1.chunkvec.push_back(ChunkIDInfo(1, 1, 1));
+    segInfo1.chunkvec.push_back(ChunkIDInfo(2, 2, 2));
+    SegmentInfo segInfo2;
+    segInfo2.chunkvec.push_back(ChunkIDInfo(3, 3, 3));
+    segInfo2.chunkvec.push_back(ChunkIDInfo(4, 4, 4));
+
+    EXPECT_CALL(*client_, GetSnapshotSegmentInfo(fileName,
+          user,
+          seqNum,
+            _,
+            _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo1),
+                    Return(LIBCURVE_ERROR::OK)))
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo2),
+                    Return(kErrCodeSuccess)));
+
+    ChunkInfoDetail chunkInfo;
+    chunkInfo.chunkSn.push_back(100);
+    EXPECT_CALL(*client_, GetChunkInfo(_, _))
+        .Times(4)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    std::vector<SnapshotInfo> snapInfos;
+    info.SetSeqNum(seqNum);
+    snapInfos.push_back(info);
+    EXPECT_CALL(*metaStore_, GetSnapshotList(fileName, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(
+                    SetArgPointee<1>(snapInfos),
+                    Return(kErrCodeSuccess)));
+
+    // 第一次保存索引块，转储完成后再保存chunk数据的hash
+    ChunkIndexData savedIndexData;
+    EXPECT_CALL(*dataStore_, PutChunkIndexData(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SaveArg<1>(&savedIndexData),
+                    Return(kErrCodeSuccess)));
+
+    // chunk1全零，其他chunk数据相同
+    EXPECT_CALL(*client_, ReadChunkSnapshot(_, _, _, _, _, _))
+        .Times(8)
+        .WillRepeatedly(DoAll(
+                    Invoke([](ChunkIDInfo cidinfo,
+                        uint64_t seq,
+                        uint64_t offset,
+                        uint64_t len,
+                        char *buf,
+                        SnapCloneClosure* scc){
+                        memset(buf, cidinfo.cid_ == 1 ? 0 : 'a', len);
+                        scc->SetRetCode(LIBCURVE_ERROR::OK);
+                        scc->Run();
+                        }),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*metaStore_, GetChunkDataRefCount(_, _))
+        .Times(3)
+        .WillOnce(DoAll(SetArgPointee<1>(0),
+                    Return(kErrCodeSuccess)))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(1),
+                    Return(kErrCodeSuccess)));
+    EXPECT_CALL(*metaStore_, AddChunkDataRef(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    // 相同的数据只上传一次
+    ChunkDataName contentName;
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .WillOnce(DoAll(SaveArg<0>(&contentName),
+                    Return(kErrCodeSuccess)));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPart(_, _, _, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*client_, DeleteSnapshot(fileName, user, seqNum))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+
+    EXPECT_CALL(*client_, CheckSnapShotStatus(_, _, _, _))
+        .WillOnce(Return(-LIBCURVE_ERROR::NOTEXIST));
+
+    core_->HandleCreateSnapshotTask(task);
+
+    ASSERT_TRUE(task->IsFinish());
+    ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
+    ASSERT_EQ(2 * option.chunkSplitSize, task->GetTransferBytes());
+    ASSERT_EQ(6 * option.chunkSplitSize, task->GetDedupBytes());
+
+    std::string hash;
+    ASSERT_TRUE(savedIndexData.GetChunkContent(0, &hash));
+    ASSERT_TRUE(hash.empty());
+    for (ChunkIndexType index = 1; index < 4; index++) {
+        ASSERT_TRUE(savedIndexData.GetChunkContent(index, &hash));
+        ASSERT_EQ(64u, hash.size());
+    }
+    ASSERT_EQ(ToContentChunkDataName(hash).ToDataChunkKey(),
+              contentName.ToDataChunkKey());
+}
+
+TEST_F(TestSnapshotCoreImpl,
+    TestHandleCreateSnapshotTaskCompressSuccess) {
+    UUID uuid = "uuid1";
+    std::string user = "user1";
+    std::string fileName = "file1";
+    std::string desc = "snap1";
+    uint64_t seqNum = 100;
+
+    SnapshotInfo info(uuid, user, fileName, desc);
+    info.SetCompressType(CompressType::kSnappy);
+    info.SetStatus(Status::pending);
+
+    auto snapshotInfoMetric = std::make_shared<SnapshotInfoMetric>(uuid);
+    std::shared_ptr<SnapshotTaskInfo> task =
+        std::make_shared<SnapshotTaskInfo>(info, snapshotInfoMetric);
+
+    EXPECT_CALL(*client_, CreateSnapshot(fileName, user, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<2>(seqNum),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    FInfo snapInfo;
+    snapInfo.seqnum = 100;
+    snapInfo.chunksize = 2 * option.chunkSplitSize;
+    snapInfo.segmentsize = 2 * snapInfo.chunksize;
+    snapInfo.length = 2 * snapInfo.segmentsize;
+    snapInfo.ctime = 10;
+    EXPECT_CALL(*client_, GetSnapshot(fileName, user, seqNum, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<3>(snapInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*metaStore_, CASSnapshot(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+    EXPECT_CALL(*metaStore_, UpdateSnapshot(_))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    SegmentInfo segInfo1;
+    segInfo1.chunkvec.push_back(ChunkIDInfo(1, 1, 1));
+    segInfo1.chunkvec.push_back(ChunkIDInfo(2, 2, 2));
+    SegmentInfo segInfo2;
+    segInfo2.chunkvec.push_back(ChunkIDInfo(3, 3, 3));
+    segInfo2.chunkvec.push_back(ChunkIDInfo(4, 4, 4));
+
+    EXPECT_CALL(*client_, GetSnapshotSegmentInfo(fileName,
+          user,
+          seqNum,
+            _,
+            _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo1),
+                    Return(LIBCURVE_ERROR::OK)))
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo2),
+                    Return(kErrCodeSuccess)));
+
+    ChunkInfoDetail chunkInfo;
+    chunkInfo.chunkSn.push_back(100);
+    EXPECT_CALL(*client_, GetChunkInfo(_, _))
+        .Times(4)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    std::vector<SnapshotInfo> snapInfos;
+    info.SetSeqNum(seqNum);
+    snapInfos.push_back(info);
+    EXPECT_CALL(*metaStore_, GetSnapshotList(fileName, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(
+                    SetArgPointee<1>(snapInfos),
+                    Return(kErrCodeSuccess)));
+
+    // 第一次保存索引块，上传对象之前再保存chunk的压缩算法
+    ChunkIndexData savedIndexData;
+    EXPECT_CALL(*dataStore_, PutChunkIndexData(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SaveArg<1>(&savedIndexData),
+                    Return(kErrCodeSuccess)));
+
+    EXPECT_CALL(*client_, ReadChunkSnapshot(_, _, _, _, _, _))
+        .Times(8)
+        .WillRepeatedly(DoAll(
+                    Invoke([](ChunkIDInfo cidinfo,
+                        uint64_t seq,
+                        uint64_t offset,
+                        uint64_t len,
+                        char *buf,
+                        SnapCloneClosure* scc){
+                        memset(buf, 'a', len);
+                        scc->SetRetCode(LIBCURVE_ERROR::OK);
+                        scc->Run();
+                        }),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    // 每个chunk压缩后作为一个分片上传
+    std::vector<int> partSizes;
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .Times(4)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPart(_, _, 0, _, _))
+        .Times(4)
+        .WillRepeatedly(DoAll(
+                    Invoke([&partSizes](const ChunkDataName &name,
+                        std::shared_ptr<TransferTask> task,
+                        int partNum,
+                        int partSize,
+                        const char* buf) {
+                        partSizes.push_back(partSize);
+                        }),
+                    Return(kErrCodeSuccess)));
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .Times(4)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*client_, DeleteSnapshot(fileName, user, seqNum))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+
+    EXPECT_CALL(*client_, CheckSnapShotStatus(_, _, _, _))
+        .WillOnce(Return(-LIBCURVE_ERROR::NOTEXIST));
+
+    core_->HandleCreateSnapshotTask(task);
+
+    ASSERT_TRUE(task->IsFinish());
+    ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
+    uint64_t totalSize = 0;
+    for (int partSize : partSizes) {
+        ASSERT_LT(partSize, static_cast<int>(snapInfo.chunksize));
+        totalSize += partSize;
+    }
+    ASSERT_EQ(totalSize, task->GetTransferBytes());
+
+    for (ChunkIndexType index = 0; index < 4; index++) {
+        CompressType compressType;
+        ASSERT_TRUE(savedIndexData.GetChunkCompressType(index,
+            &compressType));
+        ASSERT_EQ(CompressType::kSnappy, compressType);
+    }
 }
 
 TEST_F(TestSnapshotCoreImpl,
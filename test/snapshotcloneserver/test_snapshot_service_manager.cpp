@@ -81,9 +81,9 @@ class TestSnapshotServiceManager : public ::testing::Test {
     const std::string &desc,
     UUID uuid) {
         SnapshotInfo info(uuid, user, file, desc);
-        EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+        EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
             .WillOnce(DoAll(
-                SetArgPointee<3>(info),
+                SetArgPointee<4>(info),
                 Return(kErrCodeSuccess)));
 
         CountDownEvent cond1(1);
@@ -99,6 +99,7 @@ class TestSnapshotServiceManager : public ::testing::Test {
             file,
             user,
             desc,
+            "",
             &uuid);
         ASSERT_EQ(kErrCodeSuccess, ret);
 
@@ -121,9 +122,9 @@ TEST_F(TestSnapshotServiceManager,
     UUID uuidOut = "abc";
 
     SnapshotInfo info(uuidOut, user, file, desc);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeSuccess)));
 
     CountDownEvent cond1(1);
@@ -139,6 +140,7 @@ TEST_F(TestSnapshotServiceManager,
         file,
         user,
         desc,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
     ASSERT_EQ(uuid, uuidOut);
@@ -164,9 +166,9 @@ TEST_F(TestSnapshotServiceManager,
     UUID uuidOut = "abc";
 
     SnapshotInfo info(uuidOut, user, file, desc);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeInternalError)));
 
 
@@ -174,6 +176,7 @@ TEST_F(TestSnapshotServiceManager,
         file,
         user,
         desc,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeInternalError, ret);
 }
@@ -187,19 +190,49 @@ TEST_F(TestSnapshotServiceManager,
     UUID uuidOut = "abc";
 
     SnapshotInfo info(uuidOut, user, file, desc);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeTaskExist)));
 
     int ret = manager_->CreateSnapshot(
         file,
         user,
         desc,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
 }
 
+TEST_F(TestSnapshotServiceManager,
+    TestCreateSnapshotWithCompressType) {
+    const std::string file = "file1";
+    const std::string user = "user1";
+    const std::string desc = "snap1";
+    UUID uuid;
+    UUID uuidOut = "abc";
+
+    SnapshotInfo info(uuidOut, user, file, desc);
+    // 未指定时使用服务端默认配置，指定时按请求记录到快照中
+    EXPECT_CALL(*core_,
+        CreateSnapshotPre(file, user, desc, CompressType::kNone, _))
+        .WillOnce(DoAll(
+            SetArgPointee<4>(info),
+            Return(kErrCodeTaskExist)));
+    EXPECT_CALL(*core_,
+        CreateSnapshotPre(file, user, desc, CompressType::kSnappy, _))
+        .WillOnce(DoAll(
+            SetArgPointee<4>(info),
+            Return(kErrCodeTaskExist)));
+
+    ASSERT_EQ(kErrCodeSuccess,
+        manager_->CreateSnapshot(file, user, desc, "", &uuid));
+    ASSERT_EQ(kErrCodeSuccess,
+        manager_->CreateSnapshot(file, user, desc, "snappy", &uuid));
+    ASSERT_EQ(kErrCodeInvalidRequest,
+        manager_->CreateSnapshot(file, user, desc, "lz4", &uuid));
+}
+
 TEST_F(TestSnapshotServiceManager,
     TestCreateSnapshotPushTaskFail) {
     const std::string file1 = "file1";
@@ -208,9 +241,9 @@ TEST_F(TestSnapshotServiceManager,
     UUID uuid1 = "uuid1";
 
     SnapshotInfo info(uuid1, user1, file1, desc1);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file1, user1, desc1, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file1, user1, desc1, _, _))
         .WillRepeatedly(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeSuccess)));
 
     EXPECT_CALL(*core_, HandleCreateSnapshotTask(_))
@@ -221,6 +254,7 @@ TEST_F(TestSnapshotServiceManager,
         file1,
         user1,
         desc1,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
 
@@ -229,6 +263,7 @@ TEST_F(TestSnapshotServiceManager,
         file1,
         user1,
         desc1,
+        "",
         &uuid2);
 
     ASSERT_EQ(kErrCodeInternalError, ret);
@@ -262,16 +297,16 @@ TEST_F(TestSnapshotServiceManager,
     SnapshotInfo info2(uuid2, user, file2, desc2);
     SnapshotInfo info3(uuid3, user, file3, desc3);
 
-    EXPECT_CALL(*core_, CreateSnapshotPre(_, _, _, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(_, _, _, _, _))
         .Times(3)
         .WillOnce(DoAll(
-            SetArgPointee<3>(info1),
+            SetArgPointee<4>(info1),
             Return(kErrCodeSuccess)))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info2),
+            SetArgPointee<4>(info2),
             Return(kErrCodeSuccess)))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info3),
+            SetArgPointee<4>(info3),
             Return(kErrCodeSuccess)));
 
     std::condition_variable cv;
@@ -295,6 +330,7 @@ TEST_F(TestSnapshotServiceManager,
         file1,
         user,
         desc1,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
 
@@ -302,6 +338,7 @@ TEST_F(TestSnapshotServiceManager,
         file2,
         user,
         desc2,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
 
@@ -309,6 +346,7 @@ TEST_F(TestSnapshotServiceManager,
         file3,
         user,
         desc3,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
 
@@ -341,16 +379,16 @@ TEST_F(TestSnapshotServiceManager,
     SnapshotInfo info2(uuid2, user, file1, desc2);
     SnapshotInfo info3(uuid3, user, file1, desc3);
 
-    EXPECT_CALL(*core_, CreateSnapshotPre(_, _, _, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(_, _, _, _, _))
         .Times(3)
         .WillOnce(DoAll(
-            SetArgPointee<3>(info1),
+            SetArgPointee<4>(info1),
             Return(kErrCodeSuccess)))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info2),
+            SetArgPointee<4>(info2),
             Return(kErrCodeSuccess)))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info3),
+            SetArgPointee<4>(info3),
             Return(kErrCodeSuccess)));
 
     CountDownEvent cond1(3);
@@ -368,6 +406,7 @@ TEST_F(TestSnapshotServiceManager,
         file1,
         user,
         desc1,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
 
@@ -375,6 +414,7 @@ TEST_F(TestSnapshotServiceManager,
         file1,
         user,
         desc2,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
 
@@ -382,6 +422,7 @@ TEST_F(TestSnapshotServiceManager,
         file1,
         user,
         desc3,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
     cond1.Wait();
@@ -437,9 +478,9 @@ TEST_F(TestSnapshotServiceManager, TestDeleteSnapshotByCancelSuccess) {
     UUID uuidOut = "abc";
 
     SnapshotInfo info(uuidOut, user, file, desc);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeSuccess)));
 
     CountDownEvent cond1(1);
@@ -461,6 +502,7 @@ TEST_F(TestSnapshotServiceManager, TestDeleteSnapshotByCancelSuccess) {
         file,
         user,
         desc,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
     ASSERT_EQ(uuid, uuidOut);
@@ -609,9 +651,9 @@ TEST_F(TestSnapshotServiceManager, TestGetFileSnapshotInfoSuccess) {
     uint32_t progress = 50;
 
     SnapshotInfo info(uuidOut, user, file, desc);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeSuccess)));
 
     CountDownEvent cond1(1);
@@ -627,6 +669,7 @@ TEST_F(TestSnapshotServiceManager, TestGetFileSnapshotInfoSuccess) {
         file,
         user,
         desc,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
 
@@ -739,9 +782,9 @@ TEST_F(TestSnapshotServiceManager, TestGetSnapshotListByFilterSuccess) {
     uint32_t progress = 50;
 
     SnapshotInfo info(uuidOut, user, file, desc);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeSuccess)));
 
     CountDownEvent cond1(1);
@@ -757,6 +800,7 @@ TEST_F(TestSnapshotServiceManager, TestGetSnapshotListByFilterSuccess) {
         file,
         user,
         desc,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
 
@@ -1060,13 +1104,13 @@ TEST_F(TestSnapshotServiceManager,
 
     SnapshotInfo info(uuidOut, user, file, desc);
     SnapshotInfo info2(uuidOut2, user, file, desc);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
         .Times(2)
         .WillOnce(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeSuccess)))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info2),
+            SetArgPointee<4>(info2),
             Return(kErrCodeSuccess)));
 
     CountDownEvent cond1(1);
@@ -1103,6 +1147,7 @@ TEST_F(TestSnapshotServiceManager,
         file,
         user,
         desc,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
     ASSERT_EQ(uuid, uuidOut);
@@ -1112,6 +1157,7 @@ TEST_F(TestSnapshotServiceManager,
         file,
         user,
         desc,
+        "",
         &uuid2);
     ASSERT_EQ(kErrCodeSuccess, ret);
     ASSERT_EQ(uuid2, uuidOut2);
@@ -1141,9 +1187,9 @@ TEST_F(TestSnapshotServiceManager,
     UUID uuidOut = "abc";
 
     SnapshotInfo info(uuidOut, user, file, desc);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeSuccess)));
 
     CountDownEvent cond1(1);
@@ -1161,6 +1207,7 @@ TEST_F(TestSnapshotServiceManager,
         file,
         user,
         desc,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
     ASSERT_EQ(uuid, uuidOut);
@@ -1184,9 +1231,9 @@ TEST_F(TestSnapshotServiceManager,
     UUID uuidOut = "abc";
 
     SnapshotInfo info(uuidOut, user, file, desc);
-    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _))
+    EXPECT_CALL(*core_, CreateSnapshotPre(file, user, desc, _, _))
         .WillOnce(DoAll(
-            SetArgPointee<3>(info),
+            SetArgPointee<4>(info),
             Return(kErrCodeSuccess)));
 
     CountDownEvent cond1(1);
@@ -1204,6 +1251,7 @@ TEST_F(TestSnapshotServiceManager,
         file,
         user,
         desc,
+        "",
         &uuid);
     ASSERT_EQ(kErrCodeSuccess, ret);
     ASSERT_EQ(uuid, uuidOut);
@@ -86,9 +86,9 @@ TEST_F(TestSnapshotCloneServiceImpl, TestCreateSnapShotSuccess) {
     std::string file = "test";
     std::string snapName = "snap1";
 
-    EXPECT_CALL(*snapshotManager_, CreateSnapshot(file, user, snapName, _))
+    EXPECT_CALL(*snapshotManager_, CreateSnapshot(file, user, snapName, _, _))
         .WillOnce(DoAll(
-                    SetArgPointee<3>(uuid),
+                    SetArgPointee<4>(uuid),
                     Return(kErrCodeSuccess)));
 
     brpc::Channel channel;
@@ -119,6 +119,88 @@ TEST_F(TestSnapshotCloneServiceImpl, TestCreateSnapShotSuccess) {
     LOG(ERROR) << cntl.response_attachment();
 }
 
+TEST_F(TestSnapshotCloneServiceImpl, TestCreateSnapShotWithCompressType) {
+    UUID uuid = "uuid1";
+    std::string user = "user";
+    std::string file = "test";
+    std::string snapName = "snap1";
+    std::string compressType = "snappy";
+
+    EXPECT_CALL(*snapshotManager_,
+        CreateSnapshot(file, user, snapName, compressType, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<4>(uuid),
+                    Return(kErrCodeSuccess)));
+
+    brpc::Channel channel;
+    brpc::ChannelOptions option;
+    option.protocol = "http";
+
+    std::string url = std::string("http://127.0.0.1:")
+                    + std::to_string(listenAddr_.port)
+                    + "/" + kServiceName + "?"
+                    + kActionStr+ "=" + kCreateSnapshotAction + "&"
+                    + kVersionStr + "=1&"
+                    + kUserStr + "=" + user + "&"
+                    + kFileStr + "=" + file + "&"
+                    + kNameStr + "=" + snapName + "&"
+                    + kCompressTypeStr + "=" + compressType;
+
+    if (channel.Init(url.c_str(), "", &option) != 0) {
+        FAIL() << "Fail to init channel"
+               << std::endl;
+    }
+
+    brpc::Controller cntl;
+    cntl.http_request().uri() = url.c_str();
+
+    channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+    if (cntl.Failed()) {
+        LOG(ERROR) << cntl.ErrorText();
+    }
+    LOG(ERROR) << cntl.response_attachment();
+    ASSERT_EQ(brpc::HTTP_STATUS_OK, cntl.http_response().status_code());
+}
+
+TEST_F(TestSnapshotCloneServiceImpl, TestCreateSnapShotInvalidCompressType) {
+    std::string user = "user";
+    std::string file = "test";
+    std::string snapName = "snap1";
+
+    EXPECT_CALL(*snapshotManager_, CreateSnapshot(_, _, _, _, _))
+        .Times(0);
+
+    brpc::Channel channel;
+    brpc::ChannelOptions option;
+    option.protocol = "http";
+
+    std::string url = std::string("http://127.0.0.1:")
+                    + std::to_string(listenAddr_.port)
+                    + "/" + kServiceName + "?"
+                    + kActionStr+ "=" + kCreateSnapshotAction + "&"
+                    + kVersionStr + "=1&"
+                    + kUserStr + "=" + user + "&"
+                    + kFileStr + "=" + file + "&"
+                    + kNameStr + "=" + snapName + "&"
+                    + kCompressTypeStr + "=lz4";
+
+    if (channel.Init(url.c_str(), "", &option) != 0) {
+        FAIL() << "Fail to init channel"
+               << std::endl;
+    }
+
+    brpc::Controller cntl;
+    cntl.http_request().uri() = url.c_str();
+
+    channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+    if (cntl.Failed()) {
+        LOG(ERROR) << cntl.ErrorText();
+    }
+    LOG(ERROR) << cntl.response_attachment();
+    ASSERT_EQ(brpc::HTTP_STATUS_BAD_REQUEST,
+                    cntl.http_response().status_code());
+}
+
 TEST_F(TestSnapshotCloneServiceImpl, TestDeleteSnapShotSuccess) {
     UUID uuid = "uuid1";
     std::string user = "test";
@@ -665,9 +747,9 @@ TEST_F(TestSnapshotCloneServiceImpl, TestCreateSnapShotFail) {
     std::string file = "test";
     std::string snapName = "snap1";
 
-    EXPECT_CALL(*snapshotManager_, CreateSnapshot(file, user, snapName, _))
+    EXPECT_CALL(*snapshotManager_, CreateSnapshot(file, user, snapName, _, _))
         .WillOnce(DoAll(
-                    SetArgPointee<3>(uuid),
+                    SetArgPointee<4>(uuid),
                     Return(kErrCodeInternalError)));
 
     brpc::Channel channel;
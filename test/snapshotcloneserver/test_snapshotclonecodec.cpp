@@ -43,6 +43,7 @@ TEST(TestSnapshotCloneServerCodec, TestSnapInfoEncodeDecodeEqual) {
     SnapshotInfo snapInfo("snapuuid", "snapuser", "file1", "snapxxx", 100,
                         1024, 2048, 4096, 4096, 8, 0,
                         Status::pending);
+    snapInfo.SetCompressType(CompressType::kSnappy);
     SnapshotCloneCodec testObj;
     std::string value;
     ASSERT_TRUE(testObj.EncodeSnapshotData(snapInfo, &value));
@@ -60,6 +61,7 @@ TEST(TestSnapshotCloneServerCodec, TestSnapInfoEncodeDecodeEqual) {
     ASSERT_EQ(snapInfo.GetFileLength(), decodedSnapInfo.GetFileLength());
     ASSERT_EQ(snapInfo.GetStripeUnit(), decodedSnapInfo.GetStripeUnit());
     ASSERT_EQ(snapInfo.GetStripeCount(), decodedSnapInfo.GetStripeCount());
+    ASSERT_EQ(snapInfo.GetCompressType(), decodedSnapInfo.GetCompressType());
     ASSERT_EQ(snapInfo.GetCreateTime(), decodedSnapInfo.GetCreateTime());
     ASSERT_EQ(snapInfo.GetStatus(), decodedSnapInfo.GetStatus());
 }